@@ -0,0 +1,381 @@
+//
+//  batch.cpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#include "batch.hpp"
+
+// C++
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Cubzh Core
+#include "color_atlas.h"
+#include "transform.h"
+#include "utils.h"
+
+// cli
+#include "blocks.hpp"
+#include "combine.hpp"
+#include "job.hpp"
+#include "options.hpp"
+#include "shape_point.hpp"
+
+namespace {
+
+struct BatchJob {
+    size_t index;
+    std::string line;
+};
+
+/// Jobs waiting for a worker, filled by the thread reading the manifest.
+class BatchQueue final {
+public:
+    BatchQueue() :
+    _mutex(),
+    _cv(),
+    _jobs(),
+    _closed(false) {}
+
+    void push(BatchJob job) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.push_back(std::move(job));
+        }
+        _cv.notify_one();
+    }
+
+    /// No more jobs will be pushed
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _closed = true;
+        }
+        _cv.notify_all();
+    }
+
+    /// Blocks until a job is available.
+    /// Returns false when the queue is closed and empty.
+    bool pop(BatchJob& job) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [this]{ return _jobs.empty() == false || _closed; });
+        if (_jobs.empty()) {
+            return false;
+        }
+        job = std::move(_jobs.front());
+        _jobs.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<BatchJob> _jobs;
+    bool _closed;
+};
+
+std::string json_escape(const std::string& str) {
+    std::string out;
+    out.reserve(str.size() + 2);
+    out.push_back('"');
+    for (const char c : str) {
+        switch (c) {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned int>(c));
+                    out.append(buf);
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    out.push_back('"');
+    return out;
+}
+
+std::string json_ms(const uint64_t ns) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.3f", static_cast<double>(ns) / 1000000.0);
+    return std::string(buf);
+}
+
+std::string json_timings(const JobTimings& timings, const uint64_t total) {
+    return std::string("{\"read\":") + json_ms(timings.read) +
+           ",\"inflate\":" + json_ms(timings.inflate) +
+           ",\"parse\":" + json_ms(timings.parse) +
+           ",\"build\":" + json_ms(timings.build) +
+           ",\"total\":" + json_ms(total) + "}";
+}
+
+/// Splits a job line in arguments, supporting double quotes.
+std::vector<std::string> split_arguments(const std::string& line) {
+    std::vector<std::string> args;
+    std::string current;
+    bool inArgument = false;
+    bool inQuotes = false;
+
+    for (size_t i = 0; i < line.size(); ++i) {
+        const char c = line[i];
+        if (inQuotes) {
+            if (c == '\\' && i + 1 < line.size() && (line[i + 1] == '"' || line[i + 1] == '\\')) {
+                current.push_back(line[++i]);
+            } else if (c == '"') {
+                inQuotes = false;
+            } else {
+                current.push_back(c);
+            }
+        } else if (c == '"') {
+            inQuotes = true;
+            inArgument = true;
+        } else if (c == ' ' || c == '\t' || c == '\r') {
+            if (inArgument) {
+                args.push_back(current);
+                current.clear();
+                inArgument = false;
+            }
+        } else {
+            current.push_back(c);
+            inArgument = true;
+        }
+    }
+    if (inArgument) {
+        args.push_back(current);
+    }
+    return args;
+}
+
+/// Runs one job, returns the job specific JSON fields on success (can be empty).
+bool run_job(const std::vector<std::string>& args,
+             cxxopts::Options& options,
+             ColorAtlas *colorAtlas,
+             JobTimings *timings,
+             std::string& command,
+             std::string& fields,
+             std::string& err) {
+
+    // cxxopts expects the program name first
+    std::vector<const char *> argv;
+    argv.push_back("cubzh");
+    for (const std::string& arg : args) {
+        argv.push_back(arg.c_str());
+    }
+
+    cxxopts::ParseResult result = options.parse(static_cast<int>(argv.size()), argv.data());
+
+    if (result.count("command") == 0) {
+        err.assign("no command");
+        return false;
+    }
+    command = result["command"].as<std::string>();
+
+    if (command == "blocks") {
+        if (result.count("input") != 1) {
+            err.assign("exactly one input file expected");
+            return false;
+        }
+        size_t blockCount = 0;
+        const std::string inputPath = result["input"].as<std::vector<std::string>>().front();
+        if (blocks_count(inputPath, colorAtlas, blockCount, timings, err) == false) {
+            return false;
+        }
+        fields = ",\"blocks\":" + std::to_string(blockCount);
+        return true;
+
+    } else if (command == "combine") {
+        if (result.count("input") == 0) {
+            err.assign("no input files");
+            return false;
+        }
+        if (result.count("output") != 1) {
+            err.assign("exactly one output file expected");
+            return false;
+        }
+        return combine_vox_files(result["input"].as<std::vector<std::string>>(),
+                                 result["output"].as<std::string>(),
+                                 colorAtlas,
+                                 timings,
+                                 err);
+
+    } else if (command == "setpoint") {
+        if (result.count("input") != 1) {
+            err.assign("exactly one input file expected");
+            return false;
+        }
+        const std::vector<std::string>& pointArgs = result.unmatched();
+        if (pointArgs.size() != 7) {
+            err.assign("expected arguments: <name> <x> <y> <z> <rx> <ry> <rz>");
+            return false;
+        }
+        const std::string inputPath = result["input"].as<std::vector<std::string>>().front();
+        const std::string outputPath = result.count("output") > 0 ? result["output"].as<std::string>()
+                                                                  : inputPath;
+        const float3 position = {
+            std::stof(pointArgs[1]), std::stof(pointArgs[2]), std::stof(pointArgs[3])
+        };
+        const float3 rotation = {
+            std::stof(pointArgs[4]), std::stof(pointArgs[5]), std::stof(pointArgs[6])
+        };
+        return shape_set_point(inputPath,
+                               outputPath,
+                               pointArgs[0],
+                               position,
+                               rotation,
+                               colorAtlas,
+                               timings,
+                               err);
+    }
+
+    err.assign("command not supported in batch: " + command);
+    return false;
+}
+
+} // namespace
+
+bool command_batch(cxxopts::ParseResult parseResult, std::string& err) {
+
+    // validation
+
+    if (parseResult.count("input") > 1) {
+        err.assign("only 1 manifest file is allowed");
+        return false;
+    }
+
+    unsigned int nbThreads = std::thread::hardware_concurrency();
+    if (parseResult.count("jobs") > 0) {
+        nbThreads = parseResult["jobs"].as<unsigned int>();
+    }
+    if (nbThreads == 0) {
+        nbThreads = 1;
+    }
+
+    const bool bench = parseResult.count("bench") > 0;
+
+    std::ifstream manifest;
+    if (parseResult.count("input") == 1) {
+        const std::string manifestPath = parseResult["input"].as<std::vector<std::string>>().front();
+        manifest.open(manifestPath);
+        if (manifest.is_open() == false) {
+            err.assign("can't open manifest file: " + manifestPath);
+            return false;
+        }
+    }
+    std::istream& in = manifest.is_open() ? static_cast<std::istream&>(manifest) : std::cin;
+
+    // processing
+
+    // transform IDs are shared by all shapes, whatever the thread
+    transform_init_ID_thread_safety();
+
+    BatchQueue queue;
+    std::mutex outputMutex;
+    std::atomic<size_t> nbFailed(0);
+    JobTimings totalTimings;
+
+    const uint64_t batchStart = utils_time_ns();
+
+    std::vector<std::thread> workers;
+    workers.reserve(nbThreads);
+    for (unsigned int i = 0; i < nbThreads; ++i) {
+        workers.emplace_back([&queue, &outputMutex, &nbFailed, &totalTimings, bench](){
+            ColorAtlas * const colorAtlas = color_atlas_new();
+            cxxopts::Options options = cli_options();
+            BatchJob job;
+
+            while (queue.pop(job)) {
+                JobTimings timings;
+                std::string command;
+                std::string fields;
+                std::string jobErr;
+                bool success = false;
+
+                const uint64_t start = utils_time_ns();
+                try {
+                    success = run_job(split_arguments(job.line),
+                                      options,
+                                      colorAtlas,
+                                      bench ? &timings : nullptr,
+                                      command,
+                                      fields,
+                                      jobErr);
+                } catch (const std::exception& e) {
+                    jobErr = e.what();
+                    success = false;
+                }
+                const uint64_t total = utils_time_ns() - start;
+
+                if (success == false) {
+                    ++nbFailed;
+                }
+
+                std::string out = "{\"job\":" + std::to_string(job.index) +
+                                  ",\"command\":" + json_escape(command) +
+                                  ",\"success\":" + (success ? "true" : "false");
+                if (success) {
+                    out += fields;
+                } else {
+                    out += ",\"error\":" + json_escape(jobErr.empty() ? "unknown error" : jobErr);
+                }
+                if (bench) {
+                    out += ",\"timings_ms\":" + json_timings(timings, total);
+                }
+                out += "}\n";
+
+                std::lock_guard<std::mutex> lock(outputMutex);
+                if (bench) {
+                    totalTimings.read += timings.read;
+                    totalTimings.inflate += timings.inflate;
+                    totalTimings.parse += timings.parse;
+                    totalTimings.build += timings.build;
+                }
+                std::cout << out << std::flush;
+            }
+
+            color_atlas_free(colorAtlas);
+        });
+    }
+
+    size_t nbJobs = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        queue.push({nbJobs, line});
+        ++nbJobs;
+    }
+    queue.close();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    const uint64_t wall = utils_time_ns() - batchStart;
+
+    std::string summary = "{\"summary\":{\"jobs\":" + std::to_string(nbJobs) +
+                          ",\"failed\":" + std::to_string(nbFailed.load()) +
+                          ",\"threads\":" + std::to_string(nbThreads);
+    if (bench) {
+        summary += ",\"timings_ms\":" + json_timings(totalTimings, wall);
+    }
+    summary += "}}";
+    std::cout << summary << std::endl;
+
+    return nbFailed.load() == 0;
+}
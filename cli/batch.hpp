@@ -0,0 +1,31 @@
+//
+//  batch.hpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#pragma once
+
+// C++
+#include <string>
+
+// cxxopts
+#include <cxxopts.hpp>
+
+/// Runs a batch of jobs on a pool of worker threads.
+///
+/// Jobs are read from the input manifest file, or from stdin when no input is
+/// given, one per line, using the same syntax as the command line:
+///
+///     blocks -i hat.3zh
+///     combine -i a.vox -i b.vox -o ab.vox
+///     setpoint -i hat.3zh -o hat2.3zh ModelPoint 0 1 0 0 0 0
+///
+/// Empty lines and lines starting with '#' are ignored.
+/// One JSON object is printed per job, in completion order, followed by a summary.
+/// Each worker thread owns a ColorAtlas, reused from one job to the next.
+///
+/// Returns true if all jobs succeeded, false otherwise.
+/// When the batch itself can't run, the `err` argument is filled with an error message.
+bool command_batch(cxxopts::ParseResult parseResult, std::string& err);
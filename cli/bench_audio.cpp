@@ -0,0 +1,46 @@
+//
+//  bench_audio.cpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#include "bench_audio.hpp"
+
+// C++
+#include <cstdio>
+
+// xptools
+#include "audio.hpp"
+
+bool command_bench_audio(cxxopts::ParseResult parseResult, std::string& err) {
+
+    // validation
+
+    const int count =
+        parseResult.count("instances") > 0 ? static_cast<int>(parseResult["instances"].as<unsigned int>()) : 10000;
+
+    if (count <= 0) {
+        err.assign("at least 1 instance expected");
+        return false;
+    }
+
+    // processing
+
+    vx::audio::AudioEngine::run_unit_tests();
+#if !defined(NDEBUG)
+    printf("* audio engine self-test passed\n");
+#endif
+
+    printf("* %d Sound instances (null backend)\n", count);
+    for (int i = 0; i < 3; ++i) {
+        const double instancesPerSec = vx::audio::AudioEngine::run_benchmark(count);
+        if (instancesPerSec <= 0.0) {
+            err.assign("failed to create Sound instances");
+            return false;
+        }
+        printf("  %.0f instances/sec\n", instancesPerSec);
+    }
+
+    return true;
+}
@@ -0,0 +1,26 @@
+//
+//  bench_audio.hpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#pragma once
+
+// C++
+#include <string>
+
+// cxxopts
+#include <cxxopts.hpp>
+
+/// Benchmarks Sound instances creation, on top of miniaudio's null backend
+/// (no audio output).
+///
+/// Runs the audio engine self-test first (its asserts are only compiled in
+/// debug builds), then creates & destroys `--instances` Sound instances
+/// (default: 10000) of a decoded sound, 3 times, and reports instances per
+/// second.
+///
+/// Returns true on success, false otherwise.
+/// When an error occured, the `err` argument is filled with an error message.
+bool command_bench_audio(cxxopts::ParseResult parseResult, std::string& err);
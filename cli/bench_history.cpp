@@ -0,0 +1,156 @@
+//
+//  bench_history.cpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#include "bench_history.hpp"
+
+// C++
+#include <cstdio>
+
+// Cubzh Core
+#include "color_atlas.h"
+#include "color_palette.h"
+#include "shape.h"
+#include "utils.h"
+
+namespace {
+
+double ms(const uint64_t ns) {
+    return static_cast<double>(ns) / 1000000.0;
+}
+
+void print_row(const char *name, const uint64_t ns) {
+    printf("  %-18s %10.1f ms\n", name, ms(ns));
+}
+
+} // namespace
+
+bool command_bench_history(cxxopts::ParseResult parseResult, std::string& err) {
+
+    // validation
+
+    const uint32_t size = parseResult.count("size") > 0 ? parseResult["size"].as<unsigned int>()
+                                                        : 100;
+    if (size == 0 || size > 1024) {
+        err.assign("size must be between 1 and 1024");
+        return false;
+    }
+
+    // processing
+
+    ColorAtlas *colorAtlas = color_atlas_new();
+    Shape *shape = shape_make_2(true);
+    shape_set_palette(shape, color_palette_new(colorAtlas), false);
+    shape_history_setEnabled(shape, true);
+
+    SHAPE_COLOR_INDEX_INT_T red = 0, green = 0;
+    color_palette_check_and_add_color(shape_get_palette(shape), {255, 0, 0, 255}, &red, false);
+    color_palette_check_and_add_color(shape_get_palette(shape), {0, 255, 0, 255}, &green, false);
+
+    const SHAPE_COORDS_INT_T s = static_cast<SHAPE_COORDS_INT_T>(size);
+    const SHAPE_COORDS_INT_T half = s / 2;
+
+    // fill
+    uint64_t start = utils_time_ns();
+    for (SHAPE_COORDS_INT_T z = -half; z < s - half; ++z) {
+        for (SHAPE_COORDS_INT_T y = 0; y < s; ++y) {
+            for (SHAPE_COORDS_INT_T x = -half; x < s - half; ++x) {
+                shape_add_block_as_transaction(shape, nullptr, red, x, y, z);
+            }
+        }
+    }
+    const uint64_t fillTransaction = utils_time_ns() - start;
+    start = utils_time_ns();
+    shape_apply_current_transaction(shape, false);
+    const uint64_t fillApply = utils_time_ns() - start;
+
+    // paint
+    start = utils_time_ns();
+    for (SHAPE_COORDS_INT_T z = -half; z < s - half; ++z) {
+        for (SHAPE_COORDS_INT_T y = 0; y < s; ++y) {
+            for (SHAPE_COORDS_INT_T x = -half; x < s - half; ++x) {
+                shape_paint_block_as_transaction(shape, green, x, y, z);
+            }
+        }
+    }
+    const uint64_t paintTransaction = utils_time_ns() - start;
+    start = utils_time_ns();
+    shape_apply_current_transaction(shape, false);
+    const uint64_t paintApply = utils_time_ns() - start;
+
+    const size_t nbBlocks = shape_get_nb_blocks(shape);
+
+    start = utils_time_ns();
+    shape_history_undo(shape);
+    const uint64_t paintUndo = utils_time_ns() - start;
+    start = utils_time_ns();
+    shape_history_undo(shape);
+    const uint64_t fillUndo = utils_time_ns() - start;
+    const bool undone = shape_get_nb_blocks(shape) == 0;
+
+    start = utils_time_ns();
+    shape_history_redo(shape);
+    const uint64_t fillRedo = utils_time_ns() - start;
+    start = utils_time_ns();
+    shape_history_redo(shape);
+    const uint64_t paintRedo = utils_time_ns() - start;
+    const bool redone = shape_get_nb_blocks(shape) == nbBlocks;
+
+    printf("* %u³ box, %zu blocks%s\n",
+           size,
+           nbBlocks,
+           undone && redone ? "" : " UNDO/REDO MISMATCH");
+    print_row("fill transaction", fillTransaction);
+    print_row("fill apply & push", fillApply);
+    print_row("paint transaction", paintTransaction);
+    print_row("paint apply & push", paintApply);
+    print_row("undo paint", paintUndo);
+    print_row("undo fill", fillUndo);
+    print_row("redo fill", fillRedo);
+    print_row("redo paint", paintRedo);
+    printf("  history memory: %.1f MB\n",
+           static_cast<double>(shape_history_getMemoryUsage(shape)) /
+               (1024.0 * 1024.0));
+
+    // same edits with region operations, on a new shape
+    Shape *regionShape = shape_make_2(true);
+    shape_set_palette(regionShape, shape_get_palette(shape), true);
+    shape_history_setEnabled(regionShape, true);
+
+    const SHAPE_COORDS_INT3_T min = {static_cast<SHAPE_COORDS_INT_T>(-half), 0,
+                                     static_cast<SHAPE_COORDS_INT_T>(-half)};
+    const SHAPE_COORDS_INT3_T max = {static_cast<SHAPE_COORDS_INT_T>(s - half), s,
+                                     static_cast<SHAPE_COORDS_INT_T>(s - half)};
+
+    start = utils_time_ns();
+    shape_fill_box(regionShape, nullptr, red, min, max);
+    const uint64_t regionFill = utils_time_ns() - start;
+    start = utils_time_ns();
+    shape_replace_color_in_box(regionShape, nullptr, red, green, min, max);
+    const uint64_t regionReplace = utils_time_ns() - start;
+    start = utils_time_ns();
+    shape_copy_box_from(regionShape, nullptr, shape, min, max, {max.x, min.y, min.z});
+    const uint64_t regionCopy = utils_time_ns() - start;
+
+    start = utils_time_ns();
+    shape_history_undo(regionShape);
+    shape_history_undo(regionShape);
+    shape_history_undo(regionShape);
+    const uint64_t regionUndo = utils_time_ns() - start;
+    const bool regionUndone = shape_get_nb_blocks(regionShape) == 0;
+
+    printf("* region operations%s\n", regionUndone ? "" : " UNDO MISMATCH");
+    print_row("fill box", regionFill);
+    print_row("replace color", regionReplace);
+    print_row("copy box", regionCopy);
+    print_row("undo all 3", regionUndo);
+
+    shape_release(regionShape);
+    shape_release(shape);
+    color_atlas_free(colorAtlas);
+
+    return true;
+}
@@ -0,0 +1,26 @@
+//
+//  bench_history.hpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#pragma once
+
+// C++
+#include <string>
+
+// cxxopts
+#include <cxxopts.hpp>
+
+/// Benchmarks shape edition history.
+///
+/// Fills a box of `--size` blocks per axis (default: 100, 1M blocks) in one
+/// transaction, then paints all of it in a second one. Times transactions
+/// application (history push included), undo & redo of both, and reports
+/// history memory usage. Then times the same edits done with region
+/// operations (shape_fill_box, shape_replace_color_in_box, shape_copy_box_from).
+///
+/// Returns true on success, false otherwise.
+/// When an error occured, the `err` argument is filled with an error message.
+bool command_bench_history(cxxopts::ParseResult parseResult, std::string& err);
@@ -0,0 +1,329 @@
+//
+//  bench_index3d.cpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#include "bench_index3d.hpp"
+
+// C++
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Cubzh Core
+#include "doubly_linked_list.h"
+#include "index3d.h"
+#include "utils.h"
+
+namespace {
+
+/// Index3D as it was before being a hash map: a trie of 64 slots nodes per coordinate,
+/// with a linked list for iteration.
+class TrieIndex3D {
+public:
+    TrieIndex3D() : _top(new_node()), _list(doubly_linked_list_new()) {}
+
+    ~TrieIndex3D() {
+        free_node(_top, 1);
+        free(_top);
+        doubly_linked_list_free(_list);
+    }
+
+    void insert(void *ptr, const int32_t x, const int32_t y, const int32_t z) {
+        void **slot = leaf_slot(x, y, z, true);
+        *slot = doubly_linked_list_push_last(_list, ptr);
+    }
+
+    void *get(const int32_t x, const int32_t y, const int32_t z) {
+        void **slot = leaf_slot(x, y, z, false);
+        if (slot == nullptr || *slot == nullptr) {
+            return nullptr;
+        }
+        return doubly_linked_list_node_pointer(static_cast<DoublyLinkedListNode *>(*slot));
+    }
+
+    void *remove(const int32_t x, const int32_t y, const int32_t z) {
+        void **slot = leaf_slot(x, y, z, false);
+        if (slot == nullptr || *slot == nullptr) {
+            return nullptr;
+        }
+        DoublyLinkedListNode *node = static_cast<DoublyLinkedListNode *>(*slot);
+        void *ptr = doubly_linked_list_node_pointer(node);
+        doubly_linked_list_delete_node(_list, node);
+        *slot = nullptr;
+        return ptr;
+    }
+
+    template <typename F>
+    void for_each(F f) {
+        DoublyLinkedListNode *node = doubly_linked_list_first(_list);
+        while (node != nullptr) {
+            f(doubly_linked_list_node_pointer(node));
+            node = doubly_linked_list_node_next(node);
+        }
+    }
+
+private:
+    static const uint32_t LAST = 64;
+
+    static void **new_node() {
+        return static_cast<void **>(calloc(LAST + 1, sizeof(void *)));
+    }
+
+    static void free_node(void **node, const int dimension) {
+        for (uint32_t i = 0; i < LAST; ++i) {
+            if (node[i] != nullptr) {
+                free_node(static_cast<void **>(node[i]), dimension);
+                free(node[i]);
+            }
+        }
+        // last dimension's extra slot stores list nodes, freed with the list
+        if (node[LAST] != nullptr && dimension < 3) {
+            free_node(static_cast<void **>(node[LAST]), dimension + 1);
+            free(node[LAST]);
+        }
+    }
+
+    /// Returns the slot storing the list node of given position,
+    /// or nullptr if not found and `create` is false
+    void **leaf_slot(const int32_t x, const int32_t y, const int32_t z, const bool create) {
+        const uint32_t coords[3] = {static_cast<uint32_t>(x),
+                                    static_cast<uint32_t>(y),
+                                    static_cast<uint32_t>(z)};
+        void **node = _top;
+        for (int d = 0; d < 3; ++d) {
+            uint32_t modulo = coords[d] & (LAST - 1);
+            uint32_t quotient = coords[d] >> 6;
+            while (true) {
+                if (quotient == 0 && modulo == 0) {
+                    if (d == 2) {
+                        return &node[LAST];
+                    }
+                    if (node[LAST] == nullptr) {
+                        if (create == false) {
+                            return nullptr;
+                        }
+                        node[LAST] = new_node();
+                    }
+                    node = static_cast<void **>(node[LAST]);
+                    break;
+                }
+                if (node[modulo] == nullptr) {
+                    if (create == false) {
+                        return nullptr;
+                    }
+                    node[modulo] = new_node();
+                }
+                node = static_cast<void **>(node[modulo]);
+                if (quotient == 0) {
+                    modulo = 0;
+                } else {
+                    modulo = quotient & (LAST - 1);
+                    quotient = quotient >> 6;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    void **_top;
+    DoublyLinkedList *_list;
+};
+
+class HashIndex3D {
+public:
+    HashIndex3D() : _index(index3d_new()) {}
+
+    ~HashIndex3D() {
+        index3d_flush(_index, nullptr);
+        index3d_free(_index);
+    }
+
+    void insert(void *ptr, const int32_t x, const int32_t y, const int32_t z) {
+        index3d_insert(_index, ptr, x, y, z, nullptr);
+    }
+
+    void *get(const int32_t x, const int32_t y, const int32_t z) {
+        return index3d_get(_index, x, y, z);
+    }
+
+    void *remove(const int32_t x, const int32_t y, const int32_t z) {
+        return index3d_remove(_index, x, y, z, nullptr);
+    }
+
+    template <typename F>
+    void for_each(F f) {
+        Index3DIterator *it = index3d_iterator_new(_index);
+        void *ptr;
+        while ((ptr = index3d_iterator_pointer(it)) != nullptr) {
+            f(ptr);
+            index3d_iterator_next(it);
+        }
+        index3d_iterator_free(it);
+    }
+
+private:
+    Index3D *_index;
+};
+
+struct Position {
+    int32_t x, y, z;
+};
+
+struct Timings {
+    uint64_t insert = 0;
+    uint64_t get = 0;
+    uint64_t miss = 0;
+    uint64_t hole = 0;
+    uint64_t iterate = 0;
+    uint64_t remove = 0;
+    uintptr_t checksum = 0;
+};
+
+template <typename Map>
+Timings run(const std::vector<Position>& positions,
+            const std::vector<Position>& lookups,
+            const std::vector<Position>& misses,
+            const std::vector<Position>& holes,
+            std::vector<int>& values,
+            const uint32_t rounds) {
+    Timings t;
+    for (uint32_t r = 0; r < rounds; ++r) {
+        Map map;
+
+        uint64_t start = utils_time_ns();
+        for (size_t i = 0; i < positions.size(); ++i) {
+            map.insert(&values[i], positions[i].x, positions[i].y, positions[i].z);
+        }
+        t.insert += utils_time_ns() - start;
+
+        start = utils_time_ns();
+        for (const Position& p : lookups) {
+            t.checksum += reinterpret_cast<uintptr_t>(map.get(p.x, p.y, p.z));
+        }
+        t.get += utils_time_ns() - start;
+
+        start = utils_time_ns();
+        for (const Position& p : misses) {
+            t.checksum += reinterpret_cast<uintptr_t>(map.get(p.x, p.y, p.z));
+        }
+        t.miss += utils_time_ns() - start;
+
+        start = utils_time_ns();
+        for (const Position& p : holes) {
+            t.checksum += reinterpret_cast<uintptr_t>(map.get(p.x, p.y, p.z));
+        }
+        t.hole += utils_time_ns() - start;
+
+        start = utils_time_ns();
+        map.for_each([&t](void *ptr) { t.checksum += reinterpret_cast<uintptr_t>(ptr); });
+        t.iterate += utils_time_ns() - start;
+
+        start = utils_time_ns();
+        for (const Position& p : lookups) {
+            t.checksum += reinterpret_cast<uintptr_t>(map.remove(p.x, p.y, p.z));
+        }
+        t.remove += utils_time_ns() - start;
+    }
+    return t;
+}
+
+double us(const uint64_t ns, const uint32_t rounds) {
+    return static_cast<double>(ns) / 1000.0 / static_cast<double>(rounds);
+}
+
+void print_row(const char *name, const uint64_t hash, const uint64_t trie, const uint32_t rounds) {
+    printf("  %-8s %12.1f us %12.1f us   x%.1f\n",
+           name,
+           us(hash, rounds),
+           us(trie, rounds),
+           hash > 0 ? static_cast<double>(trie) / static_cast<double>(hash) : 0.0);
+}
+
+void bench(const uint32_t count) {
+    // cube centered on origin, like chunks of a shape (negative coordinates included),
+    // with 1 position out of 8 left empty
+    const double boxCount = static_cast<double>(count) * 8.0 / 7.0;
+    const int32_t side = static_cast<int32_t>(std::ceil(std::cbrt(boxCount)));
+    std::vector<Position> positions;
+    std::vector<Position> empty;
+    positions.reserve(count);
+    uint32_t k = 0;
+    for (int32_t z = 0; z < side && positions.size() < count; ++z) {
+        for (int32_t y = 0; y < side && positions.size() < count; ++y) {
+            for (int32_t x = 0; x < side && positions.size() < count; ++x) {
+                const Position p = {x - side / 2, y - side / 2, z - side / 2};
+                if (k++ % 8 == 7) {
+                    empty.push_back(p);
+                } else {
+                    positions.push_back(p);
+                }
+            }
+        }
+    }
+
+    // lookups & removals in random order, misses right outside of the cube
+    uint32_t seed = 1;
+    std::vector<Position> lookups = positions;
+    for (size_t i = lookups.size(); i > 1; --i) {
+        seed = seed * 1664525u + 1013904223u;
+        std::swap(lookups[i - 1], lookups[(seed >> 8) % i]);
+    }
+    std::vector<Position> misses;
+    misses.reserve(count);
+    for (const Position& p : lookups) {
+        misses.push_back({p.x + side, p.y, p.z});
+    }
+    // as many lookups of empty positions within the cube
+    std::vector<Position> holes;
+    holes.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        holes.push_back(empty[i % empty.size()]);
+    }
+
+    std::vector<int> values(count);
+    const uint32_t rounds = count >= 100000 ? 3 : (count >= 10000 ? 10 : 100);
+
+    const Timings hash = run<HashIndex3D>(positions, lookups, misses, holes, values, rounds);
+    const Timings trie = run<TrieIndex3D>(positions, lookups, misses, holes, values, rounds);
+
+    printf("* %u entries (average of %u rounds)%s\n",
+           count,
+           rounds,
+           hash.checksum == trie.checksum ? "" : " CHECKSUM MISMATCH");
+    printf("  %-8s %15s %15s\n", "", "index3d", "trie (baseline)");
+    print_row("insert", hash.insert, trie.insert, rounds);
+    print_row("get", hash.get, trie.get, rounds);
+    print_row("miss", hash.miss, trie.miss, rounds);
+    print_row("hole", hash.hole, trie.hole, rounds);
+    print_row("iterate", hash.iterate, trie.iterate, rounds);
+    print_row("remove", hash.remove, trie.remove, rounds);
+}
+
+} // namespace
+
+bool command_bench_index3d(cxxopts::ParseResult parseResult, std::string& err) {
+
+    // validation
+
+    std::vector<uint32_t> counts = {1000, 10000, 100000};
+    if (parseResult.count("entries") > 0) {
+        const uint32_t entries = parseResult["entries"].as<unsigned int>();
+        if (entries == 0) {
+            err.assign("at least 1 entry expected");
+            return false;
+        }
+        counts = {entries};
+    }
+
+    // processing
+
+    for (const uint32_t count : counts) {
+        bench(count);
+    }
+
+    return true;
+}
@@ -0,0 +1,27 @@
+//
+//  bench_index3d.hpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#pragma once
+
+// C++
+#include <string>
+
+// cxxopts
+#include <cxxopts.hpp>
+
+/// Benchmarks Index3D, the map used for shape chunks & transactions.
+///
+/// Times insertion, lookups (hits, misses around & holes within the entries),
+/// iteration and removal of `--entries` positions (default: 1000, 10000 and
+/// 100000), both for Index3D and for the trie it used to be, kept here as a
+/// baseline. Beware, trie removals are quadratic (linked list lookup), 100000
+/// entries take about a minute. Positions fill a cube centered on the origin,
+/// like chunks of a shape, 1 position out of 8 being left empty.
+///
+/// Returns true on success, false otherwise.
+/// When an error occured, the `err` argument is filled with an error message.
+bool command_bench_index3d(cxxopts::ParseResult parseResult, std::string& err);
@@ -0,0 +1,159 @@
+//
+//  bench_scene.cpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#include "bench_scene.hpp"
+
+// C++
+#include <cstdio>
+#include <vector>
+
+// Cubzh Core
+#include "color_atlas.h"
+#include "color_palette.h"
+#include "profiler.h"
+#include "rigidBody.h"
+#include "scene.h"
+#include "shape.h"
+#include "transform.h"
+#include "utils.h"
+
+namespace {
+
+const float GRAVITY = -300.0f;
+const TICK_DELTA_SEC_T DT = 1.0 / 60.0;
+
+/// Flat ground of `size`² blocks, with per-block collisions like a game map
+Shape *make_map(ColorAtlas *colorAtlas, const SHAPE_COORDS_INT_T size) {
+    Shape *map = shape_make_2(true);
+    shape_set_palette(map, color_palette_new(colorAtlas), false);
+
+    SHAPE_COLOR_INDEX_INT_T colorIdx = 0;
+    color_palette_check_and_add_color(shape_get_palette(map),
+                                      {120, 180, 90, 255},
+                                      &colorIdx,
+                                      false);
+
+    for (SHAPE_COORDS_INT_T z = 0; z < size; ++z) {
+        for (SHAPE_COORDS_INT_T x = 0; x < size; ++x) {
+            shape_add_block(map, colorIdx, x, 0, z, false);
+        }
+    }
+
+    RigidBody *rb = nullptr;
+    shape_ensure_rigidbody(map, PHYSICS_GROUP_DEFAULT_MAP, PHYSICS_GROUP_NONE, &rb);
+    rigidbody_set_simulation_mode(rb, RigidbodyMode_StaticPerBlock);
+
+    return map;
+}
+
+double us(const uint64_t ns) {
+    return static_cast<double>(ns) / 1000.0;
+}
+
+} // namespace
+
+bool command_bench_scene(cxxopts::ParseResult parseResult, std::string& err) {
+
+    // validation
+
+    const uint32_t nbObjects =
+        parseResult.count("objects") > 0 ? parseResult["objects"].as<unsigned int>() : 500;
+    const uint32_t nbTicks =
+        parseResult.count("ticks") > 0 ? parseResult["ticks"].as<unsigned int>() : 300;
+
+    if (nbTicks == 0) {
+        err.assign("at least 1 tick expected");
+        return false;
+    }
+
+    const std::string tracePath =
+        parseResult.count("trace") > 0 ? parseResult["trace"].as<std::string>() : "";
+
+    // processing
+
+    ColorAtlas *colorAtlas = color_atlas_new();
+    Scene *sc = scene_new(nullptr);
+
+    const float gravity[3] = {0.0f, GRAVITY, 0.0f};
+    scene_set_constant_acceleration(sc, &gravity[0], &gravity[1], &gravity[2]);
+
+    const SHAPE_COORDS_INT_T mapSize = 64;
+    Shape *map = make_map(colorAtlas, mapSize);
+    scene_add_map(sc, map);
+
+    // objects dropped in layers above the map, slightly apart
+    const uint32_t perRow = 16;
+    const Box collider = {{-2.0f, 0.0f, -2.0f}, {2.0f, 4.0f, 2.0f}};
+    for (uint32_t i = 0; i < nbObjects; ++i) {
+        Transform *t = transform_make(PointTransform);
+        RigidBody *rb = nullptr;
+        transform_ensure_rigidbody(t,
+                                   RigidbodyMode_Dynamic,
+                                   PHYSICS_GROUP_DEFAULT_OBJECT,
+                                   PHYSICS_GROUP_DEFAULT_MAP | PHYSICS_GROUP_DEFAULT_OBJECT,
+                                   &rb);
+        rigidbody_set_collider(rb, &collider, true);
+
+        const float x = 2.0f + static_cast<float>(i % perRow) * 3.9f;
+        const float z = 2.0f + static_cast<float>(i / perRow % perRow) * 3.9f;
+        const float y = 10.0f + static_cast<float>(i / (perRow * perRow)) * 8.0f;
+        transform_set_position(t, x, y, z);
+        transform_set_parent(t, scene_get_root(sc), false);
+        transform_release(t); // retained by scene root
+    }
+
+    std::vector<uint64_t> times(nbTicks);
+
+    if (tracePath.empty() == false) {
+        profiler_set_capturing(true);
+    }
+
+    for (uint32_t i = 0; i < nbTicks; ++i) {
+        const uint64_t start = utils_time_ns();
+        scene_refresh(sc, DT, nullptr);
+        times[i] = utils_time_ns() - start;
+    }
+
+    if (tracePath.empty() == false) {
+        profiler_set_capturing(false);
+    }
+
+    uint64_t totalTime = 0;
+    for (uint32_t i = 0; i < nbTicks; ++i) {
+        totalTime += times[i];
+    }
+
+    printf("* %u dynamic objects over a %d² map, %u ticks\n", nbObjects, mapSize, nbTicks);
+    printf("  first tick: %9.1f us\n", us(times[0]));
+    printf("  per tick:   %9.1f us\n", us(totalTime) / nbTicks);
+
+    bool success = true;
+    if (tracePath.empty() == false) {
+        FILE *fd = fopen(tracePath.c_str(), "wb");
+        if (fd == nullptr) {
+            err.assign("can't open trace file: " + tracePath);
+            success = false;
+        } else {
+            success = profiler_write_chrome_trace(fd);
+            fclose(fd);
+            if (success) {
+                printf("* %u profiler zones written to %s\n",
+                       profiler_get_zone_count(),
+                       tracePath.c_str());
+            } else {
+                err.assign("failed to write trace file: " + tracePath);
+            }
+        }
+        profiler_release();
+    }
+
+    scene_free(sc);
+    shape_release(map);
+    color_atlas_free(colorAtlas);
+
+    return success;
+}
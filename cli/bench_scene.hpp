@@ -0,0 +1,28 @@
+//
+//  bench_scene.hpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#pragma once
+
+// C++
+#include <string>
+
+// cxxopts
+#include <cxxopts.hpp>
+
+/// Benchmarks scene ticks.
+///
+/// Builds a scene with a flat map and `--objects` dynamic rigidbodies
+/// (default: 500) falling onto it, then runs `--ticks` scene refreshes
+/// (default: 300) at 60 ticks per second.
+/// Reports time per tick (allocator calls per tick are reported by core_bench,
+/// see core/bench/README.md).
+/// With `--trace <file>`, profiler zones recorded during ticks are written
+/// to `file` in Chrome trace event format.
+///
+/// Returns true on success, false otherwise.
+/// When an error occured, the `err` argument is filled with an error message.
+bool command_bench_scene(cxxopts::ParseResult parseResult, std::string& err);
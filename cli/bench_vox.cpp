@@ -0,0 +1,251 @@
+//
+//  bench_vox.cpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#include "bench_vox.hpp"
+
+// C++
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Cubzh Core
+#include "color_atlas.h"
+#include "color_palette.h"
+#include "magicavoxel.h"
+#include "shape.h"
+#include "stream.h"
+#include "utils.h"
+
+// cli
+#include "job.hpp"
+
+namespace {
+
+void write_uint32(std::vector<char>& bytes, const uint32_t value) {
+    const char b[4] = {
+        static_cast<char>(value & 0xFF),
+        static_cast<char>((value >> 8) & 0xFF),
+        static_cast<char>((value >> 16) & 0xFF),
+        static_cast<char>((value >> 24) & 0xFF)
+    };
+    bytes.insert(bytes.end(), b, b + 4);
+}
+
+void write_chunk_header(std::vector<char>& bytes,
+                        const char *id,
+                        const uint32_t contentSize,
+                        const uint32_t childrenSize) {
+    bytes.insert(bytes.end(), id, id + 4);
+    write_uint32(bytes, contentSize);
+    write_uint32(bytes, childrenSize);
+}
+
+/// Generates a .vox file with `nbModels` models of size³ voxels, each voxel being
+/// filled with a probability of `fill` percent. Voxels are written in random order.
+void generate_vox(std::vector<char>& bytes,
+                  const uint32_t size,
+                  const uint32_t nbModels,
+                  const uint32_t fill) {
+
+    uint32_t seed = 1;
+    auto random = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+
+    std::vector<std::vector<uint8_t>> models(nbModels);
+    uint32_t childrenSize = 12 + 1024; // RGBA
+
+    for (std::vector<uint8_t>& voxels : models) {
+        voxels.reserve(static_cast<size_t>(size) * size * size * 4 * fill / 100 + 4096);
+        for (uint32_t z = 0; z < size; ++z) {
+            for (uint32_t y = 0; y < size; ++y) {
+                for (uint32_t x = 0; x < size; ++x) {
+                    if (random() % 100 < fill) {
+                        const uint8_t v[4] = {
+                            static_cast<uint8_t>(x),
+                            static_cast<uint8_t>(y),
+                            static_cast<uint8_t>(z),
+                            static_cast<uint8_t>(1 + random() % 255)
+                        };
+                        voxels.insert(voxels.end(), v, v + 4);
+                    }
+                }
+            }
+        }
+
+        // shuffle, editors don't write voxels in a convenient order
+        const size_t nbVoxels = voxels.size() / 4;
+        for (size_t i = nbVoxels; i > 1; --i) {
+            const size_t j = random() % i;
+            uint8_t tmp[4];
+            memcpy(tmp, &voxels[(i - 1) * 4], 4);
+            memcpy(&voxels[(i - 1) * 4], &voxels[j * 4], 4);
+            memcpy(&voxels[j * 4], tmp, 4);
+        }
+
+        childrenSize += 12 + 12 + 12 + 4 + static_cast<uint32_t>(voxels.size());
+    }
+
+    bytes.clear();
+    bytes.insert(bytes.end(), {'V', 'O', 'X', ' '});
+    write_uint32(bytes, 150);
+    write_chunk_header(bytes, "MAIN", 0, childrenSize);
+
+    for (const std::vector<uint8_t>& voxels : models) {
+        write_chunk_header(bytes, "SIZE", 12, 0);
+        write_uint32(bytes, size);
+        write_uint32(bytes, size);
+        write_uint32(bytes, size);
+
+        write_chunk_header(bytes, "XYZI", 4 + static_cast<uint32_t>(voxels.size()), 0);
+        write_uint32(bytes, static_cast<uint32_t>(voxels.size() / 4));
+        bytes.insert(bytes.end(), voxels.begin(), voxels.end());
+    }
+
+    write_chunk_header(bytes, "RGBA", 1024, 0);
+    for (uint32_t i = 0; i < 256; ++i) {
+        bytes.push_back(static_cast<char>(i * 7));
+        bytes.push_back(static_cast<char>(i * 13));
+        bytes.push_back(static_cast<char>(i * 29));
+        bytes.push_back(static_cast<char>(255));
+    }
+}
+
+/// Inserts blocks of `src` one by one in a new shape,
+/// resolving palette entries for each block, like the importer used to do.
+Shape *rebuild_block_by_block(const Shape *src, ColorAtlas *colorAtlas) {
+    Shape *dst = shape_make_2(true);
+    shape_set_palette(dst, color_palette_new(colorAtlas), false);
+
+    ColorPalette *srcPalette = shape_get_palette(src);
+    ColorPalette *dstPalette = shape_get_palette(dst);
+
+    SHAPE_COORDS_INT3_T min, max;
+    shape_get_model_aabb_2(src, &min, &max);
+
+    for (SHAPE_COORDS_INT_T z = min.z; z < max.z; ++z) {
+        for (SHAPE_COORDS_INT_T y = min.y; y < max.y; ++y) {
+            for (SHAPE_COORDS_INT_T x = min.x; x < max.x; ++x) {
+                const Block *b = shape_get_block_immediate(src, x, y, z);
+                if (b == nullptr || block_is_solid(b) == false) {
+                    continue;
+                }
+                SHAPE_COLOR_INDEX_INT_T colorIdx = b->colorIndex;
+                if (color_palette_check_and_add_color(dstPalette,
+                                                      color_palette_get_color(srcPalette, colorIdx),
+                                                      &colorIdx,
+                                                      false) == false) {
+                    colorIdx = 0;
+                }
+                shape_add_block(dst, colorIdx, x, y, z, false);
+            }
+        }
+    }
+    color_palette_clear_lighting_dirty(dstPalette);
+
+    return dst;
+}
+
+double ms(const uint64_t ns) {
+    return static_cast<double>(ns) / 1000000.0;
+}
+
+} // namespace
+
+bool command_bench_vox(cxxopts::ParseResult parseResult, std::string& err) {
+
+    // validation
+
+    if (parseResult.count("input") > 1) {
+        err.assign("only 1 input file is allowed");
+        return false;
+    }
+
+    const uint32_t size = parseResult.count("size") > 0 ? parseResult["size"].as<unsigned int>() : 256;
+    const uint32_t nbModels = parseResult.count("models") > 0 ? parseResult["models"].as<unsigned int>() : 1;
+    const uint32_t fill = parseResult.count("fill") > 0 ? parseResult["fill"].as<unsigned int>() : 50;
+    const bool baseline = parseResult.count("baseline") > 0;
+
+    if (size == 0 || size > 256) {
+        err.assign("size must be between 1 and 256");
+        return false;
+    }
+    if (nbModels == 0) {
+        err.assign("at least 1 model expected");
+        return false;
+    }
+    if (fill > 100) {
+        err.assign("fill must be a percentage");
+        return false;
+    }
+
+    // processing
+
+    std::vector<char> bytes;
+    JobTimings timings;
+
+    if (parseResult.count("input") == 1) {
+        const std::string inputPath = parseResult["input"].as<std::vector<std::string>>().front();
+        if (job_read_file(inputPath, bytes, &timings, err) == false) {
+            return false;
+        }
+        printf("* %s\n", inputPath.c_str());
+    } else {
+        const uint64_t start = utils_time_ns();
+        generate_vox(bytes, size, nbModels, fill);
+        printf("* synthetic: %u model(s) of %u³, %u%% filled (generated in %.1f ms)\n",
+               nbModels, size, fill, ms(utils_time_ns() - start));
+    }
+
+    ColorAtlas *colorAtlas = color_atlas_new();
+
+    Shape **shapes = nullptr;
+    size_t nbShapes = 0;
+    enum serialization_magicavoxel_error error = no_error;
+    const uint64_t start = utils_time_ns();
+    {
+        JobLoadScope scope(&timings);
+        Stream *s = stream_new_buffer_read(bytes.data(), bytes.size());
+        error = serialization_vox_to_shapes(s, &shapes, &nbShapes, true, colorAtlas);
+        stream_free(s);
+    }
+    const uint64_t importTime = utils_time_ns() - start;
+
+    if (error != no_error) {
+        err.assign("can't parse .vox");
+        color_atlas_free(colorAtlas);
+        return false;
+    }
+
+    size_t nbBlocks = 0;
+    for (size_t i = 0; i < nbShapes; ++i) {
+        nbBlocks += shape_get_nb_blocks(shapes[i]);
+    }
+
+    printf("  %zu bytes, %zu shape(s), %zu blocks\n", bytes.size(), nbShapes, nbBlocks);
+    printf("  import:   %9.1f ms (parse %.1f ms, build %.1f ms)\n",
+           ms(importTime), ms(timings.parse), ms(timings.build));
+
+    if (baseline) {
+        const uint64_t baselineStart = utils_time_ns();
+        for (size_t i = 0; i < nbShapes; ++i) {
+            shape_release(rebuild_block_by_block(shapes[i], colorAtlas));
+        }
+        const uint64_t baselineTime = utils_time_ns() - baselineStart;
+        printf("  baseline: %9.1f ms (block by block insertion, x%.1f)\n",
+               ms(baselineTime), static_cast<double>(baselineTime) / static_cast<double>(importTime));
+    }
+
+    for (size_t i = 0; i < nbShapes; ++i) {
+        shape_release(shapes[i]);
+    }
+    free(shapes);
+    color_atlas_free(colorAtlas);
+
+    return true;
+}
@@ -0,0 +1,26 @@
+//
+//  bench_vox.hpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#pragma once
+
+// C++
+#include <string>
+
+// cxxopts
+#include <cxxopts.hpp>
+
+/// Benchmarks MagicaVoxel import.
+///
+/// Imports the input .vox file, or a synthetic one generated in memory when no
+/// input is given (`--size` voxels per axis, `--models` models, `--fill` percent
+/// of each model filled with random colors, deterministic).
+/// With `--baseline`, the same voxels are also inserted one by one with
+/// `shape_add_block`, for comparison.
+///
+/// Returns true on success, false otherwise.
+/// When an error occured, the `err` argument is filled with an error message.
+bool command_bench_vox(cxxopts::ParseResult parseResult, std::string& err);
@@ -5,7 +5,7 @@
 //  Created by Gaetan de Villele on 13/10/2022.
 //
 
-#include "combine.hpp"
+#include "blocks.hpp"
 
 // C++
 #include <iostream>
@@ -35,15 +35,32 @@ bool count_blocks(cxxopts::ParseResult parseResult, std::string& err) {
     // processing
 
     const std::string input_path = parseResult["input"].as<std::vector<std::string>>()[0];
-    
-    FILE * const fd = fopen(input_path.c_str(), "rb");
-    if (fd == nullptr) {
-        err.assign("can't open input file: " + input_path);
+
+    ColorAtlas * const colorAtlas = color_atlas_new();
+    size_t blockCount = 0;
+    const bool success = blocks_count(input_path, colorAtlas, blockCount, nullptr, err);
+    color_atlas_free(colorAtlas);
+
+    if (success == false) {
         return false;
     }
 
-    ColorAtlas * const colorAtlas = color_atlas_new();
-    Stream * const stream = stream_new_file_read(fd); // Stream is responsible for fclose-ing the file descriptor
+    // Don't print a new line ('\n') character since this command is used by another program (the Hub CLI)
+    std::cout << blockCount;
+    
+    return true;
+}
+
+bool blocks_count(const std::string& inputPath,
+                  ColorAtlas *colorAtlas,
+                  size_t& blockCount,
+                  JobTimings *timings,
+                  std::string& err) {
+
+    std::vector<char> bytes;
+    if (job_read_file(inputPath, bytes, timings, err) == false) {
+        return false;
+    }
 
     const LoadShapeSettings shapeSettings = {
         .lighting = false,
@@ -51,22 +68,25 @@ bool count_blocks(cxxopts::ParseResult parseResult, std::string& err) {
     };
 
     const bool allowLegacy = true; // support .pcubes files
-    DoublyLinkedList *assets = serialization_load_assets(stream,
-                                                         "",
-                                                         AssetType_Shape,
-                                                         colorAtlas,
-                                                         &shapeSettings,
-                                                         allowLegacy);
-    // `stream` is freed here (done by `serialization_load_assets`)
-    // `stream` took care of fclose-ing `fd`
+    DoublyLinkedList *assets = nullptr;
+    {
+        JobLoadScope scope(timings);
+        // `stream` is freed by `serialization_load_assets`, `bytes` remains owned here
+        Stream * const stream = stream_new_buffer_read(bytes.data(), bytes.size());
+        assets = serialization_load_assets(stream,
+                                           "",
+                                           AssetType_Shape,
+                                           colorAtlas,
+                                           &shapeSettings,
+                                           allowLegacy);
+    }
     if (assets == NULL) {
-        color_atlas_free(colorAtlas);
         err.assign("can't load assets");
         return false;
     }
-    
-    size_t blockCount = 0;
-    
+
+    blockCount = 0;
+
     DoublyLinkedListNode *node = doubly_linked_list_first(assets);
     while (node != NULL) {
         Asset * const r = (Asset *)doubly_linked_list_node_pointer(node);
@@ -78,11 +98,6 @@ bool count_blocks(cxxopts::ParseResult parseResult, std::string& err) {
     }
     doubly_linked_list_flush(assets, free);
     doubly_linked_list_free(assets);
-    
-    color_atlas_free(colorAtlas);
 
-    // Don't print a new line ('\n') character since this command is used by another program (the Hub CLI)
-    std::cout << blockCount;
-    
     return true;
 }
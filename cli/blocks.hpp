@@ -13,6 +13,20 @@
 // cxxopts
 #include <cxxopts.hpp>
 
+// Cubzh Core
+#include "color_atlas.h"
+
+// cli
+#include "job.hpp"
+
 /// Returns true on success, false otherwise.
 /// When an error occured, the `err` argument is filled with an error message.
 bool count_blocks(cxxopts::ParseResult parseResult, std::string& err);
+
+/// Counts blocks of all shapes in the given file, using the provided color atlas.
+/// `timings` is optional.
+bool blocks_count(const std::string& inputPath,
+                  ColorAtlas *colorAtlas,
+                  size_t& blockCount,
+                  JobTimings *timings,
+                  std::string& err);
@@ -46,65 +46,66 @@ bool command_combine(cxxopts::ParseResult parseResult, std::string& err) {
     std::cout << "  output: " << output_path << std::endl;
     
     ColorAtlas *colorAtlas = color_atlas_new();
-    
-    Shape **shapes = (Shape**)malloc(sizeof(Shape*) * input_paths.size());
-    int index = 0;
-    
-    for (std::string input_path : input_paths) {
-        
-        FILE *fd = fopen(input_path.c_str(), "rw");
-        if (fd == nullptr) {
-            err = std::string("can't open ") + input_path;
+    const bool success = combine_vox_files(input_paths, output_path, colorAtlas, nullptr, err);
+    color_atlas_free(colorAtlas);
+
+    return success;
+}
+
+bool combine_vox_files(const std::vector<std::string>& inputPaths,
+                       const std::string& outputPath,
+                       ColorAtlas *colorAtlas,
+                       JobTimings *timings,
+                       std::string& err) {
+
+    // each input file can contain several models
+    std::vector<Shape*> shapes;
+    std::vector<char> bytes;
+
+    for (const std::string& input_path : inputPaths) {
+
+        if (job_read_file(input_path, bytes, timings, err) == false) {
             break;
         }
-        
-        Stream *s = stream_new_file_read(fd);
-        
-        Shape *shape = nullptr;
-        
-        enum serialization_magicavoxel_error error = serialization_vox_to_shape(s,
-                                                                                &shape,
-                                                                                true,
-                                                                                colorAtlas);
-        
-        if (shape != nullptr) {
-            shapes[index] = shape;
-            ++index;
+
+        Shape **fileShapes = nullptr;
+        size_t nbFileShapes = 0;
+        enum serialization_magicavoxel_error error = no_error;
+        {
+            JobLoadScope scope(timings);
+            Stream *s = stream_new_buffer_read(bytes.data(), bytes.size());
+            error = serialization_vox_to_shapes(s, &fileShapes, &nbFileShapes, true, colorAtlas);
+            stream_free(s);
+        }
+
+        for (size_t i = 0; i < nbFileShapes; ++i) {
+            shapes.push_back(fileShapes[i]);
         }
-        
-        stream_free(s);
-        
+        free(fileShapes);
+
         if (error != no_error) {
             err = std::string("can't parse ") + input_path;
             break;
         }
     }
-    
-    if (err.empty() && index > 0) {
-        
-        FILE *dst = fopen(output_path.c_str(), "wb");
+
+    if (err.empty() && shapes.empty() == false) {
+
+        FILE *dst = fopen(outputPath.c_str(), "wb");
         if (dst == nullptr) {
-            err = std::string("can't create ") + output_path;
+            err = std::string("can't create ") + outputPath;
         } else {
-            const bool success = serialization_shapes_to_vox(shapes, (size_t)index, dst);
+            const bool success = serialization_shapes_to_vox(shapes.data(), shapes.size(), dst);
             if (success == false) {
-                err = std::string("can't export to ") + output_path;
+                err = std::string("can't export to ") + outputPath;
             }
-            // serialization_save_vox(shapes.at(0), dst);
             fclose(dst);
         }
     }
-    
-    for (int i = 0; i < index; ++i) {
-        shape_release(shapes[i]);
-    }
-    free(shapes);
-    
-    color_atlas_free(colorAtlas);
-    
-    if (err.empty() == false) {
-        return false;
+
+    for (Shape *shape : shapes) {
+        shape_release(shape);
     }
-    
-    return true;
+
+    return err.empty();
 }
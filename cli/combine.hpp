@@ -9,10 +9,25 @@
 
 // C++
 #include <string>
+#include <vector>
 
 // cxxopts
 #include <cxxopts.hpp>
 
+// Cubzh Core
+#include "color_atlas.h"
+
+// cli
+#include "job.hpp"
+
 /// Returns true on success, false otherwise.
 /// When an error occured, the `err` argument is filled with an error message.
 bool command_combine(cxxopts::ParseResult parseResult, std::string& err);
+
+/// Combines all models of the given .vox files into a single one, using the provided color atlas.
+/// `timings` is optional.
+bool combine_vox_files(const std::vector<std::string>& inputPaths,
+                       const std::string& outputPath,
+                       ColorAtlas *colorAtlas,
+                       JobTimings *timings,
+                       std::string& err);
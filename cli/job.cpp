@@ -0,0 +1,79 @@
+//
+//  job.cpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#include "job.hpp"
+
+// C
+#include <cstdio>
+
+// Cubzh Core
+#include "utils.h"
+
+JobTimings::JobTimings() :
+read(0),
+inflate(0),
+parse(0),
+build(0) {}
+
+bool job_read_file(const std::string& path,
+                   std::vector<char>& bytes,
+                   JobTimings *timings,
+                   std::string& err) {
+
+    const uint64_t start = timings != nullptr ? utils_time_ns() : 0;
+
+    FILE * const fd = fopen(path.c_str(), "rb");
+    if (fd == nullptr) {
+        err.assign("can't open input file: " + path);
+        return false;
+    }
+
+    bool success = fseek(fd, 0, SEEK_END) == 0;
+    const long size = success ? ftell(fd) : -1;
+    success = size >= 0 && fseek(fd, 0, SEEK_SET) == 0;
+
+    if (success) {
+        bytes.resize(static_cast<size_t>(size));
+        success = size == 0 || fread(bytes.data(), static_cast<size_t>(size), 1, fd) == 1;
+    }
+    fclose(fd);
+
+    if (success == false) {
+        bytes.clear();
+        err.assign("can't read input file: " + path);
+        return false;
+    }
+
+    if (timings != nullptr) {
+        timings->read += utils_time_ns() - start;
+    }
+    return true;
+}
+
+JobLoadScope::JobLoadScope(JobTimings *timings) :
+_timings(timings),
+_loadTimings(),
+_start(0) {
+    if (_timings != nullptr) {
+        _loadTimings.inflate_ns = 0;
+        _loadTimings.build_ns = 0;
+        serialization_set_load_timings(&_loadTimings);
+        _start = utils_time_ns();
+    }
+}
+
+JobLoadScope::~JobLoadScope() {
+    if (_timings != nullptr) {
+        const uint64_t total = utils_time_ns() - _start;
+        serialization_set_load_timings(nullptr);
+
+        const uint64_t stages = _loadTimings.inflate_ns + _loadTimings.build_ns;
+        _timings->inflate += _loadTimings.inflate_ns;
+        _timings->build += _loadTimings.build_ns;
+        _timings->parse += total > stages ? total - stages : 0;
+    }
+}
@@ -0,0 +1,47 @@
+//
+//  job.hpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#pragma once
+
+// C++
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Cubzh Core
+#include "serialization.h"
+
+/// Durations of each stage of a job, in nanoseconds.
+struct JobTimings {
+    JobTimings();
+
+    uint64_t read;    // loading files in memory
+    uint64_t inflate; // chunks decompression
+    uint64_t parse;   // everything else done while loading
+    uint64_t build;   // blocks insertion in shapes
+};
+
+/// Reads the whole file in memory.
+/// When `timings` is not null, the duration is added to `timings->read`.
+bool job_read_file(const std::string& path,
+                   std::vector<char>& bytes,
+                   JobTimings *timings,
+                   std::string& err);
+
+/// Collects core serialization timings for loads done by the calling thread
+/// while it's in scope, then distributes them in the given `JobTimings`.
+/// Does nothing when `timings` is null.
+class JobLoadScope final {
+public:
+    JobLoadScope(JobTimings *timings);
+    ~JobLoadScope();
+
+private:
+    JobTimings *_timings;
+    SerializationLoadTimings _loadTimings;
+    uint64_t _start;
+};
@@ -12,22 +12,20 @@
 #include <cxxopts.hpp>
 
 // cli
+#include "batch.hpp"
+#include "bench_audio.hpp"
+#include "bench_history.hpp"
+#include "bench_index3d.hpp"
+#include "bench_scene.hpp"
+#include "bench_vox.hpp"
 #include "blocks.hpp"
 #include "combine.hpp"
+#include "options.hpp"
 #include "shape_point.hpp"
 
 int main(int argc, const char * argv[]) {
 
-    cxxopts::Options options("Cubzh", "Tools for voxels.");
-
-    options.add_options()
-    ("command", "command to use", cxxopts::value<std::string>())
-    ("i,input", "input files", cxxopts::value<std::vector<std::string>>())
-    // ("n,name", "input file name", cxxopts::value<std::vector<std::string>>())
-    ("o,output", "output file", cxxopts::value<std::string>())
-    ;
-
-    options.parse_positional({"command"});
+    cxxopts::Options options = cli_options();
 
     auto result = options.parse(argc, argv);
     
@@ -47,6 +45,18 @@ int main(int argc, const char * argv[]) {
         success = command_combine(result, err);
     } else if (command == "setpoint") {
         success = commandSetPoint(result, err);
+    } else if (command == "batch") {
+        success = command_batch(result, err);
+    } else if (command == "bench-vox") {
+        success = command_bench_vox(result, err);
+    } else if (command == "bench-index3d") {
+        success = command_bench_index3d(result, err);
+    } else if (command == "bench-history") {
+        success = command_bench_history(result, err);
+    } else if (command == "bench-scene") {
+        success = command_bench_scene(result, err);
+    } else if (command == "bench-audio") {
+        success = command_bench_audio(result, err);
     } else {
         err = "command not supported.";
     }
@@ -0,0 +1,39 @@
+//
+//  options.cpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#include "options.hpp"
+
+// C++
+#include <string>
+#include <vector>
+
+cxxopts::Options cli_options() {
+
+    cxxopts::Options options("Cubzh", "Tools for voxels.");
+
+    options.add_options()
+    ("command", "command to use", cxxopts::value<std::string>())
+    ("i,input", "input files", cxxopts::value<std::vector<std::string>>())
+    // ("n,name", "input file name", cxxopts::value<std::vector<std::string>>())
+    ("o,output", "output file", cxxopts::value<std::string>())
+    ("j,jobs", "batch: number of worker threads (default: number of cores)", cxxopts::value<unsigned int>())
+    ("bench", "batch: report per-stage timings (read, inflate, parse, build)")
+    ("size", "bench-vox: synthetic model size (default: 256), bench-history: box size (default: 100)", cxxopts::value<unsigned int>())
+    ("models", "bench-vox: synthetic models count (default: 1)", cxxopts::value<unsigned int>())
+    ("fill", "bench-vox: synthetic models fill percentage (default: 50)", cxxopts::value<unsigned int>())
+    ("baseline", "bench-vox: also time block by block insertion")
+    ("entries", "bench-index3d: number of entries (default: 1000, 10000 & 100000)", cxxopts::value<unsigned int>())
+    ("objects", "bench-scene: number of dynamic objects (default: 500)", cxxopts::value<unsigned int>())
+    ("ticks", "bench-scene: number of ticks (default: 300)", cxxopts::value<unsigned int>())
+    ("trace", "bench-scene: write a Chrome trace of profiler zones to given file", cxxopts::value<std::string>())
+    ("instances", "bench-audio: number of Sound instances (default: 10000)", cxxopts::value<unsigned int>())
+    ;
+
+    options.parse_positional({"command"});
+
+    return options;
+}
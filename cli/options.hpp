@@ -0,0 +1,14 @@
+//
+//  options.hpp
+//  cli
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//
+
+#pragma once
+
+// cxxopts
+#include <cxxopts.hpp>
+
+/// Command line options, shared by the main command line & batch jobs.
+cxxopts::Options cli_options();
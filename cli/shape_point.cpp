@@ -34,6 +34,10 @@ bool commandSetPoint(cxxopts::ParseResult parseResult, std::string& err) {
     }
 
     const std::vector<std::string>& args = parseResult.unmatched();
+    if (args.size() != 7) {
+        err.assign("expected arguments: <name> <x> <y> <z> <rx> <ry> <rz>");
+        return false;
+    }
 
     const std::string pointName = args[0];
     // printf("point name: %s\n", pointName.c_str());
@@ -48,43 +52,75 @@ bool commandSetPoint(cxxopts::ParseResult parseResult, std::string& err) {
     float rz = std::stof(args[6]);
     // printf("point rot: %f %f %f\n", rx, ry, rz);
 
+    ColorAtlas *colorAtlas = color_atlas_new();
+    const bool success = shape_set_point(inputPath,
+                                         outputPath,
+                                         pointName,
+                                         {x, y, z},
+                                         {rx, ry, rz},
+                                         colorAtlas,
+                                         nullptr,
+                                         err);
+    color_atlas_free(colorAtlas);
+
+    return success;
+}
+
+bool shape_set_point(const std::string& inputPath,
+                     const std::string& outputPath,
+                     const std::string& pointName,
+                     const float3& position,
+                     const float3& rotation,
+                     ColorAtlas *colorAtlas,
+                     JobTimings *timings,
+                     std::string& err) {
+
     // Read input file
-    FILE *fd = fopen(inputPath.c_str(), "rb");
-    if (fd == nullptr) {
-        // TODO: handle error
+    std::vector<char> bytes;
+    if (job_read_file(inputPath, bytes, timings, err) == false) {
         return false;
     }
 
-    // The file descriptor is owned by the stream, which will fclose it in the future.
-    Stream *stream = stream_new_file_read(fd);
-    ColorAtlas *colorAtlas = color_atlas_new();
-
     LoadShapeSettings settings = {
         .lighting = false,
         .isMutable = true
     };
 
-    Shape *shape = serialization_load_shape(stream, // frees stream, closing fd
-                                            "",
-                                            colorAtlas,
-                                            &settings,
-                                            false); // allowLegacy
-    float3 posf3 = {x, y, z};
+    Shape *shape = nullptr;
+    {
+        JobLoadScope scope(timings);
+        Stream *stream = stream_new_buffer_read(bytes.data(), bytes.size());
+        shape = serialization_load_shape(stream, // frees stream
+                                         "",
+                                         colorAtlas,
+                                         &settings,
+                                         false); // allowLegacy
+    }
+    if (shape == nullptr) {
+        err.assign("can't load shape: " + inputPath);
+        return false;
+    }
+
+    float3 posf3 = position;
     shape_set_point_of_interest(shape, pointName.c_str(), &posf3);
 
-    float3 rotf3 = {rx, ry, rz};
+    float3 rotf3 = rotation;
     shape_set_point_rotation(shape, pointName.c_str(), &rotf3);
 
     FILE *outfd = fopen(outputPath.c_str(), "wb");
-    if (fd == nullptr) {
-        // TODO: handle error
+    if (outfd == nullptr) {
+        shape_free(shape);
+        err.assign("can't create output file: " + outputPath);
         return false;
     }
 
-    // bool ok =
-    serialization_save_shape(shape, nullptr /*preview data*/, 0, outfd);
-    // printf("Write file: %s\n", ok ? "OK" : "FAILED");
+    // closes outfd
+    const bool ok = serialization_save_shape(shape, nullptr /*preview data*/, 0, outfd);
+    shape_free(shape);
 
-    color_atlas_free(colorAtlas);
+    if (ok == false) {
+        err.assign("can't write output file: " + outputPath);
+        return false;
+    }
     return true;
 }
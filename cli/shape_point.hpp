@@ -13,6 +13,24 @@
 // cxxopts
 #include <cxxopts.hpp>
 
+// Cubzh Core
+#include "color_atlas.h"
+#include "float3.h"
+
+// cli
+#include "job.hpp"
+
 /// Returns true on success, false otherwise.
 /// When an error occured, the `err` argument is filled with an error message.
 bool commandSetPoint(cxxopts::ParseResult parseResult, std::string& err);
+
+/// Sets point of interest position & rotation in a .3zh file, using the provided color atlas.
+/// `timings` is optional.
+bool shape_set_point(const std::string& inputPath,
+                     const std::string& outputPath,
+                     const std::string& pointName,
+                     const float3& position,
+                     const float3& rotation,
+                     ColorAtlas *colorAtlas,
+                     JobTimings *timings,
+                     std::string& err);
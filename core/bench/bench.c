@@ -0,0 +1,223 @@
+// -------------------------------------------------------------
+//  Cubzh Core Benchmarks
+//  bench.c
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#include "bench.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "color_palette.h"
+
+#define BENCH_NAME_MAX_LENGTH 64
+
+typedef struct {
+    char name[BENCH_NAME_MAX_LENGTH];
+    uint64_t min;
+    uint64_t max;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    double mean;
+    /// average allocator calls per sample, negative when not reported
+    double allocations;
+    uint32_t count;
+    char pad[4];
+} BenchCase;
+
+struct _BenchSuite {
+    BenchCase *cases;
+    uint32_t nbCases;
+    uint32_t casesCapacity;
+    uint32_t iterations;
+    char pad[4];
+};
+
+static int _bench_compare_samples(const void *a, const void *b) {
+    const uint64_t sa = *(const uint64_t *)a;
+    const uint64_t sb = *(const uint64_t *)b;
+    return sa < sb ? -1 : (sa > sb ? 1 : 0);
+}
+
+/// Nearest-rank percentile of sorted samples
+static uint64_t _bench_percentile(const uint64_t *sorted, const uint32_t count, const uint32_t p) {
+    uint32_t rank = (p * count + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    return sorted[rank - 1];
+}
+
+BenchSuite *bench_suite_new(const uint32_t iterations) {
+    BenchSuite *b = (BenchSuite *)malloc(sizeof(BenchSuite));
+    if (b == NULL) {
+        return NULL;
+    }
+    b->cases = NULL;
+    b->nbCases = 0;
+    b->casesCapacity = 0;
+    b->iterations = iterations > 0 ? iterations : 1;
+    return b;
+}
+
+void bench_suite_free(BenchSuite *b) {
+    if (b == NULL) {
+        return;
+    }
+    free(b->cases);
+    free(b);
+}
+
+uint32_t bench_get_iterations(const BenchSuite *b) {
+    return b->iterations;
+}
+
+void bench_report(BenchSuite *b, const char *name, uint64_t *samples, const uint32_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (b->nbCases == b->casesCapacity) {
+        const uint32_t capacity = b->casesCapacity == 0 ? 16 : b->casesCapacity * 2;
+        BenchCase *cases = (BenchCase *)realloc(b->cases, sizeof(BenchCase) * capacity);
+        if (cases == NULL) {
+            return;
+        }
+        b->cases = cases;
+        b->casesCapacity = capacity;
+    }
+
+    qsort(samples, count, sizeof(uint64_t), _bench_compare_samples);
+
+    BenchCase *c = &b->cases[b->nbCases++];
+    snprintf(c->name, BENCH_NAME_MAX_LENGTH, "%s", name);
+    c->count = count;
+    c->min = samples[0];
+    c->max = samples[count - 1];
+    c->p50 = _bench_percentile(samples, count, 50);
+    c->p90 = _bench_percentile(samples, count, 90);
+    c->p99 = _bench_percentile(samples, count, 99);
+    double sum = 0.0;
+    for (uint32_t i = 0; i < count; ++i) {
+        sum += (double)samples[i];
+    }
+    c->mean = sum / (double)count;
+    c->allocations = -1.0;
+
+    fprintf(stderr,
+            "%-40s p50 %12.3f ms   p90 %12.3f ms   (%u samples)\n",
+            c->name,
+            (double)c->p50 / 1000000.0,
+            (double)c->p90 / 1000000.0,
+            count);
+}
+
+void bench_report_allocations(BenchSuite *b, const double allocationsPerSample) {
+    if (b->nbCases == 0 || bench_allocations_counted() == false) {
+        return;
+    }
+    BenchCase *c = &b->cases[b->nbCases - 1];
+    c->allocations = allocationsPerSample;
+    fprintf(stderr, "%-40s %.1f allocations per sample\n", c->name, allocationsPerSample);
+}
+
+bool bench_write_json(const BenchSuite *b, FILE *fd) {
+    if (fprintf(fd, "{\n  \"unit\": \"ns\",\n  \"iterations\": %u,\n", b->iterations) < 0) {
+        return false;
+    }
+    if (fprintf(fd, "  \"benchmarks\": [") < 0) {
+        return false;
+    }
+    for (uint32_t i = 0; i < b->nbCases; ++i) {
+        const BenchCase *c = &b->cases[i];
+        if (fprintf(fd,
+                    "%s\n    {\"name\": \"%s\", \"samples\": %u, \"min\": %llu, \"mean\": %.0f, "
+                    "\"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"max\": %llu",
+                    i > 0 ? "," : "",
+                    c->name,
+                    c->count,
+                    (unsigned long long)c->min,
+                    c->mean,
+                    (unsigned long long)c->p50,
+                    (unsigned long long)c->p90,
+                    (unsigned long long)c->p99,
+                    (unsigned long long)c->max) < 0) {
+            return false;
+        }
+        if (c->allocations >= 0.0 && fprintf(fd, ", \"allocations\": %.1f", c->allocations) < 0) {
+            return false;
+        }
+        if (fprintf(fd, "}") < 0) {
+            return false;
+        }
+    }
+    return fprintf(fd, "\n  ]\n}\n") >= 0;
+}
+
+// MARK: - Synthetic data -
+
+uint32_t bench_rand(uint32_t *state) {
+    // xorshift32, state must not be 0
+    uint32_t x = *state != 0 ? *state : 0x9E3779B9u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+float bench_rand_float(uint32_t *state) {
+    return (float)(bench_rand(state) >> 8) / 16777216.0f;
+}
+
+static float _bench_lattice(const int32_t x, const int32_t z) {
+    uint32_t h = (uint32_t)x * 374761393u + (uint32_t)z * 668265263u;
+    h = (h ^ (h >> 13)) * 1274126177u;
+    h ^= h >> 16;
+    return (float)(h & 0xFFFF) / 65535.0f;
+}
+
+static float _bench_value_noise(const float x, const float z) {
+    const float fx0 = floorf(x);
+    const float fz0 = floorf(z);
+    const int32_t x0 = (int32_t)fx0;
+    const int32_t z0 = (int32_t)fz0;
+    float tx = x - fx0;
+    float tz = z - fz0;
+    tx = tx * tx * (3.0f - 2.0f * tx);
+    tz = tz * tz * (3.0f - 2.0f * tz);
+    const float a = _bench_lattice(x0, z0);
+    const float b = _bench_lattice(x0 + 1, z0);
+    const float c = _bench_lattice(x0, z0 + 1);
+    const float d = _bench_lattice(x0 + 1, z0 + 1);
+    return (a + (b - a) * tx) + ((c + (d - c) * tx) - (a + (b - a) * tx)) * tz;
+}
+
+Shape *bench_make_terrain(ColorAtlas *atlas, const SHAPE_COORDS_INT_T size, const bool isMutable) {
+    Shape *s = shape_make_2(isMutable);
+    shape_set_palette(s, color_palette_new(atlas), false);
+
+    ColorPalette *palette = shape_get_palette(s);
+    SHAPE_COLOR_INDEX_INT_T grass, dirt, stone;
+    color_palette_check_and_add_color(palette, (RGBAColor){110, 180, 70, 255}, &grass, false);
+    color_palette_check_and_add_color(palette, (RGBAColor){130, 90, 60, 255}, &dirt, false);
+    color_palette_check_and_add_color(palette, (RGBAColor){120, 120, 130, 255}, &stone, false);
+
+    const float maxHeight = (float)(size / 2 > 1 ? size / 2 : 1);
+    for (SHAPE_COORDS_INT_T z = 0; z < size; ++z) {
+        for (SHAPE_COORDS_INT_T x = 0; x < size; ++x) {
+            const float n = 0.65f * _bench_value_noise((float)x / 32.0f, (float)z / 32.0f) +
+                            0.35f * _bench_value_noise((float)x / 8.0f, (float)z / 8.0f);
+            const SHAPE_COORDS_INT_T h = (SHAPE_COORDS_INT_T)(1.0f + n * (maxHeight - 1.0f));
+            for (SHAPE_COORDS_INT_T y = 0; y < h; ++y) {
+                const SHAPE_COLOR_INDEX_INT_T color = y == h - 1 ? grass
+                                                      : y >= h - 4 ? dirt
+                                                                   : stone;
+                shape_add_block(s, color, x, y, z, false);
+            }
+        }
+    }
+    return s;
+}
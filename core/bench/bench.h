@@ -0,0 +1,60 @@
+// -------------------------------------------------------------
+//  Cubzh Core Benchmarks
+//  bench.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "color_atlas.h"
+#include "shape.h"
+
+typedef struct _BenchSuite BenchSuite;
+
+typedef void (*bench_func)(BenchSuite *b);
+
+typedef struct {
+    const char *name;
+    bench_func func;
+} BenchEntry;
+
+BenchSuite *bench_suite_new(const uint32_t iterations);
+void bench_suite_free(BenchSuite *b);
+
+/// Number of timed iterations per case (--iterations), a warm-up iteration is run before
+uint32_t bench_get_iterations(const BenchSuite *b);
+
+/// Adds a case to the report, `samples` are durations in nanoseconds (sorted in place).
+/// `name` is copied, conventionally "<group>/<case>".
+void bench_report(BenchSuite *b, const char *name, uint64_t *samples, const uint32_t count);
+
+/// Sets average allocator calls per sample of the last reported case.
+void bench_report_allocations(BenchSuite *b, const double allocationsPerSample);
+
+/// Writes all reported cases as JSON: nanoseconds min, mean, p50, p90, p99 & max per case.
+/// Returns false if writing failed.
+bool bench_write_json(const BenchSuite *b, FILE *fd);
+
+// MARK: - Allocations -
+
+/// Returns false when allocator calls can't be counted on this platform (not glibc)
+bool bench_allocations_counted(void);
+
+/// Count of malloc, calloc & realloc calls since the benchmark started
+uint64_t bench_get_allocations(void);
+
+// MARK: - Synthetic data -
+
+/// Deterministic pseudo random numbers, for benchmarks to be reproducible
+uint32_t bench_rand(uint32_t *state);
+
+/// Between 0 (included) and 1 (excluded)
+float bench_rand_float(uint32_t *state);
+
+/// Procedural terrain of `size` x `size` columns, from 1 to `size / 2` blocks high, colored by
+/// altitude. Always generates the same terrain for a given size.
+Shape *bench_make_terrain(ColorAtlas *atlas, const SHAPE_COORDS_INT_T size, const bool isMutable);
@@ -0,0 +1,57 @@
+// -------------------------------------------------------------
+//  Cubzh Core Benchmarks
+//  bench_alloc.c
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+// Allocator calls are counted by replacing malloc & co for the whole benchmark executable,
+// it must only be linked into core_bench.
+
+#include "bench.h"
+
+#include <stddef.h>
+
+static volatile uint64_t _bench_nb_allocations = 0;
+
+#if defined(__GLIBC__)
+
+// glibc lets executables replace the allocator, forward to it after counting calls
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+    __atomic_add_fetch(&_bench_nb_allocations, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    __atomic_add_fetch(&_bench_nb_allocations, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    __atomic_add_fetch(&_bench_nb_allocations, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+
+bool bench_allocations_counted(void) {
+    return true;
+}
+
+#else
+
+bool bench_allocations_counted(void) {
+    return false;
+}
+
+#endif
+
+uint64_t bench_get_allocations(void) {
+    return __atomic_load_n(&_bench_nb_allocations, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,66 @@
+// -------------------------------------------------------------
+//  Cubzh Core Benchmarks
+//  bench_lighting.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <stdlib.h>
+
+#include "bench.h"
+#include "utils.h"
+
+#define BENCH_LIGHTING_SIZE 64
+#define BENCH_LIGHTING_EDITS 100
+
+/// Full baked lighting computation, then batches of block edits updating it incrementally
+void bench_lighting(BenchSuite *b) {
+    const uint32_t iterations = bench_get_iterations(b);
+    uint64_t *bake = (uint64_t *)malloc(sizeof(uint64_t) * iterations);
+
+    ColorAtlas *atlas = color_atlas_new();
+    Shape *s = NULL;
+    for (uint32_t i = 0; i <= iterations; ++i) {
+        shape_release(s);
+        s = bench_make_terrain(atlas, BENCH_LIGHTING_SIZE, true);
+
+        const uint64_t start = utils_time_ns();
+        shape_compute_baked_lighting(s);
+        const uint64_t bakeTime = utils_time_ns() - start;
+
+        // first bake is a warm-up
+        if (i > 0) {
+            bake[i - 1] = bakeTime;
+        }
+    }
+    bench_report(b, "lighting/bake_terrain_64", bake, iterations);
+
+    // edits on last baked terrain: removing existing blocks, adding in empty space
+    const uint32_t nbBatches = iterations * 10;
+    uint64_t *edits = (uint64_t *)malloc(sizeof(uint64_t) * nbBatches);
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < nbBatches; ++i) {
+        const uint64_t start = utils_time_ns();
+        for (uint32_t e = 0; e < BENCH_LIGHTING_EDITS; ++e) {
+            const SHAPE_COORDS_INT_T x = (SHAPE_COORDS_INT_T)(bench_rand(&seed) %
+                                                              BENCH_LIGHTING_SIZE);
+            const SHAPE_COORDS_INT_T y = (SHAPE_COORDS_INT_T)(bench_rand(&seed) %
+                                                              (BENCH_LIGHTING_SIZE / 2));
+            const SHAPE_COORDS_INT_T z = (SHAPE_COORDS_INT_T)(bench_rand(&seed) %
+                                                              BENCH_LIGHTING_SIZE);
+            if (block_is_solid(shape_get_block_immediate(s, x, y, z))) {
+                shape_remove_block(s, x, y, z);
+            } else {
+                shape_add_block(s, 0, x, y, z, false);
+            }
+        }
+        edits[i] = utils_time_ns() - start;
+    }
+    bench_report(b, "lighting/edits_terrain_64_x100", edits, nbBatches);
+
+    shape_release(s);
+    color_atlas_free(atlas);
+    free(bake);
+    free(edits);
+}
@@ -0,0 +1,92 @@
+// -------------------------------------------------------------
+//  Cubzh Core Benchmarks
+//  bench_list.c
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "chunk.h"
+
+#include "bench_lighting.h"
+#include "bench_meshing.h"
+#include "bench_physics.h"
+#include "bench_raycast.h"
+#include "bench_serialization.h"
+
+BenchEntry bench_list[] = {
+    {"lighting", bench_lighting},
+    {"meshing", bench_meshing},
+    {"physics", bench_physics},
+    {"raycast", bench_raycast},
+    {"serialization", bench_serialization},
+
+    {NULL, NULL}};
+
+static void _bench_usage(const char *program) {
+    fprintf(stderr,
+            "usage: %s [--iterations N] [--output FILE] [--list] [GROUP...]\n"
+            "  --iterations N  timed iterations per case (default: 10)\n"
+            "  --output FILE   writes the JSON report to FILE instead of stdout\n"
+            "  --list          lists benchmark groups\n"
+            "  GROUP           only runs given groups (default: all)\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = 10;
+    const char *output = NULL;
+    const char **groups = (const char **)malloc(sizeof(char *) * (size_t)argc);
+    int nbGroups = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--list") == 0) {
+            for (BenchEntry *e = bench_list; e->name != NULL; ++e) {
+                printf("%s\n", e->name);
+            }
+            free(groups);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            _bench_usage(argv[0]);
+            free(groups);
+            return 1;
+        } else {
+            groups[nbGroups++] = argv[i];
+        }
+    }
+
+    // shared by chunks created with default lighting, normally allocated at engine startup
+    chunk_alloc_default_light();
+
+    BenchSuite *b = bench_suite_new(iterations);
+    for (BenchEntry *e = bench_list; e->name != NULL; ++e) {
+        bool selected = nbGroups == 0;
+        for (int g = 0; g < nbGroups && selected == false; ++g) {
+            selected = strcmp(groups[g], e->name) == 0;
+        }
+        if (selected) {
+            e->func(b);
+        }
+    }
+    free(groups);
+
+    FILE *fd = output != NULL ? fopen(output, "w") : stdout;
+    if (fd == NULL) {
+        fprintf(stderr, "can't open %s\n", output);
+        bench_suite_free(b);
+        return 1;
+    }
+    const bool success = bench_write_json(b, fd);
+    if (fd != stdout) {
+        fclose(fd);
+    }
+    bench_suite_free(b);
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+// -------------------------------------------------------------
+//  Cubzh Core Benchmarks
+//  bench_meshing.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <stdlib.h>
+
+#include "bench.h"
+#include "job_system.h"
+#include "thread.h"
+#include "utils.h"
+
+static void _bench_meshing_terrain(BenchSuite *b,
+                                   const SHAPE_COORDS_INT_T size,
+                                   const char *suffix) {
+    const uint32_t iterations = bench_get_iterations(b);
+    uint64_t *build = (uint64_t *)malloc(sizeof(uint64_t) * iterations);
+    uint64_t *mesh = (uint64_t *)malloc(sizeof(uint64_t) * iterations);
+
+    // first iteration is a warm-up
+    for (uint32_t i = 0; i <= iterations; ++i) {
+        ColorAtlas *atlas = color_atlas_new();
+
+        uint64_t start = utils_time_ns();
+        Shape *s = bench_make_terrain(atlas, size, true);
+        const uint64_t buildTime = utils_time_ns() - start;
+
+        start = utils_time_ns();
+        shape_refresh_all_vertices(s);
+        const uint64_t meshTime = utils_time_ns() - start;
+
+        if (i > 0) {
+            build[i - 1] = buildTime;
+            mesh[i - 1] = meshTime;
+        }
+        shape_release(s);
+        color_atlas_free(atlas);
+    }
+
+    char name[64];
+    if (suffix[0] == '\0') {
+        snprintf(name, sizeof(name), "shape/add_blocks_terrain_%d", size);
+        bench_report(b, name, build, iterations);
+    }
+    snprintf(name, sizeof(name), "meshing/terrain_%d%s", size, suffix);
+    bench_report(b, name, mesh, iterations);
+
+    free(build);
+    free(mesh);
+}
+
+/// Terrain construction block by block & full meshing, serial then on all cores
+void bench_meshing(BenchSuite *b) {
+    _bench_meshing_terrain(b, 32, "");
+    _bench_meshing_terrain(b, 64, "");
+    _bench_meshing_terrain(b, 128, "");
+
+    const uint32_t nbCores = thread_get_core_count();
+    if (nbCores > 1) {
+        job_system_shared_init(nbCores - 1);
+        _bench_meshing_terrain(b, 128, "_parallel");
+        job_system_shared_free();
+    }
+}
@@ -0,0 +1,132 @@
+// -------------------------------------------------------------
+//  Cubzh Core Benchmarks
+//  bench_physics.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <stdlib.h>
+
+#include "bench.h"
+#include "rigidBody.h"
+#include "scene.h"
+#include "transform.h"
+#include "utils.h"
+
+#define BENCH_PHYSICS_MAP_SIZE 64
+#define BENCH_PHYSICS_GRAVITY -300.0f
+#define BENCH_PHYSICS_TICKS 120
+#define BENCH_PHYSICS_CAST_MAP_SIZE 128
+#define BENCH_PHYSICS_CAST_BATCH 1000
+
+/// Terrain as a per-block collisions map, added to a new scene
+static Scene *_bench_physics_make_scene(ColorAtlas *atlas, const SHAPE_COORDS_INT_T mapSize) {
+    Scene *sc = scene_new(NULL);
+    const float gravity = BENCH_PHYSICS_GRAVITY, zero = 0.0f;
+    scene_set_constant_acceleration(sc, &zero, &gravity, &zero);
+
+    Shape *map = bench_make_terrain(atlas, mapSize, true);
+    RigidBody *rb = NULL;
+    shape_ensure_rigidbody(map, PHYSICS_GROUP_DEFAULT_MAP, PHYSICS_GROUP_NONE, &rb);
+    rigidbody_set_simulation_mode(rb, RigidbodyMode_StaticPerBlock);
+    scene_add_map(sc, map);
+    shape_release(map); // retained by scene
+
+    return sc;
+}
+
+static void _bench_physics_falling(BenchSuite *b, const uint32_t nbObjects) {
+    ColorAtlas *atlas = color_atlas_new();
+    Scene *sc = _bench_physics_make_scene(atlas, BENCH_PHYSICS_MAP_SIZE);
+
+    // dropped in layers above the terrain, slightly apart
+    const uint32_t perRow = 16;
+    const Box collider = {{-1.5f, 0.0f, -1.5f}, {1.5f, 3.0f, 1.5f}};
+    for (uint32_t i = 0; i < nbObjects; ++i) {
+        Transform *t = transform_make(PointTransform);
+        RigidBody *rb = NULL;
+        transform_ensure_rigidbody(t,
+                                   RigidbodyMode_Dynamic,
+                                   PHYSICS_GROUP_DEFAULT_OBJECT,
+                                   PHYSICS_GROUP_DEFAULT_MAP | PHYSICS_GROUP_DEFAULT_OBJECT,
+                                   &rb);
+        rigidbody_set_collider(rb, &collider, true);
+
+        const float x = 2.0f + (float)(i % perRow) * 3.9f;
+        const float z = 2.0f + (float)(i / perRow % perRow) * 3.9f;
+        const float y = (float)BENCH_PHYSICS_MAP_SIZE + (float)(i / (perRow * perRow)) * 8.0f;
+        transform_set_position(t, x, y, z);
+        transform_set_parent(t, scene_get_root(sc), false);
+        transform_release(t); // retained by scene root
+    }
+
+    // one sample per tick, objects fall, collide & settle
+    uint64_t samples[BENCH_PHYSICS_TICKS];
+    const uint64_t allocationsStart = bench_get_allocations();
+    for (uint32_t i = 0; i < BENCH_PHYSICS_TICKS; ++i) {
+        const uint64_t start = utils_time_ns();
+        scene_refresh(sc, 1.0 / 60.0, NULL);
+        samples[i] = utils_time_ns() - start;
+    }
+    const uint64_t nbAllocations = bench_get_allocations() - allocationsStart;
+
+    char name[64];
+    snprintf(name, sizeof(name), "physics/falling_%u_tick", nbObjects);
+    bench_report(b, name, samples, BENCH_PHYSICS_TICKS);
+    bench_report_allocations(b, (double)nbAllocations / (double)BENCH_PHYSICS_TICKS);
+
+    scene_free(sc);
+    color_atlas_free(atlas);
+}
+
+/// Batches of per-block box casts, as done by rigidbody_tick for each moving body against a map
+static void _bench_physics_box_cast(BenchSuite *b) {
+    ColorAtlas *atlas = color_atlas_new();
+    Shape *map = bench_make_terrain(atlas, BENCH_PHYSICS_CAST_MAP_SIZE, false);
+
+    const uint32_t nbBatches = bench_get_iterations(b) * 10;
+    uint64_t *samples = (uint64_t *)malloc(sizeof(uint64_t) * nbBatches);
+    uint32_t seed = 1;
+    uint32_t hits = 0;
+    const float size = (float)BENCH_PHYSICS_CAST_MAP_SIZE;
+    const float3 epsilon = {EPSILON_COLLISION, EPSILON_COLLISION, EPSILON_COLLISION};
+    float3 normal;
+
+    for (uint32_t i = 0; i <= nbBatches; ++i) {
+        const uint64_t start = utils_time_ns();
+        for (uint32_t c = 0; c < BENCH_PHYSICS_CAST_BATCH; ++c) {
+            // character sized box above the terrain, moving down & sideways over one tick
+            const float3 p = {bench_rand_float(&seed) * (size - 1.0f),
+                              size * 0.5f * bench_rand_float(&seed),
+                              bench_rand_float(&seed) * (size - 1.0f)};
+            const Box box = {{p.x, p.y, p.z}, {p.x + 0.8f, p.y + 2.0f, p.z + 0.8f}};
+            const float3 v = {bench_rand_float(&seed) - 0.5f,
+                              -0.5f * bench_rand_float(&seed) - 0.1f,
+                              bench_rand_float(&seed) - 0.5f};
+            if (shape_box_cast(map, &box, &v, &epsilon, true, &normal, NULL, NULL, NULL) < 1.0f) {
+                ++hits;
+            }
+        }
+        // first batch is a warm-up
+        if (i > 0) {
+            samples[i - 1] = utils_time_ns() - start;
+        }
+    }
+
+    if (hits == 0) {
+        fprintf(stderr, "physics: no box cast hit, map isn't set up as expected\n");
+    }
+    bench_report(b, "physics/box_cast_128_x1000", samples, nbBatches);
+
+    free(samples);
+    shape_release(map);
+    color_atlas_free(atlas);
+}
+
+/// Scene ticks of dynamic rigidbodies falling onto a terrain map, and box casts against a map
+void bench_physics(BenchSuite *b) {
+    _bench_physics_falling(b, 100);
+    _bench_physics_falling(b, 500);
+    _bench_physics_box_cast(b);
+}
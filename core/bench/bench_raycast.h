@@ -0,0 +1,63 @@
+// -------------------------------------------------------------
+//  Cubzh Core Benchmarks
+//  bench_raycast.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <stdlib.h>
+
+#include "bench.h"
+#include "bench_physics.h"
+#include "ray.h"
+#include "scene.h"
+#include "utils.h"
+
+#define BENCH_RAYCAST_MAP_SIZE 128
+#define BENCH_RAYCAST_BATCH 1000
+
+/// Batches of rays cast from above a terrain map, in random downward directions
+void bench_raycast(BenchSuite *b) {
+    ColorAtlas *atlas = color_atlas_new();
+    Scene *sc = _bench_physics_make_scene(atlas, BENCH_RAYCAST_MAP_SIZE);
+    scene_refresh(sc, 1.0 / 60.0, NULL); // r-tree insertion
+
+    const uint32_t nbBatches = bench_get_iterations(b) * 10;
+    uint64_t *samples = (uint64_t *)malloc(sizeof(uint64_t) * nbBatches);
+    uint32_t seed = 1;
+    uint32_t hits = 0;
+    const float size = (float)BENCH_RAYCAST_MAP_SIZE;
+
+    for (uint32_t i = 0; i <= nbBatches; ++i) {
+        const uint64_t start = utils_time_ns();
+        for (uint32_t r = 0; r < BENCH_RAYCAST_BATCH; ++r) {
+            float3 origin = {bench_rand_float(&seed) * size,
+                             size * (0.5f + bench_rand_float(&seed)),
+                             bench_rand_float(&seed) * size};
+            float3 dir = {bench_rand_float(&seed) - 0.5f,
+                          -0.2f - bench_rand_float(&seed),
+                          bench_rand_float(&seed) - 0.5f};
+            float3_normalize(&dir);
+            Ray *rr = ray_new(&origin, &dir);
+            CastResult result;
+            if (scene_cast_ray(sc, rr, PHYSICS_GROUP_ALL_SYSTEM, NULL, &result) != Hit_None) {
+                ++hits;
+            }
+            ray_free(rr);
+        }
+        // first batch is a warm-up
+        if (i > 0) {
+            samples[i - 1] = utils_time_ns() - start;
+        }
+    }
+
+    if (hits == 0) {
+        fprintf(stderr, "raycast: no hit, scene isn't set up as expected\n");
+    }
+    bench_report(b, "raycast/terrain_128_x1000", samples, nbBatches);
+
+    free(samples);
+    scene_free(sc);
+    color_atlas_free(atlas);
+}
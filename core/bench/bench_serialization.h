@@ -0,0 +1,80 @@
+// -------------------------------------------------------------
+//  Cubzh Core Benchmarks
+//  bench_serialization.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <stdlib.h>
+
+#include "bench.h"
+#include "serialization.h"
+#include "stream.h"
+#include "utils.h"
+
+/// .3zh save & load round-trips of a terrain shape, from & to memory
+static void _bench_serialization_terrain(BenchSuite *b, const SHAPE_COORDS_INT_T size) {
+    const uint32_t iterations = bench_get_iterations(b);
+    uint64_t *save = (uint64_t *)malloc(sizeof(uint64_t) * iterations);
+    uint64_t *load = (uint64_t *)malloc(sizeof(uint64_t) * iterations);
+
+    ColorAtlas *atlas = color_atlas_new();
+    Shape *s = bench_make_terrain(atlas, size, true);
+    const size_t nbBlocks = shape_get_nb_blocks(s);
+    LoadShapeSettings settings = {.lighting = false, .isMutable = false};
+
+    for (uint32_t i = 0; i <= iterations; ++i) {
+        void *buffer = NULL;
+        uint32_t bufferSize = 0;
+
+        uint64_t start = utils_time_ns();
+        const bool saved = serialization_save_shape_as_buffer(s,
+                                                              NULL,
+                                                              NULL,
+                                                              0,
+                                                              &buffer,
+                                                              &bufferSize);
+        const uint64_t saveTime = utils_time_ns() - start;
+        if (saved == false) {
+            fprintf(stderr, "serialization: failed to save shape\n");
+            break;
+        }
+
+        start = utils_time_ns();
+        Shape *loaded = serialization_load_shape(stream_new_buffer_read((const char *)buffer,
+                                                                        bufferSize),
+                                                 "bench",
+                                                 atlas,
+                                                 &settings,
+                                                 false);
+        const uint64_t loadTime = utils_time_ns() - start;
+        if (loaded == NULL || shape_get_nb_blocks(loaded) != nbBlocks) {
+            fprintf(stderr, "serialization: loaded shape doesn't match\n");
+        }
+
+        // first round-trip is a warm-up
+        if (i > 0) {
+            save[i - 1] = saveTime;
+            load[i - 1] = loadTime;
+        }
+        shape_release(loaded);
+        free(buffer);
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "serialization/save_terrain_%d", size);
+    bench_report(b, name, save, iterations);
+    snprintf(name, sizeof(name), "serialization/load_terrain_%d", size);
+    bench_report(b, name, load, iterations);
+
+    shape_release(s);
+    color_atlas_free(atlas);
+    free(save);
+    free(load);
+}
+
+void bench_serialization(BenchSuite *b) {
+    _bench_serialization_terrain(b, 64);
+    _bench_serialization_terrain(b, 128);
+}
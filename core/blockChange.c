@@ -22,11 +22,11 @@ typedef struct _BlockChange {
     char pad[1];
 } BlockChange;
 
-BlockChange *blockChange_new(const SHAPE_COLOR_INDEX_INT_T colorIndex,
-                             const SHAPE_COORDS_INT_T x,
-                             const SHAPE_COORDS_INT_T y,
-                             const SHAPE_COORDS_INT_T z) {
-    BlockChange *bc = (BlockChange *)malloc(sizeof(BlockChange));
+static BlockChange *_blockChange_init(BlockChange *const bc,
+                                      const SHAPE_COLOR_INDEX_INT_T colorIndex,
+                                      const SHAPE_COORDS_INT_T x,
+                                      const SHAPE_COORDS_INT_T y,
+                                      const SHAPE_COORDS_INT_T z) {
     if (bc == NULL) {
         return NULL;
     }
@@ -38,6 +38,25 @@ BlockChange *blockChange_new(const SHAPE_COLOR_INDEX_INT_T colorIndex,
     return bc;
 }
 
+BlockChange *blockChange_new(const SHAPE_COLOR_INDEX_INT_T colorIndex,
+                             const SHAPE_COORDS_INT_T x,
+                             const SHAPE_COORDS_INT_T y,
+                             const SHAPE_COORDS_INT_T z) {
+    return _blockChange_init((BlockChange *)malloc(sizeof(BlockChange)), colorIndex, x, y, z);
+}
+
+void blockChange_pool_init(Pool *const pool, const uint32_t firstSlabCapacity) {
+    pool_init(pool, sizeof(BlockChange), firstSlabCapacity);
+}
+
+BlockChange *blockChange_new_from_pool(Pool *const pool,
+                                       const SHAPE_COLOR_INDEX_INT_T colorIndex,
+                                       const SHAPE_COORDS_INT_T x,
+                                       const SHAPE_COORDS_INT_T y,
+                                       const SHAPE_COORDS_INT_T z) {
+    return _blockChange_init((BlockChange *)pool_alloc(pool), colorIndex, x, y, z);
+}
+
 void blockChange_free(BlockChange *const bc) {
     free(bc);
 }
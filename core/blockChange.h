@@ -11,6 +11,7 @@ extern "C" {
 #endif
 
 #include "config.h"
+#include "pool.h"
 
 typedef struct _BlockChange BlockChange;
 typedef struct _Block Block;
@@ -21,6 +22,17 @@ BlockChange *blockChange_new(const SHAPE_COLOR_INDEX_INT_T colorIndex,
                              const SHAPE_COORDS_INT_T y,
                              const SHAPE_COORDS_INT_T z);
 
+/// Initializes a pool to allocate BlockChanges from
+void blockChange_pool_init(Pool *const pool, const uint32_t firstSlabCapacity);
+
+/// Same as blockChange_new, allocating from given pool (see Transaction).
+/// Such a BlockChange is released with its pool, it must not be freed with blockChange_free.
+BlockChange *blockChange_new_from_pool(Pool *const pool,
+                                       const SHAPE_COLOR_INDEX_INT_T colorIndex,
+                                       const SHAPE_COORDS_INT_T x,
+                                       const SHAPE_COORDS_INT_T y,
+                                       const SHAPE_COORDS_INT_T z);
+
 ///
 void blockChange_free(BlockChange *const bc);
 
@@ -6,10 +6,17 @@
 
 #include "cclog.h"
 
+// C
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+// Core
+#include "config.h"
+#include "thread.h"
+#include "utils.h"
+
 const char *_cclog_filename(const char *file) {
     const char *p = strrchr(file, '/');
     if (p == NULL)
@@ -17,20 +24,26 @@ const char *_cclog_filename(const char *file) {
     return p ? p + 1 : file;
 }
 
-char *_cc_vsnprintf_helper(const char *format, ...) {
-    static char buffer[LOG_BUFFER_LENGTH];
-    // Declare a va_list type variable
-    va_list myargs;
+// MARK: - private prototypes -
 
-    // Initialise the va_list variable with the ... after format
-    va_start(myargs, format);
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wformat-nonliteral"
-    vsnprintf(buffer, LOG_BUFFER_LENGTH, format, myargs);
-#pragma clang diagnostic pop
-    va_end(myargs);
-    return buffer;
-}
+static int _cclog_write(const int severity,
+                        const char *filename,
+                        const int line,
+                        const char *format,
+                        va_list args);
+static int _cclog_writef(const int severity,
+                         const char *filename,
+                         const int line,
+                         const char *format,
+                         ...);
+static int _cclog_forward(const int severity,
+                          const char *filename,
+                          const int line,
+                          const char *format,
+                          ...);
+static bool _cclog_rate_limit_pass(const int severity, const char *filename, const int line);
+
+// MARK: - default log function -
 
 int _cclog(const int severity,
            const char *filename,
@@ -38,12 +51,11 @@ int _cclog(const int severity,
            const char *format,
            va_list args) {
 
-    // create a static memory buffer
-    static char bufferPreString[LOG_BUFFER_LENGTH];
+    char buffer[LOG_BUFFER_LENGTH];
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wformat-nonliteral"
-    vsnprintf(bufferPreString, LOG_BUFFER_LENGTH, format, args);
+    vsnprintf(buffer, LOG_BUFFER_LENGTH, format, args);
 #pragma clang diagnostic pop
 
     const char *sev;
@@ -72,20 +84,336 @@ int _cclog(const int severity,
             break;
     }
 
-    char *buffer = _cc_vsnprintf_helper("%s %s", sev, bufferPreString);
-
-    return fprintf((severity >= LOG_SEVERITY_WARNING) ? stderr : stdout, "%s\n", buffer);
+    return fprintf((severity >= LOG_SEVERITY_WARNING) ? stderr : stdout, "%s %s\n", sev, buffer);
 }
 
 log_func_ptr cclog_function_ptr = _cclog;
 
 int cclog(const int severity, const char *filename, const int line, const char *format, ...) {
-    int r = -1;
-    if (cclog_function_ptr != NULL) {
-        va_list myargs;
-        va_start(myargs, format);
-        r = cclog_function_ptr(severity, filename, line, format, myargs);
-        va_end(myargs);
+    if (cclog_function_ptr == NULL) {
+        return -1;
+    }
+    if (_cclog_rate_limit_pass(severity, filename, line) == false) {
+        return 0;
+    }
+    va_list myargs;
+    va_start(myargs, format);
+    const int r = _cclog_write(severity, filename, line, format, myargs);
+    va_end(myargs);
+    return r;
+}
+
+// MARK: - Asynchronous logging -
+
+// power of 2
+#define CCLOG_ASYNC_CAPACITY 512
+// longer messages are truncated when logging asynchronously
+#define CCLOG_ASYNC_MESSAGE_LENGTH 512
+
+typedef struct {
+    // Vyukov's bounded queue: equal to the position when the slot is free for that position,
+    // position + 1 once the record is published
+    volatile int32_t sequence;
+    int32_t severity;
+    const char *filename;
+    int32_t line;
+    char message[CCLOG_ASYNC_MESSAGE_LENGTH];
+    char pad[4];
+} CClogRecord;
+
+typedef struct {
+    CClogRecord *records;
+    Thread *flusher;
+    ThreadCondition *wake;
+    // positions wrap around, only differences are meaningful
+    volatile int32_t enqueuePos;
+    volatile int32_t dequeuePos;
+    // 1 while the flusher waits for records
+    volatile int32_t sleeping;
+    volatile int32_t stop;
+    // records discarded because the ring buffer was full
+    volatile int32_t dropped;
+    char pad[4];
+} CClogAsync;
+
+static CClogAsync *volatile _async = NULL;
+
+// logs from the flusher itself (e.g. within cclog_function_ptr) remain synchronous
+static vx_thread_local bool _isFlusher = false;
+
+static bool _cclog_async_has_record(CClogAsync *a) {
+    const uint32_t pos = (uint32_t)thread_atomic_load(&a->dequeuePos);
+    const CClogRecord *r = &a->records[pos & (CCLOG_ASYNC_CAPACITY - 1)];
+    return (uint32_t)thread_atomic_load((volatile int32_t *)&r->sequence) == pos + 1;
+}
+
+static void _cclog_async_wake(CClogAsync *a) {
+    // lock only taken if the flusher is idle
+    if (thread_atomic_compare_exchange(&a->sleeping, 1, 0)) {
+        thread_condition_lock(a->wake);
+        thread_condition_signal(a->wake);
+        thread_condition_unlock(a->wake);
+    }
+}
+
+static int _cclog_async_push(CClogAsync *a,
+                             const int severity,
+                             const char *filename,
+                             const int line,
+                             const char *format,
+                             va_list args) {
+    CClogRecord *r;
+    uint32_t pos = (uint32_t)thread_atomic_load(&a->enqueuePos);
+    for (;;) {
+        r = &a->records[pos & (CCLOG_ASYNC_CAPACITY - 1)];
+        const int32_t diff = (int32_t)((uint32_t)thread_atomic_load(&r->sequence) - pos);
+        if (diff == 0) {
+            if (thread_atomic_compare_exchange(&a->enqueuePos, (int32_t)pos, (int32_t)(pos + 1))) {
+                break;
+            }
+            pos = (uint32_t)thread_atomic_load(&a->enqueuePos);
+        } else if (diff < 0) {
+            // full
+            thread_atomic_add(&a->dropped, 1);
+            return -1;
+        } else {
+            pos = (uint32_t)thread_atomic_load(&a->enqueuePos);
+        }
+    }
+
+    r->severity = severity;
+    r->filename = filename;
+    r->line = line;
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wformat-nonliteral"
+    const int len = vsnprintf(r->message, CCLOG_ASYNC_MESSAGE_LENGTH, format, args);
+#pragma clang diagnostic pop
+    thread_atomic_store(&r->sequence, (int32_t)(pos + 1));
+
+    _cclog_async_wake(a);
+    return len;
+}
+
+/// Writes all published records, returns how many were written
+static uint32_t _cclog_async_drain(CClogAsync *a) {
+    uint32_t count = 0;
+    uint32_t pos = (uint32_t)thread_atomic_load(&a->dequeuePos);
+    for (;;) {
+        CClogRecord *r = &a->records[pos & (CCLOG_ASYNC_CAPACITY - 1)];
+        if ((uint32_t)thread_atomic_load(&r->sequence) != pos + 1) {
+            break;
+        }
+        _cclog_forward(r->severity, r->filename, r->line, "%s", r->message);
+        thread_atomic_store(&r->sequence, (int32_t)(pos + CCLOG_ASYNC_CAPACITY));
+        ++pos;
+        thread_atomic_store(&a->dequeuePos, (int32_t)pos);
+        ++count;
+    }
+
+    const int32_t dropped = thread_atomic_load(&a->dropped);
+    if (dropped > 0) {
+        thread_atomic_add(&a->dropped, -dropped);
+        _cclog_forward(LOG_SEVERITY_WARNING,
+                       NULL,
+                       0,
+                       "cclog: %d records dropped (ring buffer full)",
+                       dropped);
+    }
+    return count;
+}
+
+static void _cclog_async_flusher(void *userdata) {
+    CClogAsync *a = (CClogAsync *)userdata;
+    _isFlusher = true;
+    for (;;) {
+        if (_cclog_async_drain(a) > 0) {
+            continue;
+        }
+        if (thread_atomic_load(&a->stop) != 0) {
+            break;
+        }
+        thread_condition_lock(a->wake);
+        thread_atomic_store(&a->sleeping, 1);
+        // checked after setting `sleeping`: either the flusher sees the record here, or the
+        // producer sees `sleeping` & signals once the lock is released by the wait
+        if (_cclog_async_has_record(a) == false) {
+            while (thread_atomic_load(&a->sleeping) == 1 && thread_atomic_load(&a->stop) == 0) {
+                thread_condition_wait(a->wake);
+            }
+        }
+        thread_atomic_store(&a->sleeping, 0);
+        thread_condition_unlock(a->wake);
+    }
+}
+
+bool cclog_async_start(void) {
+    if (_async != NULL) {
+        return true;
+    }
+    CClogAsync *a = (CClogAsync *)malloc(sizeof(CClogAsync));
+    if (a == NULL) {
+        return false;
     }
+    a->records = (CClogRecord *)malloc(sizeof(CClogRecord) * CCLOG_ASYNC_CAPACITY);
+    a->wake = thread_condition_new();
+    if (a->records == NULL || a->wake == NULL) {
+        free(a->records);
+        thread_condition_free(a->wake);
+        free(a);
+        return false;
+    }
+    for (uint32_t i = 0; i < CCLOG_ASYNC_CAPACITY; ++i) {
+        a->records[i].sequence = (int32_t)i;
+    }
+    a->enqueuePos = 0;
+    a->dequeuePos = 0;
+    a->sleeping = 0;
+    a->stop = 0;
+    a->dropped = 0;
+
+    a->flusher = thread_new(_cclog_async_flusher, a);
+    if (a->flusher == NULL) {
+        free(a->records);
+        thread_condition_free(a->wake);
+        free(a);
+        return false;
+    }
+    _async = a;
+    return true;
+}
+
+void cclog_async_stop(void) {
+    CClogAsync *a = _async;
+    if (a == NULL) {
+        return;
+    }
+    _async = NULL;
+
+    thread_atomic_store(&a->stop, 1);
+    thread_condition_lock(a->wake);
+    thread_atomic_store(&a->sleeping, 0);
+    thread_condition_signal(a->wake);
+    thread_condition_unlock(a->wake);
+
+    // the flusher drains remaining records before exiting
+    thread_join_and_free(a->flusher);
+    thread_condition_free(a->wake);
+    free(a->records);
+    free(a);
+}
+
+void cclog_flush(void) {
+    CClogAsync *a = _async;
+    if (a == NULL || _isFlusher) {
+        return;
+    }
+    const uint32_t target = (uint32_t)thread_atomic_load(&a->enqueuePos);
+    while ((int32_t)(target - (uint32_t)thread_atomic_load(&a->dequeuePos)) > 0) {
+        _cclog_async_wake(a);
+        thread_yield();
+    }
+}
+
+// MARK: - Rate limiting -
+
+typedef struct {
+    // max records per second, 0: unlimited
+    volatile int32_t limit;
+    // current 1 second window
+    volatile int32_t window;
+    // records within current window
+    volatile int32_t count;
+    // records discarded since last report
+    volatile int32_t suppressed;
+} CClogRateLimit;
+
+static CClogRateLimit _rateLimits[LOG_SEVERITY_FATAL + 1] = {{0, 0, 0, 0}};
+
+void cclog_set_rate_limit(const LOG_SEVERITY severity, const uint32_t maxPerSecond) {
+    if (severity > LOG_SEVERITY_FATAL) {
+        return;
+    }
+    CClogRateLimit *rl = &_rateLimits[severity];
+    thread_atomic_store(&rl->count, 0);
+    thread_atomic_store(&rl->suppressed, 0);
+    thread_atomic_store(&rl->limit, (int32_t)maxPerSecond);
+}
+
+static bool _cclog_rate_limit_pass(const int severity, const char *filename, const int line) {
+    if (severity < LOG_SEVERITY_TRACE || severity > LOG_SEVERITY_FATAL) {
+        return true;
+    }
+    CClogRateLimit *rl = &_rateLimits[severity];
+    const int32_t limit = thread_atomic_load(&rl->limit);
+    if (limit == 0) {
+        return true;
+    }
+
+    const int32_t now = (int32_t)(utils_time_ns() / 1000000000);
+    const int32_t window = thread_atomic_load(&rl->window);
+    if (window != now && thread_atomic_compare_exchange(&rl->window, window, now)) {
+        // approximate: concurrent records may be counted in previous window
+        thread_atomic_store(&rl->count, 0);
+    }
+    if (thread_atomic_add(&rl->count, 1) > limit) {
+        thread_atomic_add(&rl->suppressed, 1);
+        return false;
+    }
+
+    int32_t suppressed = thread_atomic_load(&rl->suppressed);
+    while (suppressed > 0 &&
+           thread_atomic_compare_exchange(&rl->suppressed, suppressed, 0) == false) {
+        suppressed = thread_atomic_load(&rl->suppressed);
+    }
+    if (suppressed > 0) {
+        _cclog_writef(severity, filename, line, "(%d similar records suppressed)", suppressed);
+    }
+    return true;
+}
+
+// MARK: - private functions -
+
+static int _cclog_write(const int severity,
+                        const char *filename,
+                        const int line,
+                        const char *format,
+                        va_list args) {
+    CClogAsync *a = _async;
+    if (a == NULL || _isFlusher) {
+        return cclog_function_ptr(severity, filename, line, format, args);
+    }
+    const int r = _cclog_async_push(a, severity, filename, line, format, args);
+    if (severity >= LOG_SEVERITY_FATAL) {
+        cclog_flush();
+    }
+    return r;
+}
+
+static int _cclog_writef(const int severity,
+                         const char *filename,
+                         const int line,
+                         const char *format,
+                         ...) {
+    va_list myargs;
+    va_start(myargs, format);
+    const int r = _cclog_write(severity, filename, line, format, myargs);
+    va_end(myargs);
+    return r;
+}
+
+/// Calls `cclog_function_ptr` with variadic arguments
+static int _cclog_forward(const int severity,
+                          const char *filename,
+                          const int line,
+                          const char *format,
+                          ...) {
+    log_func_ptr f = cclog_function_ptr;
+    if (f == NULL) {
+        return -1;
+    }
+    va_list myargs;
+    va_start(myargs, format);
+    const int r = f(severity, filename, line, format, myargs);
+    va_end(myargs);
     return r;
 }
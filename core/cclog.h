@@ -10,6 +10,8 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 
 // NOTE: the log function is implemented here
@@ -48,11 +50,76 @@ typedef enum {
 
 int cclog(const int severity, const char *filename, const int line, const char *format, ...);
 
+// MARK: - Asynchronous logging -
+
+/// Starts a flusher thread: from now on, log records are pushed into a lock-free ring buffer
+/// and handed to `cclog_function_ptr` by the flusher, in order, instead of on the calling thread.
+/// The message is still formatted by the caller (arguments can't outlive the call), but no
+/// shared buffer, lock or stream I/O is involved.
+/// Records are dropped (and counted) when the ring buffer is full, fatal records are flushed
+/// before `cclog` returns.
+/// Returns false if the thread can't be started, logging remains synchronous in that case.
+bool cclog_async_start(void);
+
+/// Writes pending records, stops the flusher & goes back to synchronous logging.
+/// Other threads shouldn't be logging while this is called.
+void cclog_async_stop(void);
+
+/// Blocks until all records pushed before this call have been written.
+/// Does nothing when logging is synchronous.
+void cclog_flush(void);
+
+// MARK: - Rate limiting -
+
+/// Limits the number of records written per second for given severity, 0 means unlimited
+/// (default). Exceeding records are discarded, their count is reported with the next record
+/// of same severity that gets through.
+void cclog_set_rate_limit(const LOG_SEVERITY severity, const uint32_t maxPerSecond);
+
+// MARK: - Compile time filter -
+
+// Calls below CCLOG_MIN_SEVERITY are compiled out entirely: arguments are still type checked,
+// but never evaluated.
+// Values match LOG_SEVERITY (0: trace ... 5: fatal), e.g. -DCCLOG_MIN_SEVERITY=3 for warnings
+// and above only.
+#ifndef CCLOG_MIN_SEVERITY
+#define CCLOG_MIN_SEVERITY 0
+#endif
+
+#if CCLOG_MIN_SEVERITY <= 0
 #define cclog_trace(...) cclog(LOG_SEVERITY_TRACE, NULL, 0, __VA_ARGS__)
+#else
+#define cclog_trace(...) ((void)(0 && cclog(LOG_SEVERITY_TRACE, NULL, 0, __VA_ARGS__)))
+#endif
+
+#if CCLOG_MIN_SEVERITY <= 1
 #define cclog_debug(...) cclog(LOG_SEVERITY_DEBUG, __FILE_NAME__, __LINE__, __VA_ARGS__)
+#else
+#define cclog_debug(...)                                                                           \
+    ((void)(0 && cclog(LOG_SEVERITY_DEBUG, __FILE_NAME__, __LINE__, __VA_ARGS__)))
+#endif
+
+#if CCLOG_MIN_SEVERITY <= 2
 #define cclog_info(...) cclog(LOG_SEVERITY_INFO, __FILE_NAME__, __LINE__, __VA_ARGS__)
+#else
+#define cclog_info(...)                                                                            \
+    ((void)(0 && cclog(LOG_SEVERITY_INFO, __FILE_NAME__, __LINE__, __VA_ARGS__)))
+#endif
+
+#if CCLOG_MIN_SEVERITY <= 3
 #define cclog_warning(...) cclog(LOG_SEVERITY_WARNING, __FILE_NAME__, __LINE__, __VA_ARGS__)
+#else
+#define cclog_warning(...)                                                                         \
+    ((void)(0 && cclog(LOG_SEVERITY_WARNING, __FILE_NAME__, __LINE__, __VA_ARGS__)))
+#endif
+
+#if CCLOG_MIN_SEVERITY <= 4
 #define cclog_error(...) cclog(LOG_SEVERITY_ERROR, __FILE_NAME__, __LINE__, __VA_ARGS__)
+#else
+#define cclog_error(...)                                                                           \
+    ((void)(0 && cclog(LOG_SEVERITY_ERROR, __FILE_NAME__, __LINE__, __VA_ARGS__)))
+#endif
+
 #define cclog_fatal(...) cclog(LOG_SEVERITY_FATAL, __FILE_NAME__, __LINE__, __VA_ARGS__)
 
 #ifdef __cplusplus
@@ -10,13 +10,24 @@
 #include <string.h>
 
 #include "cclog.h"
+#include "profiler.h"
+#include "thread.h"
 #include "vertextbuffer.h"
 #include "zlib.h"
 
 #define CHUNK_NEIGHBORS_COUNT 26
 
+// occupancy mask rows along x have to fit in 64-bit words
+#if 64 % CHUNK_SIZE != 0
+#error "CHUNK_SIZE must divide 64"
+#endif
+#define CHUNK_MASK_ROW ((uint64_t)((1ull << (CHUNK_SIZE - 1)) * 2 - 1))
+
 static VERTEX_LIGHT_STRUCT_T *defaultLight = NULL;
 
+// chunks created so far, high bits of solid versions
+static volatile int32_t chunkSerial = 0;
+
 // chunk structure definition
 struct _Chunk {
     // 26 possible chunk neighbors used for fast access
@@ -28,9 +39,13 @@ struct _Chunk {
     VERTEX_LIGHT_STRUCT_T *lightingData; /* 8 bytes */
     // reference to shape chunks rtree leaf node, used for removal
     void *rtreeLeaf; /* 8 bytes */
+    // palette opaqueMask was computed with, NULL if it has to be refreshed
+    const ColorPalette *opaquePalette; /* 8 bytes */
     // first opaque/transparent vbma reserved for that chunk, this can be chained across several vb
     VertexBufferMemArea *vbma_opaque;      /* 8 bytes */
     VertexBufferMemArea *vbma_transparent; /* 8 bytes */
+    // same for coarser LOD levels, only used if the shape has LODs enabled
+    VertexBufferMemArea *vbmaLod[CHUNK_LOD_COUNT - 1][2]; /* 2 x 2 x 8 bytes */
     // number of blocks in that chunk
     int nbBlocks; /* 4 bytes */
     // position of chunk in shape's model
@@ -40,7 +55,15 @@ struct _Chunk {
     // whether vertices need to be refreshed
     bool dirty; /* 1 byte */
 
-    char pad[7];
+    char pad[3];
+
+    // palette transparency version opaqueMask was computed with
+    uint32_t opaqueVersion; /* 4 bytes */
+    // see chunk_get_solid_version
+    uint64_t solidVersion; /* 8 bytes */
+    // occupancy masks, see CHUNK_MASK_WORDS
+    uint64_t solidMask[CHUNK_MASK_WORDS];  /* 512 bytes */
+    uint64_t opaqueMask[CHUNK_MASK_WORDS]; /* 512 bytes */
 };
 
 // MARK: private functions prototypes
@@ -75,6 +98,34 @@ void _chunk_update_bounding_box(Chunk *chunk,
                                 const CHUNK_COORDS_INT3_T coords,
                                 const bool addOrRemove);
 
+/// Unique base version for a new chunk, the chunk then increments it on each change
+static uint64_t _chunk_new_solid_version(void) {
+    return (uint64_t)(uint32_t)thread_atomic_add(&chunkSerial, 1) << 32;
+}
+
+static size_t _chunk_mask_index(const int x, const int y, const int z) {
+    return (size_t)(x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQR);
+}
+
+static uint32_t _chunk_mask_lowest_bit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(word);
+#else
+    uint32_t bit = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+/// CHUNK_SIZE bits of the row of blocks along x at given y & z
+static uint64_t _chunk_mask_get_row(const uint64_t *mask, const int y, const int z) {
+    const size_t i = _chunk_mask_index(0, y, z);
+    return (mask[i >> 6] >> (i & 63)) & CHUNK_MASK_ROW;
+}
+
 // MARK: public functions
 
 void chunk_alloc_default_light(void) {
@@ -95,6 +146,10 @@ Chunk *chunk_new(const SHAPE_COORDS_INT3_T origin) {
     chunk->octree = _chunk_new_octree();
     chunk->lightingData = NULL;
     chunk->rtreeLeaf = NULL;
+    chunk->opaquePalette = NULL;
+    chunk->opaqueVersion = 0;
+    chunk->solidVersion = _chunk_new_solid_version();
+    memset(chunk->solidMask, 0, sizeof(chunk->solidMask));
     chunk->dirty = false;
     chunk->origin = origin;
     chunk->bbMin = (CHUNK_COORDS_INT3_T){0, 0, 0};
@@ -107,6 +162,7 @@ Chunk *chunk_new(const SHAPE_COORDS_INT3_T origin) {
 
     chunk->vbma_opaque = NULL;
     chunk->vbma_transparent = NULL;
+    memset(chunk->vbmaLod, 0, sizeof(chunk->vbmaLod));
 
     return chunk;
 }
@@ -126,6 +182,10 @@ Chunk *chunk_new_copy(const Chunk *c) {
         copy->lightingData = NULL;
     }
     copy->rtreeLeaf = NULL;
+    copy->opaquePalette = NULL;
+    copy->opaqueVersion = 0;
+    copy->solidVersion = _chunk_new_solid_version();
+    memcpy(copy->solidMask, c->solidMask, sizeof(c->solidMask));
     copy->dirty = false;
     copy->origin = c->origin;
     copy->bbMin = c->bbMin;
@@ -138,6 +198,7 @@ Chunk *chunk_new_copy(const Chunk *c) {
 
     copy->vbma_opaque = NULL;
     copy->vbma_transparent = NULL;
+    memset(copy->vbmaLod, 0, sizeof(copy->vbmaLod));
 
     return copy;
 }
@@ -162,6 +223,8 @@ void chunk_free(Chunk *chunk, bool updateNeighbors) {
     }
     chunk->vbma_transparent = NULL;
 
+    chunk_flush_lod_vbmas(chunk);
+
     free(chunk);
 }
 
@@ -291,12 +354,70 @@ bool chunk_add_block(Chunk *chunk,
         return false;
     } else {
         octree_set_element(chunk->octree, &block, (size_t)x, (size_t)y, (size_t)z);
+        const size_t i = _chunk_mask_index(x, y, z);
+        chunk->solidMask[i >> 6] |= 1ull << (i & 63);
+        chunk->solidVersion++;
+        chunk->opaquePalette = NULL;
         chunk->nbBlocks++;
         _chunk_update_bounding_box(chunk, (CHUNK_COORDS_INT3_T){x, y, z}, true);
         return true;
     }
 }
 
+int chunk_set_blocks(Chunk *chunk, const Block *blocks) {
+    vx_assert(octree_get_dimension(chunk->octree) == CHUNK_SIZE);
+
+    memcpy(octree_get_elements(chunk->octree), blocks, CHUNK_SIZE_CUBE * sizeof(Block));
+
+    return chunk_refresh_blocks(chunk);
+}
+
+int chunk_refresh_blocks(Chunk *chunk) {
+    vx_assert(octree_get_dimension(chunk->octree) == CHUNK_SIZE);
+
+    const Block air = (Block){SHAPE_COLOR_INDEX_AIR_BLOCK};
+    octree_refresh_nodes(chunk->octree, &air);
+
+    const Block *blocks = (const Block *)octree_get_elements(chunk->octree);
+    int nbBlocks = 0;
+    CHUNK_COORDS_INT3_T bbMin = {CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE};
+    CHUNK_COORDS_INT3_T bbMax = {0, 0, 0};
+    const Block *b = blocks;
+    size_t i = 0;
+    memset(chunk->solidMask, 0, sizeof(chunk->solidMask));
+    chunk->solidVersion++;
+    chunk->opaquePalette = NULL;
+    for (CHUNK_COORDS_INT_T z = 0; z < CHUNK_SIZE; ++z) {
+        for (CHUNK_COORDS_INT_T y = 0; y < CHUNK_SIZE; ++y) {
+            for (CHUNK_COORDS_INT_T x = 0; x < CHUNK_SIZE; ++x) {
+                if (b->colorIndex != SHAPE_COLOR_INDEX_AIR_BLOCK) {
+                    chunk->solidMask[i >> 6] |= 1ull << (i & 63);
+                    ++nbBlocks;
+                    bbMin.x = minimum(bbMin.x, x);
+                    bbMin.y = minimum(bbMin.y, y);
+                    bbMin.z = minimum(bbMin.z, z);
+                    bbMax.x = maximum(bbMax.x, x + 1);
+                    bbMax.y = maximum(bbMax.y, y + 1);
+                    bbMax.z = maximum(bbMax.z, z + 1);
+                }
+                ++b;
+                ++i;
+            }
+        }
+    }
+
+    chunk->nbBlocks = nbBlocks;
+    if (nbBlocks > 0) {
+        chunk->bbMin = bbMin;
+        chunk->bbMax = bbMax;
+    } else {
+        chunk->bbMin = (CHUNK_COORDS_INT3_T){0, 0, 0};
+        chunk->bbMax = (CHUNK_COORDS_INT3_T){0, 0, 0};
+    }
+
+    return nbBlocks;
+}
+
 bool chunk_remove_block(Chunk *chunk,
                         const CHUNK_COORDS_INT_T x,
                         const CHUNK_COORDS_INT_T y,
@@ -311,6 +432,10 @@ bool chunk_remove_block(Chunk *chunk,
         }
         block_set_color_index(b, SHAPE_COLOR_INDEX_AIR_BLOCK);
         octree_remove_element(chunk->octree, (size_t)x, (size_t)y, (size_t)z, NULL);
+        const size_t i = _chunk_mask_index(x, y, z);
+        chunk->solidMask[i >> 6] &= ~(1ull << (i & 63));
+        chunk->opaqueMask[i >> 6] &= ~(1ull << (i & 63));
+        chunk->solidVersion++;
         chunk->nbBlocks--;
         _chunk_update_bounding_box(chunk, (CHUNK_COORDS_INT3_T){x, y, z}, false);
         return true;
@@ -333,6 +458,7 @@ bool chunk_paint_block(Chunk *chunk,
             *prevColorIndex = block_get_color_index(b);
         }
         block_set_color_index(b, colorIndex);
+        chunk->opaquePalette = NULL;
         return true;
     } else {
         return false;
@@ -358,6 +484,71 @@ Block *chunk_get_block(const Chunk *chunk,
         Block *)octree_get_element_without_checking(chunk->octree, (size_t)x, (size_t)y, (size_t)z);
 }
 
+bool chunk_is_block_solid(const Chunk *chunk,
+                          const CHUNK_COORDS_INT_T x,
+                          const CHUNK_COORDS_INT_T y,
+                          const CHUNK_COORDS_INT_T z) {
+    if (chunk == NULL || x < 0 || x > CHUNK_SIZE_MINUS_ONE || y < 0 || y > CHUNK_SIZE_MINUS_ONE ||
+        z < 0 || z > CHUNK_SIZE_MINUS_ONE) {
+        return false;
+    }
+    const size_t i = _chunk_mask_index(x, y, z);
+    return (chunk->solidMask[i >> 6] >> (i & 63)) & 1;
+}
+
+bool chunk_has_solid_blocks_in_box(const Chunk *chunk,
+                                   const CHUNK_COORDS_INT3_T min,
+                                   const CHUNK_COORDS_INT3_T max) {
+    const int fromX = maximum(min.x, 0), toX = minimum(max.x, CHUNK_SIZE_MINUS_ONE);
+    const int fromY = maximum(min.y, 0), toY = minimum(max.y, CHUNK_SIZE_MINUS_ONE);
+    const int fromZ = maximum(min.z, 0), toZ = minimum(max.z, CHUNK_SIZE_MINUS_ONE);
+    if (fromX > toX) {
+        return false;
+    }
+    const uint64_t xMask = (CHUNK_MASK_ROW >> (CHUNK_SIZE_MINUS_ONE - toX + fromX)) << fromX;
+    for (int z = fromZ; z <= toZ; ++z) {
+        for (int y = fromY; y <= toY; ++y) {
+            if (_chunk_mask_get_row(chunk->solidMask, y, z) & xMask) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+const uint64_t *chunk_get_solid_mask(const Chunk *chunk) {
+    return chunk->solidMask;
+}
+
+uint64_t chunk_get_solid_version(const Chunk *chunk) {
+    return chunk->solidVersion;
+}
+
+const uint64_t *chunk_get_opaque_mask(Chunk *chunk, const ColorPalette *palette) {
+    const uint32_t version = color_palette_get_transparency_version(palette);
+    if (chunk->opaquePalette == palette && chunk->opaqueVersion == version) {
+        return chunk->opaqueMask;
+    }
+
+    // transparent blocks are removed from solid mask
+    const Block *blocks = (const Block *)octree_get_elements(chunk->octree);
+    for (size_t w = 0; w < CHUNK_MASK_WORDS; ++w) {
+        uint64_t word = chunk->solidMask[w];
+        uint64_t solid = word;
+        while (solid != 0) {
+            const uint32_t bit = _chunk_mask_lowest_bit(solid);
+            if (color_palette_is_transparent(palette, blocks[(w << 6) + bit].colorIndex)) {
+                word &= ~(1ull << bit);
+            }
+            solid &= solid - 1;
+        }
+        chunk->opaqueMask[w] = word;
+    }
+    chunk->opaquePalette = palette;
+    chunk->opaqueVersion = version;
+    return chunk->opaqueMask;
+}
+
 Block *chunk_get_block_2(const Chunk *chunk, CHUNK_COORDS_INT3_T coords) {
     return chunk_get_block(chunk, coords.x, coords.y, coords.z);
 }
@@ -567,38 +758,16 @@ Chunk *chunk_get_neighbor(const Chunk *chunk, Neighbor location) {
 }
 
 void chunk_move_in_neighborhood(Index3D *chunks, Chunk *chunk, SHAPE_COORDS_INT3_T coords) {
-    void **batchedNode_X = NULL, **batchedNode_Y = NULL;
-
-    // Batch Index3D search for all neighbors on the right (x+1)
-    Chunk *x = NULL, *x_y = NULL, *x_y_z = NULL, *x_y_nz = NULL, *x_ny = NULL, *x_ny_z = NULL,
-          *x_ny_nz = NULL, *x_z = NULL, *x_nz = NULL;
-
-    index3d_batch_get_reset(chunks, &batchedNode_X);
-    if (index3d_batch_get_advance(coords.x + 1, &batchedNode_X)) {
-        // y batch
-        batchedNode_Y = batchedNode_X;
-        if (index3d_batch_get_advance(coords.y, &batchedNode_Y)) {
-            x = index3d_batch_get(coords.z, batchedNode_Y);
-            x_z = index3d_batch_get(coords.z + 1, batchedNode_Y);
-            x_nz = index3d_batch_get(coords.z - 1, batchedNode_Y);
-        }
-
-        // y+1 batch
-        batchedNode_Y = batchedNode_X;
-        if (index3d_batch_get_advance(coords.y + 1, &batchedNode_Y)) {
-            x_y = index3d_batch_get(coords.z, batchedNode_Y);
-            x_y_z = index3d_batch_get(coords.z + 1, batchedNode_Y);
-            x_y_nz = index3d_batch_get(coords.z - 1, batchedNode_Y);
-        }
-
-        // y-1 batch
-        batchedNode_Y = batchedNode_X;
-        if (index3d_batch_get_advance(coords.y - 1, &batchedNode_Y)) {
-            x_ny = index3d_batch_get(coords.z, batchedNode_Y);
-            x_ny_z = index3d_batch_get(coords.z + 1, batchedNode_Y);
-            x_ny_nz = index3d_batch_get(coords.z - 1, batchedNode_Y);
-        }
-    }
+    // neighbors on the right (x+1)
+    Chunk *x = index3d_get(chunks, coords.x + 1, coords.y, coords.z);
+    Chunk *x_z = index3d_get(chunks, coords.x + 1, coords.y, coords.z + 1);
+    Chunk *x_nz = index3d_get(chunks, coords.x + 1, coords.y, coords.z - 1);
+    Chunk *x_y = index3d_get(chunks, coords.x + 1, coords.y + 1, coords.z);
+    Chunk *x_y_z = index3d_get(chunks, coords.x + 1, coords.y + 1, coords.z + 1);
+    Chunk *x_y_nz = index3d_get(chunks, coords.x + 1, coords.y + 1, coords.z - 1);
+    Chunk *x_ny = index3d_get(chunks, coords.x + 1, coords.y - 1, coords.z);
+    Chunk *x_ny_z = index3d_get(chunks, coords.x + 1, coords.y - 1, coords.z + 1);
+    Chunk *x_ny_nz = index3d_get(chunks, coords.x + 1, coords.y - 1, coords.z - 1);
 
     _chunk_hello_neighbor(chunk, NX, x, X);
     _chunk_hello_neighbor(chunk, NX_NZ, x_z, X_Z);
@@ -612,36 +781,16 @@ void chunk_move_in_neighborhood(Index3D *chunks, Chunk *chunk, SHAPE_COORDS_INT3
     _chunk_hello_neighbor(chunk, NX_Y_NZ, x_ny_z, X_NY_Z);
     _chunk_hello_neighbor(chunk, NX_Y_Z, x_ny_nz, X_NY_NZ);
 
-    // Batch Index3D search for all neighbors on the left (x-1)
-    Chunk *nx = NULL, *nx_y = NULL, *nx_y_z = NULL, *nx_y_nz = NULL, *nx_ny = NULL, *nx_ny_z = NULL,
-          *nx_ny_nz = NULL, *nx_z = NULL, *nx_nz = NULL;
-
-    index3d_batch_get_reset(chunks, &batchedNode_X);
-    if (index3d_batch_get_advance(coords.x - 1, &batchedNode_X)) {
-        // y batch
-        batchedNode_Y = batchedNode_X;
-        if (index3d_batch_get_advance(coords.y, &batchedNode_Y)) {
-            nx = index3d_batch_get(coords.z, batchedNode_Y);
-            nx_z = index3d_batch_get(coords.z + 1, batchedNode_Y);
-            nx_nz = index3d_batch_get(coords.z - 1, batchedNode_Y);
-        }
-
-        // y+1 batch
-        batchedNode_Y = batchedNode_X;
-        if (index3d_batch_get_advance(coords.y + 1, &batchedNode_Y)) {
-            nx_y = index3d_batch_get(coords.z, batchedNode_Y);
-            nx_y_z = index3d_batch_get(coords.z + 1, batchedNode_Y);
-            nx_y_nz = index3d_batch_get(coords.z - 1, batchedNode_Y);
-        }
-
-        // y-1 batch
-        batchedNode_Y = batchedNode_X;
-        if (index3d_batch_get_advance(coords.y - 1, &batchedNode_Y)) {
-            nx_ny = index3d_batch_get(coords.z, batchedNode_Y);
-            nx_ny_z = index3d_batch_get(coords.z + 1, batchedNode_Y);
-            nx_ny_nz = index3d_batch_get(coords.z - 1, batchedNode_Y);
-        }
-    }
+    // neighbors on the left (x-1)
+    Chunk *nx = index3d_get(chunks, coords.x - 1, coords.y, coords.z);
+    Chunk *nx_z = index3d_get(chunks, coords.x - 1, coords.y, coords.z + 1);
+    Chunk *nx_nz = index3d_get(chunks, coords.x - 1, coords.y, coords.z - 1);
+    Chunk *nx_y = index3d_get(chunks, coords.x - 1, coords.y + 1, coords.z);
+    Chunk *nx_y_z = index3d_get(chunks, coords.x - 1, coords.y + 1, coords.z + 1);
+    Chunk *nx_y_nz = index3d_get(chunks, coords.x - 1, coords.y + 1, coords.z - 1);
+    Chunk *nx_ny = index3d_get(chunks, coords.x - 1, coords.y - 1, coords.z);
+    Chunk *nx_ny_z = index3d_get(chunks, coords.x - 1, coords.y - 1, coords.z + 1);
+    Chunk *nx_ny_nz = index3d_get(chunks, coords.x - 1, coords.y - 1, coords.z - 1);
 
     _chunk_hello_neighbor(chunk, X, nx, NX);
     _chunk_hello_neighbor(chunk, X_NZ, nx_z, NX_Z);
@@ -655,35 +804,15 @@ void chunk_move_in_neighborhood(Index3D *chunks, Chunk *chunk, SHAPE_COORDS_INT3
     _chunk_hello_neighbor(chunk, X_Y_NZ, nx_ny_z, NX_NY_Z);
     _chunk_hello_neighbor(chunk, X_Y_Z, nx_ny_nz, NX_NY_NZ);
 
-    // Batch Index3D search for remaining neighbors (same x)
-    Chunk *y = NULL, *y_z = NULL, *y_nz = NULL, *ny = NULL, *ny_z = NULL, *ny_nz = NULL, *z = NULL,
-          *nz = NULL;
-
-    index3d_batch_get_reset(chunks, &batchedNode_X);
-    if (index3d_batch_get_advance(coords.x, &batchedNode_X)) {
-        // y batch
-        batchedNode_Y = batchedNode_X;
-        if (index3d_batch_get_advance(coords.y, &batchedNode_Y)) {
-            z = index3d_batch_get(coords.z + 1, batchedNode_Y);
-            nz = index3d_batch_get(coords.z - 1, batchedNode_Y);
-        }
-
-        // y+1 batch
-        batchedNode_Y = batchedNode_X;
-        if (index3d_batch_get_advance(coords.y + 1, &batchedNode_Y)) {
-            y = index3d_batch_get(coords.z, batchedNode_Y);
-            y_z = index3d_batch_get(coords.z + 1, batchedNode_Y);
-            y_nz = index3d_batch_get(coords.z - 1, batchedNode_Y);
-        }
-
-        // y-1 batch
-        batchedNode_Y = batchedNode_X;
-        if (index3d_batch_get_advance(coords.y - 1, &batchedNode_Y)) {
-            ny = index3d_batch_get(coords.z, batchedNode_Y);
-            ny_z = index3d_batch_get(coords.z + 1, batchedNode_Y);
-            ny_nz = index3d_batch_get(coords.z - 1, batchedNode_Y);
-        }
-    }
+    // remaining neighbors (same x)
+    Chunk *z = index3d_get(chunks, coords.x, coords.y, coords.z + 1);
+    Chunk *nz = index3d_get(chunks, coords.x, coords.y, coords.z - 1);
+    Chunk *y = index3d_get(chunks, coords.x, coords.y + 1, coords.z);
+    Chunk *y_z = index3d_get(chunks, coords.x, coords.y + 1, coords.z + 1);
+    Chunk *y_nz = index3d_get(chunks, coords.x, coords.y + 1, coords.z - 1);
+    Chunk *ny = index3d_get(chunks, coords.x, coords.y - 1, coords.z);
+    Chunk *ny_z = index3d_get(chunks, coords.x, coords.y - 1, coords.z + 1);
+    Chunk *ny_nz = index3d_get(chunks, coords.x, coords.y - 1, coords.z - 1);
 
     _chunk_hello_neighbor(chunk, NZ, z, Z);
     _chunk_hello_neighbor(chunk, Z, nz, NZ);
@@ -751,22 +880,184 @@ void chunk_set_vbma(Chunk *chunk, void *vbma, bool transparent) {
     }
 }
 
-void chunk_write_vertices(Shape *shape, Chunk *chunk) {
-    ColorPalette *palette = shape_get_palette(shape);
+void *chunk_get_lod_vbma(const Chunk *chunk, uint8_t lod, bool transparent) {
+    if (lod == 0) {
+        return chunk_get_vbma(chunk, transparent);
+    }
+    return chunk->vbmaLod[lod - 1][transparent ? 1 : 0];
+}
 
-    VertexBufferMemAreaWriter *opaqueWriter = vertex_buffer_mem_area_writer_new(shape,
-                                                                                chunk,
-                                                                                chunk->vbma_opaque,
-                                                                                false);
-#if ENABLE_TRANSPARENCY
-    VertexBufferMemAreaWriter *transparentWriter = vertex_buffer_mem_area_writer_new(
-        shape,
-        chunk,
-        chunk->vbma_transparent,
-        true);
-#else
-    VertexBufferMemAreaWriter *transparentWriter = opaqueWriter;
-#endif
+void chunk_set_lod_vbma(Chunk *chunk, void *vbma, uint8_t lod, bool transparent) {
+    if (lod == 0) {
+        chunk_set_vbma(chunk, vbma, transparent);
+    } else {
+        chunk->vbmaLod[lod - 1][transparent ? 1 : 0] = (VertexBufferMemArea *)vbma;
+    }
+}
+
+void chunk_flush_lod_vbmas(Chunk *chunk) {
+    for (uint8_t lod = 1; lod < CHUNK_LOD_COUNT; ++lod) {
+        for (int i = 0; i < 2; ++i) {
+            if (chunk->vbmaLod[lod - 1][i] != NULL) {
+                vertex_buffer_mem_area_flush(chunk->vbmaLod[lod - 1][i]);
+            }
+            chunk->vbmaLod[lod - 1][i] = NULL;
+        }
+    }
+}
+
+typedef struct {
+    float x, y, z;
+    ATLAS_COLOR_INDEX_INT_T color;
+    VERTEX_LIGHT_STRUCT_T vlight1, vlight2, vlight3, vlight4;
+    FACE_AMBIENT_OCCLUSION_STRUCT_T ao;
+    FACE_INDEX_INT_T faceIndex;
+    bool transparent;
+    bool vLighting;
+} ChunkMeshFace;
+
+struct _ChunkMesh {
+    ChunkMeshFace *faces;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+/// Faces are either written right away in vertex buffers, or recorded in a mesh
+typedef struct {
+    VertexBufferMemAreaWriter *opaqueWriter;
+    VertexBufferMemAreaWriter *transparentWriter;
+    ChunkMesh *mesh;
+} ChunkFaceSink;
+
+static void _chunk_face_sink_write(ChunkFaceSink *sink,
+                                   bool transparent,
+                                   float x,
+                                   float y,
+                                   float z,
+                                   ATLAS_COLOR_INDEX_INT_T color,
+                                   FACE_INDEX_INT_T faceIndex,
+                                   FACE_AMBIENT_OCCLUSION_STRUCT_T ao,
+                                   bool vLighting,
+                                   VERTEX_LIGHT_STRUCT_T vlight1,
+                                   VERTEX_LIGHT_STRUCT_T vlight2,
+                                   VERTEX_LIGHT_STRUCT_T vlight3,
+                                   VERTEX_LIGHT_STRUCT_T vlight4) {
+    if (sink->mesh == NULL) {
+        vertex_buffer_mem_area_writer_write(transparent ? sink->transparentWriter
+                                                        : sink->opaqueWriter,
+                                            x,
+                                            y,
+                                            z,
+                                            color,
+                                            faceIndex,
+                                            ao,
+                                            vLighting,
+                                            vlight1,
+                                            vlight2,
+                                            vlight3,
+                                            vlight4);
+        return;
+    }
+
+    ChunkMesh *m = sink->mesh;
+    if (m->count == m->capacity) {
+        m->capacity = m->capacity > 0 ? m->capacity * 2 : 256;
+        m->faces = (ChunkMeshFace *)realloc(m->faces, sizeof(ChunkMeshFace) * m->capacity);
+    }
+    ChunkMeshFace *f = &m->faces[m->count++];
+    f->x = x;
+    f->y = y;
+    f->z = z;
+    f->color = color;
+    f->vlight1 = vlight1;
+    f->vlight2 = vlight2;
+    f->vlight3 = vlight3;
+    f->vlight4 = vlight4;
+    f->ao = ao;
+    f->faceIndex = faceIndex;
+    f->transparent = transparent;
+    f->vLighting = vLighting;
+}
+
+/// Computes chunk faces, handing them to the given sink.
+/// Only reads shape & chunk data, vertex buffers are only touched by the sink.
+/// Opaque blocks row along x in a neighbor chunk, read from blocks as the neighbor's opaque mask
+/// may be refreshed concurrently by another meshing job
+static uint64_t _chunk_mesh_neighbor_opaque_row(const Chunk *neighbor,
+                                                const ColorPalette *palette,
+                                                const int y,
+                                                const int z) {
+    uint64_t row = 0;
+    if (neighbor != NULL) {
+        const Block *blocks = (const Block *)octree_get_elements(neighbor->octree);
+        const size_t i = _chunk_mask_index(0, y, z);
+        uint64_t solid = _chunk_mask_get_row(neighbor->solidMask, y, z);
+        while (solid != 0) {
+            const uint32_t x = _chunk_mask_lowest_bit(solid);
+            if (color_palette_is_transparent(palette, blocks[i + x].colorIndex) == false) {
+                row |= 1ull << x;
+            }
+            solid &= solid - 1;
+        }
+    }
+    return row;
+}
+
+/// Rows of blocks to mesh: solid blocks, minus opaque blocks enclosed by opaque blocks on all six
+/// sides, as none of their faces would be rendered
+static void _chunk_mesh_get_visible_rows(Chunk *chunk,
+                                         const ColorPalette *palette,
+                                         uint64_t *rows) {
+    const uint64_t *opaque = chunk_get_opaque_mask(chunk, palette);
+    for (int z = 0; z < CHUNK_SIZE; ++z) {
+        for (int y = 0; y < CHUNK_SIZE; ++y) {
+            const uint64_t self = _chunk_mask_get_row(opaque, y, z);
+            uint64_t hidden = self;
+            if (hidden != 0) {
+                const uint64_t left = _chunk_mesh_neighbor_opaque_row(chunk->neighbors[NX],
+                                                                      palette,
+                                                                      y,
+                                                                      z);
+                hidden &= (self << 1) | (left >> CHUNK_SIZE_MINUS_ONE);
+            }
+            if (hidden != 0) {
+                const uint64_t right = _chunk_mesh_neighbor_opaque_row(chunk->neighbors[X],
+                                                                       palette,
+                                                                       y,
+                                                                       z);
+                hidden &= (self >> 1) | ((right & 1) << CHUNK_SIZE_MINUS_ONE);
+            }
+            if (hidden != 0) {
+                hidden &= y > 0 ? _chunk_mask_get_row(opaque, y - 1, z)
+                                : _chunk_mesh_neighbor_opaque_row(chunk->neighbors[NY],
+                                                                  palette,
+                                                                  CHUNK_SIZE_MINUS_ONE,
+                                                                  z);
+            }
+            if (hidden != 0) {
+                hidden &= y < CHUNK_SIZE_MINUS_ONE
+                              ? _chunk_mask_get_row(opaque, y + 1, z)
+                              : _chunk_mesh_neighbor_opaque_row(chunk->neighbors[Y], palette, 0, z);
+            }
+            if (hidden != 0) {
+                hidden &= z > 0 ? _chunk_mask_get_row(opaque, y, z - 1)
+                                : _chunk_mesh_neighbor_opaque_row(chunk->neighbors[NZ],
+                                                                  palette,
+                                                                  y,
+                                                                  CHUNK_SIZE_MINUS_ONE);
+            }
+            if (hidden != 0) {
+                hidden &= z < CHUNK_SIZE_MINUS_ONE
+                              ? _chunk_mask_get_row(opaque, y, z + 1)
+                              : _chunk_mesh_neighbor_opaque_row(chunk->neighbors[Z], palette, y, 0);
+            }
+            rows[y + z * CHUNK_SIZE] = _chunk_mask_get_row(chunk->solidMask, y, z) & ~hidden;
+        }
+    }
+}
+
+static void _chunk_mesh(const Shape *shape, Chunk *chunk, ChunkFaceSink *sink) {
+    const ColorPalette *palette = shape_get_palette(shape);
 
     Block *b;
     SHAPE_COORDS_INT3_T coords_in_shape;
@@ -810,9 +1101,15 @@ void chunk_write_vertices(Shape *shape, Chunk *chunk) {
     // should self be rendered with transparency
     bool selfTransparent;
 
+    uint64_t visibleRows[CHUNK_SIZE_SQR];
+    _chunk_mesh_get_visible_rows(chunk, palette, visibleRows);
+
     for (CHUNK_COORDS_INT_T x = 0; x < CHUNK_SIZE; ++x) {
         for (CHUNK_COORDS_INT_T z = 0; z < CHUNK_SIZE; ++z) {
             for (CHUNK_COORDS_INT_T y = 0; y < CHUNK_SIZE; ++y) {
+                if (((visibleRows[y + z * CHUNK_SIZE] >> x) & 1) == 0) {
+                    continue;
+                }
                 b = chunk_get_block(chunk, x, y, z);
                 if (block_is_solid(b)) {
 
@@ -1184,19 +1481,19 @@ void chunk_write_vertices(Shape *shape, Chunk *chunk) {
                                                     neighbors[NX_NY].vlight);
                         }
 
-                        vertex_buffer_mem_area_writer_write(selfTransparent ? transparentWriter
-                                                                            : opaqueWriter,
-                                                            (float)coords_in_shape.x,
-                                                            (float)coords_in_shape.y,
-                                                            (float)coords_in_shape.z,
-                                                            atlasColorIdx,
-                                                            FACE_LEFT,
-                                                            ao,
-                                                            vLighting,
-                                                            vlight1,
-                                                            vlight2,
-                                                            vlight3,
-                                                            vlight4);
+                        _chunk_face_sink_write(sink,
+                                               selfTransparent,
+                                               (float)coords_in_shape.x,
+                                               (float)coords_in_shape.y,
+                                               (float)coords_in_shape.z,
+                                               atlasColorIdx,
+                                               FACE_LEFT,
+                                               ao,
+                                               vLighting,
+                                               vlight1,
+                                               vlight2,
+                                               vlight3,
+                                               vlight4);
                     }
 
                     if (renderRight) {
@@ -1401,19 +1698,19 @@ void chunk_write_vertices(Shape *shape, Chunk *chunk) {
                                                     neighbors[X_Z].vlight);
                         }
 
-                        vertex_buffer_mem_area_writer_write(selfTransparent ? transparentWriter
-                                                                            : opaqueWriter,
-                                                            (float)coords_in_shape.x,
-                                                            (float)coords_in_shape.y,
-                                                            (float)coords_in_shape.z,
-                                                            atlasColorIdx,
-                                                            FACE_RIGHT,
-                                                            ao,
-                                                            vLighting,
-                                                            vlight1,
-                                                            vlight2,
-                                                            vlight3,
-                                                            vlight4);
+                        _chunk_face_sink_write(sink,
+                                               selfTransparent,
+                                               (float)coords_in_shape.x,
+                                               (float)coords_in_shape.y,
+                                               (float)coords_in_shape.z,
+                                               atlasColorIdx,
+                                               FACE_RIGHT,
+                                               ao,
+                                               vLighting,
+                                               vlight1,
+                                               vlight2,
+                                               vlight3,
+                                               vlight4);
                     }
 
                     if (renderFront) {
@@ -1625,19 +1922,19 @@ void chunk_write_vertices(Shape *shape, Chunk *chunk) {
                                                     neighbors[X_NZ].vlight);
                         }
 
-                        vertex_buffer_mem_area_writer_write(selfTransparent ? transparentWriter
-                                                                            : opaqueWriter,
-                                                            (float)coords_in_shape.x,
-                                                            (float)coords_in_shape.y,
-                                                            (float)coords_in_shape.z,
-                                                            atlasColorIdx,
-                                                            FACE_BACK,
-                                                            ao,
-                                                            vLighting,
-                                                            vlight1,
-                                                            vlight2,
-                                                            vlight3,
-                                                            vlight4);
+                        _chunk_face_sink_write(sink,
+                                               selfTransparent,
+                                               (float)coords_in_shape.x,
+                                               (float)coords_in_shape.y,
+                                               (float)coords_in_shape.z,
+                                               atlasColorIdx,
+                                               FACE_BACK,
+                                               ao,
+                                               vLighting,
+                                               vlight1,
+                                               vlight2,
+                                               vlight3,
+                                               vlight4);
                     }
 
                     if (renderBack) {
@@ -1849,19 +2146,19 @@ void chunk_write_vertices(Shape *shape, Chunk *chunk) {
                                                     neighbors[X_Z].vlight);
                         }
 
-                        vertex_buffer_mem_area_writer_write(selfTransparent ? transparentWriter
-                                                                            : opaqueWriter,
-                                                            (float)coords_in_shape.x,
-                                                            (float)coords_in_shape.y,
-                                                            (float)coords_in_shape.z,
-                                                            atlasColorIdx,
-                                                            FACE_FRONT,
-                                                            ao,
-                                                            vLighting,
-                                                            vlight1,
-                                                            vlight2,
-                                                            vlight3,
-                                                            vlight4);
+                        _chunk_face_sink_write(sink,
+                                               selfTransparent,
+                                               (float)coords_in_shape.x,
+                                               (float)coords_in_shape.y,
+                                               (float)coords_in_shape.z,
+                                               atlasColorIdx,
+                                               FACE_FRONT,
+                                               ao,
+                                               vLighting,
+                                               vlight1,
+                                               vlight2,
+                                               vlight3,
+                                               vlight4);
                     }
 
                     if (renderTop) {
@@ -2082,19 +2379,19 @@ void chunk_write_vertices(Shape *shape, Chunk *chunk) {
                                                     neighbors[Y_NZ].vlight);
                         }
 
-                        vertex_buffer_mem_area_writer_write(selfTransparent ? transparentWriter
-                                                                            : opaqueWriter,
-                                                            (float)coords_in_shape.x,
-                                                            (float)coords_in_shape.y,
-                                                            (float)coords_in_shape.z,
-                                                            atlasColorIdx,
-                                                            FACE_TOP,
-                                                            ao,
-                                                            vLighting,
-                                                            vlight1,
-                                                            vlight2,
-                                                            vlight3,
-                                                            vlight4);
+                        _chunk_face_sink_write(sink,
+                                               selfTransparent,
+                                               (float)coords_in_shape.x,
+                                               (float)coords_in_shape.y,
+                                               (float)coords_in_shape.z,
+                                               atlasColorIdx,
+                                               FACE_TOP,
+                                               ao,
+                                               vLighting,
+                                               vlight1,
+                                               vlight2,
+                                               vlight3,
+                                               vlight4);
                     }
 
                     if (renderBottom) {
@@ -2315,33 +2612,235 @@ void chunk_write_vertices(Shape *shape, Chunk *chunk) {
                                                     neighbors[NY_NZ].vlight);
                         }
 
-                        vertex_buffer_mem_area_writer_write(selfTransparent ? transparentWriter
-                                                                            : opaqueWriter,
-                                                            (float)coords_in_shape.x,
-                                                            (float)coords_in_shape.y,
-                                                            (float)coords_in_shape.z,
-                                                            atlasColorIdx,
-                                                            FACE_DOWN,
-                                                            ao,
-                                                            vLighting,
-                                                            vlight1,
-                                                            vlight2,
-                                                            vlight3,
-                                                            vlight4);
+                        _chunk_face_sink_write(sink,
+                                               selfTransparent,
+                                               (float)coords_in_shape.x,
+                                               (float)coords_in_shape.y,
+                                               (float)coords_in_shape.z,
+                                               atlasColorIdx,
+                                               FACE_DOWN,
+                                               ao,
+                                               vLighting,
+                                               vlight1,
+                                               vlight2,
+                                               vlight3,
+                                               vlight4);
                     }
                 }
             }
         }
     }
+}
+
+static void _chunk_face_sink_init_writers(ChunkFaceSink *sink,
+                                          Shape *shape,
+                                          Chunk *chunk,
+                                          uint8_t lod) {
+    sink->opaqueWriter = vertex_buffer_mem_area_writer_new(shape,
+                                                           chunk,
+                                                           chunk_get_lod_vbma(chunk, lod, false),
+                                                           false,
+                                                           lod);
+#if ENABLE_TRANSPARENCY
+    sink->transparentWriter = vertex_buffer_mem_area_writer_new(
+        shape,
+        chunk,
+        chunk_get_lod_vbma(chunk, lod, true),
+        true,
+        lod);
+#else
+    sink->transparentWriter = sink->opaqueWriter;
+#endif
+    sink->mesh = NULL;
+}
 
-    vertex_buffer_mem_area_writer_done(opaqueWriter);
-    vertex_buffer_mem_area_writer_free(opaqueWriter);
+static void _chunk_face_sink_release_writers(ChunkFaceSink *sink) {
+    vertex_buffer_mem_area_writer_done(sink->opaqueWriter);
+    vertex_buffer_mem_area_writer_free(sink->opaqueWriter);
 #if ENABLE_TRANSPARENCY
-    vertex_buffer_mem_area_writer_done(transparentWriter);
-    vertex_buffer_mem_area_writer_free(transparentWriter);
+    vertex_buffer_mem_area_writer_done(sink->transparentWriter);
+    vertex_buffer_mem_area_writer_free(sink->transparentWriter);
 #endif
 }
 
+void chunk_write_vertices(Shape *shape, Chunk *chunk) {
+    PROFILER_ZONE_BEGIN("chunk_write_vertices");
+    ChunkFaceSink sink;
+    _chunk_face_sink_init_writers(&sink, shape, chunk, 0);
+    _chunk_mesh(shape, chunk, &sink);
+    _chunk_face_sink_release_writers(&sink);
+    PROFILER_ZONE_END();
+}
+
+/// Color of each 2^lod cell of the chunk, air if empty. Cells are found from octree nodes of that
+/// size (only non-empty nodes are visited), their color is the one of the top-most solid block,
+/// seen from above being the most common case for distant terrain.
+static void _chunk_lod_get_cells(const Chunk *chunk, uint8_t lod, SHAPE_COLOR_INDEX_INT_T *cells) {
+    const int cellSize = 1 << lod;
+    const int n = CHUNK_SIZE >> lod;
+    const uint64_t cellRow = (1ull << cellSize) - 1;
+    const Block *blocks = (const Block *)octree_get_elements(chunk->octree);
+
+    memset(cells, SHAPE_COLOR_INDEX_AIR_BLOCK, (size_t)(n * n * n));
+
+    Box box;
+    bool leaf = false;
+    OctreeIterator *oi = octree_iterator_new(chunk->octree);
+    while (octree_iterator_is_done(oi) == false) {
+        octree_iterator_get_node_box(oi, &box);
+        const bool isCell = (int)(box.max.x - box.min.x) == cellSize;
+        if (isCell) {
+            const int x = (int)box.min.x;
+            const int y = (int)box.min.y;
+            const int z = (int)box.min.z;
+            for (int by = y + cellSize - 1; by >= y; --by) {
+                int bz = z;
+                for (; bz < z + cellSize; ++bz) {
+                    const uint64_t row = (_chunk_mask_get_row(chunk->solidMask, by, bz) >> x) &
+                                         cellRow;
+                    if (row != 0) {
+                        const size_t i = _chunk_mask_index(x + (int)_chunk_mask_lowest_bit(row),
+                                                           by,
+                                                           bz);
+                        cells[(x >> lod) + (y >> lod) * n + (z >> lod) * n * n] = blocks[i]
+                                                                                      .colorIndex;
+                        break;
+                    }
+                }
+                if (bz < z + cellSize) {
+                    break;
+                }
+            }
+        }
+        octree_iterator_next(oi, isCell, &leaf);
+    }
+    octree_iterator_free(oi);
+}
+
+void chunk_write_lod_vertices(Shape *shape, Chunk *chunk) {
+    PROFILER_ZONE_BEGIN("chunk_write_lod_vertices");
+    const ColorPalette *palette = shape_get_palette(shape);
+    const bool vLighting = shape_uses_baked_lighting(shape);
+    const FACE_AMBIENT_OCCLUSION_STRUCT_T ao = {0, 0, 0, 0};
+    const VERTEX_LIGHT_STRUCT_T vlight = vertex_light_default;
+
+    // neighbor cell offset & face for each direction
+    static const int8_t dirs[FACE_SIZE_CTC][3] = {{1, 0, 0},
+                                                  {-1, 0, 0},
+                                                  {0, 0, 1},
+                                                  {0, 0, -1},
+                                                  {0, 1, 0},
+                                                  {0, -1, 0}};
+
+    SHAPE_COLOR_INDEX_INT_T cells[CHUNK_SIZE_CUBE >> 3];
+    ChunkFaceSink sink;
+
+    for (uint8_t lod = 1; lod < CHUNK_LOD_COUNT; ++lod) {
+        const int n = CHUNK_SIZE >> lod;
+        _chunk_lod_get_cells(chunk, lod, cells);
+        _chunk_face_sink_init_writers(&sink, shape, chunk, lod);
+
+        for (int z = 0; z < n; ++z) {
+            for (int y = 0; y < n; ++y) {
+                for (int x = 0; x < n; ++x) {
+                    const SHAPE_COLOR_INDEX_INT_T color = cells[x + y * n + z * n * n];
+                    if (color == SHAPE_COLOR_INDEX_AIR_BLOCK) {
+                        continue;
+                    }
+                    const bool selfTransparent = color_palette_is_transparent(palette, color);
+                    const ATLAS_COLOR_INDEX_INT_T atlasColorIdx =
+                        color_palette_get_atlas_index(palette, color);
+
+                    for (FACE_INDEX_INT_T f = 0; f < FACE_SIZE_CTC; ++f) {
+                        const int nx = x + dirs[f][0];
+                        const int ny = y + dirs[f][1];
+                        const int nz = z + dirs[f][2];
+
+                        // faces on chunk borders are always rendered, neighbor chunks may use a
+                        // different LOD level, this keeps all combinations watertight
+                        if (nx >= 0 && nx < n && ny >= 0 && ny < n && nz >= 0 && nz < n) {
+                            const SHAPE_COLOR_INDEX_INT_T neighbor = cells[nx + ny * n +
+                                                                           nz * n * n];
+                            if (neighbor != SHAPE_COLOR_INDEX_AIR_BLOCK &&
+                                (selfTransparent ||
+                                 color_palette_is_transparent(palette, neighbor) == false)) {
+                                continue;
+                            }
+                        }
+
+                        _chunk_face_sink_write(&sink,
+                                               selfTransparent,
+                                               (float)(chunk->origin.x + (x << lod)),
+                                               (float)(chunk->origin.y + (y << lod)),
+                                               (float)(chunk->origin.z + (z << lod)),
+                                               atlasColorIdx,
+                                               f,
+                                               ao,
+                                               vLighting,
+                                               vlight,
+                                               vlight,
+                                               vlight,
+                                               vlight);
+                    }
+                }
+            }
+        }
+
+        _chunk_face_sink_release_writers(&sink);
+    }
+    PROFILER_ZONE_END();
+}
+
+ChunkMesh *chunk_mesh_new(void) {
+    ChunkMesh *m = (ChunkMesh *)malloc(sizeof(ChunkMesh));
+    if (m == NULL) {
+        return NULL;
+    }
+    m->faces = NULL;
+    m->count = 0;
+    m->capacity = 0;
+    return m;
+}
+
+void chunk_mesh_free(ChunkMesh *m) {
+    if (m == NULL) {
+        return;
+    }
+    free(m->faces);
+    free(m);
+}
+
+void chunk_compute_mesh(const Shape *shape, Chunk *chunk, ChunkMesh *mesh) {
+    PROFILER_ZONE_BEGIN("chunk_compute_mesh");
+    ChunkFaceSink sink = {NULL, NULL, mesh};
+    mesh->count = 0;
+    _chunk_mesh(shape, chunk, &sink);
+    PROFILER_ZONE_END();
+}
+
+void chunk_write_mesh(Shape *shape, Chunk *chunk, const ChunkMesh *mesh) {
+    ChunkFaceSink sink;
+    _chunk_face_sink_init_writers(&sink, shape, chunk, 0);
+    const ChunkMeshFace *f;
+    for (uint32_t i = 0; i < mesh->count; ++i) {
+        f = &mesh->faces[i];
+        _chunk_face_sink_write(&sink,
+                               f->transparent,
+                               f->x,
+                               f->y,
+                               f->z,
+                               f->color,
+                               f->faceIndex,
+                               f->ao,
+                               f->vLighting,
+                               f->vlight1,
+                               f->vlight2,
+                               f->vlight3,
+                               f->vlight4);
+    }
+    _chunk_face_sink_release_writers(&sink);
+}
+
 // MARK: private functions
 
 Octree *_chunk_new_octree(void) {
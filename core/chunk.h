@@ -89,6 +89,16 @@ bool chunk_add_block(Chunk *chunk,
                      const CHUNK_COORDS_INT_T y,
                      const CHUNK_COORDS_INT_T z);
 
+/// Replaces all blocks of the chunk in one go, from a dense array of CHUNK_SIZE_CUBE blocks
+/// indexed with x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQR, air blocks are left empty.
+/// Lighting data isn't modified. Returns the number of solid blocks.
+int chunk_set_blocks(Chunk *chunk, const Block *blocks);
+
+/// Refreshes octree nodes, blocks count & bounding box after blocks were written directly in the
+/// octree elements (see octree_get_elements), same layout as chunk_set_blocks.
+/// Returns the number of solid blocks.
+int chunk_refresh_blocks(Chunk *chunk);
+
 bool chunk_remove_block(Chunk *chunk,
                         const CHUNK_COORDS_INT_T x,
                         const CHUNK_COORDS_INT_T y,
@@ -128,6 +138,34 @@ void chunk_get_bounding_box_2(const Chunk *chunk,
                               CHUNK_COORDS_INT3_T *min,
                               CHUNK_COORDS_INT3_T *max);
 
+// MARK: - Occupancy masks -
+
+// One bit per block, indexed like blocks: x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQR, so that each
+// row of CHUNK_SIZE blocks along x is contained in a single 64-bit word.
+#define CHUNK_MASK_WORDS (CHUNK_SIZE_CUBE / 64)
+
+/// Faster than block_is_solid(chunk_get_block(...)), false if out of chunk bounds
+bool chunk_is_block_solid(const Chunk *chunk,
+                          const CHUNK_COORDS_INT_T x,
+                          const CHUNK_COORDS_INT_T y,
+                          const CHUNK_COORDS_INT_T z);
+
+/// Whether there is at least one solid block between min & max chunk coordinates (included)
+bool chunk_has_solid_blocks_in_box(const Chunk *chunk,
+                                   const CHUNK_COORDS_INT3_T min,
+                                   const CHUNK_COORDS_INT3_T max);
+
+/// Solid blocks mask, kept up to date by chunk block functions
+const uint64_t *chunk_get_solid_mask(const Chunk *chunk);
+
+/// Changes each time the solid mask may have changed, never equal for two different chunks: a
+/// cache of the solid mask is up to date if both chunk pointer & version are the same
+uint64_t chunk_get_solid_version(const Chunk *chunk);
+
+/// Opaque blocks mask (solid & not transparent in given palette), refreshed if blocks or palette
+/// transparency changed since last call. Like meshing, not to be called concurrently on a chunk.
+const uint64_t *chunk_get_opaque_mask(Chunk *chunk, const ColorPalette *palette);
+
 // MARK: - Neighbors -
 
 Chunk *chunk_get_neighbor(const Chunk *chunk, Neighbor location);
@@ -140,6 +178,35 @@ void *chunk_get_vbma(const Chunk *chunk, bool transparent);
 void chunk_set_vbma(Chunk *chunk, void *vbma, bool transparent);
 void chunk_write_vertices(Shape *shape, Chunk *chunk);
 
+// Level of detail meshes: level 0 is full resolution, each following level halves resolution.
+// Coarser levels are only meshed for shapes with LODs enabled, see shape_set_lods_enabled.
+#define CHUNK_LOD_COUNT 3
+
+/// LOD level 0 is the regular mesh, level `lod` is meshed from cells of 2^lod blocks per side
+void *chunk_get_lod_vbma(const Chunk *chunk, uint8_t lod, bool transparent);
+void chunk_set_lod_vbma(Chunk *chunk, void *vbma, uint8_t lod, bool transparent);
+
+/// Writes meshes of all coarser LOD levels (1 to CHUNK_LOD_COUNT - 1), in the shape's LOD vertex
+/// buffers. A cell is solid if any of its blocks is, faces on chunk borders are always written.
+void chunk_write_lod_vertices(Shape *shape, Chunk *chunk);
+
+/// Releases vertices of coarser LOD levels, when disabling LODs
+void chunk_flush_lod_vbmas(Chunk *chunk);
+
+/// Chunk faces computed by chunk_compute_mesh, not written in vertex buffers yet.
+/// Allows to mesh several chunks in parallel, vertex buffers being filled afterwards.
+typedef struct _ChunkMesh ChunkMesh;
+
+ChunkMesh *chunk_mesh_new(void);
+void chunk_mesh_free(ChunkMesh *m);
+
+/// Computes chunk faces in `mesh` (discarding its previous content), vertex buffers are untouched.
+/// Can be called from any thread, as long as the shape isn't modified meanwhile.
+void chunk_compute_mesh(const Shape *shape, Chunk *chunk, ChunkMesh *mesh);
+
+/// Writes faces computed by chunk_compute_mesh, same result as chunk_write_vertices
+void chunk_write_mesh(Shape *shape, Chunk *chunk, const ChunkMesh *mesh);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
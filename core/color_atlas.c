@@ -14,6 +14,41 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define COLOR_ATLAS_AVAILABLE_WORDS (ATLAS_COLOR_INDEX_MAX_COUNT / 64)
+
+static uint32_t _color_atlas_lowest_bit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(word);
+#else
+    uint32_t bit = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+/// Pops lowest available index, returns false if there's none
+static bool _color_atlas_pop_available_index(ColorAtlas *a, ATLAS_COLOR_INDEX_INT_T *index) {
+    if (a->nbAvailableIndices == 0) {
+        return false;
+    }
+    for (uint32_t w = a->availableIndicesHint; w < COLOR_ATLAS_AVAILABLE_WORDS; ++w) {
+        const uint64_t word = a->availableIndices[w];
+        if (word != 0) {
+            const uint32_t bit = _color_atlas_lowest_bit(word);
+            a->availableIndices[w] = word & (word - 1);
+            a->availableIndicesHint = w;
+            --a->nbAvailableIndices;
+            *index = w * 64 + bit;
+            return true;
+        }
+    }
+    vx_assert(false); // nbAvailableIndices out of sync
+    return false;
+}
+
 void _color_atlas_add_index_to_dirty_slice(ColorAtlas *a, ATLAS_COLOR_INDEX_INT_T index) {
     if (a->dirty_slice_min != ATLAS_COLOR_INDEX_ERROR &&
         a->dirty_slice_max != ATLAS_COLOR_INDEX_ERROR) {
@@ -28,7 +63,10 @@ ColorAtlas *color_atlas_new(void) {
     ColorAtlas *color_atlas = (ColorAtlas *)malloc(sizeof(ColorAtlas));
 
     color_atlas->wptr = NULL;
-    color_atlas->availableIndices = fifo_list_new();
+    color_atlas->availableIndices = (uint64_t *)calloc(COLOR_ATLAS_AVAILABLE_WORDS,
+                                                       sizeof(uint64_t));
+    color_atlas->nbAvailableIndices = 0;
+    color_atlas->availableIndicesHint = 0;
     color_atlas->count = 0;
     color_atlas->size = COLOR_ATLAS_SIZE;
     color_atlas->dirty_slice_min = ATLAS_COLOR_INDEX_ERROR;
@@ -47,7 +85,7 @@ void color_atlas_free(ColorAtlas *a) {
         weakptr_invalidate(a->wptr);
         free(a->colors);
         free(a->complementaryColors);
-        fifo_list_free(a->availableIndices, free);
+        free(a->availableIndices);
     }
     free(a);
 }
@@ -73,13 +111,10 @@ Weakptr *color_atlas_get_and_retain_weakptr(ColorAtlas *a) {
 ATLAS_COLOR_INDEX_INT_T color_atlas_check_and_add_color(ColorAtlas *a, RGBAColor color) {
     // get an available index below count, or expand
     ATLAS_COLOR_INDEX_INT_T index;
-    void *pop = fifo_list_pop(a->availableIndices);
-    if (pop != NULL) {
-        index = *((ATLAS_COLOR_INDEX_INT_T *)pop);
-        free(pop);
-    } else if (a->count >= ATLAS_COLOR_INDEX_MAX_COUNT) {
-        return ATLAS_COLOR_INDEX_ERROR; // atlas at max capacity
-    } else {
+    if (_color_atlas_pop_available_index(a, &index) == false) {
+        if (a->count >= ATLAS_COLOR_INDEX_MAX_COUNT) {
+            return ATLAS_COLOR_INDEX_ERROR; // atlas at max capacity
+        }
         index = a->count++;
     }
 
@@ -98,15 +133,21 @@ ATLAS_COLOR_INDEX_INT_T color_atlas_check_and_add_color(ColorAtlas *a, RGBAColor
 }
 
 void color_atlas_remove_color(ColorAtlas *a, ATLAS_COLOR_INDEX_INT_T index) {
-    if (index >= ATLAS_COLOR_INDEX_MAX_COUNT) {
+    if (index >= a->count) {
         return;
     }
 
     // index becomes available
-    ATLAS_COLOR_INDEX_INT_T *push = (ATLAS_COLOR_INDEX_INT_T *)malloc(
-        sizeof(ATLAS_COLOR_INDEX_INT_T));
-    *push = index;
-    fifo_list_push(a->availableIndices, push);
+    const uint32_t w = index / 64;
+    const uint64_t bit = (uint64_t)1 << (index % 64);
+    if ((a->availableIndices[w] & bit) != 0) {
+        return; // already available
+    }
+    a->availableIndices[w] |= bit;
+    ++a->nbAvailableIndices;
+    if (w < a->availableIndicesHint) {
+        a->availableIndicesHint = w;
+    }
 
     // note: removed color do not need to be set dirty, it simply becomes available and won't be
     // used in the meantime
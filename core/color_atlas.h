@@ -14,7 +14,6 @@ extern "C" {
 #include <stdint.h>
 
 #include "colors.h"
-#include "fifo_list.h"
 #include "float3.h"
 #include "hash_uint32_int.h"
 #include "weakptr.h"
@@ -36,7 +35,9 @@ typedef struct ColorAtlas {
     Weakptr *wptr;
     RGBAColor *colors;
     RGBAColor *complementaryColors;
-    FifoList *availableIndices; // pool of available indices below count
+    uint64_t *availableIndices; // bitmap of available indices below count
+    uint32_t nbAvailableIndices;
+    uint32_t availableIndicesHint; // no available index in bitmap words below this one
     uint32_t count;
     uint32_t size; // atlas dimension
     ATLAS_COLOR_INDEX_INT_T dirty_slice_min, dirty_slice_max;
@@ -38,19 +38,17 @@ void _color_palette_unmap_entry_and_remap_duplicate(ColorPalette *p,
                                                     SHAPE_COLOR_INDEX_INT_T entry) {
     int idx;
     uint32_t rgba = color_to_uint32(&p->entries[entry].color);
-    if (hash_uint32_int_get(p->colorToIdx, rgba, &idx)) {
+    if (hash_uint32_int_get(p->colorToIdx, rgba, &idx) && idx == entry) {
         // this entry was the one used for mapping index, unmap it
         hash_uint32_int_delete(p->colorToIdx, rgba);
 
         // remap first duplicate if any
-        RGBAColor color;
+        SHAPE_COLOR_INDEX_INT_T dup;
         for (SHAPE_COLOR_INDEX_INT_T i = 0; i < p->orderedCount; ++i) {
-            if (i != entry) {
-                color = p->entries[p->orderedIndices != NULL ? p->orderedIndices[i] : i].color;
-                if (colors_are_equal(&color, &p->entries[entry].color)) {
-                    hash_uint32_int_set(p->colorToIdx, color_to_uint32(&color), i);
-                    break;
-                }
+            dup = p->orderedIndices != NULL ? p->orderedIndices[i] : i;
+            if (dup != entry && colors_are_equal(&p->entries[dup].color, &p->entries[entry].color)) {
+                hash_uint32_int_set(p->colorToIdx, rgba, dup);
+                break;
             }
         }
     }
@@ -70,6 +68,7 @@ ColorPalette *color_palette_new(ColorAtlas *atlas) {
     p->colorToIdx = hash_uint32_int_new();
     p->count = 0;
     p->orderedCount = 0;
+    p->transparencyVersion = 0;
     p->lighting_dirty = false;
     p->wptr = NULL;
     p->refCount = 1;
@@ -92,6 +91,7 @@ ColorPalette *color_palette_new_from_data(ColorAtlas *atlas,
     p->colorToIdx = hash_uint32_int_new();
     p->count = count;
     p->orderedCount = count;
+    p->transparencyVersion = 0;
     p->lighting_dirty = false;
     p->wptr = NULL;
     p->refCount = 1;
@@ -210,6 +210,8 @@ bool color_palette_check_and_add_color(ColorPalette *p,
     if (pop != NULL) {
         idx = *((SHAPE_COLOR_INDEX_INT_T *)pop);
         free(pop);
+        // reused entry
+        ++p->transparencyVersion;
     } else {
         idx = p->count++;
     }
@@ -363,6 +365,9 @@ void color_palette_set_color(ColorPalette *p, SHAPE_COLOR_INDEX_INT_T entry, RGB
             p->lighting_dirty = true;
         }
     }
+    if (color_is_opaque(&p->entries[entry].color) != color_is_opaque(&color)) {
+        ++p->transparencyVersion;
+    }
 
     ColorAtlas *a = (ColorAtlas *)weakptr_get(p->refAtlas);
 
@@ -405,6 +410,10 @@ bool color_palette_is_transparent(const ColorPalette *p, SHAPE_COLOR_INDEX_INT_T
     return p->entries[entry].color.a < 255;
 }
 
+uint32_t color_palette_get_transparency_version(const ColorPalette *p) {
+    return p->transparencyVersion;
+}
+
 ATLAS_COLOR_INDEX_INT_T color_palette_get_atlas_index(const ColorPalette *p,
                                                       SHAPE_COLOR_INDEX_INT_T entry) {
     if (entry == SHAPE_COLOR_INDEX_AIR_BLOCK || entry >= p->count) {
@@ -438,6 +447,7 @@ VERTEX_LIGHT_STRUCT_T color_palette_get_emissive_color_as_light(const ColorPalet
 void color_palette_copy(ColorPalette *dst, const ColorPalette *src) {
     dst->count = src->count;
     dst->orderedCount = src->orderedCount;
+    ++dst->transparencyVersion;
 
     // copy entries
     const uint8_t size = maximum(src->count, SHAPE_COLOR_INDEX_MAX_COUNT);
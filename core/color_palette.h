@@ -15,6 +15,7 @@ extern "C" {
 #include "color_atlas.h"
 #include "colors.h"
 #include "config.h"
+#include "fifo_list.h"
 #include "weakptr.h"
 
 #define DEBUG_PALETTE_RUN_TESTS false
@@ -58,10 +59,13 @@ typedef struct ColorPalette {
     // Number of colors in user-friendly order
     uint8_t orderedCount;
 
+    // Incremented whenever an entry used by blocks may go from opaque to transparent or back
+    uint32_t transparencyVersion;
+
     // Is true if any alpha or emission values changed since last clear
     bool lighting_dirty;
 
-    char pad[3];
+    char pad[7];
 
 } ColorPalette;
 
@@ -103,6 +107,8 @@ RGBAColor color_palette_get_color(const ColorPalette *p, SHAPE_COLOR_INDEX_INT_T
 void color_palette_set_emissive(ColorPalette *p, SHAPE_COLOR_INDEX_INT_T entry, bool toggle);
 bool color_palette_is_emissive(const ColorPalette *p, SHAPE_COLOR_INDEX_INT_T entry);
 bool color_palette_is_transparent(const ColorPalette *p, SHAPE_COLOR_INDEX_INT_T entry);
+/// Can be compared with a previous value to know if transparency of any entry changed since
+uint32_t color_palette_get_transparency_version(const ColorPalette *p);
 bool color_palette_get_shape_index(const ColorPalette *p, SHAPE_COLOR_INDEX_INT_T *entryOut);
 ATLAS_COLOR_INDEX_INT_T color_palette_get_atlas_index(const ColorPalette *p,
                                                       SHAPE_COLOR_INDEX_INT_T entry);
@@ -26,6 +26,12 @@ extern "C" {
 #define vx_deprecated(_MSG) __attribute__((deprecated(_MSG)))
 #endif
 
+#ifdef __VX_PLATFORM_WINDOWS
+#define vx_thread_local __declspec(thread)
+#else
+#define vx_thread_local __thread
+#endif
+
 // GENERAL
 
 #define MAP_DEFAULT_SCALE 5.0f
@@ -52,8 +58,8 @@ extern "C" {
 #define EVENT_TYPE_FROM_SCRIPT_WITH_DEBUG                                                          \
     5 // sent as EVENT_TYPE_FROM_SCRIPT, with attached debug metadata
 
-// UNDO MAXIMUM ACTIONS
-#define NB_UNDOABLE_ACTIONS 20
+// UNDO MEMORY LIMIT (bytes), oldest actions are discarded beyond that
+#define HISTORY_DEFAULT_MEMORY_LIMIT 33554432 // 32MB
 
 // MARK: - Maths -
 
@@ -124,6 +130,12 @@ extern unsigned long upper_power_of_two(unsigned long v);
     64.0f // 1/4 of a large-sized map, or "10 frames" of max velocity (PHYSICS_MAX_VELOCITY * .016)
 /// When updating a leaf, stick to current node if volume expansion is below threshold
 #define RTREE_LEAF_UPDATE_THRESHOLD 25.0f
+/// Moving leaves are placed in the tree w/ their aabb enlarged by this margin, and by their motion
+/// over that many ticks, so that they do not change the tree every tick
+#define RTREE_LEAF_FAT_MARGIN 0.5f
+#define RTREE_LEAF_FAT_MOTION_FACTOR 2.0f
+/// Maximum number of leaves reinserted per refit, others wait for the next ones
+#define RTREE_REFIT_MAX_REINSERTIONS 16
 /// Maximum velocity magnitude in unit/sec for all objects
 #define PHYSICS_MAX_VELOCITY 400.0f
 #define PHYSICS_MAX_SQR_VELOCITY 160000.0f
@@ -306,6 +318,12 @@ static const FACE_INDEX_INT_T FACE_NONE = 7;
 // Subsequent buffers on init/runtime can be downscaled or upscaled, see shape_add_buffer
 #define SHAPE_BUFFER_INIT_SCALE_RATE .75f
 #define SHAPE_BUFFER_RUNTIME_SCALE_RATE 4.0f
+// Maximum amount of vertices moved per shape refresh to fill vertex buffer gaps, remaining gaps
+// are filled during following refreshes, see vertex_buffer_set_compaction_budget
+#define SHAPE_BUFFER_COMPACTION_BUDGET 65536
+// Distance (in blocks) from LOD camera position covered by each chunk LOD level, see
+// shape_set_lod_distance
+#define SHAPE_LOD_DEFAULT_DISTANCE 128.0f
 
 //// Disabling global lighting will use neutral value (15, 0, 0, 0) everywhere
 #define GLOBAL_LIGHTING_ENABLED true
@@ -0,0 +1,511 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  culling.c
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#include "culling.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cclog.h"
+#include "chunk.h"
+#include "color_palette.h"
+#include "rtree.h"
+#include "transform.h"
+
+// clip space w below which a point is considered behind the camera
+#define CULLING_MIN_W 0.0001f
+// depth of boxes crossing the near plane, always visible & never occluders
+#define CULLING_DEPTH_NEAR_PLANE -FLT_MAX
+
+// chunk within the frustum, with the pixels it covers (x1 & y1 excluded)
+typedef struct {
+    Chunk *chunk;
+    float depth; // nearest depth of chunk blocks box
+    int16_t x0, y0, x1, y1;
+    char pad[4];
+} CullingEntry;
+
+struct _Culling {
+    Matrix4x4 viewProj;
+    // depth of nearest occluder for each pixel, FLT_MAX if none
+    float *depth;
+    // chunks of the last shape within frustum, sorted from nearest to farthest
+    CullingEntry *entries;
+    uint32_t nbEntries;
+    uint32_t entriesCapacity;
+    uint16_t width;
+    uint16_t height;
+    char pad[4];
+};
+
+// box projected on the depth buffer
+typedef struct {
+    float x[8], y[8];
+    float nearDepth, farDepth;
+} CullingProjectedBox;
+
+// MARK: - Private -
+
+static void _culling_get_mvp(const Culling *c, Shape *s, Matrix4x4 *mvp) {
+    Transform *t = shape_get_root_transform(s);
+    transform_refresh(t, false, true);
+    matrix4x4_copy(mvp, &c->viewProj);
+    matrix4x4_op_multiply(mvp, transform_get_ltw(t));
+
+    // model space is offset by shape pivot, see shape_block_to_local
+    const float3 p = shape_get_pivot(s);
+    mvp->x4y1 -= mvp->x1y1 * p.x + mvp->x2y1 * p.y + mvp->x3y1 * p.z;
+    mvp->x4y2 -= mvp->x1y2 * p.x + mvp->x2y2 * p.y + mvp->x3y2 * p.z;
+    mvp->x4y3 -= mvp->x1y3 * p.x + mvp->x2y3 * p.y + mvp->x3y3 * p.z;
+    mvp->x4y4 -= mvp->x1y4 * p.x + mvp->x2y4 * p.y + mvp->x3y4 * p.z;
+}
+
+/// Frustum planes in the space transformed by `m`, normals pointing inside. Near plane is taken at
+/// clip z = -w, covering both [-w, w] & [0, w] depth ranges.
+static void _culling_get_planes(const Matrix4x4 *m, float4 *planes) {
+    const float4 r1 = {m->x1y1, m->x2y1, m->x3y1, m->x4y1};
+    const float4 r2 = {m->x1y2, m->x2y2, m->x3y2, m->x4y2};
+    const float4 r3 = {m->x1y3, m->x2y3, m->x3y3, m->x4y3};
+    const float4 r4 = {m->x1y4, m->x2y4, m->x3y4, m->x4y4};
+
+    planes[0] = (float4){r4.x + r1.x, r4.y + r1.y, r4.z + r1.z, r4.w + r1.w};
+    planes[1] = (float4){r4.x - r1.x, r4.y - r1.y, r4.z - r1.z, r4.w - r1.w};
+    planes[2] = (float4){r4.x + r2.x, r4.y + r2.y, r4.z + r2.z, r4.w + r2.w};
+    planes[3] = (float4){r4.x - r2.x, r4.y - r2.y, r4.z - r2.z, r4.w - r2.w};
+    planes[4] = (float4){r4.x + r3.x, r4.y + r3.y, r4.z + r3.z, r4.w + r3.w};
+    planes[5] = (float4){r4.x - r3.x, r4.y - r3.y, r4.z - r3.z, r4.w - r3.w};
+}
+
+/// Returns false if box is entirely outside of one of the planes, `inside` is set if box is
+/// entirely inside all planes
+static bool _culling_box_in_frustum(const float4 *planes, const Box *box, bool *inside) {
+    *inside = true;
+    for (int i = 0; i < 6; ++i) {
+        const float4 *p = &planes[i];
+        const float far = p->x * (p->x >= 0.0f ? box->max.x : box->min.x) +
+                          p->y * (p->y >= 0.0f ? box->max.y : box->min.y) +
+                          p->z * (p->z >= 0.0f ? box->max.z : box->min.z) + p->w;
+        if (far < 0.0f) {
+            return false;
+        }
+        const float near = p->x * (p->x >= 0.0f ? box->min.x : box->max.x) +
+                           p->y * (p->y >= 0.0f ? box->min.y : box->max.y) +
+                           p->z * (p->z >= 0.0f ? box->min.z : box->max.z) + p->w;
+        if (near < 0.0f) {
+            *inside = false;
+        }
+    }
+    return true;
+}
+
+/// Projects box corners in depth buffer pixels, returns false if box crosses the near plane
+static bool _culling_project_box(const Culling *c,
+                                 const Matrix4x4 *mvp,
+                                 const Box *box,
+                                 CullingProjectedBox *out) {
+    out->nearDepth = FLT_MAX;
+    out->farDepth = -FLT_MAX;
+    float4 clip;
+    for (int i = 0; i < 8; ++i) {
+        const float4 corner = {(i & 1) ? box->max.x : box->min.x,
+                               (i & 2) ? box->max.y : box->min.y,
+                               (i & 4) ? box->max.z : box->min.z,
+                               1.0f};
+        matrix4x4_op_multiply_vec(&clip, &corner, mvp);
+        if (clip.w < CULLING_MIN_W) {
+            return false;
+        }
+        out->x[i] = (clip.x / clip.w * 0.5f + 0.5f) * (float)c->width;
+        out->y[i] = (clip.y / clip.w * 0.5f + 0.5f) * (float)c->height;
+        const float depth = clip.z / clip.w;
+        out->nearDepth = minimum(out->nearDepth, depth);
+        out->farDepth = maximum(out->farDepth, depth);
+    }
+    return true;
+}
+
+/// Pixels covered by projected box, x1 & y1 excluded
+static void _culling_get_rect(const Culling *c,
+                              const CullingProjectedBox *p,
+                              int *x0,
+                              int *y0,
+                              int *x1,
+                              int *y1) {
+    float minX = p->x[0], maxX = p->x[0], minY = p->y[0], maxY = p->y[0];
+    for (int i = 1; i < 8; ++i) {
+        minX = minimum(minX, p->x[i]);
+        maxX = maximum(maxX, p->x[i]);
+        minY = minimum(minY, p->y[i]);
+        maxY = maximum(maxY, p->y[i]);
+    }
+    *x0 = (int)CLAMP(floorf(minX), 0.0f, (float)c->width);
+    *x1 = (int)CLAMP(ceilf(maxX), 0.0f, (float)c->width);
+    *y0 = (int)CLAMP(floorf(minY), 0.0f, (float)c->height);
+    *y1 = (int)CLAMP(ceilf(maxY), 0.0f, (float)c->height);
+}
+
+static void _culling_add_entry(Culling *c, Chunk *chunk, const Matrix4x4 *mvp) {
+    if (chunk_get_nb_blocks(chunk) == 0) {
+        return;
+    }
+    if (c->nbEntries == c->entriesCapacity) {
+        const uint32_t capacity = c->entriesCapacity > 0 ? c->entriesCapacity * 2 : 64;
+        CullingEntry *entries = (CullingEntry *)realloc(c->entries,
+                                                        sizeof(CullingEntry) * capacity);
+        if (entries == NULL) {
+            cclog_error("culling: can't allocate entries");
+            return;
+        }
+        c->entries = entries;
+        c->entriesCapacity = capacity;
+    }
+
+    // chunk blocks box in model space
+    const SHAPE_COORDS_INT3_T origin = chunk_get_origin(chunk);
+    const float3 offset = {(float)origin.x, (float)origin.y, (float)origin.z};
+    Box box;
+    chunk_get_bounding_box(chunk, &box.min, &box.max);
+    float3_op_add(&box.min, &offset);
+    float3_op_add(&box.max, &offset);
+
+    CullingEntry *e = &c->entries[c->nbEntries++];
+    e->chunk = chunk;
+    CullingProjectedBox p;
+    if (_culling_project_box(c, mvp, &box, &p) == false) {
+        e->depth = CULLING_DEPTH_NEAR_PLANE;
+        e->x0 = e->y0 = e->x1 = e->y1 = 0;
+        return;
+    }
+    int x0, y0, x1, y1;
+    _culling_get_rect(c, &p, &x0, &y0, &x1, &y1);
+    e->depth = p.nearDepth;
+    e->x0 = (int16_t)x0;
+    e->y0 = (int16_t)y0;
+    e->x1 = (int16_t)x1;
+    e->y1 = (int16_t)y1;
+}
+
+static void _culling_collect_node(Culling *c,
+                                  RtreeNode *rn,
+                                  const float4 *planes,
+                                  const Matrix4x4 *mvp,
+                                  bool inside) {
+    if (inside == false &&
+        _culling_box_in_frustum(planes, rtree_node_get_aabb(rn), &inside) == false) {
+        return;
+    }
+    if (rtree_node_is_leaf(rn)) {
+        _culling_add_entry(c, (Chunk *)rtree_node_get_leaf_ptr(rn), mvp);
+        return;
+    }
+    DoublyLinkedListNode *n = rtree_node_get_children_iterator(rn);
+    while (n != NULL) {
+        _culling_collect_node(c,
+                              (RtreeNode *)doubly_linked_list_node_pointer(n),
+                              planes,
+                              mvp,
+                              inside);
+        n = doubly_linked_list_node_next(n);
+    }
+}
+
+static int _culling_entry_compare(const void *a, const void *b) {
+    const float d1 = ((const CullingEntry *)a)->depth;
+    const float d2 = ((const CullingEntry *)b)->depth;
+    return d1 < d2 ? -1 : (d1 > d2 ? 1 : 0);
+}
+
+/// Lists chunks of the shape within the frustum in entries, from nearest to farthest
+static void _culling_collect(Culling *c, Shape *s, Matrix4x4 *mvp) {
+    c->nbEntries = 0;
+    _culling_get_mvp(c, s, mvp);
+
+    RtreeNode *root = rtree_get_root(shape_get_rtree(s));
+    if (root == NULL || rtree_node_get_children_count(root) == 0) {
+        return;
+    }
+    float4 planes[6];
+    _culling_get_planes(mvp, planes);
+    _culling_collect_node(c, root, planes, mvp, false);
+
+    qsort(c->entries, c->nbEntries, sizeof(CullingEntry), _culling_entry_compare);
+}
+
+/// Visible if any covered pixel has no occluder in front of given depth
+static bool _culling_is_rect_visible(const Culling *c,
+                                     int x0,
+                                     int y0,
+                                     int x1,
+                                     int y1,
+                                     float depth) {
+    if (depth == CULLING_DEPTH_NEAR_PLANE || x0 >= x1 || y0 >= y1) {
+        return true;
+    }
+    for (int y = y0; y < y1; ++y) {
+        const float *row = c->depth + y * c->width;
+        for (int x = x0; x < x1; ++x) {
+            if (row[x] >= depth) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/// > 0 if point (x, y) is on the left of projected corners a -> b
+static float _culling_cross(const CullingProjectedBox *p, int a, int b, float x, float y) {
+    return (p->x[b] - p->x[a]) * (y - p->y[a]) - (p->y[b] - p->y[a]) * (x - p->x[a]);
+}
+
+/// Writes box far depth in pixels whose center is covered by the box silhouette (convex hull of
+/// projected corners)
+static void _culling_rasterize_box(Culling *c, const Matrix4x4 *mvp, const Box *box) {
+    CullingProjectedBox p;
+    if (_culling_project_box(c, mvp, box, &p) == false) {
+        return;
+    }
+
+    // sort corners by x then y, for monotone chain hull
+    int order[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    for (int i = 1; i < 8; ++i) {
+        const int k = order[i];
+        int j = i - 1;
+        while (j >= 0 &&
+               (p.x[order[j]] > p.x[k] || (p.x[order[j]] == p.x[k] && p.y[order[j]] > p.y[k]))) {
+            order[j + 1] = order[j];
+            --j;
+        }
+        order[j + 1] = k;
+    }
+
+    // counter-clockwise hull, lower then upper part
+    int hull[16];
+    int n = 0;
+    for (int i = 0; i < 8; ++i) {
+        const float x = p.x[order[i]], y = p.y[order[i]];
+        while (n >= 2 && _culling_cross(&p, hull[n - 2], hull[n - 1], x, y) <= 0.0f) {
+            --n;
+        }
+        hull[n++] = order[i];
+    }
+    const int lower = n + 1;
+    for (int i = 6; i >= 0; --i) {
+        const float x = p.x[order[i]], y = p.y[order[i]];
+        while (n >= lower && _culling_cross(&p, hull[n - 2], hull[n - 1], x, y) <= 0.0f) {
+            --n;
+        }
+        hull[n++] = order[i];
+    }
+    --n; // last point is the first one
+    if (n < 3) {
+        return;
+    }
+
+    int x0, y0, x1, y1;
+    _culling_get_rect(c, &p, &x0, &y0, &x1, &y1);
+
+    for (int y = y0; y < y1; ++y) {
+        const float cy = (float)y + 0.5f;
+        float *row = c->depth + y * c->width;
+        for (int x = x0; x < x1; ++x) {
+            const float cx = (float)x + 0.5f;
+            int i = 0;
+            for (; i < n; ++i) {
+                if (_culling_cross(&p, hull[i], hull[(i + 1) % n], cx, cy) < 0.0f) {
+                    break;
+                }
+            }
+            if (i == n && p.farDepth < row[x]) {
+                row[x] = p.farDepth;
+            }
+        }
+    }
+}
+
+/// Rasterizes runs of fully opaque cells along x, see CULLING_OCCLUDER_CELL_SIZE
+static void _culling_rasterize_chunk(Culling *c,
+                                     Chunk *chunk,
+                                     const ColorPalette *palette,
+                                     const Matrix4x4 *mvp) {
+    const uint64_t *opaque = chunk_get_opaque_mask(chunk, palette);
+    const SHAPE_COORDS_INT3_T origin = chunk_get_origin(chunk);
+    const int cellSize = CULLING_OCCLUDER_CELL_SIZE;
+    const uint64_t cellBits = (1ull << cellSize) - 1;
+
+    for (int cz = 0; cz < CHUNK_SIZE; cz += cellSize) {
+        for (int cy = 0; cy < CHUNK_SIZE; cy += cellSize) {
+            // blocks of the rows of cells opaque on all their rows
+            uint64_t full = ~0ull;
+            for (int z = cz; z < cz + cellSize && full != 0; ++z) {
+                for (int y = cy; y < cy + cellSize; ++y) {
+                    const size_t i = (size_t)(y * CHUNK_SIZE + z * CHUNK_SIZE_SQR);
+                    full &= opaque[i >> 6] >> (i & 63);
+                }
+            }
+            int runStart = -1;
+            for (int cx = 0; cx <= CHUNK_SIZE; cx += cellSize) {
+                const bool isFull = cx < CHUNK_SIZE && ((full >> cx) & cellBits) == cellBits;
+                if (isFull && runStart < 0) {
+                    runStart = cx;
+                } else if (isFull == false && runStart >= 0) {
+                    const Box box = {{(float)(origin.x + runStart),
+                                      (float)(origin.y + cy),
+                                      (float)(origin.z + cz)},
+                                     {(float)(origin.x + cx),
+                                      (float)(origin.y + cy + cellSize),
+                                      (float)(origin.z + cz + cellSize)}};
+                    _culling_rasterize_box(c, mvp, &box);
+                    runStart = -1;
+                }
+            }
+        }
+    }
+}
+
+/// Keeps visible entries only, returns their count
+static uint32_t _culling_filter_visible(Culling *c) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < c->nbEntries; ++i) {
+        const CullingEntry *e = &c->entries[i];
+        if (_culling_is_rect_visible(c, e->x0, e->y0, e->x1, e->y1, e->depth)) {
+            c->entries[count++] = *e;
+        }
+    }
+    c->nbEntries = count;
+    return count;
+}
+
+static int _culling_range_compare(const void *a, const void *b) {
+    const CullingDrawRange *r1 = (const CullingDrawRange *)a;
+    const CullingDrawRange *r2 = (const CullingDrawRange *)b;
+    const uint32_t id1 = vertex_buffer_get_id(r1->vb);
+    const uint32_t id2 = vertex_buffer_get_id(r2->vb);
+    if (id1 != id2) {
+        return id1 < id2 ? -1 : 1;
+    }
+    return r1->start < r2->start ? -1 : (r1->start > r2->start ? 1 : 0);
+}
+
+// MARK: - Public -
+
+Culling *culling_new(const uint16_t width, const uint16_t height) {
+    Culling *c = (Culling *)malloc(sizeof(Culling));
+    if (c == NULL) {
+        return NULL;
+    }
+    c->width = width > 0 ? width : CULLING_DEPTH_WIDTH;
+    c->height = height > 0 ? height : CULLING_DEPTH_HEIGHT;
+    c->depth = (float *)malloc(sizeof(float) * c->width * c->height);
+    if (c->depth == NULL) {
+        free(c);
+        return NULL;
+    }
+    c->entries = NULL;
+    c->nbEntries = 0;
+    c->entriesCapacity = 0;
+    culling_begin(c, &matrix4x4_identity);
+    return c;
+}
+
+void culling_free(Culling *c) {
+    if (c == NULL) {
+        return;
+    }
+    free(c->depth);
+    free(c->entries);
+    free(c);
+}
+
+void culling_begin(Culling *c, const Matrix4x4 *viewProj) {
+    matrix4x4_copy(&c->viewProj, viewProj);
+    const size_t count = (size_t)c->width * (size_t)c->height;
+    for (size_t i = 0; i < count; ++i) {
+        c->depth[i] = FLT_MAX;
+    }
+}
+
+void culling_add_occluders(Culling *c, Shape *s) {
+    Matrix4x4 mvp;
+    _culling_collect(c, s, &mvp);
+
+    const ColorPalette *palette = shape_get_palette(s);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < c->nbEntries && count < CULLING_MAX_OCCLUDER_CHUNKS; ++i) {
+        if (c->entries[i].depth == CULLING_DEPTH_NEAR_PLANE) {
+            continue;
+        }
+        _culling_rasterize_chunk(c, c->entries[i].chunk, palette, &mvp);
+        ++count;
+    }
+}
+
+uint32_t culling_get_visible_chunks(Culling *c, Shape *s, Chunk **chunks, const uint32_t max) {
+    Matrix4x4 mvp;
+    _culling_collect(c, s, &mvp);
+    const uint32_t count = _culling_filter_visible(c);
+    for (uint32_t i = 0; i < count && i < max; ++i) {
+        chunks[i] = c->entries[i].chunk;
+    }
+    return count;
+}
+
+uint32_t culling_get_draw_ranges(Culling *c,
+                                 Shape *s,
+                                 const bool transparent,
+                                 CullingDrawRange *ranges,
+                                 const uint32_t max) {
+    Matrix4x4 mvp;
+    _culling_collect(c, s, &mvp);
+    const uint32_t nbVisible = _culling_filter_visible(c);
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < nbVisible && count < max; ++i) {
+        Chunk *chunk = c->entries[i].chunk;
+        VertexBufferMemArea *vbma = (VertexBufferMemArea *)
+            chunk_get_lod_vbma(chunk, shape_get_chunk_lod(s, chunk), transparent);
+        while (vbma != NULL && count < max) {
+            if (vertex_buffer_mem_area_get_count(vbma) > 0) {
+                ranges[count++] = (CullingDrawRange){vertex_buffer_mem_area_get_vb(vbma),
+                                                     vertex_buffer_mem_area_get_start_idx(vbma),
+                                                     vertex_buffer_mem_area_get_count(vbma)};
+            }
+            vbma = vertex_buffer_mem_area_get_group_next(vbma);
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    qsort(ranges, count, sizeof(CullingDrawRange), _culling_range_compare);
+    uint32_t merged = 0;
+    for (uint32_t i = 1; i < count; ++i) {
+        CullingDrawRange *last = &ranges[merged];
+        if (ranges[i].vb == last->vb && last->start + last->count == ranges[i].start) {
+            last->count += ranges[i].count;
+        } else {
+            ranges[++merged] = ranges[i];
+        }
+    }
+    return merged + 1;
+}
+
+bool culling_is_box_visible(const Culling *c, const Box *box) {
+    float4 planes[6];
+    bool inside;
+    _culling_get_planes(&c->viewProj, planes);
+    if (_culling_box_in_frustum(planes, box, &inside) == false) {
+        return false;
+    }
+    CullingProjectedBox p;
+    if (_culling_project_box(c, &c->viewProj, box, &p) == false) {
+        return true;
+    }
+    int x0, y0, x1, y1;
+    _culling_get_rect(c, &p, &x0, &y0, &x1, &y1);
+    return _culling_is_rect_visible(c, x0, y0, x1, y1, p.nearDepth);
+}
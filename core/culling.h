@@ -0,0 +1,82 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  culling.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+// CPU visibility of shape chunks, for renderers to only draw what the camera can see.
+//
+// For each frame:
+// 1) culling_begin with the camera view-projection matrix,
+// 2) culling_add_occluders with shapes hiding large parts of the scene (typically the map),
+// 3) culling_get_draw_ranges (or culling_get_visible_chunks) for each shape to draw.
+//
+// Chunks are first tested against the view frustum, walking shape rtrees from the root. Chunks in
+// the frustum are then tested against a coarse depth buffer, rasterized in software from the
+// fully opaque parts of the nearest occluder chunks. Occluders are written at pixel centers with
+// the depth of their farthest point, chunks are tested with their nearest point over all pixels
+// they may cover: hidden chunks may be reported visible, visible chunks are only culled if seen
+// through holes thinner than a depth buffer pixel.
+//
+// Clip space depth is expected to increase away from the camera, in [-w, w] or [0, w].
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "box.h"
+#include "matrix4x4.h"
+#include "shape.h"
+#include "vertextbuffer.h"
+
+// default depth buffer resolution
+#define CULLING_DEPTH_WIDTH 128
+#define CULLING_DEPTH_HEIGHT 64
+// nearest chunks in frustum rasterized as occluders, per culling_add_occluders call
+#define CULLING_MAX_OCCLUDER_CHUNKS 64
+// chunks are split in cells of that many blocks per side, fully opaque cells are occluders
+#define CULLING_OCCLUDER_CELL_SIZE 4
+
+typedef struct _Culling Culling;
+
+/// Vertices to draw in a vertex buffer
+typedef struct {
+    VertexBuffer *vb;
+    uint32_t start, count;
+} CullingDrawRange;
+
+/// Depth buffer resolution, CULLING_DEPTH_WIDTH x CULLING_DEPTH_HEIGHT if 0
+Culling *culling_new(const uint16_t width, const uint16_t height);
+void culling_free(Culling *c);
+
+/// Starts a new frame, clearing occluders. `viewProj` transforms world positions to clip space.
+void culling_begin(Culling *c, const Matrix4x4 *viewProj);
+
+/// Rasterizes the nearest chunks of the shape within the frustum in the depth buffer
+void culling_add_occluders(Culling *c, Shape *s);
+
+/// Chunks of the shape within the frustum & not hidden by occluders, from nearest to farthest.
+/// Returns the amount of visible chunks, at most `max` of them being written in `chunks`.
+uint32_t culling_get_visible_chunks(Culling *c, Shape *s, Chunk **chunks, const uint32_t max);
+
+/// Vertex ranges of visible chunks, at the LOD level selected for each of them (see
+/// shape_get_chunk_lod). Ranges are sorted by vertex buffer & start, contiguous ones being merged.
+/// Returns the amount of ranges written in `ranges`, at most `max`.
+uint32_t culling_get_draw_ranges(Culling *c,
+                                 Shape *s,
+                                 const bool transparent,
+                                 CullingDrawRange *ranges,
+                                 const uint32_t max);
+
+/// World axis-aligned box within the frustum & not hidden by occluders, for objects that
+/// aren't split in chunks
+bool culling_is_box_visible(const Culling *c, const Box *box);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
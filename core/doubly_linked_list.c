@@ -18,6 +18,14 @@ struct _DoublyLinkedListNode {
     void *ptr;                      // stored pointer
 };
 
+// nodes of a list are allocated from its pool, slabs of 4, 8, ... up to 256 nodes
+#define DOUBLY_LINKED_LIST_FIRST_SLAB_CAPACITY 4
+
+// private prototypes
+
+static DoublyLinkedListNode *_doubly_linked_list_node_alloc(DoublyLinkedList *list, void *ptr);
+static void _doubly_linked_list_node_recycle(DoublyLinkedList *list, DoublyLinkedListNode *node);
+
 //---------------------
 // DoublyLinkedList
 //---------------------
@@ -26,6 +34,7 @@ DoublyLinkedList *doubly_linked_list_new(void) {
     DoublyLinkedList *list = (DoublyLinkedList *)malloc(sizeof(DoublyLinkedList));
     list->first = NULL;
     list->last = NULL;
+    pool_init(&list->nodes, sizeof(DoublyLinkedListNode), DOUBLY_LINKED_LIST_FIRST_SLAB_CAPACITY);
     return list;
 }
 
@@ -65,14 +74,13 @@ void doubly_linked_list_flush(DoublyLinkedList *list, pointer_free_function ptr)
 }
 
 void doubly_linked_list_free(DoublyLinkedList *const list) {
-    while (list->last != NULL) {
-        doubly_linked_list_pop_last(list);
-    }
+    // nodes are all released with the pool
+    pool_release(&list->nodes);
     free(list);
 }
 
 DoublyLinkedListNode *doubly_linked_list_push_last(DoublyLinkedList *const list, void *const ptr) {
-    DoublyLinkedListNode *newNode = doubly_linked_list_node_new(ptr);
+    DoublyLinkedListNode *newNode = _doubly_linked_list_node_alloc(list, ptr);
     if (newNode == NULL) {
         return NULL;
     }
@@ -92,7 +100,7 @@ DoublyLinkedListNode *doubly_linked_list_push_last(DoublyLinkedList *const list,
 }
 
 DoublyLinkedListNode *doubly_linked_list_push_first(DoublyLinkedList *const list, void *const ptr) {
-    DoublyLinkedListNode *newNode = doubly_linked_list_node_new(ptr);
+    DoublyLinkedListNode *newNode = _doubly_linked_list_node_alloc(list, ptr);
     if (newNode == NULL) {
         return NULL;
     }
@@ -128,7 +136,7 @@ void *doubly_linked_list_pop_last(DoublyLinkedList *list) {
         list->first = NULL;
     }
 
-    doubly_linked_list_node_free(node);
+    _doubly_linked_list_node_recycle(list, node);
 
     return ptr;
 }
@@ -150,7 +158,7 @@ void *doubly_linked_list_pop_first(DoublyLinkedList *list) {
         list->last = NULL;
     }
 
-    doubly_linked_list_node_free(node);
+    _doubly_linked_list_node_recycle(list, node);
 
     return ptr;
 }
@@ -202,7 +210,7 @@ DoublyLinkedListNode *doubly_linked_list_delete_node(DoublyLinkedList *const lis
         }
     }
 
-    doubly_linked_list_node_free(node);
+    _doubly_linked_list_node_recycle(list, node);
 
     return result;
 }
@@ -211,7 +219,10 @@ DoublyLinkedListNode *doubly_linked_list_insert_node_previous(DoublyLinkedList *
                                                               DoublyLinkedListNode *node,
                                                               void *ptr) {
 
-    DoublyLinkedListNode *newNode = doubly_linked_list_node_new(ptr);
+    DoublyLinkedListNode *newNode = _doubly_linked_list_node_alloc(list, ptr);
+    if (newNode == NULL) {
+        return NULL;
+    }
 
     if (node->previous != NULL) {
         node->previous->next = newNode;
@@ -229,7 +240,10 @@ DoublyLinkedListNode *doubly_linked_list_insert_node_next(DoublyLinkedList *list
                                                           DoublyLinkedListNode *node,
                                                           void *ptr) {
 
-    DoublyLinkedListNode *newNode = doubly_linked_list_node_new(ptr);
+    DoublyLinkedListNode *newNode = _doubly_linked_list_node_alloc(list, ptr);
+    if (newNode == NULL) {
+        return NULL;
+    }
 
     if (node->next != NULL) {
         node->next->previous = newNode;
@@ -369,6 +383,9 @@ void doubly_linked_list_print(const DoublyLinkedList *const list) {
 
 DoublyLinkedListNode *doubly_linked_list_node_new(void *ptr) {
     DoublyLinkedListNode *node = (DoublyLinkedListNode *)malloc(sizeof(DoublyLinkedListNode));
+    if (node == NULL) {
+        return NULL;
+    }
     node->previous = NULL;
     node->next = NULL;
     node->ptr = ptr;
@@ -406,3 +423,27 @@ void *doubly_linked_list_node_pointer(const DoublyLinkedListNode *node) {
 void doubly_linked_list_node_set_pointer(DoublyLinkedListNode *node, void *ptr) {
     node->ptr = ptr;
 }
+
+// MARK: - private functions -
+
+static DoublyLinkedListNode *_doubly_linked_list_node_alloc(DoublyLinkedList *list, void *ptr) {
+    DoublyLinkedListNode *node = (DoublyLinkedListNode *)pool_alloc(&list->nodes);
+    if (node == NULL) {
+        return NULL;
+    }
+    node->previous = NULL;
+    node->next = NULL;
+    node->ptr = ptr;
+    return node;
+}
+
+// same as doubly_linked_list_node_free, giving node back to the list's pool
+static void _doubly_linked_list_node_recycle(DoublyLinkedList *list, DoublyLinkedListNode *node) {
+    if (node->next != NULL) {
+        node->next->previous = node->previous;
+    }
+    if (node->previous != NULL) {
+        node->previous->next = node->next;
+    }
+    pool_recycle(&list->nodes, node);
+}
@@ -11,6 +11,7 @@ extern "C" {
 #endif
 
 #include "function_pointers.h"
+#include "pool.h"
 
 #include <stdbool.h>
 #include <stdlib.h>
@@ -21,6 +22,8 @@ typedef struct _DoublyLinkedListNode DoublyLinkedListNode;
 typedef struct {
     DoublyLinkedListNode *first;
     DoublyLinkedListNode *last;
+    // nodes pushed & inserted in the list, recycled when popped or deleted
+    Pool nodes;
 } DoublyLinkedList;
 
 //--------------------
@@ -33,7 +36,7 @@ DoublyLinkedList *doubly_linked_list_new(void);
 // copy
 bool doubly_linked_list_copy(DoublyLinkedList *const dst, DoublyLinkedList *const src);
 
-// pop and free all nodes, the list itself is not freed
+// pop all nodes, the list itself is not freed, and keeps node memory for reuse
 void doubly_linked_list_flush(DoublyLinkedList *list, pointer_free_function ptr);
 // destructor
 //!\\ stored pointers won't be released
@@ -88,10 +91,10 @@ void doubly_linked_list_print(const DoublyLinkedList *const list);
 // MARK: - DoublyLinkedListNode -
 //--------------------
 
-// constructor
+// constructor, for nodes that are not part of a list
 DoublyLinkedListNode *doubly_linked_list_node_new(void *ptr);
 
-// destructor
+// destructor, for nodes created with doubly_linked_list_node_new
 //!\\ stored pointer won't be released
 void doubly_linked_list_node_free(DoublyLinkedListNode *node);
 
@@ -6,25 +6,25 @@
 
 #include "fifo_list.h"
 
-#include <stdio.h>
+#include <stdbool.h>
 #include <stdlib.h>
 
-struct _FifoListNode {
-    FifoListNode *next;
-    // stored pointer
-    void *ptr;
-};
+// Ring buffer of pointers, the first ones being stored within the list itself.
+// Most queues (scene & rtree traversals) never grow past that, allocating nothing.
+#define FIFO_LIST_INLINE_CAPACITY 8
 
 struct _FifoList {
-    FifoListNode *first;
-    FifoListNode *last;
+    void **items; // points to `inlineItems` until growing
+    uint32_t first;
     uint32_t size;
+    uint32_t capacity; // always a power of 2
+    char pad[4];
+    void *inlineItems[FIFO_LIST_INLINE_CAPACITY];
 };
 
 // private prototypes
 
-FifoListNode *fifo_list_node_new(void *ptr);
-void fifo_list_node_free(FifoListNode *node);
+static bool _fifo_list_grow(FifoList *list);
 
 //---------------------
 // FifoList
@@ -35,59 +35,49 @@ FifoList *fifo_list_new(void) {
     if (list == NULL) {
         return NULL;
     }
-    list->first = NULL;
-    list->last = NULL;
+    list->items = list->inlineItems;
+    list->first = 0;
     list->size = 0;
+    list->capacity = FIFO_LIST_INLINE_CAPACITY;
     return list;
 }
 
 FifoList *fifo_list_new_copy(const FifoList *list) {
     FifoList *copy = fifo_list_new();
-    FifoListNode *n = list->first;
-    while (n != NULL) {
-        fifo_list_push(copy, n->ptr);
-        n = n->next;
+    if (copy == NULL) {
+        return NULL;
+    }
+    const uint32_t mask = list->capacity - 1;
+    for (uint32_t i = 0; i < list->size; ++i) {
+        fifo_list_push(copy, list->items[(list->first + i) & mask]);
     }
     return copy;
 }
 
 void fifo_list_free(FifoList *list, pointer_free_function freeFunc) {
-    while (list->first != NULL) {
-        void *storedPtr = fifo_list_pop(list);
-        if (freeFunc != NULL) {
-            freeFunc(storedPtr);
-        }
+    if (freeFunc != NULL) {
+        fifo_list_flush(list, freeFunc);
+    }
+    if (list->items != list->inlineItems) {
+        free(list->items);
     }
     free(list);
 }
 
 void fifo_list_push(FifoList *list, void *ptr) {
-    FifoListNode *newNode = fifo_list_node_new(ptr);
-    if (list->first == NULL) {
-        list->first = newNode;
-        list->last = newNode;
-    } else {
-        list->last->next = newNode;
-        list->last = newNode;
+    if (list->size == list->capacity && _fifo_list_grow(list) == false) {
+        return;
     }
+    list->items[(list->first + list->size) & (list->capacity - 1)] = ptr;
     list->size++;
 }
 
 void *fifo_list_pop(FifoList *list) {
-
-    if (list->first == NULL) {
+    if (list->size == 0) {
         return NULL;
     }
-
-    FifoListNode *node = list->first;
-    void *ptr = node->ptr;
-    list->first = node->next;
-
-    if (list->first == NULL) {
-        list->last = NULL;
-    }
-
-    fifo_list_node_free(node);
+    void *ptr = list->items[list->first];
+    list->first = (list->first + 1) & (list->capacity - 1);
     list->size--;
     return ptr;
 }
@@ -97,30 +87,34 @@ void fifo_list_empty_freefunc(void *a) {
 }
 
 void fifo_list_flush(FifoList *list, pointer_free_function freeFunc) {
-    while (list->first != NULL) {
+    while (list->size > 0) {
         freeFunc(fifo_list_pop(list));
     }
-    list->size = 0;
+    list->first = 0;
 }
 
-//---------------------
-// FifoListNode
-//---------------------
-
-FifoListNode *fifo_list_node_new(void *ptr) {
-    FifoListNode *node = (FifoListNode *)malloc(sizeof(FifoListNode));
-    if (node == NULL) {
-        return NULL;
-    }
-    node->next = NULL;
-    node->ptr = ptr;
-    return node;
+uint32_t fifo_list_get_size(const FifoList *list) {
+    return list->size;
 }
 
-void fifo_list_node_free(FifoListNode *node) {
-    free(node);
-}
+// MARK: - private functions -
 
-uint32_t fifo_list_get_size(const FifoList *list) {
-    return list->size;
+static bool _fifo_list_grow(FifoList *list) {
+    const uint32_t capacity = list->capacity * 2;
+    void **items = (void **)malloc(sizeof(void *) * capacity);
+    if (items == NULL) {
+        return false;
+    }
+    // unwrap stored pointers at the beginning of the new buffer
+    const uint32_t mask = list->capacity - 1;
+    for (uint32_t i = 0; i < list->size; ++i) {
+        items[i] = list->items[(list->first + i) & mask];
+    }
+    if (list->items != list->inlineItems) {
+        free(list->items);
+    }
+    list->items = items;
+    list->first = 0;
+    list->capacity = capacity;
+    return true;
 }
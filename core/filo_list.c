@@ -6,64 +6,48 @@
 
 #include "filo_list.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 
-typedef struct _FiloListNode FiloListNode;
-
+// growable array, popping keeps capacity for next pushes
 struct _FiloList {
-    FiloListNode *first;
-};
-
-struct _FiloListNode {
-    FiloListNode *next;
-    // stored pointer
-    void *ptr;
+    void **items;
+    uint32_t size;
+    uint32_t capacity;
 };
 
-FiloListNode *filo_list_node_new(void *ptr);
-void filo_list_node_free(FiloListNode *node);
-
 FiloList *filo_list_new(void) {
     FiloList *list = (FiloList *)malloc(sizeof(FiloList));
-    list->first = NULL;
+    if (list == NULL) {
+        return NULL;
+    }
+    list->items = NULL;
+    list->size = 0;
+    list->capacity = 0;
     return list;
 }
 
 void filo_list_free(FiloList *list) {
-    while (list->first != NULL) {
-        filo_list_pop(list);
-    }
+    free(list->items);
     free(list);
 }
 
 void filo_list_push(FiloList *list, void *ptr) {
-    FiloListNode *newNode = filo_list_node_new(ptr);
-    if (list->first != NULL) {
-        newNode->next = list->first;
+    if (list->size == list->capacity) {
+        const uint32_t capacity = list->capacity == 0 ? 8 : list->capacity * 2;
+        void **items = (void **)realloc(list->items, sizeof(void *) * capacity);
+        if (items == NULL) {
+            return;
+        }
+        list->items = items;
+        list->capacity = capacity;
     }
-    list->first = newNode;
+    list->items[list->size++] = ptr;
 }
 
 void *filo_list_pop(FiloList *list) {
-    if (list->first == NULL) {
+    if (list->size == 0) {
         return NULL;
     }
-
-    FiloListNode *node = list->first;
-    list->first = node->next;
-    void *ptr = node->ptr;
-
-    filo_list_node_free(node);
-    return ptr;
-}
-
-FiloListNode *filo_list_node_new(void *ptr) {
-    FiloListNode *node = (FiloListNode *)malloc(sizeof(FiloListNode));
-    node->next = NULL;
-    node->ptr = ptr;
-    return node;
-}
-
-void filo_list_node_free(FiloListNode *node) {
-    free(node);
+    return list->items[--list->size];
 }
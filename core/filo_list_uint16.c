@@ -8,72 +8,49 @@
 
 #include <stdlib.h>
 
+// growable array, popping keeps capacity for next pushes
 struct _FiloListUInt16 {
-    FiloListUInt16Node *first;
+    uint16_t *values;
+    uint32_t size;
+    uint32_t capacity;
 };
 
-struct _FiloListUInt16Node {
-    FiloListUInt16Node *next; /* 8 bytes */
-    // stored integer
-    uint16_t value; /* 2 bytes */
-    char pad[6];
-};
-
-// private prototypes
-
-FiloListUInt16Node *filo_list_uint16_node_new(uint16_t value);
-void filo_list_uint16_node_free(FiloListUInt16Node *node);
-
-//---------------------
-// FiloListUInt16
-//---------------------
-
 FiloListUInt16 *filo_list_uint16_new(void) {
     FiloListUInt16 *list = (FiloListUInt16 *)malloc(sizeof(FiloListUInt16));
-    list->first = NULL;
+    if (list == NULL) {
+        return NULL;
+    }
+    list->values = NULL;
+    list->size = 0;
+    list->capacity = 0;
     return list;
 }
 
 void filo_list_uint16_free(FiloListUInt16 *list) {
-    while (list->first != NULL) {
-        filo_list_uint16_pop(list, NULL);
-    }
+    free(list->values);
     free(list);
 }
 
 void filo_list_uint16_push(FiloListUInt16 *list, uint16_t value) {
-    FiloListUInt16Node *newNode = filo_list_uint16_node_new(value);
-    if (list->first != NULL)
-        newNode->next = list->first;
-    list->first = newNode;
+    if (list->size == list->capacity) {
+        const uint32_t capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+        uint16_t *values = (uint16_t *)realloc(list->values, sizeof(uint16_t) * capacity);
+        if (values == NULL) {
+            return;
+        }
+        list->values = values;
+        list->capacity = capacity;
+    }
+    list->values[list->size++] = value;
 }
 
 bool filo_list_uint16_pop(FiloListUInt16 *list, uint16_t *i) {
-    if (list == NULL || list->first == NULL) {
+    if (list == NULL || list->size == 0) {
         return false;
     }
-
-    FiloListUInt16Node *node = list->first;
+    list->size--;
     if (i != NULL) {
-        *i = node->value;
+        *i = list->values[list->size];
     }
-    list->first = node->next;
-
-    filo_list_uint16_node_free(node);
     return true;
 }
-
-//---------------------
-// FiloListUint16Node
-//---------------------
-
-FiloListUInt16Node *filo_list_uint16_node_new(uint16_t value) {
-    FiloListUInt16Node *node = (FiloListUInt16Node *)malloc(sizeof(FiloListUInt16Node));
-    node->next = NULL;
-    node->value = value;
-    return node;
-}
-
-void filo_list_uint16_node_free(FiloListUInt16Node *node) {
-    free(node);
-}
@@ -15,7 +15,6 @@ extern "C" {
 #include <stdio.h>
 
 typedef struct _FiloListUInt16 FiloListUInt16;
-typedef struct _FiloListUInt16Node FiloListUInt16Node;
 
 FiloListUInt16 *filo_list_uint16_new(void);
 
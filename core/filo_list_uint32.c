@@ -8,62 +8,49 @@
 
 #include <stdlib.h>
 
+// growable array, popping keeps capacity for next pushes
 struct _FiloListUInt32 {
-    FiloListUInt32Node *first;
+    uint32_t *values;
+    uint32_t size;
+    uint32_t capacity;
 };
 
-struct _FiloListUInt32Node {
-    FiloListUInt32Node *next; /* 8 bytes */
-    // stored integer
-    uint32_t value; /* 4 bytes */
-    char pad[4];
-};
-
-FiloListUInt32Node *filo_list_uint32_node_new(uint32_t value);
-void filo_list_uint32_node_free(FiloListUInt32Node *node);
-
 FiloListUInt32 *filo_list_uint32_new(void) {
     FiloListUInt32 *list = (FiloListUInt32 *)malloc(sizeof(FiloListUInt32));
-    list->first = NULL;
+    if (list == NULL) {
+        return NULL;
+    }
+    list->values = NULL;
+    list->size = 0;
+    list->capacity = 0;
     return list;
 }
 
 void filo_list_uint32_free(FiloListUInt32 *list) {
-    while (list->first != NULL) {
-        filo_list_uint32_pop(list, NULL);
-    }
+    free(list->values);
     free(list);
 }
 
 void filo_list_uint32_push(FiloListUInt32 *list, uint32_t value) {
-    FiloListUInt32Node *newNode = filo_list_uint32_node_new(value);
-    if (list->first != NULL)
-        newNode->next = list->first;
-    list->first = newNode;
+    if (list->size == list->capacity) {
+        const uint32_t capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+        uint32_t *values = (uint32_t *)realloc(list->values, sizeof(uint32_t) * capacity);
+        if (values == NULL) {
+            return;
+        }
+        list->values = values;
+        list->capacity = capacity;
+    }
+    list->values[list->size++] = value;
 }
 
 bool filo_list_uint32_pop(FiloListUInt32 *list, uint32_t *i) {
-    if (list == NULL || list->first == NULL) {
+    if (list == NULL || list->size == 0) {
         return false;
     }
-
-    FiloListUInt32Node *node = list->first;
+    list->size--;
     if (i != NULL) {
-        *i = node->value;
+        *i = list->values[list->size];
     }
-    list->first = node->next;
-
-    filo_list_uint32_node_free(node);
     return true;
 }
-
-FiloListUInt32Node *filo_list_uint32_node_new(uint32_t value) {
-    FiloListUInt32Node *node = (FiloListUInt32Node *)malloc(sizeof(FiloListUInt32Node));
-    node->next = NULL;
-    node->value = value;
-    return node;
-}
-
-void filo_list_uint32_node_free(FiloListUInt32Node *node) {
-    free(node);
-}
@@ -15,7 +15,6 @@ extern "C" {
 #include <stdio.h>
 
 typedef struct _FiloListUInt32 FiloListUInt32;
-typedef struct _FiloListUInt32Node FiloListUInt32Node;
 
 FiloListUInt32 *filo_list_uint32_new(void);
 
@@ -20,11 +20,6 @@
 // MARK: - File Private -
 // =============================================================================
 
-// variables used within functions to avoid allocations
-static float _length;
-static float _f;
-static float _x, _y, _z;
-
 /// Utils to go from RGB to HSB and vice versa
 
 typedef struct {
@@ -224,21 +219,21 @@ void float3_copy(float3 *dest, const float3 *src) {
 
 /// f1 = f1 X f2 (f1 is modified)
 void float3_cross_product(float3 *f1, const float3 *f2) {
-    _x = f1->y * f2->z - f1->z * f2->y;
-    _y = f1->z * f2->x - f1->x * f2->z;
-    _z = f1->x * f2->y - f1->y * f2->x;
-    f1->x = _x;
-    f1->y = _y;
-    f1->z = _z;
+    const float x = f1->y * f2->z - f1->z * f2->y;
+    const float y = f1->z * f2->x - f1->x * f2->z;
+    const float z = f1->x * f2->y - f1->y * f2->x;
+    f1->x = x;
+    f1->y = y;
+    f1->z = z;
 }
 
 void float3_cross_product2(const float3 *f1, float3 *f2) {
-    _x = f1->y * f2->z - f1->z * f2->y;
-    _y = f1->z * f2->x - f1->x * f2->z;
-    _z = f1->x * f2->y - f1->y * f2->x;
-    f2->x = _x;
-    f2->y = _y;
-    f2->z = _z;
+    const float x = f1->y * f2->z - f1->z * f2->y;
+    const float y = f1->z * f2->x - f1->x * f2->z;
+    const float z = f1->x * f2->y - f1->y * f2->x;
+    f2->x = x;
+    f2->y = y;
+    f2->z = z;
 }
 
 float3 float3_cross_product3(const float3 *f1, const float3 *f2) {
@@ -271,11 +266,11 @@ float float3_distance(const float3 *f1, const float3 *f2) {
 
 /// normalizes a float3
 void float3_normalize(float3 *const f) {
-    _length = float3_length(f);
-    if (_length != 0.0f) {
-        f->x /= _length;
-        f->y /= _length;
-        f->z /= _length;
+    const float length = float3_length(f);
+    if (length != 0.0f) {
+        f->x /= length;
+        f->y /= length;
+        f->z /= length;
     }
 }
 
@@ -298,14 +293,14 @@ float3 float3_mmin2(const float3 *f1, const float3 *f2) {
 }
 
 void float3_set_norm(float3 *f, float n) {
-    _length = float3_length(f);
-    if (_length == 0.0f) {
+    const float length = float3_length(f);
+    if (length == 0.0f) {
         return;
     }
-    _f = n / _length;
-    f->x = f->x * _f;
-    f->y = f->y * _f;
-    f->z = f->z * _f;
+    const float ratio = n / length;
+    f->x = f->x * ratio;
+    f->y = f->y * ratio;
+    f->z = f->z * ratio;
 }
 
 /// sums two float3 (first argument is modified)
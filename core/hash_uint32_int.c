@@ -6,213 +6,138 @@
 
 #include "hash_uint32_int.h"
 
+#include <string.h>
+
 #include "cclog.h"
-#include <stdio.h>
-
-#define HASH_UINT32_BIT_SHIFT 2
-// 32 / 2 = 16 levels
-#define HASH_TREE_LEVELS 16
-#define HASH_TREE_LEVELS_MINUS_ONE 15
-#define HASH_UINT32_CHILDREN_PER_NODE 16
-// % 16 (modulo) == & 15 (binary operation)
-#define HASH_UINT32_BIN_MODULO 15 // 1111
-
-typedef struct _HashUInt32IntNode HashUInt32IntNode;
-
-struct _HashUInt32IntNode {
-    void **slots;
-    HashUInt32IntNode *parent;
-    uint8_t level;
-    uint8_t index;
-};
+
+// Open addressing with linear probing, in a power of 2 array of slots.
+// Deleting an entry shifts following entries of the same probe sequence
+// back, so that there's no need for tombstones.
+
+#define HASH_UINT32_INT_MIN_CAPACITY 16
+// table grows when more than 3/4 of the slots are used
+#define HASH_UINT32_INT_MAX_LOAD_NUM 3
+#define HASH_UINT32_INT_MAX_LOAD_DEN 4
+
+typedef struct {
+    uint32_t key;
+    int value;
+    bool used;
+    char pad[3];
+} HashUInt32IntSlot;
 
 struct _HashUInt32Int {
-    HashUInt32IntNode *rootNode;
+    HashUInt32IntSlot *slots;
+    uint32_t capacity; // always a power of 2
+    uint32_t count;
 };
 
-// when leaf == true, each branch slot contains a value, not another branch
-HashUInt32IntNode *hash_uint32_node_new(HashUInt32IntNode *parent, uint8_t index, uint8_t level) {
-    vx_assert(level <= HASH_TREE_LEVELS);
-    HashUInt32IntNode *const n = (HashUInt32IntNode *)malloc(sizeof(HashUInt32IntNode));
-    void **slots = (void **)malloc(sizeof(void *) * HASH_UINT32_CHILDREN_PER_NODE);
-    for (int i = 0; i < HASH_UINT32_CHILDREN_PER_NODE; ++i) {
-        slots[i] = NULL;
-    }
-    n->slots = slots;
-    n->parent = parent;
-    n->level = level;
-    n->index = index;
-    return n;
+static uint32_t _hash_uint32_int_slot(const HashUInt32Int *h, const uint32_t key) {
+    // Fibonacci hashing, spreads keys only differing in a few bits (e.g. colors)
+    return (key * 2654435769u) & (h->capacity - 1);
 }
 
-// frees node and all children
-// + sets parent slot to NULL
-void hash_uint32_node_free(HashUInt32IntNode *n) {
-    HashUInt32IntNode *cursor = n;
-    HashUInt32IntNode *tmp = NULL;
-    uint8_t slotCursor = 0;
-    HashUInt32IntNode **slots;
-
-    while (cursor != NULL) {
-        if (slotCursor == HASH_UINT32_CHILDREN_PER_NODE ||
-            cursor->level == HASH_TREE_LEVELS_MINUS_ONE) {
-            // done freeing all children, or reached last level
-            tmp = cursor->parent;
-            slotCursor = cursor->index + 1;
-            for (int i = 0; i < HASH_UINT32_CHILDREN_PER_NODE; ++i) {
-                if (cursor->slots[i] != NULL) {
-                    free(cursor->slots[i]);
-                    cursor->slots[i] = NULL;
-                }
-            }
-            if (tmp != NULL) {
-                // set parent slot to NULL
-                tmp->slots[cursor->index] = NULL;
-            }
-            if (cursor == n) {
-                // don't free nodes above n
-                tmp = NULL;
-            }
-            free(cursor->slots);
-            free(cursor);
-            cursor = tmp;
-            continue;
-        }
+static void _hash_uint32_int_alloc(HashUInt32Int *h, const uint32_t capacity) {
+    h->slots = (HashUInt32IntSlot *)calloc(capacity, sizeof(HashUInt32IntSlot));
+    h->capacity = capacity;
+    h->count = 0;
+}
+
+static void _hash_uint32_int_grow(HashUInt32Int *h) {
+    HashUInt32IntSlot *const slots = h->slots;
+    const uint32_t capacity = h->capacity;
 
-        slots = (HashUInt32IntNode **)(cursor->slots);
-        if (slots[slotCursor] != NULL) {
-            cursor = slots[slotCursor];
-            slotCursor = 0;
-            continue;
+    _hash_uint32_int_alloc(h, capacity * 2);
+
+    for (uint32_t i = 0; i < capacity; ++i) {
+        if (slots[i].used) {
+            hash_uint32_int_set(h, slots[i].key, slots[i].value);
         }
-        ++slotCursor; // child is NULL, go see next
     }
+    free(slots);
 }
 
 HashUInt32Int *hash_uint32_int_new(void) {
     HashUInt32Int *h = (HashUInt32Int *)malloc(sizeof(HashUInt32Int));
-    h->rootNode = hash_uint32_node_new(NULL, 0, 1);
+    _hash_uint32_int_alloc(h, HASH_UINT32_INT_MIN_CAPACITY);
     return h;
 }
 
 void hash_uint32_int_free(HashUInt32Int *h) {
-    hash_uint32_node_free(h->rootNode);
+    if (h == NULL) {
+        return;
+    }
+    free(h->slots);
     free(h);
 }
 
 void hash_uint32_int_set(HashUInt32Int *const h, uint32_t key, const int value) {
-    uint8_t level = 1;
-    HashUInt32IntNode *n = h->rootNode;
-    vx_assert(n != NULL);
-    uint8_t modulo = (uint8_t)(key & HASH_UINT32_BIN_MODULO);
-    HashUInt32IntNode **slots;
-
-    while (true) {
-        slots = (HashUInt32IntNode **)(n->slots);
-        // cclog_debug("LEVEL: %d - modulo: %d", level, modulo);
-        ++level;
-        if (slots[modulo] == NULL) {
-            slots[modulo] = hash_uint32_node_new(n, modulo, level);
-        }
-        n = slots[modulo];
-        key = key >> HASH_UINT32_BIT_SHIFT;
-        modulo = (uint8_t)(key & HASH_UINT32_BIN_MODULO);
-
-        if (level == HASH_TREE_LEVELS_MINUS_ONE) {
-            slots = (HashUInt32IntNode **)(n->slots);
-            int *i = (int *)slots[modulo];
+    vx_assert(h != NULL);
 
-            if (i == NULL) {
-                slots[modulo] = (void *)malloc(sizeof(int *));
-                i = (int *)slots[modulo];
-            }
-
-            *i = value;
+    uint32_t i = _hash_uint32_int_slot(h, key);
+    while (h->slots[i].used) {
+        if (h->slots[i].key == key) {
+            h->slots[i].value = value;
             return;
         }
+        i = (i + 1) & (h->capacity - 1);
     }
-}
-
-bool hash_uint32_int_get(HashUInt32Int *h, uint32_t key, int *outValue) {
-    int level = 1;
-    HashUInt32IntNode *n = h->rootNode;
-    vx_assert(n != NULL);
-    uint8_t modulo = (uint8_t)(key & HASH_UINT32_BIN_MODULO);
-    HashUInt32IntNode **slots;
 
-    while (true) {
-        slots = (HashUInt32IntNode **)(n->slots);
-
-        if (slots[modulo] == NULL) {
-            return false;
-        }
-        n = slots[modulo];
-        ++level;
-        key = key >> HASH_UINT32_BIT_SHIFT;
-        modulo = (uint8_t)(key & HASH_UINT32_BIN_MODULO);
+    if ((h->count + 1) * HASH_UINT32_INT_MAX_LOAD_DEN > h->capacity * HASH_UINT32_INT_MAX_LOAD_NUM) {
+        _hash_uint32_int_grow(h);
+        hash_uint32_int_set(h, key, value);
+        return;
+    }
 
-        if (level == HASH_TREE_LEVELS_MINUS_ONE) {
+    h->slots[i].key = key;
+    h->slots[i].value = value;
+    h->slots[i].used = true;
+    ++h->count;
+}
 
-            slots = (HashUInt32IntNode **)(n->slots);
-            int *i = (int *)slots[modulo];
+bool hash_uint32_int_get(HashUInt32Int *h, uint32_t key, int *outValue) {
+    vx_assert(h != NULL);
 
-            if (i == NULL) {
-                return false;
+    uint32_t i = _hash_uint32_int_slot(h, key);
+    while (h->slots[i].used) {
+        if (h->slots[i].key == key) {
+            if (outValue != NULL) {
+                *outValue = h->slots[i].value;
             }
-
-            *outValue = *i;
             return true;
         }
+        i = (i + 1) & (h->capacity - 1);
     }
-
-    vx_assert(false); // should never reach this point
     return false;
 }
 
 void hash_uint32_int_delete(HashUInt32Int *h, uint32_t key) {
-    int level = 1;
-    HashUInt32IntNode *n = h->rootNode;
-    HashUInt32IntNode *tmp = NULL;
-    vx_assert(n != NULL);
-    uint8_t modulo = (uint8_t)(key & HASH_UINT32_BIN_MODULO);
-    HashUInt32IntNode **slots;
-
-    while (true) {
-        slots = (HashUInt32IntNode **)(n->slots);
-
-        if (slots[modulo] == NULL) {
-            // not found, nothing to delete
-            return;
-        }
-        n = slots[modulo];
-        ++level;
-        key = key >> HASH_UINT32_BIT_SHIFT;
-        modulo = (uint8_t)(key & HASH_UINT32_BIN_MODULO);
-
-        if (level == HASH_TREE_LEVELS_MINUS_ONE) {
+    vx_assert(h != NULL);
 
-            slots = (HashUInt32IntNode **)(n->slots);
-
-            if (slots[modulo] == NULL) {
-                // not found, nothing to delete
-                return;
-            }
+    const uint32_t mask = h->capacity - 1;
+    uint32_t i = _hash_uint32_int_slot(h, key);
+    while (h->slots[i].used && h->slots[i].key != key) {
+        i = (i + 1) & mask;
+    }
+    if (h->slots[i].used == false) {
+        return; // not found, nothing to delete
+    }
 
-            free(slots[modulo]); // free int* (value)
-            slots[modulo] = NULL;
+    // move back following entries that can't be reached anymore once slot i is empty
+    uint32_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (h->slots[j].used == false) {
             break;
         }
-    }
-
-    // cleanup empty parents (except root node)
-    while (n != NULL && n->level > 1) {
-        for (int i = 0; i < HASH_UINT32_CHILDREN_PER_NODE; ++i) {
-            if (n->slots[i] != NULL) {
-                return; // at least one slot not empty, stop
-            }
+        const uint32_t home = _hash_uint32_int_slot(h, h->slots[j].key);
+        // entry j can move to i if its home slot isn't in the (i, j] cyclic range
+        const bool between = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (between == false) {
+            h->slots[i] = h->slots[j];
+            i = j;
         }
-        tmp = n->parent;
-        hash_uint32_node_free(n);
-        n = tmp;
     }
+    h->slots[i].used = false;
+    --h->count;
 }
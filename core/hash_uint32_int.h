@@ -4,8 +4,8 @@
 //  Created by Adrien Duermael on August 15, 2022.
 // -------------------------------------------------------------
 
-// Allows to register uint32 values and quickly find out if some value is registered.
-// In that kind of hash, the key stored and the value are the same.
+// Maps uint32 keys to int values, e.g. RGBA colors to palette entries.
+// Open addressing hash: lookups & insertions are O(1), without allocation per entry.
 
 #pragma once
 
@@ -8,64 +8,87 @@
 
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "block.h"
+#include "blockChange.h"
 #include "cclog.h"
-#include "int3.h"
-#include "shape.h"
+#include "chunk.h"
+#include "index3d.h"
 #include "transaction.h"
 
-typedef struct _HistoryTransaction HistoryTransaction;
-
-void _history_flush(History *const h);
-
-struct _HistoryTransaction {
-    HistoryTransaction *previousAction; // 8 bytes
-    HistoryTransaction *nextAction;     // 8 bytes
-    Transaction *transaction;           // 8 bytes
+// Block changes are sorted using 64-bit keys:
+// [chunk z, y, x: 3 * 12 bits][block in chunk: 12 bits][before: 8 bits][after: 8 bits]
+#define CHUNK_COORDS_BITS (16 - CHUNK_SIZE_SQRT)
+#define CHUNK_COORDS_MASK ((1 << CHUNK_COORDS_BITS) - 1)
+#define CHUNK_COORDS_OFFSET (1 << (CHUNK_COORDS_BITS - 1))
+#define KEY_SORTED_BITS 48
+// one radix sort pass per block in chunk, chunk x, y & z
+#define KEY_RADIX_BITS 12
+#define KEY_RADIX_SIZE (1 << KEY_RADIX_BITS)
+#define KEY_RADIX_MASK (KEY_RADIX_SIZE - 1)
+#define KEY_RADIX_PASSES (KEY_SORTED_BITS / KEY_RADIX_BITS)
+#define KEY_CHUNK(k) ((k) >> (16 + 3 * CHUNK_SIZE_SQRT))
+#define KEY_POSITION(k) ((k) >> 16)
+#define KEY_COLORS(k) ((k) & 0xFFFF)
+
+struct _HistoryRecord {
+    HistoryRecord *previousAction; // 8 bytes
+    HistoryRecord *nextAction;     // 8 bytes
+    // chunks & spans are allocated right after the record
+    HistoryChunk *chunks; // 8 bytes
+    HistorySpan *spans;   // 8 bytes
+    size_t size;          // 8 bytes
+    uint32_t nbChunks;    // 4 bytes
+    uint32_t nbSpans;     // 4 bytes
 };
 
-HistoryTransaction *history_transaction_new(Transaction *const tr) {
-    HistoryTransaction *ht = (HistoryTransaction *)malloc(sizeof(HistoryTransaction));
-    ht->previousAction = NULL;
-    ht->nextAction = NULL;
-    ht->transaction = tr;
-    return ht;
-}
-
-void history_transaction_free(HistoryTransaction *const ht) {
-    if (ht != NULL) {
-        transaction_free(ht->transaction);
-        free(ht);
-    }
-}
+struct _HistoryChanges {
+    uint64_t *keys;    // 8 bytes
+    uint32_t count;    // 4 bytes
+    uint32_t capacity; // 4 bytes
+};
 
 struct _History {
     // history
-    HistoryTransaction *latest; // 8 bytes
-    HistoryTransaction *oldest; // 8 bytes
-    HistoryTransaction *cursor; // 8 bytes
+    HistoryRecord *latest; // 8 bytes
+    HistoryRecord *oldest; // 8 bytes
+    HistoryRecord *cursor; // 8 bytes
 
-    uint16_t limit;     // 2 bytes
-    uint16_t nbActions; // 2 bytes
-
-    char pad[4]; // 4 bytes
+    size_t memoryLimit; // 8 bytes
+    size_t memoryUsage; // 8 bytes
 };
 
+// private prototypes
+
+static void _history_flush(History *const h);
+static void _history_discard_oldest(History *const h);
+static void _history_push_record(History *const h, HistoryRecord *const r);
+static HistoryRecord *_history_record_new_from_transaction(Transaction *const tr);
+static HistoryRecord *_history_record_new(uint64_t *keys, uint64_t *tmp, uint32_t nbKeys);
+static uint64_t _history_key(const SHAPE_COORDS_INT3_T coords,
+                             const SHAPE_COLOR_INDEX_INT_T before,
+                             const SHAPE_COLOR_INDEX_INT_T after);
+static bool _history_sort_keys(uint64_t *keys, uint64_t *tmp, const uint32_t count);
+static uint32_t _history_merge_keys(uint64_t *keys, const uint32_t count);
+static bool _history_key_starts_chunk(const uint64_t *keys, const uint32_t i);
+static bool _history_key_starts_span(const uint64_t *keys, const uint32_t i);
+
 History *history_new(void) {
     History *h = (History *)malloc(sizeof(History));
-    // h->pendingTransaction = NULL;
+    if (h == NULL) {
+        return NULL;
+    }
     h->latest = NULL;
     h->oldest = NULL;
     h->cursor = NULL;
-    h->limit = NB_UNDOABLE_ACTIONS;
-    h->nbActions = 0;
+    h->memoryLimit = HISTORY_DEFAULT_MEMORY_LIMIT;
+    h->memoryUsage = 0;
     return h;
 }
 
 void history_free(History *const h) {
     if (h != NULL) {
-        // transaction_free(h->pendingTransaction);
         _history_flush(h);
         free(h);
     }
@@ -79,84 +102,160 @@ void history_pushTransaction(History *const h, Transaction *const tr) {
         return;
     }
 
-    HistoryTransaction *const htr = history_transaction_new(tr);
+    HistoryRecord *const r = _history_record_new_from_transaction(tr);
+    transaction_free(tr);
+    if (r == NULL) {
+        cclog_error("HISTORY: failed to allocate record");
+        return;
+    }
+    _history_push_record(h, r);
+}
 
-    if (h->oldest == NULL) {
-        // history doesn't contain anything yet, we are setting the first transaction in it.
-        // cursor and latest should be NULL
-        if (h->cursor != NULL || h->latest != NULL) {
-            cclog_error("HISTORY",
-                        "cursor (%p) and latest (%p) should be NULL",
-                        (void *)h->cursor,
-                        (void *)h->latest);
-            history_transaction_free(htr);
-            return;
-        }
-        h->oldest = htr;
-        h->cursor = htr;
-        h->latest = htr;
-        h->nbActions = 1;
+HistoryChanges *history_changes_new(void) {
+    HistoryChanges *c = (HistoryChanges *)malloc(sizeof(HistoryChanges));
+    if (c == NULL) {
+        return NULL;
+    }
+    c->keys = NULL;
+    c->count = 0;
+    c->capacity = 0;
+    return c;
+}
 
-    } else {
-        // there is at least one transaction in history
-        // cursor and latest should NOT be NULL
-        if (h->latest == NULL || h->cursor == NULL) {
-            cclog_error("HISTORY",
-                        "latest (%p) and cursor (%p) should NOT be NULL",
-                        (void *)h->latest,
-                        (void *)h->cursor);
-            history_transaction_free(htr);
+void history_changes_free(HistoryChanges *const c) {
+    if (c != NULL) {
+        free(c->keys);
+        free(c);
+    }
+}
+
+bool history_changes_reserve(HistoryChanges *const c, const uint32_t count) {
+    if (count <= c->capacity - c->count) {
+        return true;
+    }
+    const uint32_t needed = c->count + count;
+    const uint32_t capacity = c->capacity * 2 > needed ? c->capacity * 2 : needed;
+    uint64_t *keys = (uint64_t *)realloc(c->keys, sizeof(uint64_t) * capacity);
+    if (keys == NULL) {
+        return false;
+    }
+    c->keys = keys;
+    c->capacity = capacity;
+    return true;
+}
+
+void history_changes_add(HistoryChanges *const c,
+                         const SHAPE_COORDS_INT3_T coords,
+                         const SHAPE_COLOR_INDEX_INT_T before,
+                         const SHAPE_COLOR_INDEX_INT_T after) {
+    if (before == after) {
+        return;
+    }
+    if (c->count == c->capacity) {
+        const uint32_t capacity = c->capacity > 0 ? c->capacity * 2 : 256;
+        uint64_t *keys = (uint64_t *)realloc(c->keys, sizeof(uint64_t) * capacity);
+        if (keys == NULL) {
+            cclog_error("HISTORY: failed to grow changes");
             return;
         }
+        c->keys = keys;
+        c->capacity = capacity;
+    }
+    c->keys[c->count++] = _history_key(coords, before, after);
+}
 
-        // If a transaction is pushed after one or several "undo" operations,
-        // we forget about the previous timeline as a new one is created.
-        // (deletes all actions after h->cursor)
-        history_discardTransactionsMoreRecentThanCursor(h);
+uint32_t history_changes_get_count(const HistoryChanges *const c) {
+    return c->count;
+}
 
-        // update cross-references between current latest and new latest
-        htr->previousAction = h->latest;
-        h->latest->nextAction = htr;
-        // set new latest
-        h->latest = htr;
-        h->cursor = h->latest;
-        h->nbActions++;
+void history_changes_add_record(HistoryChanges *const c, const HistoryRecord *const r) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < r->nbSpans; ++i) {
+        count += r->spans[i].length;
+    }
+    if (history_changes_reserve(c, count) == false) {
+        cclog_error("HISTORY: failed to grow changes");
+        return;
     }
 
-    // if there's no space to add an action, we remove the oldest ones
-    while (h->nbActions > h->limit) {
-        if (h->oldest != NULL) {
-            // there is at least one action in history
-            HistoryTransaction *toDelete = h->oldest;
-
-            if (h->oldest->nextAction == NULL) {
-                // there is only one action in history, empty the history
-                h->oldest = NULL;
-                h->cursor = NULL;
-                h->latest = NULL;
-            } else {
-                // there are more than one action in history
-                // set new oldest action
-                h->oldest = h->oldest->nextAction;
-                // new oldest cannot have a previous
-                h->oldest->previousAction = NULL;
-            }
-
-            history_transaction_free(toDelete);
-            h->nbActions--;
-        } else {
-            // do nothing if there is no oldest action (cursor and latest should be NULL)
-            if (h->cursor != NULL || h->latest != NULL) {
-                cclog_error("HISTORY",
-                            "cursor (%p) and latest (%p) should be NULL [2]",
-                            (void *)h->cursor,
-                            (void *)h->latest);
-                return;
+    const HistoryChunk *chunk = r->chunks;
+    const HistorySpan *span = r->spans;
+    for (uint32_t i = 0; i < r->nbChunks; ++i, ++chunk) {
+        for (uint16_t j = 0; j < chunk->nbSpans; ++j, ++span) {
+            for (uint8_t k = 0; k < span->length; ++k) {
+                const SHAPE_COORDS_INT3_T coords = {
+                    (SHAPE_COORDS_INT_T)(chunk->coords.x * CHUNK_SIZE + span->x + k),
+                    (SHAPE_COORDS_INT_T)(chunk->coords.y * CHUNK_SIZE + span->y),
+                    (SHAPE_COORDS_INT_T)(chunk->coords.z * CHUNK_SIZE + span->z)};
+                c->keys[c->count++] = _history_key(coords, span->before, span->after);
             }
         }
     }
 }
 
+HistoryRecord *history_record_new(HistoryChanges *const c) {
+    vx_assert(c != NULL);
+
+    if (c == NULL) {
+        return NULL;
+    }
+
+    HistoryRecord *r = NULL;
+    uint64_t *tmp = c->count > 1 ? (uint64_t *)malloc(sizeof(uint64_t) * c->count) : NULL;
+    if (c->count <= 1 || tmp != NULL) {
+        r = _history_record_new(c->keys, tmp, c->count);
+    }
+    free(tmp);
+    history_changes_free(c);
+    return r;
+}
+
+void history_record_free(HistoryRecord *const r) {
+    free(r);
+}
+
+void history_pushRecord(History *const h, HistoryRecord *const r) {
+    vx_assert(h != NULL);
+    vx_assert(r != NULL);
+
+    if (h == NULL || r == NULL) {
+        return;
+    }
+
+    _history_push_record(h, r);
+}
+
+void history_pushChanges(History *const h, HistoryChanges *const c) {
+    vx_assert(h != NULL);
+    vx_assert(c != NULL);
+
+    if (h == NULL || c == NULL) {
+        return;
+    }
+
+    HistoryRecord *const r = history_record_new(c);
+    if (r == NULL) {
+        cclog_error("HISTORY: failed to allocate record");
+        return;
+    }
+    _history_push_record(h, r);
+}
+
+void history_set_memory_limit(History *const h, const size_t bytes) {
+    h->memoryLimit = bytes;
+    while (h->memoryUsage > h->memoryLimit && h->oldest != h->latest) {
+        _history_discard_oldest(h);
+    }
+}
+
+size_t history_get_memory_limit(const History *const h) {
+    return h->memoryLimit;
+}
+
+size_t history_get_memory_usage(const History *const h) {
+    return h->memoryUsage;
+}
+
 bool history_can_undo(const History *const h) {
     if (h == NULL) {
         cclog_error("HISTORY", "history_can_undo: history reference is NULL");
@@ -165,7 +264,7 @@ bool history_can_undo(const History *const h) {
     return h->cursor != NULL;
 }
 
-Transaction *history_getTransactionToUndo(History *const h) {
+const HistoryRecord *history_get_record_to_undo(History *const h) {
     if (h == NULL) {
         cclog_error("HISTORY", "%s error: history reference is NULL", __func__);
         return NULL;
@@ -175,13 +274,13 @@ Transaction *history_getTransactionToUndo(History *const h) {
         return NULL;
     }
 
-    // transaction to undo
-    Transaction *tr = h->cursor->transaction;
+    // record to undo
+    const HistoryRecord *r = h->cursor;
 
     // update h->cursor with h->cursor->previous value
     h->cursor = h->cursor->previousAction;
 
-    return tr;
+    return r;
 }
 
 bool history_can_redo(const History *const h) {
@@ -189,45 +288,39 @@ bool history_can_redo(const History *const h) {
            (h->cursor != NULL && h->cursor->nextAction != NULL);
 }
 
-Transaction *history_getTransactionToRedo(History *const h) {
+const HistoryRecord *history_get_record_to_redo(History *const h) {
     if (h == NULL) {
         cclog_error("HISTORY", "%s error: history reference is NULL", __func__);
         return NULL;
     }
 
-    Transaction *tr = NULL;
+    const HistoryRecord *r = NULL;
 
     if (h->cursor == NULL) {
-        // the transaction to redo is "oldest"
+        // the record to redo is "oldest"
         if (h->oldest != NULL) {
-            tr = h->oldest->transaction;
+            r = h->oldest;
             h->cursor = h->oldest;
         }
     } else if (h->cursor->nextAction != NULL) {
-        tr = h->cursor->nextAction->transaction;
+        r = h->cursor->nextAction;
         // update h->cursor with h->cursor->next value
         h->cursor = h->cursor->nextAction;
     }
 
-    return tr;
+    return r;
 }
 
-void _history_flush(History *const h) {
-    if (h == NULL) {
-        return;
-    }
-    // free all actions
-    HistoryTransaction *oldest = h->oldest;
-    while (oldest != NULL) {
-        HistoryTransaction *toDelete = oldest;
-        oldest = oldest->nextAction;
-        history_transaction_free(toDelete);
-        h->nbActions--;
-    }
-    h->oldest = NULL;
-    h->cursor = NULL;
-    h->latest = NULL;
-    h->nbActions = 0;
+uint32_t history_record_get_nb_chunks(const HistoryRecord *const r) {
+    return r->nbChunks;
+}
+
+const HistoryChunk *history_record_get_chunks(const HistoryRecord *const r) {
+    return r->chunks;
+}
+
+const HistorySpan *history_record_get_spans(const HistoryRecord *const r) {
+    return r->spans;
 }
 
 void history_discardTransactionsMoreRecentThanCursor(History *const h) {
@@ -238,7 +331,7 @@ void history_discardTransactionsMoreRecentThanCursor(History *const h) {
         return;
     }
 
-    HistoryTransaction *afterCursor = NULL;
+    HistoryRecord *afterCursor = NULL;
     if (h->cursor != NULL) {
         afterCursor = h->cursor->nextAction;
     } else {
@@ -248,10 +341,10 @@ void history_discardTransactionsMoreRecentThanCursor(History *const h) {
 
     // deletes all actions after h->cursor
     while (afterCursor != NULL) {
-        HistoryTransaction *toDelete = afterCursor;
+        HistoryRecord *toDelete = afterCursor;
         afterCursor = afterCursor->nextAction;
-        history_transaction_free(toDelete);
-        h->nbActions--;
+        h->memoryUsage -= toDelete->size;
+        free(toDelete);
     }
 
     if (h->cursor != NULL) {
@@ -259,3 +352,301 @@ void history_discardTransactionsMoreRecentThanCursor(History *const h) {
     }
     h->latest = h->cursor;
 }
+
+// MARK: - private functions -
+
+static void _history_flush(History *const h) {
+    // free all actions
+    HistoryRecord *oldest = h->oldest;
+    while (oldest != NULL) {
+        HistoryRecord *toDelete = oldest;
+        oldest = oldest->nextAction;
+        free(toDelete);
+    }
+    h->oldest = NULL;
+    h->cursor = NULL;
+    h->latest = NULL;
+    h->memoryUsage = 0;
+}
+
+static void _history_discard_oldest(History *const h) {
+    HistoryRecord *toDelete = h->oldest;
+    if (toDelete == NULL) {
+        return;
+    }
+
+    if (toDelete->nextAction == NULL) {
+        // there is only one action in history, empty the history
+        h->oldest = NULL;
+        h->cursor = NULL;
+        h->latest = NULL;
+    } else {
+        // set new oldest action, it cannot have a previous
+        h->oldest = toDelete->nextAction;
+        h->oldest->previousAction = NULL;
+        if (h->cursor == toDelete) {
+            h->cursor = NULL;
+        }
+    }
+
+    h->memoryUsage -= toDelete->size;
+    free(toDelete);
+}
+
+static void _history_push_record(History *const h, HistoryRecord *const r) {
+    // If a record is pushed after one or several "undo" operations,
+    // we forget about the previous timeline as a new one is created.
+    // (deletes all actions after h->cursor)
+    history_discardTransactionsMoreRecentThanCursor(h);
+
+    if (h->oldest == NULL) {
+        // history doesn't contain anything yet, we are setting the first record in it.
+        // cursor and latest should be NULL
+        if (h->cursor != NULL || h->latest != NULL) {
+            cclog_error("HISTORY",
+                        "cursor (%p) and latest (%p) should be NULL",
+                        (void *)h->cursor,
+                        (void *)h->latest);
+            free(r);
+            return;
+        }
+        h->oldest = r;
+        h->cursor = r;
+        h->latest = r;
+
+    } else {
+        // there is at least one record in history
+        // cursor and latest should NOT be NULL
+        if (h->latest == NULL || h->cursor == NULL) {
+            cclog_error("HISTORY",
+                        "latest (%p) and cursor (%p) should NOT be NULL",
+                        (void *)h->latest,
+                        (void *)h->cursor);
+            free(r);
+            return;
+        }
+
+        // update cross-references between current latest and new latest
+        r->previousAction = h->latest;
+        h->latest->nextAction = r;
+        // set new latest
+        h->latest = r;
+        h->cursor = h->latest;
+    }
+    h->memoryUsage += r->size;
+
+    // if exceeding memory limit, we remove the oldest actions
+    while (h->memoryUsage > h->memoryLimit && h->oldest != h->latest) {
+        _history_discard_oldest(h);
+    }
+}
+
+static HistoryRecord *_history_record_new_from_transaction(Transaction *const tr) {
+    // gather block changes as sortable keys, skipping those that did not change anything
+    const uint32_t count = transaction_getNbBlockChanges(tr);
+    uint64_t *keys = count > 0 ? (uint64_t *)malloc(sizeof(uint64_t) * count * 2) : NULL;
+    if (count > 0 && keys == NULL) {
+        return NULL;
+    }
+
+    uint32_t nbKeys = 0;
+    transaction_resetIndex3DIterator(tr);
+    Index3DIterator *it = transaction_getIndex3DIterator(tr);
+    const BlockChange *bc;
+    while ((bc = (const BlockChange *)index3d_iterator_pointer(it)) != NULL) {
+        SHAPE_COORDS_INT3_T coords;
+        blockChange_getXYZ(bc, &coords.x, &coords.y, &coords.z);
+        const SHAPE_COLOR_INDEX_INT_T before = blockChange_get_previous_color(bc);
+        const SHAPE_COLOR_INDEX_INT_T after = blockChange_getBlock(bc)->colorIndex;
+
+        if (before != after && nbKeys < count) {
+            keys[nbKeys++] = _history_key(coords, before, after);
+        }
+        index3d_iterator_next(it);
+    }
+    transaction_resetIndex3DIterator(tr);
+
+    HistoryRecord *r = _history_record_new(keys, keys != NULL ? keys + count : NULL, nbKeys);
+    free(keys);
+
+    return r;
+}
+
+/// Builds a record from unsorted keys, `tmp` has to be able to store `nbKeys` keys
+static HistoryRecord *_history_record_new(uint64_t *keys, uint64_t *tmp, uint32_t nbKeys) {
+    if (nbKeys > 1) {
+        if (_history_sort_keys(keys, tmp, nbKeys) == false) {
+            return NULL;
+        }
+        nbKeys = _history_merge_keys(keys, nbKeys);
+    }
+
+    // count chunks & spans to allocate the record at once
+    uint32_t nbChunks = 0, nbSpans = 0;
+    for (uint32_t i = 0; i < nbKeys; ++i) {
+        nbChunks += _history_key_starts_chunk(keys, i) ? 1 : 0;
+        nbSpans += _history_key_starts_span(keys, i) ? 1 : 0;
+    }
+
+    const size_t size = sizeof(HistoryRecord) + sizeof(HistoryChunk) * nbChunks +
+                        sizeof(HistorySpan) * nbSpans;
+    HistoryRecord *r = (HistoryRecord *)malloc(size);
+    if (r == NULL) {
+        return NULL;
+    }
+    r->previousAction = NULL;
+    r->nextAction = NULL;
+    r->chunks = (HistoryChunk *)(r + 1);
+    r->spans = (HistorySpan *)(r->chunks + nbChunks);
+    r->size = size;
+    r->nbChunks = nbChunks;
+    r->nbSpans = nbSpans;
+
+    HistoryChunk *chunk = r->chunks - 1;
+    HistorySpan *span = r->spans - 1;
+    for (uint32_t i = 0; i < nbKeys; ++i) {
+        const uint64_t k = keys[i];
+        const uint32_t block = (uint32_t)KEY_POSITION(k) & (CHUNK_SIZE_CUBE - 1);
+
+        if (_history_key_starts_chunk(keys, i)) {
+            const uint64_t c = KEY_CHUNK(k);
+            ++chunk;
+            chunk->coords = (SHAPE_COORDS_INT3_T){
+                (SHAPE_COORDS_INT_T)((int)(c & CHUNK_COORDS_MASK) - CHUNK_COORDS_OFFSET),
+                (SHAPE_COORDS_INT_T)((int)((c >> CHUNK_COORDS_BITS) & CHUNK_COORDS_MASK) -
+                                     CHUNK_COORDS_OFFSET),
+                (SHAPE_COORDS_INT_T)((int)((c >> (2 * CHUNK_COORDS_BITS)) & CHUNK_COORDS_MASK) -
+                                     CHUNK_COORDS_OFFSET)};
+            chunk->nbSpans = 0;
+        }
+        if (_history_key_starts_span(keys, i)) {
+            ++span;
+            span->x = (CHUNK_COORDS_INT_T)(block & CHUNK_SIZE_MINUS_ONE);
+            span->y = (CHUNK_COORDS_INT_T)((block / CHUNK_SIZE) & CHUNK_SIZE_MINUS_ONE);
+            span->z = (CHUNK_COORDS_INT_T)(block / CHUNK_SIZE_SQR);
+            span->before = (SHAPE_COLOR_INDEX_INT_T)(k >> 8);
+            span->after = (SHAPE_COLOR_INDEX_INT_T)k;
+            span->length = 1;
+            ++chunk->nbSpans;
+        } else {
+            ++span->length;
+        }
+    }
+
+    return r;
+}
+
+static uint64_t _history_key(const SHAPE_COORDS_INT3_T coords,
+                             const SHAPE_COLOR_INDEX_INT_T before,
+                             const SHAPE_COLOR_INDEX_INT_T after) {
+    // same as chunk_utils_get_coords & chunk_utils_get_coords_in_chunk, inlined as this is
+    // called for each block change
+    const uint64_t chunk =
+        (uint64_t)(((coords.z >> CHUNK_SIZE_SQRT) + CHUNK_COORDS_OFFSET) & CHUNK_COORDS_MASK)
+            << (2 * CHUNK_COORDS_BITS) |
+        (uint64_t)(((coords.y >> CHUNK_SIZE_SQRT) + CHUNK_COORDS_OFFSET) & CHUNK_COORDS_MASK)
+            << CHUNK_COORDS_BITS |
+        (uint64_t)(((coords.x >> CHUNK_SIZE_SQRT) + CHUNK_COORDS_OFFSET) & CHUNK_COORDS_MASK);
+    const uint64_t block = (uint64_t)((coords.x & CHUNK_SIZE_MINUS_ONE) +
+                                      (coords.y & CHUNK_SIZE_MINUS_ONE) * CHUNK_SIZE +
+                                      (coords.z & CHUNK_SIZE_MINUS_ONE) * CHUNK_SIZE_SQR);
+    return (chunk << (3 * CHUNK_SIZE_SQRT) | block) << 16 | (uint64_t)before << 8 |
+           (uint64_t)after;
+}
+
+/// Sorts keys on their upper KEY_SORTED_BITS bits (LSD radix sort, KEY_RADIX_BITS per pass),
+/// `tmp` has to be able to store `count` keys. Sort is stable.
+static bool _history_sort_keys(uint64_t *keys, uint64_t *tmp, const uint32_t count) {
+    if (count < 2) {
+        return true;
+    }
+
+    // region operations produce keys already in order
+    const uint32_t unsortedBits = 64 - KEY_SORTED_BITS;
+    uint32_t i = 1;
+    while (i < count && keys[i - 1] >> unsortedBits <= keys[i] >> unsortedBits) {
+        ++i;
+    }
+    if (i == count) {
+        return true;
+    }
+
+    // histograms of all passes are built at once
+    uint32_t *offsets = (uint32_t *)calloc(KEY_RADIX_PASSES * KEY_RADIX_SIZE, sizeof(uint32_t));
+    if (offsets == NULL) {
+        return false;
+    }
+    for (i = 0; i < count; ++i) {
+        const uint64_t k = keys[i] >> unsortedBits;
+        for (uint32_t pass = 0; pass < KEY_RADIX_PASSES; ++pass) {
+            ++offsets[pass * KEY_RADIX_SIZE + ((k >> (pass * KEY_RADIX_BITS)) & KEY_RADIX_MASK)];
+        }
+    }
+
+    uint64_t *src = keys, *dst = tmp;
+    for (uint32_t pass = 0; pass < KEY_RADIX_PASSES; ++pass) {
+        const uint32_t shift = unsortedBits + pass * KEY_RADIX_BITS;
+        uint32_t *o = offsets + pass * KEY_RADIX_SIZE;
+
+        // skip pass if all keys share the same digit, common for chunk coordinates
+        if (o[(src[0] >> shift) & KEY_RADIX_MASK] == count) {
+            continue;
+        }
+        uint32_t sum = 0;
+        for (uint32_t b = 0; b < KEY_RADIX_SIZE; ++b) {
+            const uint32_t n = o[b];
+            o[b] = sum;
+            sum += n;
+        }
+        for (i = 0; i < count; ++i) {
+            dst[o[(src[i] >> shift) & KEY_RADIX_MASK]++] = src[i];
+        }
+        uint64_t *const swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != keys) {
+        memcpy(keys, src, sizeof(uint64_t) * count);
+    }
+
+    free(offsets);
+    return true;
+}
+
+/// Merges sorted keys at same position into one change, from first `before` to last `after`
+/// color (sort being stable, they remain in the order they were added).
+/// Changes ending up with the color they started with are removed. Returns new count.
+static uint32_t _history_merge_keys(uint64_t *keys, const uint32_t count) {
+    uint32_t n = 0;
+    bool merged = false;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (n > 0 && KEY_POSITION(keys[i]) == KEY_POSITION(keys[n - 1])) {
+            keys[n - 1] = (keys[n - 1] & ~(uint64_t)0xFF) | (keys[i] & 0xFF);
+            merged = true;
+        } else {
+            keys[n++] = keys[i];
+        }
+    }
+    if (merged == false) {
+        return n;
+    }
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        if ((SHAPE_COLOR_INDEX_INT_T)(keys[i] >> 8) != (SHAPE_COLOR_INDEX_INT_T)keys[i]) {
+            keys[kept++] = keys[i];
+        }
+    }
+    return kept;
+}
+
+static bool _history_key_starts_chunk(const uint64_t *keys, const uint32_t i) {
+    return i == 0 || KEY_CHUNK(keys[i]) != KEY_CHUNK(keys[i - 1]);
+}
+
+/// Spans are made of consecutive blocks in a chunk row, with same colors
+static bool _history_key_starts_span(const uint64_t *keys, const uint32_t i) {
+    return _history_key_starts_chunk(keys, i) ||
+           KEY_POSITION(keys[i]) != KEY_POSITION(keys[i - 1]) + 1 ||
+           (KEY_POSITION(keys[i]) & CHUNK_SIZE_MINUS_ONE) == 0 ||
+           KEY_COLORS(keys[i]) != KEY_COLORS(keys[i - 1]);
+}
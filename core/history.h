@@ -11,13 +11,36 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
 
 // An history is used to keep the last actions received by a World
 // It can be used to undo/redo operations.
+// Each action is stored as a compact record of block changes, sorted per chunk, with
+// consecutive blocks along x sharing same colors merged into spans. Oldest actions are
+// discarded once records exceed the history memory limit.
 typedef struct _History History;
+typedef struct _HistoryRecord HistoryRecord;
+typedef struct _HistoryChanges HistoryChanges;
 typedef struct _Shape Shape;
 typedef struct _Transaction Transaction;
 
+/// Blocks along +x within a chunk, changed from `before` to `after` color
+typedef struct {
+    CHUNK_COORDS_INT_T x, y, z; // first block, chunk coordinates
+    SHAPE_COLOR_INDEX_INT_T before;
+    SHAPE_COLOR_INDEX_INT_T after;
+    uint8_t length;
+} HistorySpan;
+
+/// Chunk changed by a record, its spans follow those of the previous chunk
+typedef struct {
+    SHAPE_COORDS_INT3_T coords; // chunk coordinates, see chunk_utils_get_coords
+    uint16_t nbSpans;
+} HistoryChunk;
+
 ///
 History *history_new(void);
 
@@ -27,16 +50,54 @@ void history_free(History *const h);
 ///
 void history_discardTransactionsMoreRecentThanCursor(History *const h);
 
-///
+/// Stores an applied transaction as a new record, the transaction is freed.
+/// Block changes have to know their previous color (see blockChange_set_previous_color).
 void history_pushTransaction(History *const h, Transaction *const tr);
 
+/// Block changes applied on a shape (see shape_fill_box, shape_apply_current_transaction),
+/// stored at once as a single record. A block added several times is recorded as one change,
+/// from its first `before` to its last `after` color.
+HistoryChanges *history_changes_new(void);
+void history_changes_free(HistoryChanges *const c);
+/// Makes room for `count` more changes, returns false if allocation fails
+bool history_changes_reserve(HistoryChanges *const c, const uint32_t count);
+void history_changes_add(HistoryChanges *const c,
+                         const SHAPE_COORDS_INT3_T coords,
+                         const SHAPE_COLOR_INDEX_INT_T before,
+                         const SHAPE_COLOR_INDEX_INT_T after);
+uint32_t history_changes_get_count(const HistoryChanges *const c);
+/// Adds all changes of a record
+void history_changes_add_record(HistoryChanges *const c, const HistoryRecord *const r);
+
+/// Stores changes as a new record, changes are freed.
+void history_pushChanges(History *const h, HistoryChanges *const c);
+
+/// Builds a record out of changes, changes are freed. Returns NULL if allocation fails.
+/// A record can be applied before being pushed (see shape_apply_current_transaction).
+HistoryRecord *history_record_new(HistoryChanges *const c);
+void history_record_free(HistoryRecord *const r);
+
+/// Stores a record built with history_record_new, the history becomes its owner.
+void history_pushRecord(History *const h, HistoryRecord *const r);
+
+/// Oldest records are discarded while exceeding the limit, latest record is always kept.
+/// Default is HISTORY_DEFAULT_MEMORY_LIMIT.
+void history_set_memory_limit(History *const h, const size_t bytes);
+size_t history_get_memory_limit(const History *const h);
+size_t history_get_memory_usage(const History *const h);
+
 ///
 bool history_can_undo(const History *const h);
-Transaction *history_getTransactionToUndo(History *const h);
+const HistoryRecord *history_get_record_to_undo(History *const h);
 
 ///
 bool history_can_redo(const History *const h);
-Transaction *history_getTransactionToRedo(History *const h);
+const HistoryRecord *history_get_record_to_redo(History *const h);
+
+///
+uint32_t history_record_get_nb_chunks(const HistoryRecord *const r);
+const HistoryChunk *history_record_get_chunks(const HistoryRecord *const r);
+const HistorySpan *history_record_get_spans(const HistoryRecord *const r);
 
 #ifdef __cplusplus
 } // extern "C"
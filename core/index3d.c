@@ -8,207 +8,162 @@
 
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "cclog.h"
 
-// has to be a power of two
-// #define INDEX_NODE_SIZE 64
-#define INDEX_NODE_BITWISE_MODULO 63 // INDEX_NODE_SIZE - 1
-// the extra slot is used to go from x > y and y > z or store the actual pointer
-#define INDEX_NODE_ARRAY_SIZE 65           // INDEX_NODE_SIZE + 1
-#define INDEX_NODE_ARRAY_SIZE_MINUS_ONE 64 // INDEX_NODE_ARRAY_SIZE_MINUS_ONE
-#define INDEX_DIVIDE_BYTES 6
+// Open addressing with linear probing, in a power of 2 array of slots (see hash_uint32_int.c).
+// Slots store the hash of the position, to skip most entry comparisons, and the index of the entry
+// in a dense array, that's used for iteration. Removing an entry leaves a hole (NULL pointer) in
+// that array, holes are filled once there are more holes than entries and no iterator is alive.
+// Positions outside of the box of inserted entries are rejected before hashing, lookups of absent
+// neighbors (e.g. chunks around a shape) are then as cheap as they were with the trie.
+
+#define INDEX3D_MIN_CAPACITY 16
+// table grows when more than half of the slots are used, keeping probe chains of misses short
+#define INDEX3D_MAX_LOAD_NUM 1
+#define INDEX3D_MAX_LOAD_DEN 2
+#define INDEX3D_SLOT_EMPTY 0
+
+typedef struct {
+    uint32_t hash;
+    uint32_t entry; // entry index + 1, INDEX3D_SLOT_EMPTY if not used
+} Index3DSlot;
+
+typedef struct {
+    void *ptr; // NULL if removed
+    int32_t x, y, z;
+    char pad[4];
+} Index3DEntry;
 
 struct _Index3D {
-    void **topLevelNode;
-    DoublyLinkedList *list;
+    Index3DSlot *slots;
+    Index3DEntry *entries;
+    uint32_t slotsCapacity; // 0 or a power of 2
+    uint32_t entriesCapacity;
+    uint32_t nbEntries; // including removed ones
+    uint32_t count;
+    uint32_t nbIterators;
+    // box of positions inserted since index was last empty, only valid if count > 0
+    int32_t minX, minY, minZ;
+    int32_t maxX, maxY, maxZ;
+    char pad[4];
 };
 
 struct _Index3DIterator {
-    DoublyLinkedListNode *current;
+    Index3D *index;
+    uint32_t position;
+    // current entry has been removed through the iterator,
+    // next entry is then considered to be the current one
+    bool removed;
+    char pad[3];
 };
 
 //-------------------
 // Index3D
 //-------------------
 
-static void **_new_node(void) {
-    void **arr = (void **)malloc(INDEX_NODE_ARRAY_SIZE * sizeof(void *));
-    for (int i = 0; i < INDEX_NODE_ARRAY_SIZE; ++i) {
-        arr[i] = NULL;
-    }
-    return arr;
+static uint32_t _index3d_hash(const int32_t x, const int32_t y, const int32_t z) {
+    // xor of multiplied coordinates gives equal hashes for many positions around the origin,
+    // x & y are packed as is, only z is multiplied in
+    uint64_t h = ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+    h ^= (uint64_t)(uint32_t)z * 0x9e3779b97f4a7c15ull;
+    // final mix, neighbor positions (e.g. shape chunks) must not end up in neighbor slots
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return (uint32_t)h;
 }
 
-void *index3d_get(const Index3D *index, const int32_t x, const int32_t y, const int32_t z) {
-
-    // only use unsigned integers for bitwise operations:
-    uint32_t ux = (uint32_t)x;
-    uint32_t uy = (uint32_t)y;
-    uint32_t uz = (uint32_t)z;
-
-    void **currentNode = index->topLevelNode;
-
-    uint32_t modulo = ux & INDEX_NODE_BITWISE_MODULO;
-    uint32_t quotient = ux >> INDEX_DIVIDE_BYTES;
-
-    // look for x
-
-    while (1) {
-        // found, go to y
-        if (quotient == 0 && modulo == 0) {
-            currentNode = (void **)currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE];
-            if (currentNode == NULL) {
-                // not found
-                return NULL;
-            }
-            break;
-        }
-
-        currentNode = (void **)currentNode[modulo];
-
-        if (currentNode == NULL) {
-            // not found
-            return NULL;
-        }
+static uint32_t _index3d_home(const Index3D *index, const uint32_t hash) {
+    return hash & (index->slotsCapacity - 1);
+}
 
-        if (quotient == 0) {
-            // making sure we're going to y in next loop
-            modulo = 0;
-        } else {
-            // go deeper
-            modulo = quotient & INDEX_NODE_BITWISE_MODULO;
-            quotient = quotient >> INDEX_DIVIDE_BYTES;
-        }
+/// Returns slot index of given position, or slotsCapacity if not found
+static uint32_t _index3d_find(const Index3D *index,
+                              const int32_t x,
+                              const int32_t y,
+                              const int32_t z,
+                              const uint32_t hash) {
+    if (index->count == 0 || x < index->minX || x > index->maxX || y < index->minY ||
+        y > index->maxY || z < index->minZ || z > index->maxZ) {
+        return index->slotsCapacity;
     }
-
-    // look for y
-
-    modulo = uy & INDEX_NODE_BITWISE_MODULO;
-    quotient = uy >> INDEX_DIVIDE_BYTES;
-
-    while (1) {
-        // found, go to z
-        if (quotient == 0 && modulo == 0) {
-            currentNode = (void **)currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE];
-            if (currentNode == NULL) {
-                // not found
-                return NULL;
+    const uint32_t mask = index->slotsCapacity - 1;
+    uint32_t i = _index3d_home(index, hash);
+    while (index->slots[i].entry != INDEX3D_SLOT_EMPTY) {
+        if (index->slots[i].hash == hash) {
+            const Index3DEntry *e = &index->entries[index->slots[i].entry - 1];
+            if (e->x == x && e->y == y && e->z == z) {
+                return i;
             }
-            break;
-        }
-
-        currentNode = (void **)currentNode[modulo];
-
-        if (currentNode == NULL) {
-            // not found
-            return NULL;
-        }
-
-        if (quotient == 0) {
-            // making sure we're going to z in next loop
-            modulo = 0;
-        } else {
-            // go deeper
-            modulo = quotient & INDEX_NODE_BITWISE_MODULO;
-            quotient = quotient >> INDEX_DIVIDE_BYTES;
         }
+        i = (i + 1) & mask;
     }
-
-    // look for z
-
-    modulo = uz & INDEX_NODE_BITWISE_MODULO;
-    quotient = uz >> INDEX_DIVIDE_BYTES;
-
-    while (1) {
-        // found!!!!
-        if (quotient == 0 && modulo == 0) {
-            return doubly_linked_list_node_pointer(
-                (const DoublyLinkedListNode *)currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE]);
-        }
-
-        currentNode = (void **)currentNode[modulo];
-
-        if (currentNode == NULL) {
-            // not found
-            return NULL;
-        }
-
-        if (quotient == 0) {
-            // making sure we're going to z in next loop
-            modulo = 0;
-        } else {
-            // go deeper
-            modulo = quotient & INDEX_NODE_BITWISE_MODULO;
-            quotient = quotient >> INDEX_DIVIDE_BYTES;
-        }
-    }
-
-    return NULL;
+    return index->slotsCapacity;
 }
 
-void index3d_batch_get_reset(const Index3D *index, void ***batchedNode) {
-    *batchedNode = index->topLevelNode;
+static void _index3d_place(Index3D *index, const uint32_t hash, const uint32_t entry) {
+    const uint32_t mask = index->slotsCapacity - 1;
+    uint32_t i = _index3d_home(index, hash);
+    while (index->slots[i].entry != INDEX3D_SLOT_EMPTY) {
+        i = (i + 1) & mask;
+    }
+    index->slots[i].hash = hash;
+    index->slots[i].entry = entry + 1;
 }
 
-bool index3d_batch_get_advance(const int32_t value, void ***batchedNode) {
-    uint32_t modulo = (uint32_t)value & INDEX_NODE_BITWISE_MODULO;
-    uint32_t quotient = (uint32_t)value >> INDEX_DIVIDE_BYTES;
+static void _index3d_rehash(Index3D *index, const uint32_t capacity) {
+    free(index->slots);
+    index->slots = (Index3DSlot *)calloc(capacity, sizeof(Index3DSlot));
+    index->slotsCapacity = capacity;
 
-    while (1) {
-        if (quotient == 0 && modulo == 0) {
-            *batchedNode = (void **)(*batchedNode)[INDEX_NODE_ARRAY_SIZE_MINUS_ONE];
-            if (*batchedNode == NULL) {
-                return false; // not found
-            }
-            break;
-        }
-
-        *batchedNode = (void **)(*batchedNode)[modulo];
-
-        if (*batchedNode == NULL) {
-            return false; // not found
-        }
-
-        if (quotient == 0) {
-            // making sure we're going to stop next loop
-            modulo = 0;
-        } else {
-            // go deeper
-            modulo = quotient & INDEX_NODE_BITWISE_MODULO;
-            quotient = quotient >> INDEX_DIVIDE_BYTES;
+    for (uint32_t i = 0; i < index->nbEntries; ++i) {
+        const Index3DEntry *e = &index->entries[i];
+        if (e->ptr != NULL) {
+            _index3d_place(index, _index3d_hash(e->x, e->y, e->z), i);
         }
     }
-
-    return true;
 }
 
-void *index3d_batch_get(const int32_t z, void **batchedNode) {
-    uint32_t modulo = (uint32_t)z & INDEX_NODE_BITWISE_MODULO;
-    uint32_t quotient = (uint32_t)z >> INDEX_DIVIDE_BYTES;
+/// Fills holes left by removed entries, only when it can't invalidate iterators
+static void _index3d_compact_if_needed(Index3D *index) {
+    const uint32_t nbRemoved = index->nbEntries - index->count;
+    if (index->nbIterators > 0 || nbRemoved <= index->count || nbRemoved < INDEX3D_MIN_CAPACITY) {
+        return;
+    }
 
-    while (1) {
-        // found!!!!
-        if (quotient == 0 && modulo == 0) {
-            return doubly_linked_list_node_pointer(
-                (const DoublyLinkedListNode *)batchedNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE]);
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < index->nbEntries; ++i) {
+        if (index->entries[i].ptr != NULL) {
+            index->entries[n++] = index->entries[i];
         }
+    }
+    index->nbEntries = n;
 
-        batchedNode = (void **)batchedNode[modulo];
+    uint32_t capacity = INDEX3D_MIN_CAPACITY;
+    while (n * INDEX3D_MAX_LOAD_DEN > capacity * INDEX3D_MAX_LOAD_NUM) {
+        capacity *= 2;
+    }
+    _index3d_rehash(index, capacity);
+}
 
-        if (batchedNode == NULL) {
-            return NULL; // not found
-        }
+/// Returns position of first entry that hasn't been removed, from given position
+static uint32_t _index3d_skip_removed(const Index3D *index, uint32_t position) {
+    while (position < index->nbEntries && index->entries[position].ptr == NULL) {
+        ++position;
+    }
+    return position;
+}
 
-        if (quotient == 0) {
-            // making sure we're going to stop next loop
-            modulo = 0;
-        } else {
-            // go deeper
-            modulo = quotient & INDEX_NODE_BITWISE_MODULO;
-            quotient = quotient >> INDEX_DIVIDE_BYTES;
-        }
+void *index3d_get(const Index3D *index, const int32_t x, const int32_t y, const int32_t z) {
+    const uint32_t i = _index3d_find(index, x, y, z, _index3d_hash(x, y, z));
+    if (i == index->slotsCapacity) {
+        return NULL;
     }
+    return index->entries[index->slots[i].entry - 1].ptr;
 }
 
 void *index3d_remove(Index3D *index,
@@ -217,120 +172,48 @@ void *index3d_remove(Index3D *index,
                      const int32_t z,
                      Index3DIterator *it) {
 
-    // only use unsigned integers for bitwise operations:
-    uint32_t ux = (uint32_t)x;
-    uint32_t uy = (uint32_t)y;
-    uint32_t uz = (uint32_t)z;
-
-    void **currentNode = index->topLevelNode;
-
-    uint32_t modulo = ux & INDEX_NODE_BITWISE_MODULO;
-    uint32_t quotient = ux >> INDEX_DIVIDE_BYTES;
-
-    // look for x
-
-    while (1) {
-        // found, go to y
-        if (quotient == 0 && modulo == 0) {
-            currentNode = (void **)currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE];
-            if (currentNode == NULL) {
-                // not found
-                return NULL;
-            }
-            break;
-        }
-
-        currentNode = (void **)currentNode[modulo];
-
-        if (currentNode == NULL) {
-            // not found
-            return NULL;
-        }
-
-        if (quotient == 0) {
-            // making sure we're going to y in next loop
-            modulo = 0;
-        } else {
-            // go deeper
-            modulo = quotient & INDEX_NODE_BITWISE_MODULO;
-            quotient = quotient >> INDEX_DIVIDE_BYTES;
-        }
+    uint32_t i = _index3d_find(index, x, y, z, _index3d_hash(x, y, z));
+    if (i == index->slotsCapacity) {
+        return NULL; // not found
     }
 
-    // look for y
+    const uint32_t entry = index->slots[i].entry - 1;
+    void *ptr = index->entries[entry].ptr;
+    index->entries[entry].ptr = NULL;
+    --index->count;
 
-    modulo = uy & INDEX_NODE_BITWISE_MODULO;
-    quotient = uy >> INDEX_DIVIDE_BYTES;
+    // optionally maintain ongoing iterator, if at entry being removed
+    if (it != NULL && _index3d_skip_removed(index, it->position) > entry &&
+        it->position <= entry) {
+        it->position = entry;
+        it->removed = true;
+    }
 
-    while (1) {
-        // found, go to z
-        if (quotient == 0 && modulo == 0) {
-            currentNode = (void **)currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE];
-            if (currentNode == NULL) {
-                // not found
-                return NULL;
-            }
+    // move back following slots that can't be reached anymore once slot i is empty
+    const uint32_t mask = index->slotsCapacity - 1;
+    uint32_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (index->slots[j].entry == INDEX3D_SLOT_EMPTY) {
             break;
         }
-
-        currentNode = (void **)currentNode[modulo];
-
-        if (currentNode == NULL) {
-            // not found
-            return NULL;
-        }
-
-        if (quotient == 0) {
-            // making sure we're going to z in next loop
-            modulo = 0;
-        } else {
-            // go deeper
-            modulo = quotient & INDEX_NODE_BITWISE_MODULO;
-            quotient = quotient >> INDEX_DIVIDE_BYTES;
+        const uint32_t home = _index3d_home(index, index->slots[j].hash);
+        // slot j can move to i if its home slot isn't in the (i, j] cyclic range
+        const bool between = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (between == false) {
+            index->slots[i] = index->slots[j];
+            i = j;
         }
     }
+    index->slots[i].entry = INDEX3D_SLOT_EMPTY;
 
-    // look for z
-
-    modulo = uz & INDEX_NODE_BITWISE_MODULO;
-    quotient = uz >> INDEX_DIVIDE_BYTES;
-
-    while (1) {
-        // found!!!!
-        if (quotient == 0 && modulo == 0) {
-            // Note: maybe the node itself can be destroyed if contains nothing
-            // else, but it's good enough for now.
-            void *node = currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE];
-            currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE] = NULL;
-
-            // optionally maintain ongoing iterator, if at node being removed
-            if (it != NULL && it->current == node) {
-                it->current = doubly_linked_list_node_previous(it->current);
-            }
-
-            void *ptr = doubly_linked_list_node_pointer((const DoublyLinkedListNode *)node);
-            doubly_linked_list_delete_node(index->list, (DoublyLinkedListNode *)node);
-            return ptr;
-        }
-
-        currentNode = (void **)currentNode[modulo];
-
-        if (currentNode == NULL) {
-            // not found
-            return NULL;
-        }
-
-        if (quotient == 0) {
-            // making sure we're going to z in next loop
-            modulo = 0;
-        } else {
-            // go deeper
-            modulo = quotient & INDEX_NODE_BITWISE_MODULO;
-            quotient = quotient >> INDEX_DIVIDE_BYTES;
-        }
+    if (index->count == 0 && index->nbIterators == 0) {
+        index->nbEntries = 0;
+    } else {
+        _index3d_compact_if_needed(index);
     }
 
-    return NULL;
+    return ptr;
 }
 
 void index3d_insert(Index3D *index,
@@ -339,160 +222,87 @@ void index3d_insert(Index3D *index,
                     const int32_t y,
                     const int32_t z,
                     Index3DIterator *it) {
+    // all iterators see appended entries, no need to maintain `it`
+    (void)it;
 
-    // only use unsigned integers for bitwise operations:
-    uint32_t ux = (uint32_t)x;
-    uint32_t uy = (uint32_t)y;
-    uint32_t uz = (uint32_t)z;
-
-    void **currentNode = index->topLevelNode;
-
-    uint32_t modulo = ux & INDEX_NODE_BITWISE_MODULO;
-    uint32_t quotient = ux >> INDEX_DIVIDE_BYTES;
-
-    // set x
-
-    while (1) {
-        // printf("x -- q: %u - m: %u\n", quotient, modulo);
-        // found, go to y
-        if (quotient == 0 && modulo == 0) {
-            if (currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE] == NULL) {
-                currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE] = _new_node();
-            }
-            currentNode = (void **)currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE];
-            break;
-        }
-
-        if (currentNode[modulo] == NULL) {
-            currentNode[modulo] = _new_node();
-        }
-        currentNode = (void **)currentNode[modulo];
-
-        if (quotient == 0) {
-            // making sure we're going to y in next loop
-            modulo = 0;
-        } else {
-            // go deeper
-            modulo = quotient & INDEX_NODE_BITWISE_MODULO;
-            quotient = quotient >> INDEX_DIVIDE_BYTES;
-        }
+    if (ptr == NULL) {
+        cclog_error("index3d_insert: can't insert NULL pointer");
+        return;
     }
 
-    // set y
-
-    modulo = uy & INDEX_NODE_BITWISE_MODULO;
-    quotient = uy >> INDEX_DIVIDE_BYTES;
+    const uint32_t hash = _index3d_hash(x, y, z);
 
-    while (1) {
-        // printf("y -- q: %u - m: %u\n", quotient, modulo);
-        // found, go to z
-        if (quotient == 0 && modulo == 0) {
-            if (currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE] == NULL) {
-                currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE] = _new_node();
-            }
-            currentNode = (void **)currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE];
-            break;
-        }
-
-        if (currentNode[modulo] == NULL) {
-            currentNode[modulo] = _new_node();
-        }
-        currentNode = (void **)currentNode[modulo];
-
-        if (quotient == 0) {
-            // making sure we're going to y in next loop
-            modulo = 0;
-        } else {
-            // go deeper
-            modulo = quotient & INDEX_NODE_BITWISE_MODULO;
-            quotient = quotient >> INDEX_DIVIDE_BYTES;
-        }
+    const uint32_t i = _index3d_find(index, x, y, z, hash);
+    if (i != index->slotsCapacity) {
+        index->entries[index->slots[i].entry - 1].ptr = ptr;
+        return;
     }
 
-    // set z
-
-    modulo = uz & INDEX_NODE_BITWISE_MODULO;
-    quotient = uz >> INDEX_DIVIDE_BYTES;
-
-    while (1) {
-        // printf("z -- q: %u - m: %u\n", quotient, modulo);
-        // found, go to z
-        if (quotient == 0 && modulo == 0) {
-            DoublyLinkedListNode *node = doubly_linked_list_push_last(index->list, ptr);
-            currentNode[INDEX_NODE_ARRAY_SIZE_MINUS_ONE] = node;
+    if (index->nbEntries == index->entriesCapacity) {
+        const uint32_t capacity = index->entriesCapacity == 0 ? INDEX3D_MIN_CAPACITY
+                                                              : index->entriesCapacity * 2;
+        Index3DEntry *entries = (Index3DEntry *)realloc(index->entries,
+                                                        capacity * sizeof(Index3DEntry));
+        if (entries == NULL) {
+            cclog_error("index3d_insert: can't allocate entries");
+            return;
+        }
+        index->entries = entries;
+        index->entriesCapacity = capacity;
+    }
 
-            // optionally maintain ongoing iterator, if at the end
-            if (it != NULL && it->current == NULL) {
-                it->current = node;
-            }
-            break;
-        }
+    if ((index->count + 1) * INDEX3D_MAX_LOAD_DEN > index->slotsCapacity * INDEX3D_MAX_LOAD_NUM) {
+        _index3d_rehash(index,
+                        index->slotsCapacity == 0 ? INDEX3D_MIN_CAPACITY
+                                                  : index->slotsCapacity * 2);
+    }
 
-        if (currentNode[modulo] == NULL) {
-            currentNode[modulo] = _new_node();
-        }
-        currentNode = (void **)currentNode[modulo];
-
-        if (quotient == 0) {
-            // making sure we're going to y in next loop
-            modulo = 0;
-        } else {
-            // go deeper
-            modulo = quotient & INDEX_NODE_BITWISE_MODULO;
-            quotient = quotient >> INDEX_DIVIDE_BYTES;
-        }
+    const uint32_t entry = index->nbEntries++;
+    index->entries[entry].ptr = ptr;
+    index->entries[entry].x = x;
+    index->entries[entry].y = y;
+    index->entries[entry].z = z;
+    if (index->count == 0) {
+        index->minX = index->maxX = x;
+        index->minY = index->maxY = y;
+        index->minZ = index->maxZ = z;
+    } else {
+        index->minX = x < index->minX ? x : index->minX;
+        index->minY = y < index->minY ? y : index->minY;
+        index->minZ = z < index->minZ ? z : index->minZ;
+        index->maxX = x > index->maxX ? x : index->maxX;
+        index->maxY = y > index->maxY ? y : index->maxY;
+        index->maxZ = z > index->maxZ ? z : index->maxZ;
     }
+    ++index->count;
+
+    _index3d_place(index, hash, entry);
 }
 
 /// returns whether index is empty
 bool index3d_is_empty(const Index3D *const index) {
-    for (int i = 0; i < INDEX_NODE_ARRAY_SIZE; i++) {
-        if (index->topLevelNode[i] != NULL) {
-            return false;
-        }
-    }
-    return true;
+    return index->count == 0;
 }
 
-void index3d_flush_node(Index3D *index,
-                        void **node,
-                        uint8_t dimension,
-                        pointer_free_function freePtr) {
-    if (node == NULL)
-        return;
-
-    int lastIndex = INDEX_NODE_ARRAY_SIZE_MINUS_ONE;
-
-    for (int i = 0; i < lastIndex; ++i) {
-        if (node[i] != NULL) {
-            index3d_flush_node(index, (void **)(node[i]), dimension, freePtr);
-            free(node[i]);
-            node[i] = NULL;
-        }
-    }
-
-    // go to next dimension or free content if looking in 3rd one
-    if (node[lastIndex] != NULL) {
-        if (dimension < 3) {
-            index3d_flush_node(index, (void **)(node[lastIndex]), dimension + 1, freePtr);
-            free(node[lastIndex]);
-            node[lastIndex] = NULL;
-        } else {
-            void *ptr = doubly_linked_list_node_pointer(
-                (const DoublyLinkedListNode *)(node[lastIndex]));
-            if (freePtr != NULL) {
-                freePtr(ptr);
-            }
-            doubly_linked_list_delete_node(index->list, (DoublyLinkedListNode *)(node[lastIndex]));
-            node[lastIndex] = NULL;
-        }
-    }
+uint32_t index3d_get_count(const Index3D *index) {
+    return index->count;
 }
 
 Index3D *index3d_new(void) {
     Index3D *index = (Index3D *)malloc(sizeof(Index3D));
-    index->topLevelNode = _new_node();
-    index->list = doubly_linked_list_new();
+    if (index == NULL) {
+        return NULL;
+    }
+    // allocated on first insertion, many indexes remain empty (e.g. transactions)
+    index->slots = NULL;
+    index->entries = NULL;
+    index->slotsCapacity = 0;
+    index->entriesCapacity = 0;
+    index->nbEntries = 0;
+    index->count = 0;
+    index->nbIterators = 0;
+    index->minX = index->minY = index->minZ = 0;
+    index->maxX = index->maxY = index->maxZ = 0;
     return index;
 }
 
@@ -503,8 +313,11 @@ void index3d_free(Index3D *index) {
     if (index3d_is_empty(index) == false) {
         cclog_error("⚠️ index3d_free error: index is not empty (possible memory leak)");
     }
-    doubly_linked_list_free(index->list);
-    free(index->topLevelNode);
+    if (index->nbIterators > 0) {
+        cclog_error("⚠️ index3d_free error: iterators still alive");
+    }
+    free(index->slots);
+    free(index->entries);
     free(index);
 }
 
@@ -512,11 +325,25 @@ void index3d_flush(Index3D *index, pointer_free_function ptr) {
     if (index3d_is_empty(index) == true) {
         return;
     }
-    // list nodes are freed correctly within index3d_flush_node
-    index3d_flush_node(index, index->topLevelNode, 1, ptr);
-    // so it's now safe to free the list and create a new one
-    doubly_linked_list_free(index->list);
-    index->list = doubly_linked_list_new();
+    if (ptr != NULL) {
+        for (uint32_t i = 0; i < index->nbEntries; ++i) {
+            if (index->entries[i].ptr != NULL) {
+                ptr(index->entries[i].ptr);
+            }
+        }
+    }
+    if (index->slots != NULL) {
+        memset(index->slots, 0, index->slotsCapacity * sizeof(Index3DSlot));
+    }
+    if (index->nbIterators > 0) {
+        // keep positions valid for alive iterators, entries become holes
+        for (uint32_t i = 0; i < index->nbEntries; ++i) {
+            index->entries[i].ptr = NULL;
+        }
+    } else {
+        index->nbEntries = 0;
+    }
+    index->count = 0;
 }
 
 //-------------------
@@ -525,23 +352,48 @@ void index3d_flush(Index3D *index, pointer_free_function ptr) {
 
 Index3DIterator *index3d_iterator_new(Index3D *index) {
     Index3DIterator *it = (Index3DIterator *)malloc(sizeof(Index3DIterator));
-    it->current = doubly_linked_list_first(index->list);
+    if (it == NULL) {
+        return NULL;
+    }
+    it->index = index;
+    it->position = 0;
+    it->removed = false;
+    ++index->nbIterators;
     return it;
 }
 
 void index3d_iterator_free(Index3DIterator *it) {
-    // the list nodes are the Index3D's responsibility
+    if (it == NULL) {
+        return;
+    }
+    Index3D *index = it->index;
+    --index->nbIterators;
+    if (index->count == 0 && index->nbIterators == 0) {
+        index->nbEntries = 0;
+    } else {
+        _index3d_compact_if_needed(index);
+    }
     free(it);
 }
 
 void *index3d_iterator_pointer(const Index3DIterator *it) {
-    return doubly_linked_list_node_pointer(it->current);
+    const uint32_t position = _index3d_skip_removed(it->index, it->position);
+    return position < it->index->nbEntries ? it->index->entries[position].ptr : NULL;
 }
 
 void index3d_iterator_next(Index3DIterator *it) {
-    it->current = doubly_linked_list_node_next(it->current);
+    const Index3D *index = it->index;
+    uint32_t position = _index3d_skip_removed(index, it->position);
+    if (it->removed == false && position < index->nbEntries) {
+        ++position;
+    }
+    it->position = _index3d_skip_removed(index, position);
+    it->removed = false;
 }
 
 bool index3d_iterator_is_at_end(const Index3DIterator *it) {
-    return doubly_linked_list_node_next(it->current) == NULL;
+    const Index3D *index = it->index;
+    const uint32_t position = _index3d_skip_removed(index, it->position);
+    return position >= index->nbEntries ||
+           _index3d_skip_removed(index, position + 1) >= index->nbEntries;
 }
@@ -4,12 +4,10 @@
 //  Created by Adrien Duermael on December 3, 2016.
 // -------------------------------------------------------------
 
-// index3d can be used to store pointers in 3d space
-// storing and retrieving pointers is a little slower compared
-// to 3d arrays. But it takes a lot less space in memory and
-// request time is constant and reliable.
-// index3d also automatically stores pointers in a doubly_linked_list, in no
-// specific order. It's useful when we want to iterate over all entries quickly.
+// index3d can be used to store pointers in 3d space.
+// Positions are hashed in a flat open addressing table, pointing to a dense array of entries, which
+// keeps insertion order and allows to iterate over all entries quickly.
+// Removed entries leave a hole in the dense array, filled when no iterator exists.
 
 #pragma once
 
@@ -21,13 +19,11 @@ extern "C" {
 #include <stdint.h>
 #include <stdio.h>
 
-#include "doubly_linked_list.h"
 #include "function_pointers.h"
 
 typedef struct _Index3D Index3D;
 
-// Index3DIterator can be used to quickly iterate over all stored pointers
-// (uses the doubly_linked_list)
+// Index3DIterator can be used to quickly iterate over all stored pointers, in insertion order
 typedef struct _Index3DIterator Index3DIterator;
 
 // constructor
@@ -47,7 +43,9 @@ bool index3d_is_empty(const Index3D *const index);
 // see world.c/entity_list_with_distance_free to help for implementation
 void index3d_flush(Index3D *index, pointer_free_function ptr);
 
-// index3d_insert inserts ptr at given position, optionally maintaining given iterator
+// index3d_insert inserts ptr at given position, replacing pointer already at that position if any.
+// Iterators at end position will point to the new entry.
+// `it` parameter is only kept for compatibility, all iterators are maintained.
 void index3d_insert(Index3D *index,
                     void *ptr,
                     const int32_t x,
@@ -57,11 +55,9 @@ void index3d_insert(Index3D *index,
 
 // index3d_get returns pointer at given position. NULL can be returned
 void *index3d_get(const Index3D *index, const int32_t x, const int32_t y, const int32_t z);
-void index3d_batch_get_reset(const Index3D *index, void ***batchedNode);
-bool index3d_batch_get_advance(const int32_t value, void ***batchedNode);
-void *index3d_batch_get(const int32_t z, void **batchedNode);
 
-// index3d_remove removes ptr from index at given position, optionally maintaining given iterator
+// index3d_remove removes ptr from index at given position.
+// An iterator pointing to the removed entry then points to the next one.
 // @returns removed pointer or NULL if not found. Its caller's responsibility to free memory.
 void *index3d_remove(Index3D *index,
                      const int32_t x,
@@ -69,6 +65,9 @@ void *index3d_remove(Index3D *index,
                      const int32_t z,
                      Index3DIterator *it);
 
+// returns number of stored pointers
+uint32_t index3d_get_count(const Index3D *index);
+
 // returns new iterator
 Index3DIterator *index3d_iterator_new(Index3D *index);
 
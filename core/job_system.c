@@ -0,0 +1,401 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  job_system.c
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#include "job_system.h"
+
+// C
+#include <stdlib.h>
+
+// Core
+#include "cclog.h"
+#include "config.h"
+#include "mutex.h"
+#include "thread.h"
+
+#define JOB_DEQUE_INITIAL_CAPACITY 64
+// parallel_for default grain: aim for that many ranges per thread, for load balancing
+#define JOB_RANGES_PER_THREAD 4
+
+typedef struct {
+    job_func func;
+    void *userdata;
+    JobCounter *counter;
+} Job;
+
+typedef struct {
+    Mutex *mutex;
+    Job *jobs; // ring buffer
+    uint32_t capacity;
+    uint32_t top; // index of oldest job, where thieves steal
+    uint32_t count;
+    char pad[4];
+} JobDeque;
+
+typedef struct {
+    JobSystem *js;
+    Thread *thread;
+    uint32_t index;
+    char pad[4];
+} JobWorker;
+
+struct _JobSystem {
+    JobWorker *workers;
+    // one deque per worker + one shared by non-worker threads (last one)
+    JobDeque *deques;
+    ThreadCondition *sleep;
+    uint32_t nbWorkers;
+    uint32_t nbDeques; // nbWorkers + 1, unless workers couldn't be started
+    // jobs in deques, not taken yet
+    volatile int32_t queued;
+    bool stop;
+    char pad[3];
+};
+
+// deque index of the current thread, when it's a worker of `_currentSystem`
+static vx_thread_local JobSystem *_currentSystem = NULL;
+static vx_thread_local uint32_t _currentDeque = 0;
+
+static JobSystem *_sharedSystem = NULL;
+
+// MARK: - Deque -
+
+static void _job_deque_init(JobDeque *d) {
+    d->mutex = mutex_new();
+    d->jobs = (Job *)malloc(sizeof(Job) * JOB_DEQUE_INITIAL_CAPACITY);
+    d->capacity = JOB_DEQUE_INITIAL_CAPACITY;
+    d->top = 0;
+    d->count = 0;
+}
+
+static void _job_deque_release(JobDeque *d) {
+    mutex_free(d->mutex);
+    free(d->jobs);
+}
+
+static void _job_deque_push_bottom(JobDeque *d, const Job job) {
+    mutex_lock(d->mutex);
+    if (d->count == d->capacity) {
+        Job *jobs = (Job *)malloc(sizeof(Job) * d->capacity * 2);
+        for (uint32_t i = 0; i < d->count; ++i) {
+            jobs[i] = d->jobs[(d->top + i) % d->capacity];
+        }
+        free(d->jobs);
+        d->jobs = jobs;
+        d->capacity *= 2;
+        d->top = 0;
+    }
+    d->jobs[(d->top + d->count) % d->capacity] = job;
+    ++d->count;
+    mutex_unlock(d->mutex);
+}
+
+static bool _job_deque_pop_bottom(JobDeque *d, Job *job) {
+    bool found = false;
+    mutex_lock(d->mutex);
+    if (d->count > 0) {
+        --d->count;
+        *job = d->jobs[(d->top + d->count) % d->capacity];
+        found = true;
+    }
+    mutex_unlock(d->mutex);
+    return found;
+}
+
+static bool _job_deque_steal_top(JobDeque *d, Job *job) {
+    bool found = false;
+    mutex_lock(d->mutex);
+    if (d->count > 0) {
+        *job = d->jobs[d->top];
+        d->top = (d->top + 1) % d->capacity;
+        --d->count;
+        found = true;
+    }
+    mutex_unlock(d->mutex);
+    return found;
+}
+
+// MARK: - Private -
+
+static uint32_t _job_system_current_deque(const JobSystem *js) {
+    return _currentSystem == js ? _currentDeque : js->nbWorkers;
+}
+
+static void _job_run(const Job *job) {
+    job->func(job->userdata);
+    if (job->counter != NULL) {
+        thread_atomic_add(&job->counter->pending, -1);
+    }
+}
+
+/// Takes a job from own deque first, steals from others otherwise
+static bool _job_system_take(JobSystem *js, Job *job) {
+    if (thread_atomic_load(&js->queued) == 0) {
+        return false;
+    }
+
+    const uint32_t nbDeques = js->nbWorkers + 1;
+    const uint32_t own = _job_system_current_deque(js);
+    bool found = _job_deque_pop_bottom(&js->deques[own], job);
+
+    for (uint32_t i = 1; found == false && i < nbDeques; ++i) {
+        found = _job_deque_steal_top(&js->deques[(own + i) % nbDeques], job);
+    }
+
+    if (found) {
+        thread_atomic_add(&js->queued, -1);
+    }
+    return found;
+}
+
+static void _job_worker_main(void *ptr) {
+    JobWorker *worker = (JobWorker *)ptr;
+    JobSystem *js = worker->js;
+    _currentSystem = js;
+    _currentDeque = worker->index;
+
+    Job job;
+    while (true) {
+        if (_job_system_take(js, &job)) {
+            _job_run(&job);
+            continue;
+        }
+
+        thread_condition_lock(js->sleep);
+        while (thread_atomic_load(&js->queued) == 0 && js->stop == false) {
+            thread_condition_wait(js->sleep);
+        }
+        const bool stop = js->stop && thread_atomic_load(&js->queued) == 0;
+        thread_condition_unlock(js->sleep);
+
+        if (stop) {
+            break;
+        }
+    }
+
+    _currentSystem = NULL;
+}
+
+typedef struct {
+    job_range_func func;
+    void *userdata;
+    uint32_t begin;
+    uint32_t end;
+} JobRange;
+
+static void _job_range_run(void *userdata) {
+    JobRange *range = (JobRange *)userdata;
+    range->func(range->userdata, range->begin, range->end);
+}
+
+typedef struct {
+    void **pointers;
+    job_pointer_func func;
+    void *userdata;
+} JobPointers;
+
+static void _job_pointers_run(void *userdata, uint32_t begin, uint32_t end) {
+    JobPointers *p = (JobPointers *)userdata;
+    for (uint32_t i = begin; i < end; ++i) {
+        p->func(p->pointers[i], p->userdata);
+    }
+}
+
+// MARK: - Public -
+
+JobSystem *job_system_new(uint32_t nbWorkers) {
+    JobSystem *js = (JobSystem *)malloc(sizeof(JobSystem));
+    if (js == NULL) {
+        return NULL;
+    }
+    js->workers = nbWorkers > 0 ? (JobWorker *)malloc(sizeof(JobWorker) * nbWorkers) : NULL;
+    js->deques = (JobDeque *)malloc(sizeof(JobDeque) * (nbWorkers + 1));
+    js->sleep = thread_condition_new();
+    js->nbWorkers = nbWorkers;
+    js->nbDeques = nbWorkers + 1;
+    js->queued = 0;
+    js->stop = false;
+
+    for (uint32_t i = 0; i <= nbWorkers; ++i) {
+        _job_deque_init(&js->deques[i]);
+    }
+
+    for (uint32_t i = 0; i < nbWorkers; ++i) {
+        js->workers[i].js = js;
+        js->workers[i].index = i;
+        js->workers[i].thread = thread_new(_job_worker_main, &js->workers[i]);
+        if (js->workers[i].thread == NULL) {
+            // platform without threads or out of resources: stop started workers,
+            // and fall back to deterministic mode
+            thread_condition_lock(js->sleep);
+            js->stop = true;
+            thread_condition_broadcast(js->sleep);
+            thread_condition_unlock(js->sleep);
+            for (uint32_t j = 0; j < i; ++j) {
+                thread_join_and_free(js->workers[j].thread);
+            }
+            js->stop = false;
+            js->nbWorkers = 0;
+            break;
+        }
+    }
+
+    return js;
+}
+
+void job_system_free(JobSystem *js) {
+    if (js == NULL) {
+        return;
+    }
+
+    thread_condition_lock(js->sleep);
+    js->stop = true;
+    thread_condition_broadcast(js->sleep);
+    thread_condition_unlock(js->sleep);
+
+    for (uint32_t i = 0; i < js->nbWorkers; ++i) {
+        thread_join_and_free(js->workers[i].thread);
+    }
+
+    // jobs submitted to the shared deque while there's no worker can't be left behind
+    Job job;
+    while (_job_system_take(js, &job)) {
+        _job_run(&job);
+    }
+
+    if (js->workers != NULL) {
+        free(js->workers);
+    }
+    for (uint32_t i = 0; i < js->nbDeques; ++i) {
+        _job_deque_release(&js->deques[i]);
+    }
+    free(js->deques);
+    thread_condition_free(js->sleep);
+    free(js);
+}
+
+uint32_t job_system_get_nb_workers(const JobSystem *js) {
+    return js != NULL ? js->nbWorkers : 0;
+}
+
+void job_system_submit(JobSystem *js, job_func func, void *userdata, JobCounter *counter) {
+    const Job job = {func, userdata, counter};
+
+    if (js == NULL || js->nbWorkers == 0) {
+        // deterministic mode
+        func(userdata);
+        return;
+    }
+
+    if (counter != NULL) {
+        thread_atomic_add(&counter->pending, 1);
+    }
+    _job_deque_push_bottom(&js->deques[_job_system_current_deque(js)], job);
+    thread_atomic_add(&js->queued, 1);
+
+    thread_condition_lock(js->sleep);
+    thread_condition_signal(js->sleep);
+    thread_condition_unlock(js->sleep);
+}
+
+void job_system_wait(JobSystem *js, JobCounter *counter) {
+    if (js == NULL || counter == NULL) {
+        return;
+    }
+    Job job;
+    while (thread_atomic_load(&counter->pending) > 0) {
+        if (_job_system_take(js, &job)) {
+            _job_run(&job);
+        } else {
+            // remaining jobs are being executed by other threads
+            thread_yield();
+        }
+    }
+}
+
+void job_system_parallel_for(JobSystem *js,
+                             uint32_t count,
+                             uint32_t grain,
+                             job_range_func func,
+                             void *userdata) {
+    if (count == 0) {
+        return;
+    }
+    if (js == NULL || js->nbWorkers == 0) {
+        func(userdata, 0, count);
+        return;
+    }
+
+    if (grain == 0) {
+        grain = count / ((js->nbWorkers + 1) * JOB_RANGES_PER_THREAD);
+        if (grain == 0) {
+            grain = 1;
+        }
+    }
+
+    const uint32_t nbRanges = (count + grain - 1) / grain;
+    JobRange *ranges = (JobRange *)malloc(sizeof(JobRange) * nbRanges);
+    if (ranges == NULL) {
+        func(userdata, 0, count);
+        return;
+    }
+
+    JobCounter counter = {0};
+    for (uint32_t i = 0; i < nbRanges; ++i) {
+        ranges[i].func = func;
+        ranges[i].userdata = userdata;
+        ranges[i].begin = i * grain;
+        ranges[i].end = i == nbRanges - 1 ? count : (i + 1) * grain;
+        job_system_submit(js, _job_range_run, &ranges[i], &counter);
+    }
+    job_system_wait(js, &counter);
+
+    free(ranges);
+}
+
+void job_system_parallel_for_index3d(JobSystem *js,
+                                     Index3D *index,
+                                     job_pointer_func func,
+                                     void *userdata) {
+    uint32_t count = 0;
+    uint32_t capacity = 64;
+    void **pointers = (void **)malloc(sizeof(void *) * capacity);
+
+    Index3DIterator *it = index3d_iterator_new(index);
+    void *ptr;
+    while ((ptr = index3d_iterator_pointer(it)) != NULL) {
+        if (count == capacity) {
+            capacity *= 2;
+            pointers = (void **)realloc(pointers, sizeof(void *) * capacity);
+        }
+        pointers[count++] = ptr;
+        index3d_iterator_next(it);
+    }
+    index3d_iterator_free(it);
+
+    JobPointers p = {pointers, func, userdata};
+    job_system_parallel_for(js, count, 0, _job_pointers_run, &p);
+
+    free(pointers);
+}
+
+// MARK: - Shared job system -
+
+void job_system_shared_init(uint32_t nbWorkers) {
+    if (_sharedSystem != NULL) {
+        cclog_warning("job_system_shared_init: already initialized");
+        return;
+    }
+    _sharedSystem = job_system_new(nbWorkers);
+}
+
+void job_system_shared_free(void) {
+    job_system_free(_sharedSystem);
+    _sharedSystem = NULL;
+}
+
+JobSystem *job_system_shared(void) {
+    return _sharedSystem;
+}
@@ -0,0 +1,85 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  job_system.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+// Work-stealing job system.
+// Each worker thread owns a deque: jobs it submits are pushed & popped at the bottom (LIFO, cache
+// friendly), idle workers steal from the top of other deques (FIFO). Jobs submitted from other
+// threads go to a shared deque that all workers steal from.
+//
+// A job system created with 0 workers is deterministic: jobs run on the submitting thread,
+// immediately and in submission order. Meant for tests & platforms without threads.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "index3d.h"
+
+typedef struct _JobSystem JobSystem;
+
+/// Counts submitted jobs that are not done yet, zero it before first use.
+/// Usually lives on the stack of the function waiting for the jobs.
+typedef struct {
+    volatile int32_t pending;
+} JobCounter;
+
+typedef void (*job_func)(void *userdata);
+typedef void (*job_range_func)(void *userdata, uint32_t begin, uint32_t end);
+typedef void (*job_pointer_func)(void *ptr, void *userdata);
+
+/// Creates a job system with `nbWorkers` worker threads, 0 for deterministic mode.
+/// The thread waiting for jobs also executes jobs, so `nbWorkers` is usually core count - 1.
+/// May start less workers than requested if threads can't be created.
+JobSystem *job_system_new(uint32_t nbWorkers);
+
+/// Lets workers finish queued jobs, then stops them & frees the job system
+void job_system_free(JobSystem *js);
+
+uint32_t job_system_get_nb_workers(const JobSystem *js);
+
+/// Schedules `func(userdata)`, `counter` is optional.
+void job_system_submit(JobSystem *js, job_func func, void *userdata, JobCounter *counter);
+
+/// Returns once all jobs tracked by `counter` are done, executing jobs in the meantime.
+void job_system_wait(JobSystem *js, JobCounter *counter);
+
+/// Calls `func` on sub-ranges of [0, count) of at most `grain` elements, in parallel,
+/// and returns once all of them are done. `grain` 0 picks a grain based on workers count.
+/// `js` can be NULL, `func` is then called once for the whole range.
+void job_system_parallel_for(JobSystem *js,
+                             uint32_t count,
+                             uint32_t grain,
+                             job_range_func func,
+                             void *userdata);
+
+/// Calls `func` for each pointer of the index (e.g. shape chunks), in parallel.
+/// Pointers are split in ranges following the iterator order.
+void job_system_parallel_for_index3d(JobSystem *js,
+                                     Index3D *index,
+                                     job_pointer_func func,
+                                     void *userdata);
+
+// MARK: - Shared job system -
+
+/// Creates the job system used by core functions that can parallelize work
+/// (e.g. shape_refresh_all_vertices). Not thread-safe, call once at launch.
+/// Core works on a single thread as long as this isn't called.
+void job_system_shared_init(uint32_t nbWorkers);
+
+/// Frees the shared job system, if any
+void job_system_shared_free(void);
+
+/// Returns NULL if job_system_shared_init hasn't been called
+JobSystem *job_system_shared(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -12,9 +12,12 @@
 #include "colors.h"
 #include "config.h"
 #include "hash_uint32_int.h"
+#include "mutex.h"
 #include "serialization.h"
 #include "shape.h"
 #include "stream.h"
+#include "thread.h"
+#include "utils.h"
 
 #define VOX_MAGIC_BYTES "VOX "
 #define VOX_MAGIC_BYTES_SIZE 4
@@ -603,14 +606,184 @@ bool serialization_shapes_to_vox(Shape **shapes, const size_t nbShapes, FILE *co
     return true;
 }
 
-enum serialization_magicavoxel_error serialization_vox_to_shape(Stream *s,
-                                                                Shape **out,
-                                                                const bool isMutable,
-                                                                ColorAtlas *colorAtlas) {
+// MARK: - Import -
 
-    vx_assert(s != NULL);
-    vx_assert(out != NULL);
-    vx_assert(*out == NULL);
+#define VOX_CHUNKS_PER_AXIS (256 / CHUNK_SIZE) // .vox models are 256 blocks max per axis
+#define VOX_CHUNKS_COUNT (VOX_CHUNKS_PER_AXIS * VOX_CHUNKS_PER_AXIS * VOX_CHUNKS_PER_AXIS)
+
+typedef struct {
+    Shape *shape;
+    // XYZI chunk content, 4 bytes per voxel: x, z, y, color index (.vox is z-up)
+    uint8_t *voxels;
+    // chunks built from voxels, waiting to be added to the shape
+    Chunk **chunks;
+    size_t nbChunks;
+    uint32_t nbVoxels;
+    uint32_t sizeX, sizeY, sizeZ;
+    // .vox color index -> shape palette index
+    SHAPE_COLOR_INDEX_INT_T colorMap[VOX_MAX_NB_COLORS];
+    bool failed;
+    char pad[7];
+} VoxModel;
+
+typedef struct {
+    VoxModel *models;
+    Mutex *mutex;
+    size_t nbModels;
+    size_t next;
+} VoxBuildQueue;
+
+// Buckets model voxels per chunk & builds each chunk octree in one go.
+// Only touches model's own data, so models can be built concurrently.
+static void _vox_model_build_chunks(VoxModel *model) {
+
+    // counting sort of voxels per chunk, keeping file order within each chunk
+    uint32_t *offsets = (uint32_t *)calloc(VOX_CHUNKS_COUNT + 1, sizeof(uint32_t));
+    uint8_t *sorted = (uint8_t *)malloc((size_t)model->nbVoxels * 4 + 1);
+    Block *blocks = (Block *)malloc(sizeof(Block) * CHUNK_SIZE_CUBE);
+    model->chunks = (Chunk **)malloc(sizeof(Chunk *) * VOX_CHUNKS_COUNT);
+    if (offsets == NULL || sorted == NULL || blocks == NULL || model->chunks == NULL) {
+        free(offsets);
+        free(sorted);
+        free(blocks);
+        model->failed = true;
+        return;
+    }
+
+    const uint8_t *v;
+    uint32_t chunkIndex;
+    for (uint32_t i = 0; i < model->nbVoxels; ++i) {
+        v = model->voxels + i * 4;
+        // ⚠️ y -> z, z -> y
+        chunkIndex = (uint32_t)(v[0] / CHUNK_SIZE) +
+                     (uint32_t)(v[2] / CHUNK_SIZE) * VOX_CHUNKS_PER_AXIS +
+                     (uint32_t)(v[1] / CHUNK_SIZE) * VOX_CHUNKS_PER_AXIS * VOX_CHUNKS_PER_AXIS;
+        ++offsets[chunkIndex + 1];
+    }
+    for (uint32_t c = 0; c < VOX_CHUNKS_COUNT; ++c) {
+        offsets[c + 1] += offsets[c];
+    }
+    // offsets[c] is now the start of chunk c, used as insertion cursor & restored below
+    for (uint32_t i = 0; i < model->nbVoxels; ++i) {
+        v = model->voxels + i * 4;
+        chunkIndex = (uint32_t)(v[0] / CHUNK_SIZE) +
+                     (uint32_t)(v[2] / CHUNK_SIZE) * VOX_CHUNKS_PER_AXIS +
+                     (uint32_t)(v[1] / CHUNK_SIZE) * VOX_CHUNKS_PER_AXIS * VOX_CHUNKS_PER_AXIS;
+        // voxels are moved, not referenced, so that chunks can then be read sequentially
+        memcpy(sorted + (size_t)offsets[chunkIndex]++ * 4, v, 4);
+    }
+
+    model->nbChunks = 0;
+    uint32_t start = 0;
+    for (uint32_t c = 0; c < VOX_CHUNKS_COUNT; ++c) {
+        const uint32_t end = offsets[c];
+        if (end == start) {
+            continue;
+        }
+
+        memset(blocks, SHAPE_COLOR_INDEX_AIR_BLOCK, sizeof(Block) * CHUNK_SIZE_CUBE);
+        for (uint32_t i = start; i < end; ++i) {
+            v = sorted + (size_t)i * 4;
+            const uint32_t x = v[0] % CHUNK_SIZE;
+            const uint32_t y = v[2] % CHUNK_SIZE;
+            const uint32_t z = v[1] % CHUNK_SIZE;
+            Block *b = blocks + x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQR;
+            // first voxel wins, like when adding blocks one by one
+            if (block_is_solid(b) == false) {
+                // MV block indexes start at 1, while palette indexes start at 0
+                b->colorIndex = model->colorMap[(uint8_t)(v[3] - 1)];
+            }
+        }
+
+        const SHAPE_COORDS_INT3_T origin = {
+            (SHAPE_COORDS_INT_T)((c % VOX_CHUNKS_PER_AXIS) * CHUNK_SIZE),
+            (SHAPE_COORDS_INT_T)((c / VOX_CHUNKS_PER_AXIS % VOX_CHUNKS_PER_AXIS) * CHUNK_SIZE),
+            (SHAPE_COORDS_INT_T)((c / (VOX_CHUNKS_PER_AXIS * VOX_CHUNKS_PER_AXIS)) * CHUNK_SIZE)};
+        Chunk *chunk = chunk_new(origin);
+        if (chunk == NULL) {
+            model->failed = true;
+            break;
+        }
+        chunk_set_blocks(chunk, blocks);
+        model->chunks[model->nbChunks++] = chunk;
+
+        start = end;
+    }
+
+    free(offsets);
+    free(sorted);
+    free(blocks);
+}
+
+static void _vox_build_worker(void *ptr) {
+    VoxBuildQueue *queue = (VoxBuildQueue *)ptr;
+    size_t i;
+    while (true) {
+        mutex_lock(queue->mutex);
+        i = queue->next++;
+        mutex_unlock(queue->mutex);
+
+        if (i >= queue->nbModels) {
+            return;
+        }
+        _vox_model_build_chunks(&queue->models[i]);
+    }
+}
+
+// Builds chunks of all models, using several threads if possible
+static void _vox_build_models(VoxModel *models, const size_t nbModels) {
+    uint32_t nbThreads = minimum(thread_get_core_count(), (uint32_t)nbModels);
+    Mutex *mutex = nbThreads > 1 ? mutex_new() : NULL;
+    if (mutex == NULL) {
+        nbThreads = 1;
+    }
+
+    VoxBuildQueue queue = {models, mutex, nbModels, 0};
+
+    if (nbThreads == 1) {
+        for (size_t i = 0; i < nbModels; ++i) {
+            _vox_model_build_chunks(&models[i]);
+        }
+        return;
+    }
+
+    // calling thread is one of the workers
+    Thread **threads = (Thread **)malloc(sizeof(Thread *) * (nbThreads - 1));
+    if (threads != NULL) {
+        for (uint32_t i = 0; i < nbThreads - 1; ++i) {
+            threads[i] = thread_new(_vox_build_worker, &queue);
+        }
+    }
+    _vox_build_worker(&queue);
+    if (threads != NULL) {
+        for (uint32_t i = 0; i < nbThreads - 1; ++i) {
+            thread_join_and_free(threads[i]);
+        }
+        free(threads);
+    }
+    mutex_free(mutex);
+}
+
+static void _vox_models_free(VoxModel *models, const size_t nbModels) {
+    for (size_t i = 0; i < nbModels; ++i) {
+        free(models[i].voxels);
+        if (models[i].chunks != NULL) {
+            for (size_t c = 0; c < models[i].nbChunks; ++c) {
+                chunk_free(models[i].chunks[c], false);
+            }
+            free(models[i].chunks);
+        }
+    }
+    free(models);
+}
+
+// Reads .vox content, importing all models or only the first one
+static enum serialization_magicavoxel_error _vox_import(Stream *s,
+                                                        const bool isMutable,
+                                                        ColorAtlas *colorAtlas,
+                                                        const bool firstModelOnly,
+                                                        Shape ***out,
+                                                        size_t *nbShapes) {
 
     // read magic bytes
     if (_readExpectedBytes(s, VOX_MAGIC_BYTES, VOX_MAGIC_BYTES_SIZE) == false) {
@@ -653,8 +826,6 @@ enum serialization_magicavoxel_error serialization_vox_to_shape(Stream *s,
 
     // It really looks like a .vox file
 
-    *out = NULL;
-
     // read chunks
 
     char chunkName[CHUNK_HEADER_SIZE_PLUS_ONE]; // chunkNameSize
@@ -662,23 +833,16 @@ enum serialization_magicavoxel_error serialization_vox_to_shape(Stream *s,
 
     uint32_t current_chunk_content_bytes;
     uint32_t current_chunk_children_content_bytes;
-    uint32_t sizeX = 0;
-    uint32_t sizeY = 0;
-    uint32_t sizeZ = 0;
 
     enum serialization_magicavoxel_error err = no_error;
 
-    size_t blocksPosition = 0;
-    RGBAColor *colors = malloc(sizeof(RGBAColor) * VOX_MAX_NB_COLORS);
-    if (colors == NULL) {
-        return unknown_chunk;
-    }
-    for (int i = 0; i < VOX_MAX_NB_COLORS; ++i) {
-        colors[i].r = 0;
-        colors[i].g = 0;
-        colors[i].b = 0;
-        colors[i].a = 0;
-    }
+    // models are SIZE + XYZI chunk pairs
+    VoxModel *models = NULL;
+    size_t nbModels = 0;
+    size_t modelsCapacity = 0;
+
+    RGBAColor colors[VOX_MAX_NB_COLORS];
+    memset(colors, 0, sizeof(colors));
 
     while (stream_reached_the_end(s) == false) {
 
@@ -700,17 +864,17 @@ enum serialization_magicavoxel_error serialization_vox_to_shape(Stream *s,
             break;
         }
 
-        // PACK
+        // PACK (number of models, deprecated, models are counted from SIZE chunks instead)
         if (strcmp(chunkName, "PACK") == 0) {
 
-            uint32_t nbModels = 0;
-            if (stream_read_uint32(s, &nbModels) == false) {
+            uint32_t nbPackModels = 0;
+            if (stream_read_uint32(s, &nbPackModels) == false) {
                 cclog_error("could not read number of models");
                 err = invalid_format;
                 break;
             }
 
-            if (nbModels > 1) {
+            if (firstModelOnly && nbPackModels > 1) {
                 cclog_error("PACK with more than 1 model not supported");
                 err = pack_chunk_found;
                 break;
@@ -718,20 +882,32 @@ enum serialization_magicavoxel_error serialization_vox_to_shape(Stream *s,
         }
         // SIZE
         else if (strcmp(chunkName, "SIZE") == 0) {
+            if (nbModels == modelsCapacity) {
+                modelsCapacity = modelsCapacity == 0 ? 1 : modelsCapacity * 2;
+                VoxModel *resized = (VoxModel *)realloc(models, sizeof(VoxModel) * modelsCapacity);
+                if (resized == NULL) {
+                    err = invalid_format;
+                    break;
+                }
+                models = resized;
+            }
+            VoxModel *model = &models[nbModels++];
+            memset(model, 0, sizeof(VoxModel));
+
             // ⚠️ y -> z, z -> y
-            if (stream_read_uint32(s, &sizeX) == false) {
+            if (stream_read_uint32(s, &model->sizeX) == false) {
                 cclog_error("could not read sizeX");
                 err = invalid_format;
                 break;
             }
 
-            if (stream_read_uint32(s, &sizeZ) == false) {
+            if (stream_read_uint32(s, &model->sizeZ) == false) {
                 cclog_error("could not read sizeZ");
                 err = invalid_format;
                 break;
             }
 
-            if (stream_read_uint32(s, &sizeY) == false) {
+            if (stream_read_uint32(s, &model->sizeY) == false) {
                 cclog_error("could not read sizeY");
                 err = invalid_format;
                 break;
@@ -739,18 +915,38 @@ enum serialization_magicavoxel_error serialization_vox_to_shape(Stream *s,
         }
         // XYZI
         else if (strcmp(chunkName, "XYZI") == 0) {
-            // Found blocks, but palette not loaded, keeping for later
+            // Found blocks, but palette may not be loaded yet, keeping them for later
 
-            blocksPosition = stream_get_cursor_position(s);
+            if (nbModels == 0 || models[nbModels - 1].voxels != NULL) {
+                cclog_error("XYZI chunk without SIZE chunk");
+                err = invalid_format;
+                break;
+            }
+            VoxModel *model = &models[nbModels - 1];
 
-            uint32_t nbVoxels;
-            if (stream_read_uint32(s, &nbVoxels) == false) {
+            if (stream_read_uint32(s, &model->nbVoxels) == false) {
                 cclog_error("could not read nbVoxels");
-                shape_release(*out);
-                return invalid_format;
+                err = invalid_format;
+                break;
             }
 
-            stream_skip(s, 4 * nbVoxels);
+            if (current_chunk_content_bytes < 4 ||
+                (current_chunk_content_bytes - 4) / 4 < model->nbVoxels) {
+                cclog_error("invalid XYZI chunk format");
+                err = invalid_format;
+                break;
+            }
+
+            // all voxels read at once
+            model->voxels = (uint8_t *)malloc((size_t)model->nbVoxels * 4 + 1);
+            if (model->voxels == NULL ||
+                (model->nbVoxels > 0 &&
+                 stream_read(s, model->voxels, (size_t)model->nbVoxels * 4, 1) == false)) {
+                cclog_error("could not read voxels");
+                err = invalid_format;
+                break;
+            }
+            stream_skip(s, current_chunk_content_bytes - 4 - model->nbVoxels * 4);
         }
 
         // RGBA (palette)
@@ -762,33 +958,11 @@ enum serialization_magicavoxel_error serialization_vox_to_shape(Stream *s,
                 break;
             }
 
-            int nbColors = minimum(current_chunk_content_bytes / 4, VOX_MAX_NB_COLORS);
-
-            for (int i = 0; i < nbColors; i++) {
-
-                if (stream_read_uint8(s, &(colors[i].r)) == false) {
-                    cclog_error("could not read r");
-                    err = invalid_format;
-                    break;
-                }
-
-                if (stream_read_uint8(s, &(colors[i].g)) == false) {
-                    cclog_error("could not read g");
-                    err = invalid_format;
-                    break;
-                }
-
-                if (stream_read_uint8(s, &(colors[i].b)) == false) {
-                    cclog_error("could not read b");
-                    err = invalid_format;
-                    break;
-                }
-
-                if (stream_read_uint8(s, &(colors[i].a)) == false) {
-                    cclog_error("could not read a");
-                    err = invalid_format;
-                    break;
-                }
+            const size_t nbColors = minimum(current_chunk_content_bytes / 4, VOX_MAX_NB_COLORS);
+            if (stream_read(s, colors, sizeof(RGBAColor), nbColors) == false) {
+                cclog_error("could not read colors");
+                err = invalid_format;
+                break;
             }
         }
         // UNSUPPORTED CHUNK
@@ -798,84 +972,131 @@ enum serialization_magicavoxel_error serialization_vox_to_shape(Stream *s,
         }
     }
 
-    if (err != no_error || sizeX == 0 || sizeY == 0 || sizeZ == 0 || blocksPosition == 0) {
-        free(colors);
-        if (err == no_error) {
-            return invalid_format;
+    // only keep complete models
+    size_t nbValidModels = 0;
+    for (size_t i = 0; i < nbModels; ++i) {
+        if (models[i].voxels != NULL && models[i].sizeX > 0 && models[i].sizeY > 0 &&
+            models[i].sizeZ > 0 && (firstModelOnly == false || nbValidModels == 0)) {
+            models[nbValidModels++] = models[i];
+        } else {
+            free(models[i].voxels);
         }
-        return err;
     }
+    nbModels = nbValidModels;
 
-    // create Shape
-    *out = shape_make_2(isMutable);
-    shape_set_palette(*out, color_palette_new(colorAtlas), false);
-
-    stream_set_cursor_position(s, blocksPosition);
-
-    uint32_t nbVoxels;
-    uint8_t x, y, z;
-    SHAPE_COLOR_INDEX_INT_T color_index;
-
-    if (stream_read_uint32(s, &nbVoxels) == false) {
-        cclog_error("could not read nbVoxels");
-        shape_release(*out);
-        free(colors);
-        return invalid_format;
+    if (err != no_error || nbModels == 0) {
+        _vox_models_free(models, nbModels);
+        return err != no_error ? err : invalid_format;
     }
 
-    ColorPalette *palette = shape_get_palette(*out);
-    for (uint32_t i = 0; i < nbVoxels; i++) {
-
-        // ⚠️ y -> z, z -> y
-        if (stream_read_uint8(s, &x) == false) {
-            cclog_error("could not read x");
-            err = invalid_format;
-            break;
+    SerializationLoadTimings *timings = serialization_get_load_timings();
+    const uint64_t buildStart = timings != NULL ? utils_time_ns() : 0;
+
+    // create shapes & resolve palette entries, once per distinct color index,
+    // in order of first use to get the same palette as when adding blocks one by one
+    for (size_t m = 0; m < nbModels; ++m) {
+        VoxModel *model = &models[m];
+        model->shape = shape_make_2(isMutable);
+        shape_set_palette(model->shape, color_palette_new(colorAtlas), false);
+        ColorPalette *palette = shape_get_palette(model->shape);
+
+        bool resolved[VOX_MAX_NB_COLORS];
+        memset(resolved, 0, sizeof(resolved));
+        for (uint32_t i = 0; i < model->nbVoxels; ++i) {
+            const uint8_t colorIdx = (uint8_t)(model->voxels[i * 4 + 3] - 1);
+            if (resolved[colorIdx] == false) {
+                resolved[colorIdx] = true;
+                // translate & shrink to a shape palette w/ only used colors
+                if (color_palette_check_and_add_color(palette,
+                                                      colors[colorIdx],
+                                                      &model->colorMap[colorIdx],
+                                                      false) == false) {
+                    model->colorMap[colorIdx] = 0;
+                }
+            }
         }
+    }
 
-        if (stream_read_uint8(s, &z) == false) {
-            cclog_error("could not read z");
-            err = invalid_format;
-            break;
+    // heavy lifting, concurrently if possible
+    _vox_build_models(models, nbModels);
+
+    // move chunks into shapes, palette usage goes through the color atlas so it's done here
+    *out = (Shape **)malloc(sizeof(Shape *) * nbModels);
+    *nbShapes = 0;
+    for (size_t m = 0; m < nbModels; ++m) {
+        VoxModel *model = &models[m];
+        for (size_t c = 0; c < model->nbChunks; ++c) {
+            if (model->failed == false && *out != NULL &&
+                shape_add_chunk(model->shape, model->chunks[c])) {
+                model->chunks[c] = NULL;
+            } else {
+                chunk_free(model->chunks[c], false);
+            }
         }
+        model->nbChunks = 0;
+        color_palette_clear_lighting_dirty(shape_get_palette(model->shape));
 
-        if (stream_read_uint8(s, &y) == false) {
-            cclog_error("could not read y");
+        if (model->failed || *out == NULL) {
+            shape_release(model->shape);
             err = invalid_format;
-            break;
+        } else {
+            (*out)[(*nbShapes)++] = model->shape;
         }
+    }
 
-        if (stream_read_uint8(s, &color_index) == false) {
-            cclog_error("could not read color_index");
-            err = invalid_format;
-            break;
-        }
+    if (timings != NULL) {
+        timings->build_ns += utils_time_ns() - buildStart;
+    }
 
-        // MV block indexes start at 1, while palette indexes start at 0.
-        // We have to shift the color index.
-        // It's also done when exporting .vox (+1 instead of -1)
-        SHAPE_COLOR_INDEX_INT_T colorIdx = color_index - 1;
+    _vox_models_free(models, nbModels);
 
-        // translate & shrink to a shape palette w/ only used colors
-        if (color_palette_check_and_add_color(palette, colors[colorIdx], &colorIdx, false) ==
-            false) {
-            colorIdx = 0;
+    if (err != no_error) {
+        for (size_t i = 0; *out != NULL && i < *nbShapes; ++i) {
+            shape_release((*out)[i]);
         }
-
-        shape_add_block(*out,
-                        colorIdx,
-                        (SHAPE_COORDS_INT_T)x,
-                        (SHAPE_COORDS_INT_T)y,
-                        (SHAPE_COORDS_INT_T)z,
-                        false);
+        free(*out);
+        *out = NULL;
+        *nbShapes = 0;
     }
-    color_palette_clear_lighting_dirty(palette);
 
-    if (err != no_error) {
-        shape_release(*out);
-        free(colors);
-        return err;
+    return err;
+}
+
+enum serialization_magicavoxel_error serialization_vox_to_shape(Stream *s,
+                                                                Shape **out,
+                                                                const bool isMutable,
+                                                                ColorAtlas *colorAtlas) {
+
+    vx_assert(s != NULL);
+    vx_assert(out != NULL);
+    vx_assert(*out == NULL);
+
+    Shape **shapes = NULL;
+    size_t nbShapes = 0;
+    const enum serialization_magicavoxel_error err = _vox_import(s,
+                                                                 isMutable,
+                                                                 colorAtlas,
+                                                                 true,
+                                                                 &shapes,
+                                                                 &nbShapes);
+    if (err == no_error) {
+        *out = shapes[0];
+        free(shapes);
     }
+    return err;
+}
+
+enum serialization_magicavoxel_error serialization_vox_to_shapes(Stream *s,
+                                                                 Shape ***out,
+                                                                 size_t *nbShapes,
+                                                                 const bool isMutable,
+                                                                 ColorAtlas *colorAtlas) {
 
-    return no_error;
+    vx_assert(s != NULL);
+    vx_assert(out != NULL);
+    vx_assert(nbShapes != NULL);
+
+    *out = NULL;
+    *nbShapes = 0;
+    return _vox_import(s, isMutable, colorAtlas, false, out, nbShapes);
 }
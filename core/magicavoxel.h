@@ -36,11 +36,23 @@ bool serialization_save_vox(Shape *src, FILE *const out);
 bool serialization_shapes_to_vox(Shape **shapes, const size_t nbShapes, FILE *const out);
 
 /// converts raw data from src to a Shape
+/// Returns `pack_chunk_found` if a PACK chunk announces several models.
+/// Files listing several models without PACK chunk import their first model only.
+/// Use `serialization_vox_to_shapes` to import all models.
 enum serialization_magicavoxel_error serialization_vox_to_shape(Stream *s,
                                                                 Shape **out,
                                                                 const bool isMutable,
                                                                 ColorAtlas *colorAtlas);
 
+/// converts raw data from src to Shapes, one per model, models being built in parallel
+/// `out` is set to an array of `nbShapes` shapes, the caller is responsible for freeing it
+/// and releasing the shapes
+enum serialization_magicavoxel_error serialization_vox_to_shapes(Stream *s,
+                                                                 Shape ***out,
+                                                                 size_t *nbShapes,
+                                                                 const bool isMutable,
+                                                                 ColorAtlas *colorAtlas);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -9,10 +9,6 @@
 #include <math.h>
 #include <stdlib.h>
 
-static float float4x4_cos, float4x4_cosp, float4x4_sin;
-static float float4x4_s_length, float4x4_s_height, float4x4_s_depth;
-static float3 float4x4_v, float4x4_vx, float4x4_vy, float4x4_vz;
-
 Matrix4x4 *matrix4x4_new(const float x1y1,
                          const float x2y1,
                          const float x3y1,
@@ -94,38 +90,40 @@ void matrix4x4_set_look_at(Matrix4x4 *m,
                            const float3 *eye,
                            const float3 *center,
                            const float3 *up) {
-    float3_copy(&float4x4_vz, center);
-    float3_op_substract(&float4x4_vz, eye);
-    float3_normalize(&float4x4_vz);
+    float3 vx, vy, vz;
+
+    float3_copy(&vz, center);
+    float3_op_substract(&vz, eye);
+    float3_normalize(&vz);
 
-    float3_copy(&float4x4_vx, up);
-    float3_cross_product(&float4x4_vx, &float4x4_vz);
-    float3_normalize(&float4x4_vx);
+    float3_copy(&vx, up);
+    float3_cross_product(&vx, &vz);
+    float3_normalize(&vx);
 
-    float3_copy(&float4x4_vy, &float4x4_vz);
-    float3_cross_product(&float4x4_vy, &float4x4_vx);
+    float3_copy(&vy, &vz);
+    float3_cross_product(&vy, &vx);
     // no need to normalize, because cross product of 2 normalized vectors
     // is a normalized vector
     // |a x b| = |a| x |b|
 
-    m->x1y1 = float4x4_vx.x;
-    m->x1y2 = float4x4_vy.x;
-    m->x1y3 = float4x4_vz.x;
+    m->x1y1 = vx.x;
+    m->x1y2 = vy.x;
+    m->x1y3 = vz.x;
     m->x1y4 = 0.0;
 
-    m->x2y1 = float4x4_vx.y;
-    m->x2y2 = float4x4_vy.y;
-    m->x2y3 = float4x4_vz.y;
+    m->x2y1 = vx.y;
+    m->x2y2 = vy.y;
+    m->x2y3 = vz.y;
     m->x2y4 = 0.0;
 
-    m->x3y1 = float4x4_vx.z;
-    m->x3y2 = float4x4_vy.z;
-    m->x3y3 = float4x4_vz.z;
+    m->x3y1 = vx.z;
+    m->x3y2 = vy.z;
+    m->x3y3 = vz.z;
     m->x3y4 = 0.0;
 
-    m->x4y1 = -float3_dot_product(&float4x4_vx, eye);
-    m->x4y2 = -float3_dot_product(&float4x4_vy, eye);
-    m->x4y3 = -float3_dot_product(&float4x4_vz, eye);
+    m->x4y1 = -float3_dot_product(&vx, eye);
+    m->x4y2 = -float3_dot_product(&vy, eye);
+    m->x4y3 = -float3_dot_product(&vz, eye);
     m->x4y4 = 1.0;
 }
 
@@ -148,28 +146,28 @@ void matrix4x4_set_off_center_orthographic(Matrix4x4 *m,
                                            const float top,
                                            const float near,
                                            const float far) {
-    float4x4_s_length = 1.0f / (right - left);
-    float4x4_s_height = 1.0f / (top - bottom);
-    float4x4_s_depth = 1.0f / (far - near);
+    const float sLength = 1.0f / (right - left);
+    const float sHeight = 1.0f / (top - bottom);
+    const float sDepth = 1.0f / (far - near);
 
-    m->x1y1 = float4x4_s_length * 2.0f;
+    m->x1y1 = sLength * 2.0f;
     m->x1y2 = 0.0f;
     m->x1y3 = 0.0f;
     m->x1y4 = 0.0f;
 
     m->x2y1 = 0.0f;
-    m->x2y2 = float4x4_s_height * 2.0f;
+    m->x2y2 = sHeight * 2.0f;
     m->x2y3 = 0.0f;
     m->x2y4 = 0.0f;
 
     m->x3y1 = 0.0f;
     m->x3y2 = 0.0f;
-    m->x3y3 = float4x4_s_depth;
+    m->x3y3 = sDepth;
     m->x3y4 = 0.0f;
 
-    m->x4y1 = -float4x4_s_length * (left + right);
-    m->x4y2 = -float4x4_s_height * (top + bottom);
-    m->x4y3 = -float4x4_s_depth * near;
+    m->x4y1 = -sLength * (left + right);
+    m->x4y2 = -sHeight * (top + bottom);
+    m->x4y3 = -sDepth * near;
     m->x4y4 = 1.0f;
 }
 
@@ -519,25 +517,26 @@ Matrix4x4 *matrix4x4_new_from_axis_rotation(const float radians,
                                             const float y,
                                             const float z) {
 
-    float3_set(&float4x4_v, x, y, z);
-    float3_normalize(&float4x4_v);
+    float3 v;
+    float3_set(&v, x, y, z);
+    float3_normalize(&v);
 
-    float4x4_cos = cosf(radians);
-    float4x4_cosp = 1.0f - float4x4_cos;
-    float4x4_sin = sinf(radians);
+    const float c = cosf(radians);
+    const float cosp = 1.0f - c;
+    const float s = sinf(radians);
 
     Matrix4x4 *m = matrix4x4_new(
-        float4x4_cos + float4x4_cosp * float4x4_v.x * float4x4_v.x,
-        float4x4_cosp * float4x4_v.x * float4x4_v.y - float4x4_v.z * float4x4_sin,
-        float4x4_cosp * float4x4_v.x * float4x4_v.z + float4x4_v.y * float4x4_sin,
+        c + cosp * v.x * v.x,
+        cosp * v.x * v.y - v.z * s,
+        cosp * v.x * v.z + v.y * s,
         0.0,
-        float4x4_cosp * float4x4_v.x * float4x4_v.y + float4x4_v.z * float4x4_sin,
-        float4x4_cos + float4x4_cosp * float4x4_v.y * float4x4_v.y,
-        float4x4_cosp * float4x4_v.y * float4x4_v.z - float4x4_v.x * float4x4_sin,
+        cosp * v.x * v.y + v.z * s,
+        c + cosp * v.y * v.y,
+        cosp * v.y * v.z - v.x * s,
         0.0,
-        float4x4_cosp * float4x4_v.x * float4x4_v.z - float4x4_v.y * float4x4_sin,
-        float4x4_cosp * float4x4_v.y * float4x4_v.z + float4x4_v.x * float4x4_sin,
-        float4x4_cos + float4x4_cosp * float4x4_v.z * float4x4_v.z,
+        cosp * v.x * v.z - v.y * s,
+        cosp * v.y * v.z + v.x * s,
+        c + cosp * v.z * v.z,
         0.0,
         0.0,
         0.0,
@@ -553,25 +552,26 @@ void matrix4x4_set_from_axis_rotation(Matrix4x4 *m,
                                       const float y,
                                       const float z) {
 
-    float3_set(&float4x4_v, x, y, z);
-    float3_normalize(&float4x4_v);
+    float3 v;
+    float3_set(&v, x, y, z);
+    float3_normalize(&v);
 
-    float4x4_cos = cosf(radians);
-    float4x4_cosp = 1.0f - float4x4_cos;
-    float4x4_sin = sinf(radians);
+    const float c = cosf(radians);
+    const float cosp = 1.0f - c;
+    const float s = sinf(radians);
 
     matrix4x4_set(m,
-                  float4x4_cos + float4x4_cosp * float4x4_v.x * float4x4_v.x,
-                  float4x4_cosp * float4x4_v.x * float4x4_v.y - float4x4_v.z * float4x4_sin,
-                  float4x4_cosp * float4x4_v.x * float4x4_v.z + float4x4_v.y * float4x4_sin,
+                  c + cosp * v.x * v.x,
+                  cosp * v.x * v.y - v.z * s,
+                  cosp * v.x * v.z + v.y * s,
                   0.0,
-                  float4x4_cosp * float4x4_v.x * float4x4_v.y + float4x4_v.z * float4x4_sin,
-                  float4x4_cos + float4x4_cosp * float4x4_v.y * float4x4_v.y,
-                  float4x4_cosp * float4x4_v.y * float4x4_v.z - float4x4_v.x * float4x4_sin,
+                  cosp * v.x * v.y + v.z * s,
+                  c + cosp * v.y * v.y,
+                  cosp * v.y * v.z - v.x * s,
                   0.0,
-                  float4x4_cosp * float4x4_v.x * float4x4_v.z - float4x4_v.y * float4x4_sin,
-                  float4x4_cosp * float4x4_v.y * float4x4_v.z + float4x4_v.x * float4x4_sin,
-                  float4x4_cos + float4x4_cosp * float4x4_v.z * float4x4_v.z,
+                  cosp * v.x * v.z - v.y * s,
+                  cosp * v.y * v.z + v.x * s,
+                  c + cosp * v.z * v.z,
                   0.0,
                   0.0,
                   0.0,
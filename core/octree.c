@@ -70,6 +70,14 @@ uint32_t nb_nodes_for_levels(const size_t levels);
 uint32_t nb_elements_for_levels(const size_t levels);
 size_t octree_element_index_1d(const Octree *octree, size_t x, size_t y, size_t z);
 void *_octree_set_element(const Octree *octree, const void *element, size_t x, size_t y, size_t z);
+bool _octree_refresh_node(Octree *octree,
+                          const uint8_t level,
+                          const int node_index,
+                          const size_t x,
+                          const size_t y,
+                          const size_t z,
+                          const size_t size,
+                          const void *emptyElement);
 static Octree *_octree_new(void);
 
 Octree *octree_new_with_default_element(const OctreeLevelsForSize levels,
@@ -571,6 +579,13 @@ void octree_get_element_or_empty_value(const Octree *octree,
     }
 }
 
+void octree_refresh_nodes(Octree *octree, const void *emptyElement) {
+    if (octree->levels == 0) {
+        return;
+    }
+    _octree_refresh_node(octree, 0, 0, 0, 0, 0, octree->width_height_depth, emptyElement);
+}
+
 void *_octree_set_element(const Octree *octree, const void *element, size_t x, size_t y, size_t z) {
     // no need to check for negative x, y or z: unsigned so always positive
     // if (x < 0 || y < 0 || z < 0) {
@@ -1277,3 +1292,88 @@ static Octree *_octree_new(void) {
     o->levels = 0;
     return o;
 }
+
+// sets node flags for given branch and returns true if the node isn't empty
+bool _octree_refresh_node(Octree *octree,
+                          const uint8_t level,
+                          const int node_index,
+                          const size_t x,
+                          const size_t y,
+                          const size_t z,
+                          const size_t size,
+                          const void *emptyElement) {
+
+    // child offsets, in branch order: 000, 100, 101, 001, 010, 110, 111, 011
+    static const uint8_t offsets[8][3] = {{0, 0, 0},
+                                          {1, 0, 0},
+                                          {1, 0, 1},
+                                          {0, 0, 1},
+                                          {0, 1, 0},
+                                          {1, 1, 0},
+                                          {1, 1, 1},
+                                          {0, 1, 1}};
+
+    OctreeNode *node = (OctreeNode *)(octree->nodes) + node_index;
+    memset(node, 0, sizeof(OctreeNode));
+
+    const size_t half = size >> 1;
+    const bool lastLevel = level + 1 == octree->levels;
+    bool notEmpty;
+
+    for (int i = 0; i < 8; ++i) {
+        const size_t cx = x + offsets[i][0] * half;
+        const size_t cy = y + offsets[i][1] * half;
+        const size_t cz = z + offsets[i][2] * half;
+
+        if (lastLevel) {
+            const char *element = (char *)octree->elements +
+                                  octree->element_size * octree_element_index_1d(octree, cx, cy, cz);
+            // single byte elements (e.g. blocks) are very common, avoid memcmp calls for those
+            notEmpty = octree->element_size == 1
+                           ? *element != *(const char *)emptyElement
+                           : memcmp(element, emptyElement, octree->element_size) != 0;
+        } else {
+            const int child_index = startIndexForLevel[level + 1] +
+                                    8 * (node_index - startIndexForLevel[level]) + i;
+            notEmpty = _octree_refresh_node(octree,
+                                            level + 1,
+                                            child_index,
+                                            cx,
+                                            cy,
+                                            cz,
+                                            half,
+                                            emptyElement);
+        }
+
+        if (notEmpty) {
+            switch (i) {
+                case 0:
+                    node->n000 = 1;
+                    break;
+                case 1:
+                    node->n100 = 1;
+                    break;
+                case 2:
+                    node->n101 = 1;
+                    break;
+                case 3:
+                    node->n001 = 1;
+                    break;
+                case 4:
+                    node->n010 = 1;
+                    break;
+                case 5:
+                    node->n110 = 1;
+                    break;
+                case 6:
+                    node->n111 = 1;
+                    break;
+                case 7:
+                    node->n011 = 1;
+                    break;
+            }
+        }
+    }
+
+    return ((OctreeNodeValue *)node)->v != 0;
+}
@@ -66,6 +66,11 @@ bool octree_set_element(const Octree *octree, const void *element, size_t x, siz
 
 bool octree_remove_element(const Octree *octree, size_t x, size_t y, size_t z, void *emptyElement);
 
+/// Recomputes all nodes from elements, to be called after writing elements directly
+/// (see octree_get_elements). Elements equal to `emptyElement` are considered empty.
+/// This is much faster than setting elements one by one when filling a whole tree.
+void octree_refresh_nodes(Octree *octree, const void *emptyElement);
+
 void octree_log(const Octree *octree);
 
 void octree_non_recursive_iteration(const Octree *octree);
@@ -0,0 +1,393 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  particles.c
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#include "particles.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chunk.h"
+#include "fifo_list.h"
+#include "matrix4x4.h"
+#include "rigidBody.h"
+#include "rtree.h"
+#include "shape.h"
+#include "transform.h"
+
+// float arrays in the pool
+#define PARTICLES_NB_FLOAT_ARRAYS 10
+// shortest particle life, for spread life values
+#define PARTICLES_MIN_LIFE 0.001f
+
+typedef struct {
+    Box box; // world aligned collider
+    // world to model matrix of per-block shapes
+    Matrix4x4 wtl;
+    Shape *shape; // NULL if colliding with box
+} ParticlesCollider;
+
+struct _ParticlesEmitter {
+    ParticlesEmitterConfig config;
+    // structure of arrays, alive particles in [0, count)
+    float *px, *py, *pz;
+    float *vx, *vy, *vz;
+    float *age, *life;
+    float *startScale, *endScale;
+    RGBAColor *startColor, *endColor;
+    void *pool;
+    FifoList *query;
+    ParticlesCollider colliders[PARTICLES_MAX_COLLIDERS];
+    uint32_t nbColliders;
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t random;
+    float spawnAccumulator;
+    char pad[4];
+};
+
+static const float _particles_quad_vertices[] = {-0.5f, -0.5f, 0.0f, 0.5f, -0.5f, 0.0f,
+                                                 0.5f,  0.5f,  0.0f, -0.5f, 0.5f, 0.0f};
+static const uint16_t _particles_quad_indices[] = {0, 2, 1, 0, 3, 2};
+static const float _particles_cube_vertices[] = {
+    -0.5f, -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, -0.5f, 0.5f, -0.5f,
+    -0.5f, -0.5f, 0.5f,  0.5f, -0.5f, 0.5f,  0.5f, 0.5f, 0.5f,  -0.5f, 0.5f, 0.5f};
+static const uint16_t _particles_cube_indices[] = {0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7,
+                                                  0, 1, 5, 0, 5, 4, 3, 6, 2, 3, 7, 6,
+                                                  0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5};
+
+// MARK: - Private -
+
+/// xorshift32, in [-1, 1]
+static float _particles_random(ParticlesEmitter *e) {
+    uint32_t x = e->random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    e->random = x;
+    return (float)(x >> 8) / (float)(1 << 23) - 1.0f;
+}
+
+static RGBAColor _particles_color_lerp(const RGBAColor a, const RGBAColor b, const float t) {
+    return (RGBAColor){(uint8_t)((float)a.r + ((float)b.r - (float)a.r) * t + 0.5f),
+                       (uint8_t)((float)a.g + ((float)b.g - (float)a.g) * t + 0.5f),
+                       (uint8_t)((float)a.b + ((float)b.b - (float)a.b) * t + 0.5f),
+                       (uint8_t)((float)a.a + ((float)b.a - (float)a.a) * t + 0.5f)};
+}
+
+static void _particles_remove(ParticlesEmitter *e, const uint32_t i) {
+    const uint32_t last = --e->count;
+    e->px[i] = e->px[last];
+    e->py[i] = e->py[last];
+    e->pz[i] = e->pz[last];
+    e->vx[i] = e->vx[last];
+    e->vy[i] = e->vy[last];
+    e->vz[i] = e->vz[last];
+    e->age[i] = e->age[last];
+    e->life[i] = e->life[last];
+    e->startScale[i] = e->startScale[last];
+    e->endScale[i] = e->endScale[last];
+    e->startColor[i] = e->startColor[last];
+    e->endColor[i] = e->endColor[last];
+}
+
+static void _particles_gather_colliders(ParticlesEmitter *e, Scene *sc, const float dt) {
+    e->nbColliders = 0;
+
+    // bounds of all trajectories
+    const float *px = e->px, *py = e->py, *pz = e->pz;
+    const float *vx = e->vx, *vy = e->vy, *vz = e->vz;
+    Box bounds = {{px[0], py[0], pz[0]}, {px[0], py[0], pz[0]}};
+    for (uint32_t i = 0; i < e->count; ++i) {
+        const float x = px[i] + vx[i] * dt, y = py[i] + vy[i] * dt, z = pz[i] + vz[i] * dt;
+        bounds.min.x = fminf(bounds.min.x, fminf(px[i], x));
+        bounds.min.y = fminf(bounds.min.y, fminf(py[i], y));
+        bounds.min.z = fminf(bounds.min.z, fminf(pz[i], z));
+        bounds.max.x = fmaxf(bounds.max.x, fmaxf(px[i], x));
+        bounds.max.y = fmaxf(bounds.max.y, fmaxf(py[i], y));
+        bounds.max.z = fmaxf(bounds.max.z, fmaxf(pz[i], z));
+    }
+
+    if (rtree_query_overlap_box(scene_get_rtree(sc),
+                                &bounds,
+                                PHYSICS_GROUP_NONE,
+                                e->config.collidesWith,
+                                NULL,
+                                e->query,
+                                0.0f) == 0) {
+        return;
+    }
+
+    RtreeNode *hit;
+    while ((hit = (RtreeNode *)fifo_list_pop(e->query)) != NULL) {
+        if (e->nbColliders == PARTICLES_MAX_COLLIDERS) {
+            continue;
+        }
+        Transform *t = (Transform *)rtree_node_get_leaf_ptr(hit);
+        RigidBody *rb = transform_get_rigidbody(t);
+        const uint8_t mode = rigidbody_get_simulation_mode(rb);
+        if (mode == RigidbodyMode_Disabled || mode == RigidbodyMode_Trigger ||
+            mode == RigidbodyMode_TriggerPerBlock) {
+            continue;
+        }
+        ParticlesCollider *c = &e->colliders[e->nbColliders++];
+        c->box = *rtree_node_get_aabb(hit);
+        c->shape = rigidbody_uses_per_block_collisions(rb) ? transform_utils_get_shape(t) : NULL;
+        if (c->shape != NULL) {
+            transform_utils_get_model_wtl(t, &c->wtl);
+        }
+    }
+}
+
+static bool _particles_collides(const ParticlesEmitter *e, const float3 *p) {
+    for (uint32_t i = 0; i < e->nbColliders; ++i) {
+        const ParticlesCollider *c = &e->colliders[i];
+        if (p->x <= c->box.min.x || p->y <= c->box.min.y || p->z <= c->box.min.z ||
+            p->x >= c->box.max.x || p->y >= c->box.max.y || p->z >= c->box.max.z) {
+            continue;
+        }
+        if (c->shape == NULL) {
+            return true;
+        }
+
+        float3 model;
+        matrix4x4_op_multiply_vec_point(&model, p, &c->wtl);
+        const SHAPE_COORDS_INT3_T coords = {(SHAPE_COORDS_INT_T)floorf(model.x),
+                                            (SHAPE_COORDS_INT_T)floorf(model.y),
+                                            (SHAPE_COORDS_INT_T)floorf(model.z)};
+        const SHAPE_COORDS_INT3_T chunkCoords = chunk_utils_get_coords(coords);
+        const Chunk *chunk = (const Chunk *)index3d_get(shape_get_chunks(c->shape),
+                                                        chunkCoords.x,
+                                                        chunkCoords.y,
+                                                        chunkCoords.z);
+        if (chunk != NULL) {
+            const CHUNK_COORDS_INT3_T local = chunk_utils_get_coords_in_chunk(coords);
+            if (chunk_is_block_solid(chunk, local.x, local.y, local.z)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/// Moves one axis at a time, bouncing on the axes leading into a collider
+static void _particles_move_colliding(ParticlesEmitter *e, const uint32_t i, const float dt) {
+    float3 p = {e->px[i], e->py[i], e->pz[i]};
+    const float bounciness = -e->config.bounciness;
+
+    float3 next = {p.x + e->vx[i] * dt, p.y, p.z};
+    if (_particles_collides(e, &next)) {
+        e->vx[i] *= bounciness;
+    } else {
+        p.x = next.x;
+    }
+    next = (float3){p.x, p.y + e->vy[i] * dt, p.z};
+    if (_particles_collides(e, &next)) {
+        e->vy[i] *= bounciness;
+    } else {
+        p.y = next.y;
+    }
+    next = (float3){p.x, p.y, p.z + e->vz[i] * dt};
+    if (_particles_collides(e, &next)) {
+        e->vz[i] *= bounciness;
+    } else {
+        p.z = next.z;
+    }
+
+    e->px[i] = p.x;
+    e->py[i] = p.y;
+    e->pz[i] = p.z;
+}
+
+// MARK: - Emitter -
+
+ParticlesEmitter *particles_emitter_new(const uint32_t capacity, const uint32_t seed) {
+    ParticlesEmitter *e = (ParticlesEmitter *)malloc(sizeof(ParticlesEmitter));
+    if (e == NULL) {
+        return NULL;
+    }
+
+    // arrays are 16 bytes aligned
+    const size_t stride = ((size_t)capacity + 3) & ~(size_t)3;
+    e->pool = malloc(stride * (sizeof(float) * PARTICLES_NB_FLOAT_ARRAYS + sizeof(RGBAColor) * 2));
+    e->query = fifo_list_new();
+    if ((e->pool == NULL && capacity > 0) || e->query == NULL) {
+        free(e->pool);
+        fifo_list_free(e->query, NULL);
+        free(e);
+        return NULL;
+    }
+    float *floats = (float *)e->pool;
+    e->px = floats;
+    e->py = floats + stride;
+    e->pz = floats + stride * 2;
+    e->vx = floats + stride * 3;
+    e->vy = floats + stride * 4;
+    e->vz = floats + stride * 5;
+    e->age = floats + stride * 6;
+    e->life = floats + stride * 7;
+    e->startScale = floats + stride * 8;
+    e->endScale = floats + stride * 9;
+    e->startColor = (RGBAColor *)(floats + stride * PARTICLES_NB_FLOAT_ARRAYS);
+    e->endColor = e->startColor + stride;
+
+    e->config = (ParticlesEmitterConfig){float3_zero,
+                                         float3_zero,
+                                         float3_zero,
+                                         float3_zero,
+                                         float3_zero,
+                                         (RGBAColor){255, 255, 255, 255},
+                                         (RGBAColor){255, 255, 255, 255},
+                                         1.0f,
+                                         0.0f,
+                                         1.0f,
+                                         1.0f,
+                                         0.0f,
+                                         0.0f,
+                                         0.0f,
+                                         PHYSICS_GROUP_NONE,
+                                         ParticlesMesh_Cube,
+                                         {0}};
+    e->nbColliders = 0;
+    e->capacity = capacity;
+    e->count = 0;
+    e->random = seed != 0 ? seed : 1; // xorshift state can't be 0
+    e->spawnAccumulator = 0.0f;
+    return e;
+}
+
+void particles_emitter_free(ParticlesEmitter *e) {
+    if (e == NULL) {
+        return;
+    }
+    free(e->pool);
+    fifo_list_free(e->query, NULL);
+    free(e);
+}
+
+ParticlesEmitterConfig *particles_emitter_get_config(ParticlesEmitter *e) {
+    return &e->config;
+}
+
+uint32_t particles_emitter_spawn(ParticlesEmitter *e, const uint32_t n) {
+    const ParticlesEmitterConfig *cfg = &e->config;
+    const uint32_t spawned = n < e->capacity - e->count ? n : e->capacity - e->count;
+    for (uint32_t k = 0; k < spawned; ++k) {
+        const uint32_t i = e->count++;
+        e->px[i] = cfg->position.x + cfg->positionSpread.x * _particles_random(e);
+        e->py[i] = cfg->position.y + cfg->positionSpread.y * _particles_random(e);
+        e->pz[i] = cfg->position.z + cfg->positionSpread.z * _particles_random(e);
+        e->vx[i] = cfg->velocity.x + cfg->velocitySpread.x * _particles_random(e);
+        e->vy[i] = cfg->velocity.y + cfg->velocitySpread.y * _particles_random(e);
+        e->vz[i] = cfg->velocity.z + cfg->velocitySpread.z * _particles_random(e);
+        e->age[i] = 0.0f;
+        e->life[i] = fmaxf(cfg->life + cfg->lifeSpread * _particles_random(e), PARTICLES_MIN_LIFE);
+        e->startScale[i] = cfg->startScale;
+        e->endScale[i] = cfg->endScale;
+        e->startColor[i] = cfg->startColor;
+        e->endColor[i] = cfg->endColor;
+    }
+    return spawned;
+}
+
+void particles_emitter_clear(ParticlesEmitter *e) {
+    e->count = 0;
+    e->spawnAccumulator = 0.0f;
+}
+
+void particles_emitter_update(ParticlesEmitter *e, Scene *sc, const float dt) {
+    if (dt <= 0.0f) {
+        return;
+    }
+
+    if (e->config.rate > 0.0f) {
+        e->spawnAccumulator += e->config.rate * dt;
+        const uint32_t n = (uint32_t)e->spawnAccumulator;
+        e->spawnAccumulator -= (float)n;
+        particles_emitter_spawn(e, n);
+    }
+
+    float *age = e->age;
+    const float *life = e->life;
+    for (uint32_t i = 0; i < e->count; ++i) {
+        age[i] += dt;
+    }
+    for (uint32_t i = e->count; i > 0; --i) {
+        if (age[i - 1] >= life[i - 1]) {
+            _particles_remove(e, i - 1);
+        }
+    }
+    const uint32_t count = e->count;
+    if (count == 0) {
+        return;
+    }
+
+    float *vx = e->vx, *vy = e->vy, *vz = e->vz;
+    const float3 dv = {e->config.acceleration.x * dt,
+                       e->config.acceleration.y * dt,
+                       e->config.acceleration.z * dt};
+    const float damping = fmaxf(1.0f - e->config.drag * dt, 0.0f);
+    for (uint32_t i = 0; i < count; ++i) {
+        vx[i] = (vx[i] + dv.x) * damping;
+        vy[i] = (vy[i] + dv.y) * damping;
+        vz[i] = (vz[i] + dv.z) * damping;
+    }
+
+    if (sc != NULL && e->config.collidesWith != PHYSICS_GROUP_NONE) {
+        _particles_gather_colliders(e, sc, dt);
+        if (e->nbColliders > 0) {
+            for (uint32_t i = 0; i < count; ++i) {
+                _particles_move_colliding(e, i, dt);
+            }
+            return;
+        }
+    }
+
+    float *px = e->px, *py = e->py, *pz = e->pz;
+    for (uint32_t i = 0; i < count; ++i) {
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        pz[i] += vz[i] * dt;
+    }
+}
+
+uint32_t particles_emitter_get_count(const ParticlesEmitter *e) {
+    return e->count;
+}
+
+uint32_t particles_emitter_write_instances(const ParticlesEmitter *e,
+                                           ParticlesInstance *instances,
+                                           const uint32_t max) {
+    const uint32_t n = e->count < max ? e->count : max;
+    for (uint32_t i = 0; i < n; ++i) {
+        const float t = e->age[i] / e->life[i];
+        instances[i] = (ParticlesInstance){
+            e->px[i],
+            e->py[i],
+            e->pz[i],
+            e->startScale[i] + (e->endScale[i] - e->startScale[i]) * t,
+            _particles_color_lerp(e->startColor[i], e->endColor[i], t)};
+    }
+    return n;
+}
+
+void particles_get_mesh(const ParticlesMesh mesh,
+                        const float **vertices,
+                        uint32_t *nbVertices,
+                        const uint16_t **indices,
+                        uint32_t *nbIndices) {
+    if (mesh == ParticlesMesh_Quad) {
+        *vertices = _particles_quad_vertices;
+        *nbVertices = 4;
+        *indices = _particles_quad_indices;
+        *nbIndices = 6;
+    } else {
+        *vertices = _particles_cube_vertices;
+        *nbVertices = 8;
+        *indices = _particles_cube_indices;
+        *nbIndices = 36;
+    }
+}
@@ -0,0 +1,102 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  particles.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+// Particles simulated by the engine, without a Shape or an Object for each of them.
+//
+// An emitter owns a fixed capacity pool of particles stored as structure of arrays (positions,
+// velocities, colors, life), alive particles being packed at the start of the arrays. Each update
+// integrates all particles in a few tight loops over these arrays, that the compiler vectorizes.
+// Dead particles are replaced by the last alive one.
+//
+// Particles may collide with scene rigidbodies: a single r-tree query per update gathers colliders
+// overlapping the trajectories of all particles. Particles then move one world axis at a time,
+// bouncing off blocks of per-block shapes & off colliders of other rigidbodies.
+//
+// Renderers draw particles as instances of a unit mesh, see particles_emitter_write_instances.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "colors.h"
+#include "float3.h"
+#include "scene.h"
+
+// colliders considered per update, extra ones are ignored
+#define PARTICLES_MAX_COLLIDERS 32
+
+typedef struct _ParticlesEmitter ParticlesEmitter;
+
+typedef enum {
+    ParticlesMesh_Quad = 0,
+    ParticlesMesh_Cube = 1
+} ParticlesMesh;
+
+/// Applied to particles spawned after it is modified. Spreads are random offsets within
+/// [-spread, spread] added to each particle's value.
+typedef struct {
+    float3 position; // world space
+    float3 positionSpread;
+    float3 velocity;
+    float3 velocitySpread;
+    float3 acceleration; // eg. gravity
+    RGBAColor startColor, endColor; // interpolated over particle life
+    float life, lifeSpread; // seconds
+    float startScale, endScale;
+    float drag;       // velocity ratio lost per second
+    float bounciness; // velocity ratio kept when bouncing
+    float rate;       // particles spawned per second in particles_emitter_update
+    uint16_t collidesWith; // groups of scene rigidbodies particles collide with, 0 for none
+    uint8_t mesh;          // ParticlesMesh, for renderers
+    char pad[1];
+} ParticlesEmitterConfig;
+
+/// Per-particle data for instanced drawing
+typedef struct {
+    float x, y, z;
+    float scale;
+    RGBAColor color;
+} ParticlesInstance;
+
+/// `seed` makes spawned particles random values reproducible
+ParticlesEmitter *particles_emitter_new(const uint32_t capacity, const uint32_t seed);
+void particles_emitter_free(ParticlesEmitter *e);
+
+ParticlesEmitterConfig *particles_emitter_get_config(ParticlesEmitter *e);
+
+/// Returns the amount of spawned particles, limited by the emitter's capacity
+uint32_t particles_emitter_spawn(ParticlesEmitter *e, const uint32_t n);
+
+/// Removes all particles
+void particles_emitter_clear(ParticlesEmitter *e);
+
+/// Spawns particles at config rate, removes dead particles & moves others. To be called after
+/// scene_refresh, particles collide with its rigidbodies if `sc` isn't NULL.
+void particles_emitter_update(ParticlesEmitter *e, Scene *sc, const float dt);
+
+uint32_t particles_emitter_get_count(const ParticlesEmitter *e);
+
+/// Writes at most `max` instances with current particle colors & scales, returns amount written
+uint32_t particles_emitter_write_instances(const ParticlesEmitter *e,
+                                           ParticlesInstance *instances,
+                                           const uint32_t max);
+
+/// Unit mesh centered on origin that instances are drawn with: vertex positions (x, y, z) &
+/// triangle indices. Quad faces -z, to be oriented towards the camera.
+void particles_get_mesh(const ParticlesMesh mesh,
+                        const float **vertices,
+                        uint32_t *nbVertices,
+                        const uint16_t **indices,
+                        uint32_t *nbIndices);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,1237 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  pathfinding.c
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#include "pathfinding.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cclog.h"
+#include "chunk.h"
+#include "fifo_list.h"
+#include "filo_list_uint32.h"
+#include "hash_uint32_int.h"
+#include "index3d.h"
+#include "mutex.h"
+#include "profiler.h"
+#include "thread.h"
+
+#define PATHFINDING_NO_MOVE INT8_MIN
+#define PATHFINDING_UNREACHABLE UINT32_MAX
+#define PATHFINDING_ROW ((1ull << CHUNK_SIZE) - 1)
+// abstract nodes are keyed by cluster id & cell index
+#define PATHFINDING_CELL_BITS 12
+#define PATHFINDING_MAX_CLUSTERS (1u << (32 - PATHFINDING_CELL_BITS))
+// cached costs from cells to exits per cluster, cache is cleared when full
+#define PATHFINDING_MAX_CACHED_ENTRIES 64
+
+#if CHUNK_SIZE_CUBE > (1 << PATHFINDING_CELL_BITS)
+#error "pathfinding: cell index has to fit in PATHFINDING_CELL_BITS"
+#endif
+
+// horizontal moves directions
+static const int8_t pathfinding_dx[4] = {1, -1, 0, 0};
+static const int8_t pathfinding_dz[4] = {0, 0, 1, -1};
+
+// representative move of a portal, from a cell of the cluster to a cell of a neighbor cluster
+typedef struct {
+    uint32_t cost;
+    uint16_t from; // cell index in cluster
+    uint16_t to;   // cell index in target cluster
+    int8_t offset[3];
+    char pad[5];
+} PathfindingExit;
+
+// costs from a cell to all exits of its cluster
+typedef struct {
+    uint32_t *costs;
+    uint16_t cell;
+    char pad[6];
+} PathfindingEntry;
+
+typedef struct {
+    // chunk the solid mask was copied from, never accessed, NULL if no chunk at these coords
+    const Chunk *chunk;
+    uint64_t version;
+    // walkable cells indexes, by rank
+    uint16_t *cells;
+    // 4 moves per walkable cell, by rank: height difference or PATHFINDING_NO_MOVE
+    int8_t *moves;
+    PathfindingExit *exits;
+    PathfindingEntry *entries;
+    SHAPE_COORDS_INT3_T coords; // in chunks
+    uint16_t nbWalkable;
+    uint16_t nbExits;
+    uint16_t nbEntries;
+    uint32_t id;
+    // last update seeing the chunk
+    uint32_t epoch;
+    bool dirty;
+    char pad[3];
+    // walkable cells before each mask word
+    uint16_t ranks[CHUNK_MASK_WORDS];
+    uint64_t solid[CHUNK_MASK_WORDS];
+    uint64_t walkable[CHUNK_MASK_WORDS];
+} PathfindingCluster;
+
+// walkable cells, moves & exits of a cluster, built without holding pf->graph, then published
+typedef struct {
+    PathfindingCluster *cluster;
+    uint16_t *cells;
+    int8_t *moves;
+    PathfindingExit *exits;
+    uint16_t nbWalkable;
+    uint16_t nbExits;
+    char pad[4];
+    uint16_t ranks[CHUNK_MASK_WORDS];
+    uint64_t walkable[CHUNK_MASK_WORDS];
+} PathfindingClusterBuild;
+
+typedef struct {
+    uint64_t *items;
+    uint32_t count;
+    uint32_t capacity;
+} PathfindingHeap;
+
+// abstract search node: a cell of a cluster, reached through a portal
+typedef struct {
+    PathfindingCluster *cluster;
+    uint32_t g;
+    int32_t parent;
+    int32_t exit; // exit of parent cluster leading to this node, -1 if reached within cluster
+    uint16_t cell;
+    bool closed;
+    char pad[1];
+} PathfindingNode;
+
+typedef struct {
+    SHAPE_COORDS_INT3_T start;
+    SHAPE_COORDS_INT3_T goal;
+    uint32_t id;
+} PathfindingRequest;
+
+struct _Pathfinding {
+    Shape *map;
+    Thread *thread;
+    ThreadCondition *condition;
+    // requests & results are protected by condition
+    FifoList *requests;
+    FifoList *results;
+    // clusters & search scratch are protected by graph, only written by the thread calling
+    // pathfinding_update (solid masks & dirty flags aren't read by searches)
+    Mutex *graph;
+    // chunk coordinates -> PathfindingCluster
+    Index3D *clusters;
+    PathfindingCluster **clustersById;
+    FiloListUInt32 *freeIds;
+    // cluster search scratch, by rank
+    uint32_t *dist;
+    uint16_t *prev;
+    PathfindingHeap heap;
+    uint32_t nbClusters;
+    uint32_t clustersCapacity;
+    uint32_t nbBuilds;
+    uint32_t epoch;
+    uint32_t nextId;
+    uint8_t agentHeight;
+    // protected by condition
+    bool busy;
+    bool stop;
+    char pad[1];
+};
+
+// MARK: - Utils -
+
+static uint32_t _pathfinding_popcount(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_popcountll(v);
+#else
+    v = v - ((v >> 1) & 0x5555555555555555ull);
+    v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (uint32_t)((v * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+static uint16_t _pathfinding_index(const int x, const int y, const int z) {
+    return (uint16_t)(x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQR);
+}
+
+static bool _pathfinding_is_walkable(const PathfindingCluster *c, const uint16_t i) {
+    return (c->walkable[i >> 6] >> (i & 63)) & 1;
+}
+
+static uint16_t _pathfinding_rank(const PathfindingCluster *c, const uint16_t i) {
+    const uint64_t below = c->walkable[i >> 6] & ((1ull << (i & 63)) - 1);
+    return (uint16_t)(c->ranks[i >> 6] + _pathfinding_popcount(below));
+}
+
+static uint32_t _pathfinding_move_cost(const int8_t dy) {
+    if (dy > 0) {
+        return PATHFINDING_COST_MOVE + PATHFINDING_COST_STEP_UP;
+    }
+    return PATHFINDING_COST_MOVE + (uint32_t)(-dy) * PATHFINDING_COST_DROP_PER_BLOCK;
+}
+
+static SHAPE_COORDS_INT3_T _pathfinding_cell_coords(const PathfindingCluster *c, const uint16_t i) {
+    return (SHAPE_COORDS_INT3_T){
+        (SHAPE_COORDS_INT_T)(c->coords.x * CHUNK_SIZE + i % CHUNK_SIZE),
+        (SHAPE_COORDS_INT_T)(c->coords.y * CHUNK_SIZE + (i / CHUNK_SIZE) % CHUNK_SIZE),
+        (SHAPE_COORDS_INT_T)(c->coords.z * CHUNK_SIZE + i / CHUNK_SIZE_SQR)};
+}
+
+static bool _pathfinding_heap_push(PathfindingHeap *h, const uint64_t item) {
+    if (h->count == h->capacity) {
+        const uint32_t capacity = h->capacity == 0 ? 256 : h->capacity * 2;
+        uint64_t *items = (uint64_t *)realloc(h->items, capacity * sizeof(uint64_t));
+        if (items == NULL) {
+            return false;
+        }
+        h->items = items;
+        h->capacity = capacity;
+    }
+    uint32_t i = h->count++;
+    while (i > 0 && h->items[(i - 1) / 2] > item) {
+        h->items[i] = h->items[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->items[i] = item;
+    return true;
+}
+
+static uint64_t _pathfinding_heap_pop(PathfindingHeap *h) {
+    const uint64_t top = h->items[0];
+    const uint64_t last = h->items[--h->count];
+    uint32_t i = 0;
+    while (true) {
+        uint32_t child = 2 * i + 1;
+        if (child >= h->count) {
+            break;
+        }
+        if (child + 1 < h->count && h->items[child + 1] < h->items[child]) {
+            ++child;
+        }
+        if (h->items[child] >= last) {
+            break;
+        }
+        h->items[i] = h->items[child];
+        i = child;
+    }
+    if (h->count > 0) {
+        h->items[i] = last;
+    }
+    return top;
+}
+
+// MARK: - Clusters -
+
+static PathfindingCluster *_pathfinding_get_cluster(const Pathfinding *pf,
+                                                    const int32_t x,
+                                                    const int32_t y,
+                                                    const int32_t z) {
+    return (PathfindingCluster *)index3d_get(pf->clusters, x, y, z);
+}
+
+static void _pathfinding_cluster_flush_entries(PathfindingCluster *c) {
+    for (uint16_t i = 0; i < c->nbEntries; ++i) {
+        free(c->entries[i].costs);
+    }
+    c->nbEntries = 0;
+}
+
+static PathfindingCluster *_pathfinding_cluster_new(Pathfinding *pf,
+                                                    const SHAPE_COORDS_INT3_T coords) {
+    uint32_t id;
+    if (filo_list_uint32_pop(pf->freeIds, &id) == false) {
+        if (pf->nbClusters >= PATHFINDING_MAX_CLUSTERS) {
+            cclog_error("pathfinding: too many clusters");
+            return NULL;
+        }
+        id = pf->nbClusters;
+        if (id == pf->clustersCapacity) {
+            const uint32_t capacity = pf->clustersCapacity == 0 ? 64 : pf->clustersCapacity * 2;
+            PathfindingCluster **clusters = (PathfindingCluster **)
+                realloc(pf->clustersById, capacity * sizeof(PathfindingCluster *));
+            if (clusters == NULL) {
+                return NULL;
+            }
+            pf->clustersById = clusters;
+            pf->clustersCapacity = capacity;
+        }
+    }
+    PathfindingCluster *c = (PathfindingCluster *)malloc(sizeof(PathfindingCluster));
+    if (c == NULL) {
+        filo_list_uint32_push(pf->freeIds, id);
+        return NULL;
+    }
+    c->chunk = NULL;
+    c->version = 0;
+    c->cells = NULL;
+    c->moves = NULL;
+    c->exits = NULL;
+    c->entries = (PathfindingEntry *)malloc(PATHFINDING_MAX_CACHED_ENTRIES *
+                                            sizeof(PathfindingEntry));
+    c->coords = coords;
+    c->nbWalkable = 0;
+    c->nbExits = 0;
+    c->nbEntries = 0;
+    c->id = id;
+    c->epoch = pf->epoch;
+    c->dirty = true;
+    memset(c->ranks, 0, sizeof(c->ranks));
+    memset(c->solid, 0, sizeof(c->solid));
+    memset(c->walkable, 0, sizeof(c->walkable));
+
+    if (id == pf->nbClusters) {
+        ++pf->nbClusters;
+    }
+    pf->clustersById[id] = c;
+    index3d_insert(pf->clusters, c, coords.x, coords.y, coords.z, NULL);
+    return c;
+}
+
+static void _pathfinding_cluster_free(Pathfinding *pf, PathfindingCluster *c) {
+    index3d_remove(pf->clusters, c->coords.x, c->coords.y, c->coords.z, NULL);
+    pf->clustersById[c->id] = NULL;
+    filo_list_uint32_push(pf->freeIds, c->id);
+    _pathfinding_cluster_flush_entries(c);
+    free(c->entries);
+    free(c->cells);
+    free(c->moves);
+    free(c->exits);
+    free(c);
+}
+
+static PathfindingCluster *_pathfinding_get_or_create_cluster(Pathfinding *pf,
+                                                              const SHAPE_COORDS_INT3_T coords) {
+    PathfindingCluster *c = _pathfinding_get_cluster(pf, coords.x, coords.y, coords.z);
+    return c != NULL ? c : _pathfinding_cluster_new(pf, coords);
+}
+
+/// Moves of a cluster depend on solid blocks of its direct neighbors
+static void _pathfinding_set_neighborhood_dirty(Pathfinding *pf, const SHAPE_COORDS_INT3_T coords) {
+    for (int32_t z = -1; z <= 1; ++z) {
+        for (int32_t y = -1; y <= 1; ++y) {
+            for (int32_t x = -1; x <= 1; ++x) {
+                PathfindingCluster *c = _pathfinding_get_cluster(pf,
+                                                                 coords.x + x,
+                                                                 coords.y + y,
+                                                                 coords.z + z);
+                if (c != NULL) {
+                    c->dirty = true;
+                }
+            }
+        }
+    }
+}
+
+/// x, y, z relative to the center cluster of the neighborhood, in [-CHUNK_SIZE, 2 * CHUNK_SIZE)
+static bool _pathfinding_is_solid(const uint64_t *const *neighborhood,
+                                  const int x,
+                                  const int y,
+                                  const int z) {
+    const int ox = (x + CHUNK_SIZE) / CHUNK_SIZE;
+    const int oy = (y + CHUNK_SIZE) / CHUNK_SIZE;
+    const int oz = (z + CHUNK_SIZE) / CHUNK_SIZE;
+    const uint64_t *mask = neighborhood[ox + oy * 3 + oz * 9];
+    if (mask == NULL) {
+        return false;
+    }
+    const uint16_t i = _pathfinding_index(x - (ox - 1) * CHUNK_SIZE,
+                                          y - (oy - 1) * CHUNK_SIZE,
+                                          z - (oz - 1) * CHUNK_SIZE);
+    return (mask[i >> 6] >> (i & 63)) & 1;
+}
+
+/// Solid blocks of a row along x in the center column of the neighborhood
+static uint64_t _pathfinding_solid_row(const uint64_t *const *neighborhood,
+                                       const int y,
+                                       const int z) {
+    const int oy = (y + CHUNK_SIZE) / CHUNK_SIZE;
+    const uint64_t *mask = neighborhood[1 + oy * 3 + 9];
+    if (mask == NULL) {
+        return 0;
+    }
+    const uint16_t i = _pathfinding_index(0, y - (oy - 1) * CHUNK_SIZE, z);
+    return (mask[i >> 6] >> (i & 63)) & PATHFINDING_ROW;
+}
+
+static bool _pathfinding_can_stand(const uint64_t *const *neighborhood,
+                                   const uint8_t height,
+                                   const int x,
+                                   const int y,
+                                   const int z) {
+    if (_pathfinding_is_solid(neighborhood, x, y - 1, z) == false) {
+        return false;
+    }
+    for (int k = 0; k < height; ++k) {
+        if (_pathfinding_is_solid(neighborhood, x, y + k, z)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @returns height difference of the move from given cell in given direction, or
+/// PATHFINDING_NO_MOVE
+static int8_t _pathfinding_compute_move(const uint64_t *const *neighborhood,
+                                        const uint8_t height,
+                                        const int x,
+                                        const int y,
+                                        const int z,
+                                        const int dir) {
+    const int tx = x + pathfinding_dx[dir];
+    const int tz = z + pathfinding_dz[dir];
+
+    // step up on the block in front, if there's room to do so above agent's head
+    if (_pathfinding_is_solid(neighborhood, tx, y, tz)) {
+        if (_pathfinding_can_stand(neighborhood, height, tx, y + 1, tz) &&
+            _pathfinding_is_solid(neighborhood, x, y + height, z) == false) {
+            return 1;
+        }
+        return PATHFINDING_NO_MOVE;
+    }
+
+    // agent has to fit in front
+    for (int k = 1; k < height; ++k) {
+        if (_pathfinding_is_solid(neighborhood, tx, y + k, tz)) {
+            return PATHFINDING_NO_MOVE;
+        }
+    }
+
+    // lands on the first solid block below
+    for (int d = 0; d <= PATHFINDING_MAX_DROP; ++d) {
+        if (_pathfinding_is_solid(neighborhood, tx, y - d - 1, tz)) {
+            return (int8_t)-d;
+        }
+    }
+    return PATHFINDING_NO_MOVE;
+}
+
+typedef struct {
+    uint32_t cost;
+    int32_t group;
+    uint16_t from;
+    uint16_t to;
+    int8_t offset[3];
+    int8_t dy;
+    uint8_t dir;
+    char pad[3];
+} PathfindingCandidate;
+
+static bool _pathfinding_cells_adjacent(const uint16_t a, const uint16_t b) {
+    const int d = abs(a % CHUNK_SIZE - b % CHUNK_SIZE) +
+                  abs((a / CHUNK_SIZE) % CHUNK_SIZE - (b / CHUNK_SIZE) % CHUNK_SIZE) +
+                  abs(a / CHUNK_SIZE_SQR - b / CHUNK_SIZE_SQR);
+    return d == 1;
+}
+
+/// Moves of a portal all have the same cost & lead to contiguous cells: any of them can stand for
+/// the others (e.g. a border half level, half cliff gives 2 portals)
+static bool _pathfinding_candidates_adjacent(const PathfindingCandidate *a,
+                                             const PathfindingCandidate *b) {
+    if (a->dir != b->dir || a->dy != b->dy || a->offset[0] != b->offset[0] ||
+        a->offset[1] != b->offset[1] || a->offset[2] != b->offset[2]) {
+        return false;
+    }
+    return _pathfinding_cells_adjacent(a->from, b->from) &&
+           _pathfinding_cells_adjacent(a->to, b->to);
+}
+
+/// Groups moves leaving the cluster in portals, keeping one representative move per portal
+static void _pathfinding_cluster_build_exits(PathfindingClusterBuild *b,
+                                             PathfindingCandidate *candidates,
+                                             const uint32_t nbCandidates) {
+    int32_t *stack = (int32_t *)malloc(nbCandidates * sizeof(int32_t) + 1);
+    uint16_t nbGroups = 0;
+    for (uint32_t i = 0; i < nbCandidates; ++i) {
+        candidates[i].group = -1;
+    }
+    for (uint32_t i = 0; i < nbCandidates; ++i) {
+        if (candidates[i].group >= 0) {
+            continue;
+        }
+        // flood contiguous moves
+        uint32_t size = 0;
+        candidates[i].group = nbGroups;
+        stack[size++] = (int32_t)i;
+        while (size > 0) {
+            const PathfindingCandidate *a = &candidates[stack[--size]];
+            for (uint32_t j = i + 1; j < nbCandidates; ++j) {
+                if (candidates[j].group < 0 &&
+                    _pathfinding_candidates_adjacent(a, &candidates[j])) {
+                    candidates[j].group = nbGroups;
+                    stack[size++] = (int32_t)j;
+                }
+            }
+        }
+        ++nbGroups;
+    }
+    free(stack);
+
+    b->exits = (PathfindingExit *)malloc(nbGroups * sizeof(PathfindingExit) + 1);
+    b->nbExits = nbGroups;
+
+    // representative is the move closest to the center of the portal
+    for (uint16_t g = 0; g < nbGroups; ++g) {
+        int sx = 0, sy = 0, sz = 0, n = 0;
+        for (uint32_t i = 0; i < nbCandidates; ++i) {
+            if (candidates[i].group == g) {
+                sx += candidates[i].from % CHUNK_SIZE;
+                sy += (candidates[i].from / CHUNK_SIZE) % CHUNK_SIZE;
+                sz += candidates[i].from / CHUNK_SIZE_SQR;
+                ++n;
+            }
+        }
+        const PathfindingCandidate *best = NULL;
+        int bestDistance = INT32_MAX;
+        for (uint32_t i = 0; i < nbCandidates; ++i) {
+            if (candidates[i].group == g) {
+                const int dx = (candidates[i].from % CHUNK_SIZE) * n - sx;
+                const int dy = ((candidates[i].from / CHUNK_SIZE) % CHUNK_SIZE) * n - sy;
+                const int dz = (candidates[i].from / CHUNK_SIZE_SQR) * n - sz;
+                const int distance = dx * dx + dy * dy + dz * dz;
+                if (distance < bestDistance) {
+                    best = &candidates[i];
+                    bestDistance = distance;
+                }
+            }
+        }
+        PathfindingExit *e = &b->exits[g];
+        e->cost = best->cost;
+        e->from = best->from;
+        e->to = best->to;
+        memcpy(e->offset, best->offset, sizeof(e->offset));
+    }
+}
+
+/// Reads solid masks of the cluster & its neighbors, doesn't modify clusters
+static void _pathfinding_cluster_build(const Pathfinding *pf, PathfindingClusterBuild *b) {
+    const PathfindingCluster *c = b->cluster;
+    const uint64_t *neighborhood[27];
+    for (int32_t z = -1; z <= 1; ++z) {
+        for (int32_t y = -1; y <= 1; ++y) {
+            for (int32_t x = -1; x <= 1; ++x) {
+                const PathfindingCluster *n = _pathfinding_get_cluster(pf,
+                                                                       c->coords.x + x,
+                                                                       c->coords.y + y,
+                                                                       c->coords.z + z);
+                neighborhood[(x + 1) + (y + 1) * 3 + (z + 1) * 9] = n != NULL && n->chunk != NULL
+                                                                        ? n->solid
+                                                                        : NULL;
+            }
+        }
+    }
+    const uint8_t height = pf->agentHeight;
+
+    // walkable cells: solid below, air for agent's height
+    memset(b->walkable, 0, sizeof(b->walkable));
+    for (int z = 0; z < CHUNK_SIZE; ++z) {
+        for (int y = 0; y < CHUNK_SIZE; ++y) {
+            uint64_t row = _pathfinding_solid_row(neighborhood, y - 1, z);
+            for (int k = 0; k < height && row != 0; ++k) {
+                row &= ~_pathfinding_solid_row(neighborhood, y + k, z);
+            }
+            const uint16_t i = _pathfinding_index(0, y, z);
+            b->walkable[i >> 6] |= row << (i & 63);
+        }
+    }
+    uint16_t nbWalkable = 0;
+    for (int w = 0; w < CHUNK_MASK_WORDS; ++w) {
+        b->ranks[w] = nbWalkable;
+        nbWalkable = (uint16_t)(nbWalkable + _pathfinding_popcount(b->walkable[w]));
+    }
+    b->nbWalkable = nbWalkable;
+
+    b->cells = (uint16_t *)malloc(nbWalkable * sizeof(uint16_t) + 1);
+    b->moves = (int8_t *)malloc(nbWalkable * 4 * sizeof(int8_t) + 1);
+    PathfindingCandidate *candidates = (PathfindingCandidate *)
+        malloc(nbWalkable * 4 * sizeof(PathfindingCandidate) + 1);
+    uint32_t nbCandidates = 0;
+
+    uint16_t r = 0;
+    for (uint16_t i = 0; i < CHUNK_SIZE_CUBE; ++i) {
+        if (((b->walkable[i >> 6] >> (i & 63)) & 1) == 0) {
+            continue;
+        }
+        const int x = i % CHUNK_SIZE, y = (i / CHUNK_SIZE) % CHUNK_SIZE, z = i / CHUNK_SIZE_SQR;
+        b->cells[r] = i;
+        for (uint8_t dir = 0; dir < 4; ++dir) {
+            const int8_t dy = _pathfinding_compute_move(neighborhood, height, x, y, z, dir);
+            b->moves[r * 4 + dir] = dy;
+            if (dy == PATHFINDING_NO_MOVE) {
+                continue;
+            }
+            const int tx = x + pathfinding_dx[dir], ty = y + dy, tz = z + pathfinding_dz[dir];
+            const int8_t ox = (int8_t)(tx < 0 ? -1 : (tx >= CHUNK_SIZE ? 1 : 0));
+            const int8_t oy = (int8_t)(ty < 0 ? -1 : (ty >= CHUNK_SIZE ? 1 : 0));
+            const int8_t oz = (int8_t)(tz < 0 ? -1 : (tz >= CHUNK_SIZE ? 1 : 0));
+            if (ox != 0 || oy != 0 || oz != 0) {
+                PathfindingCandidate *candidate = &candidates[nbCandidates++];
+                candidate->cost = _pathfinding_move_cost(dy);
+                candidate->from = i;
+                candidate->to = _pathfinding_index(tx - ox * CHUNK_SIZE,
+                                                   ty - oy * CHUNK_SIZE,
+                                                   tz - oz * CHUNK_SIZE);
+                candidate->offset[0] = ox;
+                candidate->offset[1] = oy;
+                candidate->offset[2] = oz;
+                candidate->dy = dy;
+                candidate->dir = dir;
+            }
+        }
+        ++r;
+    }
+
+    _pathfinding_cluster_build_exits(b, candidates, nbCandidates);
+    free(candidates);
+}
+
+/// Swaps built data with the cluster's, graph has to be locked. Previous data is left in `b`.
+static void _pathfinding_cluster_publish(PathfindingClusterBuild *b) {
+    PathfindingCluster *c = b->cluster;
+    uint16_t *cells = c->cells;
+    int8_t *moves = c->moves;
+    PathfindingExit *exits = c->exits;
+    c->cells = b->cells;
+    c->moves = b->moves;
+    c->exits = b->exits;
+    c->nbWalkable = b->nbWalkable;
+    c->nbExits = b->nbExits;
+    memcpy(c->ranks, b->ranks, sizeof(c->ranks));
+    memcpy(c->walkable, b->walkable, sizeof(c->walkable));
+    b->cells = cells;
+    b->moves = moves;
+    b->exits = exits;
+    _pathfinding_cluster_flush_entries(c);
+}
+
+// MARK: - Search -
+
+/// Dijkstra within a cluster from given cell, stopping once `to` is reached if not UINT16_MAX.
+/// Fills pf->dist & pf->prev, by rank.
+static void _pathfinding_cluster_search(Pathfinding *pf,
+                                        const PathfindingCluster *c,
+                                        const uint16_t from,
+                                        const uint16_t to) {
+    for (uint16_t r = 0; r < c->nbWalkable; ++r) {
+        pf->dist[r] = PATHFINDING_UNREACHABLE;
+    }
+    const uint16_t fromRank = _pathfinding_rank(c, from);
+    const uint16_t toRank = to != UINT16_MAX ? _pathfinding_rank(c, to) : UINT16_MAX;
+    pf->dist[fromRank] = 0;
+    pf->heap.count = 0;
+    _pathfinding_heap_push(&pf->heap, fromRank);
+
+    while (pf->heap.count > 0) {
+        const uint64_t item = _pathfinding_heap_pop(&pf->heap);
+        const uint32_t cost = (uint32_t)(item >> 16);
+        const uint16_t r = (uint16_t)(item & 0xFFFF);
+        if (cost > pf->dist[r]) {
+            continue;
+        }
+        if (r == toRank) {
+            break;
+        }
+        const uint16_t i = c->cells[r];
+        const int x = i % CHUNK_SIZE, y = (i / CHUNK_SIZE) % CHUNK_SIZE, z = i / CHUNK_SIZE_SQR;
+        for (uint8_t dir = 0; dir < 4; ++dir) {
+            const int8_t dy = c->moves[r * 4 + dir];
+            if (dy == PATHFINDING_NO_MOVE) {
+                continue;
+            }
+            const int tx = x + pathfinding_dx[dir], ty = y + dy, tz = z + pathfinding_dz[dir];
+            if (tx < 0 || tx >= CHUNK_SIZE || ty < 0 || ty >= CHUNK_SIZE || tz < 0 ||
+                tz >= CHUNK_SIZE) {
+                continue;
+            }
+            const uint16_t tr = _pathfinding_rank(c, _pathfinding_index(tx, ty, tz));
+            const uint32_t newCost = cost + _pathfinding_move_cost(dy);
+            if (newCost < pf->dist[tr]) {
+                pf->dist[tr] = newCost;
+                pf->prev[tr] = r;
+                _pathfinding_heap_push(&pf->heap, (uint64_t)newCost << 16 | tr);
+            }
+        }
+    }
+}
+
+/// Costs from given cell to all exits of the cluster, cached
+static const uint32_t *_pathfinding_get_exit_costs(Pathfinding *pf,
+                                                   PathfindingCluster *c,
+                                                   const uint16_t cell) {
+    for (uint16_t i = 0; i < c->nbEntries; ++i) {
+        if (c->entries[i].cell == cell) {
+            return c->entries[i].costs;
+        }
+    }
+    if (c->nbEntries == PATHFINDING_MAX_CACHED_ENTRIES) {
+        _pathfinding_cluster_flush_entries(c);
+    }
+
+    _pathfinding_cluster_search(pf, c, cell, UINT16_MAX);
+    uint32_t *costs = (uint32_t *)malloc(c->nbExits * sizeof(uint32_t) + 1);
+    for (uint16_t e = 0; e < c->nbExits; ++e) {
+        const uint32_t d = pf->dist[_pathfinding_rank(c, c->exits[e].from)];
+        costs[e] = d != PATHFINDING_UNREACHABLE ? d + c->exits[e].cost : PATHFINDING_UNREACHABLE;
+    }
+    PathfindingEntry *entry = &c->entries[c->nbEntries++];
+    entry->cell = cell;
+    entry->costs = costs;
+    return costs;
+}
+
+/// Finds a walkable cell at or below given position
+static bool _pathfinding_snap(const Pathfinding *pf,
+                              const SHAPE_COORDS_INT3_T coords,
+                              PathfindingCluster **cluster,
+                              uint16_t *cell) {
+    for (int d = 0; d <= PATHFINDING_SNAP_DEPTH; ++d) {
+        const SHAPE_COORDS_INT3_T p = {coords.x, (SHAPE_COORDS_INT_T)(coords.y - d), coords.z};
+        const SHAPE_COORDS_INT3_T co = chunk_utils_get_coords(p);
+        PathfindingCluster *c = _pathfinding_get_cluster(pf, co.x, co.y, co.z);
+        if (c == NULL) {
+            continue;
+        }
+        const CHUNK_COORDS_INT3_T local = chunk_utils_get_coords_in_chunk(p);
+        const uint16_t i = _pathfinding_index(local.x, local.y, local.z);
+        if (_pathfinding_is_walkable(c, i)) {
+            *cluster = c;
+            *cell = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Appends cells of the path within a cluster, `from` excluded
+static bool _pathfinding_append_cluster_path(Pathfinding *pf,
+                                             const PathfindingCluster *c,
+                                             const uint16_t from,
+                                             const uint16_t to,
+                                             PathfindingResult *result,
+                                             uint32_t *capacity) {
+    _pathfinding_cluster_search(pf, c, from, to);
+    const uint16_t fromRank = _pathfinding_rank(c, from);
+    uint16_t r = _pathfinding_rank(c, to);
+    if (pf->dist[r] == PATHFINDING_UNREACHABLE) {
+        return false;
+    }
+    uint32_t n = 0;
+    for (uint16_t k = r; k != fromRank; k = pf->prev[k]) {
+        ++n;
+    }
+    if (result->nbCells + n > *capacity) {
+        *capacity = (result->nbCells + n) * 2;
+        SHAPE_COORDS_INT3_T *cells = (SHAPE_COORDS_INT3_T *)
+            realloc(result->cells, *capacity * sizeof(SHAPE_COORDS_INT3_T));
+        if (cells == NULL) {
+            return false;
+        }
+        result->cells = cells;
+    }
+    for (uint32_t k = n; k > 0; --k) {
+        result->cells[result->nbCells + k - 1] = _pathfinding_cell_coords(c, c->cells[r]);
+        r = pf->prev[r];
+    }
+    result->nbCells += n;
+    return true;
+}
+
+static uint32_t _pathfinding_heuristic(const SHAPE_COORDS_INT3_T a, const SHAPE_COORDS_INT3_T b) {
+    return (uint32_t)(abs(a.x - b.x) + abs(a.z - b.z)) * PATHFINDING_COST_MOVE;
+}
+
+static int32_t _pathfinding_add_node(HashUInt32Int *index,
+                                     PathfindingNode **nodes,
+                                     uint32_t *nbNodes,
+                                     uint32_t *capacity,
+                                     PathfindingCluster *c,
+                                     const uint16_t cell) {
+    const uint32_t key = c->id << PATHFINDING_CELL_BITS | cell;
+    int value;
+    if (hash_uint32_int_get(index, key, &value)) {
+        return value;
+    }
+    if (*nbNodes == PATHFINDING_MAX_SEARCH_NODES) {
+        return -1;
+    }
+    if (*nbNodes == *capacity) {
+        *capacity *= 2;
+        PathfindingNode *grown = (PathfindingNode *)
+            realloc(*nodes, *capacity * sizeof(PathfindingNode));
+        if (grown == NULL) {
+            return -1;
+        }
+        *nodes = grown;
+    }
+    PathfindingNode *n = &(*nodes)[*nbNodes];
+    n->cluster = c;
+    n->g = PATHFINDING_UNREACHABLE;
+    n->parent = -1;
+    n->exit = -1;
+    n->cell = cell;
+    n->closed = false;
+    hash_uint32_int_set(index, key, (int)*nbNodes);
+    return (int32_t)(*nbNodes)++;
+}
+
+static PathfindingResult *_pathfinding_find(Pathfinding *pf,
+                                            const uint32_t id,
+                                            const SHAPE_COORDS_INT3_T start,
+                                            const SHAPE_COORDS_INT3_T goal) {
+    PROFILER_ZONE_BEGIN("pathfinding_find");
+    PathfindingResult *result = (PathfindingResult *)malloc(sizeof(PathfindingResult));
+    if (result == NULL) {
+        PROFILER_ZONE_END();
+        return NULL;
+    }
+    result->cells = NULL;
+    result->nbCells = 0;
+    result->cost = 0;
+    result->id = id;
+    result->found = false;
+
+    PathfindingCluster *startCluster, *goalCluster;
+    uint16_t startCell, goalCell;
+    if (_pathfinding_snap(pf, start, &startCluster, &startCell) == false ||
+        _pathfinding_snap(pf, goal, &goalCluster, &goalCell) == false) {
+        PROFILER_ZONE_END();
+        return result;
+    }
+    const SHAPE_COORDS_INT3_T goalCoords = _pathfinding_cell_coords(goalCluster, goalCell);
+
+    // abstract search, between portals
+    HashUInt32Int *index = hash_uint32_int_new();
+    PathfindingHeap open = {NULL, 0, 0};
+    uint32_t nbNodes = 0, capacity = 256;
+    PathfindingNode *nodes = (PathfindingNode *)malloc(capacity * sizeof(PathfindingNode));
+    int32_t goalNode = -1;
+
+    int32_t k = _pathfinding_add_node(index, &nodes, &nbNodes, &capacity, startCluster, startCell);
+    nodes[k].g = 0;
+    _pathfinding_heap_push(&open, (uint64_t)k);
+
+    while (open.count > 0) {
+        const int32_t current = (int32_t)(_pathfinding_heap_pop(&open) & 0xFFFFFFFF);
+        if (nodes[current].closed) {
+            continue;
+        }
+        nodes[current].closed = true;
+        PathfindingCluster *c = nodes[current].cluster;
+        const uint16_t cell = nodes[current].cell;
+        if (c == goalCluster && cell == goalCell) {
+            goalNode = current;
+            break;
+        }
+        const uint32_t g = nodes[current].g;
+
+        // through exits of the cluster
+        const uint32_t *costs = _pathfinding_get_exit_costs(pf, c, cell);
+        for (uint16_t e = 0; e < c->nbExits; ++e) {
+            if (costs[e] == PATHFINDING_UNREACHABLE) {
+                continue;
+            }
+            const PathfindingExit *exit = &c->exits[e];
+            PathfindingCluster *target = _pathfinding_get_cluster(pf,
+                                                                  c->coords.x + exit->offset[0],
+                                                                  c->coords.y + exit->offset[1],
+                                                                  c->coords.z + exit->offset[2]);
+            // target may have been rebuilt before this cluster, or not be built yet
+            if (target == NULL || _pathfinding_is_walkable(target, exit->to) == false) {
+                continue;
+            }
+            k = _pathfinding_add_node(index, &nodes, &nbNodes, &capacity, target, exit->to);
+            if (k >= 0 && nodes[k].closed == false && g + costs[e] < nodes[k].g) {
+                nodes[k].g = g + costs[e];
+                nodes[k].parent = current;
+                nodes[k].exit = e;
+                const uint32_t f = nodes[k].g + _pathfinding_heuristic(
+                                                    _pathfinding_cell_coords(target, exit->to),
+                                                    goalCoords);
+                _pathfinding_heap_push(&open, (uint64_t)f << 32 | (uint32_t)k);
+            }
+        }
+
+        // to the goal within the cluster
+        if (c == goalCluster) {
+            _pathfinding_cluster_search(pf, c, cell, goalCell);
+            const uint32_t d = pf->dist[_pathfinding_rank(c, goalCell)];
+            if (d != PATHFINDING_UNREACHABLE) {
+                k = _pathfinding_add_node(index, &nodes, &nbNodes, &capacity, c, goalCell);
+                if (k >= 0 && g + d < nodes[k].g) {
+                    nodes[k].g = g + d;
+                    nodes[k].parent = current;
+                    nodes[k].exit = -1;
+                    _pathfinding_heap_push(&open, (uint64_t)nodes[k].g << 32 | (uint32_t)k);
+                }
+            }
+        }
+    }
+
+    // refine path within each cluster
+    if (goalNode >= 0) {
+        uint32_t n = 0;
+        for (k = goalNode; k >= 0; k = nodes[k].parent) {
+            ++n;
+        }
+        int32_t *chain = (int32_t *)malloc(n * sizeof(int32_t));
+        k = goalNode;
+        for (uint32_t i = n; i > 0; --i) {
+            chain[i - 1] = k;
+            k = nodes[k].parent;
+        }
+
+        uint32_t cellsCapacity = 64;
+        result->cells = (SHAPE_COORDS_INT3_T *)malloc(cellsCapacity * sizeof(SHAPE_COORDS_INT3_T));
+        result->cells[result->nbCells++] = _pathfinding_cell_coords(startCluster, startCell);
+        bool ok = true;
+        for (uint32_t i = 1; i < n && ok; ++i) {
+            const PathfindingNode *a = &nodes[chain[i - 1]];
+            const PathfindingNode *b = &nodes[chain[i]];
+            if (b->exit < 0) {
+                ok = _pathfinding_append_cluster_path(pf,
+                                                      a->cluster,
+                                                      a->cell,
+                                                      b->cell,
+                                                      result,
+                                                      &cellsCapacity);
+                continue;
+            }
+            const PathfindingExit *exit = &a->cluster->exits[b->exit];
+            if (exit->from != a->cell) {
+                ok = _pathfinding_append_cluster_path(pf,
+                                                      a->cluster,
+                                                      a->cell,
+                                                      exit->from,
+                                                      result,
+                                                      &cellsCapacity);
+            }
+            if (ok && result->nbCells == cellsCapacity) {
+                cellsCapacity *= 2;
+                SHAPE_COORDS_INT3_T *cells = (SHAPE_COORDS_INT3_T *)
+                    realloc(result->cells, cellsCapacity * sizeof(SHAPE_COORDS_INT3_T));
+                ok = cells != NULL;
+                if (ok) {
+                    result->cells = cells;
+                }
+            }
+            if (ok) {
+                result->cells[result->nbCells++] = _pathfinding_cell_coords(b->cluster, b->cell);
+            }
+        }
+        free(chain);
+
+        if (ok) {
+            result->found = true;
+            result->cost = nodes[goalNode].g;
+        } else {
+            free(result->cells);
+            result->cells = NULL;
+            result->nbCells = 0;
+        }
+    }
+
+    free(nodes);
+    free(open.items);
+    hash_uint32_int_free(index);
+    PROFILER_ZONE_END();
+    return result;
+}
+
+// MARK: - Background thread -
+
+/// Resolves a batch of requests, if any. Condition has to be locked, it is unlocked while
+/// resolving. Returns false if there were no requests.
+static bool _pathfinding_process_batch(Pathfinding *pf) {
+    PathfindingRequest *batch[PATHFINDING_MAX_BATCH];
+    uint32_t n = 0;
+    while (n < PATHFINDING_MAX_BATCH) {
+        PathfindingRequest *r = (PathfindingRequest *)fifo_list_pop(pf->requests);
+        if (r == NULL) {
+            break;
+        }
+        batch[n++] = r;
+    }
+    if (n == 0) {
+        return false;
+    }
+    pf->busy = true;
+    thread_condition_unlock(pf->condition);
+
+    // graph locked per search, for pathfinding_update to publish rebuilt clusters in between
+    PathfindingResult *results[PATHFINDING_MAX_BATCH];
+    for (uint32_t i = 0; i < n; ++i) {
+        mutex_lock(pf->graph);
+        results[i] = _pathfinding_find(pf, batch[i]->id, batch[i]->start, batch[i]->goal);
+        mutex_unlock(pf->graph);
+        free(batch[i]);
+    }
+
+    thread_condition_lock(pf->condition);
+    for (uint32_t i = 0; i < n; ++i) {
+        if (results[i] != NULL) {
+            fifo_list_push(pf->results, results[i]);
+        }
+    }
+    pf->busy = false;
+    thread_condition_broadcast(pf->condition);
+    return true;
+}
+
+static void _pathfinding_worker_main(void *userdata) {
+    Pathfinding *pf = (Pathfinding *)userdata;
+
+    thread_condition_lock(pf->condition);
+    while (true) {
+        while (pf->stop == false && fifo_list_get_size(pf->requests) == 0) {
+            thread_condition_wait(pf->condition);
+        }
+        if (_pathfinding_process_batch(pf) == false) {
+            break; // stopped & all requests processed
+        }
+    }
+    thread_condition_unlock(pf->condition);
+}
+
+static void _pathfinding_result_free_func(void *ptr) {
+    pathfinding_result_free((PathfindingResult *)ptr);
+}
+
+// MARK: - Public functions -
+
+Pathfinding *pathfinding_new(Shape *map, const uint8_t agentHeight) {
+    if (map == NULL || agentHeight == 0 || agentHeight > CHUNK_SIZE) {
+        return NULL;
+    }
+    Pathfinding *pf = (Pathfinding *)malloc(sizeof(Pathfinding));
+    if (pf == NULL) {
+        return NULL;
+    }
+    pf->map = map;
+    pf->condition = thread_condition_new();
+    pf->requests = fifo_list_new();
+    pf->results = fifo_list_new();
+    pf->graph = mutex_new();
+    pf->clusters = index3d_new();
+    pf->clustersById = NULL;
+    pf->freeIds = filo_list_uint32_new();
+    pf->dist = (uint32_t *)malloc(CHUNK_SIZE_CUBE * sizeof(uint32_t));
+    pf->prev = (uint16_t *)malloc(CHUNK_SIZE_CUBE * sizeof(uint16_t));
+    pf->heap = (PathfindingHeap){NULL, 0, 0};
+    pf->nbClusters = 0;
+    pf->clustersCapacity = 0;
+    pf->nbBuilds = 0;
+    pf->epoch = 0;
+    pf->nextId = 1;
+    pf->agentHeight = agentHeight;
+    pf->busy = false;
+    pf->stop = false;
+
+    pf->thread = thread_new(_pathfinding_worker_main, pf);
+    if (pf->thread == NULL) {
+        cclog_warning("pathfinding: no background thread, requests resolved on update");
+    }
+    return pf;
+}
+
+void pathfinding_free(Pathfinding *pf) {
+    if (pf == NULL) {
+        return;
+    }
+    if (pf->thread != NULL) {
+        thread_condition_lock(pf->condition);
+        pf->stop = true;
+        thread_condition_broadcast(pf->condition);
+        thread_condition_unlock(pf->condition);
+        thread_join_and_free(pf->thread);
+    }
+
+    fifo_list_free(pf->requests, free);
+    fifo_list_free(pf->results, _pathfinding_result_free_func);
+    for (uint32_t i = 0; i < pf->nbClusters; ++i) {
+        if (pf->clustersById[i] != NULL) {
+            _pathfinding_cluster_free(pf, pf->clustersById[i]);
+        }
+    }
+    free(pf->clustersById);
+    index3d_free(pf->clusters);
+    filo_list_uint32_free(pf->freeIds);
+    free(pf->dist);
+    free(pf->prev);
+    free(pf->heap.items);
+    mutex_free(pf->graph);
+    thread_condition_free(pf->condition);
+    free(pf);
+}
+
+void pathfinding_update(Pathfinding *pf) {
+    PROFILER_ZONE_BEGIN("pathfinding_update");
+    mutex_lock(pf->graph);
+    ++pf->epoch;
+
+    // added or modified chunks
+    Index3DIterator *it = index3d_iterator_new(shape_get_chunks(pf->map));
+    const Chunk *chunk;
+    while ((chunk = (const Chunk *)index3d_iterator_pointer(it)) != NULL) {
+        const SHAPE_COORDS_INT3_T coords = chunk_utils_get_coords(chunk_get_origin(chunk));
+        PathfindingCluster *c = _pathfinding_get_or_create_cluster(pf, coords);
+        if (c != NULL) {
+            c->epoch = pf->epoch;
+            const uint64_t version = chunk_get_solid_version(chunk);
+            if (c->chunk != chunk || c->version != version) {
+                c->chunk = chunk;
+                c->version = version;
+                memcpy(c->solid, chunk_get_solid_mask(chunk), sizeof(c->solid));
+                _pathfinding_set_neighborhood_dirty(pf, coords);
+            }
+        }
+        // cells on top of the chunk may be walkable
+        _pathfinding_get_or_create_cluster(pf,
+                                           (SHAPE_COORDS_INT3_T){coords.x,
+                                                                 (SHAPE_COORDS_INT_T)(coords.y + 1),
+                                                                 coords.z});
+        index3d_iterator_next(it);
+    }
+    index3d_iterator_free(it);
+
+    // removed chunks
+    for (uint32_t i = 0; i < pf->nbClusters; ++i) {
+        PathfindingCluster *c = pf->clustersById[i];
+        if (c != NULL && c->chunk != NULL && c->epoch != pf->epoch) {
+            c->chunk = NULL;
+            c->version = 0;
+            memset(c->solid, 0, sizeof(c->solid));
+            _pathfinding_set_neighborhood_dirty(pf, c->coords);
+        }
+    }
+    // clusters w/o chunk can only have walkable cells if there's a chunk below
+    for (uint32_t i = 0; i < pf->nbClusters; ++i) {
+        PathfindingCluster *c = pf->clustersById[i];
+        if (c != NULL && c->chunk == NULL) {
+            const PathfindingCluster *below = _pathfinding_get_cluster(pf,
+                                                                       c->coords.x,
+                                                                       c->coords.y - 1,
+                                                                       c->coords.z);
+            if (below == NULL || below->chunk == NULL) {
+                _pathfinding_cluster_free(pf, c);
+            }
+        }
+    }
+
+    uint32_t nbDirty = 0;
+    for (uint32_t i = 0; i < pf->nbClusters; ++i) {
+        if (pf->clustersById[i] != NULL && pf->clustersById[i]->dirty) {
+            ++nbDirty;
+        }
+    }
+    mutex_unlock(pf->graph);
+
+    // searches go on with previous clusters while modified ones are rebuilt
+    PathfindingClusterBuild *builds = NULL;
+    if (nbDirty > 0) {
+        builds = (PathfindingClusterBuild *)malloc(nbDirty * sizeof(PathfindingClusterBuild));
+    }
+    if (builds != NULL) {
+        uint32_t n = 0;
+        for (uint32_t i = 0; i < pf->nbClusters; ++i) {
+            PathfindingCluster *c = pf->clustersById[i];
+            if (c != NULL && c->dirty) {
+                builds[n].cluster = c;
+                _pathfinding_cluster_build(pf, &builds[n]);
+                c->dirty = false;
+                ++n;
+            }
+        }
+        pf->nbBuilds += nbDirty;
+
+        mutex_lock(pf->graph);
+        for (uint32_t i = 0; i < nbDirty; ++i) {
+            _pathfinding_cluster_publish(&builds[i]);
+        }
+        mutex_unlock(pf->graph);
+
+        for (uint32_t i = 0; i < nbDirty; ++i) {
+            free(builds[i].cells);
+            free(builds[i].moves);
+            free(builds[i].exits);
+        }
+        free(builds);
+    }
+
+    // resolve requests here if there's no background thread
+    if (pf->thread == NULL) {
+        thread_condition_lock(pf->condition);
+        while (_pathfinding_process_batch(pf)) {}
+        thread_condition_unlock(pf->condition);
+    }
+    PROFILER_ZONE_END();
+}
+
+uint32_t pathfinding_request(Pathfinding *pf,
+                             const SHAPE_COORDS_INT3_T start,
+                             const SHAPE_COORDS_INT3_T goal) {
+    PathfindingRequest *r = (PathfindingRequest *)malloc(sizeof(PathfindingRequest));
+    if (r == NULL) {
+        return 0;
+    }
+    r->start = start;
+    r->goal = goal;
+    r->id = pf->nextId++;
+    if (pf->nextId == 0) {
+        pf->nextId = 1;
+    }
+    const uint32_t id = r->id;
+
+    thread_condition_lock(pf->condition);
+    fifo_list_push(pf->requests, r);
+    thread_condition_broadcast(pf->condition);
+    thread_condition_unlock(pf->condition);
+    return id;
+}
+
+PathfindingResult *pathfinding_pop_result(Pathfinding *pf) {
+    thread_condition_lock(pf->condition);
+    PathfindingResult *r = (PathfindingResult *)fifo_list_pop(pf->results);
+    thread_condition_unlock(pf->condition);
+    return r;
+}
+
+void pathfinding_wait(Pathfinding *pf) {
+    thread_condition_lock(pf->condition);
+    if (pf->thread == NULL) {
+        while (_pathfinding_process_batch(pf)) {}
+    }
+    while (fifo_list_get_size(pf->requests) > 0 || pf->busy) {
+        thread_condition_wait(pf->condition);
+    }
+    thread_condition_unlock(pf->condition);
+}
+
+PathfindingResult *pathfinding_find(Pathfinding *pf,
+                                    const SHAPE_COORDS_INT3_T start,
+                                    const SHAPE_COORDS_INT3_T goal) {
+    mutex_lock(pf->graph);
+    PathfindingResult *r = _pathfinding_find(pf, 0, start, goal);
+    mutex_unlock(pf->graph);
+    return r;
+}
+
+void pathfinding_result_free(PathfindingResult *r) {
+    if (r == NULL) {
+        return;
+    }
+    free(r->cells);
+    free(r);
+}
+
+uint32_t pathfinding_get_nb_clusters(const Pathfinding *pf) {
+    return index3d_get_count(pf->clusters);
+}
+
+uint32_t pathfinding_get_nb_cluster_builds(const Pathfinding *pf) {
+    return pf->nbBuilds;
+}
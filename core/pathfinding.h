@@ -0,0 +1,95 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  pathfinding.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+// Paths for agents walking on the blocks of a map shape.
+//
+// An agent stands in a walkable cell: an air cell above a solid block, with enough air above it
+// for the agent's height. From there, it can move to the 4 horizontal neighbors: at the same level,
+// stepping up one block (if there's room above its head to do so), or dropping down at most
+// PATHFINDING_MAX_DROP blocks.
+//
+// Search is hierarchical (HPA*): each chunk is a cluster, moves between clusters are grouped in
+// portals, one per contiguous set of moves between two clusters. Paths are first searched between
+// portals, using costs from portals to exits of each cluster computed when first needed & cached,
+// then refined within each cluster. Paths are near-optimal.
+//
+// Walkable cells & portals are built from a copy of chunks solid masks, refreshed in
+// pathfinding_update for modified chunks only (& their neighbors). Requests are resolved in
+// batches by a background thread, which never accesses the shape. Clusters are rebuilt while
+// searches go on, then swapped in between two searches.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "shape.h"
+
+#define PATHFINDING_MAX_DROP 3
+// costs of moves, a path cost is the sum of its moves costs
+#define PATHFINDING_COST_MOVE 10
+#define PATHFINDING_COST_STEP_UP 5
+#define PATHFINDING_COST_DROP_PER_BLOCK 2
+// start & goal positions are moved down that many blocks at most to find a walkable cell
+#define PATHFINDING_SNAP_DEPTH 4
+// portals visited per search, paths needing more aren't found
+#define PATHFINDING_MAX_SEARCH_NODES 16384
+// requests resolved by the background thread before publishing their results
+#define PATHFINDING_MAX_BATCH 32
+
+typedef struct _Pathfinding Pathfinding;
+
+typedef struct {
+    /// cells walked through, from start to goal included, NULL if not found
+    SHAPE_COORDS_INT3_T *cells;
+    uint32_t nbCells;
+    uint32_t cost;
+    uint32_t id;
+    bool found;
+    char pad[3];
+} PathfindingResult;
+
+/// `agentHeight` in blocks, in [1, CHUNK_SIZE]. `map` must outlive the pathfinding.
+/// Requests are resolved in pathfinding_update if the background thread can't be started.
+Pathfinding *pathfinding_new(Shape *map, const uint8_t agentHeight);
+
+/// Waits for the background thread to resolve pending requests
+void pathfinding_free(Pathfinding *pf);
+
+/// Refreshes walkable cells & portals of modified chunks. To be called once per frame, from the
+/// thread owning the map shape. It waits for the search being resolved if any, twice at most.
+void pathfinding_update(Pathfinding *pf);
+
+/// Requests a path between two positions in map block coordinates, returns request id
+uint32_t pathfinding_request(Pathfinding *pf,
+                             const SHAPE_COORDS_INT3_T start,
+                             const SHAPE_COORDS_INT3_T goal);
+
+/// Next resolved request, NULL if none. To be freed with pathfinding_result_free.
+PathfindingResult *pathfinding_pop_result(Pathfinding *pf);
+
+/// Waits for all pending requests to be resolved
+void pathfinding_wait(Pathfinding *pf);
+
+/// Resolves a path on the calling thread
+PathfindingResult *pathfinding_find(Pathfinding *pf,
+                                    const SHAPE_COORDS_INT3_T start,
+                                    const SHAPE_COORDS_INT3_T goal);
+
+void pathfinding_result_free(PathfindingResult *r);
+
+uint32_t pathfinding_get_nb_clusters(const Pathfinding *pf);
+
+/// Clusters built since creation, each build being triggered by a chunk change
+uint32_t pathfinding_get_nb_cluster_builds(const Pathfinding *pf);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,66 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  pool.c
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#include "pool.h"
+
+#include <stdlib.h>
+
+// keeps elements aligned like malloc'd memory
+#define POOL_SLAB_HEADER_SIZE 16
+
+void pool_init(Pool *p, const size_t elementSize, const uint32_t firstSlabCapacity) {
+    p->freeList = NULL;
+    p->slabs = NULL;
+    p->elementSize = (uint32_t)(elementSize < sizeof(void *) ? sizeof(void *) : elementSize);
+    // elements have the alignment of a pointer
+    p->elementSize = (p->elementSize + (uint32_t)sizeof(void *) - 1) &
+                     ~((uint32_t)sizeof(void *) - 1);
+    p->nextSlabCapacity = firstSlabCapacity == 0 ? 1 : firstSlabCapacity;
+}
+
+void pool_release(Pool *p) {
+    void *slab = p->slabs;
+    while (slab != NULL) {
+        void *next = *(void **)slab;
+        free(slab);
+        slab = next;
+    }
+    p->slabs = NULL;
+    p->freeList = NULL;
+}
+
+void *pool_alloc(Pool *p) {
+    if (p->freeList == NULL) {
+        const uint32_t capacity = p->nextSlabCapacity;
+        char *slab = (char *)malloc(POOL_SLAB_HEADER_SIZE + (size_t)capacity * p->elementSize);
+        if (slab == NULL) {
+            return NULL;
+        }
+        *(void **)slab = p->slabs;
+        p->slabs = slab;
+
+        // chaining new elements in order, first one allocated first
+        char *element = slab + POOL_SLAB_HEADER_SIZE + (size_t)(capacity - 1) * p->elementSize;
+        for (uint32_t i = 0; i < capacity; ++i) {
+            *(void **)element = p->freeList;
+            p->freeList = element;
+            element -= p->elementSize;
+        }
+
+        if (capacity < POOL_MAX_SLAB_CAPACITY) {
+            p->nextSlabCapacity = capacity * 2 > POOL_MAX_SLAB_CAPACITY ? POOL_MAX_SLAB_CAPACITY
+                                                                        : capacity * 2;
+        }
+    }
+    void *element = p->freeList;
+    p->freeList = *(void **)element;
+    return element;
+}
+
+void pool_recycle(Pool *p, void *element) {
+    *(void **)element = p->freeList;
+    p->freeList = element;
+}
@@ -0,0 +1,44 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  pool.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define POOL_MAX_SLAB_CAPACITY 256
+
+// Allocates fixed size elements from slabs of growing capacity, recycled
+// elements are reused before allocating new slabs. Slabs are only released
+// with the pool itself, meant to be embedded in containers allocating a node
+// per element (see DoublyLinkedList).
+typedef struct {
+    void *freeList; // recycled elements, chained through their first bytes
+    void *slabs;    // chained through their headers
+    uint32_t elementSize;
+    uint32_t nextSlabCapacity;
+} Pool;
+
+// elements are at least the size of a pointer, `firstSlabCapacity` doubles
+// for each new slab, up to POOL_MAX_SLAB_CAPACITY
+void pool_init(Pool *p, const size_t elementSize, const uint32_t firstSlabCapacity);
+
+// frees all slabs, elements still in use become invalid
+void pool_release(Pool *p);
+
+// returns NULL if allocation fails, element's content is undefined
+void *pool_alloc(Pool *p);
+
+// element has to come from the same pool
+void pool_recycle(Pool *p, void *element);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
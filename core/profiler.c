@@ -0,0 +1,273 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  profiler.c
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#include "profiler.h"
+
+// C
+#include <stdlib.h>
+
+// Core
+#include "cclog.h"
+#include "config.h"
+#include "thread.h"
+#include "utils.h"
+
+// per thread buffers grow up to PROFILER_THREAD_MAX_ZONES, further zones are dropped
+#define PROFILER_THREAD_INITIAL_ZONES 4096
+#define PROFILER_THREAD_MAX_ZONES 1048576
+#define PROFILER_MAX_DEPTH 64
+
+typedef struct {
+    const char *name;
+    uint64_t start;
+    uint64_t duration;
+} ProfilerZone;
+
+typedef struct {
+    ProfilerZone *zones;
+    // open zones, start is 0 for zones opened while not capturing
+    const char *stackNames[PROFILER_MAX_DEPTH];
+    uint64_t stackStarts[PROFILER_MAX_DEPTH];
+    // zones are published by incrementing count
+    volatile int32_t count;
+    volatile int32_t dropped;
+    int32_t capacity;
+    uint32_t depth;
+    // track id in exported trace
+    uint32_t id;
+    char pad[4];
+} ProfilerThread;
+
+static volatile int32_t _capturing = 0;
+static uint64_t _origin = 0;
+
+// registry of per-thread buffers, protected by a spin lock (only taken once per thread)
+static ProfilerThread **_threads = NULL;
+static uint32_t _nbThreads = 0;
+static uint32_t _threadsCapacity = 0;
+static volatile int32_t _threadsLock = 0;
+// incremented when buffers are released, invalidating thread local pointers
+static volatile int32_t _generation = 0;
+
+static vx_thread_local ProfilerThread *_thread = NULL;
+static vx_thread_local int32_t _threadGeneration = -1;
+
+// MARK: - private functions -
+
+static void _profiler_lock(void) {
+    while (thread_atomic_compare_exchange(&_threadsLock, 0, 1) == false) {
+        thread_yield();
+    }
+}
+
+static void _profiler_unlock(void) {
+    thread_atomic_store(&_threadsLock, 0);
+}
+
+static ProfilerThread *_profiler_get_thread(const bool create) {
+    const int32_t generation = thread_atomic_load(&_generation);
+    if (_thread != NULL && _threadGeneration == generation) {
+        return _thread;
+    }
+    _thread = NULL;
+    if (create == false) {
+        return NULL;
+    }
+
+    ProfilerThread *t = (ProfilerThread *)malloc(sizeof(ProfilerThread));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->zones = (ProfilerZone *)malloc(sizeof(ProfilerZone) * PROFILER_THREAD_INITIAL_ZONES);
+    if (t->zones == NULL) {
+        free(t);
+        return NULL;
+    }
+    t->capacity = PROFILER_THREAD_INITIAL_ZONES;
+    t->count = 0;
+    t->dropped = 0;
+    t->depth = 0;
+
+    _profiler_lock();
+    if (_nbThreads == _threadsCapacity) {
+        const uint32_t capacity = _threadsCapacity == 0 ? 8 : _threadsCapacity * 2;
+        ProfilerThread **threads = (ProfilerThread **)realloc(_threads,
+                                                              sizeof(ProfilerThread *) * capacity);
+        if (threads == NULL) {
+            _profiler_unlock();
+            free(t->zones);
+            free(t);
+            return NULL;
+        }
+        _threads = threads;
+        _threadsCapacity = capacity;
+    }
+    t->id = _nbThreads;
+    _threads[_nbThreads++] = t;
+    _profiler_unlock();
+
+    _thread = t;
+    _threadGeneration = generation;
+    return t;
+}
+
+static bool _profiler_write_zone(FILE *fd, const ProfilerZone *z, const uint32_t tid, bool *first) {
+    // names are string literals, only escaping what could break the JSON
+    if (fprintf(fd, "%s\n{\"name\":\"", *first ? "" : ",") < 0) {
+        return false;
+    }
+    *first = false;
+    for (const char *c = z->name; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', fd);
+        }
+        fputc(*c, fd);
+    }
+    const uint64_t start = z->start > _origin ? z->start - _origin : 0;
+    return fprintf(fd,
+                   "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%llu.%03u,\"dur\":%llu.%03u}",
+                   tid,
+                   (unsigned long long)(start / 1000),
+                   (unsigned int)(start % 1000),
+                   (unsigned long long)(z->duration / 1000),
+                   (unsigned int)(z->duration % 1000)) >= 0;
+}
+
+// MARK: - public functions -
+
+void profiler_set_capturing(const bool capturing) {
+    if (capturing && _origin == 0) {
+        _origin = utils_time_ns();
+    }
+    thread_atomic_store(&_capturing, capturing ? 1 : 0);
+}
+
+bool profiler_is_capturing(void) {
+    return thread_atomic_load(&_capturing) != 0;
+}
+
+void profiler_zone_begin(const char *name) {
+    const bool capturing = _capturing != 0;
+    ProfilerThread *t = _profiler_get_thread(capturing);
+    if (t == NULL) {
+        return;
+    }
+    if (t->depth < PROFILER_MAX_DEPTH) {
+        t->stackNames[t->depth] = name;
+        t->stackStarts[t->depth] = capturing ? utils_time_ns() : 0;
+    }
+    ++t->depth;
+}
+
+void profiler_zone_end(void) {
+    ProfilerThread *t = _profiler_get_thread(false);
+    if (t == NULL || t->depth == 0) {
+        return;
+    }
+    --t->depth;
+    if (t->depth >= PROFILER_MAX_DEPTH) {
+        return;
+    }
+    const uint64_t start = t->stackStarts[t->depth];
+    if (start == 0 || _capturing == 0) {
+        return;
+    }
+    const int32_t count = t->count;
+    if (count == t->capacity) {
+        // export & reset can't happen while recording, the buffer can be moved
+        ProfilerZone *zones = NULL;
+        if (t->capacity < PROFILER_THREAD_MAX_ZONES) {
+            zones = (ProfilerZone *)realloc(t->zones,
+                                            sizeof(ProfilerZone) * (size_t)t->capacity * 2);
+        }
+        if (zones == NULL) {
+            thread_atomic_add(&t->dropped, 1);
+            return;
+        }
+        t->zones = zones;
+        t->capacity *= 2;
+    }
+    ProfilerZone *z = &t->zones[count];
+    z->name = t->stackNames[t->depth];
+    z->start = start;
+    z->duration = utils_time_ns() - start;
+    thread_atomic_store(&t->count, count + 1);
+}
+
+uint32_t profiler_get_zone_count(void) {
+    uint32_t count = 0;
+    _profiler_lock();
+    for (uint32_t i = 0; i < _nbThreads; ++i) {
+        count += (uint32_t)thread_atomic_load(&_threads[i]->count);
+    }
+    _profiler_unlock();
+    return count;
+}
+
+void profiler_reset(void) {
+    _profiler_lock();
+    for (uint32_t i = 0; i < _nbThreads; ++i) {
+        thread_atomic_store(&_threads[i]->count, 0);
+        thread_atomic_store(&_threads[i]->dropped, 0);
+    }
+    _profiler_unlock();
+}
+
+bool profiler_write_chrome_trace(FILE *fd) {
+    if (fd == NULL) {
+        cclog_error("profiler: file descriptor is NULL");
+        return false;
+    }
+
+    bool success = fprintf(fd, "{\"traceEvents\":[") >= 0;
+    bool first = true;
+    uint32_t dropped = 0;
+
+    _profiler_lock();
+    for (uint32_t i = 0; i < _nbThreads && success; ++i) {
+        ProfilerThread *t = _threads[i];
+        const int32_t count = thread_atomic_load(&t->count);
+        if (count == 0) {
+            continue;
+        }
+        success = fprintf(fd,
+                          "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,"
+                          "\"args\":{\"name\":\"thread %u\"}}",
+                          first ? "" : ",",
+                          t->id,
+                          t->id) >= 0;
+        first = false;
+        for (int32_t z = 0; z < count && success; ++z) {
+            success = _profiler_write_zone(fd, &t->zones[z], t->id, &first);
+        }
+        dropped += (uint32_t)thread_atomic_load(&t->dropped);
+    }
+    _profiler_unlock();
+
+    if (success) {
+        success = fprintf(fd,
+                          "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedZones\":%u}}\n",
+                          dropped) >= 0;
+    }
+    if (success == false) {
+        cclog_error("profiler: failed to write chrome trace");
+    }
+    return success;
+}
+
+void profiler_release(void) {
+    _profiler_lock();
+    for (uint32_t i = 0; i < _nbThreads; ++i) {
+        free(_threads[i]->zones);
+        free(_threads[i]);
+    }
+    free(_threads);
+    _threads = NULL;
+    _nbThreads = 0;
+    _threadsCapacity = 0;
+    thread_atomic_add(&_generation, 1);
+    _profiler_unlock();
+}
@@ -0,0 +1,67 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  profiler.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Zones are compiled in when PROFILER_ENABLED is true, they can be turned on for release builds
+// with -DPROFILER_ENABLED=1. When compiled out, PROFILER_ZONE_* macros expand to nothing.
+#ifndef PROFILER_ENABLED
+#if DEBUG
+#define PROFILER_ENABLED true
+#else
+#define PROFILER_ENABLED false
+#endif
+#endif
+
+#if PROFILER_ENABLED
+#define PROFILER_ZONE_BEGIN(name) profiler_zone_begin(name)
+#define PROFILER_ZONE_END() profiler_zone_end()
+#else
+#define PROFILER_ZONE_BEGIN(name)
+#define PROFILER_ZONE_END()
+#endif
+
+/// Starts or stops recording zones. Zones are only recorded while capturing (off by default),
+/// otherwise each zone costs a branch.
+void profiler_set_capturing(const bool capturing);
+bool profiler_is_capturing(void);
+
+/// Opens a zone on the calling thread, `name` has to be a string literal (or outlive the
+/// profiler). Zones nest, each begin must be paired with an end on the same thread.
+/// Prefer PROFILER_ZONE_BEGIN, compiled out when PROFILER_ENABLED is false.
+void profiler_zone_begin(const char *name);
+
+/// Closes the last zone opened on the calling thread
+void profiler_zone_end(void);
+
+/// Number of zones recorded since last reset, all threads included
+uint32_t profiler_get_zone_count(void);
+
+/// Discards recorded zones.
+/// Other threads shouldn't be recording zones while this is called.
+void profiler_reset(void);
+
+/// Writes recorded zones in Chrome trace event format (chrome://tracing, Perfetto), one track
+/// per thread, timestamps relative to when capture was first started.
+/// Other threads shouldn't be recording zones while this is called.
+/// Returns false if writing failed. Doesn't close the file descriptor.
+bool profiler_write_chrome_trace(FILE *fd);
+
+/// Frees all per-thread buffers.
+/// Other threads shouldn't be recording zones while this is called.
+void profiler_release(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
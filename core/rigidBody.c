@@ -10,6 +10,7 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include "profiler.h"
 #include "scene.h"
 
 #define SIMULATIONFLAG_NONE 0
@@ -459,8 +460,11 @@ bool _rigidbody_dynamic_tick(Scene *scene,
                         swept = 1.0f;
                     }
                 }
-                // earlier contact found
-                if (swept < minSwept) {
+                // earlier contact found, ties are broken by transform ID so that the outcome
+                // doesn't depend on r-tree queries order
+                if (swept < minSwept ||
+                    (swept == minSwept && isTrigger == false && contact.t != NULL &&
+                     transform_get_id(hitLeaf) < transform_get_id(contact.t))) {
                     if (isTrigger) {
                         // consider triggers here too, in case dynamic rb passes through in one
                         // frame, or the callback is defined only on the dynamic rb
@@ -1037,24 +1041,28 @@ bool rigidbody_tick(Scene *scene,
         sceneQuery = fifo_list_new();
     }
 
+    bool moved = false;
+    PROFILER_ZONE_BEGIN("rigidbody_tick");
+
     // dynamic rigidbodies are fully simulated, their callbacks are evaluated in this loop
     // vs. other dynamic rigidbodies only
     if (rigidbody_is_dynamic(rb)) {
-        return _rigidbody_dynamic_tick(scene,
-                                       rb,
-                                       t,
-                                       worldCollider,
-                                       r,
-                                       dt,
-                                       sceneQuery,
-                                       callbackData);
+        moved = _rigidbody_dynamic_tick(scene,
+                                        rb,
+                                        t,
+                                        worldCollider,
+                                        r,
+                                        dt,
+                                        sceneQuery,
+                                        callbackData);
     }
     // check for overlaps to fire callbacks for trigger and static rigidbodies
     else if (rigidbody_is_active_trigger(rb)) {
         _rigidbody_trigger_tick(scene, rb, t, worldCollider, r, sceneQuery, callbackData);
     }
 
-    return false;
+    PROFILER_ZONE_END();
+    return moved;
 }
 
 // MARK: - Accessors -
@@ -1178,6 +1186,33 @@ void rigidbody_set_awake(RigidBody *rb) {
     rb->awakeFlag = PHYSICS_AWAKE_FRAMES;
 }
 
+void rigidbody_get_state(const RigidBody *rb, RigidbodyState *state) {
+    *state = (RigidbodyState){*rb->velocity,
+                              *rb->motion,
+                              *rb->constantAcceleration,
+                              rb->checkpoint != NULL ? *rb->checkpoint : float3_zero,
+                              rb->contact,
+                              rb->awakeFlag,
+                              rb->checkpoint != NULL,
+                              {0}};
+}
+
+void rigidbody_set_state(RigidBody *rb, const RigidbodyState *state) {
+    float3_copy(rb->velocity, &state->velocity);
+    float3_copy(rb->motion, &state->motion);
+    float3_copy(rb->constantAcceleration, &state->constantAcceleration);
+    if (state->hasCheckpoint == false) {
+        float3_free(rb->checkpoint);
+        rb->checkpoint = NULL;
+    } else if (rb->checkpoint == NULL) {
+        rb->checkpoint = float3_new_copy(&state->checkpoint);
+    } else {
+        float3_copy(rb->checkpoint, &state->checkpoint);
+    }
+    rb->contact = state->contact;
+    rb->awakeFlag = state->awakeFlag;
+}
+
 // MARK: - State -
 
 bool rigidbody_has_contact(const RigidBody *rb, uint8_t value) {
@@ -64,6 +64,18 @@ typedef enum {
     RigidbodyMode_Max = 5
 } RigidbodyMode;
 
+/// Simulation state, copied as is to roll back a simulation (see scene_write_snapshot)
+typedef struct {
+    float3 velocity;
+    float3 motion;
+    float3 constantAcceleration;
+    float3 checkpoint;
+    uint8_t contact;
+    uint8_t awakeFlag;
+    bool hasCheckpoint;
+    char pad[1];
+} RigidbodyState;
+
 typedef enum CollisionCallbackType {
     CollisionCallbackType_Begin,
     CollisionCallbackType_Tick,
@@ -118,6 +130,8 @@ void rigidbody_set_simulation_mode(RigidBody *rb, const uint8_t value);
 bool rigidbody_get_collider_dirty(const RigidBody *rb);
 void rigidbody_reset_collider_dirty(RigidBody *rb);
 void rigidbody_set_awake(RigidBody *rb);
+void rigidbody_get_state(const RigidBody *rb, RigidbodyState *state);
+void rigidbody_set_state(RigidBody *rb, const RigidbodyState *state);
 
 /// MARK: - State -
 bool rigidbody_has_contact(const RigidBody *rb, uint8_t value);
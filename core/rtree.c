@@ -10,6 +10,7 @@
 
 #include "cclog.h"
 #include "config.h"
+#include "profiler.h"
 #include "shape.h"
 #include "transform.h"
 
@@ -42,6 +43,9 @@ struct _RtreeNode {
     DoublyLinkedList *children;
     // axis-aligned bounding box for this node
     Box *aabb;
+    // a leaf node is placed in the tree w/ an enlarged box, its aabb can move within it w/o
+    // changing ancestors, it is null for non-leaf nodes
+    Box *fatAabb;
     // a leaf node carries a pointer to the corresponding object
     void *leaf;
     // collision masks may be used to filter out queries,
@@ -51,8 +55,11 @@ struct _RtreeNode {
     uint8_t count;
     // non-leaf node layers need to be refreshed
     bool layersDirty;
-
-    char pad[2];
+    // non-leaf node aabb may be larger than its children & needs to be refit, or a leaf below it
+    // is waiting for reinsertion
+    bool aabbDirty;
+    // leaf node moved too far from its siblings, to be reinserted on next refit
+    bool reinsert;
 };
 
 // MARK: - Private functions prototypes -
@@ -62,6 +69,18 @@ void _rtree_node_free(RtreeNode *rn);
 
 // MARK: - Private functions -
 
+/// @returns box used to place the node in the tree, larger than the node aabb for a moving leaf
+static Box *_rtree_node_get_bounds(const RtreeNode *rn) {
+    return rn->fatAabb != NULL ? rn->fatAabb : rn->aabb;
+}
+
+static void _rtree_node_set_aabb_dirty(RtreeNode *rn) {
+    while (rn != NULL && rn->aabbDirty == false) {
+        rn->aabbDirty = true;
+        rn = rn->parent;
+    }
+}
+
 RtreeNode *_rtree_node_new_root(Rtree *r) {
     RtreeNode *rn = (RtreeNode *)malloc(sizeof(RtreeNode));
     if (rn == NULL) {
@@ -70,11 +89,14 @@ RtreeNode *_rtree_node_new_root(Rtree *r) {
     rn->parent = NULL;
     rn->children = doubly_linked_list_new();
     rn->aabb = NULL;
+    rn->fatAabb = NULL;
     rn->leaf = NULL;
     rn->count = 0;
     rn->groups = PHYSICS_GROUP_ALL_SYSTEM;
     rn->collidesWith = PHYSICS_GROUP_ALL_SYSTEM;
     rn->layersDirty = false;
+    rn->aabbDirty = false;
+    rn->reinsert = false;
 
     if (r->root != NULL) {
         rtree_recurse(r->root, _rtree_node_free);
@@ -97,11 +119,14 @@ RtreeNode *_rtree_node_new_leaf(RtreeNode *parent,
     rn->parent = parent;
     rn->children = doubly_linked_list_new();
     rn->aabb = box_new_copy(aabb);
+    rn->fatAabb = box_new_copy(aabb);
     rn->leaf = ptr;
     rn->count = 0;
     rn->groups = groups;
     rn->collidesWith = collidesWith;
     rn->layersDirty = false;
+    rn->aabbDirty = false;
+    rn->reinsert = false;
 
     if (parent != NULL) {
         _rtree_node_assign(parent, rn, true);
@@ -118,11 +143,14 @@ RtreeNode *_rtree_node_new_branch(RtreeNode *parent, RtreeNode *child) {
     rn->parent = parent;
     rn->children = doubly_linked_list_new();
     rn->aabb = NULL;
+    rn->fatAabb = NULL;
     rn->leaf = NULL;
     rn->count = 0;
     rn->groups = PHYSICS_GROUP_ALL_SYSTEM;
     rn->collidesWith = PHYSICS_GROUP_ALL_SYSTEM;
     rn->layersDirty = false;
+    rn->aabbDirty = false;
+    rn->reinsert = false;
 
     if (child != NULL) {
         _rtree_node_assign(rn, child, true);
@@ -139,6 +167,9 @@ void _rtree_node_free(RtreeNode *rn) {
     if (rn->aabb != NULL) {
         box_free(rn->aabb);
     }
+    if (rn->fatAabb != NULL) {
+        box_free(rn->fatAabb);
+    }
     free(rn);
 }
 
@@ -168,12 +199,17 @@ void _rtree_node_assign(RtreeNode *parent, RtreeNode *child, bool merge) {
             // this should happen on a previously empty node
             vx_assert(parent->count == 1);
 
-            parent->aabb = box_new_copy(child->aabb);
+            parent->aabb = box_new_copy(_rtree_node_get_bounds(child));
         } else {
-            box_op_merge(parent->aabb, child->aabb, parent->aabb);
+            box_op_merge(parent->aabb, _rtree_node_get_bounds(child), parent->aabb);
         }
         parent->layersDirty = true;
     }
+
+    // keep the path to a pending refit reachable from the root
+    if (child->aabbDirty || child->reinsert) {
+        _rtree_node_set_aabb_dirty(parent);
+    }
 }
 
 /// @returns whether or not child was found & removed, if so, ancestors aabb will need to be
@@ -206,13 +242,13 @@ void _rtree_node_reset_aabb(RtreeNode *rn) {
     if (n != NULL) {
         // aabb is set to match its first child aabb
         RtreeNode *child = (RtreeNode *)doubly_linked_list_node_pointer(n);
-        box_copy(rn->aabb, child->aabb);
+        box_copy(rn->aabb, _rtree_node_get_bounds(child));
 
         // merge w/ other children aabb if any
         n = doubly_linked_list_node_next(n);
         while (n != NULL) {
             child = (RtreeNode *)doubly_linked_list_node_pointer(n);
-            box_op_merge(rn->aabb, child->aabb, rn->aabb);
+            box_op_merge(rn->aabb, _rtree_node_get_bounds(child), rn->aabb);
             n = doubly_linked_list_node_next(n);
         }
     } else {
@@ -307,7 +343,9 @@ RtreeNode *_rtree_split_node_quadratic(Rtree *r, RtreeNode *toSplit) {
         while (n2 != NULL) {
             rn2 = (RtreeNode *)doubly_linked_list_node_pointer(n2);
 
-            const float vol = _rtree_box_merge_dead_space(rn1->aabb, rn2->aabb, &tmpBox);
+            const float vol = _rtree_box_merge_dead_space(_rtree_node_get_bounds(rn1),
+                                                          _rtree_node_get_bounds(rn2),
+                                                          &tmpBox);
             if (vol > maxVol) {
                 seed1 = rn1;
                 seed2 = rn2;
@@ -349,9 +387,10 @@ RtreeNode *_rtree_split_node_quadratic(Rtree *r, RtreeNode *toSplit) {
                 rn2 = rnSplit2;
             } else {
                 // choose optimal insertion node
+                Box *bounds = _rtree_node_get_bounds(rn1);
                 rn2 = rnSplit1;
-                float vol = _rtree_box_expand_volume(rnSplit1->aabb, rn1->aabb, &tmpBox);
-                _rtree_insert_choose_node(rn1->aabb, &tmpBox, rnSplit2, &rn2, &vol);
+                float vol = _rtree_box_expand_volume(rnSplit1->aabb, bounds, &tmpBox);
+                _rtree_insert_choose_node(bounds, &tmpBox, rnSplit2, &rn2, &vol);
             }
 
             // assign to chosen node
@@ -404,7 +443,7 @@ RtreeNode *_rtree_find_leaf(RtreeNode *start, Box *aabb, void *ptr, bool check)
             child = (RtreeNode *)doubly_linked_list_node_pointer(n);
 
             // examine each potential node
-            if (check == false || box_collide(child->aabb, aabb)) {
+            if (check == false || box_collide(_rtree_node_get_bounds(child), aabb)) {
                 fifo_list_push(toExamine, child);
             }
 
@@ -598,6 +637,10 @@ void rtree_insert(Rtree *r, RtreeNode *leaf) {
     // we should only be inserting a leaf (no parent yet)
     vx_assert(leaf->leaf != NULL && leaf->aabb != NULL);
 
+    // leaf is placed according to its current fat aabb
+    Box *bounds = _rtree_node_get_bounds(leaf);
+    leaf->reinsert = false;
+
     selectedNode = r->root;
     level = 1;
 
@@ -613,7 +656,7 @@ void rtree_insert(Rtree *r, RtreeNode *leaf) {
         while (n != NULL) {
             rn = (RtreeNode *)doubly_linked_list_node_pointer(n);
 
-            _rtree_insert_choose_node(leaf->aabb, &tmpBox, rn, &selectedNode, &selectedNodeVol);
+            _rtree_insert_choose_node(bounds, &tmpBox, rn, &selectedNode, &selectedNodeVol);
 
             n = doubly_linked_list_node_next(n);
         }
@@ -632,7 +675,7 @@ void rtree_insert(Rtree *r, RtreeNode *leaf) {
     if (selectedNode->count <= r->M) {
         rn = selectedNode->parent;
         while (rn != NULL) {
-            box_op_merge(rn->aabb, leaf->aabb, rn->aabb);
+            box_op_merge(rn->aabb, bounds, rn->aabb);
             rn = rn->parent;
             INC_BOX_MERGE_COUNT
         }
@@ -742,7 +785,7 @@ void rtree_update(Rtree *r, RtreeNode *leaf, Box *aabb) {
     while (n != NULL) {
         child = (RtreeNode *)doubly_linked_list_node_pointer(n);
         if (child != leaf) {
-            box_op_merge(&tmpBox, child->aabb, &tmpBox);
+            box_op_merge(&tmpBox, _rtree_node_get_bounds(child), &tmpBox);
         }
         n = doubly_linked_list_node_next(n);
     }
@@ -751,7 +794,9 @@ void rtree_update(Rtree *r, RtreeNode *leaf, Box *aabb) {
     // if volume difference is within threshold, keep leaf in place
     if (fabsf(vol - box_get_volume(leaf->parent->aabb)) < RTREE_LEAF_UPDATE_THRESHOLD) {
         box_copy(leaf->aabb, aabb);
+        box_copy(leaf->fatAabb, aabb);
         box_copy(leaf->parent->aabb, &tmpBox);
+        leaf->reinsert = false;
 
         // propagate aabb update upwards
         RtreeNode *rn = leaf->parent->parent;
@@ -765,10 +810,116 @@ void rtree_update(Rtree *r, RtreeNode *leaf, Box *aabb) {
     } else {
         rtree_remove(r, leaf, false);
         box_copy(leaf->aabb, aabb);
+        box_copy(leaf->fatAabb, aabb);
         rtree_insert(r, leaf);
     }
 }
 
+void rtree_update_moving(Rtree *r, RtreeNode *leaf, const Box *aabb, const float3 *motion) {
+    // we should only be updating a leaf already attached to the tree
+    vx_assert(rtree_node_is_leaf(leaf));
+    (void)r;
+
+    box_copy(leaf->aabb, aabb);
+
+    // leaf still within its fat aabb, ancestors do not change
+    Box *fat = leaf->fatAabb;
+    if (box_contains(fat, &aabb->min) && box_contains(fat, &aabb->max)) {
+        return;
+    }
+
+    // enlarge by a margin, and by predicted motion in the direction of motion
+    const float3 m = {motion->x * RTREE_LEAF_FAT_MOTION_FACTOR,
+                      motion->y * RTREE_LEAF_FAT_MOTION_FACTOR,
+                      motion->z * RTREE_LEAF_FAT_MOTION_FACTOR};
+    fat->min.x = aabb->min.x - RTREE_LEAF_FAT_MARGIN + minimum(m.x, 0.0f);
+    fat->min.y = aabb->min.y - RTREE_LEAF_FAT_MARGIN + minimum(m.y, 0.0f);
+    fat->min.z = aabb->min.z - RTREE_LEAF_FAT_MARGIN + minimum(m.z, 0.0f);
+    fat->max.x = aabb->max.x + RTREE_LEAF_FAT_MARGIN + maximum(m.x, 0.0f);
+    fat->max.y = aabb->max.y + RTREE_LEAF_FAT_MARGIN + maximum(m.y, 0.0f);
+    fat->max.z = aabb->max.z + RTREE_LEAF_FAT_MARGIN + maximum(m.z, 0.0f);
+
+    // simulate node volume w/ updated leaf fat aabb, if expansion is over threshold the leaf is
+    // reinserted on next refit rather than now
+    Box tmpBox;
+    box_copy(&tmpBox, fat);
+    DoublyLinkedListNode *n = doubly_linked_list_first(leaf->parent->children);
+    RtreeNode *child;
+    while (n != NULL) {
+        child = (RtreeNode *)doubly_linked_list_node_pointer(n);
+        if (child != leaf) {
+            box_op_merge(&tmpBox, _rtree_node_get_bounds(child), &tmpBox);
+        }
+        n = doubly_linked_list_node_next(n);
+    }
+    if (fabsf(box_get_volume(&tmpBox) - box_get_volume(leaf->parent->aabb)) >=
+        RTREE_LEAF_UPDATE_THRESHOLD) {
+        leaf->reinsert = true;
+    }
+
+    // ancestors only grow until next refit, queries remain exact as leaves use their aabb
+    RtreeNode *rn = leaf->parent;
+    while (rn != NULL) {
+        box_op_merge(rn->aabb, fat, rn->aabb);
+        rn = rn->parent;
+    }
+    _rtree_node_set_aabb_dirty(leaf->parent);
+
+#if DEBUG_RTREE_CALLS
+    debug_rtree_update_calls++;
+#endif
+}
+
+/// Tightens dirty nodes bottom-up, and collects leaves to reinsert within the given budget
+/// @returns whether or not the node still has pending reinsertions below it
+static bool _rtree_refit_node(RtreeNode *rn, FifoList *toReinsert, uint16_t *budget) {
+    DoublyLinkedListNode *n = doubly_linked_list_first(rn->children);
+    RtreeNode *child;
+    bool pending = false;
+    while (n != NULL) {
+        child = (RtreeNode *)doubly_linked_list_node_pointer(n);
+        if (child->leaf != NULL) {
+            if (child->reinsert) {
+                if (*budget > 0) {
+                    fifo_list_push(toReinsert, child);
+                    (*budget)--;
+                } else {
+                    pending = true;
+                }
+            }
+        } else if (child->aabbDirty) {
+            pending = _rtree_refit_node(child, toReinsert, budget) || pending;
+        }
+        n = doubly_linked_list_node_next(n);
+    }
+    if (rn->count > 0) {
+        _rtree_node_reset_aabb(rn);
+    }
+    rn->aabbDirty = pending;
+    return pending;
+}
+
+void rtree_refit(Rtree *r) {
+    if (r->root->aabbDirty == false) {
+        return;
+    }
+
+    FifoList *toReinsert = fifo_list_new();
+    uint16_t budget = RTREE_REFIT_MAX_REINSERTIONS;
+    _rtree_refit_node(r->root, toReinsert, &budget);
+
+    RtreeNode *leaf = (RtreeNode *)fifo_list_pop(toReinsert);
+    while (leaf != NULL) {
+        // leaf may have been reinserted already, when condensing the tree after a removal
+        if (leaf->reinsert) {
+            rtree_remove(r, leaf, false);
+            rtree_insert(r, leaf);
+        }
+        leaf = (RtreeNode *)fifo_list_pop(toReinsert);
+    }
+    fifo_list_free(toReinsert, NULL);
+}
+
 void rtree_refresh_collision_masks(Rtree *r) {
     rtree_recurse(r->root, _rtree_node_reset_collision_masks);
 }
@@ -783,6 +934,7 @@ size_t rtree_query_overlap_func(Rtree *r,
                                 const DoublyLinkedList *excludeLeafPtrs,
                                 FifoList *results,
                                 float epsilon) {
+    PROFILER_ZONE_BEGIN("rtree_query_overlap");
 
     FifoList *toExamine = fifo_list_new();
     DoublyLinkedListNode *n;
@@ -820,6 +972,7 @@ size_t rtree_query_overlap_func(Rtree *r,
 
     fifo_list_free(toExamine, NULL);
 
+    PROFILER_ZONE_END();
     return hits;
 }
 
@@ -853,6 +1006,7 @@ size_t rtree_query_cast_all_func(Rtree *r,
                                  const DoublyLinkedList *excludeLeafPtrs,
                                  DoublyLinkedList *results) {
     vx_assert(results != NULL);
+    PROFILER_ZONE_BEGIN("rtree_query_cast_all");
 
     FifoList *toExamine = fifo_list_new();
     DoublyLinkedListNode *n;
@@ -895,6 +1049,7 @@ size_t rtree_query_cast_all_func(Rtree *r,
 
     fifo_list_free(toExamine, NULL);
 
+    PROFILER_ZONE_END();
     return hits;
 }
 
@@ -981,17 +1136,19 @@ size_t rtree_query_cast_all_box(Rtree *r,
                                 uint16_t collidesWith,
                                 const DoublyLinkedList *excludeLeafPtrs,
                                 DoublyLinkedList *results) {
-
-    return rtree_utils_broadphase_steps(r,
-                                        aabb,
-                                        unit,
-                                        maxDist,
-                                        groups,
-                                        collidesWith,
-                                        rtree_query_cast_all_box_step_func,
-                                        NULL,
-                                        excludeLeafPtrs,
-                                        results);
+    PROFILER_ZONE_BEGIN("rtree_query_cast_all_box");
+    const size_t hits = rtree_utils_broadphase_steps(r,
+                                                     aabb,
+                                                     unit,
+                                                     maxDist,
+                                                     groups,
+                                                     collidesWith,
+                                                     rtree_query_cast_all_box_step_func,
+                                                     NULL,
+                                                     excludeLeafPtrs,
+                                                     results);
+    PROFILER_ZONE_END();
+    return hits;
 }
 
 // MARK: Utils
@@ -1133,12 +1290,21 @@ bool debug_rtree_integrity_check(Rtree *r) {
             success = false;
         }
 
+        if (rn->fatAabb != NULL &&
+            (box_contains_epsilon(rn->fatAabb, &rn->aabb->min, EPSILON_ZERO) == false ||
+             box_contains_epsilon(rn->fatAabb, &rn->aabb->max, EPSILON_ZERO) == false)) {
+
+            cclog_debug("⚠️⚠️⚠️debug_rtree_integrity_check: leaf fat aabb does not contain aabb");
+            success = false;
+        }
+
         n = doubly_linked_list_first(rn->children);
         while (n != NULL) {
             child = (RtreeNode *)doubly_linked_list_node_pointer(n);
 
-            if (box_contains_epsilon(rn->aabb, &child->aabb->min, EPSILON_ZERO) == false ||
-                box_contains_epsilon(rn->aabb, &child->aabb->max, EPSILON_ZERO) == false) {
+            const Box *bounds = _rtree_node_get_bounds(child);
+            if (box_contains_epsilon(rn->aabb, &bounds->min, EPSILON_ZERO) == false ||
+                box_contains_epsilon(rn->aabb, &bounds->max, EPSILON_ZERO) == false) {
 
                 cclog_debug("⚠️⚠️⚠️debug_rtree_integrity_check: parent aabb does not contain "
                             "child aabb");
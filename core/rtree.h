@@ -88,6 +88,14 @@ RtreeNode *rtree_create_and_insert(Rtree *r,
 void rtree_remove(Rtree *r, RtreeNode *leaf, bool freeLeaf);
 void rtree_find_and_remove(Rtree *r, Box *aabb, void *ptr);
 void rtree_update(Rtree *r, RtreeNode *leaf, Box *aabb);
+/// Updates the aabb of a moving leaf, cheaper than rtree_update for objects moving every frame:
+/// the leaf is placed w/ a fat aabb enlarged by a margin & given motion (eg. velocity * dt), and
+/// the tree is only changed once the aabb leaves it. Ancestors boxes are then grown, to be
+/// tightened by rtree_refit, which should be called once per tick. Queries results are identical.
+void rtree_update_moving(Rtree *r, RtreeNode *leaf, const Box *aabb, const float3 *motion);
+/// Refits ancestors of leaves moved since last call bottom-up, and reinserts up to
+/// RTREE_REFIT_MAX_REINSERTIONS leaves which moved too far from their siblings
+void rtree_refit(Rtree *r);
 void rtree_refresh_collision_masks(Rtree *r);
 
 /// MARK: - Queries -
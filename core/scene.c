@@ -7,8 +7,12 @@
 #include "scene.h"
 
 #include <float.h>
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "hash_uint32_int.h"
+#include "profiler.h"
 #include "weakptr.h"
 
 #if DEBUG_SCENE
@@ -28,30 +32,99 @@ struct _Scene {
     // relevant for physics & sync, internal transforms do not need to be accounted for here
     FifoList *removed;
 
-    // rigidbody couples registered & waiting for a call to end-of-collision callback
-    DoublyLinkedList *collisions;
+    // rigidbody couples registered & waiting for a call to end-of-collision callback,
+    // stored inline in registration order, indexed by ordered pair of transform IDs
+    struct _CollisionCouple *collisions;
+    HashUInt32Int *collisionsIndex;
+    uint32_t nbCollisions;
+    uint32_t collisionsCapacity;
 
     // awake volumes can be registered for end-of-frame awake phase
     DoublyLinkedList *awakeBoxes;
 
+    // queues used by scene_refresh, kept to reuse their memory every tick
+    FifoList *toExamine;
+    FifoList *awakeQuery;
+
+    // world positions of dynamic rigidbodies before the last fixed step, indexed by transform ID
+    struct _ScenePreviousPosition *previous;
+    HashUInt32Int *previousIndex;
+    uint32_t nbPrevious;
+    uint32_t previousCapacity;
+
+    // fixed step mode if > 0, time accumulated & not simulated yet
+    TICK_DELTA_SEC_T fixedStep;
+    TICK_DELTA_SEC_T accumulator;
+
     // constant acceleration for the whole Scene (gravity usually)
     float3 constantAcceleration;
+
+    uint32_t frame;
 };
 
-typedef struct {
+typedef struct _CollisionCouple {
+    // weak refs retained once when the couple begins, released when it ends
     Weakptr *t1, *t2;
     float3 wNormal;
+    uint32_t key;
     bool flag;
+    char pad[3];
 } _CollisionCouple;
 
-void _scene_collision_couple_free_func(void *ptr) {
-    _CollisionCouple *cc = (_CollisionCouple *)ptr;
+typedef struct _ScenePreviousPosition {
+    float3 position;
+    uint32_t frame; // frame at which position was recorded
+    uint16_t id;
+    char pad[2];
+} _ScenePreviousPosition;
+
+#define SCENE_COLLISIONS_MIN_CAPACITY 32
+#define SCENE_PREVIOUS_MIN_CAPACITY 32
+
+// snapshot header: version, frame & amount of records
+#define SCENE_SNAPSHOT_HEADER_SIZE 9
+// record header: transform ID & flags, followed by TransformState & optional RigidbodyState
+#define SCENE_SNAPSHOT_RECORD_HEADER_SIZE 3
+#define SCENE_SNAPSHOT_FLAG_RIGIDBODY 1
+// records are followed by the amount of collision couples, each written as transform IDs in
+// registration order, world normal & flag
+#define SCENE_SNAPSHOT_COUPLE_SIZE (2 * sizeof(uint16_t) + sizeof(float3) + sizeof(uint8_t))
+
+static uint32_t _scene_collision_couple_key(const Transform *t1, const Transform *t2) {
+    const uint16_t id1 = transform_get_id(t1);
+    const uint16_t id2 = transform_get_id(t2);
+    return id1 < id2 ? ((uint32_t)id1 << 16) | id2 : ((uint32_t)id2 << 16) | id1;
+}
+
+static void _scene_collision_couple_release(_CollisionCouple *cc) {
     weakptr_release(cc->t1);
     weakptr_release(cc->t2);
-    free(cc);
 }
 
-void _scene_update_rtree(Scene *sc, RigidBody *rb, Transform *t, Box *collider) {
+static bool _scene_collision_couples_reserve(Scene *sc, const uint32_t count) {
+    if (count <= sc->collisionsCapacity) {
+        return true;
+    }
+    uint32_t capacity = sc->collisionsCapacity == 0 ? SCENE_COLLISIONS_MIN_CAPACITY
+                                                    : sc->collisionsCapacity;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+    _CollisionCouple *collisions = (_CollisionCouple *)realloc(sc->collisions,
+                                                               sizeof(_CollisionCouple) * capacity);
+    if (collisions == NULL) {
+        return false;
+    }
+    sc->collisions = collisions;
+    sc->collisionsCapacity = capacity;
+    return true;
+}
+
+void _scene_update_rtree(Scene *sc,
+                         RigidBody *rb,
+                         Transform *t,
+                         Box *collider,
+                         const TICK_DELTA_SEC_T dt) {
     // register awake volume here for new and removed colliders, and for transformations change
     if (rigidbody_is_enabled(rb) && rigidbody_is_collider_valid(rb) &&
         box_is_valid(collider, EPSILON_COLLISION)) {
@@ -66,10 +139,15 @@ void _scene_update_rtree(Scene *sc, RigidBody *rb, Transform *t, Box *collider)
                                                              t));
             scene_register_awake_rigidbody_contacts(sc, rb);
         }
-        // update leaf due to collider or transformations change
+        // update leaf due to collider or transformations change, tree is refit once per tick
         else if (rigidbody_get_collider_dirty(rb) || transform_is_physics_dirty(t)) {
+            float3 motion = float3_zero;
+            if (rigidbody_is_dynamic(rb)) {
+                motion = *rigidbody_get_velocity(rb);
+                float3_op_scale(&motion, (float)dt);
+            }
             scene_register_awake_rigidbody_contacts(sc, rb);
-            rtree_update(sc->rtree, rigidbody_get_rtree_leaf(rb), collider);
+            rtree_update_moving(sc->rtree, rigidbody_get_rtree_leaf(rb), collider, &motion);
             scene_register_awake_rigidbody_contacts(sc, rb);
         }
     }
@@ -114,6 +192,42 @@ bool _scene_standalone_refresh_func(Transform *t, void *ptr) {
     return false;
 }
 
+static void _scene_record_previous_position(Scene *sc, Transform *t) {
+    const uint16_t id = transform_get_id(t);
+    int index;
+    if (hash_uint32_int_get(sc->previousIndex, id, &index) == false) {
+        if (sc->nbPrevious == sc->previousCapacity) {
+            const uint32_t capacity = sc->previousCapacity > 0 ? sc->previousCapacity * 2
+                                                               : SCENE_PREVIOUS_MIN_CAPACITY;
+            _ScenePreviousPosition *previous = (_ScenePreviousPosition *)realloc(
+                sc->previous,
+                sizeof(_ScenePreviousPosition) * capacity);
+            if (previous == NULL) {
+                return;
+            }
+            sc->previous = previous;
+            sc->previousCapacity = capacity;
+        }
+        index = (int)sc->nbPrevious++;
+        hash_uint32_int_set(sc->previousIndex, id, index);
+    }
+    sc->previous[index] = (_ScenePreviousPosition){*transform_get_position(t, false),
+                                                   sc->frame,
+                                                   id,
+                                                   {0}};
+}
+
+static void _scene_snapshot_write(uint8_t *buffer,
+                                  const size_t capacity,
+                                  size_t *size,
+                                  const void *data,
+                                  const size_t n) {
+    if (*size + n <= capacity) {
+        memcpy(buffer + *size, data, n);
+    }
+    *size += n;
+}
+
 void _scene_register_removed_transform(Scene *sc, Transform *t) {
     if (sc == NULL || t == NULL) {
         return;
@@ -135,9 +249,21 @@ Scene *scene_new(Weakptr *g) {
         sc->wptr = NULL;
         sc->game = g;
         sc->removed = fifo_list_new();
-        sc->collisions = doubly_linked_list_new();
+        sc->collisions = NULL;
+        sc->collisionsIndex = hash_uint32_int_new();
+        sc->nbCollisions = 0;
+        sc->collisionsCapacity = 0;
         sc->awakeBoxes = doubly_linked_list_new();
+        sc->toExamine = fifo_list_new();
+        sc->awakeQuery = fifo_list_new();
+        sc->previous = NULL;
+        sc->previousIndex = hash_uint32_int_new();
+        sc->nbPrevious = 0;
+        sc->previousCapacity = 0;
+        sc->fixedStep = 0.0;
+        sc->accumulator = 0.0;
         float3_set(&sc->constantAcceleration, 0.0f, 0.0f, 0.0f);
+        sc->frame = 0;
 
         transform_set_parent(sc->system, sc->root, false);
     }
@@ -160,10 +286,17 @@ void scene_free(Scene *sc) {
     rtree_free(sc->rtree);
     weakptr_invalidate(sc->wptr);
     fifo_list_free(sc->removed, NULL);
-    doubly_linked_list_flush(sc->collisions, _scene_collision_couple_free_func);
-    doubly_linked_list_free(sc->collisions);
+    for (uint32_t i = 0; i < sc->nbCollisions; ++i) {
+        _scene_collision_couple_release(&sc->collisions[i]);
+    }
+    free(sc->collisions);
+    hash_uint32_int_free(sc->collisionsIndex);
     doubly_linked_list_flush(sc->awakeBoxes, box_free_std);
     doubly_linked_list_free(sc->awakeBoxes);
+    fifo_list_free(sc->toExamine, NULL);
+    fifo_list_free(sc->awakeQuery, NULL);
+    free(sc->previous);
+    hash_uint32_int_free(sc->previousIndex);
 
     free(sc);
 }
@@ -198,15 +331,13 @@ Rtree *scene_get_rtree(Scene *sc) {
     return sc->rtree;
 }
 
-void scene_refresh(Scene *sc, const TICK_DELTA_SEC_T dt, void *callbackData) {
-    if (sc == NULL) {
-        return;
-    }
+static void _scene_step(Scene *sc, const TICK_DELTA_SEC_T dt, void *callbackData) {
+    PROFILER_ZONE_BEGIN("scene_refresh");
 #if DEBUG_RIGIDBODY_EXTRA_LOGS
     cclog_debug("🏞 physics step");
 #endif
 
-    FifoList *toExamine = fifo_list_new();
+    FifoList *toExamine = sc->toExamine;
     Transform *t = sc->root, *child = NULL;
     DoublyLinkedListNode *n;
     while (t != NULL) {
@@ -227,9 +358,13 @@ void scene_refresh(Scene *sc, const TICK_DELTA_SEC_T dt, void *callbackData) {
 
         if (rb != NULL) {
             // Update r-tree (top-first) after sandbox changes
-            _scene_update_rtree(sc, rb, t, &collider);
+            _scene_update_rtree(sc, rb, t, &collider, dt);
             _scene_refresh_rtree_collision_masks(rb);
 
+            if (sc->fixedStep > 0.0 && rigidbody_is_dynamic(rb)) {
+                _scene_record_previous_position(sc, t);
+            }
+
             // Step physics (top-first), collider is kept up-to-date
             const bool moved = rigidbody_tick(sc, rb, t, &collider, sc->rtree, dt, callbackData);
 
@@ -240,7 +375,7 @@ void scene_refresh(Scene *sc, const TICK_DELTA_SEC_T dt, void *callbackData) {
                 // Update r-tree (top-first) after physics changes
                 if (rb != NULL) {
                     transform_get_or_compute_world_aligned_collider(t, &collider, false);
-                    _scene_update_rtree(sc, rb, t, &collider);
+                    _scene_update_rtree(sc, rb, t, &collider, dt);
                 }
             }
         }
@@ -261,7 +396,9 @@ void scene_refresh(Scene *sc, const TICK_DELTA_SEC_T dt, void *callbackData) {
 
         t = (Transform *)fifo_list_pop(toExamine);
     }
-    fifo_list_free(toExamine, NULL);
+
+    // tighten r-tree after this tick's moves
+    rtree_refit(sc->rtree);
 
 #if DEBUG_RTREE_CHECK
     vx_assert(debug_rtree_integrity_check(sc->rtree));
@@ -296,33 +433,38 @@ void scene_refresh(Scene *sc, const TICK_DELTA_SEC_T dt, void *callbackData) {
         t = (Transform *)fifo_list_pop(sc->removed);
     }
 
-    // process collision couples for end-of-contact callback
-    n = doubly_linked_list_first(sc->collisions);
-    _CollisionCouple *cc;
+    // process collision couples for end-of-contact callback, compacting the array in place
+    // to keep registration order (couples registered from callbacks are appended & processed)
+    _CollisionCouple cc;
     Transform *t2;
-    while (n != NULL) {
-        cc = (_CollisionCouple *)doubly_linked_list_node_pointer(n);
-        t = weakptr_get(cc->t1);
-        t2 = weakptr_get(cc->t2);
-
-        if (t == NULL || t2 == NULL || cc->flag == false) {
+    uint32_t kept = 0;
+    int index;
+    for (uint32_t i = 0; i < sc->nbCollisions; ++i) {
+        cc = sc->collisions[i];
+        t = weakptr_get(cc.t1);
+        t2 = weakptr_get(cc.t2);
+
+        if (t == NULL || t2 == NULL || cc.flag == false) {
+            // a stale couple may share its key with a newer one, only the indexed one is removed
+            if (hash_uint32_int_get(sc->collisionsIndex, cc.key, &index) && (uint32_t)index == i) {
+                hash_uint32_int_delete(sc->collisionsIndex, cc.key);
+            }
             if (t != NULL && t2 != NULL) {
                 rigidbody_fire_reciprocal_collision_end_callback(t, t2, callbackData);
             }
-
-            _scene_collision_couple_free_func(cc);
-
-            DoublyLinkedListNode *next = doubly_linked_list_node_next(n);
-            doubly_linked_list_delete_node(sc->collisions, n);
-            n = next;
+            _scene_collision_couple_release(&cc);
         } else {
-            cc->flag = false;
-            n = doubly_linked_list_node_next(n);
+            cc.flag = false;
+            if (kept != i) {
+                hash_uint32_int_set(sc->collisionsIndex, cc.key, (int)kept);
+            }
+            sc->collisions[kept++] = cc;
         }
     }
+    sc->nbCollisions = kept;
 
     // awake phase
-    FifoList *awakeQuery = fifo_list_new();
+    FifoList *awakeQuery = sc->awakeQuery;
     Box *awakeBox;
     n = doubly_linked_list_first(sc->awakeBoxes);
     while (n != NULL) {
@@ -361,10 +503,35 @@ void scene_refresh(Scene *sc, const TICK_DELTA_SEC_T dt, void *callbackData) {
         n = next;
         box_free(awakeBox);
     }
-    fifo_list_free(awakeQuery, NULL);
 
     // physics layers mask changes take effect in the rtree once each frame
     rtree_refresh_collision_masks(sc->rtree);
+
+    sc->frame++;
+
+    PROFILER_ZONE_END();
+}
+
+void scene_refresh(Scene *sc, const TICK_DELTA_SEC_T dt, void *callbackData) {
+    if (sc == NULL) {
+        return;
+    }
+    if (sc->fixedStep <= 0.0) {
+        _scene_step(sc, dt, callbackData);
+        return;
+    }
+
+    sc->accumulator += dt;
+    uint32_t steps = 0;
+    while (sc->accumulator >= sc->fixedStep && steps < SCENE_FIXED_STEP_MAX_STEPS) {
+        _scene_step(sc, sc->fixedStep, callbackData);
+        sc->accumulator -= sc->fixedStep;
+        ++steps;
+    }
+    // simulation can't keep up, drop time left behind
+    if (sc->accumulator >= sc->fixedStep) {
+        sc->accumulator = fmod(sc->accumulator, sc->fixedStep);
+    }
 }
 
 void scene_standalone_refresh(Scene *sc) {
@@ -420,15 +587,6 @@ void scene_register_managed_transform(Scene *sc, Transform *t) {
     transform_set_managed_ptr(t, sc->game);
 }
 
-bool _scene_register_collision_couple_func(void *ptr, void *data) {
-    const _CollisionCouple *cc1 = (_CollisionCouple *)ptr;
-    const _CollisionCouple *cc2 = (_CollisionCouple *)data;
-    return (weakptr_get(cc1->t1) == weakptr_get(cc2->t1) &&
-            weakptr_get(cc1->t2) == weakptr_get(cc2->t2)) ||
-           (weakptr_get(cc1->t1) == weakptr_get(cc2->t2) &&
-            weakptr_get(cc1->t2) == weakptr_get(cc2->t1));
-}
-
 CollisionCoupleStatus scene_register_collision_couple(Scene *sc,
                                                       Transform *t1,
                                                       Transform *t2,
@@ -438,33 +596,284 @@ CollisionCoupleStatus scene_register_collision_couple(Scene *sc,
     }
     vx_assert(wNormal != NULL);
 
-    _CollisionCouple *newCC = (_CollisionCouple *)malloc(sizeof(_CollisionCouple));
-    if (newCC == NULL) {
+    const uint32_t key = _scene_collision_couple_key(t1, t2);
+    int index;
+    if (hash_uint32_int_get(sc->collisionsIndex, key, &index)) {
+        _CollisionCouple *existingCC = &sc->collisions[index];
+        Transform *e1 = (Transform *)weakptr_get(existingCC->t1);
+        Transform *e2 = (Transform *)weakptr_get(existingCC->t2);
+
+        // IDs are recycled, a couple is stale if one of its transforms was freed
+        if ((e1 == t1 && e2 == t2) || (e1 == t2 && e2 == t1)) {
+            *wNormal = existingCC->wNormal;
+            if (existingCC->flag) {
+                return CollisionCoupleStatus_Discard;
+            } else {
+                existingCC->flag = true;
+                return CollisionCoupleStatus_Tick;
+            }
+        }
+    }
+
+    if (_scene_collision_couples_reserve(sc, sc->nbCollisions + 1) == false) {
         return CollisionCoupleStatus_Discard;
     }
+
+    // stale couple, if any, stays in the array to be removed at end-of-frame
+    _CollisionCouple *newCC = &sc->collisions[sc->nbCollisions];
     newCC->t1 = transform_get_and_retain_weakptr(t1);
     newCC->t2 = transform_get_and_retain_weakptr(t2);
     newCC->wNormal = *wNormal;
+    newCC->key = key;
     newCC->flag = true;
+    hash_uint32_int_set(sc->collisionsIndex, key, (int)sc->nbCollisions);
+    ++sc->nbCollisions;
 
-    _CollisionCouple *existingCC;
-    if (doubly_linked_list_contains_func(sc->collisions,
-                                         _scene_register_collision_couple_func,
-                                         newCC,
-                                         (void **)&existingCC)) {
-        _scene_collision_couple_free_func(newCC);
-        *wNormal = existingCC->wNormal;
-        if (existingCC->flag) {
-            return CollisionCoupleStatus_Discard;
-        } else {
-            existingCC->flag = true;
-            return CollisionCoupleStatus_Tick;
+    return CollisionCoupleStatus_Begin;
+}
+
+// MARK: - Fixed step -
+
+void scene_set_fixed_step(Scene *sc, const TICK_DELTA_SEC_T step) {
+    sc->fixedStep = step > 0.0 ? step : 0.0;
+    sc->accumulator = 0.0;
+}
+
+TICK_DELTA_SEC_T scene_get_fixed_step(const Scene *sc) {
+    return sc->fixedStep;
+}
+
+void scene_step(Scene *sc, void *callbackData) {
+    vx_assert(sc->fixedStep > 0.0);
+    _scene_step(sc, sc->fixedStep, callbackData);
+}
+
+uint32_t scene_get_frame(const Scene *sc) {
+    return sc->frame;
+}
+
+float scene_get_fixed_step_alpha(const Scene *sc) {
+    return sc->fixedStep > 0.0 ? (float)(sc->accumulator / sc->fixedStep) : 0.0f;
+}
+
+void scene_get_interpolated_position(Scene *sc, Transform *t, float3 *out) {
+    *out = *transform_get_position(t, true);
+
+    int index;
+    if (sc->fixedStep > 0.0 &&
+        hash_uint32_int_get(sc->previousIndex, transform_get_id(t), &index) &&
+        sc->previous[index].frame + 1 == sc->frame) {
+
+        const float3 *previous = &sc->previous[index].position;
+        const float alpha = scene_get_fixed_step_alpha(sc);
+        out->x = previous->x + (out->x - previous->x) * alpha;
+        out->y = previous->y + (out->y - previous->y) * alpha;
+        out->z = previous->z + (out->z - previous->z) * alpha;
+    }
+}
+
+// MARK: - Snapshots -
+
+size_t scene_write_snapshot(Scene *sc, void *buffer, const size_t capacity) {
+    uint8_t *bytes = (uint8_t *)buffer;
+    size_t size = SCENE_SNAPSHOT_HEADER_SIZE;
+    uint32_t count = 0;
+
+    FifoList *toExamine = sc->toExamine;
+    Transform *t = sc->root;
+    TransformState ts;
+    RigidbodyState rs;
+    while (t != NULL) {
+        RigidBody *rb = transform_get_rigidbody(t);
+        const uint16_t id = transform_get_id(t);
+        const uint8_t flags = rb != NULL ? SCENE_SNAPSHOT_FLAG_RIGIDBODY : 0;
+        _scene_snapshot_write(bytes, capacity, &size, &id, sizeof(uint16_t));
+        _scene_snapshot_write(bytes, capacity, &size, &flags, sizeof(uint8_t));
+        transform_get_state(t, &ts);
+        _scene_snapshot_write(bytes, capacity, &size, &ts, sizeof(TransformState));
+        if (rb != NULL) {
+            rigidbody_get_state(rb, &rs);
+            _scene_snapshot_write(bytes, capacity, &size, &rs, sizeof(RigidbodyState));
+        }
+        ++count;
+
+        DoublyLinkedListNode *n = transform_get_children_iterator(t);
+        while (n != NULL) {
+            fifo_list_push(toExamine, doubly_linked_list_node_pointer(n));
+            n = doubly_linked_list_node_next(n);
         }
+        t = (Transform *)fifo_list_pop(toExamine);
     }
 
-    doubly_linked_list_push_last(sc->collisions, newCC);
+    // couples of freed transforms are skipped, they would end w/o callback
+    const size_t couplesOffset = size;
+    uint32_t nbCouples = 0;
+    _scene_snapshot_write(bytes, capacity, &size, &nbCouples, sizeof(uint32_t));
+    for (uint32_t i = 0; i < sc->nbCollisions; ++i) {
+        const _CollisionCouple *cc = &sc->collisions[i];
+        Transform *t1 = (Transform *)weakptr_get(cc->t1);
+        Transform *t2 = (Transform *)weakptr_get(cc->t2);
+        if (t1 == NULL || t2 == NULL) {
+            continue;
+        }
+        const uint16_t id1 = transform_get_id(t1);
+        const uint16_t id2 = transform_get_id(t2);
+        const uint8_t flag = cc->flag ? 1 : 0;
+        _scene_snapshot_write(bytes, capacity, &size, &id1, sizeof(uint16_t));
+        _scene_snapshot_write(bytes, capacity, &size, &id2, sizeof(uint16_t));
+        _scene_snapshot_write(bytes, capacity, &size, &cc->wNormal, sizeof(float3));
+        _scene_snapshot_write(bytes, capacity, &size, &flag, sizeof(uint8_t));
+        ++nbCouples;
+    }
 
-    return CollisionCoupleStatus_Begin;
+    if (size <= capacity) {
+        memcpy(bytes + couplesOffset, &nbCouples, sizeof(uint32_t));
+        bytes[0] = SCENE_SNAPSHOT_VERSION;
+        memcpy(bytes + 1, &sc->frame, sizeof(uint32_t));
+        memcpy(bytes + 5, &count, sizeof(uint32_t));
+    }
+    return size;
+}
+
+bool scene_restore_snapshot(Scene *sc, const void *snapshot, const size_t size) {
+    const uint8_t *bytes = (const uint8_t *)snapshot;
+    if (size < SCENE_SNAPSHOT_HEADER_SIZE || bytes[0] != SCENE_SNAPSHOT_VERSION) {
+        return false;
+    }
+    uint32_t frame, count;
+    memcpy(&frame, bytes + 1, sizeof(uint32_t));
+    memcpy(&count, bytes + 5, sizeof(uint32_t));
+
+    // index records by transform ID
+    HashUInt32Int *records = hash_uint32_int_new();
+    size_t offset = SCENE_SNAPSHOT_HEADER_SIZE;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (offset + SCENE_SNAPSHOT_RECORD_HEADER_SIZE > size) {
+            break;
+        }
+        uint16_t id;
+        memcpy(&id, bytes + offset, sizeof(uint16_t));
+        const uint8_t flags = bytes[offset + 2];
+        hash_uint32_int_set(records, id, (int)offset);
+        offset += SCENE_SNAPSHOT_RECORD_HEADER_SIZE + sizeof(TransformState);
+        if ((flags & SCENE_SNAPSHOT_FLAG_RIGIDBODY) != 0) {
+            offset += sizeof(RigidbodyState);
+        }
+    }
+    uint32_t nbCouples = 0;
+    if (offset + sizeof(uint32_t) <= size) {
+        memcpy(&nbCouples, bytes + offset, sizeof(uint32_t));
+    }
+    const size_t couplesOffset = offset + sizeof(uint32_t);
+    if (couplesOffset + (size_t)nbCouples * SCENE_SNAPSHOT_COUPLE_SIZE != size) {
+        hash_uint32_int_free(records);
+        return false;
+    }
+
+    // transforms referenced by couples, resolved while walking the hierarchy
+    HashUInt32Int *coupled = hash_uint32_int_new();
+    Transform **resolved = NULL;
+    uint32_t nbResolved = 0;
+    if (nbCouples > 0) {
+        resolved = (Transform **)malloc(sizeof(Transform *) * 2 * nbCouples);
+        if (resolved == NULL) {
+            hash_uint32_int_free(coupled);
+            hash_uint32_int_free(records);
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < 2 * nbCouples; ++i) {
+        uint16_t id;
+        memcpy(&id,
+               bytes + couplesOffset + (i / 2) * SCENE_SNAPSHOT_COUPLE_SIZE +
+                   (i % 2) * sizeof(uint16_t),
+               sizeof(uint16_t));
+        int slot;
+        if (hash_uint32_int_get(coupled, id, &slot) == false) {
+            hash_uint32_int_set(coupled, id, (int)nbResolved);
+            resolved[nbResolved++] = NULL;
+        }
+    }
+
+    // parents are restored before their children
+    FifoList *toExamine = sc->toExamine;
+    Transform *t = sc->root;
+    TransformState ts;
+    RigidbodyState rs;
+    int record, slot;
+    while (t != NULL) {
+        if (hash_uint32_int_get(coupled, transform_get_id(t), &slot)) {
+            resolved[slot] = t;
+        }
+        if (hash_uint32_int_get(records, transform_get_id(t), &record)) {
+            const uint8_t *data = bytes + record + SCENE_SNAPSHOT_RECORD_HEADER_SIZE;
+            memcpy(&ts, data, sizeof(TransformState));
+            transform_set_state(t, &ts);
+
+            RigidBody *rb = transform_get_rigidbody(t);
+            if (rb != NULL &&
+                (bytes[record + 2] & SCENE_SNAPSHOT_FLAG_RIGIDBODY) != 0) {
+                memcpy(&rs, data + sizeof(TransformState), sizeof(RigidbodyState));
+                rigidbody_set_state(rb, &rs);
+
+                // r-tree leaf as it was after the snapshot step, w/o waking up neighbors
+                RtreeNode *leaf = rigidbody_get_rtree_leaf(rb);
+                if (leaf != NULL) {
+                    Box collider;
+                    transform_refresh(t, false, true);
+                    transform_get_or_compute_world_aligned_collider(t, &collider, false);
+                    rtree_update(sc->rtree, leaf, &collider);
+                    transform_reset_physics_dirty(t);
+                }
+            }
+        }
+
+        DoublyLinkedListNode *n = transform_get_children_iterator(t);
+        while (n != NULL) {
+            fifo_list_push(toExamine, doubly_linked_list_node_pointer(n));
+            n = doubly_linked_list_node_next(n);
+        }
+        t = (Transform *)fifo_list_pop(toExamine);
+    }
+    hash_uint32_int_free(records);
+
+    // current couples are dropped w/o end-of-collision callback, as if they never began
+    for (uint32_t i = 0; i < sc->nbCollisions; ++i) {
+        hash_uint32_int_delete(sc->collisionsIndex, sc->collisions[i].key);
+        _scene_collision_couple_release(&sc->collisions[i]);
+    }
+    sc->nbCollisions = 0;
+
+    if (_scene_collision_couples_reserve(sc, nbCouples)) {
+        for (uint32_t i = 0; i < nbCouples; ++i) {
+            const uint8_t *data = bytes + couplesOffset + i * SCENE_SNAPSHOT_COUPLE_SIZE;
+            uint16_t id1, id2;
+            memcpy(&id1, data, sizeof(uint16_t));
+            memcpy(&id2, data + sizeof(uint16_t), sizeof(uint16_t));
+
+            int slot1, slot2;
+            hash_uint32_int_get(coupled, id1, &slot1);
+            hash_uint32_int_get(coupled, id2, &slot2);
+            Transform *t1 = resolved[slot1], *t2 = resolved[slot2];
+            if (t1 == NULL || t2 == NULL) {
+                continue;
+            }
+
+            _CollisionCouple *cc = &sc->collisions[sc->nbCollisions];
+            cc->t1 = transform_get_and_retain_weakptr(t1);
+            cc->t2 = transform_get_and_retain_weakptr(t2);
+            memcpy(&cc->wNormal, data + 2 * sizeof(uint16_t), sizeof(float3));
+            cc->key = _scene_collision_couple_key(t1, t2);
+            cc->flag = data[2 * sizeof(uint16_t) + sizeof(float3)] != 0;
+            hash_uint32_int_set(sc->collisionsIndex, cc->key, (int)sc->nbCollisions);
+            ++sc->nbCollisions;
+        }
+    }
+    free(resolved);
+    hash_uint32_int_free(coupled);
+
+    sc->frame = frame;
+    return true;
 }
 
 // MARK: - Physics -
@@ -543,6 +952,29 @@ void scene_register_awake_block_box(Scene *sc,
     scene_register_awake_box(sc, worldBox);
 }
 
+void scene_register_awake_blocks_box(Scene *sc,
+                                     const Transform *t,
+                                     const SHAPE_COORDS_INT3_T min,
+                                     const SHAPE_COORDS_INT3_T max) {
+
+    Matrix4x4 model;
+    transform_utils_get_model_ltw(t, &model);
+
+    const Box modelBox = {{(float)min.x, (float)min.y, (float)min.z},
+                          {(float)max.x, (float)max.y, (float)max.z}};
+    Box aabb;
+    box_to_aabox2(&modelBox, &aabb, &model, NULL, NoSquarify);
+
+    Box *worldBox = box_new_2(aabb.min.x - PHYSICS_AWAKE_DISTANCE,
+                              aabb.min.y - PHYSICS_AWAKE_DISTANCE,
+                              aabb.min.z - PHYSICS_AWAKE_DISTANCE,
+                              aabb.max.x + PHYSICS_AWAKE_DISTANCE,
+                              aabb.max.y + PHYSICS_AWAKE_DISTANCE,
+                              aabb.max.z + PHYSICS_AWAKE_DISTANCE);
+
+    scene_register_awake_box(sc, worldBox);
+}
+
 CastResult scene_cast_result_default(void) {
     CastResult hit;
     hit.hitTr = NULL;
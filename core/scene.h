@@ -46,8 +46,16 @@ Transform *scene_get_root(Scene *sc);
 Transform *scene_get_system_root(Scene *sc);
 Rtree *scene_get_rtree(Scene *sc);
 
+// fixed steps simulated per scene_refresh at most, time left behind is dropped
+#define SCENE_FIXED_STEP_MAX_STEPS 8
+#define SCENE_SNAPSHOT_VERSION 2
+
 /// Perform transform refreshes, update the r-tree, step the physics engine,
 /// handle transform removal and collision callbacks
+///
+/// In fixed step mode, `dt` is accumulated & as many fixed steps as fit are simulated, possibly
+/// none. Each step processes transforms in hierarchy order, and contacts of equal distance are
+/// resolved by transform ID, for a given state to always lead to the same results.
 void scene_refresh(Scene *sc, const TICK_DELTA_SEC_T dt, void *callbackData);
 
 /// A standalone refresh can be called to solely refresh transforms in special cases where waiting
@@ -81,6 +89,40 @@ CollisionCoupleStatus scene_register_collision_couple(Scene *sc,
                                                       Transform *t2,
                                                       float3 *wNormal);
 
+// MARK: - Fixed step -
+
+/// Opt-in fixed timestep, 0 to step with scene_refresh `dt` (default)
+void scene_set_fixed_step(Scene *sc, const TICK_DELTA_SEC_T step);
+TICK_DELTA_SEC_T scene_get_fixed_step(const Scene *sc);
+
+/// Simulates one fixed step, eg. to simulate frames again after scene_restore_snapshot
+void scene_step(Scene *sc, void *callbackData);
+
+/// Amount of steps simulated since scene creation, restored with snapshots
+uint32_t scene_get_frame(const Scene *sc);
+
+/// Time accumulated & not simulated yet, as a ratio of fixed step in [0, 1)
+float scene_get_fixed_step_alpha(const Scene *sc);
+
+/// World position of a dynamic rigidbody, interpolated between the last two fixed steps by
+/// scene_get_fixed_step_alpha. Current world position for other transforms.
+void scene_get_interpolated_position(Scene *sc, Transform *t, float3 *out);
+
+// MARK: - Snapshots -
+
+/// Writes local transformations & rigidbodies simulation state of all transforms in the scene
+/// hierarchy, along with the frame number & ongoing collision couples, if the snapshot fits in `capacity` bytes. Returns the
+/// snapshot size in bytes, in native endianness.
+size_t scene_write_snapshot(Scene *sc, void *buffer, const size_t capacity);
+
+/// Restores transforms still in the scene, matched by ID, transforms created after the snapshot
+/// are left untouched. R-tree leaves are updated right away. Ongoing collision couples are
+/// replaced by the ones in the snapshot, w/o firing end-of-collision callbacks, so that steps
+/// simulated after a restore fire the same callbacks. Couples of transforms no longer in the
+/// scene are dropped.
+/// Returns false if snapshot isn't valid.
+bool scene_restore_snapshot(Scene *sc, const void *snapshot, const size_t size);
+
 // MARK: - Physics -
 
 void scene_set_constant_acceleration(Scene *sc, const float *x, const float *y, const float *z);
@@ -95,6 +137,11 @@ void scene_register_awake_block_box(Scene *sc,
                                     const SHAPE_COORDS_INT_T x,
                                     const SHAPE_COORDS_INT_T y,
                                     const SHAPE_COORDS_INT_T z);
+/// Same for a box of blocks, from `min` (included) to `max` (excluded) in model coordinates
+void scene_register_awake_blocks_box(Scene *sc,
+                                     const Transform *t,
+                                     const SHAPE_COORDS_INT3_T min,
+                                     const SHAPE_COORDS_INT3_T max);
 
 typedef enum {
     Hit_None,
@@ -10,12 +10,30 @@
 #include <string.h>
 
 #include "cclog.h"
+#include "profiler.h"
 #include "serialization_v5.h"
 #include "serialization_v6.h"
 #include "stream.h"
 #include "transform.h"
 #include "zlib.h"
 
+static DoublyLinkedList *_serialization_load_assets(Stream *s,
+                                                    const char *fullname,
+                                                    AssetType filterMask,
+                                                    ColorAtlas *colorAtlas,
+                                                    const LoadShapeSettings *const shapeSettings,
+                                                    const bool allowLegacy);
+
+static vx_thread_local SerializationLoadTimings *_loadTimings = NULL;
+
+void serialization_set_load_timings(SerializationLoadTimings *timings) {
+    _loadTimings = timings;
+}
+
+SerializationLoadTimings *serialization_get_load_timings(void) {
+    return _loadTimings;
+}
+
 // Returns 0 on success, 1 otherwise.
 // This function doesn't close the file descriptor, you probably want to close
 // it in the calling context, when an error occurs.
@@ -99,6 +117,23 @@ DoublyLinkedList *serialization_load_assets(Stream *s,
                                             ColorAtlas *colorAtlas,
                                             const LoadShapeSettings *const shapeSettings,
                                             const bool allowLegacy) {
+    PROFILER_ZONE_BEGIN("serialization_load_assets");
+    DoublyLinkedList *list = _serialization_load_assets(s,
+                                                        fullname,
+                                                        filterMask,
+                                                        colorAtlas,
+                                                        shapeSettings,
+                                                        allowLegacy);
+    PROFILER_ZONE_END();
+    return list;
+}
+
+static DoublyLinkedList *_serialization_load_assets(Stream *s,
+                                                    const char *fullname,
+                                                    AssetType filterMask,
+                                                    ColorAtlas *colorAtlas,
+                                                    const LoadShapeSettings *const shapeSettings,
+                                                    const bool allowLegacy) {
     if (s == NULL) {
         cclog_error("can't load asset from NULL Stream");
         return NULL; // error
@@ -211,7 +246,9 @@ bool serialization_save_shape(Shape *shape,
         return false;
     }
 
+    PROFILER_ZONE_BEGIN("serialization_save_shape");
     const bool success = serialization_v6_save_shape(shape, imageData, imageDataSize, fd);
+    PROFILER_ZONE_END();
 
     fclose(fd);
     return success;
@@ -228,13 +265,15 @@ bool serialization_save_shape_as_buffer(Shape *shape,
                                         const uint32_t previewDataSize,
                                         void **outBuffer,
                                         uint32_t *outBufferSize) {
-
-    return serialization_v6_save_shape_as_buffer(shape,
-                                                 artistPalette,
-                                                 previewData,
-                                                 previewDataSize,
-                                                 outBuffer,
-                                                 outBufferSize);
+    PROFILER_ZONE_BEGIN("serialization_save_shape_as_buffer");
+    const bool success = serialization_v6_save_shape_as_buffer(shape,
+                                                               artistPalette,
+                                                               previewData,
+                                                               previewDataSize,
+                                                               outBuffer,
+                                                               outBufferSize);
+    PROFILER_ZONE_END();
+    return success;
 }
 
 // =============================================================================
@@ -111,6 +111,17 @@ DoublyLinkedList *serialization_load_assets(Stream *s,
                                             const bool allowLegacy);
 void serialization_assets_free_func(void *ptr);
 
+/// Optional timings of the load stages, in nanoseconds.
+/// Durations are added up, so the same struct can be used for several loads.
+typedef struct {
+    uint64_t inflate_ns; // chunks decompression
+    uint64_t build_ns;   // blocks insertion in shapes
+} SerializationLoadTimings;
+
+/// Sets timings collected by loads running on the calling thread, NULL to stop collecting.
+void serialization_set_load_timings(SerializationLoadTimings *timings);
+SerializationLoadTimings *serialization_get_load_timings(void);
+
 /// serialize a shape w/ its palette
 bool serialization_save_shape(Shape *shape,
                               const void *imageData,
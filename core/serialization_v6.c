@@ -14,6 +14,7 @@
 #include "serialization.h"
 #include "stream.h"
 #include "transform.h"
+#include "utils.h"
 #include "zlib.h"
 
 typedef enum P3sCompressionMethod {
@@ -652,6 +653,9 @@ bool chunk_v6_read(void **chunkData, uint32_t *chunkSize, uint32_t *uncompressed
 
     // uncompress if required by this chunk
     if (_isCompressed != 0) {
+        SerializationLoadTimings *timings = serialization_get_load_timings();
+        const uint64_t start = timings != NULL ? utils_time_ns() : 0;
+
         uLong resultSize = _uncompressedSize;
         void *uncompressedData = malloc(_uncompressedSize);
         if (uncompress(uncompressedData, &resultSize, _chunkData, _chunkSize) != Z_OK) {
@@ -661,6 +665,10 @@ bool chunk_v6_read(void **chunkData, uint32_t *chunkSize, uint32_t *uncompressed
         }
         free(_chunkData);
 
+        if (timings != NULL) {
+            timings->inflate_ns += utils_time_ns() - start;
+        }
+
         *chunkData = uncompressedData;
     } else {
         *chunkData = _chunkData;
@@ -1167,6 +1175,9 @@ uint32_t chunk_v6_read_shape(Stream *s,
 
     // process blocks now
     if (shapeBlocksCursor != NULL) {
+        SerializationLoadTimings *timings = serialization_get_load_timings();
+        const uint64_t start = timings != NULL ? utils_time_ns() : 0;
+
         chunk_v6_read_shape_process_blocks(shapeBlocksCursor,
                                            *shape,
                                            width,
@@ -1174,6 +1185,10 @@ uint32_t chunk_v6_read_shape(Stream *s,
                                            depth,
                                            paletteID,
                                            shrinkPalette ? filePalette : NULL);
+
+        if (timings != NULL) {
+            timings->build_ns += utils_time_ns() - start;
+        }
     }
 
     free(chunkData);
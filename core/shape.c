@@ -15,6 +15,8 @@
 #include "config.h"
 #include "easings.h"
 #include "history.h"
+#include "job_system.h"
+#include "profiler.h"
 #include "rigidBody.h"
 #include "scene.h"
 #include "transaction.h"
@@ -37,6 +39,9 @@
 // no automatic refresh, no model changes until unlocked
 #define SHAPE_RENDERING_FLAG_BAKE_LOCKED 16
 
+// chunks meshed in parallel per thread, before writing their vertices
+#define SHAPE_MESH_BATCH_PER_THREAD 8
+
 #define SHAPE_LUA_FLAG_NONE 0
 #define SHAPE_LUA_FLAG_MUTABLE 1
 #define SHAPE_LUA_FLAG_HISTORY 2
@@ -62,6 +67,12 @@ struct _Shape {
 
     // buffers storing vertex data used for rendering, latest buffer is inserted after first
     VertexBuffer *firstVB_opaque, *firstVB_transparent;
+    // same for coarser chunk LOD levels, opaque & transparent, see shape_set_lods_enabled
+    VertexBuffer *firstVB_lod[CHUNK_LOD_COUNT - 1][2];
+
+    // model space position LOD levels are selected from, see shape_get_chunk_lod
+    float3 lodCameraPosition; // 12 bytes
+    float lodDistance;        // 4 bytes
 
     // Chunks are indexed by coordinates, and partitioned in a r-tree for physics queries
     Index3D *chunks;
@@ -77,6 +88,10 @@ struct _Shape {
     // Current shape transaction, to be applied at end of frame (lua coords)
     Transaction *pendingTransaction;
 
+    // Changes made by the pending transaction when kept pending & applied several times,
+    // pushed to history at once
+    HistoryChanges *pendingChanges;
+
     // name of the original item <username>.<itemname>, used for baked files
     char *fullname;
 
@@ -97,9 +112,30 @@ struct _Shape {
     uint8_t renderingFlags; // 1 byte
     uint8_t luaFlags;       // 1 byte
 
-    char pad[1];
+    bool lodsEnabled; // 1 byte
 };
 
+// Region operations applied chunk by chunk, see _shape_apply_region
+typedef enum {
+    ShapeRegionOp_Fill,
+    ShapeRegionOp_Replace,
+    ShapeRegionOp_Copy
+} ShapeRegionOp;
+
+typedef struct {
+    // copy: dense array of source colors within the region (x first), in shape palette
+    const SHAPE_COLOR_INDEX_INT_T *colors;
+    // copy: region origin & size in shape
+    SHAPE_COORDS_INT3_T origin;
+    int sizeX, sizeY;
+
+    ShapeRegionOp op;
+    SHAPE_COLOR_INDEX_INT_T color; // fill & replace: new color
+    SHAPE_COLOR_INDEX_INT_T from;  // replace: color being replaced
+
+    char pad[2];
+} ShapeRegion;
+
 // MARK: - private functions prototypes -
 
 static void _shape_toggle_rendering_flag(Shape *s, const uint8_t flag, const bool toggle);
@@ -111,6 +147,7 @@ void _shape_chunk_enqueue_refresh(Shape *shape, Chunk *c);
 void _shape_chunk_check_neighbors_dirty(Shape *shape,
                                         const Chunk *chunk,
                                         CHUNK_COORDS_INT3_T block_pos);
+static void _shape_insert_chunk(Shape *shape, Chunk *chunk, const SHAPE_COORDS_INT3_T chunk_coords);
 static bool _shape_add_block_in_chunks(Shape *shape,
                                        const Block block,
                                        const SHAPE_COORDS_INT_T x,
@@ -190,10 +227,36 @@ void _light_removal_all(Shape *s, SHAPE_COORDS_INT3_T *min, SHAPE_COORDS_INT3_T
 void _shape_check_all_vb_fragmented(Shape *s, VertexBuffer *first);
 void _shape_flush_all_vb(Shape *s);
 void _shape_fill_draw_slices(VertexBuffer *vb);
+static void _shape_free_lod_vbs(Shape *s);
+static void _shape_check_lod_vbs_fragmented(Shape *s);
+static void _shape_fill_lod_draw_slices(Shape *s);
 VertexBuffer *_shape_get_latest_buffer(const Shape *s, const bool transparent);
 
-bool _shape_apply_transaction(Shape *const sh, Transaction *tr);
-bool _shape_undo_transaction(Shape *const sh, Transaction *tr);
+HistoryRecord *_shape_apply_transaction(Shape *const sh, Transaction *tr);
+static void _shape_free_pending_transaction(Shape *const sh);
+bool _shape_apply_history_record(Shape *const sh, const HistoryRecord *r, const bool undo);
+void _shape_apply_color_deltas(Shape *const sh, const int32_t *colorDeltas);
+static size_t _shape_apply_region(Shape *const sh,
+                                  Scene *scene,
+                                  const SHAPE_COORDS_INT3_T min,
+                                  const SHAPE_COORDS_INT3_T max,
+                                  const ShapeRegion *region);
+static SHAPE_COLOR_INDEX_INT_T _shape_region_get_target(const ShapeRegion *region,
+                                                        const SHAPE_COORDS_INT3_T coords,
+                                                        const SHAPE_COLOR_INDEX_INT_T current);
+static void _shape_region_gather(const Shape *src,
+                                 const SHAPE_COORDS_INT3_T min,
+                                 const SHAPE_COORDS_INT3_T size,
+                                 ColorPalette *palette,
+                                 SHAPE_COLOR_INDEX_INT_T *out);
+static void _shape_region_queue_lighting(Shape *s,
+                                         LightNodeQueue *lightQueue,
+                                         LightRemovalNodeQueue *lightRemovalQueue,
+                                         Chunk *c,
+                                         const SHAPE_COORDS_INT3_T coords,
+                                         const CHUNK_COORDS_INT3_T coordsInChunk,
+                                         const SHAPE_COLOR_INDEX_INT_T before,
+                                         const SHAPE_COLOR_INDEX_INT_T after);
 
 void _shape_clear_cached_world_aabb(Shape *s);
 
@@ -242,10 +305,15 @@ Shape *shape_make(void) {
     s->firstVB_transparent = NULL;
     s->vbAllocationFlag_opaque = 0;
     s->vbAllocationFlag_transparent = 0;
+    memset(s->firstVB_lod, 0, sizeof(s->firstVB_lod));
+    s->lodCameraPosition = float3_zero;
+    s->lodDistance = SHAPE_LOD_DEFAULT_DISTANCE;
+    s->lodsEnabled = false;
 
     s->history = NULL;
     s->fullname = NULL;
     s->pendingTransaction = NULL;
+    s->pendingChanges = NULL;
     s->nbChunks = 0;
     s->nbBlocks = 0;
     s->bbMin = coords3_zero;
@@ -408,6 +476,7 @@ void shape_flush(Shape *shape) {
         shape->firstVB_opaque = NULL;
         vertex_buffer_free_all(shape->firstVB_transparent);
         shape->firstVB_transparent = NULL;
+        _shape_free_lod_vbs(shape);
         shape->vbAllocationFlag_opaque = 0;
         shape->vbAllocationFlag_transparent = 0;
 
@@ -488,6 +557,7 @@ void shape_free(Shape *const shape) {
     // free all vertex buffers
     vertex_buffer_free_all(shape->firstVB_opaque);
     vertex_buffer_free_all(shape->firstVB_transparent);
+    _shape_free_lod_vbs(shape);
 
     // no need to flush fragmentedVBs,
     // vertex_buffer_free_all has been called previously
@@ -499,8 +569,7 @@ void shape_free(Shape *const shape) {
     shape->history = NULL;
 
     // free current transaction
-    transaction_free(shape->pendingTransaction);
-    shape->pendingTransaction = NULL;
+    _shape_free_pending_transaction(shape);
 
     if (shape->fullname != NULL) {
         free(shape->fullname);
@@ -637,26 +706,45 @@ void shape_apply_current_transaction(Shape *const shape, bool keepPending) {
         return; // no transaction to apply
     }
 
-    const bool done = _shape_apply_transaction(shape, shape->pendingTransaction);
-    if (done == false) {
-        transaction_free(shape->pendingTransaction);
-        shape->pendingTransaction = NULL;
+    // changes are applied at once from a record, that can then be pushed to the history
+    HistoryRecord *r = _shape_apply_transaction(shape, shape->pendingTransaction);
+    if (r == NULL) {
+        _shape_free_pending_transaction(shape);
         return;
     }
 
     keepPending = keepPending || (_shape_get_lua_flag(shape, SHAPE_LUA_FLAG_HISTORY) &&
                                   _shape_get_lua_flag(shape, SHAPE_LUA_FLAG_HISTORY_KEEP_PENDING));
+    const bool historyEnabled = _shape_get_lua_flag(shape, SHAPE_LUA_FLAG_HISTORY) &&
+                                shape->history != NULL;
+
+    if (historyEnabled && (keepPending || shape->pendingChanges != NULL)) {
+        // transaction applied in several steps, gathering changes to store them all at once
+        if (shape->pendingChanges == NULL) {
+            shape->pendingChanges = history_changes_new();
+        }
+        if (shape->pendingChanges != NULL) {
+            history_changes_add_record(shape->pendingChanges, r);
+        }
+        history_record_free(r);
+        r = NULL;
+
+        if (keepPending == false && shape->pendingChanges != NULL) {
+            history_pushChanges(shape->history, shape->pendingChanges);
+            shape->pendingChanges = NULL;
+        }
+    }
 
     if (keepPending == false) {
-        if (_shape_get_lua_flag(shape, SHAPE_LUA_FLAG_HISTORY) && shape->history != NULL) {
-            // history is enabled, store the transaction in the history
-            transaction_resetIndex3DIterator(shape->pendingTransaction);
-            history_pushTransaction(shape->history, shape->pendingTransaction);
+        if (historyEnabled && r != NULL) {
+            // history is enabled, store the record in the history
+            history_pushRecord(shape->history, r);
         } else {
-            // otherwise, simply delete transaction
-            transaction_free(shape->pendingTransaction);
+            history_record_free(r);
         }
-        shape->pendingTransaction = NULL;
+        _shape_free_pending_transaction(shape);
+    } else {
+        history_record_free(r);
     }
 }
 
@@ -716,6 +804,143 @@ bool shape_add_block(Shape *shape,
     return blockAdded;
 }
 
+bool shape_add_chunk(Shape *shape, Chunk *chunk) {
+
+    if (shape == NULL || chunk == NULL) {
+        return false;
+    }
+
+    const SHAPE_COORDS_INT3_T origin = chunk_get_origin(chunk);
+    const SHAPE_COORDS_INT3_T chunk_coords = chunk_utils_get_coords(origin);
+    if (index3d_get(shape->chunks, chunk_coords.x, chunk_coords.y, chunk_coords.z) != NULL) {
+        return false;
+    }
+
+    _shape_insert_chunk(shape, chunk, chunk_coords);
+    shape->nbChunks++;
+
+    const int nbBlocks = chunk_get_nb_blocks(chunk);
+    if (nbBlocks == 0) {
+        return true;
+    }
+    shape->nbBlocks += (size_t)nbBlocks;
+
+    // palette usage is updated once per color
+    CHUNK_COORDS_INT3_T bbMin, bbMax;
+    chunk_get_bounding_box_2(chunk, &bbMin, &bbMax);
+
+    // octree elements are a flat CHUNK_SIZE^3 array of blocks
+    const Block *blocks = (const Block *)octree_get_elements(chunk_get_octree(chunk));
+    uint32_t counts[SHAPE_COLOR_INDEX_MAX_COUNT + 1] = {0};
+    for (CHUNK_COORDS_INT_T z = bbMin.z; z < bbMax.z; ++z) {
+        for (CHUNK_COORDS_INT_T y = bbMin.y; y < bbMax.y; ++y) {
+            const Block *b = blocks + bbMin.x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQR;
+            for (CHUNK_COORDS_INT_T x = bbMin.x; x < bbMax.x; ++x) {
+                ++counts[b->colorIndex]; // air blocks counted at SHAPE_COLOR_INDEX_AIR_BLOCK
+                ++b;
+            }
+        }
+    }
+    for (SHAPE_COLOR_INDEX_INT_T i = 0; i < SHAPE_COLOR_INDEX_MAX_COUNT; ++i) {
+        if (counts[i] > 0) {
+            color_palette_increment_color(shape->palette, i, counts[i]);
+            shape->blocksCount[i] += counts[i];
+        }
+    }
+
+    shape_expand_box(shape,
+                     (SHAPE_COORDS_INT3_T){(SHAPE_COORDS_INT_T)(origin.x + bbMin.x),
+                                           (SHAPE_COORDS_INT_T)(origin.y + bbMin.y),
+                                           (SHAPE_COORDS_INT_T)(origin.z + bbMin.z)});
+    shape_expand_box(shape,
+                     (SHAPE_COORDS_INT3_T){(SHAPE_COORDS_INT_T)(origin.x + bbMax.x - 1),
+                                           (SHAPE_COORDS_INT_T)(origin.y + bbMax.y - 1),
+                                           (SHAPE_COORDS_INT_T)(origin.z + bbMax.z - 1)});
+
+    _shape_chunk_enqueue_refresh(shape, chunk);
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, X));
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, NX));
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, Y));
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, NY));
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, Z));
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, NZ));
+
+    return true;
+}
+
+bool shape_remove_chunk(Shape *shape, const SHAPE_COORDS_INT3_T chunk_coords) {
+    if (shape == NULL) {
+        return false;
+    }
+
+    Chunk *chunk = (Chunk *)
+        index3d_remove(shape->chunks, chunk_coords.x, chunk_coords.y, chunk_coords.z, NULL);
+    if (chunk == NULL) {
+        return false;
+    }
+    shape->nbChunks--;
+
+    // a dirty chunk is still listed for refresh, keep all other chunks in order
+    if (chunk_is_dirty(chunk)) {
+        const uint32_t size = fifo_list_get_size(shape->dirtyChunks);
+        for (uint32_t i = 0; i < size; ++i) {
+            Chunk *c = (Chunk *)fifo_list_pop(shape->dirtyChunks);
+            if (c != chunk) {
+                fifo_list_push(shape->dirtyChunks, c);
+            }
+        }
+    }
+
+    bool boxShrinks = false;
+    const int nbBlocks = chunk_get_nb_blocks(chunk);
+    if (nbBlocks > 0) {
+        shape->nbBlocks -= (size_t)nbBlocks;
+
+        CHUNK_COORDS_INT3_T bbMin, bbMax;
+        chunk_get_bounding_box_2(chunk, &bbMin, &bbMax);
+
+        // bounding box only shrinks if the chunk's blocks reached one of its sides
+        const SHAPE_COORDS_INT3_T origin = chunk_get_origin(chunk);
+        boxShrinks = origin.x + bbMin.x == shape->bbMin.x || origin.y + bbMin.y == shape->bbMin.y ||
+                     origin.z + bbMin.z == shape->bbMin.z || origin.x + bbMax.x == shape->bbMax.x ||
+                     origin.y + bbMax.y == shape->bbMax.y || origin.z + bbMax.z == shape->bbMax.z;
+
+        const Block *blocks = (const Block *)octree_get_elements(chunk_get_octree(chunk));
+        uint32_t counts[SHAPE_COLOR_INDEX_MAX_COUNT + 1] = {0};
+        for (CHUNK_COORDS_INT_T z = bbMin.z; z < bbMax.z; ++z) {
+            for (CHUNK_COORDS_INT_T y = bbMin.y; y < bbMax.y; ++y) {
+                const Block *b = blocks + bbMin.x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQR;
+                for (CHUNK_COORDS_INT_T x = bbMin.x; x < bbMax.x; ++x) {
+                    ++counts[b->colorIndex];
+                    ++b;
+                }
+            }
+        }
+        for (SHAPE_COLOR_INDEX_INT_T i = 0; i < SHAPE_COLOR_INDEX_MAX_COUNT; ++i) {
+            if (counts[i] > 0) {
+                color_palette_decrement_color(shape->palette, i, counts[i]);
+                shape->blocksCount[i] -= counts[i];
+            }
+        }
+    }
+
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, X));
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, NX));
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, Y));
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, NY));
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, Z));
+    _shape_chunk_enqueue_refresh(shape, chunk_get_neighbor(chunk, NZ));
+
+    rtree_remove(shape->rtree, chunk_get_rtree_leaf(chunk), true);
+    chunk_free(chunk, true);
+
+    if (boxShrinks) {
+        shape_reset_box(shape);
+    }
+
+    return true;
+}
+
 bool shape_remove_block(Shape *shape,
                         const SHAPE_COORDS_INT_T x,
                         const SHAPE_COORDS_INT_T y,
@@ -812,6 +1037,90 @@ bool shape_paint_block(Shape *shape,
     return painted;
 }
 
+size_t shape_fill_box(Shape *shape,
+                      Scene *scene,
+                      const SHAPE_COLOR_INDEX_INT_T colorIndex,
+                      const SHAPE_COORDS_INT3_T min,
+                      const SHAPE_COORDS_INT3_T max) {
+    if (shape == NULL) {
+        return 0;
+    }
+
+    ShapeRegion region;
+    memset(&region, 0, sizeof(ShapeRegion));
+    region.op = ShapeRegionOp_Fill;
+    region.color = colorIndex;
+
+    return _shape_apply_region(shape, scene, min, max, &region);
+}
+
+size_t shape_replace_color_in_box(Shape *shape,
+                                  Scene *scene,
+                                  const SHAPE_COLOR_INDEX_INT_T from,
+                                  const SHAPE_COLOR_INDEX_INT_T to,
+                                  const SHAPE_COORDS_INT3_T min,
+                                  const SHAPE_COORDS_INT3_T max) {
+    if (shape == NULL || from == to || from == SHAPE_COLOR_INDEX_AIR_BLOCK) {
+        return 0;
+    }
+
+    ShapeRegion region;
+    memset(&region, 0, sizeof(ShapeRegion));
+    region.op = ShapeRegionOp_Replace;
+    region.color = to;
+    region.from = from;
+
+    return _shape_apply_region(shape, scene, min, max, &region);
+}
+
+size_t shape_copy_box_from(Shape *dst,
+                           Scene *scene,
+                           const Shape *src,
+                           const SHAPE_COORDS_INT3_T min,
+                           const SHAPE_COORDS_INT3_T max,
+                           const SHAPE_COORDS_INT3_T dstOrigin) {
+    if (dst == NULL || src == NULL) {
+        return 0;
+    }
+
+    // copied size, clipped to destination coordinates range
+    const SHAPE_COORDS_INT3_T size = {
+        (SHAPE_COORDS_INT_T)minimum(max.x - min.x, SHAPE_COORDS_MAX - dstOrigin.x),
+        (SHAPE_COORDS_INT_T)minimum(max.y - min.y, SHAPE_COORDS_MAX - dstOrigin.y),
+        (SHAPE_COORDS_INT_T)minimum(max.z - min.z, SHAPE_COORDS_MAX - dstOrigin.z)};
+    if (size.x <= 0 || size.y <= 0 || size.z <= 0) {
+        return 0;
+    }
+
+    // source blocks are gathered first, source & destination may be the same shape
+    const size_t volume = (size_t)size.x * (size_t)size.y * (size_t)size.z;
+    SHAPE_COLOR_INDEX_INT_T *colors = (SHAPE_COLOR_INDEX_INT_T *)malloc(volume);
+    if (colors == NULL) {
+        return 0;
+    }
+    _shape_region_gather(src, min, size, dst->palette, colors);
+
+    ShapeRegion region;
+    memset(&region, 0, sizeof(ShapeRegion));
+    region.op = ShapeRegionOp_Copy;
+    region.colors = colors;
+    region.origin = dstOrigin;
+    region.sizeX = size.x;
+    region.sizeY = size.y;
+
+    const size_t nbChanged = _shape_apply_region(
+        dst,
+        scene,
+        dstOrigin,
+        (SHAPE_COORDS_INT3_T){(SHAPE_COORDS_INT_T)(dstOrigin.x + size.x),
+                              (SHAPE_COORDS_INT_T)(dstOrigin.y + size.y),
+                              (SHAPE_COORDS_INT_T)(dstOrigin.z + size.z)},
+        &region);
+    free(colors);
+
+    return nbChanged;
+}
+
 ColorPalette *shape_get_palette(const Shape *shape) {
     return shape->palette;
 }
@@ -877,7 +1186,7 @@ void shape_remap_colors(Shape *s, const SHAPE_COLOR_INDEX_INT_T *remap) {
                                     continue;
                                 }
 
-                                block_set_color_index(b, newColor);
+                                chunk_paint_block(chunk, cx, cy, cz, newColor, NULL);
 
                                 color_palette_decrement_color(s->palette, prevColor, 1);
                                 color_palette_increment_color(s->palette, newColor, 1);
@@ -1692,11 +2001,13 @@ void shape_refresh_vertices(Shape *shape) {
     if (_shape_get_rendering_flag(shape, SHAPE_RENDERING_FLAG_BAKE_LOCKED)) {
         _shape_fill_draw_slices(shape->firstVB_opaque);
         _shape_fill_draw_slices(shape->firstVB_transparent);
+        _shape_fill_lod_draw_slices(shape);
         return;
     }
 
     Chunk *c = shape->dirtyChunks != NULL ? fifo_list_pop(shape->dirtyChunks) : NULL;
-    if (c == NULL) {
+    // compaction may still be ongoing, from previous refreshes
+    if (c == NULL && doubly_linked_list_first(shape->fragmentedVBs) == NULL) {
         return;
     }
     while (c != NULL) {
@@ -1722,6 +2033,9 @@ void shape_refresh_vertices(Shape *shape) {
         // else chunk has data that needs updating
         else {
             chunk_write_vertices(shape, c);
+            if (shape->lodsEnabled) {
+                chunk_write_lod_vertices(shape, c);
+            }
         }
 
         if (c != NULL) {
@@ -1732,12 +2046,15 @@ void shape_refresh_vertices(Shape *shape) {
     }
 
     // check all vertex buffers used by this shape, to see if they have to be defragmented
+    doubly_linked_list_flush(shape->fragmentedVBs, NULL);
     _shape_check_all_vb_fragmented(shape, shape->firstVB_opaque);
     _shape_check_all_vb_fragmented(shape, shape->firstVB_transparent);
+    _shape_check_lod_vbs_fragmented(shape);
 
     // DEFRAGMENTATION
 
-    // fill remaining mem area gaps (for all vertex buffers involved)
+    // fill remaining mem area gaps (for all vertex buffers involved), moving a limited amount of
+    // vertices per refresh, vertex buffers still fragmented stay listed for next refresh
     VertexBuffer *fragmentedVB = (VertexBuffer *)doubly_linked_list_pop_first(shape->fragmentedVBs);
 
     // bool log = true; // fragmentedVB != NULL;
@@ -1746,11 +2063,15 @@ void shape_refresh_vertices(Shape *shape) {
     //        shape_log_vertex_buffers(shape, true);
     //    }
 
+    uint32_t budget = vertex_buffer_get_compaction_budget();
     while (fragmentedVB != NULL) {
-        vertex_buffer_fill_gaps(fragmentedVB);
+        budget -= minimum(budget, vertex_buffer_fill_gaps_with_budget(fragmentedVB, budget));
 
         fragmentedVB = (VertexBuffer *)doubly_linked_list_pop_first(shape->fragmentedVBs);
     }
+    _shape_check_all_vb_fragmented(shape, shape->firstVB_opaque);
+    _shape_check_all_vb_fragmented(shape, shape->firstVB_transparent);
+    _shape_check_lod_vbs_fragmented(shape);
 
     //    if (log) {
     //        shape_log_vertex_buffers(shape, true);
@@ -1759,27 +2080,92 @@ void shape_refresh_vertices(Shape *shape) {
     // fill draw slices after defragmentation
     _shape_fill_draw_slices(shape->firstVB_opaque);
     _shape_fill_draw_slices(shape->firstVB_transparent);
+    _shape_fill_lod_draw_slices(shape);
 
     _set_vb_allocation_flag_one_frame(shape);
 }
 
-void shape_refresh_all_vertices(Shape *s) {
-    // refresh all chunks
-    Index3DIterator *it = index3d_iterator_new(s->chunks);
-    Chunk *chunk;
-    while (index3d_iterator_pointer(it) != NULL) {
-        chunk = index3d_iterator_pointer(it);
+typedef struct {
+    const Shape *shape;
+    Chunk **chunks;
+    ChunkMesh **meshes;
+} ShapeMeshBatch;
 
-        chunk_write_vertices(s, chunk);
-        chunk_set_dirty(chunk, false);
+static void _shape_mesh_batch(void *userdata, uint32_t begin, uint32_t end) {
+    ShapeMeshBatch *batch = (ShapeMeshBatch *)userdata;
+    for (uint32_t i = begin; i < end; ++i) {
+        chunk_compute_mesh(batch->shape, batch->chunks[i], batch->meshes[i]);
+    }
+}
 
+/// Chunks are meshed in parallel by batches, then written in vertex buffers in iteration order,
+/// vertex buffers end up the same as when refreshing chunks one by one
+static void _shape_refresh_all_vertices_parallel(Shape *s, JobSystem *js) {
+    uint32_t count = 0;
+    Chunk **chunks = (Chunk **)malloc(sizeof(Chunk *) * s->nbChunks);
+    Index3DIterator *it = index3d_iterator_new(s->chunks);
+    while (index3d_iterator_pointer(it) != NULL && count < s->nbChunks) {
+        chunks[count++] = index3d_iterator_pointer(it);
         index3d_iterator_next(it);
     }
     index3d_iterator_free(it);
 
+    const uint32_t batchSize = minimum(count,
+                                       (job_system_get_nb_workers(js) + 1) *
+                                           SHAPE_MESH_BATCH_PER_THREAD);
+    ChunkMesh **meshes = (ChunkMesh **)malloc(sizeof(ChunkMesh *) * batchSize);
+    for (uint32_t i = 0; i < batchSize; ++i) {
+        meshes[i] = chunk_mesh_new();
+    }
+
+    ShapeMeshBatch batch = {s, NULL, meshes};
+    for (uint32_t start = 0; start < count; start += batchSize) {
+        const uint32_t n = minimum(batchSize, count - start);
+        batch.chunks = chunks + start;
+        job_system_parallel_for(js, n, 1, _shape_mesh_batch, &batch);
+
+        for (uint32_t i = 0; i < n; ++i) {
+            chunk_write_mesh(s, chunks[start + i], meshes[i]);
+            if (s->lodsEnabled) {
+                chunk_write_lod_vertices(s, chunks[start + i]);
+            }
+            chunk_set_dirty(chunks[start + i], false);
+        }
+    }
+
+    for (uint32_t i = 0; i < batchSize; ++i) {
+        chunk_mesh_free(meshes[i]);
+    }
+    free(meshes);
+    free(chunks);
+}
+
+void shape_refresh_all_vertices(Shape *s) {
+    JobSystem *js = job_system_shared();
+    if (job_system_get_nb_workers(js) > 0 && s->nbChunks > 1) {
+        _shape_refresh_all_vertices_parallel(s, js);
+    } else {
+        // refresh all chunks
+        Index3DIterator *it = index3d_iterator_new(s->chunks);
+        Chunk *chunk;
+        while (index3d_iterator_pointer(it) != NULL) {
+            chunk = index3d_iterator_pointer(it);
+
+            chunk_write_vertices(s, chunk);
+            if (s->lodsEnabled) {
+                chunk_write_lod_vertices(s, chunk);
+            }
+            chunk_set_dirty(chunk, false);
+
+            index3d_iterator_next(it);
+        }
+        index3d_iterator_free(it);
+    }
+
     // refresh draw slices after full refresh
     _shape_fill_draw_slices(s->firstVB_opaque);
     _shape_fill_draw_slices(s->firstVB_transparent);
+    _shape_fill_lod_draw_slices(s);
 
     // flush dirty list
     if (s->dirtyChunks != NULL) {
@@ -1792,6 +2178,112 @@ VertexBuffer *shape_get_first_vertex_buffer(const Shape *shape, bool transparent
     return transparent ? shape->firstVB_transparent : shape->firstVB_opaque;
 }
 
+// MARK: - Level of detail -
+
+void shape_set_lods_enabled(Shape *s, const bool enabled) {
+    if (s->lodsEnabled == enabled) {
+        return;
+    }
+    s->lodsEnabled = enabled;
+
+    Index3DIterator *it = index3d_iterator_new(s->chunks);
+    Chunk *c;
+    while (index3d_iterator_pointer(it) != NULL) {
+        c = index3d_iterator_pointer(it);
+        if (enabled) {
+            _shape_chunk_enqueue_refresh(s, c);
+        } else {
+            for (uint8_t lod = 1; lod < CHUNK_LOD_COUNT; ++lod) {
+                chunk_set_lod_vbma(c, NULL, lod, false);
+                chunk_set_lod_vbma(c, NULL, lod, true);
+            }
+        }
+        index3d_iterator_next(it);
+    }
+    index3d_iterator_free(it);
+
+    if (enabled == false) {
+        // LOD vbs may have been listed for compaction, listed again at next refresh if needed
+        doubly_linked_list_flush(s->fragmentedVBs, NULL);
+        _shape_free_lod_vbs(s);
+    }
+}
+
+bool shape_get_lods_enabled(const Shape *s) {
+    return s->lodsEnabled;
+}
+
+void shape_set_lod_camera_position(Shape *s, const float3 *modelPosition) {
+    s->lodCameraPosition = *modelPosition;
+}
+
+const float3 *shape_get_lod_camera_position(const Shape *s) {
+    return &s->lodCameraPosition;
+}
+
+void shape_set_lod_distance(Shape *s, const float distance) {
+    s->lodDistance = maximum(distance, EPSILON_ZERO);
+}
+
+float shape_get_lod_distance(const Shape *s) {
+    return s->lodDistance;
+}
+
+uint8_t shape_get_chunk_lod(const Shape *s, const Chunk *c) {
+    if (s->lodsEnabled == false) {
+        return 0;
+    }
+
+    // distance from camera to chunk box, chunk containing the camera is always at full resolution
+    const SHAPE_COORDS_INT3_T origin = chunk_get_origin(c);
+    const float3 *p = &s->lodCameraPosition;
+    const float dx = maximum(maximum((float)origin.x - p->x, p->x - (float)(origin.x + CHUNK_SIZE)),
+                             0.0f);
+    const float dy = maximum(maximum((float)origin.y - p->y, p->y - (float)(origin.y + CHUNK_SIZE)),
+                             0.0f);
+    const float dz = maximum(maximum((float)origin.z - p->z, p->z - (float)(origin.z + CHUNK_SIZE)),
+                             0.0f);
+    const float lod = sqrtf(dx * dx + dy * dy + dz * dz) / s->lodDistance;
+
+    return lod >= (float)(CHUNK_LOD_COUNT - 1) ? CHUNK_LOD_COUNT - 1 : (uint8_t)lod;
+}
+
+VertexBuffer *shape_get_first_lod_vertex_buffer(const Shape *s,
+                                                const uint8_t lod,
+                                                const bool transparent) {
+    if (lod == 0) {
+        return shape_get_first_vertex_buffer(s, transparent);
+    }
+    return s->firstVB_lod[lod - 1][transparent ? 1 : 0];
+}
+
+VertexBuffer *shape_add_lod_buffer(Shape *s, const uint8_t lod, const bool transparent) {
+    if (lod == 0) {
+        return shape_add_buffer(s, transparent);
+    }
+
+    // same estimation as a first shape buffer (see shape_add_buffer), each LOD level divides faces
+    // count by 4, following buffers are of the same capacity
+    const size_t shell = 6 * CHUNK_SIZE_SQR * 2 * s->nbChunks;
+    uint32_t facesCapacity = (uint32_t)(ceilf(
+        (float)(shell >> (2 * lod)) * SHAPE_BUFFER_INITIAL_FACTOR *
+        (transparent ? SHAPE_BUFFER_TRANSPARENT_FACTOR : 1.0f)));
+    facesCapacity = CLAMP(facesCapacity, SHAPE_BUFFER_MIN_COUNT, SHAPE_BUFFER_MAX_COUNT);
+
+    VertexBuffer *vb = vertex_buffer_new_with_max_count(facesCapacity *
+                                                            DRAWBUFFER_VERTICES_PER_FACE,
+                                                        transparent);
+    vertex_buffer_set_lod(vb, lod);
+
+    VertexBuffer **first = &s->firstVB_lod[lod - 1][transparent ? 1 : 0];
+    if (*first != NULL) {
+        vertex_buffer_insert_after(vb, *first);
+    } else {
+        *first = vb;
+    }
+    return vb;
+}
+
 // MARK: - Physics -
 
 Rtree *shape_get_rtree(const Shape *shape) {
@@ -1888,6 +2380,77 @@ void _chunk_entry_insert(DoublyLinkedList *chunks, Chunk *c, void *castData, flo
     }
 }
 
+/// Whether blocks in given slab along an axis can't be hit before `minSwept`, the moving box
+/// having to overlap the slab on that axis for any face of a block in it to be hit.
+static bool _shape_box_cast_is_out_of_reach(const float v,
+                                            const float boxMin,
+                                            const float boxMax,
+                                            const int slab,
+                                            const float minSwept) {
+    if (v > 0.0f) {
+        return (float)slab - boxMax > minSwept * v + EPSILON_COLLISION;
+    } else if (v < 0.0f) {
+        return boxMin - (float)(slab + 1) > minSwept * -v + EPSILON_COLLISION;
+    }
+    return false;
+}
+
+/// Rank of chunk block coordinates in octree iterator traversal, children being visited in this
+/// order at each level: 000, 100, 101, 001, 010, 110, 111, 011 (xyz)
+static uint32_t _shape_octree_order(const int x, const int y, const int z) {
+    static const uint32_t xz[4] = {0, 1, 3, 2};
+    uint32_t order = 0;
+    for (int bit = CHUNK_SIZE >> 1; bit > 0; bit >>= 1) {
+        order = order * 8 + ((y & bit) ? 4 : 0) + xz[((x & bit) ? 1 : 0) | ((z & bit) ? 2 : 0)];
+    }
+    return order;
+}
+
+#if PHYSICS_EXTRA_REPLACEMENTS
+static void _shape_box_cast_merge_replacement(float3 *extraReplacement,
+                                              const float3 *tmpReplacement,
+                                              bool *blockedX,
+                                              bool *blockedY,
+                                              bool *blockedZ) {
+    if (tmpReplacement->x != 0.0f && *blockedX == false) {
+        // previous replacement is positive and new replacement is positive & bigger
+        if (extraReplacement->x >= 0.0f && tmpReplacement->x > extraReplacement->x) {
+            extraReplacement->x = tmpReplacement->x;
+        }
+        // previous replacement is negative and new replacement is negative & bigger
+        else if (extraReplacement->x <= 0.0f && tmpReplacement->x < extraReplacement->x) {
+            extraReplacement->x = tmpReplacement->x;
+        }
+        // previous & new replacements are opposite... this axis is blocked,
+        // set to 0 to avoid stuttering and wait for another axis to replace
+        else if (extraReplacement->x * tmpReplacement->x < 0.0f) {
+            extraReplacement->x = 0.0f;
+            *blockedX = true;
+        }
+    }
+    if (tmpReplacement->y != 0.0f && *blockedY == false) {
+        if (extraReplacement->y >= 0.0f && tmpReplacement->y > extraReplacement->y) {
+            extraReplacement->y = tmpReplacement->y;
+        } else if (extraReplacement->y <= 0.0f && tmpReplacement->y < extraReplacement->y) {
+            extraReplacement->y = tmpReplacement->y;
+        } else if (extraReplacement->y * tmpReplacement->y < 0.0f) {
+            extraReplacement->y = 0.0f;
+            *blockedX = true;
+        }
+    }
+    if (tmpReplacement->z != 0.0f && *blockedZ == false) {
+        if (extraReplacement->z >= 0.0f && tmpReplacement->z > extraReplacement->z) {
+            extraReplacement->z = tmpReplacement->z;
+        } else if (extraReplacement->z <= 0.0f && tmpReplacement->z < extraReplacement->z) {
+            extraReplacement->z = tmpReplacement->z;
+        } else if (extraReplacement->z * tmpReplacement->z < 0.0f) {
+            extraReplacement->z = 0.0f;
+            *blockedX = true;
+        }
+    }
+}
+#endif
+
 float shape_box_cast(const Shape *s,
                      const Box *modelBox,
                      const float3 *modelVector,
@@ -1921,17 +2484,42 @@ float shape_box_cast(const Shape *s,
         Box broadPhaseBox, tmpBox;
         box_set_broadphase_box(modelBox, modelVector, &broadPhaseBox);
 
+        // blocks overlapped by the broadphase box are walked slab by slab, fastest axis first and
+        // nearest slabs first on each axis, until slabs can't be reached before current hit
+        const float v[3] = {modelVector->x, modelVector->y, modelVector->z};
+        const float boxMin[3] = {modelBox->min.x, modelBox->min.y, modelBox->min.z};
+        const float boxMax[3] = {modelBox->max.x, modelBox->max.y, modelBox->max.z};
+        const float bpMin[3] = {broadPhaseBox.min.x, broadPhaseBox.min.y, broadPhaseBox.min.z};
+        const float bpMax[3] = {broadPhaseBox.max.x, broadPhaseBox.max.y, broadPhaseBox.max.z};
+        int axes[3] = {0, 1, 2};
+        for (int i = 1; i < 3; ++i) {
+            for (int j = i; j > 0 && fabsf(v[axes[j]]) > fabsf(v[axes[j - 1]]); --j) {
+                const int a = axes[j];
+                axes[j] = axes[j - 1];
+                axes[j - 1] = a;
+            }
+        }
+        const int a0 = axes[0], a1 = axes[1], a2 = axes[2];
+#if PHYSICS_EXTRA_REPLACEMENTS
+        // replacements are accumulated over all overlapped blocks
+        const bool canStop = extraReplacement == NULL;
+#else
+        const bool canStop = true;
+#endif
+
         // examine query results in order, return first hit block
         DoublyLinkedListNode *n = doubly_linked_list_first(chunksQuery);
         RtreeCastResult *rtreeHit;
-        OctreeIterator *oi;
-        Chunk *c;
-        bool didHit = false, leaf;
+        Chunk *c, *hitChunk = NULL;
+        bool didHit = false;
         float3 tmpNormal, tmpReplacement;
         float swept = 1.0f, lastRtreeDist = FLT_MAX;
+        uint32_t hitOrder = 0;
+        int origin[3], lo[3], hi[3], from[3], to[3], step[3], coords[3];
         while (n != NULL) {
             rtreeHit = (RtreeCastResult *)doubly_linked_list_node_pointer(n);
             c = (Chunk *)rtree_node_get_leaf_ptr(rtreeHit->rtreeLeaf);
+            n = doubly_linked_list_node_next(n);
 
             // make sure to examine all hits w/ similar distances before stopping
             if (didHit &&
@@ -1941,111 +2529,118 @@ float shape_box_cast(const Shape *s,
             lastRtreeDist = rtreeHit->distance;
 
             const SHAPE_COORDS_INT3_T chunkOrigin = chunk_get_origin(c);
-            leaf = false;
+            origin[0] = chunkOrigin.x;
+            origin[1] = chunkOrigin.y;
+            origin[2] = chunkOrigin.z;
+
+            // chunk blocks range overlapped by the broadphase box
+            for (int a = 0; a < 3; ++a) {
+                lo[a] = CLAMP((int)floorf(bpMin[a]) - origin[a], 0, CHUNK_SIZE);
+                hi[a] = CLAMP((int)floorf(bpMax[a]) - origin[a], -1, CHUNK_SIZE_MINUS_ONE);
+                step[a] = v[a] < 0.0f ? -1 : 1;
+                from[a] = v[a] < 0.0f ? hi[a] : lo[a];
+                to[a] = (v[a] < 0.0f ? lo[a] : hi[a]) + step[a];
+            }
+            if (chunk_has_solid_blocks_in_box(c,
+                                              (CHUNK_COORDS_INT3_T){(CHUNK_COORDS_INT_T)lo[0],
+                                                                    (CHUNK_COORDS_INT_T)lo[1],
+                                                                    (CHUNK_COORDS_INT_T)lo[2]},
+                                              (CHUNK_COORDS_INT3_T){(CHUNK_COORDS_INT_T)hi[0],
+                                                                    (CHUNK_COORDS_INT_T)hi[1],
+                                                                    (CHUNK_COORDS_INT_T)hi[2]}) ==
+                false) {
+                continue;
+            }
 #if PHYSICS_EXTRA_REPLACEMENTS
-            float blockedX = false, blockedY = false, blockedZ = false;
+            bool blockedX = false, blockedY = false, blockedZ = false;
 #endif
 
-            oi = octree_iterator_new(chunk_get_octree(c));
-            while (octree_iterator_is_done(oi) == false) {
-                octree_iterator_get_node_box(oi, &tmpBox);
-
-                // chunk octree box in model space
-                tmpBox.min.x += chunkOrigin.x;
-                tmpBox.min.y += chunkOrigin.y;
-                tmpBox.min.z += chunkOrigin.z;
-                tmpBox.max.x += chunkOrigin.x;
-                tmpBox.max.y += chunkOrigin.y;
-                tmpBox.max.z += chunkOrigin.z;
-
-                const bool collides = box_collide(&tmpBox, &broadPhaseBox);
-                if (leaf && collides) {
-                    swept = box_swept(modelBox,
-                                      modelVector,
-                                      &tmpBox,
-                                      epsilon,
-                                      withReplacement,
-                                      &tmpNormal,
-                                      &tmpReplacement);
-                    if (swept < minSwept) {
-                        minSwept = swept;
-                        didHit = true;
-                        if (normal != NULL) {
-                            *normal = tmpNormal;
+            for (coords[a0] = from[a0]; coords[a0] != to[a0]; coords[a0] += step[a0]) {
+                if (canStop && _shape_box_cast_is_out_of_reach(v[a0],
+                                                               boxMin[a0],
+                                                               boxMax[a0],
+                                                               origin[a0] + coords[a0],
+                                                               minSwept)) {
+                    break;
+                }
+                for (coords[a1] = from[a1]; coords[a1] != to[a1]; coords[a1] += step[a1]) {
+                    if (canStop && _shape_box_cast_is_out_of_reach(v[a1],
+                                                                   boxMin[a1],
+                                                                   boxMax[a1],
+                                                                   origin[a1] + coords[a1],
+                                                                   minSwept)) {
+                        break;
+                    }
+                    for (coords[a2] = from[a2]; coords[a2] != to[a2]; coords[a2] += step[a2]) {
+                        if (canStop && _shape_box_cast_is_out_of_reach(v[a2],
+                                                                       boxMin[a2],
+                                                                       boxMax[a2],
+                                                                       origin[a2] + coords[a2],
+                                                                       minSwept)) {
+                            break;
                         }
-                        if (block != NULL) {
-                            *block = (Block *)octree_iterator_get_element(oi);
+
+                        if (chunk_is_block_solid(c,
+                                                 (CHUNK_COORDS_INT_T)coords[0],
+                                                 (CHUNK_COORDS_INT_T)coords[1],
+                                                 (CHUNK_COORDS_INT_T)coords[2]) == false) {
+                            continue;
                         }
-                        if (blockCoords != NULL) {
-                            uint16_t x, y, z;
-                            octree_iterator_get_current_position(oi, &x, &y, &z);
-                            blockCoords->x = (SHAPE_COORDS_INT_T)x;
-                            blockCoords->y = (SHAPE_COORDS_INT_T)y;
-                            blockCoords->z = (SHAPE_COORDS_INT_T)z;
+
+                        // block box in model space
+                        tmpBox.min.x = (float)(origin[0] + coords[0]);
+                        tmpBox.min.y = (float)(origin[1] + coords[1]);
+                        tmpBox.min.z = (float)(origin[2] + coords[2]);
+                        tmpBox.max.x = tmpBox.min.x + 1.0f;
+                        tmpBox.max.y = tmpBox.min.y + 1.0f;
+                        tmpBox.max.z = tmpBox.min.z + 1.0f;
+                        if (box_collide(&tmpBox, &broadPhaseBox) == false) {
+                            continue;
                         }
-                    }
-#if PHYSICS_EXTRA_REPLACEMENTS
-                    if (extraReplacement != NULL) {
-                        if (tmpReplacement.x != 0.0f && blockedX == false) {
-                            // previous replacement is positive and new replacement is positive &
-                            // bigger
-                            if (extraReplacement->x >= 0.0f &&
-                                tmpReplacement.x > extraReplacement->x) {
-                                extraReplacement->x = tmpReplacement.x;
-                            }
-                            // previous replacement is negative and new replacement is negative &
-                            // bigger
-                            else if (extraReplacement->x <= 0.0f &&
-                                     tmpReplacement.x < extraReplacement->x) {
-                                extraReplacement->x = tmpReplacement.x;
+
+                        swept = box_swept(modelBox,
+                                          modelVector,
+                                          &tmpBox,
+                                          epsilon,
+                                          withReplacement,
+                                          &tmpNormal,
+                                          &tmpReplacement);
+
+                        // same time of impact: keep the block an octree traversal would find first
+                        if (swept < minSwept ||
+                            (swept == minSwept && hitChunk == c &&
+                             _shape_octree_order(coords[0], coords[1], coords[2]) < hitOrder)) {
+                            minSwept = swept;
+                            didHit = true;
+                            hitChunk = c;
+                            hitOrder = _shape_octree_order(coords[0], coords[1], coords[2]);
+                            if (normal != NULL) {
+                                *normal = tmpNormal;
                             }
-                            // previous & new replacements are opposite... this axis is blocked,
-                            // set to 0 to avoid stuttering and wait for another axis to replace
-                            else if (extraReplacement->x * tmpReplacement.x < 0.0f) {
-                                extraReplacement->x = 0.0f;
-                                blockedX = true;
+                            if (block != NULL) {
+                                *block = chunk_get_block(c,
+                                                         (CHUNK_COORDS_INT_T)coords[0],
+                                                         (CHUNK_COORDS_INT_T)coords[1],
+                                                         (CHUNK_COORDS_INT_T)coords[2]);
                             }
-                        }
-                        if (tmpReplacement.y != 0.0f && blockedY == false) {
-                            if (extraReplacement->y >= 0.0f &&
-                                tmpReplacement.y > extraReplacement->y) {
-                                extraReplacement->y = tmpReplacement.y;
-                            } else if (extraReplacement->y <= 0.0f &&
-                                       tmpReplacement.y < extraReplacement->y) {
-                                extraReplacement->y = tmpReplacement.y;
-                            } else if (extraReplacement->y * tmpReplacement.y < 0.0f) {
-                                extraReplacement->y = 0.0f;
-                                blockedX = true;
+                            if (blockCoords != NULL) {
+                                blockCoords->x = (SHAPE_COORDS_INT_T)(origin[0] + coords[0]);
+                                blockCoords->y = (SHAPE_COORDS_INT_T)(origin[1] + coords[1]);
+                                blockCoords->z = (SHAPE_COORDS_INT_T)(origin[2] + coords[2]);
                             }
                         }
-                        if (tmpReplacement.z != 0.0f && blockedZ == false) {
-                            if (extraReplacement->z >= 0.0f &&
-                                tmpReplacement.z > extraReplacement->z) {
-                                extraReplacement->z = tmpReplacement.z;
-                            } else if (extraReplacement->z <= 0.0f &&
-                                       tmpReplacement.z < extraReplacement->z) {
-                                extraReplacement->z = tmpReplacement.z;
-                            } else if (extraReplacement->z * tmpReplacement.z < 0.0f) {
-                                extraReplacement->z = 0.0f;
-                                blockedX = true;
-                            }
+#if PHYSICS_EXTRA_REPLACEMENTS
+                        if (extraReplacement != NULL) {
+                            _shape_box_cast_merge_replacement(extraReplacement,
+                                                              &tmpReplacement,
+                                                              &blockedX,
+                                                              &blockedY,
+                                                              &blockedZ);
                         }
-                    }
 #endif
+                    }
                 }
-
-                octree_iterator_next(oi, collides == false && leaf == false, &leaf);
             }
-            octree_iterator_free(oi);
-
-            if (didHit && blockCoords != NULL) {
-                // chunk block coordinates in model space
-                blockCoords->x += chunkOrigin.x;
-                blockCoords->y += chunkOrigin.y;
-                blockCoords->z += chunkOrigin.z;
-            }
-
-            n = doubly_linked_list_node_next(n);
         }
     }
     doubly_linked_list_flush(chunksQuery, free);
@@ -2204,16 +2799,25 @@ bool shape_point_overlap(const Shape *s, const float3 *world) {
     CHUNK_COORDS_INT3_T coords_in_chunk;
     shape_get_chunk_and_coordinates(s, coords_in_shape, &c, NULL, &coords_in_chunk);
 
-    if (c != NULL) {
-        Block *b = (Block *)octree_get_element_without_checking(chunk_get_octree(c),
-                                                                (size_t)coords_in_chunk.x,
-                                                                (size_t)coords_in_chunk.y,
-                                                                (size_t)coords_in_chunk.z);
+    return chunk_is_block_solid(c, coords_in_chunk.x, coords_in_chunk.y, coords_in_chunk.z);
+}
 
-        return block_is_solid(b);
+/// Chunk blocks range along an axis, of blocks overlapped by a box (same test as box_collide)
+static void _shape_box_overlap_range(const float min,
+                                     const float max,
+                                     const SHAPE_COORDS_INT_T origin,
+                                     CHUNK_COORDS_INT_T *from,
+                                     CHUNK_COORDS_INT_T *to) {
+    int lo = (int)floorf(min);
+    if ((min < (float)(lo + 1) - EPSILON_COLLISION) == false) {
+        ++lo;
     }
-
-    return false;
+    int hi = (int)floorf(max);
+    if ((max > (float)hi + EPSILON_COLLISION) == false) {
+        --hi;
+    }
+    *from = (CHUNK_COORDS_INT_T)CLAMP(lo - origin, 0, CHUNK_SIZE);
+    *to = (CHUNK_COORDS_INT_T)CLAMP(hi - origin, -1, CHUNK_SIZE_MINUS_ONE);
 }
 
 bool shape_box_overlap(const Shape *s, const Box *modelBox, Box *out) {
@@ -2229,42 +2833,44 @@ bool shape_box_overlap(const Shape *s, const Box *modelBox, Box *out) {
 
         // examine query results, stop at first overlap
         RtreeNode *hit = fifo_list_pop(chunksQuery);
-        OctreeIterator *oi;
-        bool leaf;
         Chunk *c;
-        Box tmpBox;
+        CHUNK_COORDS_INT3_T min, max;
         while (hit != NULL && didHit == false) {
             c = (Chunk *)rtree_node_get_leaf_ptr(hit);
+            hit = fifo_list_pop(chunksQuery);
 
-            const SHAPE_COORDS_INT3_T chunkOrigin = chunk_get_origin(c);
-            leaf = false;
-
-            oi = octree_iterator_new(chunk_get_octree(c));
-            while (octree_iterator_is_done(oi) == false) {
-                octree_iterator_get_node_box(oi, &tmpBox);
-
-                // chunk octree box in model space
-                tmpBox.min.x += chunkOrigin.x;
-                tmpBox.min.y += chunkOrigin.y;
-                tmpBox.min.z += chunkOrigin.z;
-                tmpBox.max.x += chunkOrigin.x;
-                tmpBox.max.y += chunkOrigin.y;
-                tmpBox.max.z += chunkOrigin.z;
-
-                const bool collides = box_collide(modelBox, &tmpBox);
-                if (leaf && collides) {
-                    didHit = true;
-                    if (out != NULL) {
-                        *out = tmpBox;
+            const SHAPE_COORDS_INT3_T origin = chunk_get_origin(c);
+            _shape_box_overlap_range(modelBox->min.x, modelBox->max.x, origin.x, &min.x, &max.x);
+            _shape_box_overlap_range(modelBox->min.y, modelBox->max.y, origin.y, &min.y, &max.y);
+            _shape_box_overlap_range(modelBox->min.z, modelBox->max.z, origin.z, &min.z, &max.z);
+            if (chunk_has_solid_blocks_in_box(c, min, max) == false) {
+                continue;
+            }
+            didHit = true;
+
+            if (out != NULL) {
+                // report the block an octree traversal would find first
+                uint32_t order, hitOrder = UINT32_MAX;
+                for (CHUNK_COORDS_INT_T z = min.z; z <= max.z; ++z) {
+                    for (CHUNK_COORDS_INT_T y = min.y; y <= max.y; ++y) {
+                        for (CHUNK_COORDS_INT_T x = min.x; x <= max.x; ++x) {
+                            if (chunk_is_block_solid(c, x, y, z) == false) {
+                                continue;
+                            }
+                            order = _shape_octree_order(x, y, z);
+                            if (order < hitOrder) {
+                                hitOrder = order;
+                                out->min = (float3){(float)(origin.x + x),
+                                                    (float)(origin.y + y),
+                                                    (float)(origin.z + z)};
+                                out->max = (float3){out->min.x + 1.0f,
+                                                    out->min.y + 1.0f,
+                                                    out->min.z + 1.0f};
+                            }
+                        }
                     }
-                    break;
                 }
-
-                octree_iterator_next(oi, collides == false && leaf == false, &leaf);
             }
-            octree_iterator_free(oi);
-
-            hit = fifo_list_pop(chunksQuery);
         }
     }
     fifo_list_free(chunksQuery, NULL);
@@ -2889,13 +3495,11 @@ void shape_history_undo(Shape *const s) {
         return;
     }
     if (s->pendingTransaction != NULL) {
-        transaction_free(s->pendingTransaction);
-        s->pendingTransaction = NULL;
+        _shape_free_pending_transaction(s);
     } else {
-        Transaction *const tr = history_getTransactionToUndo(s->history);
-        if (tr != NULL) {
-            transaction_resetIndex3DIterator(tr);
-            _shape_undo_transaction(s, tr);
+        const HistoryRecord *r = history_get_record_to_undo(s->history);
+        if (r != NULL) {
+            _shape_apply_history_record(s, r, true);
         }
     }
 }
@@ -2907,13 +3511,26 @@ void shape_history_redo(Shape *const s) {
     if (s->history == NULL) {
         return;
     }
-    Transaction *tr = history_getTransactionToRedo(s->history);
-    if (tr != NULL) {
-        transaction_resetIndex3DIterator(tr);
-        _shape_apply_transaction(s, tr);
+    const HistoryRecord *r = history_get_record_to_redo(s->history);
+    if (r != NULL) {
+        _shape_apply_history_record(s, r, false);
     }
 }
 
+void shape_history_setMemoryLimit(Shape *const s, const size_t bytes) {
+    if (s == NULL || s->history == NULL) {
+        return;
+    }
+    history_set_memory_limit(s->history, bytes);
+}
+
+size_t shape_history_getMemoryUsage(const Shape *const s) {
+    if (s == NULL || s->history == NULL) {
+        return 0;
+    }
+    return history_get_memory_usage(s->history);
+}
+
 // MARK: - Lua flags -
 
 bool shape_is_lua_mutable(const Shape *s) {
@@ -3024,6 +3641,19 @@ void _shape_chunk_check_neighbors_dirty(Shape *shape,
     }
 }
 
+void _shape_insert_chunk(Shape *shape, Chunk *chunk, const SHAPE_COORDS_INT3_T chunk_coords) {
+    const SHAPE_COORDS_INT3_T chunkOrigin = chunk_get_origin(chunk);
+
+    index3d_insert(shape->chunks, chunk, chunk_coords.x, chunk_coords.y, chunk_coords.z, NULL);
+    chunk_move_in_neighborhood(shape->chunks, chunk, chunk_coords);
+
+    Box chunkBox = {{(float)chunkOrigin.x, (float)chunkOrigin.y, (float)chunkOrigin.z},
+                    {(float)(chunkOrigin.x + CHUNK_SIZE),
+                     (float)(chunkOrigin.y + CHUNK_SIZE),
+                     (float)(chunkOrigin.z + CHUNK_SIZE)}};
+    chunk_set_rtree_leaf(chunk, rtree_create_and_insert(shape->rtree, &chunkBox, 1, 1, chunk));
+}
+
 bool _shape_add_block_in_chunks(Shape *shape,
                                 const Block block,
                                 const SHAPE_COORDS_INT_T x,
@@ -3045,15 +3675,7 @@ bool _shape_add_block_in_chunks(Shape *shape,
                                            (SHAPE_COORDS_INT_T)chunk_coords.y * CHUNK_SIZE,
                                            (SHAPE_COORDS_INT_T)chunk_coords.z * CHUNK_SIZE};
         chunk = chunk_new(chunkOrigin);
-
-        index3d_insert(shape->chunks, chunk, chunk_coords.x, chunk_coords.y, chunk_coords.z, NULL);
-        chunk_move_in_neighborhood(shape->chunks, chunk, chunk_coords);
-
-        Box chunkBox = {{(float)chunkOrigin.x, (float)chunkOrigin.y, (float)chunkOrigin.z},
-                        {(float)(chunkOrigin.x + CHUNK_SIZE),
-                         (float)(chunkOrigin.y + CHUNK_SIZE),
-                         (float)(chunkOrigin.z + CHUNK_SIZE)}};
-        chunk_set_rtree_leaf(chunk, rtree_create_and_insert(shape->rtree, &chunkBox, 1, 1, chunk));
+        _shape_insert_chunk(shape, chunk, chunk_coords);
 
         *chunkAdded = true;
     } else {
@@ -3423,6 +4045,7 @@ void _light_propagate(Shape *s,
                       SHAPE_COORDS_INT_T srcY,
                       SHAPE_COORDS_INT_T srcZ,
                       bool initWithEmptyLight) {
+    PROFILER_ZONE_BEGIN("_light_propagate");
 
 #if SHAPE_LIGHTING_DEBUG
     cclog_debug("☀️ light propagation started...");
@@ -3788,6 +4411,8 @@ void _light_propagate(Shape *s,
 #if SHAPE_LIGHTING_DEBUG
     cclog_debug("☀️ light propagation done with %d iterations", iCount);
 #endif
+
+    PROFILER_ZONE_END();
 }
 
 void _light_removal(Shape *s,
@@ -3795,6 +4420,7 @@ void _light_removal(Shape *s,
                     SHAPE_COORDS_INT3_T *bbMax,
                     LightRemovalNodeQueue *lightRemovalQueue,
                     LightNodeQueue *lightQueue) {
+    PROFILER_ZONE_BEGIN("_light_removal");
 
 #if SHAPE_LIGHTING_DEBUG
     cclog_debug("☀️ light removal started...");
@@ -4036,6 +4662,8 @@ void _light_removal(Shape *s,
 #if SHAPE_LIGHTING_DEBUG
     cclog_debug("☀️ light removal done with %d iterations", iCount);
 #endif
+
+    PROFILER_ZONE_END();
 }
 
 void _light_removal_all(Shape *s, SHAPE_COORDS_INT3_T *min, SHAPE_COORDS_INT3_T *max) {
@@ -4088,23 +4716,50 @@ void _shape_flush_all_vb(Shape *s) {
     while (index3d_iterator_pointer(it) != NULL) {
         c = index3d_iterator_pointer(it);
 
-        chunk_set_vbma(c, NULL, false);
-        chunk_set_vbma(c, NULL, true);
+        for (uint8_t lod = 0; lod < CHUNK_LOD_COUNT; ++lod) {
+            chunk_set_lod_vbma(c, NULL, lod, false);
+            chunk_set_lod_vbma(c, NULL, lod, true);
+        }
         _shape_chunk_enqueue_refresh(s, c);
 
         index3d_iterator_next(it);
     }
     index3d_iterator_free(it);
 
-    // free all vertex buffers
+    // free all vertex buffers, compaction may have been ongoing
+    doubly_linked_list_flush(s->fragmentedVBs, NULL);
     vertex_buffer_free_all(s->firstVB_opaque);
     s->firstVB_opaque = NULL;
     vertex_buffer_free_all(s->firstVB_transparent);
     s->firstVB_transparent = NULL;
+    _shape_free_lod_vbs(s);
     s->vbAllocationFlag_opaque = 0;
     s->vbAllocationFlag_transparent = 0;
 }
 
+static void _shape_free_lod_vbs(Shape *s) {
+    for (int lod = 0; lod < CHUNK_LOD_COUNT - 1; ++lod) {
+        for (int i = 0; i < 2; ++i) {
+            vertex_buffer_free_all(s->firstVB_lod[lod][i]);
+            s->firstVB_lod[lod][i] = NULL;
+        }
+    }
+}
+
+static void _shape_check_lod_vbs_fragmented(Shape *s) {
+    for (int lod = 0; lod < CHUNK_LOD_COUNT - 1; ++lod) {
+        _shape_check_all_vb_fragmented(s, s->firstVB_lod[lod][0]);
+        _shape_check_all_vb_fragmented(s, s->firstVB_lod[lod][1]);
+    }
+}
+
+static void _shape_fill_lod_draw_slices(Shape *s) {
+    for (int lod = 0; lod < CHUNK_LOD_COUNT - 1; ++lod) {
+        _shape_fill_draw_slices(s->firstVB_lod[lod][0]);
+        _shape_fill_draw_slices(s->firstVB_lod[lod][1]);
+    }
+}
+
 void _shape_fill_draw_slices(VertexBuffer *vb) {
     while (vb != NULL) {
         vertex_buffer_fill_draw_slices(vb);
@@ -4123,29 +4778,41 @@ VertexBuffer *_shape_get_latest_buffer(const Shape *s, const bool transparent) {
     }
 }
 
-bool _shape_apply_transaction(Shape *const sh, Transaction *tr) {
+/// Applies block changes of the transaction not applied yet, returns a record of these changes
+/// or NULL if allocation fails.
+HistoryRecord *_shape_apply_transaction(Shape *const sh, Transaction *tr) {
     vx_assert(sh != NULL);
     vx_assert(tr != NULL);
     if (sh == NULL) {
-        return false;
+        return NULL;
     }
     if (tr == NULL) {
-        return false;
+        return NULL;
     }
 
     // Returned iterator remains under transaction responsibility
     // Do not free it!
     Index3DIterator *it = transaction_getIndex3DIterator(tr);
     if (it == NULL) {
-        return false;
+        return NULL;
+    }
+
+    HistoryChanges *changes = history_changes_new();
+    if (changes == NULL ||
+        history_changes_reserve(changes, transaction_getNbBlockChanges(tr)) == false) {
+        history_changes_free(changes);
+        return NULL;
     }
 
     // loop on all the BlockChanges
-    uint32_t resetBoxNeeded = false;
     SHAPE_COLOR_INDEX_INT_T before, after;
     SHAPE_COORDS_INT_T x, y, z;
     BlockChange *bc;
-    const Block *b;
+
+    // consecutive changes are usually in the same chunk, its blocks are read directly
+    SHAPE_COORDS_INT3_T chunkCoords = {0, 0, 0};
+    const Block *blocks = NULL;
+    bool chunkRead = false;
 
     while (index3d_iterator_pointer(it) != NULL) {
         bc = (BlockChange *)index3d_iterator_pointer(it);
@@ -4157,105 +4824,645 @@ bool _shape_apply_transaction(Shape *const sh, Transaction *tr) {
         // an issue since transactions can be applied from a line-by-line refresh in Lua
         // (eg. shape.Width), meaning part of an amended transaction could've been applied
         // already. As a result, we'll always use the CURRENT block
-        b = shape_get_block_immediate(sh, x, y, z);
-        before = b != NULL ? b->colorIndex : SHAPE_COLOR_INDEX_AIR_BLOCK;
+        const SHAPE_COORDS_INT3_T coords = {x, y, z};
+        const SHAPE_COORDS_INT3_T c = chunk_utils_get_coords(coords);
+        if (chunkRead == false || c.x != chunkCoords.x || c.y != chunkCoords.y ||
+            c.z != chunkCoords.z) {
+            const Chunk *chunk = (const Chunk *)index3d_get(sh->chunks, c.x, c.y, c.z);
+            blocks = chunk != NULL ? (const Block *)octree_get_elements(chunk_get_octree(chunk))
+                                   : NULL;
+            chunkCoords = c;
+            chunkRead = true;
+        }
+        if (blocks != NULL) {
+            const int idx = (x - c.x * CHUNK_SIZE) + (y - c.y * CHUNK_SIZE) * CHUNK_SIZE +
+                            (z - c.z * CHUNK_SIZE) * CHUNK_SIZE_SQR;
+            before = blocks[idx].colorIndex;
+        } else {
+            before = SHAPE_COLOR_INDEX_AIR_BLOCK;
+        }
         blockChange_set_previous_color(bc, before);
 
         after = blockChange_getBlock(bc)->colorIndex;
 
-        // [air>block] = add block
-        if (before == SHAPE_COLOR_INDEX_AIR_BLOCK && after != SHAPE_COLOR_INDEX_AIR_BLOCK) {
-            shape_add_block(sh, after, x, y, z, false);
-        }
-        // [block>air] = remove block
-        else if (before != SHAPE_COLOR_INDEX_AIR_BLOCK && after == SHAPE_COLOR_INDEX_AIR_BLOCK) {
-            shape_remove_block(sh, x, y, z);
-            if (index3d_iterator_pointer(it) == NULL) {
-                // if block removal is the only transaction, use cheaper function
-                shape_shrink_box(sh, (SHAPE_COORDS_INT3_T){x, y, z});
-            } else {
-                resetBoxNeeded = true;
+        // [air>block] = add block, [block>air] = remove block, [block>block] = paint block
+        history_changes_add(changes, coords, before, after);
+
+        index3d_iterator_next(it);
+    }
+
+    // changes sorted per chunk are applied in bulk, like a redo
+    HistoryRecord *r = history_record_new(changes);
+    if (r == NULL) {
+        return NULL;
+    }
+    _shape_apply_history_record(sh, r, false);
+
+    return r;
+}
+
+static void _shape_free_pending_transaction(Shape *const sh) {
+    transaction_free(sh->pendingTransaction);
+    sh->pendingTransaction = NULL;
+    history_changes_free(sh->pendingChanges);
+    sh->pendingChanges = NULL;
+}
+
+bool _shape_apply_history_record(Shape *const sh, const HistoryRecord *r, const bool undo) {
+    vx_assert(sh != NULL);
+    vx_assert(r != NULL);
+    if (sh == NULL || r == NULL) {
+        return false;
+    }
+
+    const bool bakedLighting = _shape_get_rendering_flag(sh, SHAPE_RENDERING_FLAG_BAKED_LIGHTING);
+    LightNodeQueue *lightQueue = bakedLighting ? light_node_queue_new() : NULL;
+    LightRemovalNodeQueue *lightRemovalQueue = bakedLighting ? light_removal_node_queue_new()
+                                                             : NULL;
+
+    // palette & blocks count are updated once per color
+    int32_t colorDeltas[SHAPE_COLOR_INDEX_MAX_COUNT + 1] = {0};
+    SHAPE_COORDS_INT3_T changedMin = {0, 0, 0}, changedMax = {0, 0, 0}, lastRemoved;
+    bool added = false, changed = false;
+    uint32_t nbRemoved = 0;
+
+    const HistoryChunk *rc = history_record_get_chunks(r);
+    const HistorySpan *span = history_record_get_spans(r);
+    const uint32_t nbChunks = history_record_get_nb_chunks(r);
+
+    for (uint32_t i = 0; i < nbChunks; ++i, ++rc) {
+        Chunk *chunk = (Chunk *)index3d_get(sh->chunks, rc->coords.x, rc->coords.y, rc->coords.z);
+        Block *blocks = chunk != NULL ? (Block *)octree_get_elements(chunk_get_octree(chunk))
+                                      : NULL;
+        const SHAPE_COORDS_INT3_T origin = {(SHAPE_COORDS_INT_T)(rc->coords.x * CHUNK_SIZE),
+                                            (SHAPE_COORDS_INT_T)(rc->coords.y * CHUNK_SIZE),
+                                            (SHAPE_COORDS_INT_T)(rc->coords.z * CHUNK_SIZE)};
+        bool chunkChanged = false;
+
+        for (uint16_t j = 0; j < rc->nbSpans; ++j, ++span) {
+            const SHAPE_COLOR_INDEX_INT_T target = undo ? span->before : span->after;
+
+            for (CHUNK_COORDS_INT_T k = 0; k < (CHUNK_COORDS_INT_T)span->length; ++k) {
+                const CHUNK_COORDS_INT3_T coordsInChunk = {(CHUNK_COORDS_INT_T)(span->x + k),
+                                                           span->y,
+                                                           span->z};
+                const int idx = coordsInChunk.x + coordsInChunk.y * CHUNK_SIZE +
+                                coordsInChunk.z * CHUNK_SIZE_SQR;
+
+                // always compare to CURRENT block, shape may have been changed outside of history
+                const SHAPE_COLOR_INDEX_INT_T current = blocks != NULL
+                                                            ? blocks[idx].colorIndex
+                                                            : SHAPE_COLOR_INDEX_AIR_BLOCK;
+                if (current == target) {
+                    continue;
+                }
+
+                if (blocks == NULL) {
+                    chunk = chunk_new(origin);
+                    _shape_insert_chunk(sh, chunk, rc->coords);
+                    sh->nbChunks++;
+                    blocks = (Block *)octree_get_elements(chunk_get_octree(chunk));
+                }
+                blocks[idx].colorIndex = target;
+
+                const SHAPE_COORDS_INT3_T coords = {
+                    (SHAPE_COORDS_INT_T)(origin.x + coordsInChunk.x),
+                    (SHAPE_COORDS_INT_T)(origin.y + coordsInChunk.y),
+                    (SHAPE_COORDS_INT_T)(origin.z + coordsInChunk.z)};
+
+                // [air>block] = add block
+                if (current == SHAPE_COLOR_INDEX_AIR_BLOCK) {
+                    sh->nbBlocks++;
+                    ++colorDeltas[target];
+                    added = true;
+                }
+                // [block>air] = remove block
+                else if (target == SHAPE_COLOR_INDEX_AIR_BLOCK) {
+                    sh->nbBlocks--;
+                    --colorDeltas[current];
+                    lastRemoved = coords;
+                    ++nbRemoved;
+                }
+                // [block>block] = paint block
+                else {
+                    --colorDeltas[current];
+                    ++colorDeltas[target];
+                }
+
+                if (bakedLighting) {
+                    _shape_region_queue_lighting(sh,
+                                                 lightQueue,
+                                                 lightRemovalQueue,
+                                                 chunk,
+                                                 coords,
+                                                 coordsInChunk,
+                                                 current,
+                                                 target);
+                }
+
+                if (changed) {
+                    changedMin = (SHAPE_COORDS_INT3_T){minimum(changedMin.x, coords.x),
+                                                       minimum(changedMin.y, coords.y),
+                                                       minimum(changedMin.z, coords.z)};
+                    changedMax = (SHAPE_COORDS_INT3_T){maximum(changedMax.x, coords.x),
+                                                       maximum(changedMax.y, coords.y),
+                                                       maximum(changedMax.z, coords.z)};
+                } else {
+                    changedMin = changedMax = coords;
+                    changed = true;
+                }
+
+                _shape_chunk_check_neighbors_dirty(sh, chunk, coordsInChunk);
+                chunkChanged = true;
             }
         }
-        // [block>block] = paint block
-        else if (before != SHAPE_COLOR_INDEX_AIR_BLOCK && after != SHAPE_COLOR_INDEX_AIR_BLOCK &&
-                 before != after) {
-            shape_paint_block(sh, after, x, y, z);
+
+        if (chunkChanged) {
+            chunk_refresh_blocks(chunk);
+            _shape_chunk_enqueue_refresh(sh, chunk);
         }
+    }
 
-        index3d_iterator_next(it);
+    _shape_apply_color_deltas(sh, colorDeltas);
+    if (added) {
+        shape_expand_box(sh, changedMin);
+        shape_expand_box(sh, changedMax);
+    }
+
+    // lighting passes run once for all changed blocks, before shrinking the box
+    if (bakedLighting) {
+        if (changed) {
+            SHAPE_COORDS_INT3_T lightMin = changedMin, lightMax = changedMax;
+            _light_removal(sh, &lightMin, &lightMax, lightRemovalQueue, lightQueue);
+            _light_propagate(sh,
+                             &lightMin,
+                             &lightMax,
+                             lightQueue,
+                             changedMin.x,
+                             changedMin.y,
+                             changedMin.z,
+                             false);
+        }
+        light_removal_node_queue_free(lightRemovalQueue);
+        light_node_queue_free(lightQueue);
     }
 
-    if (resetBoxNeeded) {
+    if (nbRemoved == 1) {
+        // cheaper for a single block removal
+        shape_shrink_box(sh, lastRemoved);
+    } else if (nbRemoved > 1) {
         shape_reset_box(sh);
     }
 
     return true;
 }
 
-bool _shape_undo_transaction(Shape *const sh, Transaction *tr) {
-    vx_assert(sh != NULL);
-    vx_assert(tr != NULL);
-    if (sh == NULL) {
-        return false;
+void _shape_apply_color_deltas(Shape *const sh, const int32_t *colorDeltas) {
+    for (int c = 0; c < SHAPE_COLOR_INDEX_MAX_COUNT; ++c) {
+        if (colorDeltas[c] > 0) {
+            color_palette_increment_color(sh->palette,
+                                          (SHAPE_COLOR_INDEX_INT_T)c,
+                                          (uint32_t)colorDeltas[c]);
+        } else if (colorDeltas[c] < 0) {
+            color_palette_decrement_color(sh->palette,
+                                          (SHAPE_COLOR_INDEX_INT_T)c,
+                                          (uint32_t)-colorDeltas[c]);
+        }
+        sh->blocksCount[c] = (uint32_t)((int32_t)sh->blocksCount[c] + colorDeltas[c]);
     }
-    if (tr == NULL) {
-        return false;
+}
+
+/// Applies a region operation from `min` (included) to `max` (excluded), blocks are written
+/// directly in chunk octrees which are then refreshed once. Palette usage, bounding box, baked
+/// lighting & history are updated once for the whole region.
+static size_t _shape_apply_region(Shape *const sh,
+                                  Scene *scene,
+                                  const SHAPE_COORDS_INT3_T min,
+                                  const SHAPE_COORDS_INT3_T max,
+                                  const ShapeRegion *region) {
+    if (min.x >= max.x || min.y >= max.y || min.z >= max.z ||
+        _shape_get_rendering_flag(sh, SHAPE_RENDERING_FLAG_BAKE_LOCKED)) {
+        return 0;
     }
 
-    // No need to resize the shape down
+    const bool bakedLighting = _shape_get_rendering_flag(sh, SHAPE_RENDERING_FLAG_BAKED_LIGHTING);
+    LightNodeQueue *lightQueue = bakedLighting ? light_node_queue_new() : NULL;
+    LightRemovalNodeQueue *lightRemovalQueue = bakedLighting ? light_removal_node_queue_new()
+                                                             : NULL;
+    HistoryChanges *changes = NULL;
+    if (_shape_get_lua_flag(sh, SHAPE_LUA_FLAG_HISTORY) && sh->history != NULL) {
+        changes = history_changes_new();
+    }
+
+    // palette & blocks count are updated once per color
+    int32_t colorDeltas[SHAPE_COLOR_INDEX_MAX_COUNT + 1] = {0};
+    SHAPE_COORDS_INT3_T changedMin = min, changedMax = min;
+    SHAPE_COORDS_INT3_T addedMin = min, addedMax = min;
+    bool added = false, removed = false, anyChunkChanged = false;
+    size_t nbChanged = 0;
+
+    const SHAPE_COORDS_INT3_T chunkMin = chunk_utils_get_coords(min);
+    const SHAPE_COORDS_INT3_T chunkMax = chunk_utils_get_coords(
+        (SHAPE_COORDS_INT3_T){(SHAPE_COORDS_INT_T)(max.x - 1),
+                              (SHAPE_COORDS_INT_T)(max.y - 1),
+                              (SHAPE_COORDS_INT_T)(max.z - 1)});
+
+    for (int cz = chunkMin.z; cz <= chunkMax.z; ++cz) {
+        for (int cy = chunkMin.y; cy <= chunkMax.y; ++cy) {
+            for (int cx = chunkMin.x; cx <= chunkMax.x; ++cx) {
+                const SHAPE_COORDS_INT3_T chunkCoords = {(SHAPE_COORDS_INT_T)cx,
+                                                         (SHAPE_COORDS_INT_T)cy,
+                                                         (SHAPE_COORDS_INT_T)cz};
+                const SHAPE_COORDS_INT3_T origin = {(SHAPE_COORDS_INT_T)(cx * CHUNK_SIZE),
+                                                    (SHAPE_COORDS_INT_T)(cy * CHUNK_SIZE),
+                                                    (SHAPE_COORDS_INT_T)(cz * CHUNK_SIZE)};
+                Chunk *chunk = (Chunk *)index3d_get(sh->chunks, cx, cy, cz);
+                Block *blocks = chunk != NULL
+                                    ? (Block *)octree_get_elements(chunk_get_octree(chunk))
+                                    : NULL;
+
+                // region within chunk, `to` excluded
+                const CHUNK_COORDS_INT3_T from = {
+                    (CHUNK_COORDS_INT_T)maximum(min.x - origin.x, 0),
+                    (CHUNK_COORDS_INT_T)maximum(min.y - origin.y, 0),
+                    (CHUNK_COORDS_INT_T)maximum(min.z - origin.z, 0)};
+                const CHUNK_COORDS_INT3_T to = {
+                    (CHUNK_COORDS_INT_T)minimum(max.x - origin.x, CHUNK_SIZE),
+                    (CHUNK_COORDS_INT_T)minimum(max.y - origin.y, CHUNK_SIZE),
+                    (CHUNK_COORDS_INT_T)minimum(max.z - origin.z, CHUNK_SIZE)};
+                CHUNK_COORDS_INT3_T chunkChangedMin = to, chunkChangedMax = from;
+                bool chunkChanged = false;
+
+                for (CHUNK_COORDS_INT_T z = from.z; z < to.z; ++z) {
+                    for (CHUNK_COORDS_INT_T y = from.y; y < to.y; ++y) {
+                        for (CHUNK_COORDS_INT_T x = from.x; x < to.x; ++x) {
+                            const int idx = x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQR;
+                            const SHAPE_COLOR_INDEX_INT_T current =
+                                blocks != NULL ? blocks[idx].colorIndex
+                                               : SHAPE_COLOR_INDEX_AIR_BLOCK;
+                            const SHAPE_COORDS_INT3_T coords = {
+                                (SHAPE_COORDS_INT_T)(origin.x + x),
+                                (SHAPE_COORDS_INT_T)(origin.y + y),
+                                (SHAPE_COORDS_INT_T)(origin.z + z)};
+                            const SHAPE_COLOR_INDEX_INT_T target =
+                                _shape_region_get_target(region, coords, current);
+                            if (target == current) {
+                                continue;
+                            }
 
-    // Returned iterator remains under transaction responsibility
-    // Do not free it!
-    Index3DIterator *it = transaction_getIndex3DIterator(tr);
-    if (it == NULL) {
-        return false;
-    }
+                            if (blocks == NULL) {
+                                chunk = chunk_new(origin);
+                                _shape_insert_chunk(sh, chunk, chunkCoords);
+                                sh->nbChunks++;
+                                blocks = (Block *)octree_get_elements(chunk_get_octree(chunk));
+                            }
+                            blocks[idx].colorIndex = target;
+
+                            if (current == SHAPE_COLOR_INDEX_AIR_BLOCK) {
+                                sh->nbBlocks++;
+                                ++colorDeltas[target];
+                                if (added) {
+                                    addedMin = (SHAPE_COORDS_INT3_T){
+                                        minimum(addedMin.x, coords.x),
+                                        minimum(addedMin.y, coords.y),
+                                        minimum(addedMin.z, coords.z)};
+                                    addedMax = (SHAPE_COORDS_INT3_T){
+                                        maximum(addedMax.x, coords.x),
+                                        maximum(addedMax.y, coords.y),
+                                        maximum(addedMax.z, coords.z)};
+                                } else {
+                                    addedMin = addedMax = coords;
+                                    added = true;
+                                }
+                            } else if (target == SHAPE_COLOR_INDEX_AIR_BLOCK) {
+                                sh->nbBlocks--;
+                                --colorDeltas[current];
+                                removed = true;
+                            } else {
+                                --colorDeltas[current];
+                                ++colorDeltas[target];
+                            }
 
-    // loop on all the BlockChanges and revert them
-    bool resetBoxNeeded = false;
-    SHAPE_COLOR_INDEX_INT_T before, after;
-    SHAPE_COORDS_INT_T x, y, z;
-    BlockChange *bc;
-    const Block *b;
+                            if (changes != NULL) {
+                                history_changes_add(changes, coords, current, target);
+                            }
+                            if (bakedLighting) {
+                                _shape_region_queue_lighting(sh,
+                                                             lightQueue,
+                                                             lightRemovalQueue,
+                                                             chunk,
+                                                             coords,
+                                                             (CHUNK_COORDS_INT3_T){x, y, z},
+                                                             current,
+                                                             target);
+                            }
 
-    while (index3d_iterator_pointer(it) != NULL) {
-        bc = (BlockChange *)index3d_iterator_pointer(it);
+                            chunkChangedMin = (CHUNK_COORDS_INT3_T){
+                                minimum(chunkChangedMin.x, x),
+                                minimum(chunkChangedMin.y, y),
+                                minimum(chunkChangedMin.z, z)};
+                            chunkChangedMax = (CHUNK_COORDS_INT3_T){
+                                maximum(chunkChangedMax.x, x),
+                                maximum(chunkChangedMax.y, y),
+                                maximum(chunkChangedMax.z, z)};
+                            chunkChanged = true;
+                            ++nbChanged;
+                        }
+                    }
+                }
 
-        blockChange_getXYZ(bc, &x, &y, &z);
+                if (chunkChanged == false) {
+                    continue;
+                }
+
+                chunk_refresh_blocks(chunk);
+                _shape_chunk_enqueue_refresh(sh, chunk);
+                _shape_chunk_check_neighbors_dirty(sh, chunk, chunkChangedMin);
+                _shape_chunk_check_neighbors_dirty(sh, chunk, chunkChangedMax);
+
+                const SHAPE_COORDS_INT3_T cMin = {
+                    (SHAPE_COORDS_INT_T)(origin.x + chunkChangedMin.x),
+                    (SHAPE_COORDS_INT_T)(origin.y + chunkChangedMin.y),
+                    (SHAPE_COORDS_INT_T)(origin.z + chunkChangedMin.z)};
+                const SHAPE_COORDS_INT3_T cMax = {
+                    (SHAPE_COORDS_INT_T)(origin.x + chunkChangedMax.x),
+                    (SHAPE_COORDS_INT_T)(origin.y + chunkChangedMax.y),
+                    (SHAPE_COORDS_INT_T)(origin.z + chunkChangedMax.z)};
+                if (anyChunkChanged == false) {
+                    changedMin = cMin;
+                    changedMax = cMax;
+                    anyChunkChanged = true;
+                } else {
+                    changedMin = (SHAPE_COORDS_INT3_T){minimum(changedMin.x, cMin.x),
+                                                       minimum(changedMin.y, cMin.y),
+                                                       minimum(changedMin.z, cMin.z)};
+                    changedMax = (SHAPE_COORDS_INT3_T){maximum(changedMax.x, cMax.x),
+                                                       maximum(changedMax.y, cMax.y),
+                                                       maximum(changedMax.z, cMax.z)};
+                }
+            }
+        }
+    }
+
+    _shape_apply_color_deltas(sh, colorDeltas);
+    if (added) {
+        shape_expand_box(sh, addedMin);
+        shape_expand_box(sh, addedMax);
+    }
+
+    // lighting passes run once for all changed blocks, before shrinking the box like with
+    // block by block removal
+    if (bakedLighting) {
+        if (nbChanged > 0) {
+            SHAPE_COORDS_INT3_T lightMin = changedMin, lightMax = changedMax;
+            _light_removal(sh, &lightMin, &lightMax, lightRemovalQueue, lightQueue);
+            _light_propagate(sh,
+                             &lightMin,
+                             &lightMax,
+                             lightQueue,
+                             changedMin.x,
+                             changedMin.y,
+                             changedMin.z,
+                             false);
+        }
+        light_removal_node_queue_free(lightRemovalQueue);
+        light_node_queue_free(lightQueue);
+    }
 
-        b = shape_get_block_immediate(sh, x, y, z);
-        before = b != NULL ? b->colorIndex : SHAPE_COLOR_INDEX_AIR_BLOCK;
+    if (removed) {
+        shape_reset_box(sh);
+    }
 
-        after = blockChange_get_previous_color(bc);
+    // all changes are stored as a single action
+    if (changes != NULL) {
+        if (nbChanged > 0) {
+            history_pushChanges(sh->history, changes);
+        } else {
+            history_changes_free(changes);
+        }
+    }
 
-        // [air>block] = add block
-        if (before == SHAPE_COLOR_INDEX_AIR_BLOCK && after != SHAPE_COLOR_INDEX_AIR_BLOCK) {
-            shape_add_block(sh, after, x, y, z, false);
+    // register awake box if using per-block collisions
+    if (nbChanged > 0 && scene != NULL &&
+        rigidbody_uses_per_block_collisions(transform_get_rigidbody(sh->transform))) {
+        scene_register_awake_blocks_box(
+            scene,
+            sh->transform,
+            changedMin,
+            (SHAPE_COORDS_INT3_T){(SHAPE_COORDS_INT_T)(changedMax.x + 1),
+                                  (SHAPE_COORDS_INT_T)(changedMax.y + 1),
+                                  (SHAPE_COORDS_INT_T)(changedMax.z + 1)});
+    }
+
+    return nbChanged;
+}
+
+static SHAPE_COLOR_INDEX_INT_T _shape_region_get_target(const ShapeRegion *region,
+                                                        const SHAPE_COORDS_INT3_T coords,
+                                                        const SHAPE_COLOR_INDEX_INT_T current) {
+    switch (region->op) {
+        case ShapeRegionOp_Fill:
+            return region->color;
+        case ShapeRegionOp_Replace:
+            return current == region->from ? region->color : current;
+        case ShapeRegionOp_Copy: {
+            // air blocks from source are not copied
+            const size_t idx = (size_t)(coords.x - region->origin.x) +
+                               (size_t)(coords.y - region->origin.y) * (size_t)region->sizeX +
+                               (size_t)(coords.z - region->origin.z) * (size_t)region->sizeX *
+                                   (size_t)region->sizeY;
+            const SHAPE_COLOR_INDEX_INT_T color = region->colors[idx];
+            return color != SHAPE_COLOR_INDEX_AIR_BLOCK ? color : current;
         }
-        // [block>air] = remove block
-        else if (before != SHAPE_COLOR_INDEX_AIR_BLOCK && after == SHAPE_COLOR_INDEX_AIR_BLOCK) {
-            shape_remove_block(sh, x, y, z);
-            if (index3d_iterator_pointer(it) == NULL) {
-                // if block removal is the only transaction, use cheaper function
-                shape_shrink_box(sh, (SHAPE_COORDS_INT3_T){x, y, z});
-            } else {
-                resetBoxNeeded = true;
+    }
+    return current;
+}
+
+/// Reads source blocks from `min` over `size` into a dense array (x first), with colors remapped
+/// to given palette. Colors that can't be added to a full palette are read as air.
+static void _shape_region_gather(const Shape *src,
+                                 const SHAPE_COORDS_INT3_T min,
+                                 const SHAPE_COORDS_INT3_T size,
+                                 ColorPalette *palette,
+                                 SHAPE_COLOR_INDEX_INT_T *out) {
+    memset(out, SHAPE_COLOR_INDEX_AIR_BLOCK, (size_t)size.x * (size_t)size.y * (size_t)size.z);
+
+    // source palette entries are mapped when first encountered
+    SHAPE_COLOR_INDEX_INT_T remap[SHAPE_COLOR_INDEX_MAX_COUNT + 1];
+    bool mapped[SHAPE_COLOR_INDEX_MAX_COUNT + 1] = {false};
+    remap[SHAPE_COLOR_INDEX_AIR_BLOCK] = SHAPE_COLOR_INDEX_AIR_BLOCK;
+    mapped[SHAPE_COLOR_INDEX_AIR_BLOCK] = true;
+    const bool samePalette = src->palette == palette;
+
+    const SHAPE_COORDS_INT3_T chunkMin = chunk_utils_get_coords(min);
+    const SHAPE_COORDS_INT3_T chunkMax = chunk_utils_get_coords(
+        (SHAPE_COORDS_INT3_T){(SHAPE_COORDS_INT_T)(min.x + size.x - 1),
+                              (SHAPE_COORDS_INT_T)(min.y + size.y - 1),
+                              (SHAPE_COORDS_INT_T)(min.z + size.z - 1)});
+
+    for (int cz = chunkMin.z; cz <= chunkMax.z; ++cz) {
+        for (int cy = chunkMin.y; cy <= chunkMax.y; ++cy) {
+            for (int cx = chunkMin.x; cx <= chunkMax.x; ++cx) {
+                const Chunk *chunk = (const Chunk *)index3d_get(src->chunks, cx, cy, cz);
+                if (chunk == NULL || chunk_get_nb_blocks(chunk) == 0) {
+                    continue;
+                }
+                const Block *blocks = (const Block *)octree_get_elements(chunk_get_octree(chunk));
+                const int ox = cx * CHUNK_SIZE, oy = cy * CHUNK_SIZE, oz = cz * CHUNK_SIZE;
+
+                const int fromX = maximum(min.x - ox, 0), toX = minimum(min.x + size.x - ox,
+                                                                        CHUNK_SIZE);
+                const int fromY = maximum(min.y - oy, 0), toY = minimum(min.y + size.y - oy,
+                                                                        CHUNK_SIZE);
+                const int fromZ = maximum(min.z - oz, 0), toZ = minimum(min.z + size.z - oz,
+                                                                        CHUNK_SIZE);
+
+                for (int z = fromZ; z < toZ; ++z) {
+                    for (int y = fromY; y < toY; ++y) {
+                        const Block *b = blocks + fromX + y * CHUNK_SIZE + z * CHUNK_SIZE_SQR;
+                        SHAPE_COLOR_INDEX_INT_T *o = out +
+                                                     (size_t)(ox + fromX - min.x) +
+                                                     (size_t)(oy + y - min.y) * (size_t)size.x +
+                                                     (size_t)(oz + z - min.z) * (size_t)size.x *
+                                                         (size_t)size.y;
+                        for (int x = fromX; x < toX; ++x, ++b, ++o) {
+                            const SHAPE_COLOR_INDEX_INT_T c = b->colorIndex;
+                            if (samePalette) {
+                                *o = c;
+                                continue;
+                            }
+                            if (mapped[c] == false) {
+                                color_palette_check_and_add_color(
+                                    palette,
+                                    color_palette_get_color(src->palette, c),
+                                    &remap[c],
+                                    false);
+                                if (remap[c] != SHAPE_COLOR_INDEX_AIR_BLOCK &&
+                                    color_palette_get_color_use_count(palette, remap[c]) == 0) {
+                                    color_palette_set_emissive(
+                                        palette,
+                                        remap[c],
+                                        color_palette_is_emissive(src->palette, c));
+                                }
+                                mapped[c] = true;
+                            }
+                            *o = remap[c];
+                        }
+                    }
+                }
             }
         }
-        // [block>block] = paint block
-        else if (before != SHAPE_COLOR_INDEX_AIR_BLOCK && after != SHAPE_COLOR_INDEX_AIR_BLOCK) {
-            shape_paint_block(sh, after, x, y, z);
+    }
+}
+
+/// Queues light removal & propagation for a block changed by a region operation, the same way
+/// as shape_compute_baked_lighting_added/removed/replaced_block. Both passes then run once
+/// for the whole region.
+static void _shape_region_queue_lighting(Shape *s,
+                                         LightNodeQueue *lightQueue,
+                                         LightRemovalNodeQueue *lightRemovalQueue,
+                                         Chunk *c,
+                                         const SHAPE_COORDS_INT3_T coords,
+                                         const CHUNK_COORDS_INT3_T coordsInChunk,
+                                         const SHAPE_COLOR_INDEX_INT_T before,
+                                         const SHAPE_COLOR_INDEX_INT_T after) {
+    const VERTEX_LIGHT_STRUCT_T existingLight = chunk_get_light_without_checking(c, coordsInChunk);
+    VERTEX_LIGHT_STRUCT_T zero;
+    ZERO_LIGHT(zero)
+
+    // [air>block] may shut sunlight or emission propagation, and/or add an emission source
+    if (before == SHAPE_COLOR_INDEX_AIR_BLOCK) {
+        const VERTEX_LIGHT_STRUCT_T newLight = color_palette_get_emissive_color_as_light(s->palette,
+                                                                                         after);
+        if (newLight.red > 0 || newLight.green > 0 || newLight.blue > 0) {
+            light_node_queue_push(lightQueue, c, coords);
+            chunk_set_light(c, coordsInChunk, newLight, false);
         }
 
-        index3d_iterator_next(it);
+        light_removal_node_queue_push(lightRemovalQueue, c, coords, existingLight, 15, 255);
+
+        // emissive blocks in the vicinity may be affected by the added block
+        Chunk *insertChunk;
+        for (CHUNK_COORDS_INT_T xo = -1; xo <= 1; ++xo) {
+            for (CHUNK_COORDS_INT_T yo = -1; yo <= 1; ++yo) {
+                for (CHUNK_COORDS_INT_T zo = -1; zo <= 1; ++zo) {
+                    if (xo == 0 && yo == 0 && zo == 0) {
+                        continue;
+                    }
+                    const Block *block = chunk_get_block_including_neighbors(
+                        c,
+                        (CHUNK_COORDS_INT_T)(coordsInChunk.x + xo),
+                        (CHUNK_COORDS_INT_T)(coordsInChunk.y + yo),
+                        (CHUNK_COORDS_INT_T)(coordsInChunk.z + zo),
+                        &insertChunk,
+                        NULL);
+                    if (block != NULL && color_palette_is_emissive(s->palette, block->colorIndex)) {
+                        light_removal_node_queue_push(
+                            lightRemovalQueue,
+                            insertChunk,
+                            (SHAPE_COORDS_INT3_T){(SHAPE_COORDS_INT_T)(coords.x + xo),
+                                                  (SHAPE_COORDS_INT_T)(coords.y + yo),
+                                                  (SHAPE_COORDS_INT_T)(coords.z + zo)},
+                            color_palette_get_emissive_color_as_light(s->palette,
+                                                                      block->colorIndex),
+                            15,
+                            block->colorIndex);
+                    }
+                }
+            }
+        }
     }
+    // [block>air] may open up sunlight or emission propagation, and/or remove an emission source
+    else if (after == SHAPE_COLOR_INDEX_AIR_BLOCK) {
+        if (existingLight.red > 0 || existingLight.green > 0 || existingLight.blue > 0) {
+            light_removal_node_queue_push(lightRemovalQueue,
+                                          c,
+                                          coords,
+                                          existingLight,
+                                          15,
+                                          before);
+        }
 
-    if (resetBoxNeeded == true) {
-        shape_reset_box(sh);
+        const SHAPE_COORDS_INT3_T neighbors[6] = {
+            {(SHAPE_COORDS_INT_T)(coords.x + 1), coords.y, coords.z},
+            {(SHAPE_COORDS_INT_T)(coords.x - 1), coords.y, coords.z},
+            {coords.x, (SHAPE_COORDS_INT_T)(coords.y + 1), coords.z},
+            {coords.x, (SHAPE_COORDS_INT_T)(coords.y - 1), coords.z},
+            {coords.x, coords.y, (SHAPE_COORDS_INT_T)(coords.z + 1)},
+            {coords.x, coords.y, (SHAPE_COORDS_INT_T)(coords.z - 1)}};
+        Chunk *insertChunk;
+        for (int i = 0; i < 6; ++i) {
+            shape_get_chunk_and_coordinates(s, neighbors[i], &insertChunk, NULL, NULL);
+            light_node_queue_push(lightQueue, insertChunk, neighbors[i]);
+        }
+
+        chunk_set_light(c, coordsInChunk, zero, false);
     }
+    // [block>block] may remove or replace an emission source
+    else {
+        const VERTEX_LIGHT_STRUCT_T newLight = color_palette_get_emissive_color_as_light(s->palette,
+                                                                                         after);
+        if (existingLight.red == newLight.red && existingLight.green == newLight.green &&
+            existingLight.blue == newLight.blue) {
+            return;
+        }
 
-    return true;
+        if (existingLight.red > 0 || existingLight.green > 0 || existingLight.blue > 0) {
+            light_removal_node_queue_push(lightRemovalQueue,
+                                          c,
+                                          coords,
+                                          existingLight,
+                                          15,
+                                          after);
+        }
+
+        if (newLight.red > 0 || newLight.green > 0 || newLight.blue > 0) {
+            light_node_queue_push(lightQueue, c, coords);
+            chunk_set_light(c, coordsInChunk, newLight, false);
+        } else {
+            chunk_set_light(c, coordsInChunk, zero, false);
+        }
+    }
 }
 
 void _shape_clear_cached_world_aabb(Shape *s) {
@@ -4275,6 +5482,7 @@ bool _shape_compute_size_and_origin(const Shape *shape,
 
     Index3DIterator *it = index3d_iterator_new(shape->chunks);
     if (index3d_iterator_pointer(it) == NULL) {
+        index3d_iterator_free(it);
         *size_x = 0;
         *size_y = 0;
         *size_z = 0;
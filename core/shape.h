@@ -141,6 +141,19 @@ bool shape_add_block(Shape *shape,
                      const SHAPE_COORDS_INT_T z,
                      bool useDefaultColor);
 
+/// Adds a chunk filled beforehand (see chunk_set_blocks), the shape takes ownership of it.
+/// Meant for bulk imports: palette usage & bounding box are updated once for the whole chunk,
+/// baked lighting isn't computed. Chunk origin must be aligned on CHUNK_SIZE.
+/// Returns false if the shape already has a chunk at that position.
+bool shape_add_chunk(Shape *shape, Chunk *chunk);
+
+/// Removes & frees the chunk at given chunk coordinates (e.g. to page it out), counterpart of
+/// shape_add_chunk: palette usage is updated once for the whole chunk, bounding box is recomputed
+/// from remaining chunks if the removed one was on its side.
+/// Neighbors are enqueued for refresh as their faces on that side become visible.
+/// Returns false if the shape has no chunk at that position.
+bool shape_remove_chunk(Shape *shape, const SHAPE_COORDS_INT3_T chunk_coords);
+
 bool shape_remove_block(Shape *shape,
                         const SHAPE_COORDS_INT_T x,
                         const SHAPE_COORDS_INT_T y,
@@ -152,6 +165,36 @@ bool shape_paint_block(Shape *shape,
                        const SHAPE_COORDS_INT_T y,
                        const SHAPE_COORDS_INT_T z);
 
+/// Region operations apply right away on a box of blocks, from `min` (included) to `max`
+/// (excluded) in model coordinates. Blocks are written chunk by chunk, palette usage, bounding
+/// box & baked lighting are updated once for the whole region, and if history is enabled, all
+/// changes are stored as a single action. `scene` is optional, used to awake physics around
+/// the region. Returns the number of changed blocks.
+
+/// Fills box with given color, or removes its blocks with SHAPE_COLOR_INDEX_AIR_BLOCK
+size_t shape_fill_box(Shape *shape,
+                      Scene *scene,
+                      const SHAPE_COLOR_INDEX_INT_T colorIndex,
+                      const SHAPE_COORDS_INT3_T min,
+                      const SHAPE_COORDS_INT3_T max);
+
+/// Replaces blocks of color `from` within box, removes them if `to` is SHAPE_COLOR_INDEX_AIR_BLOCK
+size_t shape_replace_color_in_box(Shape *shape,
+                                  Scene *scene,
+                                  const SHAPE_COLOR_INDEX_INT_T from,
+                                  const SHAPE_COLOR_INDEX_INT_T to,
+                                  const SHAPE_COORDS_INT3_T min,
+                                  const SHAPE_COORDS_INT3_T max);
+
+/// Copies `src` blocks within box into `dst`, `min` being copied at `dstOrigin`. Air blocks are
+/// not copied, `src` colors are added to `dst` palette if needed. `src` may be `dst`.
+size_t shape_copy_box_from(Shape *dst,
+                           Scene *scene,
+                           const Shape *src,
+                           const SHAPE_COORDS_INT3_T min,
+                           const SHAPE_COORDS_INT3_T max,
+                           const SHAPE_COORDS_INT3_T dstOrigin);
+
 void shape_get_bounding_box_size(const Shape *shape, int3 *size);
 // TODO: users of this function should probably use bounding box size and discard empty space at
 // origin
@@ -263,6 +306,32 @@ void shape_refresh_vertices(Shape *shape);
 void shape_refresh_all_vertices(Shape *s);
 VertexBuffer *shape_get_first_vertex_buffer(const Shape *shape, bool transparent);
 
+// MARK: - Level of detail -
+
+/// When enabled, chunks are also meshed at coarser LOD levels (see CHUNK_LOD_COUNT), in separate
+/// vertex buffers per level. Renderers draw each chunk with the vertices of its selected level,
+/// following the chunk's mem areas (chunk_get_lod_vbma). Disabled by default, disabling releases
+/// LOD vertex buffers.
+void shape_set_lods_enabled(Shape *s, const bool enabled);
+bool shape_get_lods_enabled(const Shape *s);
+
+/// Position chunk LOD levels are selected from, in model space
+void shape_set_lod_camera_position(Shape *s, const float3 *modelPosition);
+const float3 *shape_get_lod_camera_position(const Shape *s);
+
+/// Distance in blocks covered by each LOD level: chunks within `distance` of the camera position
+/// use level 0, the following `distance` level 1, etc.
+void shape_set_lod_distance(Shape *s, const float distance);
+float shape_get_lod_distance(const Shape *s);
+
+/// LOD level to draw given chunk with, always 0 if LODs aren't enabled
+uint8_t shape_get_chunk_lod(const Shape *s, const Chunk *c);
+
+VertexBuffer *shape_get_first_lod_vertex_buffer(const Shape *s,
+                                                const uint8_t lod,
+                                                const bool transparent);
+VertexBuffer *shape_add_lod_buffer(Shape *s, const uint8_t lod, const bool transparent);
+
 // MARK: - Physics -
 
 Rtree *shape_get_rtree(const Shape *shape);
@@ -398,6 +467,9 @@ bool shape_history_canUndo(const Shape *const s);
 bool shape_history_canRedo(const Shape *const s);
 void shape_history_undo(Shape *const s);
 void shape_history_redo(Shape *const s);
+/// Oldest actions are discarded beyond that limit, see history_set_memory_limit
+void shape_history_setMemoryLimit(Shape *const s, const size_t bytes);
+size_t shape_history_getMemoryUsage(const Shape *const s);
 
 // MARK: - Lua flags -
 // These flags are only used to check from VX whether or not some Lua features should be enabled
@@ -0,0 +1,135 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_cclog.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <stdarg.h>
+#include <stdlib.h>
+
+#include "cclog.h"
+#include "thread.h"
+
+#define TEST_CCLOG_THREADS 4
+#define TEST_CCLOG_RECORDS 100
+
+typedef struct {
+    // last index received for each producer thread
+    int last[TEST_CCLOG_THREADS];
+    uint32_t count;
+    uint32_t outOfOrder;
+} TestCClogSink;
+
+static TestCClogSink _testCClogSink;
+
+static int _test_cclog_sink(const int severity,
+                            const char *filename,
+                            const int line,
+                            const char *format,
+                            va_list args) {
+    char buffer[64];
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wformat-nonliteral"
+    vsnprintf(buffer, sizeof(buffer), format, args);
+#pragma clang diagnostic pop
+    int thread = 0, index = 0;
+    if (sscanf(buffer, "%d %d", &thread, &index) == 2 && thread >= 0 &&
+        thread < TEST_CCLOG_THREADS) {
+        if (index != _testCClogSink.last[thread] + 1) {
+            _testCClogSink.outOfOrder += 1;
+        }
+        _testCClogSink.last[thread] = index;
+    }
+    _testCClogSink.count += 1;
+    return 0;
+}
+
+static void _test_cclog_sink_reset(void) {
+    for (int i = 0; i < TEST_CCLOG_THREADS; ++i) {
+        _testCClogSink.last[i] = -1;
+    }
+    _testCClogSink.count = 0;
+    _testCClogSink.outOfOrder = 0;
+}
+
+static void _test_cclog_producer(void *userdata) {
+    const int thread = *(int *)userdata;
+    for (int i = 0; i < TEST_CCLOG_RECORDS; ++i) {
+        cclog_info("%d %d", thread, i);
+    }
+}
+
+// records from several threads all reach the sink, each thread's records in order
+void test_cclog_async(void) {
+    log_func_ptr previous = cclog_function_ptr;
+    cclog_function_ptr = _test_cclog_sink;
+    _test_cclog_sink_reset();
+
+    if (cclog_async_start() == false) {
+        cclog_function_ptr = previous;
+        return; // no threads support
+    }
+
+    int ids[TEST_CCLOG_THREADS];
+    Thread *threads[TEST_CCLOG_THREADS];
+    for (int i = 0; i < TEST_CCLOG_THREADS; ++i) {
+        ids[i] = i;
+        threads[i] = thread_new(_test_cclog_producer, &ids[i]);
+        if (threads[i] == NULL) {
+            _test_cclog_producer(&ids[i]);
+        }
+    }
+    for (int i = 0; i < TEST_CCLOG_THREADS; ++i) {
+        thread_join_and_free(threads[i]);
+    }
+
+    cclog_flush();
+    TEST_CHECK(_testCClogSink.count == TEST_CCLOG_THREADS * TEST_CCLOG_RECORDS);
+    TEST_CHECK(_testCClogSink.outOfOrder == 0);
+    for (int i = 0; i < TEST_CCLOG_THREADS; ++i) {
+        TEST_CHECK(_testCClogSink.last[i] == TEST_CCLOG_RECORDS - 1);
+    }
+
+    // pending records are written when stopping
+    cclog_warning("%d %d", 0, TEST_CCLOG_RECORDS);
+    cclog_async_stop();
+    TEST_CHECK(_testCClogSink.last[0] == TEST_CCLOG_RECORDS);
+
+    // back to synchronous logging
+    cclog_warning("%d %d", 0, TEST_CCLOG_RECORDS + 1);
+    TEST_CHECK(_testCClogSink.last[0] == TEST_CCLOG_RECORDS + 1);
+
+    cclog_function_ptr = previous;
+}
+
+void test_cclog_rate_limit(void) {
+    log_func_ptr previous = cclog_function_ptr;
+    cclog_function_ptr = _test_cclog_sink;
+    _test_cclog_sink_reset();
+
+    cclog_set_rate_limit(LOG_SEVERITY_DEBUG, 5);
+    for (int i = 0; i < 50; ++i) {
+        cclog_debug("%d %d", 0, i);
+    }
+    // at most 2 windows if crossing a second boundary, + 1 suppressed records report
+    TEST_CHECK(_testCClogSink.count >= 5);
+    TEST_CHECK(_testCClogSink.count <= 11);
+
+    // other severities aren't limited
+    _test_cclog_sink_reset();
+    for (int i = 0; i < 50; ++i) {
+        cclog_info("%d %d", 0, i);
+    }
+    TEST_CHECK(_testCClogSink.count == 50);
+
+    cclog_set_rate_limit(LOG_SEVERITY_DEBUG, 0);
+    _test_cclog_sink_reset();
+    for (int i = 0; i < 50; ++i) {
+        cclog_debug("%d %d", 0, i);
+    }
+    TEST_CHECK(_testCClogSink.count == 50);
+
+    cclog_function_ptr = previous;
+}
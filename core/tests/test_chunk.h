@@ -8,6 +8,7 @@
 
 #include "block.h"
 #include "chunk.h"
+#include "color_palette.h"
 #include "int3.h"
 
 ///// Some function are left untested :
@@ -144,3 +145,99 @@ void test_chunk_needs_display(void) {
 
     chunk_free(chunk, false);
 }
+
+// Fill a chunk in one go and check it matches the same chunk filled block by block
+// --- chunk_set_blocks()
+/////
+void test_chunk_set_blocks(void) {
+    Block *blocks = (Block *)malloc(sizeof(Block) * CHUNK_SIZE_CUBE);
+    Chunk *reference = chunk_new((SHAPE_COORDS_INT3_T){0, 0, 0});
+    Chunk *chunk = chunk_new((SHAPE_COORDS_INT3_T){0, 0, 0});
+
+    int nbBlocks = 0;
+    for (CHUNK_COORDS_INT_T z = 0; z < CHUNK_SIZE; z++) {
+        for (CHUNK_COORDS_INT_T y = 0; y < CHUNK_SIZE; y++) {
+            for (CHUNK_COORDS_INT_T x = 0; x < CHUNK_SIZE; x++) {
+                Block *b = &blocks[x + y * CHUNK_SIZE + z * CHUNK_SIZE_SQR];
+                b->colorIndex = SHAPE_COLOR_INDEX_AIR_BLOCK;
+                if (x >= 2 && y >= 1 && z >= 3 && x < 13 && (x * 7 + y * 3 + z) % 5 == 0) {
+                    b->colorIndex = (SHAPE_COLOR_INDEX_INT_T)((x + y + z) % 10);
+                    chunk_add_block(reference, *b, x, y, z);
+                    nbBlocks++;
+                }
+            }
+        }
+    }
+
+    TEST_CHECK(chunk_set_blocks(chunk, blocks) == nbBlocks);
+    TEST_CHECK(chunk_get_nb_blocks(chunk) == chunk_get_nb_blocks(reference));
+
+    CHUNK_COORDS_INT3_T min, max, refMin, refMax;
+    chunk_get_bounding_box_2(chunk, &min, &max);
+    chunk_get_bounding_box_2(reference, &refMin, &refMax);
+    TEST_CHECK(min.x == refMin.x && min.y == refMin.y && min.z == refMin.z);
+    TEST_CHECK(max.x == refMax.x && max.y == refMax.y && max.z == refMax.z);
+
+    // octree nodes & elements should be identical
+    const Octree *o = chunk_get_octree(chunk);
+    const Octree *refO = chunk_get_octree(reference);
+    TEST_CHECK(memcmp(octree_get_nodes(o), octree_get_nodes(refO), octree_get_nodes_size(o)) == 0);
+    TEST_CHECK(memcmp(octree_get_elements(o),
+                      octree_get_elements(refO),
+                      octree_get_elements_size(o)) == 0);
+
+    chunk_free(chunk, false);
+    chunk_free(reference, false);
+    free(blocks);
+}
+
+// Check solid & opaque occupancy masks follow block edits & palette transparency changes
+// --- chunk_is_block_solid()
+// --- chunk_has_solid_blocks_in_box()
+// --- chunk_get_opaque_mask()
+/////
+void test_chunk_occupancy_masks(void) {
+    Chunk *chunk = chunk_new((SHAPE_COORDS_INT3_T){0, 0, 0});
+    ColorPalette *palette = color_palette_new(NULL);
+    SHAPE_COLOR_INDEX_INT_T opaque, transparent;
+    color_palette_check_and_add_color(palette, (RGBAColor){255, 0, 0, 255}, &opaque, false);
+    color_palette_check_and_add_color(palette, (RGBAColor){0, 0, 255, 100}, &transparent, false);
+
+    chunk_add_block(chunk, (Block){opaque}, 3, 5, 7);
+    chunk_add_block(chunk, (Block){transparent}, 15, 15, 15);
+
+    TEST_CHECK(chunk_is_block_solid(chunk, 3, 5, 7));
+    TEST_CHECK(chunk_is_block_solid(chunk, 15, 15, 15));
+    TEST_CHECK(chunk_is_block_solid(chunk, 4, 5, 7) == false);
+
+    CHUNK_COORDS_INT3_T min = {0, 0, 0}, max = {2, 15, 15};
+    TEST_CHECK(chunk_has_solid_blocks_in_box(chunk, min, max) == false);
+    max.x = 3;
+    TEST_CHECK(chunk_has_solid_blocks_in_box(chunk, min, max));
+    min = (CHUNK_COORDS_INT3_T){4, 0, 0};
+    max = (CHUNK_COORDS_INT3_T){14, 15, 15};
+    TEST_CHECK(chunk_has_solid_blocks_in_box(chunk, min, max) == false);
+
+    const uint64_t *mask = chunk_get_opaque_mask(chunk, palette);
+    const size_t i = 3 + 5 * CHUNK_SIZE + 7 * CHUNK_SIZE_SQR;
+    const size_t j = CHUNK_SIZE_CUBE - 1;
+    TEST_CHECK((mask[i / 64] >> (i % 64)) & 1);
+    TEST_CHECK(((mask[j / 64] >> (j % 64)) & 1) == 0);
+
+    // painting & palette transparency changes are reflected in opaque mask
+    chunk_paint_block(chunk, 3, 5, 7, transparent, NULL);
+    mask = chunk_get_opaque_mask(chunk, palette);
+    TEST_CHECK(((mask[i / 64] >> (i % 64)) & 1) == 0);
+    color_palette_set_color(palette, transparent, (RGBAColor){0, 0, 255, 255});
+    mask = chunk_get_opaque_mask(chunk, palette);
+    TEST_CHECK((mask[i / 64] >> (i % 64)) & 1);
+    TEST_CHECK((mask[j / 64] >> (j % 64)) & 1);
+
+    chunk_remove_block(chunk, 3, 5, 7, NULL);
+    TEST_CHECK(chunk_is_block_solid(chunk, 3, 5, 7) == false);
+    mask = chunk_get_opaque_mask(chunk, palette);
+    TEST_CHECK(((mask[i / 64] >> (i % 64)) & 1) == 0);
+
+    color_palette_release(palette);
+    chunk_free(chunk, false);
+}
@@ -0,0 +1,34 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_color_atlas.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include "color_atlas.h"
+
+// removed indices are reused lowest first, before expanding the atlas
+void test_color_atlas_reuse_indices(void) {
+    ColorAtlas *a = color_atlas_new();
+    const RGBAColor color = {1, 2, 3, 255};
+
+    for (ATLAS_COLOR_INDEX_INT_T i = 0; i < 200; ++i) {
+        TEST_CHECK(color_atlas_check_and_add_color(a, color) == i);
+    }
+
+    color_atlas_remove_color(a, 150);
+    color_atlas_remove_color(a, 3);
+    color_atlas_remove_color(a, 70);
+    color_atlas_remove_color(a, 70); // removing twice has no effect
+    color_atlas_remove_color(a, 500); // never added
+    color_atlas_remove_color(a, ATLAS_COLOR_INDEX_ERROR);
+
+    TEST_CHECK(color_atlas_check_and_add_color(a, color) == 3);
+    TEST_CHECK(color_atlas_check_and_add_color(a, color) == 70);
+    TEST_CHECK(color_atlas_check_and_add_color(a, color) == 150);
+    TEST_CHECK(color_atlas_check_and_add_color(a, color) == 200);
+    TEST_CHECK(a->count == 201);
+
+    color_atlas_free(a);
+}
@@ -0,0 +1,111 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_culling.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <math.h>
+
+#include "color_palette.h"
+#include "culling.h"
+#include "transform.h"
+
+// left-handed perspective, depth in [0, 1], looking at +z from given eye position
+static void _test_culling_view_projection(Matrix4x4 *viewProj, const float3 *eye) {
+    const float f = 1.0f / tanf(PI_F / 6.0f); // 60° vertical fov
+    const float aspect = 2.0f, near = 0.1f, far = 1000.0f;
+    const float a = far / (far - near), b = -near * far / (far - near);
+    // column-major
+    *viewProj = (Matrix4x4){f / aspect, 0.0f, 0.0f, 0.0f, 0.0f, f, 0.0f, 0.0f,
+                            0.0f,       0.0f, a,    1.0f, 0.0f, 0.0f, b, 0.0f};
+    const float3 center = {eye->x, eye->y, eye->z + 1.0f};
+    const float3 up = {0.0f, 1.0f, 0.0f};
+    Matrix4x4 view;
+    matrix4x4_set_look_at(&view, eye, &center, &up);
+    matrix4x4_op_multiply(viewProj, &view);
+}
+
+static uint32_t _test_culling_draw_ranges_count(Culling *c, Shape *s) {
+    CullingDrawRange ranges[64];
+    const uint32_t n = culling_get_draw_ranges(c, s, false, ranges, 64);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        count += ranges[i].count;
+        if (i > 0 && ranges[i].vb == ranges[i - 1].vb) {
+            TEST_CHECK(ranges[i - 1].start + ranges[i - 1].count < ranges[i].start);
+        }
+    }
+    return count;
+}
+
+// chunks out of the frustum or behind a wall are culled, draw ranges only cover visible chunks
+void test_culling_frustum_occlusion(void) {
+    Shape *s = shape_make_2(true);
+    shape_set_palette(s, color_palette_new(NULL), false);
+    SHAPE_COLOR_INDEX_INT_T color;
+    color_palette_check_and_add_color(shape_get_palette(s),
+                                      (RGBAColor){255, 0, 0, 255},
+                                      &color,
+                                      false);
+
+    // 64x32x16 wall, in 8 chunks
+    shape_fill_box(s,
+                   NULL,
+                   color,
+                   (SHAPE_COORDS_INT3_T){-32, 0, 0},
+                   (SHAPE_COORDS_INT3_T){32, 32, 16});
+    // 4x4x4 cube behind the wall, a block behind the camera & a block on the side out of view
+    shape_fill_box(s,
+                   NULL,
+                   color,
+                   (SHAPE_COORDS_INT3_T){6, 4, 48},
+                   (SHAPE_COORDS_INT3_T){10, 8, 52});
+    shape_add_block(s, color, 0, 0, -64, false);
+    shape_add_block(s, color, 300, 0, 0, false);
+    shape_refresh_all_vertices(s);
+
+    Matrix4x4 viewProj;
+    const float3 eye = {0.0f, 16.0f, -40.0f};
+    _test_culling_view_projection(&viewProj, &eye);
+
+    Culling *c = culling_new(0, 0);
+    TEST_ASSERT(c != NULL);
+    Chunk *chunks[16];
+
+    // frustum only
+    culling_begin(c, &viewProj);
+    TEST_CHECK(culling_get_visible_chunks(c, s, chunks, 16) == 9);
+    const uint32_t frustumCount = _test_culling_draw_ranges_count(c, s);
+
+    // wall hides the cube
+    culling_add_occluders(c, s);
+    TEST_CHECK(culling_get_visible_chunks(c, s, chunks, 16) == 8);
+    TEST_CHECK(chunk_get_origin(chunks[0]).z == 0);
+    TEST_CHECK(index3d_get(shape_get_chunks(s), 0, 0, 3) != NULL);
+    for (int i = 0; i < 8; ++i) {
+        TEST_CHECK(chunks[i] != index3d_get(shape_get_chunks(s), 0, 0, 3));
+    }
+    TEST_CHECK(frustumCount - _test_culling_draw_ranges_count(c, s) ==
+               6 * 16 * DRAWBUFFER_VERTICES_PER_FACE);
+
+    // world boxes, shape transform is identity
+    Box box = {{6.0f, 4.0f, 48.0f}, {10.0f, 8.0f, 52.0f}};
+    TEST_CHECK(culling_is_box_visible(c, &box) == false);
+    box = (Box){{0.0f, 81.0f, 100.0f}, {4.0f, 85.0f, 104.0f}}; // above the wall
+    TEST_CHECK(culling_is_box_visible(c, &box));
+    box = (Box){{80.0f, 4.0f, 48.0f}, {84.0f, 8.0f, 52.0f}}; // on the side of the wall
+    TEST_CHECK(culling_is_box_visible(c, &box));
+    box = (Box){{0.0f, 0.0f, -64.0f}, {1.0f, 1.0f, -63.0f}}; // behind the camera
+    TEST_CHECK(culling_is_box_visible(c, &box) == false);
+
+    // shape moved away from the camera
+    transform_set_position(shape_get_root_transform(s), 1000.0f, 0.0f, 0.0f);
+    culling_begin(c, &viewProj);
+    TEST_CHECK(culling_get_visible_chunks(c, s, chunks, 16) == 0);
+    TEST_CHECK(_test_culling_draw_ranges_count(c, s) == 0);
+
+    culling_free(c);
+    shape_release(s);
+}
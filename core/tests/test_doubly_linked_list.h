@@ -579,3 +579,46 @@ void test_doubly_linked_list_sort_ascending(void) {
 
     doubly_linked_list_free(list);
 }
+
+// Nodes are recycled within the list: popped & deleted nodes memory is used again for next
+// pushes, the list staying consistent when mixing both.
+void test_doubly_linked_list_recycle(void) {
+    DoublyLinkedList *list = doubly_linked_list_new();
+    int values[64];
+
+    for (int i = 0; i < 64; ++i) {
+        doubly_linked_list_push_last(list, &values[i]);
+    }
+    DoublyLinkedListNode *last = doubly_linked_list_last(list);
+    TEST_CHECK(doubly_linked_list_pop_last(list) == &values[63]);
+    DoublyLinkedListNode *n = doubly_linked_list_push_first(list, &values[63]);
+    TEST_CHECK(n == last);
+
+    // delete every other node, then insert them back
+    n = doubly_linked_list_node_next(doubly_linked_list_first(list));
+    while (n != NULL) {
+        n = doubly_linked_list_delete_node(list, n);
+        n = doubly_linked_list_node_next(n);
+    }
+    TEST_CHECK(doubly_linked_list_node_count(list) == 32);
+    n = doubly_linked_list_first(list);
+    while (n != NULL) {
+        doubly_linked_list_insert_node_next(list, n, doubly_linked_list_node_pointer(n));
+        n = doubly_linked_list_node_next(doubly_linked_list_node_next(n));
+    }
+    TEST_CHECK(doubly_linked_list_node_count(list) == 64);
+
+    n = doubly_linked_list_last(list);
+    size_t count = 0;
+    while (n != NULL) {
+        count++;
+        n = doubly_linked_list_node_previous(n);
+    }
+    TEST_CHECK(count == 64);
+
+    doubly_linked_list_flush(list, NULL);
+    TEST_CHECK(doubly_linked_list_is_empty(list));
+    doubly_linked_list_push_last(list, &values[0]);
+    TEST_CHECK(doubly_linked_list_pop_first(list) == &values[0]);
+    doubly_linked_list_free(list);
+}
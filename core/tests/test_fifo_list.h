@@ -147,3 +147,35 @@ void test_fifo_list_new_copy(void) {
     fifo_list_free(listCopy, NULL);
     fifo_list_free(list, NULL);
 }
+
+// Push & pop past the inline capacity, wrapping around then growing the ring buffer.
+// Order has to be kept through both.
+void test_fifo_list_wraparound(void) {
+    FifoList *list = fifo_list_new();
+    int values[100];
+    bool ok = true;
+
+    for (int i = 0; i < 6; ++i) {
+        fifo_list_push(list, &values[i]);
+    }
+    for (int i = 0; i < 4; ++i) {
+        ok = ok && fifo_list_pop(list) == &values[i];
+    }
+    // wraps around, then grows with first element in the middle of the buffer
+    for (int i = 6; i < 100; ++i) {
+        fifo_list_push(list, &values[i]);
+    }
+    TEST_CHECK(fifo_list_get_size(list) == 96);
+
+    FifoList *copy = fifo_list_new_copy(list);
+    for (int i = 4; i < 100; ++i) {
+        ok = ok && fifo_list_pop(list) == &values[i];
+        ok = ok && fifo_list_pop(copy) == &values[i];
+    }
+    TEST_CHECK(ok);
+    TEST_CHECK(fifo_list_pop(list) == NULL);
+    TEST_CHECK(fifo_list_get_size(copy) == 0);
+
+    fifo_list_free(copy, NULL);
+    fifo_list_free(list, NULL);
+}
@@ -50,3 +50,35 @@ void test_hash_uint32_int(void) {
 
     hash_uint32_int_free(h);
 }
+
+// colors only differing by their alpha, enough keys to grow the table, then delete half of them
+void test_hash_uint32_int_many(void) {
+    HashUInt32Int *h = hash_uint32_int_new();
+    int v = 0;
+    RGBAColor color = {10, 20, 30, 0};
+
+    for (int i = 0; i < 256; ++i) {
+        color.a = (uint8_t)i;
+        hash_uint32_int_set(h, color_to_uint32(&color), i);
+    }
+    for (int i = 0; i < 256; ++i) {
+        color.a = (uint8_t)i;
+        TEST_CHECK(hash_uint32_int_get(h, color_to_uint32(&color), &v));
+        TEST_CHECK(v == i);
+    }
+
+    for (int i = 0; i < 256; i += 2) {
+        color.a = (uint8_t)i;
+        hash_uint32_int_delete(h, color_to_uint32(&color));
+    }
+    for (int i = 0; i < 256; ++i) {
+        color.a = (uint8_t)i;
+        const bool found = hash_uint32_int_get(h, color_to_uint32(&color), &v);
+        TEST_CHECK(found == (i % 2 == 1));
+        if (found) {
+            TEST_CHECK(v == i);
+        }
+    }
+
+    hash_uint32_int_free(h);
+}
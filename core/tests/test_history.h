@@ -0,0 +1,76 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_history.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include "history.h"
+#include "transaction.h"
+
+// a row of changes is stored as spans, split at chunk boundaries & color changes
+void test_history_record_spans(void) {
+    History *h = history_new();
+    Transaction *tr = transaction_new();
+    for (SHAPE_COORDS_INT_T x = -4; x < CHUNK_SIZE + 4; ++x) {
+        transaction_addBlock(tr, x, 3, 2, x < 8 ? 1 : 2);
+    }
+    history_pushTransaction(h, tr);
+
+    const HistoryRecord *r = history_get_record_to_undo(h);
+    TEST_ASSERT(r != NULL);
+    TEST_ASSERT(history_record_get_nb_chunks(r) == 3);
+
+    const HistoryChunk *chunks = history_record_get_chunks(r);
+    TEST_CHECK(chunks[0].coords.x == -1 && chunks[0].coords.y == 0 && chunks[0].coords.z == 0);
+    TEST_CHECK(chunks[0].nbSpans == 1);
+    TEST_CHECK(chunks[1].coords.x == 0 && chunks[1].nbSpans == 2);
+    TEST_CHECK(chunks[2].coords.x == 1 && chunks[2].nbSpans == 1);
+
+    const HistorySpan *spans = history_record_get_spans(r);
+    TEST_CHECK(spans[0].x == CHUNK_SIZE - 4 && spans[0].y == 3 && spans[0].z == 2);
+    TEST_CHECK(spans[0].length == 4 && spans[0].after == 1);
+    TEST_CHECK(spans[0].before == SHAPE_COLOR_INDEX_AIR_BLOCK);
+    TEST_CHECK(spans[1].x == 0 && spans[1].length == 8 && spans[1].after == 1);
+    TEST_CHECK(spans[2].x == 8 && spans[2].length == CHUNK_SIZE - 8 && spans[2].after == 2);
+    TEST_CHECK(spans[3].x == 0 && spans[3].length == 4 && spans[3].after == 2);
+
+    TEST_CHECK(history_can_undo(h) == false);
+    TEST_CHECK(history_get_record_to_redo(h) == r);
+    history_free(h);
+}
+
+// oldest records are discarded beyond memory limit, latest one is always kept
+void test_history_memory_limit(void) {
+    History *h = history_new();
+    TEST_CHECK(history_get_memory_limit(h) == HISTORY_DEFAULT_MEMORY_LIMIT);
+    TEST_CHECK(history_get_memory_usage(h) == 0);
+
+    for (SHAPE_COORDS_INT_T i = 0; i < 3; ++i) {
+        Transaction *tr = transaction_new();
+        transaction_addBlock(tr, i, 0, 0, 1);
+        history_pushTransaction(h, tr);
+    }
+    const size_t recordSize = history_get_memory_usage(h) / 3;
+    TEST_CHECK(recordSize > 0);
+
+    history_set_memory_limit(h, recordSize * 2);
+    TEST_CHECK(history_get_memory_usage(h) == recordSize * 2);
+    TEST_CHECK(history_get_record_to_undo(h) != NULL);
+    TEST_CHECK(history_get_record_to_undo(h) != NULL);
+    TEST_CHECK(history_can_undo(h) == false);
+
+    // pushing after undos discards undone records
+    Transaction *tr = transaction_new();
+    transaction_addBlock(tr, 0, 1, 0, 1);
+    history_pushTransaction(h, tr);
+    TEST_CHECK(history_get_memory_usage(h) == recordSize);
+    TEST_CHECK(history_can_redo(h) == false);
+
+    history_set_memory_limit(h, 0);
+    TEST_CHECK(history_get_memory_usage(h) == recordSize);
+    TEST_CHECK(history_can_undo(h));
+
+    history_free(h);
+}
@@ -0,0 +1,181 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_index3d.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include "index3d.h"
+
+void test_index3d_insert_get_remove(void) {
+    int a = 1, b = 2, c = 3;
+    Index3D *index = index3d_new();
+
+    TEST_CHECK(index3d_is_empty(index));
+    TEST_CHECK(index3d_get(index, 0, 0, 0) == NULL);
+    TEST_CHECK(index3d_remove(index, 0, 0, 0, NULL) == NULL);
+
+    index3d_insert(index, &a, 0, 0, 0, NULL);
+    index3d_insert(index, &b, -1, 0, 0, NULL);
+    index3d_insert(index, &c, 0, INT32_MIN, INT32_MAX, NULL);
+
+    TEST_CHECK(index3d_is_empty(index) == false);
+    TEST_CHECK(index3d_get_count(index) == 3);
+    TEST_CHECK(index3d_get(index, 0, 0, 0) == &a);
+    TEST_CHECK(index3d_get(index, -1, 0, 0) == &b);
+    TEST_CHECK(index3d_get(index, 0, INT32_MIN, INT32_MAX) == &c);
+    TEST_CHECK(index3d_get(index, 0, 0, -1) == NULL);
+
+    // inserting at same position replaces pointer
+    index3d_insert(index, &c, -1, 0, 0, NULL);
+    TEST_CHECK(index3d_get(index, -1, 0, 0) == &c);
+    TEST_CHECK(index3d_get_count(index) == 3);
+
+    TEST_CHECK(index3d_remove(index, -1, 0, 0, NULL) == &c);
+    TEST_CHECK(index3d_get(index, -1, 0, 0) == NULL);
+    TEST_CHECK(index3d_remove(index, -1, 0, 0, NULL) == NULL);
+    TEST_CHECK(index3d_remove(index, 0, 0, 0, NULL) == &a);
+    TEST_CHECK(index3d_remove(index, 0, INT32_MIN, INT32_MAX, NULL) == &c);
+    TEST_CHECK(index3d_is_empty(index));
+
+    index3d_free(index);
+}
+
+// lookups outside of inserted positions' box, box is reset once the index is empty
+void test_index3d_bounds(void) {
+    int a = 1, b = 2;
+    Index3D *index = index3d_new();
+
+    index3d_insert(index, &a, 2, 3, 4, NULL);
+    TEST_CHECK(index3d_get(index, 2, 3, 4) == &a);
+    TEST_CHECK(index3d_get(index, 1, 3, 4) == NULL);
+    TEST_CHECK(index3d_get(index, 2, 3, 5) == NULL);
+
+    index3d_insert(index, &b, -2, 5, 4, NULL);
+    TEST_CHECK(index3d_get(index, -2, 5, 4) == &b);
+    TEST_CHECK(index3d_get(index, 0, 4, 4) == NULL);
+
+    TEST_CHECK(index3d_remove(index, 2, 3, 4, NULL) == &a);
+    TEST_CHECK(index3d_remove(index, -2, 5, 4, NULL) == &b);
+
+    // outside of the former box
+    index3d_insert(index, &a, 10, -10, 0, NULL);
+    TEST_CHECK(index3d_get(index, 10, -10, 0) == &a);
+    TEST_CHECK(index3d_get(index, 2, 3, 4) == NULL);
+
+    index3d_flush(index, NULL);
+    index3d_insert(index, &b, -10, 10, 0, NULL);
+    TEST_CHECK(index3d_get(index, -10, 10, 0) == &b);
+    TEST_CHECK(index3d_get(index, 10, -10, 0) == NULL);
+
+    index3d_flush(index, NULL);
+    index3d_free(index);
+}
+
+// enough entries to grow the table several times, removing every other one
+void test_index3d_many(void) {
+    static int values[32][32][32];
+    Index3D *index = index3d_new();
+
+    for (int x = 0; x < 32; ++x) {
+        for (int y = 0; y < 32; ++y) {
+            for (int z = 0; z < 32; ++z) {
+                index3d_insert(index, &values[x][y][z], x - 16, y - 16, z - 16, NULL);
+            }
+        }
+    }
+    TEST_CHECK(index3d_get_count(index) == 32 * 32 * 32);
+
+    for (int x = 0; x < 32; ++x) {
+        for (int y = 0; y < 32; ++y) {
+            for (int z = 0; z < 32; z += 2) {
+                TEST_CHECK(index3d_remove(index, x - 16, y - 16, z - 16, NULL) ==
+                           &values[x][y][z]);
+            }
+        }
+    }
+    TEST_CHECK(index3d_get_count(index) == 32 * 32 * 16);
+
+    bool ok = true;
+    for (int x = 0; x < 32; ++x) {
+        for (int y = 0; y < 32; ++y) {
+            for (int z = 0; z < 32; ++z) {
+                void *expected = z % 2 == 0 ? NULL : &values[x][y][z];
+                ok = ok && index3d_get(index, x - 16, y - 16, z - 16) == expected;
+            }
+        }
+    }
+    TEST_CHECK(ok);
+
+    index3d_flush(index, NULL);
+    TEST_CHECK(index3d_is_empty(index));
+    TEST_CHECK(index3d_get(index, -15, -16, -16) == NULL);
+    index3d_free(index);
+}
+
+// iteration follows insertion order, removed entries are skipped
+void test_index3d_iterator(void) {
+    int values[64];
+    Index3D *index = index3d_new();
+
+    for (int i = 0; i < 64; ++i) {
+        index3d_insert(index, &values[i], i, -i, i * 2, NULL);
+    }
+    for (int i = 0; i < 64; i += 3) {
+        index3d_remove(index, i, -i, i * 2, NULL);
+    }
+
+    Index3DIterator *it = index3d_iterator_new(index);
+    int expected = 1;
+    bool ok = true;
+    while (index3d_iterator_pointer(it) != NULL) {
+        ok = ok && index3d_iterator_pointer(it) == &values[expected];
+        expected += expected % 3 == 2 ? 2 : 1;
+        index3d_iterator_next(it);
+    }
+    TEST_CHECK(ok);
+    TEST_CHECK(expected == 64);
+    index3d_iterator_free(it);
+
+    index3d_flush(index, NULL);
+    index3d_free(index);
+}
+
+// same as transactions: removing current entry through the iterator, inserting at end position
+void test_index3d_iterator_remove_insert(void) {
+    int a = 1, b = 2, c = 3;
+    Index3D *index = index3d_new();
+    Index3DIterator *it = index3d_iterator_new(index);
+
+    TEST_CHECK(index3d_iterator_pointer(it) == NULL);
+    index3d_insert(index, &a, 0, 0, 0, it);
+    index3d_insert(index, &b, 1, 0, 0, it);
+    index3d_insert(index, &c, 2, 0, 0, it);
+    TEST_CHECK(index3d_iterator_pointer(it) == &a);
+    TEST_CHECK(index3d_iterator_is_at_end(it) == false);
+
+    // removing current entry, then going to next one
+    TEST_CHECK(index3d_remove(index, 0, 0, 0, it) == &a);
+    index3d_iterator_next(it);
+    TEST_CHECK(index3d_iterator_pointer(it) == &b);
+
+    index3d_iterator_next(it);
+    TEST_CHECK(index3d_iterator_pointer(it) == &c);
+    TEST_CHECK(index3d_iterator_is_at_end(it));
+    index3d_iterator_next(it);
+    TEST_CHECK(index3d_iterator_pointer(it) == NULL);
+
+    // amending an entry pushes it after the iterator
+    TEST_CHECK(index3d_remove(index, 1, 0, 0, it) == &b);
+    index3d_insert(index, &b, 1, 0, 0, it);
+    TEST_CHECK(index3d_iterator_pointer(it) == &b);
+    index3d_iterator_next(it);
+    TEST_CHECK(index3d_iterator_pointer(it) == NULL);
+
+    index3d_iterator_free(it);
+    index3d_remove(index, 1, 0, 0, NULL);
+    index3d_remove(index, 2, 0, 0, NULL);
+    TEST_CHECK(index3d_is_empty(index));
+    index3d_free(index);
+}
@@ -0,0 +1,189 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_job_system.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <string.h>
+
+#include "color_atlas.h"
+#include "job_system.h"
+#include "shape.h"
+#include "thread.h"
+#include "vertextbuffer.h"
+
+typedef struct {
+    uint32_t order[8];
+    uint32_t count;
+    char pad[4];
+} TestJobLog;
+
+typedef struct {
+    TestJobLog *log;
+    uint32_t id;
+    char pad[4];
+} TestJob;
+
+static void _test_job_log(void *userdata) {
+    TestJob *job = (TestJob *)userdata;
+    job->log->order[job->log->count++] = job->id;
+}
+
+static void _test_job_sum(void *userdata, uint32_t begin, uint32_t end) {
+    volatile int32_t *sum = (volatile int32_t *)userdata;
+    int32_t partial = 0;
+    for (uint32_t i = begin; i < end; ++i) {
+        partial += (int32_t)i;
+    }
+    thread_atomic_add(sum, partial);
+}
+
+static void _test_job_increment(void *userdata) {
+    thread_atomic_add((volatile int32_t *)userdata, 1);
+}
+
+static void _test_job_mark_pointer(void *ptr, void *userdata) {
+    uint8_t *marks = (uint8_t *)userdata;
+    marks[*(uint32_t *)ptr] += 1;
+}
+
+// jobs run immediately, in submission order, when there's no worker
+void test_job_system_deterministic(void) {
+    JobSystem *js = job_system_new(0);
+    TEST_CHECK(job_system_get_nb_workers(js) == 0);
+
+    TestJobLog log = {{0}, 0, {0}};
+    TestJob jobs[4];
+    JobCounter counter = {0};
+    for (uint32_t i = 0; i < 4; ++i) {
+        jobs[i].log = &log;
+        jobs[i].id = i;
+        job_system_submit(js, _test_job_log, &jobs[i], &counter);
+        TEST_CHECK(log.count == i + 1);
+    }
+    job_system_wait(js, &counter);
+    for (uint32_t i = 0; i < 4; ++i) {
+        TEST_CHECK(log.order[i] == i);
+    }
+
+    volatile int32_t sum = 0;
+    job_system_parallel_for(js, 1000, 0, _test_job_sum, (void *)&sum);
+    TEST_CHECK(sum == 499500);
+
+    // NULL job system works the same way
+    sum = 0;
+    job_system_parallel_for(NULL, 1000, 7, _test_job_sum, (void *)&sum);
+    TEST_CHECK(sum == 499500);
+
+    job_system_free(js);
+}
+
+void test_job_system_workers(void) {
+    JobSystem *js = job_system_new(3);
+    TEST_CHECK(job_system_get_nb_workers(js) == 3);
+
+    // submit & wait
+    volatile int32_t n = 0;
+    JobCounter counter = {0};
+    for (uint32_t i = 0; i < 500; ++i) {
+        job_system_submit(js, _test_job_increment, (void *)&n, &counter);
+    }
+    job_system_wait(js, &counter);
+    TEST_CHECK(counter.pending == 0);
+    TEST_CHECK(n == 500);
+
+    // parallel for, with explicit & automatic grains
+    volatile int32_t sum = 0;
+    job_system_parallel_for(js, 10000, 3, _test_job_sum, (void *)&sum);
+    TEST_CHECK(sum == 49995000);
+    sum = 0;
+    job_system_parallel_for(js, 10000, 0, _test_job_sum, (void *)&sum);
+    TEST_CHECK(sum == 49995000);
+
+    // each pointer of an index is visited exactly once
+    Index3D *index = index3d_new();
+    uint32_t ids[64];
+    uint8_t marks[64];
+    memset(marks, 0, sizeof(marks));
+    for (uint32_t i = 0; i < 64; ++i) {
+        ids[i] = i;
+        index3d_insert(index,
+                       &ids[i],
+                       (int32_t)(i % 4),
+                       (int32_t)(i / 4 % 4),
+                       (int32_t)(i / 16),
+                       NULL);
+    }
+    job_system_parallel_for_index3d(js, index, _test_job_mark_pointer, marks);
+    for (uint32_t i = 0; i < 64; ++i) {
+        TEST_CHECK(marks[i] == 1);
+    }
+    index3d_flush(index, NULL);
+    index3d_free(index);
+
+    job_system_free(js);
+}
+
+static Shape *_test_job_system_make_shape(ColorAtlas *atlas) {
+    Shape *sh = shape_make();
+    shape_set_palette(sh, color_palette_new(atlas), false);
+    ColorPalette *palette = shape_get_palette(sh);
+    SHAPE_COLOR_INDEX_INT_T colors[3];
+    color_palette_check_and_add_color(palette, (RGBAColor){255, 0, 0, 255}, &colors[0], false);
+    color_palette_check_and_add_color(palette, (RGBAColor){0, 255, 0, 255}, &colors[1], false);
+    color_palette_check_and_add_color(palette, (RGBAColor){0, 0, 255, 255}, &colors[2], false);
+
+    // a few chunks wide, with holes
+    uint32_t seed = 1;
+    for (SHAPE_COORDS_INT_T z = 0; z < CHUNK_SIZE * 3; ++z) {
+        for (SHAPE_COORDS_INT_T y = 0; y < CHUNK_SIZE * 2; ++y) {
+            for (SHAPE_COORDS_INT_T x = 0; x < CHUNK_SIZE * 3; ++x) {
+                seed = seed * 1664525u + 1013904223u;
+                if ((seed >> 8) % 3 != 0) {
+                    shape_add_block(sh, colors[(seed >> 16) % 3], x, y, z, false);
+                }
+            }
+        }
+    }
+    return sh;
+}
+
+// parallel meshing must produce the same vertex buffers as serial meshing
+void test_job_system_shape_refresh_all_vertices(void) {
+    // one atlas per shape, for vertex colors to match
+    ColorAtlas *atlas1 = color_atlas_new();
+    ColorAtlas *atlas2 = color_atlas_new();
+
+    Shape *serial = _test_job_system_make_shape(atlas1);
+    shape_refresh_all_vertices(serial);
+
+    job_system_shared_init(3);
+    TEST_CHECK(job_system_get_nb_workers(job_system_shared()) == 3);
+    Shape *parallel = _test_job_system_make_shape(atlas2);
+    shape_refresh_all_vertices(parallel);
+    job_system_shared_free();
+    TEST_CHECK(job_system_shared() == NULL);
+
+    const VertexBuffer *vb1 = shape_get_first_vertex_buffer(serial, false);
+    const VertexBuffer *vb2 = shape_get_first_vertex_buffer(parallel, false);
+    TEST_CHECK(vb1 != NULL && vb2 != NULL);
+    while (vb1 != NULL && vb2 != NULL) {
+        const uint32_t count = vertex_buffer_get_count(vb1);
+        TEST_CHECK(count > 0);
+        TEST_CHECK(count == vertex_buffer_get_count(vb2));
+        TEST_CHECK(vertex_buffer_get_nb_draw_slices(vb1) == vertex_buffer_get_nb_draw_slices(vb2));
+        TEST_CHECK(memcmp(vertex_buffer_get_draw_buffer(vb1),
+                          vertex_buffer_get_draw_buffer(vb2),
+                          sizeof(VertexAttributes) * count) == 0);
+        vb1 = vertex_buffer_get_next(vb1);
+        vb2 = vertex_buffer_get_next(vb2);
+    }
+    TEST_CHECK(vb1 == NULL && vb2 == NULL);
+
+    shape_free(serial);
+    shape_free(parallel);
+    color_atlas_free(atlas1);
+    color_atlas_free(atlas2);
+}
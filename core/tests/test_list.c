@@ -15,8 +15,11 @@
 #include "test_block.h"
 #include "test_blockChange.h"
 #include "test_box.h"
+#include "test_cclog.h"
 #include "test_chunk.h"
+#include "test_color_atlas.h"
 #include "test_config.h"
+#include "test_culling.h"
 #include "test_doubly_linked_list.h"
 #include "test_doubly_linked_list_uint8.h"
 #include "test_fifo_list.h"
@@ -29,12 +32,20 @@
 #include "test_float4.h"
 #include "test_flood_fill_lighting.h"
 #include "test_hash_uint32_int.h"
+#include "test_history.h"
+#include "test_index3d.h"
 #include "test_inputs.h"
 #include "test_int3.h"
+#include "test_job_system.h"
 #include "test_map_string_float3.h"
 #include "test_matrix4x4.h"
+#include "test_particles.h"
+#include "test_pathfinding.h"
+#include "test_pool.h"
+#include "test_profiler.h"
 #include "test_quaternion.h"
 #include "test_rtree.h"
+#include "test_scene.h"
 #include "test_shape.h"
 #include "test_stream.h"
 #include "test_transaction.h"
@@ -42,6 +53,7 @@
 #include "test_utils.h"
 #include "test_vertexbuffer.h"
 #include "test_weakptr.h"
+#include "test_world_stream.h"
 
 TEST_LIST = {
 
@@ -81,14 +93,26 @@ TEST_LIST = {
     {"test_box_to_aabox_no_rot", test_box_to_aabox_no_rot},
     {"test_box_to_aabox2", test_box_to_aabox2},
 
+    // cclog
+    {"cclog_async", test_cclog_async},
+    {"cclog_rate_limit", test_cclog_rate_limit},
+
     // chunk
     {"test_chunk_new", test_chunk_new},
     {"test_chunk_Block", test_chunk_Block},
     {"test_chunk_needs_display", test_chunk_needs_display},
+    {"test_chunk_set_blocks", test_chunk_set_blocks},
+    {"test_chunk_occupancy_masks", test_chunk_occupancy_masks},
+
+    // color_atlas
+    {"color_atlas_reuse_indices", test_color_atlas_reuse_indices},
 
     // config
     {"test_upper_power_of_two", test_upper_power_of_two},
 
+    // culling
+    {"culling_frustum_occlusion", test_culling_frustum_occlusion},
+
     // doubly_linked_list_uint8
     {"doubly_linked_list_uint8_new", test_doubly_linked_list_uint8_new},
     {"doubly_linked_list_uint8_node_new", test_doubly_linked_list_uint8_node_new},
@@ -131,6 +155,7 @@ TEST_LIST = {
     {"doubly_linked_list_delete_node", test_doubly_linked_list_delete_node},
     {"doubly_linked_list_node_at_index", test_doubly_linked_list_node_at_index},
     {"doubly_linked_list_sort_ascending", test_doubly_linked_list_sort_ascending},
+    {"doubly_linked_list_recycle", test_doubly_linked_list_recycle},
 
     // fifo_list
     {"fifo_list_new", test_fifo_list_new},
@@ -139,6 +164,7 @@ TEST_LIST = {
     {"fifo_list_pop", test_fifo_list_pop},
     {"fifo_list_push", test_fifo_list_push},
     {"fifo_list_new_copy", test_fifo_list_new_copy},
+    {"fifo_list_wraparound", test_fifo_list_wraparound},
 
     // filo_list
     {"filo_list_new", test_filo_list_new},
@@ -175,6 +201,18 @@ TEST_LIST = {
 
     // hash_uint32
     {"hash_uint32_int", test_hash_uint32_int},
+    {"hash_uint32_int_many", test_hash_uint32_int_many},
+
+    // history
+    {"history_record_spans", test_history_record_spans},
+    {"history_memory_limit", test_history_memory_limit},
+
+    // index3d
+    {"index3d_insert_get_remove", test_index3d_insert_get_remove},
+    {"index3d_bounds", test_index3d_bounds},
+    {"index3d_many", test_index3d_many},
+    {"index3d_iterator", test_index3d_iterator},
+    {"index3d_iterator_remove_insert", test_index3d_iterator_remove_insert},
 
     // inputs
     {"isTouchEventID", test_isTouchEventID},
@@ -214,6 +252,11 @@ TEST_LIST = {
     {"int3_op_max", test_int3_op_max},
     {"int3_op_div_ints", test_int3_op_div_ints},
 
+    // job_system
+    {"job_system_deterministic", test_job_system_deterministic},
+    {"job_system_workers", test_job_system_workers},
+    {"job_system_shape_refresh_all_vertices", test_job_system_shape_refresh_all_vertices},
+
     // light_flood_fill_lighting
     {"light_node_queue_new", test_light_node_queue_new},
     {"light_node_get_coords", test_light_node_get_coords},
@@ -262,6 +305,21 @@ TEST_LIST = {
     {"matrix4x4_op_invert", test_matrix4x4_op_invert},
     {"matrix4x4_op_unscale", test_matrix4x4_op_unscale},
 
+    // particles
+    {"particles_emitter_update", test_particles_emitter_update},
+
+    // pathfinding
+    {"pathfinding_find", test_pathfinding_find},
+    {"pathfinding_cliff_at_chunk_border", test_pathfinding_cliff_at_chunk_border},
+
+    // pool
+    {"pool_alloc", test_pool_alloc},
+    {"pool_recycle", test_pool_recycle},
+
+    // profiler
+    {"profiler_zones", test_profiler_zones},
+    {"profiler_threads", test_profiler_threads},
+
     // quaternion
     {"quaternion_new", test_quaternion_new},
     {"quaternion_new_identity", test_quaternion_new_identity},
@@ -296,6 +354,12 @@ TEST_LIST = {
     {"rtree_node_get_groups", test_rtree_node_get_groups},
     {"rtree_node_get_collides_with", test_rtree_node_get_collides_with},
     {"rtree_create_and_insert", test_rtree_create_and_insert},
+    {"rtree_update_moving", test_rtree_update_moving},
+
+    // scene
+    {"scene_collision_couples", test_scene_collision_couples},
+    {"scene_collision_couples_recycled_id", test_scene_collision_couples_recycled_id},
+    {"scene_fixed_step_snapshot", test_scene_fixed_step_snapshot},
 
     // shape
     {"shape_make", test_shape_make},
@@ -312,6 +376,12 @@ TEST_LIST = {
     {"test_shape_addblock_1", test_shape_addblock_1},
     // {"test_shape_addblock_2", test_shape_addblock_2},
     {"test_shape_addblock_3", test_shape_addblock_3},
+    {"test_shape_add_chunk", test_shape_add_chunk},
+    {"shape_history", test_shape_history},
+    {"shape_history_keep_pending", test_shape_history_keep_pending},
+    {"shape_fill_box", test_shape_fill_box},
+    {"shape_copy_box_from", test_shape_copy_box_from},
+    {"shape_lods", test_shape_lods},
 
     // stream
     {"stream_new_buffer_read", test_stream_new_buffer_read},
@@ -366,6 +436,9 @@ TEST_LIST = {
     {"vertex_buffer_get_max_count", test_vertex_buffer_get_max_length},
     {"vertex_buffer_set_lighting_enabled", test_vertex_buffer_set_lighting_enabled},
     {"vertex_buffer_get_lighting_enabled", test_vertex_buffer_get_lighting_enabled},
+    {"vertex_buffer_add_draw_slice", test_vertex_buffer_add_draw_slice},
+    {"vertex_buffer_fill_gaps_with_budget", test_vertex_buffer_fill_gaps_with_budget},
+    {"vertex_buffer_pop_dirty_ranges", test_vertex_buffer_pop_dirty_ranges},
 
     // weakptr
     {"weakptr_new", test_weakptr_new},
@@ -375,5 +448,8 @@ TEST_LIST = {
     {"weakptr_get_or_release", test_weakptr_get_or_release},
     {"weakptr_invalidate", test_weakptr_invalidate},
 
+    // world stream
+    {"world_stream_load_evict", test_world_stream_load_evict},
+
     {NULL, NULL} /* zeroed record marking the end of the list */
 };
@@ -0,0 +1,85 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_particles.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include "color_palette.h"
+#include "particles.h"
+
+// particles falling on a per-block map, then through it without scene
+void test_particles_emitter_update(void) {
+    Scene *sc = scene_new(NULL);
+    Shape *map = shape_make_2(true);
+    shape_set_palette(map, color_palette_new(NULL), false);
+    SHAPE_COLOR_INDEX_INT_T color;
+    color_palette_check_and_add_color(shape_get_palette(map),
+                                      (RGBAColor){255, 0, 0, 255},
+                                      &color,
+                                      false);
+    shape_fill_box(map,
+                   NULL,
+                   color,
+                   (SHAPE_COORDS_INT3_T){0, 0, 0},
+                   (SHAPE_COORDS_INT3_T){16, 1, 16});
+    shape_set_pivot(map, 0.0f, 0.0f, 0.0f);
+    RigidBody *rb;
+    shape_ensure_rigidbody(map, PHYSICS_GROUP_DEFAULT_MAP, PHYSICS_COLLIDESWITH_DEFAULT_MAP, &rb);
+    rigidbody_set_simulation_mode(rb, RigidbodyMode_StaticPerBlock);
+    scene_add_map(sc, map);
+    scene_refresh(sc, 0.0, NULL);
+
+    ParticlesEmitter *e = particles_emitter_new(64, 42);
+    TEST_ASSERT(e != NULL);
+    ParticlesEmitterConfig *cfg = particles_emitter_get_config(e);
+    cfg->position = (float3){8.0f, 5.0f, 8.0f};
+    cfg->positionSpread = (float3){2.0f, 0.0f, 2.0f};
+    cfg->acceleration = (float3){0.0f, -20.0f, 0.0f};
+    cfg->life = 10.0f;
+    cfg->startColor = (RGBAColor){255, 0, 0, 255};
+    cfg->endColor = (RGBAColor){0, 0, 255, 255};
+    cfg->endScale = 0.0f;
+    cfg->collidesWith = PHYSICS_GROUP_DEFAULT_MAP;
+
+    // limited by capacity
+    TEST_CHECK(particles_emitter_spawn(e, 100) == 64);
+    TEST_CHECK(particles_emitter_get_count(e) == 64);
+
+    // resting on the floor after 2 seconds
+    for (int i = 0; i < 120; ++i) {
+        particles_emitter_update(e, sc, 1.0f / 60.0f);
+    }
+    ParticlesInstance instances[64];
+    TEST_CHECK(particles_emitter_write_instances(e, instances, 64) == 64);
+    for (int i = 0; i < 64; ++i) {
+        TEST_CHECK(instances[i].y >= 1.0f && instances[i].y < 1.01f);
+        TEST_CHECK(instances[i].x >= 6.0f && instances[i].x <= 10.0f);
+        TEST_CHECK(instances[i].z >= 6.0f && instances[i].z <= 10.0f);
+        // 20% of life
+        TEST_CHECK(instances[i].color.r == 204);
+        TEST_CHECK(instances[i].color.b == 51);
+        TEST_CHECK(fabsf(instances[i].scale - 0.8f) < 0.01f);
+    }
+
+    // no collisions without scene
+    particles_emitter_update(e, NULL, 0.5f);
+    TEST_CHECK(particles_emitter_write_instances(e, instances, 64) == 64);
+    for (int i = 0; i < 64; ++i) {
+        TEST_CHECK(instances[i].y < 0.0f);
+    }
+
+    // continuous emission, dead particles removed
+    particles_emitter_clear(e);
+    cfg->rate = 30.0f;
+    cfg->life = 0.5f;
+    for (int i = 0; i < 120; ++i) {
+        particles_emitter_update(e, sc, 1.0f / 60.0f);
+    }
+    TEST_CHECK(particles_emitter_get_count(e) >= 14 && particles_emitter_get_count(e) <= 16);
+
+    particles_emitter_free(e);
+    scene_free(sc);
+    shape_release(map);
+}
@@ -0,0 +1,175 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_pathfinding.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <stdlib.h>
+
+#include "color_palette.h"
+#include "pathfinding.h"
+
+static bool _test_pathfinding_is_valid(const PathfindingResult *r) {
+    for (uint32_t i = 1; i < r->nbCells; ++i) {
+        const SHAPE_COORDS_INT3_T a = r->cells[i - 1], b = r->cells[i];
+        const int dy = b.y - a.y;
+        if (abs(b.x - a.x) + abs(b.z - a.z) != 1 || dy > 1 || dy < -PATHFINDING_MAX_DROP) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 96x16 floor over 6 chunks, split by a wall w/ a gap at z = 15
+void test_pathfinding_find(void) {
+    Shape *s = shape_make_2(true);
+    shape_set_palette(s, color_palette_new(NULL), false);
+    SHAPE_COLOR_INDEX_INT_T color;
+    color_palette_check_and_add_color(shape_get_palette(s),
+                                      (RGBAColor){255, 0, 0, 255},
+                                      &color,
+                                      false);
+    shape_fill_box(s,
+                   NULL,
+                   color,
+                   (SHAPE_COORDS_INT3_T){0, 0, 0},
+                   (SHAPE_COORDS_INT3_T){96, 1, 16});
+    shape_fill_box(s,
+                   NULL,
+                   color,
+                   (SHAPE_COORDS_INT3_T){20, 1, 0},
+                   (SHAPE_COORDS_INT3_T){21, 4, 15});
+    // 1-block & 2-block steps
+    shape_add_block(s, color, 10, 1, 10, false);
+    shape_add_block(s, color, 12, 1, 10, false);
+    shape_add_block(s, color, 12, 2, 10, false);
+
+    Pathfinding *pf = pathfinding_new(s, 2);
+    TEST_ASSERT(pf != NULL);
+    pathfinding_update(pf);
+    // 6 floor chunks & the 6 clusters above them
+    TEST_CHECK(pathfinding_get_nb_clusters(pf) == 12);
+    TEST_CHECK(pathfinding_get_nb_cluster_builds(pf) == 12);
+
+    // around the wall, through the gap
+    const SHAPE_COORDS_INT3_T start = {2, 1, 2}, goal = {40, 1, 2};
+    PathfindingResult *r = pathfinding_find(pf, start, goal);
+    TEST_ASSERT(r != NULL && r->found);
+    TEST_CHECK(r->cells[0].x == start.x && r->cells[0].z == start.z);
+    TEST_CHECK(r->cells[r->nbCells - 1].x == goal.x && r->cells[r->nbCells - 1].z == goal.z);
+    TEST_CHECK(_test_pathfinding_is_valid(r));
+    bool throughGap = false;
+    for (uint32_t i = 0; i < r->nbCells; ++i) {
+        TEST_CHECK(r->cells[i].x != 20 || r->cells[i].z == 15);
+        throughGap = throughGap || (r->cells[i].x == 20 && r->cells[i].z == 15);
+    }
+    TEST_CHECK(throughGap);
+    // shortest path is 64 level moves, portals make it near-optimal
+    TEST_CHECK(r->cost == (r->nbCells - 1) * PATHFINDING_COST_MOVE);
+    TEST_CHECK(r->cost >= 640 && r->cost <= 640 * 12 / 10);
+    pathfinding_result_free(r);
+
+    // batch resolved in the background: steps up one block only
+    const uint32_t id1 = pathfinding_request(pf, start, (SHAPE_COORDS_INT3_T){10, 2, 10});
+    const uint32_t id2 = pathfinding_request(pf, start, (SHAPE_COORDS_INT3_T){12, 3, 10});
+    pathfinding_wait(pf);
+    r = pathfinding_pop_result(pf);
+    TEST_ASSERT(r != NULL);
+    TEST_CHECK(r->id == id1 && r->found);
+    TEST_CHECK(r->cells[r->nbCells - 1].y == 2 && _test_pathfinding_is_valid(r));
+    pathfinding_result_free(r);
+    r = pathfinding_pop_result(pf);
+    TEST_ASSERT(r != NULL);
+    TEST_CHECK(r->id == id2 && r->found == false && r->cells == NULL);
+    pathfinding_result_free(r);
+    TEST_CHECK(pathfinding_pop_result(pf) == NULL);
+
+    // closing the gap only rebuilds clusters around modified chunk, x in [0, 2]
+    shape_fill_box(s,
+                   NULL,
+                   color,
+                   (SHAPE_COORDS_INT3_T){20, 1, 15},
+                   (SHAPE_COORDS_INT3_T){21, 4, 16});
+    pathfinding_update(pf);
+    TEST_CHECK(pathfinding_get_nb_cluster_builds(pf) == 12 + 6);
+    pathfinding_update(pf);
+    TEST_CHECK(pathfinding_get_nb_cluster_builds(pf) == 12 + 6);
+    r = pathfinding_find(pf, start, goal);
+    TEST_ASSERT(r != NULL);
+    TEST_CHECK(r->found == false);
+    pathfinding_result_free(r);
+
+    pathfinding_free(pf);
+    shape_release(s);
+}
+
+// chunk border half level, half cliff: moves across it are split in 2 portals
+void test_pathfinding_cliff_at_chunk_border(void) {
+    Shape *s = shape_make_2(true);
+    shape_set_palette(s, color_palette_new(NULL), false);
+    SHAPE_COLOR_INDEX_INT_T color;
+    color_palette_check_and_add_color(shape_get_palette(s),
+                                      (RGBAColor){255, 0, 0, 255},
+                                      &color,
+                                      false);
+    // plateau in first chunk, continued by a narrow ledge in the next one, z in [0, 4)
+    shape_fill_box(s,
+                   NULL,
+                   color,
+                   (SHAPE_COORDS_INT3_T){0, 0, 0},
+                   (SHAPE_COORDS_INT3_T){16, 4, 16});
+    shape_fill_box(s,
+                   NULL,
+                   color,
+                   (SHAPE_COORDS_INT3_T){16, 0, 0},
+                   (SHAPE_COORDS_INT3_T){32, 4, 4});
+    // low ground next to the ledge, can't climb back from there
+    shape_fill_box(s,
+                   NULL,
+                   color,
+                   (SHAPE_COORDS_INT3_T){16, 0, 4},
+                   (SHAPE_COORDS_INT3_T){32, 1, 16});
+
+    Pathfinding *pf = pathfinding_new(s, 2);
+    TEST_ASSERT(pf != NULL);
+    pathfinding_update(pf);
+
+    // to the ledge, without dropping
+    const SHAPE_COORDS_INT3_T start = {2, 4, 8}, goal = {24, 4, 1};
+    PathfindingResult *r = pathfinding_find(pf, start, goal);
+    TEST_ASSERT(r != NULL && r->found);
+    TEST_CHECK(_test_pathfinding_is_valid(r));
+    TEST_CHECK(r->cells[r->nbCells - 1].x == goal.x && r->cells[r->nbCells - 1].z == goal.z);
+    for (uint32_t i = 0; i < r->nbCells; ++i) {
+        TEST_CHECK(r->cells[i].y == 4);
+    }
+    TEST_CHECK(r->cost == (r->nbCells - 1) * PATHFINDING_COST_MOVE);
+    pathfinding_result_free(r);
+
+    // down the cliff
+    r = pathfinding_find(pf, start, (SHAPE_COORDS_INT3_T){24, 1, 12});
+    TEST_ASSERT(r != NULL && r->found);
+    TEST_CHECK(_test_pathfinding_is_valid(r));
+    pathfinding_result_free(r);
+
+    // clusters rebuilt while requests are being resolved
+    for (uint32_t i = 0; i < 64; ++i) {
+        const SHAPE_COORDS_INT3_T low = {24, 1, (SHAPE_COORDS_INT_T)(4 + i % 12)};
+        pathfinding_request(pf, start, low);
+    }
+    shape_add_block(s, color, 20, 1, 10, false);
+    pathfinding_update(pf);
+    pathfinding_wait(pf);
+    uint32_t nbResults = 0;
+    while ((r = pathfinding_pop_result(pf)) != NULL) {
+        TEST_CHECK(r->found && _test_pathfinding_is_valid(r));
+        pathfinding_result_free(r);
+        ++nbResults;
+    }
+    TEST_CHECK(nbResults == 64);
+
+    pathfinding_free(pf);
+    shape_release(s);
+}
@@ -0,0 +1,57 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_pool.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include "pool.h"
+
+// elements allocated across several slabs are distinct & writable
+void test_pool_alloc(void) {
+    Pool p;
+    pool_init(&p, 3, 2); // rounded up to pointer size
+    TEST_CHECK(p.elementSize == sizeof(void *));
+
+    void *elements[600];
+    bool ok = true;
+    for (int i = 0; i < 600; ++i) {
+        elements[i] = pool_alloc(&p);
+        ok = ok && elements[i] != NULL;
+        *(uintptr_t *)elements[i] = (uintptr_t)i;
+    }
+    TEST_CHECK(ok);
+    TEST_CHECK(p.nextSlabCapacity == POOL_MAX_SLAB_CAPACITY);
+
+    for (int i = 0; i < 600; ++i) {
+        ok = ok && *(uintptr_t *)elements[i] == (uintptr_t)i;
+    }
+    TEST_CHECK(ok);
+
+    pool_release(&p);
+    TEST_CHECK(p.slabs == NULL);
+}
+
+// recycled elements are given back before allocating new slabs
+void test_pool_recycle(void) {
+    Pool p;
+    pool_init(&p, 24, 4);
+
+    void *a = pool_alloc(&p);
+    void *b = pool_alloc(&p);
+    void *slabs = p.slabs;
+    pool_recycle(&p, a);
+    pool_recycle(&p, b);
+    TEST_CHECK(pool_alloc(&p) == b);
+    TEST_CHECK(pool_alloc(&p) == a);
+
+    for (int i = 0; i < 2; ++i) {
+        pool_alloc(&p);
+    }
+    TEST_CHECK(p.slabs == slabs);
+    pool_alloc(&p);
+    TEST_CHECK(p.slabs != slabs);
+
+    pool_release(&p);
+}
@@ -0,0 +1,118 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_profiler.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "profiler.h"
+#include "thread.h"
+
+#define TEST_PROFILER_ZONES 100
+
+static void _test_profiler_worker(void *userdata) {
+    for (int i = 0; i < TEST_PROFILER_ZONES; ++i) {
+        profiler_zone_begin("worker");
+        profiler_zone_end();
+    }
+}
+
+static char *_test_profiler_trace(void) {
+    FILE *fd = tmpfile();
+    if (fd == NULL) {
+        return NULL;
+    }
+    TEST_CHECK(profiler_write_chrome_trace(fd));
+    const long size = ftell(fd);
+    char *trace = (char *)malloc((size_t)size + 1);
+    rewind(fd);
+    const size_t read = fread(trace, 1, (size_t)size, fd);
+    trace[read] = '\0';
+    fclose(fd);
+    return trace;
+}
+
+static uint32_t _test_profiler_count(const char *str, const char *pattern) {
+    uint32_t count = 0;
+    const char *p = strstr(str, pattern);
+    while (p != NULL) {
+        ++count;
+        p = strstr(p + 1, pattern);
+    }
+    return count;
+}
+
+// zones are only recorded while capturing, nested zones are closed in order
+void test_profiler_zones(void) {
+    profiler_release();
+
+    profiler_zone_begin("ignored");
+    profiler_zone_end();
+    TEST_CHECK(profiler_get_zone_count() == 0);
+
+    profiler_set_capturing(true);
+    TEST_CHECK(profiler_is_capturing());
+    profiler_zone_begin("outer");
+    profiler_zone_begin("inner");
+    profiler_zone_end();
+    profiler_zone_begin("inner");
+    profiler_zone_end();
+    profiler_zone_end();
+    TEST_CHECK(profiler_get_zone_count() == 3);
+
+    // zone opened while capturing, closed after: discarded
+    profiler_zone_begin("late");
+    profiler_set_capturing(false);
+    profiler_zone_end();
+    // unbalanced end is ignored
+    profiler_zone_end();
+    TEST_CHECK(profiler_get_zone_count() == 3);
+
+    char *trace = _test_profiler_trace();
+    TEST_ASSERT(trace != NULL);
+    TEST_CHECK(strncmp(trace, "{\"traceEvents\":[", 16) == 0);
+    TEST_CHECK(_test_profiler_count(trace, "\"ph\":\"X\"") == 3);
+    TEST_CHECK(_test_profiler_count(trace, "\"name\":\"inner\"") == 2);
+    TEST_CHECK(_test_profiler_count(trace, "\"name\":\"outer\"") == 1);
+    TEST_CHECK(_test_profiler_count(trace, "late") == 0);
+    free(trace);
+
+    profiler_reset();
+    TEST_CHECK(profiler_get_zone_count() == 0);
+    profiler_release();
+}
+
+// each thread records in its own buffer, exported as its own track
+void test_profiler_threads(void) {
+    profiler_release();
+    profiler_set_capturing(true);
+
+    Thread *threads[2];
+    for (int i = 0; i < 2; ++i) {
+        threads[i] = thread_new(_test_profiler_worker, NULL);
+        if (threads[i] == NULL) {
+            _test_profiler_worker(NULL);
+        }
+    }
+    for (int i = 0; i < 2; ++i) {
+        thread_join_and_free(threads[i]);
+    }
+    _test_profiler_worker(NULL);
+    profiler_set_capturing(false);
+
+    TEST_CHECK(profiler_get_zone_count() == 3 * TEST_PROFILER_ZONES);
+
+    char *trace = _test_profiler_trace();
+    TEST_ASSERT(trace != NULL);
+    TEST_CHECK(_test_profiler_count(trace, "\"ph\":\"X\"") == 3 * TEST_PROFILER_ZONES);
+    if (threads[0] != NULL && threads[1] != NULL) {
+        TEST_CHECK(_test_profiler_count(trace, "\"thread_name\"") == 3);
+    }
+    free(trace);
+
+    profiler_release();
+}
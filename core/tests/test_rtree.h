@@ -104,3 +104,103 @@ void test_rtree_create_and_insert(void) {
     rtree_free(r);
     transform_release(t);
 }
+
+#define TEST_RTREE_MOVING_COUNT 48
+
+// bit field of leaves indices overlapping given box
+static uint64_t _test_rtree_query_mask(Rtree *r, const Box *box, Transform **ptrs) {
+    FifoList *results = fifo_list_new();
+    rtree_query_overlap_box(r,
+                            box,
+                            PHYSICS_GROUP_ALL_SYSTEM,
+                            PHYSICS_GROUP_ALL_SYSTEM,
+                            NULL,
+                            results,
+                            EPSILON_COLLISION);
+    uint64_t mask = 0;
+    RtreeNode *hit = (RtreeNode *)fifo_list_pop(results);
+    while (hit != NULL) {
+        for (int i = 0; i < TEST_RTREE_MOVING_COUNT; ++i) {
+            if (ptrs[i] == rtree_node_get_leaf_ptr(hit)) {
+                mask |= (uint64_t)1 << i;
+            }
+        }
+        hit = (RtreeNode *)fifo_list_pop(results);
+    }
+    fifo_list_free(results, NULL);
+    return mask;
+}
+
+// leaves moved w/ fat aabbs & refit give the same query results as regular updates
+void test_rtree_update_moving(void) {
+    Rtree *r1 = rtree_new(2, 4);
+    Rtree *r2 = rtree_new(2, 4);
+    Transform *ptrs[TEST_RTREE_MOVING_COUNT];
+    RtreeNode *leaves1[TEST_RTREE_MOVING_COUNT], *leaves2[TEST_RTREE_MOVING_COUNT];
+    Box boxes[TEST_RTREE_MOVING_COUNT];
+    float3 velocities[TEST_RTREE_MOVING_COUNT];
+
+    uint32_t seed = 7;
+    for (int i = 0; i < TEST_RTREE_MOVING_COUNT; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        const float x = (float)(seed >> 16 & 63), z = (float)(seed >> 8 & 63);
+        boxes[i] = (Box){{x, 0.0f, z}, {x + 1.0f, 2.0f, z + 1.0f}};
+        // a few fast bodies, others slow or still
+        const float speed = i % 8 == 0 ? 20.0f : (float)(i % 3);
+        velocities[i] = (float3){(i % 2 == 0 ? 1.0f : -1.0f) * speed, 0.0f, speed * 0.5f};
+        ptrs[i] = transform_make(HierarchyTransform);
+        leaves1[i] = rtree_create_and_insert(r1,
+                                             &boxes[i],
+                                             PHYSICS_GROUP_ALL_SYSTEM,
+                                             PHYSICS_GROUP_ALL_SYSTEM,
+                                             ptrs[i]);
+        leaves2[i] = rtree_create_and_insert(r2,
+                                             &boxes[i],
+                                             PHYSICS_GROUP_ALL_SYSTEM,
+                                             PHYSICS_GROUP_ALL_SYSTEM,
+                                             ptrs[i]);
+    }
+
+    const float dt = 1.0f / 60.0f;
+    for (int tick = 0; tick < 120; ++tick) {
+        for (int i = 0; i < TEST_RTREE_MOVING_COUNT; ++i) {
+            float3 motion = velocities[i];
+            float3_op_scale(&motion, dt);
+            float3_op_add(&boxes[i].min, &motion);
+            float3_op_add(&boxes[i].max, &motion);
+            // bounce within the area
+            if (boxes[i].min.x < 0.0f || boxes[i].max.x > 64.0f) {
+                velocities[i].x = -velocities[i].x;
+            }
+            if (boxes[i].min.z < 0.0f || boxes[i].max.z > 64.0f) {
+                velocities[i].z = -velocities[i].z;
+            }
+
+            rtree_update(r1, leaves1[i], &boxes[i]);
+            rtree_update_moving(r2, leaves2[i], &boxes[i], &motion);
+
+            // queries are exact before refit
+            if (i % 16 == 0) {
+                TEST_CHECK(_test_rtree_query_mask(r1, &boxes[i], ptrs) ==
+                           _test_rtree_query_mask(r2, &boxes[i], ptrs));
+            }
+        }
+        rtree_refit(r2);
+#if DEBUG_RTREE
+        TEST_CHECK(debug_rtree_integrity_check(r2));
+#endif
+
+        for (int q = 0; q < 4; ++q) {
+            const float o = (float)(q * 16);
+            const Box query = {{o, 0.0f, o}, {o + 12.0f, 1.0f, o + 20.0f}};
+            TEST_CHECK(_test_rtree_query_mask(r1, &query, ptrs) ==
+                       _test_rtree_query_mask(r2, &query, ptrs));
+        }
+    }
+
+    rtree_free(r1);
+    rtree_free(r2);
+    for (int i = 0; i < TEST_RTREE_MOVING_COUNT; ++i) {
+        transform_release(ptrs[i]);
+    }
+}
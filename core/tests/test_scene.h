@@ -0,0 +1,243 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_scene.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "scene.h"
+
+// begin, tick & discard statuses across frames, for pairs registered in any order
+void test_scene_collision_couples(void) {
+    Scene *sc = scene_new(NULL);
+    Transform *t1 = transform_make(PointTransform);
+    Transform *t2 = transform_make(PointTransform);
+    Transform *t3 = transform_make(PointTransform);
+    float3 n1 = {0.0f, 1.0f, 0.0f};
+    float3 n2 = {1.0f, 0.0f, 0.0f};
+    float3 n;
+
+    n = n1;
+    TEST_CHECK(scene_register_collision_couple(sc, t1, t2, &n) == CollisionCoupleStatus_Begin);
+    n = n2;
+    TEST_CHECK(scene_register_collision_couple(sc, t2, t1, &n) == CollisionCoupleStatus_Discard);
+    TEST_CHECK(float3_isEqual(&n, &n1, EPSILON_ZERO));
+    n = n2;
+    TEST_CHECK(scene_register_collision_couple(sc, t1, t3, &n) == CollisionCoupleStatus_Begin);
+
+    scene_refresh(sc, 0.0, NULL);
+
+    // t1/t2 still in contact, t1/t3 contact ends
+    n = n2;
+    TEST_CHECK(scene_register_collision_couple(sc, t2, t1, &n) == CollisionCoupleStatus_Tick);
+    TEST_CHECK(float3_isEqual(&n, &n1, EPSILON_ZERO));
+
+    scene_refresh(sc, 0.0, NULL);
+
+    n = n2;
+    TEST_CHECK(scene_register_collision_couple(sc, t3, t1, &n) == CollisionCoupleStatus_Begin);
+    n = n2;
+    TEST_CHECK(scene_register_collision_couple(sc, t1, t2, &n) == CollisionCoupleStatus_Tick);
+
+    scene_refresh(sc, 0.0, NULL);
+
+    transform_release(t1);
+    transform_release(t2);
+    transform_release(t3);
+    scene_free(sc);
+}
+
+// couples are keyed by transform IDs, which are recycled when transforms are freed
+void test_scene_collision_couples_recycled_id(void) {
+    Scene *sc = scene_new(NULL);
+    Transform *t1 = transform_make(PointTransform);
+    Transform *t2 = transform_make(PointTransform);
+    float3 n = {0.0f, 1.0f, 0.0f};
+
+    TEST_CHECK(scene_register_collision_couple(sc, t1, t2, &n) == CollisionCoupleStatus_Begin);
+    transform_release(t2);
+
+    // same frame, before stale couple could be removed
+    Transform *t3 = transform_make(PointTransform);
+    TEST_CHECK(scene_register_collision_couple(sc, t1, t3, &n) == CollisionCoupleStatus_Begin);
+    TEST_CHECK(scene_register_collision_couple(sc, t3, t1, &n) == CollisionCoupleStatus_Discard);
+
+    scene_refresh(sc, 0.0, NULL);
+
+    TEST_CHECK(scene_register_collision_couple(sc, t1, t3, &n) == CollisionCoupleStatus_Tick);
+
+    scene_refresh(sc, 0.0, NULL);
+
+    transform_release(t1);
+    transform_release(t3);
+    scene_free(sc);
+}
+
+#define TEST_SCENE_CALLBACKS_CAPACITY 8192
+
+typedef struct {
+    uint32_t entries[TEST_SCENE_CALLBACKS_CAPACITY]; // type, self & other IDs
+    uint32_t count;
+    uint32_t step;
+} _TestSceneCallbacks;
+
+static void _test_scene_collision_callback(CollisionCallbackType type,
+                                           Transform *self,
+                                           RigidBody *selfRb,
+                                           Transform *other,
+                                           RigidBody *otherRb,
+                                           float3 wNormal,
+                                           void *callbackData) {
+    _TestSceneCallbacks *log = (_TestSceneCallbacks *)callbackData;
+    if (log != NULL && log->count < TEST_SCENE_CALLBACKS_CAPACITY) {
+        log->entries[log->count++] = (log->step << 18) | ((uint32_t)type << 16) |
+                                     ((uint32_t)transform_get_id(self) << 8) |
+                                     (transform_get_id(other) & 0xFF);
+    }
+}
+
+static void _test_scene_steps(Scene *sc, _TestSceneCallbacks *log, const uint32_t steps) {
+    log->count = 0;
+    for (log->step = 0; log->step < steps; ++log->step) {
+        scene_step(sc, log);
+    }
+    TEST_CHECK(log->count < TEST_SCENE_CALLBACKS_CAPACITY);
+}
+
+static bool _test_scene_callbacks_equal(const _TestSceneCallbacks *a,
+                                        const _TestSceneCallbacks *b) {
+    return a->count == b->count &&
+           memcmp(a->entries, b->entries, sizeof(uint32_t) * a->count) == 0;
+}
+
+// fixed steps accumulation, then simulating again from a snapshot gives the same state and
+// fires the same collision callbacks
+void test_scene_fixed_step_snapshot(void) {
+    Scene *sc = scene_new(NULL);
+    rigidbody_set_collision_callback(_test_scene_collision_callback);
+    const float gravity = -30.0f, zero = 0.0f;
+    scene_set_constant_acceleration(sc, &zero, &gravity, &zero);
+    scene_set_fixed_step(sc, 1.0 / 60.0);
+
+    Transform *ground = transform_make(PointTransform);
+    RigidBody *rb;
+    transform_ensure_rigidbody(ground,
+                               RigidbodyMode_Static,
+                               PHYSICS_GROUP_DEFAULT_MAP,
+                               PHYSICS_COLLIDESWITH_DEFAULT_MAP,
+                               &rb);
+    const Box groundCollider = {{-50.0f, -1.0f, -50.0f}, {50.0f, 0.0f, 50.0f}};
+    rigidbody_set_collider(rb, &groundCollider, true);
+    transform_set_parent(ground, scene_get_root(sc), false);
+
+    // boxes thrown towards each other
+    Transform *bodies[8];
+    const Box collider = {{-0.5f, 0.0f, -0.5f}, {0.5f, 1.0f, 0.5f}};
+    for (int i = 0; i < 8; ++i) {
+        bodies[i] = transform_make(PointTransform);
+        transform_ensure_rigidbody(bodies[i],
+                                   RigidbodyMode_Dynamic,
+                                   PHYSICS_GROUP_DEFAULT_OBJECT,
+                                   PHYSICS_GROUP_DEFAULT_MAP | PHYSICS_GROUP_DEFAULT_OBJECT,
+                                   &rb);
+        rigidbody_set_collider(rb, &collider, true);
+        rigidbody_toggle_collision_callback(rb, CollisionCallbackType_Begin, true);
+        rigidbody_toggle_collision_callback(rb, CollisionCallbackType_Tick, true);
+        rigidbody_toggle_collision_callback(rb, CollisionCallbackType_End, true);
+        const float3 velocity = {i % 2 == 0 ? 4.0f : -4.0f, 2.0f, 0.3f * (float)i};
+        rigidbody_set_velocity(rb, &velocity);
+        transform_set_position(bodies[i],
+                               (float)(i % 4) * 1.5f,
+                               1.0f + (float)(i / 4) * 2.0f,
+                               0.0f);
+        transform_set_parent(bodies[i], scene_get_root(sc), false);
+    }
+
+    // time accumulated until a step fits
+    scene_refresh(sc, 0.01, NULL);
+    TEST_CHECK(scene_get_frame(sc) == 0);
+    scene_refresh(sc, 0.03, NULL);
+    TEST_CHECK(scene_get_frame(sc) == 2);
+    TEST_CHECK(fabsf(scene_get_fixed_step_alpha(sc) - 0.4f) < 0.001f);
+    float3 previous = float3_zero;
+    for (int i = 0; i < 5; ++i) {
+        previous = *transform_get_position(bodies[7], true);
+        scene_refresh(sc, 1.0 / 60.0, NULL);
+    }
+    TEST_CHECK(scene_get_frame(sc) == 7);
+
+    // between previous & current position
+    float3 p, expected = *transform_get_position(bodies[7], true);
+    float3_op_substract(&expected, &previous);
+    float3_op_scale(&expected, 0.4f);
+    float3_op_add(&expected, &previous);
+    scene_get_interpolated_position(sc, bodies[7], &p);
+    TEST_CHECK(float3_isEqual(&p, &expected, 0.001f));
+    TEST_CHECK(float3_isEqual(&p, transform_get_position(bodies[7], true), 0.001f) == false);
+    scene_get_interpolated_position(sc, ground, &p);
+    TEST_CHECK(float3_isEqual(&p, &float3_zero, EPSILON_ZERO));
+
+    _TestSceneCallbacks *logs = (_TestSceneCallbacks *)malloc(sizeof(_TestSceneCallbacks) * 3);
+    TEST_ASSERT(logs != NULL);
+
+    // size varies with ongoing collision couples
+    const size_t size = scene_write_snapshot(sc, NULL, 0), capacity = size * 2;
+    uint8_t *snapshot = (uint8_t *)malloc(size);
+    uint8_t *after = (uint8_t *)malloc(capacity);
+    uint8_t *again = (uint8_t *)malloc(capacity);
+    TEST_ASSERT(snapshot != NULL && after != NULL && again != NULL);
+    TEST_CHECK(scene_write_snapshot(sc, snapshot, size) == size);
+
+    _test_scene_steps(sc, &logs[0], 90);
+    TEST_CHECK(logs[0].count > 0);
+    const size_t afterSize = scene_write_snapshot(sc, after, capacity);
+    TEST_CHECK(afterSize <= capacity);
+    TEST_CHECK(afterSize != size || memcmp(snapshot, after, size) != 0);
+    for (int i = 0; i < 8; ++i) {
+        TEST_CHECK(transform_get_position(bodies[i], true)->y > -0.01f);
+    }
+
+    TEST_CHECK(scene_restore_snapshot(sc, snapshot, size));
+    TEST_CHECK(scene_get_frame(sc) == 7);
+    _test_scene_steps(sc, &logs[1], 90);
+    TEST_CHECK(scene_write_snapshot(sc, again, capacity) == afterSize);
+    TEST_CHECK(memcmp(after, again, afterSize) == 0);
+    TEST_CHECK(_test_scene_callbacks_equal(&logs[0], &logs[1]));
+
+    // snapshot taken while couples are ongoing, restored after they ended: callbacks must not
+    // begin again, nor end twice
+    TEST_CHECK(scene_restore_snapshot(sc, snapshot, size));
+    _test_scene_steps(sc, &logs[0], 20);
+    const size_t midSize = scene_write_snapshot(sc, NULL, 0);
+    TEST_CHECK(midSize > size);
+    uint8_t *mid = (uint8_t *)malloc(midSize);
+    TEST_ASSERT(mid != NULL);
+    TEST_CHECK(scene_write_snapshot(sc, mid, midSize) == midSize);
+    _test_scene_steps(sc, &logs[1], 70);
+    TEST_CHECK(scene_restore_snapshot(sc, mid, midSize));
+    _test_scene_steps(sc, &logs[2], 70);
+    TEST_CHECK(logs[1].count > 0);
+    TEST_CHECK(_test_scene_callbacks_equal(&logs[1], &logs[2]));
+    free(mid);
+    free(logs);
+
+    // invalid snapshots
+    TEST_CHECK(scene_restore_snapshot(sc, snapshot, size - 1) == false);
+    snapshot[0] = 0;
+    TEST_CHECK(scene_restore_snapshot(sc, snapshot, size) == false);
+
+    free(snapshot);
+    free(after);
+    free(again);
+    for (int i = 0; i < 8; ++i) {
+        transform_release(bodies[i]);
+    }
+    transform_release(ground);
+    scene_free(sc);
+    rigidbody_set_collision_callback(NULL);
+}
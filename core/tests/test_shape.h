@@ -9,9 +9,11 @@
 
 #include "acutest.h"
 
+#include "chunk.h"
 #include "scene.h"
 #include "shape.h"
 #include "transform.h"
+#include "vertextbuffer.h"
 
 // functions that are NOT tested:
 // shape_add_buffer
@@ -128,14 +130,9 @@
 // shape_compute_baked_lighting_replaced_block
 // shape_is_lua_mutable
 // shape_set_lua_mutable
-// shape_history_setEnabled
 // shape_history_getEnabled
 // shape_history_setKeepTransactionPending
 // shape_history_getKeepTransactionPending
-// shape_history_canUndo
-// shape_history_canRedo
-// shape_history_undo
-// shape_history_redo
 // shape_enableAnimations
 // shape_disableAnimations
 // shape_getIgnoreAnimations
@@ -551,3 +548,427 @@ void test_shape_addblock_3(void) {
     shape_free((Shape *const)sh);
     scene_free(sc);
 }
+
+// Add a chunk filled beforehand and check blocks, counts, bounding box & palette usage
+void test_shape_add_chunk(void) {
+    Shape *sh = shape_make();
+    ColorAtlas *atlas = color_atlas_new();
+    shape_set_palette(sh, color_palette_new(atlas), false);
+    ColorPalette *palette = shape_get_palette(sh);
+    SHAPE_COLOR_INDEX_INT_T red, green;
+    TEST_CHECK(color_palette_check_and_add_color(palette, (RGBAColor){255, 0, 0, 255}, &red, false));
+    TEST_CHECK(
+        color_palette_check_and_add_color(palette, (RGBAColor){0, 255, 0, 255}, &green, false));
+
+    Block *blocks = (Block *)malloc(sizeof(Block) * CHUNK_SIZE_CUBE);
+    memset(blocks, SHAPE_COLOR_INDEX_AIR_BLOCK, sizeof(Block) * CHUNK_SIZE_CUBE);
+    blocks[1 + 2 * CHUNK_SIZE + 3 * CHUNK_SIZE_SQR].colorIndex = red;
+    blocks[4 + 5 * CHUNK_SIZE + 6 * CHUNK_SIZE_SQR].colorIndex = green;
+    blocks[4 + 6 * CHUNK_SIZE + 6 * CHUNK_SIZE_SQR].colorIndex = green;
+
+    Chunk *chunk = chunk_new((SHAPE_COORDS_INT3_T){CHUNK_SIZE, 0, CHUNK_SIZE});
+    TEST_CHECK(chunk_set_blocks(chunk, blocks) == 3);
+    TEST_CHECK(shape_add_chunk(sh, chunk));
+
+    TEST_CHECK(shape_get_nb_blocks(sh) == 3);
+    TEST_CHECK(shape_get_nb_chunks(sh) == 1);
+    TEST_CHECK(color_palette_get_color_use_count(palette, red) == 1);
+    TEST_CHECK(color_palette_get_color_use_count(palette, green) == 2);
+
+    const Block *b = shape_get_block(sh, CHUNK_SIZE + 4, 6, CHUNK_SIZE + 6);
+    TEST_CHECK(b != NULL && b->colorIndex == green);
+
+    const Box box = shape_get_model_aabb(sh);
+    TEST_CHECK(box.min.x == CHUNK_SIZE + 1 && box.min.y == 2 && box.min.z == CHUNK_SIZE + 3);
+    TEST_CHECK(box.max.x == CHUNK_SIZE + 5 && box.max.y == 7 && box.max.z == CHUNK_SIZE + 7);
+
+    // a second chunk at the same position is refused
+    Chunk *duplicate = chunk_new((SHAPE_COORDS_INT3_T){CHUNK_SIZE, 0, CHUNK_SIZE});
+    TEST_CHECK(shape_add_chunk(sh, duplicate) == false);
+    chunk_free(duplicate, false);
+
+    // blocks added after can go in the same chunk
+    TEST_CHECK(shape_add_block(sh, red, CHUNK_SIZE, 0, CHUNK_SIZE, false));
+    TEST_CHECK(shape_get_nb_chunks(sh) == 1);
+    TEST_CHECK(color_palette_get_color_use_count(palette, red) == 2);
+
+    // removing a chunk on the side of the bounding box shrinks it
+    TEST_CHECK(shape_add_block(sh, red, 1, 1, 1, false));
+    TEST_CHECK(shape_get_nb_chunks(sh) == 2);
+    TEST_CHECK(shape_remove_chunk(sh, (SHAPE_COORDS_INT3_T){1, 0, 1}));
+    TEST_CHECK(shape_get_nb_blocks(sh) == 1);
+    const Box shrunk = shape_get_model_aabb(sh);
+    TEST_CHECK(shrunk.min.x == 1 && shrunk.min.y == 1 && shrunk.min.z == 1);
+    TEST_CHECK(shrunk.max.x == 2 && shrunk.max.y == 2 && shrunk.max.z == 2);
+    TEST_CHECK(shape_remove_chunk(sh, (SHAPE_COORDS_INT3_T){1, 0, 1}) == false);
+
+    free(blocks);
+    shape_free(sh);
+    color_atlas_free(atlas);
+}
+
+// history records an edit across several chunks, undo & redo restore blocks, colors & bounding box
+void test_shape_history(void) {
+    Shape *sh = shape_make_2(true);
+    ColorAtlas *atlas = color_atlas_new();
+    shape_set_palette(sh, color_palette_new(atlas), false);
+    ColorPalette *palette = shape_get_palette(sh);
+    SHAPE_COLOR_INDEX_INT_T red, green;
+    TEST_CHECK(
+        color_palette_check_and_add_color(palette, (RGBAColor){255, 0, 0, 255}, &red, false));
+    TEST_CHECK(
+        color_palette_check_and_add_color(palette, (RGBAColor){0, 255, 0, 255}, &green, false));
+    shape_history_setEnabled(sh, true);
+
+    // 1st action: 40x3x20 red blocks, centered on origin
+    for (SHAPE_COORDS_INT_T z = -10; z < 10; ++z) {
+        for (SHAPE_COORDS_INT_T y = 0; y < 3; ++y) {
+            for (SHAPE_COORDS_INT_T x = -20; x < 20; ++x) {
+                shape_add_block_as_transaction(sh, NULL, red, x, y, z);
+            }
+        }
+    }
+    shape_apply_current_transaction(sh, false);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 2400);
+
+    // 2nd action: paint a row green, remove another one
+    for (SHAPE_COORDS_INT_T x = -20; x < 20; ++x) {
+        shape_paint_block_as_transaction(sh, green, x, 1, 0);
+        shape_remove_block_as_transaction(sh, NULL, x, 2, 5);
+    }
+    shape_apply_current_transaction(sh, false);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 2360);
+    TEST_CHECK(color_palette_get_color_use_count(palette, green) == 40);
+    TEST_CHECK(color_palette_get_color_use_count(palette, red) == 2320);
+
+    TEST_CHECK(shape_history_canUndo(sh));
+    shape_history_undo(sh);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 2400);
+    TEST_CHECK(color_palette_get_color_use_count(palette, green) == 0);
+    TEST_CHECK(color_palette_get_color_use_count(palette, red) == 2400);
+    const Block *b = shape_get_block(sh, 7, 1, 0);
+    TEST_CHECK(b != NULL && b->colorIndex == red);
+    b = shape_get_block(sh, -3, 2, 5);
+    TEST_CHECK(b != NULL && b->colorIndex == red);
+
+    shape_history_undo(sh);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 0);
+    TEST_CHECK(color_palette_get_color_use_count(palette, red) == 0);
+    TEST_CHECK(shape_history_canUndo(sh) == false);
+    TEST_CHECK(shape_history_canRedo(sh));
+
+    shape_history_redo(sh);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 2400);
+    Box box = shape_get_model_aabb(sh);
+    TEST_CHECK(box.min.x == -20.0f && box.min.y == 0.0f && box.min.z == -10.0f);
+    TEST_CHECK(box.max.x == 20.0f && box.max.y == 3.0f && box.max.z == 10.0f);
+
+    shape_history_redo(sh);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 2360);
+    TEST_CHECK(color_palette_get_color_use_count(palette, green) == 40);
+    b = shape_get_block(sh, -3, 2, 5);
+    TEST_CHECK(b == NULL || b->colorIndex == SHAPE_COLOR_INDEX_AIR_BLOCK);
+    TEST_CHECK(shape_history_canRedo(sh) == false);
+
+    shape_free(sh);
+    color_atlas_free(atlas);
+}
+
+// a transaction kept pending & applied several times is stored as a single history action
+void test_shape_history_keep_pending(void) {
+    Shape *sh = shape_make_2(true);
+    ColorAtlas *atlas = color_atlas_new();
+    shape_set_palette(sh, color_palette_new(atlas), false);
+    ColorPalette *palette = shape_get_palette(sh);
+    SHAPE_COLOR_INDEX_INT_T red, green;
+    TEST_CHECK(
+        color_palette_check_and_add_color(palette, (RGBAColor){255, 0, 0, 255}, &red, false));
+    TEST_CHECK(
+        color_palette_check_and_add_color(palette, (RGBAColor){0, 255, 0, 255}, &green, false));
+    shape_history_setEnabled(sh, true);
+
+    shape_add_block_as_transaction(sh, NULL, red, 0, 0, 0);
+    shape_add_block_as_transaction(sh, NULL, red, 1, 0, 0);
+    shape_apply_current_transaction(sh, true);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 2);
+
+    // amends an already applied change
+    shape_paint_block_as_transaction(sh, green, 0, 0, 0);
+    shape_add_block_as_transaction(sh, NULL, green, 2, 0, 0);
+    shape_apply_current_transaction(sh, false);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 3);
+    TEST_CHECK(color_palette_get_color_use_count(palette, green) == 2);
+    TEST_CHECK(color_palette_get_color_use_count(palette, red) == 1);
+
+    shape_history_undo(sh);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 0);
+    TEST_CHECK(color_palette_get_color_use_count(palette, green) == 0);
+    TEST_CHECK(color_palette_get_color_use_count(palette, red) == 0);
+    TEST_CHECK(shape_history_canUndo(sh) == false);
+
+    shape_history_redo(sh);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 3);
+    const Block *b = shape_get_block(sh, 0, 0, 0);
+    TEST_CHECK(b != NULL && b->colorIndex == green);
+    b = shape_get_block(sh, 1, 0, 0);
+    TEST_CHECK(b != NULL && b->colorIndex == red);
+
+    shape_free(sh);
+    color_atlas_free(atlas);
+}
+
+// region operations change blocks chunk by chunk, each of them stored as a single history action
+void test_shape_fill_box(void) {
+    Shape *sh = shape_make_2(true);
+    ColorAtlas *atlas = color_atlas_new();
+    shape_set_palette(sh, color_palette_new(atlas), false);
+    ColorPalette *palette = shape_get_palette(sh);
+    SHAPE_COLOR_INDEX_INT_T red, green;
+    TEST_CHECK(
+        color_palette_check_and_add_color(palette, (RGBAColor){255, 0, 0, 255}, &red, false));
+    TEST_CHECK(
+        color_palette_check_and_add_color(palette, (RGBAColor){0, 255, 0, 255}, &green, false));
+    shape_history_setEnabled(sh, true);
+
+    // 40x3x20 red blocks, centered on origin
+    const SHAPE_COORDS_INT3_T min = {-20, 0, -10}, max = {20, 3, 10};
+    TEST_CHECK(shape_fill_box(sh, NULL, red, min, max) == 2400);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 2400);
+    TEST_CHECK(color_palette_get_color_use_count(palette, red) == 2400);
+    TEST_CHECK(shape_fill_box(sh, NULL, red, min, max) == 0);
+
+    TEST_CHECK(shape_history_canUndo(sh));
+    shape_history_undo(sh);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 0);
+    TEST_CHECK(shape_history_canUndo(sh) == false);
+    shape_history_redo(sh);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 2400);
+    Box box = shape_get_model_aabb(sh);
+    TEST_CHECK(box.min.x == -20.0f && box.min.y == 0.0f && box.min.z == -10.0f);
+    TEST_CHECK(box.max.x == 20.0f && box.max.y == 3.0f && box.max.z == 10.0f);
+
+    // paint half of it green
+    const SHAPE_COORDS_INT3_T half = {0, 0, -10};
+    TEST_CHECK(shape_replace_color_in_box(sh, NULL, red, green, half, max) == 1200);
+    TEST_CHECK(color_palette_get_color_use_count(palette, red) == 1200);
+    TEST_CHECK(color_palette_get_color_use_count(palette, green) == 1200);
+    const Block *b = shape_get_block(sh, 5, 1, 3);
+    TEST_CHECK(b != NULL && b->colorIndex == green);
+
+    // remove top layer
+    TEST_CHECK(shape_fill_box(sh,
+                              NULL,
+                              SHAPE_COLOR_INDEX_AIR_BLOCK,
+                              (SHAPE_COORDS_INT3_T){-20, 2, -10},
+                              max) == 800);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 1600);
+    TEST_CHECK(color_palette_get_color_use_count(palette, green) == 800);
+    box = shape_get_model_aabb(sh);
+    TEST_CHECK(box.max.y == 2.0f);
+    b = shape_get_block(sh, -20, 2, -10);
+    TEST_CHECK(b == NULL || b->colorIndex == SHAPE_COLOR_INDEX_AIR_BLOCK);
+
+    shape_history_undo(sh);
+    TEST_CHECK(shape_get_nb_blocks(sh) == 2400);
+    box = shape_get_model_aabb(sh);
+    TEST_CHECK(box.max.y == 3.0f);
+    shape_history_undo(sh);
+    TEST_CHECK(color_palette_get_color_use_count(palette, red) == 2400);
+    TEST_CHECK(color_palette_get_color_use_count(palette, green) == 0);
+
+    shape_free(sh);
+    color_atlas_free(atlas);
+}
+
+// copied colors are remapped to destination palette, source air blocks are skipped
+void test_shape_copy_box_from(void) {
+    ColorAtlas *atlas = color_atlas_new();
+    Shape *src = shape_make_2(true);
+    shape_set_palette(src, color_palette_new(atlas), false);
+    Shape *dst = shape_make_2(true);
+    shape_set_palette(dst, color_palette_new(atlas), false);
+
+    SHAPE_COLOR_INDEX_INT_T srcBlue, dstRed, dstBlue;
+    TEST_CHECK(color_palette_check_and_add_color(shape_get_palette(src),
+                                                 (RGBAColor){0, 0, 255, 255},
+                                                 &srcBlue,
+                                                 false));
+    TEST_CHECK(color_palette_check_and_add_color(shape_get_palette(dst),
+                                                 (RGBAColor){255, 0, 0, 255},
+                                                 &dstRed,
+                                                 false));
+
+    // 4x4x4 blue cube, with a hole
+    TEST_CHECK(shape_fill_box(src, NULL, srcBlue, coords3_zero, (SHAPE_COORDS_INT3_T){4, 4, 4}) ==
+               64);
+    TEST_CHECK(shape_remove_block(src, 1, 1, 1));
+
+    // destination already has a red block where the hole lands
+    shape_add_block(dst, dstRed, 31, -4, 31, false);
+
+    const SHAPE_COORDS_INT3_T origin = {30, -5, 30};
+    TEST_CHECK(shape_copy_box_from(dst,
+                                   NULL,
+                                   src,
+                                   coords3_zero,
+                                   (SHAPE_COORDS_INT3_T){4, 4, 4},
+                                   origin) == 63);
+    TEST_CHECK(shape_get_nb_blocks(dst) == 64);
+    TEST_CHECK(color_palette_find(shape_get_palette(dst), (RGBAColor){0, 0, 255, 255}, &dstBlue));
+    TEST_CHECK(dstBlue != srcBlue);
+    TEST_CHECK(color_palette_get_color_use_count(shape_get_palette(dst), dstBlue) == 63);
+    const Block *b = shape_get_block(dst, 33, -2, 33);
+    TEST_CHECK(b != NULL && b->colorIndex == dstBlue);
+    b = shape_get_block(dst, 31, -4, 31);
+    TEST_CHECK(b != NULL && b->colorIndex == dstRed);
+
+    // overlapping copy within the same shape reads blocks before writing them
+    TEST_CHECK(shape_copy_box_from(dst,
+                                   NULL,
+                                   dst,
+                                   origin,
+                                   (SHAPE_COORDS_INT3_T){34, -1, 34},
+                                   (SHAPE_COORDS_INT3_T){32, -5, 30}) == 33);
+    b = shape_get_block(dst, 33, -4, 31);
+    TEST_CHECK(b != NULL && b->colorIndex == dstRed);
+    b = shape_get_block(dst, 35, -5, 30);
+    TEST_CHECK(b != NULL && b->colorIndex == dstBlue);
+    TEST_CHECK(shape_get_nb_blocks(dst) == 96);
+
+    shape_free(src);
+    shape_free(dst);
+    color_atlas_free(atlas);
+}
+
+// vertices written for given chunk & LOD level, following its mem areas
+static uint32_t _test_shape_lod_get_vertices(const Chunk *c,
+                                             uint8_t lod,
+                                             VertexAttributes *out,
+                                             uint32_t max) {
+    uint32_t count = 0;
+    VertexBufferMemArea *vbma = (VertexBufferMemArea *)chunk_get_lod_vbma(c, lod, false);
+    while (vbma != NULL) {
+        const VertexAttributes *v = vertex_buffer_get_draw_buffer(
+            vertex_buffer_mem_area_get_vb(vbma));
+        const uint32_t start = vertex_buffer_mem_area_get_start_idx(vbma);
+        for (uint32_t i = 0; i < vertex_buffer_mem_area_get_count(vbma) && count < max; ++i) {
+            out[count++] = v[start + i];
+        }
+        vbma = vertex_buffer_mem_area_get_group_next(vbma);
+    }
+    return count;
+}
+
+static bool _test_shape_lod_same_point(const VertexAttributes *a, const VertexAttributes *b) {
+    return a->x == b->x && a->y == b->y && a->z == b->z;
+}
+
+// closed mesh: each quad edge a->b is matched by as many b->a edges, from adjacent quads
+static bool _test_shape_lod_is_watertight(const VertexAttributes *v, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const VertexAttributes *a = &v[i];
+        const VertexAttributes *b = &v[i % 4 == 3 ? i - 3 : i + 1];
+        int balance = 0;
+        for (uint32_t j = 0; j < count; ++j) {
+            const VertexAttributes *c = &v[j];
+            const VertexAttributes *d = &v[j % 4 == 3 ? j - 3 : j + 1];
+            if (_test_shape_lod_same_point(a, c) && _test_shape_lod_same_point(b, d)) {
+                --balance;
+            } else if (_test_shape_lod_same_point(a, d) && _test_shape_lod_same_point(b, c)) {
+                ++balance;
+            }
+        }
+        if (balance != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// coarser meshes from 2x2x2 & 4x4x4 cells, each chunk closed at any level so that neighbors drawn
+// at different levels never leave cracks, level selected by distance to LOD camera position
+void test_shape_lods(void) {
+    Shape *sh = shape_make_2(true);
+    ColorAtlas *atlas = color_atlas_new();
+    shape_set_palette(sh, color_palette_new(atlas), false);
+    SHAPE_COLOR_INDEX_INT_T red;
+    TEST_CHECK(color_palette_check_and_add_color(shape_get_palette(sh),
+                                                 (RGBAColor){255, 0, 0, 255},
+                                                 &red,
+                                                 false));
+
+    // 2 chunks along x
+    TEST_CHECK(shape_fill_box(sh,
+                              NULL,
+                              red,
+                              coords3_zero,
+                              (SHAPE_COORDS_INT3_T){2 * CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE}) ==
+               2 * CHUNK_SIZE_CUBE);
+    shape_set_lods_enabled(sh, true);
+    shape_refresh_all_vertices(sh);
+
+    Chunk *c1 = (Chunk *)index3d_get(shape_get_chunks(sh), 0, 0, 0);
+    Chunk *c2 = (Chunk *)index3d_get(shape_get_chunks(sh), 1, 0, 0);
+    TEST_ASSERT(c1 != NULL && c2 != NULL);
+
+    const uint32_t max = 6 * CHUNK_SIZE_SQR * DRAWBUFFER_VERTICES_PER_FACE;
+    VertexAttributes *v = (VertexAttributes *)malloc(sizeof(VertexAttributes) * max);
+
+    // level 0 culls faces between chunks, coarser levels keep them
+    TEST_CHECK(_test_shape_lod_get_vertices(c1, 0, v, max) ==
+               5 * CHUNK_SIZE_SQR * DRAWBUFFER_VERTICES_PER_FACE);
+    for (uint8_t lod = 1; lod < CHUNK_LOD_COUNT; ++lod) {
+        const uint32_t cells = (uint32_t)((CHUNK_SIZE >> lod) * (CHUNK_SIZE >> lod));
+        uint32_t count = _test_shape_lod_get_vertices(c1, lod, v, max);
+        TEST_CHECK(count == 6 * cells * DRAWBUFFER_VERTICES_PER_FACE);
+        TEST_CHECK(_test_shape_lod_is_watertight(v, count));
+        count = _test_shape_lod_get_vertices(c2, lod, v, max);
+        TEST_CHECK(count == 6 * cells * DRAWBUFFER_VERTICES_PER_FACE);
+        TEST_CHECK(_test_shape_lod_is_watertight(v, count));
+        TEST_CHECK(v[0].x >= (float)CHUNK_SIZE);
+    }
+
+    // carve a staircase, a notch of one LOD 1 cell & a single block hole in c1, staircase keeps
+    // the same amount of faces, notch adds 4, hole is within a cell that stays solid
+    for (SHAPE_COORDS_INT_T x = 0; x < CHUNK_SIZE; ++x) {
+        const SHAPE_COORDS_INT3_T min = {x, (SHAPE_COORDS_INT_T)(CHUNK_SIZE - 1 - x / 2), 0};
+        const SHAPE_COORDS_INT3_T max = {(SHAPE_COORDS_INT_T)(x + 1), CHUNK_SIZE, CHUNK_SIZE - 3};
+        TEST_CHECK(shape_fill_box(sh, NULL, SHAPE_COLOR_INDEX_AIR_BLOCK, min, max) > 0);
+    }
+    TEST_CHECK(shape_fill_box(sh,
+                              NULL,
+                              SHAPE_COLOR_INDEX_AIR_BLOCK,
+                              (SHAPE_COORDS_INT3_T){4, 2, CHUNK_SIZE - 2},
+                              (SHAPE_COORDS_INT3_T){6, 4, CHUNK_SIZE}) == 8);
+    TEST_CHECK(shape_remove_block(sh, 5, 5, 5));
+    shape_refresh_vertices(sh);
+    for (uint8_t lod = 1; lod < CHUNK_LOD_COUNT; ++lod) {
+        const uint32_t count = _test_shape_lod_get_vertices(c1, lod, v, max);
+        TEST_CHECK(count > 0);
+        TEST_CHECK(_test_shape_lod_is_watertight(v, count));
+    }
+    TEST_CHECK(_test_shape_lod_get_vertices(c1, 1, v, max) ==
+               (6 * 64 + 4) * DRAWBUFFER_VERTICES_PER_FACE);
+
+    // level selection
+    shape_set_lod_distance(sh, CHUNK_SIZE);
+    float3 camera = {0.0f, 8.0f, 8.0f};
+    shape_set_lod_camera_position(sh, &camera);
+    TEST_CHECK(shape_get_chunk_lod(sh, c1) == 0);
+    TEST_CHECK(shape_get_chunk_lod(sh, c2) == 1);
+    camera.x = -20.0f;
+    shape_set_lod_camera_position(sh, &camera);
+    TEST_CHECK(shape_get_chunk_lod(sh, c1) == 1);
+    TEST_CHECK(shape_get_chunk_lod(sh, c2) == CHUNK_LOD_COUNT - 1);
+
+    // disabling releases LOD buffers
+    shape_set_lods_enabled(sh, false);
+    TEST_CHECK(shape_get_chunk_lod(sh, c2) == 0);
+    TEST_CHECK(chunk_get_lod_vbma(c1, 1, false) == NULL);
+    TEST_CHECK(shape_get_first_lod_vertex_buffer(sh, 1, false) == NULL);
+    TEST_CHECK(shape_get_first_lod_vertex_buffer(sh, 0, false) != NULL);
+
+    free(v);
+    shape_free(sh);
+    color_atlas_free(atlas);
+}
@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <string.h>
+
+#include "color_atlas.h"
 #include "vertextbuffer.h"
 
 // functions that are NOT tested:
@@ -17,7 +20,6 @@
 // vertex_buffer_get_id
 // vertex_buffer_get_draw_slices
 // vertex_buffer_log_draw_slices
-// vertex_buffer_add_draw_slice
 // vertex_buffer_fill_draw_slices
 // vertex_buffer_flush_draw_slices
 // vertex_buffer_get_nb_draw_slices
@@ -25,7 +27,6 @@
 // vertex_buffer_has_room_for_new_chunk
 // vertex_buffer_log_draw_slices
 // vertex_buffer_is_fragmented
-// vertex_buffer_fill_gaps
 // vertex_buffer_mem_area_make_gap
 // vertex_buffer_mem_area_flush
 // vertex_buffer_mem_area_get_vb
@@ -155,3 +156,235 @@ void test_vertex_buffer_get_lighting_enabled(void) {
 
     vertex_buffer_set_lighting_enabled(previous_value);
 }
+
+// overlapping & adjacent draw slices are coalesced
+void test_vertex_buffer_add_draw_slice(void) {
+    VertexBuffer *vb = vertex_buffer_new_with_max_count(1000, false);
+    DoublyLinkedList *slices = vertex_buffer_get_draw_slices(vb);
+    DrawBufferWriteSlice *ws;
+
+    vertex_buffer_add_draw_slice(vb, 10, 10); // [10,19]
+    vertex_buffer_add_draw_slice(vb, 40, 10); // [40,49]
+    TEST_CHECK(vertex_buffer_get_nb_draw_slices(vb) == 2);
+
+    // overlapping the first one
+    vertex_buffer_add_draw_slice(vb, 15, 10); // [10,24]
+    TEST_CHECK(vertex_buffer_get_nb_draw_slices(vb) == 2);
+
+    // contained in the second one
+    vertex_buffer_add_draw_slice(vb, 42, 2);
+    TEST_CHECK(vertex_buffer_get_nb_draw_slices(vb) == 2);
+
+    // bridging both, adjacent to the first one
+    vertex_buffer_add_draw_slice(vb, 25, 20); // [10,49]
+    TEST_CHECK(vertex_buffer_get_nb_draw_slices(vb) == 1);
+    ws = (DrawBufferWriteSlice *)doubly_linked_list_node_pointer(doubly_linked_list_first(slices));
+    TEST_CHECK(ws->from == 10 && ws->to == 49);
+
+    vertex_buffer_flush_draw_slices(vb);
+    TEST_CHECK(vertex_buffer_get_nb_draw_slices(vb) == 0);
+
+    vertex_buffer_free(vb);
+    uint32_t id;
+    vertex_buffer_pop_destroyed_id(&id);
+}
+
+static Shape *_test_vertex_buffer_make_shape(ColorAtlas *atlas) {
+    Shape *sh = shape_make();
+    shape_set_palette(sh, color_palette_new(atlas), false);
+    SHAPE_COLOR_INDEX_INT_T color;
+    color_palette_check_and_add_color(shape_get_palette(sh),
+                                      (RGBAColor){255, 0, 0, 255},
+                                      &color,
+                                      false);
+    // sparse blocks, for several chunks per vertex buffer
+    for (SHAPE_COORDS_INT_T z = 0; z < CHUNK_SIZE * 2; ++z) {
+        for (SHAPE_COORDS_INT_T y = 0; y < CHUNK_SIZE; ++y) {
+            for (SHAPE_COORDS_INT_T x = 0; x < CHUNK_SIZE * 4; ++x) {
+                if (x % 4 == 0 && y % 4 == 0 && z % 4 == 0) {
+                    shape_add_block(sh, color, x, y, z, false);
+                }
+            }
+        }
+    }
+    shape_refresh_vertices(sh);
+
+    // empty every other chunk, to leave gaps in the middle of the vertex buffer
+    for (SHAPE_COORDS_INT_T z = 0; z < CHUNK_SIZE * 2; ++z) {
+        for (SHAPE_COORDS_INT_T y = 0; y < CHUNK_SIZE; ++y) {
+            for (SHAPE_COORDS_INT_T x = 0; x < CHUNK_SIZE * 4; ++x) {
+                if (x % 4 == 0 && y % 4 == 0 && z % 4 == 0 &&
+                    (x / CHUNK_SIZE + z / CHUNK_SIZE) % 2 == 0) {
+                    shape_remove_block(sh, x, y, z);
+                }
+            }
+        }
+    }
+    return sh;
+}
+
+static bool _test_vertex_buffer_gaps_are_cleared(const Shape *sh) {
+    static const VertexAttributes zero = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    const VertexBuffer *vb = shape_get_first_vertex_buffer(sh, false);
+    while (vb != NULL) {
+        VertexBufferMemArea *vbma = vertex_buffer_get_first_mem_area(vb);
+        while (vbma != NULL) {
+            if (vertex_buffer_mem_area_get_chunk(vbma) == NULL) {
+                const VertexAttributes *v = vertex_buffer_get_draw_buffer(vb) +
+                                            vertex_buffer_mem_area_get_start_idx(vbma);
+                for (uint32_t i = 0; i < vertex_buffer_mem_area_get_count(vbma); ++i) {
+                    if (memcmp(&v[i], &zero, sizeof(VertexAttributes)) != 0) {
+                        return false;
+                    }
+                }
+            }
+            vbma = vertex_buffer_mem_area_get_global_next(vbma);
+        }
+        vb = vertex_buffer_get_next(vb);
+    }
+    return true;
+}
+
+static bool _test_vertex_buffer_is_fragmented(const Shape *sh) {
+    const VertexBuffer *vb = shape_get_first_vertex_buffer(sh, false);
+    while (vb != NULL) {
+        if (vertex_buffer_is_fragmented(vb)) {
+            return true;
+        }
+        vb = vertex_buffer_get_next(vb);
+    }
+    return false;
+}
+
+static uint32_t _test_vertex_buffer_count(const Shape *sh) {
+    uint32_t count = 0;
+    const VertexBuffer *vb = shape_get_first_vertex_buffer(sh, false);
+    while (vb != NULL) {
+        count += vertex_buffer_get_count(vb);
+        vb = vertex_buffer_get_next(vb);
+    }
+    return count;
+}
+
+static int _test_vertex_buffer_compare(const void *a, const void *b) {
+    return memcmp(a, b, sizeof(VertexAttributes));
+}
+
+// sorted copy of all vertices of the shape, layout can differ while vertices must be the same
+static VertexAttributes *_test_vertex_buffer_sorted_vertices(const Shape *sh, uint32_t count) {
+    VertexAttributes *vertices = (VertexAttributes *)malloc(sizeof(VertexAttributes) * count);
+    uint32_t n = 0;
+    const VertexBuffer *vb = shape_get_first_vertex_buffer(sh, false);
+    while (vb != NULL && n + vertex_buffer_get_count(vb) <= count) {
+        memcpy(vertices + n,
+               vertex_buffer_get_draw_buffer(vb),
+               sizeof(VertexAttributes) * vertex_buffer_get_count(vb));
+        n += vertex_buffer_get_count(vb);
+        vb = vertex_buffer_get_next(vb);
+    }
+    qsort(vertices, n, sizeof(VertexAttributes), _test_vertex_buffer_compare);
+    return vertices;
+}
+
+// gaps are filled over several refreshes when the compaction budget is small,
+// remaining gaps being zeroed & uploaded in the meantime
+void test_vertex_buffer_fill_gaps_with_budget(void) {
+    const uint32_t previousBudget = vertex_buffer_get_compaction_budget();
+    ColorAtlas *atlas1 = color_atlas_new();
+    ColorAtlas *atlas2 = color_atlas_new();
+
+    vertex_buffer_set_compaction_budget(UINT32_MAX);
+    Shape *immediate = _test_vertex_buffer_make_shape(atlas1);
+    shape_refresh_vertices(immediate);
+    TEST_CHECK(_test_vertex_buffer_is_fragmented(immediate) == false);
+
+    vertex_buffer_set_compaction_budget(500);
+    Shape *incremental = _test_vertex_buffer_make_shape(atlas2);
+    shape_refresh_vertices(incremental);
+    TEST_CHECK(_test_vertex_buffer_is_fragmented(incremental));
+    TEST_CHECK(_test_vertex_buffer_gaps_are_cleared(incremental));
+
+    int refreshes = 1;
+    while (_test_vertex_buffer_is_fragmented(incremental) && refreshes < 1000) {
+        shape_refresh_vertices(incremental);
+        TEST_CHECK(_test_vertex_buffer_gaps_are_cleared(incremental));
+        ++refreshes;
+    }
+    TEST_CHECK(refreshes > 1);
+    TEST_CHECK(_test_vertex_buffer_is_fragmented(incremental) == false);
+    const uint32_t count = _test_vertex_buffer_count(immediate);
+    TEST_CHECK(count > 0);
+    TEST_CHECK(count == _test_vertex_buffer_count(incremental));
+    VertexAttributes *v1 = _test_vertex_buffer_sorted_vertices(immediate, count);
+    VertexAttributes *v2 = _test_vertex_buffer_sorted_vertices(incremental, count);
+    TEST_CHECK(memcmp(v1, v2, sizeof(VertexAttributes) * count) == 0);
+    free(v1);
+    free(v2);
+
+    vertex_buffer_set_compaction_budget(previousBudget);
+    shape_free(immediate);
+    shape_free(incremental);
+    color_atlas_free(atlas1);
+    color_atlas_free(atlas2);
+}
+
+static uint32_t _test_vertex_buffer_pop_dirty_bytes(VertexBuffer *vb, uint32_t *nbRanges) {
+    VertexBufferRange ranges[4];
+    uint32_t bytes = 0, n;
+    *nbRanges = 0;
+    while ((n = vertex_buffer_pop_dirty_ranges(vb, ranges, 4)) > 0) {
+        for (uint32_t i = 0; i < n; ++i) {
+            // ranges are sorted & merged
+            TEST_CHECK(i == 0 || ranges[i].offset > ranges[i - 1].offset + ranges[i - 1].size);
+            bytes += ranges[i].size;
+        }
+        *nbRanges += n;
+    }
+    return bytes;
+}
+
+// only modified vertices are reported as dirty
+void test_vertex_buffer_pop_dirty_ranges(void) {
+    ColorAtlas *atlas = color_atlas_new();
+    Shape *sh = shape_make();
+    shape_set_palette(sh, color_palette_new(atlas), false);
+    SHAPE_COLOR_INDEX_INT_T red, green;
+    ColorPalette *palette = shape_get_palette(sh);
+    color_palette_check_and_add_color(palette, (RGBAColor){255, 0, 0, 255}, &red, false);
+    color_palette_check_and_add_color(palette, (RGBAColor){0, 255, 0, 255}, &green, false);
+    for (SHAPE_COORDS_INT_T z = 0; z < 8; z += 2) {
+        for (SHAPE_COORDS_INT_T y = 0; y < 8; y += 2) {
+            for (SHAPE_COORDS_INT_T x = 0; x < 8; x += 2) {
+                shape_add_block(sh, red, x, y, z, false);
+            }
+        }
+    }
+    shape_refresh_vertices(sh);
+
+    VertexBuffer *vb = shape_get_first_vertex_buffer(sh, false);
+    uint32_t nbRanges;
+    const uint32_t count = vertex_buffer_get_count(vb);
+    TEST_CHECK(count == 64 * 6 * DRAWBUFFER_VERTICES_PER_FACE);
+    // everything written for the first time, in a single range
+    TEST_CHECK(_test_vertex_buffer_pop_dirty_bytes(vb, &nbRanges) ==
+               count * DRAWBUFFER_VERTICES_BYTES);
+    TEST_CHECK(nbRanges == 1);
+    TEST_CHECK(vertex_buffer_get_nb_dirty_ranges(vb) == 0);
+
+    // chunk re-meshed with the same faces
+    shape_add_block(sh, red, 1, 1, 1, false);
+    shape_remove_block(sh, 1, 1, 1);
+    shape_refresh_vertices(sh);
+    TEST_CHECK(vertex_buffer_get_count(vb) == count);
+    TEST_CHECK(_test_vertex_buffer_pop_dirty_bytes(vb, &nbRanges) == 0);
+
+    // only the faces of the painted block are reported
+    shape_paint_block(sh, green, 4, 4, 4);
+    shape_refresh_vertices(sh);
+    TEST_CHECK(_test_vertex_buffer_pop_dirty_bytes(vb, &nbRanges) ==
+               6 * DRAWBUFFER_VERTICES_PER_FACE * DRAWBUFFER_VERTICES_BYTES);
+    TEST_CHECK(nbRanges == 1);
+
+    shape_free(sh);
+    color_atlas_free(atlas);
+}
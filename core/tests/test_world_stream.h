@@ -0,0 +1,88 @@
+// -------------------------------------------------------------
+//  Cubzh Core Unit Tests
+//  test_world_stream.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#include <stdio.h>
+
+#include "color_palette.h"
+#include "world_stream.h"
+
+// one block at the bottom corner of each chunk, colored by world chunk x coordinate
+static void _test_world_stream_generate(const int3 coords, Block *blocks, void *userdata) {
+    (void)userdata;
+    blocks[0].colorIndex = (SHAPE_COLOR_INDEX_INT_T)(coords.x & 7);
+}
+
+static void _test_world_stream_wait(WorldStream *ws) {
+    world_stream_update(ws);
+    while (world_stream_get_nb_pending_chunks(ws) > 0) {
+        world_stream_flush(ws);
+        world_stream_update(ws);
+    }
+}
+
+// chunks paged in around a focus point beyond int16 coordinates, evicted when it moves away,
+// modified chunks written to region files & loaded back
+void test_world_stream_load_evict(void) {
+    Shape *s = shape_make_2(true);
+    shape_set_palette(s, color_palette_new(NULL), false);
+    SHAPE_COLOR_INDEX_INT_T entry;
+    for (uint8_t i = 0; i < 8; ++i) {
+        color_palette_check_and_add_color(shape_get_palette(s),
+                                          (RGBAColor){i, 0, 0, 255},
+                                          &entry,
+                                          false);
+    }
+    WorldStream *ws = world_stream_new(s, ".", _test_world_stream_generate, NULL);
+    TEST_ASSERT(ws != NULL);
+
+    // far away world, shape chunk coordinates relative to origin
+    const int3 origin = {100000, 0, -100000};
+    world_stream_set_origin(ws, origin);
+    world_stream_set_radius(ws, 1);
+    world_stream_set_focus_point(ws,
+                                 0,
+                                 (int3){origin.x * CHUNK_SIZE + 5, 3, origin.z * CHUNK_SIZE - 1});
+    _test_world_stream_wait(ws);
+
+    // 3x3x3 chunks around focus chunk {origin.x, 0, origin.z - 1}
+    TEST_CHECK(world_stream_get_nb_loaded_chunks(ws) == 27);
+    TEST_CHECK(world_stream_is_chunk_loaded(ws, (int3){origin.x + 1, 1, origin.z}));
+    TEST_CHECK(world_stream_is_chunk_loaded(ws, (int3){origin.x + 2, 0, origin.z}) == false);
+    TEST_CHECK(shape_get_nb_chunks(s) == 27);
+    TEST_CHECK(shape_get_block(s, CHUNK_SIZE, 0, 0)->colorIndex == ((origin.x + 1) & 7));
+
+    // neighborhood is maintained
+    Chunk *c = (Chunk *)index3d_get(shape_get_chunks(s), 0, 0, -1);
+    TEST_ASSERT(c != NULL);
+    TEST_CHECK(chunk_get_neighbor(c, X) == index3d_get(shape_get_chunks(s), 1, 0, -1));
+
+    // modify a chunk, then move focus point away
+    shape_add_block(s, 3, 2, 2, -2, false);
+    TEST_CHECK(shape_get_block(s, 2, 2, -2)->colorIndex == 3);
+    world_stream_set_focus_point(ws,
+                                 0,
+                                 (int3){(origin.x + 10) * CHUNK_SIZE, 0, origin.z * CHUNK_SIZE});
+    _test_world_stream_wait(ws);
+    TEST_CHECK(world_stream_get_nb_loaded_chunks(ws) == 27);
+    TEST_CHECK(world_stream_is_chunk_loaded(ws, (int3){origin.x, 0, origin.z - 1}) == false);
+    TEST_CHECK(index3d_get(shape_get_chunks(s), 0, 0, -1) == NULL);
+    TEST_CHECK(shape_get_nb_chunks(s) == 27);
+
+    // modified chunk comes back from region file
+    world_stream_set_focus_point(ws, 0, (int3){origin.x * CHUNK_SIZE, 0, origin.z * CHUNK_SIZE});
+    _test_world_stream_wait(ws);
+    TEST_CHECK(shape_get_block(s, 2, 2, -2)->colorIndex == 3);
+    TEST_CHECK(shape_get_block(s, 0, 0, -CHUNK_SIZE)->colorIndex == (origin.x & 7));
+
+    world_stream_free(ws);
+    shape_release(s);
+
+    // regions around origin, only the modified chunk was written
+    TEST_CHECK(remove("12500.0.-12500.region") != 0);
+    TEST_CHECK(remove("12500.0.-12501.region") == 0);
+}
@@ -0,0 +1,251 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  thread.c
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#include "thread.h"
+
+// C
+#include <stdlib.h>
+
+// Core
+#include "cclog.h"
+
+#if defined(__VX_PLATFORM_WINDOWS)
+
+#include <windows.h>
+
+struct _Thread {
+    HANDLE handle;
+    thread_func func;
+    void *userdata;
+};
+
+static DWORD WINAPI _thread_main(LPVOID ptr) {
+    Thread *t = (Thread *)ptr;
+    t->func(t->userdata);
+    return 0;
+}
+
+Thread *thread_new(thread_func func, void *userdata) {
+    Thread *t = (Thread *)malloc(sizeof(Thread));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->func = func;
+    t->userdata = userdata;
+    t->handle = CreateThread(NULL, 0, _thread_main, t, 0, NULL);
+    if (t->handle == NULL) {
+        cclog_error("thread_new failed: %d", GetLastError());
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void thread_join_and_free(Thread *t) {
+    if (t == NULL) {
+        return;
+    }
+    WaitForSingleObject(t->handle, INFINITE);
+    CloseHandle(t->handle);
+    free(t);
+}
+
+uint32_t thread_get_core_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (uint32_t)info.dwNumberOfProcessors : 1;
+}
+
+void thread_yield(void) {
+    SwitchToThread();
+}
+
+int32_t thread_atomic_add(volatile int32_t *value, const int32_t delta) {
+    return (int32_t)InterlockedExchangeAdd((volatile LONG *)value, (LONG)delta) + delta;
+}
+
+int32_t thread_atomic_load(volatile int32_t *value) {
+    return (int32_t)InterlockedCompareExchange((volatile LONG *)value, 0, 0);
+}
+
+void thread_atomic_store(volatile int32_t *value, const int32_t newValue) {
+    InterlockedExchange((volatile LONG *)value, (LONG)newValue);
+}
+
+bool thread_atomic_compare_exchange(volatile int32_t *value,
+                                    const int32_t expected,
+                                    const int32_t desired) {
+    return InterlockedCompareExchange((volatile LONG *)value, (LONG)desired, (LONG)expected) ==
+           (LONG)expected;
+}
+
+struct _ThreadCondition {
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE cv;
+};
+
+ThreadCondition *thread_condition_new(void) {
+    ThreadCondition *c = (ThreadCondition *)malloc(sizeof(ThreadCondition));
+    if (c == NULL) {
+        return NULL;
+    }
+    InitializeCriticalSection(&c->lock);
+    InitializeConditionVariable(&c->cv);
+    return c;
+}
+
+void thread_condition_free(ThreadCondition *c) {
+    if (c == NULL) {
+        return;
+    }
+    DeleteCriticalSection(&c->lock);
+    free(c);
+}
+
+void thread_condition_lock(ThreadCondition *c) {
+    EnterCriticalSection(&c->lock);
+}
+
+void thread_condition_unlock(ThreadCondition *c) {
+    LeaveCriticalSection(&c->lock);
+}
+
+void thread_condition_wait(ThreadCondition *c) {
+    SleepConditionVariableCS(&c->cv, &c->lock, INFINITE);
+}
+
+void thread_condition_signal(ThreadCondition *c) {
+    WakeConditionVariable(&c->cv);
+}
+
+void thread_condition_broadcast(ThreadCondition *c) {
+    WakeAllConditionVariable(&c->cv);
+}
+
+#else // non-Windows platforms
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+struct _Thread {
+    pthread_t handle;
+    thread_func func;
+    void *userdata;
+};
+
+static void *_thread_main(void *ptr) {
+    Thread *t = (Thread *)ptr;
+    t->func(t->userdata);
+    return NULL;
+}
+
+Thread *thread_new(thread_func func, void *userdata) {
+#if defined(__VX_PLATFORM_WASM) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return NULL;
+#else
+    Thread *t = (Thread *)malloc(sizeof(Thread));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->func = func;
+    t->userdata = userdata;
+    const int err = pthread_create(&t->handle, NULL, _thread_main, t);
+    if (err != 0) {
+        cclog_error("thread_new failed: %d", err);
+        free(t);
+        return NULL;
+    }
+    return t;
+#endif
+}
+
+void thread_join_and_free(Thread *t) {
+    if (t == NULL) {
+        return;
+    }
+    pthread_join(t->handle, NULL);
+    free(t);
+}
+
+uint32_t thread_get_core_count(void) {
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32_t)count : 1;
+}
+
+void thread_yield(void) {
+    sched_yield();
+}
+
+int32_t thread_atomic_add(volatile int32_t *value, const int32_t delta) {
+    return __atomic_add_fetch(value, delta, __ATOMIC_ACQ_REL);
+}
+
+int32_t thread_atomic_load(volatile int32_t *value) {
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+}
+
+void thread_atomic_store(volatile int32_t *value, const int32_t newValue) {
+    __atomic_store_n(value, newValue, __ATOMIC_SEQ_CST);
+}
+
+bool thread_atomic_compare_exchange(volatile int32_t *value,
+                                    const int32_t expected,
+                                    const int32_t desired) {
+    int32_t e = expected;
+    return __atomic_compare_exchange_n(value,
+                                       &e,
+                                       desired,
+                                       false,
+                                       __ATOMIC_SEQ_CST,
+                                       __ATOMIC_SEQ_CST);
+}
+
+struct _ThreadCondition {
+    pthread_mutex_t lock;
+    pthread_cond_t cv;
+};
+
+ThreadCondition *thread_condition_new(void) {
+    ThreadCondition *c = (ThreadCondition *)malloc(sizeof(ThreadCondition));
+    if (c == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&c->lock, NULL);
+    pthread_cond_init(&c->cv, NULL);
+    return c;
+}
+
+void thread_condition_free(ThreadCondition *c) {
+    if (c == NULL) {
+        return;
+    }
+    pthread_cond_destroy(&c->cv);
+    pthread_mutex_destroy(&c->lock);
+    free(c);
+}
+
+void thread_condition_lock(ThreadCondition *c) {
+    pthread_mutex_lock(&c->lock);
+}
+
+void thread_condition_unlock(ThreadCondition *c) {
+    pthread_mutex_unlock(&c->lock);
+}
+
+void thread_condition_wait(ThreadCondition *c) {
+    pthread_cond_wait(&c->cv, &c->lock);
+}
+
+void thread_condition_signal(ThreadCondition *c) {
+    pthread_cond_signal(&c->cv);
+}
+
+void thread_condition_broadcast(ThreadCondition *c) {
+    pthread_cond_broadcast(&c->cv);
+}
+
+#endif // defined(__VX_PLATFORM_WINDOWS)
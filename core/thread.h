@@ -0,0 +1,74 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  thread.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct _Thread Thread;
+
+typedef void (*thread_func)(void *userdata);
+
+/// Starts a thread running `func(userdata)`.
+/// Returns NULL if the thread can't be created (e.g. platform without threads support),
+/// callers are expected to run `func` themselves in that case.
+Thread *thread_new(thread_func func, void *userdata);
+
+/// Waits for the thread to be done, then frees it
+void thread_join_and_free(Thread *t);
+
+/// Number of logical cores, at least 1
+uint32_t thread_get_core_count(void);
+
+/// Gives up the rest of the calling thread's time slice
+void thread_yield(void);
+
+// MARK: - Atomics -
+
+/// Atomically adds `delta` to `*value`, returns the new value
+int32_t thread_atomic_add(volatile int32_t *value, const int32_t delta);
+
+/// Atomically reads `*value`
+int32_t thread_atomic_load(volatile int32_t *value);
+
+/// Atomically writes `newValue` to `*value`
+void thread_atomic_store(volatile int32_t *value, const int32_t newValue);
+
+/// Atomically replaces `*value` by `desired` if it's equal to `expected`.
+/// Returns true if the value has been replaced.
+bool thread_atomic_compare_exchange(volatile int32_t *value,
+                                    const int32_t expected,
+                                    const int32_t desired);
+
+// MARK: - Condition -
+
+/// A mutex associated with a condition variable, to put threads to sleep until signaled.
+typedef struct _ThreadCondition ThreadCondition;
+
+ThreadCondition *thread_condition_new(void);
+void thread_condition_free(ThreadCondition *c);
+
+void thread_condition_lock(ThreadCondition *c);
+void thread_condition_unlock(ThreadCondition *c);
+
+/// Releases the lock while waiting, lock has to be held when calling this.
+/// Can wake up spuriously, the awaited state has to be checked again.
+void thread_condition_wait(ThreadCondition *c);
+
+/// Wakes up one waiting thread
+void thread_condition_signal(ThreadCondition *c);
+
+/// Wakes up all waiting threads
+void thread_condition_broadcast(ThreadCondition *c);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
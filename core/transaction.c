@@ -13,10 +13,14 @@
 #include "box.h"
 #include "index3d.h"
 
+// BlockChanges are allocated from slabs, released at once with the transaction
+#define TRANSACTION_FIRST_SLAB_CAPACITY 16
+
 struct _Transaction {
 
     // block changes
     Index3D *index3D; // 8 bytes
+    Pool blockChanges; // 24 bytes
 
     // iterator is kept as an internal variable
     // to maintain iterator position when
@@ -41,6 +45,7 @@ Transaction *transaction_new(void) {
 
     tr->index3D = index3D;
     tr->iterator = NULL;
+    blockChange_pool_init(&tr->blockChanges, TRANSACTION_FIRST_SLAB_CAPACITY);
 
     return tr;
 }
@@ -49,13 +54,15 @@ void transaction_free(Transaction *const tr) {
     if (tr == NULL) {
         return;
     }
-    index3d_flush(tr->index3D, blockChange_freeFunc);
-    index3d_free(tr->index3D);
-    tr->index3D = NULL;
+    // iterator refers to the index, free it first
     if (tr->iterator != NULL) {
         index3d_iterator_free(tr->iterator);
         tr->iterator = NULL;
     }
+    index3d_flush(tr->index3D, NULL);
+    index3d_free(tr->index3D);
+    tr->index3D = NULL;
+    pool_release(&tr->blockChanges);
     free(tr);
 }
 
@@ -88,7 +95,7 @@ bool transaction_addBlock(Transaction *const tr,
     BlockChange *bc = NULL;
     if (data == NULL) { // index doesn't contain a BlockChange for those coords
 
-        bc = blockChange_new(colorIndex, x, y, z);
+        bc = blockChange_new_from_pool(&tr->blockChanges, colorIndex, x, y, z);
     } else { // index does contain a BlockChange for those coords already
 
         bc = (BlockChange *)data;
@@ -108,7 +115,7 @@ bool transaction_addBlock(Transaction *const tr,
     return true; // block is considered added
 }
 
-void transaction_removeBlock(const Transaction *const tr,
+void transaction_removeBlock(Transaction *const tr,
                              const SHAPE_COORDS_INT_T x,
                              const SHAPE_COORDS_INT_T y,
                              const SHAPE_COORDS_INT_T z) {
@@ -120,7 +127,7 @@ void transaction_removeBlock(const Transaction *const tr,
     BlockChange *bc = NULL;
     if (data == NULL) { // index doesn't contain a BlockChange for those coords
 
-        bc = blockChange_new(SHAPE_COLOR_INDEX_AIR_BLOCK, x, y, z);
+        bc = blockChange_new_from_pool(&tr->blockChanges, SHAPE_COLOR_INDEX_AIR_BLOCK, x, y, z);
     } else { // index does contain a BlockChange for those coords already
 
         bc = (BlockChange *)data;
@@ -138,7 +145,7 @@ void transaction_removeBlock(const Transaction *const tr,
     index3d_insert(tr->index3D, bc, x, y, z, tr->iterator);
 }
 
-void transaction_replaceBlock(const Transaction *const tr,
+void transaction_replaceBlock(Transaction *const tr,
                               const SHAPE_COORDS_INT_T x,
                               const SHAPE_COORDS_INT_T y,
                               const SHAPE_COORDS_INT_T z,
@@ -151,7 +158,7 @@ void transaction_replaceBlock(const Transaction *const tr,
     BlockChange *bc = NULL;
     if (data == NULL) { // index doesn't contain a BlockChange for those coords
 
-        bc = blockChange_new(colorIndex, x, y, z);
+        bc = blockChange_new_from_pool(&tr->blockChanges, colorIndex, x, y, z);
     } else { // index does contain a BlockChange for those coords already
 
         bc = (BlockChange *)data;
@@ -169,6 +176,10 @@ void transaction_replaceBlock(const Transaction *const tr,
     index3d_insert(tr->index3D, bc, x, y, z, tr->iterator);
 }
 
+uint32_t transaction_getNbBlockChanges(const Transaction *const tr) {
+    return index3d_get_count(tr->index3D);
+}
+
 Index3DIterator *transaction_getIndex3DIterator(Transaction *const tr) {
     if (tr == NULL || tr->index3D == NULL) {
         return NULL;
@@ -35,18 +35,21 @@ bool transaction_addBlock(Transaction *const tr,
                           const SHAPE_COLOR_INDEX_INT_T colorIndex);
 
 /// x, y, z are Lua coords
-void transaction_removeBlock(const Transaction *const tr,
+void transaction_removeBlock(Transaction *const tr,
                              const SHAPE_COORDS_INT_T x,
                              const SHAPE_COORDS_INT_T y,
                              const SHAPE_COORDS_INT_T z);
 
 /// x, y, z are Lua coords
-void transaction_replaceBlock(const Transaction *const tr,
+void transaction_replaceBlock(Transaction *const tr,
                               const SHAPE_COORDS_INT_T x,
                               const SHAPE_COORDS_INT_T y,
                               const SHAPE_COORDS_INT_T z,
                               const SHAPE_COLOR_INDEX_INT_T colorIndex);
 
+/// Number of block changes, several changes at same coordinates being amended into one
+uint32_t transaction_getNbBlockChanges(const Transaction *const tr);
+
 /// Returns iterator at current position
 /// Creating a new one if needed, starting at first operation.
 /// The iterator is freed with its transaction.
@@ -761,6 +761,34 @@ void transform_get_rotation_euler(Transform *t, float3 *euler) {
     quaternion_to_euler(transform_get_rotation(t), euler);
 }
 
+// MARK: - State -
+
+void transform_get_state(Transform *t, TransformState *state) {
+    _transform_refresh_local_position(t);
+    _transform_refresh_local_rotation(t);
+    const Quaternion *q = t->localRotation;
+    *state = (TransformState){t->localPosition,
+                              t->localScale,
+                              (float4){q->x, q->y, q->z, q->w},
+                              q->normalized,
+                              {0}};
+}
+
+void transform_set_state(Transform *t, const TransformState *state) {
+    t->localPosition = state->position;
+    t->localScale = state->scale;
+    *t->localRotation = (Quaternion){state->rotation.x,
+                                     state->rotation.y,
+                                     state->rotation.z,
+                                     state->rotation.w,
+                                     state->rotationNormalized};
+    _transform_reset_dirty(t, TRANSFORM_DIRTY_LOCAL_POS | TRANSFORM_DIRTY_LOCAL_ROT);
+    _transform_set_dirty(t,
+                         TRANSFORM_DIRTY_POS | TRANSFORM_DIRTY_ROT | TRANSFORM_DIRTY_MTX |
+                             TRANSFORM_DIRTY_PHYSICS,
+                         false);
+}
+
 // MARK: - Unit vectors -
 
 void transform_get_forward(Transform *t, float3 *forward, const bool refreshParents) {
@@ -23,6 +23,15 @@ typedef struct _Transform Transform;
 typedef struct _Scene Scene;
 typedef struct _RigidBody RigidBody;
 
+/// Local transformations, copied as is to roll back a simulation (see scene_write_snapshot)
+typedef struct {
+    float3 position;
+    float3 scale;
+    float4 rotation;
+    bool rotationNormalized;
+    char pad[3];
+} TransformState;
+
 /// Select the computing mode for transforms utils euler functions (transform_utils_*)
 /// Note: internal & other functions rotations always use quaternions regardless of this mode
 /// 0: add euler angles (fastest, but need to manually clamp [0:2PI])
@@ -162,6 +171,11 @@ void transform_get_local_rotation_euler(Transform *t, float3 *euler);
 Quaternion *transform_get_rotation(Transform *t);
 void transform_get_rotation_euler(Transform *t, float3 *euler);
 
+/// MARK: - State -
+void transform_get_state(Transform *t, TransformState *state);
+/// Unlike setters, always applies given values, even if within epsilon of current ones
+void transform_set_state(Transform *t, const TransformState *state);
+
 /// MARK: - Unit vectors -
 /// Unit vector getters are computed on demand, the rationale is that the majority of transforms in
 /// a hierarchy will never use unit vectors and that it is redundant w/ storing rotation A simple
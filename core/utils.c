@@ -13,6 +13,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#if defined(__VX_PLATFORM_WINDOWS)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
 
 #include "config.h"
 
@@ -456,3 +461,19 @@ float frand(void) {
     const int r = rand();
     return (float)r / (float)RAND_MAX;
 }
+
+uint64_t utils_time_ns(void) {
+#if defined(__VX_PLATFORM_WINDOWS)
+    static LARGE_INTEGER frequency = {0};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1000000000.0 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
@@ -142,6 +142,9 @@ uint32_t utils_float_to_rgba(float r, float g, float b, float a);
 // random float value between 0.0 and 1.0
 float frand(void);
 
+// monotonic clock, in nanoseconds (origin is unspecified, only use for durations)
+uint64_t utils_time_ns(void);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -76,8 +76,11 @@ struct _VertexBufferMemArea {
     // Dirty vbma will be re-uploaded next render
     bool dirty; /* 1 byte */
 
+    // gap vertices have been zeroed, so that it can be drawn until filled
+    bool cleared; /* 1 byte */
+
     // padding
-    char pad[7];
+    char pad[6];
 };
 
 VertexBufferMemArea *vertex_buffer_mem_area_new(VertexBuffer *vb,
@@ -125,6 +128,9 @@ struct _VertexBuffer {
     // flushed by renderer calling vertex_buffer_flush_draw_slices() after re-upload
     DoublyLinkedList *drawSlices; /* 8 bytes */
 
+    // sorted & merged ranges of vertices modified since last vertex_buffer_pop_dirty_ranges
+    DrawBufferWriteSlice *dirtyRanges; /* 8 bytes */
+
     // mem areas used by chunks to store vertices
     // (references to memory areas within vertex buffer)
     VertexBufferMemArea *firstMemArea; /* 8 bytes */
@@ -145,17 +151,26 @@ struct _VertexBuffer {
     uint32_t maxCount; /* 4 bytes */
     uint32_t count;    /* 4 bytes */
 
+    uint32_t nbDirtyRanges;       /* 4 bytes */
+    uint32_t dirtyRangesCapacity; /* 4 bytes */
+
     // draw write slices count
     uint16_t nbDrawSlices; /* 2 bytes */
 
     bool isTransparent; /* 1 byte */
 
-    char pad[1];
+    // chunk LOD level of vbmas in this vb, see CHUNK_LOD_COUNT
+    uint8_t lod; /* 1 byte */
+
+    char pad[4];
 };
 
 // vb optionally writes lighting data
 static bool vertex_buffer_lighting_enabled = true;
 
+// max vertices moved by vertex_buffer_fill_gaps_with_budget callers, per refresh
+static uint32_t vertex_buffer_compaction_budget = SHAPE_BUFFER_COMPACTION_BUDGET;
+
 // MARK: DEBUG UTILS
 #if VERTEX_BUFFER_DEBUG == 1
 typedef struct {
@@ -278,7 +293,12 @@ VertexBuffer *vertex_buffer_new_with_max_count(uint32_t n, bool transparent) {
     vb->drawSlices = doubly_linked_list_new();
     vb->nbDrawSlices = 0;
 
+    vb->dirtyRanges = NULL;
+    vb->nbDirtyRanges = 0;
+    vb->dirtyRangesCapacity = 0;
+
     vb->isTransparent = transparent;
+    vb->lod = 0;
 
     return vb;
 }
@@ -314,6 +334,8 @@ void vertex_buffer_free(VertexBuffer *vb) {
     doubly_linked_list_flush(vb->drawSlices, free);
     doubly_linked_list_free(vb->drawSlices);
 
+    free(vb->dirtyRanges);
+
     //!\\ vb->next has to be freed manually or using vertex_buffer_free_all
     free(vb);
 }
@@ -380,29 +402,33 @@ void vertex_buffer_add_draw_slice(VertexBuffer *vb, uint32_t start, uint32_t cou
     }
     DrawBufferWriteSlice value = {start, start + count - 1};
 
-    DrawBufferWriteSlice *leftMerged = NULL, *rightMerged = NULL;
-    DoublyLinkedListNode *rightMergedNode = NULL;
+    // absorb all slices overlapping or adjacent to the new one, so that moved spans
+    // are only uploaded once, then keep the first absorbed slice to store the result
+    DrawBufferWriteSlice *merged = NULL;
     DoublyLinkedListNode *itr = doubly_linked_list_first(vb->drawSlices);
+    DoublyLinkedListNode *next;
     DrawBufferWriteSlice *ws;
     while (itr != NULL) {
+        next = doubly_linked_list_node_next(itr);
         ws = (DrawBufferWriteSlice *)doubly_linked_list_node_pointer(itr);
-        if (value.from == ws->to + 1) {
-            ws->to = value.to;
-            leftMerged = ws;
-        } else if (value.to == ws->from - 1) {
-            ws->from = value.from;
-            rightMerged = ws;
-            rightMergedNode = itr;
+        if (ws->from <= value.to + 1 && value.from <= ws->to + 1) {
+            value.from = minimum(value.from, ws->from);
+            value.to = maximum(value.to, ws->to);
+            if (merged == NULL) {
+                merged = ws;
+            } else {
+                doubly_linked_list_delete_node(vb->drawSlices, itr);
+                free(ws);
+                vb->nbDrawSlices--;
+            }
         }
-        itr = doubly_linked_list_node_next(itr);
-    }
-    // reduce if merged right & left, or insert if not merged at all
-    if (leftMerged != NULL && rightMerged != NULL) {
-        leftMerged->to = rightMerged->to;
-        doubly_linked_list_delete_node(vb->drawSlices, rightMergedNode);
-        free(rightMerged);
-        vb->nbDrawSlices--;
-    } else if (leftMerged == NULL && rightMerged == NULL) {
+        itr = next;
+    }
+
+    if (merged != NULL) {
+        merged->from = value.from;
+        merged->to = value.to;
+    } else {
         DrawBufferWriteSlice *node = (DrawBufferWriteSlice *)malloc(sizeof(DrawBufferWriteSlice));
         if (node != NULL) {
             node->from = value.from;
@@ -413,12 +439,93 @@ void vertex_buffer_add_draw_slice(VertexBuffer *vb, uint32_t start, uint32_t cou
     }
 }
 
+// marks [from, from + count) vertices as modified, merging with overlapping or adjacent ranges
+static void _vertex_buffer_mark_dirty(VertexBuffer *vb, const uint32_t from, const uint32_t count) {
+    if (count == 0) {
+        return;
+    }
+    const uint32_t to = from + count - 1;
+
+    // writers usually go forward, extend last range when possible
+    if (vb->nbDirtyRanges > 0) {
+        DrawBufferWriteSlice *last = &vb->dirtyRanges[vb->nbDirtyRanges - 1];
+        if (from <= last->to + 1 && from >= last->from) {
+            last->to = maximum(last->to, to);
+            return;
+        }
+    }
+
+    // first range that can be merged: ranges before it end strictly before from - 1
+    uint32_t lo = 0, hi = vb->nbDirtyRanges;
+    while (lo < hi) {
+        const uint32_t mid = (lo + hi) / 2;
+        if (vb->dirtyRanges[mid].to + 1 < from) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    // ranges [lo, end) merge with the new one, if they start before to + 1
+    uint32_t end = lo;
+    DrawBufferWriteSlice merged = {from, to};
+    while (end < vb->nbDirtyRanges && vb->dirtyRanges[end].from <= to + 1) {
+        merged.from = minimum(merged.from, vb->dirtyRanges[end].from);
+        merged.to = maximum(merged.to, vb->dirtyRanges[end].to);
+        ++end;
+    }
+
+    if (end > lo) {
+        // replace merged ranges by a single one
+        vb->dirtyRanges[lo] = merged;
+        memmove(&vb->dirtyRanges[lo + 1],
+                &vb->dirtyRanges[end],
+                (vb->nbDirtyRanges - end) * sizeof(DrawBufferWriteSlice));
+        vb->nbDirtyRanges -= end - lo - 1;
+        return;
+    }
+
+    if (vb->nbDirtyRanges == vb->dirtyRangesCapacity) {
+        const uint32_t capacity = vb->dirtyRangesCapacity > 0 ? vb->dirtyRangesCapacity * 2 : 8;
+        DrawBufferWriteSlice *ranges = (DrawBufferWriteSlice *)
+            realloc(vb->dirtyRanges, capacity * sizeof(DrawBufferWriteSlice));
+        if (ranges == NULL) {
+            return;
+        }
+        vb->dirtyRanges = ranges;
+        vb->dirtyRangesCapacity = capacity;
+    }
+    memmove(&vb->dirtyRanges[lo + 1],
+            &vb->dirtyRanges[lo],
+            (vb->nbDirtyRanges - lo) * sizeof(DrawBufferWriteSlice));
+    vb->dirtyRanges[lo] = merged;
+    ++vb->nbDirtyRanges;
+}
+
+uint32_t vertex_buffer_get_nb_dirty_ranges(const VertexBuffer *vb) {
+    return vb->nbDirtyRanges;
+}
+
+uint32_t vertex_buffer_pop_dirty_ranges(VertexBuffer *vb, VertexBufferRange *ranges, uint32_t max) {
+    const uint32_t n = minimum(max, vb->nbDirtyRanges);
+    for (uint32_t i = 0; i < n; ++i) {
+        ranges[i].offset = vb->dirtyRanges[i].from * (uint32_t)DRAWBUFFER_VERTICES_BYTES;
+        ranges[i].size = (vb->dirtyRanges[i].to - vb->dirtyRanges[i].from + 1) *
+                         (uint32_t)DRAWBUFFER_VERTICES_BYTES;
+    }
+    memmove(vb->dirtyRanges,
+            &vb->dirtyRanges[n],
+            (vb->nbDirtyRanges - n) * sizeof(DrawBufferWriteSlice));
+    vb->nbDirtyRanges -= n;
+    return n;
+}
+
 void vertex_buffer_fill_draw_slices(VertexBuffer *vb) {
     VertexBufferMemArea *vbma = vb->firstMemArea;
     uint32_t idx = 0;
     while (vbma != NULL) {
         if (vbma->dirty) {
-            if (vertex_buffer_mem_area_is_gap(vbma) == false) {
+            // gaps waiting to be filled are uploaded once cleared, not to draw stale vertices
+            if (vertex_buffer_mem_area_is_gap(vbma) == false || vbma->cleared) {
                 vertex_buffer_add_draw_slice(vb, idx, vbma->count);
             }
             vbma->dirty = false;
@@ -434,6 +541,14 @@ void vertex_buffer_flush_draw_slices(VertexBuffer *vb) {
     vb->nbDrawSlices = 0;
 }
 
+void vertex_buffer_set_lod(VertexBuffer *vb, uint8_t lod) {
+    vb->lod = lod;
+}
+
+uint8_t vertex_buffer_get_lod(const VertexBuffer *vb) {
+    return vb->lod;
+}
+
 uint16_t vertex_buffer_get_nb_draw_slices(const VertexBuffer *vb) {
     return vb->nbDrawSlices;
 }
@@ -467,15 +582,31 @@ void vertex_buffer_remove_last_mem_area(VertexBuffer *vb) {
     vertex_buffer_mem_area_remove(vb->lastMemArea, vb->isTransparent);
 }
 
-// reorganizes data to fill the gaps
+// zeroes vertices of gaps that are going to stay until next refresh,
+// draw slices then re-upload them, so that they're not drawn with stale vertices
+static void _vertex_buffer_clear_gaps(VertexBuffer *vb) {
+    VertexBufferMemArea *gap = vb->firstMemAreaGap;
+    while (gap != NULL) {
+        if (gap->cleared == false && gap->count > 0) {
+            memset(gap->start, 0, gap->count * DRAWBUFFER_VERTICES_BYTES);
+            _vertex_buffer_mark_dirty(vb, gap->startIdx, gap->count);
+            gap->cleared = true;
+            gap->dirty = true;
+        }
+        gap = gap->_groupListNext;
+    }
+}
+
 void vertex_buffer_fill_gaps(VertexBuffer *vb) {
+    vertex_buffer_fill_gaps_with_budget(vb, UINT32_MAX);
+}
+
+// reorganizes data to fill the gaps
+uint32_t vertex_buffer_fill_gaps_with_budget(VertexBuffer *vb, const uint32_t budget) {
 #if VERTEX_BUFFER_DEBUG == 1
     vertex_buffer_check_mem_area_chain(vb);
 #endif
 
-    // no gap remaining at the end of this function
-    vb->firstMemAreaGap = NULL;
-
     // here we know there are gaps, and none of them is at the end
     // of global mem area list
 
@@ -487,6 +618,9 @@ void vertex_buffer_fill_gaps(VertexBuffer *vb) {
     VertexBufferMemArea *cursor = vb->firstMemArea;
     VertexBufferMemArea *vbma;
 
+    // vertices moved so far
+    uint32_t moved = 0;
+
     while (cursor != NULL) {
         // loop until finding a gap to fill
         while (cursor != NULL && vertex_buffer_mem_area_is_gap(cursor) == false) {
@@ -555,6 +689,11 @@ void vertex_buffer_fill_gaps(VertexBuffer *vb) {
             }
 #endif
 
+            // gap remains cleared only if all merged gaps were
+            if (vbma->count > 0 && vbma->cleared == false) {
+                cursor->cleared = false;
+            }
+
             vertex_buffer_mem_area_remove(vbma, vb->isTransparent);
 
 #if VERTEX_BUFFER_DEBUG == 1
@@ -594,6 +733,15 @@ void vertex_buffer_fill_gaps(VertexBuffer *vb) {
             break; // breaks main loop
         }
 
+        // out of budget, remaining gaps are filled next time
+        if (moved >= budget) {
+            break;
+        }
+        // only fill the part of the gap that fits in the budget
+        if (cursor->count > budget - moved) {
+            vertex_buffer_mem_area_split_and_make_gap(cursor, budget - moved);
+        }
+
         uint32_t written = 0;
 
         // loop until gap is filled with vertices
@@ -656,6 +804,7 @@ void vertex_buffer_fill_gaps(VertexBuffer *vb) {
                                       vb->lastMemArea->start,
                                       vb->lastMemArea->count,
                                       0);
+                _vertex_buffer_mark_dirty(vb, cursor->startIdx, vb->lastMemArea->count);
                 cursor->dirty = true;
 
                 written += vb->lastMemArea->count;
@@ -670,6 +819,7 @@ void vertex_buffer_fill_gaps(VertexBuffer *vb) {
                 uint32_t diff = vb->lastMemArea->count - cursor->count;
 
                 _vertex_buffer_memcpy(cursor->start, vb->lastMemArea->start, cursor->count, diff);
+                _vertex_buffer_mark_dirty(vb, cursor->startIdx, cursor->count);
                 cursor->dirty = true;
 
                 written += cursor->count;
@@ -685,6 +835,7 @@ void vertex_buffer_fill_gaps(VertexBuffer *vb) {
                                       vb->lastMemArea->start,
                                       vb->lastMemArea->count,
                                       0);
+                _vertex_buffer_mark_dirty(vb, cursor->startIdx, vb->lastMemArea->count);
                 cursor->dirty = true;
 
                 written += vb->lastMemArea->count;
@@ -695,6 +846,8 @@ void vertex_buffer_fill_gaps(VertexBuffer *vb) {
             }
         } // end while (loop until gap is filled with vertices)
 
+        moved += written;
+
 #if VERTEX_BUFFER_DEBUG == 1
         if (cursor == NULL) {
             cclog_debug("⚠️⚠️⚠️ cursor shouldn't be NULL");
@@ -704,9 +857,13 @@ void vertex_buffer_fill_gaps(VertexBuffer *vb) {
         cursor = cursor->_globalListNext;
 
     } // end of main loop: while (cursor != NULL)
+
+    _vertex_buffer_clear_gaps(vb);
+
 #if VERTEX_BUFFER_DEBUG == 1
     vertex_buffer_check_mem_area_chain(vb);
 #endif
+    return moved;
 }
 
 //---------------------
@@ -756,6 +913,7 @@ VertexBufferMemArea *vertex_buffer_mem_area_new(VertexBuffer *vb,
     vbma->count = count;
     vbma->start = start;
     vbma->dirty = false;
+    vbma->cleared = false;
     return vbma;
 }
 
@@ -766,8 +924,8 @@ void vertex_buffer_mem_area_free(VertexBufferMemArea *vbma) {
 void vertex_buffer_mem_area_leave_group_list(VertexBufferMemArea *vbma, bool transparent) {
     // maybe it is the front mem area of chunk (if not a gap)
     if (vertex_buffer_mem_area_is_gap(vbma) == false) {
-        if (chunk_get_vbma(vbma->chunk, transparent) == vbma) {
-            chunk_set_vbma(vbma->chunk, vbma->_groupListNext, transparent);
+        if (chunk_get_lod_vbma(vbma->chunk, vbma->vb->lod, transparent) == vbma) {
+            chunk_set_lod_vbma(vbma->chunk, vbma->_groupListNext, vbma->vb->lod, transparent);
         }
     } else { // not the front mem area of a chunk
         if (vbma == vbma->vb->firstMemAreaGap) {
@@ -884,12 +1042,14 @@ bool vertex_buffer_mem_area_assign_to_chunk(VertexBufferMemArea *vbma,
     vertex_buffer_mem_area_leave_group_list(vbma, transparent);
 
     vbma->chunk = chunk;
+    vbma->cleared = false;
 
-    VertexBufferMemArea *memArea = (VertexBufferMemArea *)chunk_get_vbma(chunk, transparent);
+    VertexBufferMemArea *memArea = (VertexBufferMemArea *)
+        chunk_get_lod_vbma(chunk, vbma->vb->lod, transparent);
 
     // if chunk has no mem area, vbma simply becomes the first one
     if (memArea == NULL) {
-        chunk_set_vbma(chunk, vbma, transparent);
+        chunk_set_lod_vbma(chunk, vbma, vbma->vb->lod, transparent);
     }
     // otherwise go to last mem area of this chunk
     else {
@@ -916,6 +1076,7 @@ bool vertex_buffer_mem_area_insert_after(VertexBufferMemArea *vbma1,
     vertex_buffer_mem_area_leave_group_list(vbma1, transparent);
 
     vbma1->chunk = vbma2->chunk;
+    vbma1->cleared = vbma2->chunk == NULL && vbma2->cleared;
 
     if (vbma2->_groupListNext != NULL) {
         vbma2->_groupListNext->_groupListPrevious = vbma1;
@@ -940,17 +1101,26 @@ struct _VertexBufferMemAreaWriter {
     // amount of vertices written in current mem area
     // this is being reset when jumping to a different mem area
     uint32_t writtenCount; /* 4 bytes */
-    bool isTransparent;    /* 1 byte */
-    char pad[3];           /* 3 bytes */
+    // amount of vertices at the start of current mem area that were written by the same chunk,
+    // unchanged vertices in that part don't have to be uploaded again
+    uint32_t reusedCount; /* 4 bytes */
+    bool isTransparent;   /* 1 byte */
+    // chunk LOD level written, vbmas are taken from the shape's vertex buffers for that level
+    uint8_t lod;  /* 1 byte */
+    char pad[6]; /* 6 bytes */
 };
 
+// `reused`: vbma already contains vertices from the writer's chunk
 void vertex_buffer_mem_area_writer_reset(VertexBufferMemAreaWriter *vbmaw,
-                                         VertexBufferMemArea *vbma) {
+                                         VertexBufferMemArea *vbma,
+                                         bool reused) {
     vbmaw->vbma = vbma;
     if (vbmaw->vbma != NULL) {
         vbmaw->cursor = vbmaw->vbma->start;
+        vbmaw->reusedCount = reused ? vbmaw->vbma->count : 0;
     } else {
         vbmaw->cursor = NULL;
+        vbmaw->reusedCount = 0;
     }
     vbmaw->writtenCount = 0;
 }
@@ -974,7 +1144,7 @@ void vertex_buffer_mem_area_writer_write(VertexBufferMemAreaWriter *vbmaw,
             if (vbmaw->vbma != NULL) {
                 // 1) see if there's already a next area for same chunk we can use
                 if (vertex_buffer_mem_area_is_null_or_empty(vbmaw->vbma->_groupListNext) == false) {
-                    vertex_buffer_mem_area_writer_reset(vbmaw, vbmaw->vbma->_groupListNext);
+                    vertex_buffer_mem_area_writer_reset(vbmaw, vbmaw->vbma->_groupListNext, true);
                     break;
                 }
 
@@ -988,16 +1158,20 @@ void vertex_buffer_mem_area_writer_write(VertexBufferMemAreaWriter *vbmaw,
             }
 
             // 3) check across ALL vb for the current shape & same render...
-            VertexBuffer *vb = shape_get_first_vertex_buffer(vbmaw->s, vbmaw->isTransparent);
+            VertexBuffer *vb = shape_get_first_lod_vertex_buffer(vbmaw->s,
+                                                                 vbmaw->lod,
+                                                                 vbmaw->isTransparent);
             while (vb != NULL) {
                 // 2a) ...if there's a vbma gap we can use
                 if (vertex_buffer_mem_area_is_null_or_empty(vb->firstMemAreaGap) == false) {
                     if (vertex_buffer_mem_area_insert_after(vb->firstMemAreaGap,
                                                             vbmaw->vbma,
                                                             vb->isTransparent)) {
-                        vertex_buffer_mem_area_writer_reset(vbmaw, vbmaw->vbma->_groupListNext);
+                        vertex_buffer_mem_area_writer_reset(vbmaw,
+                                                            vbmaw->vbma->_groupListNext,
+                                                            false);
                     } else {
-                        vertex_buffer_mem_area_writer_reset(vbmaw, vb->firstMemAreaGap);
+                        vertex_buffer_mem_area_writer_reset(vbmaw, vb->firstMemAreaGap, false);
                         vertex_buffer_mem_area_assign_to_chunk(vb->firstMemAreaGap,
                                                                vbmaw->c,
                                                                vbmaw->isTransparent);
@@ -1012,9 +1186,11 @@ void vertex_buffer_mem_area_writer_write(VertexBufferMemAreaWriter *vbmaw,
                     if (vertex_buffer_mem_area_insert_after(vb->firstMemAreaGap,
                                                             vbmaw->vbma,
                                                             vb->isTransparent)) {
-                        vertex_buffer_mem_area_writer_reset(vbmaw, vbmaw->vbma->_groupListNext);
+                        vertex_buffer_mem_area_writer_reset(vbmaw,
+                                                            vbmaw->vbma->_groupListNext,
+                                                            false);
                     } else {
-                        vertex_buffer_mem_area_writer_reset(vbmaw, vb->firstMemAreaGap);
+                        vertex_buffer_mem_area_writer_reset(vbmaw, vb->firstMemAreaGap, false);
                         vertex_buffer_mem_area_assign_to_chunk(vb->firstMemAreaGap,
                                                                vbmaw->c,
                                                                vbmaw->isTransparent);
@@ -1034,16 +1210,18 @@ void vertex_buffer_mem_area_writer_write(VertexBufferMemAreaWriter *vbmaw,
 
             // 4) all the available vb are at capacity and we need a new one
             else {
-                VertexBuffer *newVb = shape_add_buffer(vbmaw->s, vbmaw->isTransparent);
+                VertexBuffer *newVb = shape_add_lod_buffer(vbmaw->s,
+                                                           vbmaw->lod,
+                                                           vbmaw->isTransparent);
 
                 // immediately create a new vbma for this vb
                 vertex_buffer_new_empty_gap_at_end(newVb);
                 if (vertex_buffer_mem_area_insert_after(newVb->firstMemAreaGap,
                                                         vbmaw->vbma,
                                                         newVb->isTransparent)) {
-                    vertex_buffer_mem_area_writer_reset(vbmaw, vbmaw->vbma->_groupListNext);
+                    vertex_buffer_mem_area_writer_reset(vbmaw, vbmaw->vbma->_groupListNext, false);
                 } else {
-                    vertex_buffer_mem_area_writer_reset(vbmaw, newVb->firstMemAreaGap);
+                    vertex_buffer_mem_area_writer_reset(vbmaw, newVb->firstMemAreaGap, false);
                     vertex_buffer_mem_area_assign_to_chunk(newVb->firstMemAreaGap,
                                                            vbmaw->c,
                                                            vbmaw->isTransparent);
@@ -1160,65 +1338,78 @@ void vertex_buffer_mem_area_writer_write(VertexBufferMemAreaWriter *vbmaw,
     const float v3_metadata = (float)(ao.ao3 + packed_faceIndex + packed_srgb3);
     const float v4_metadata = (float)(ao.ao4 + packed_faceIndex + packed_srgb4);
 
-    // Vertex attributes
+    // Vertex attributes, faces of LOD meshes span 2^lod blocks
+    const float size = (float)(1 << vbmaw->lod);
     VertexAttributes v1, v2, v3, v4;
     switch (faceIndex) {
         case FACE_RIGHT_CTC: {
-            v1 = (VertexAttributes){x + 1.0f, y + 1.0f, z, (float)color, v1_metadata};
-            v2 = (VertexAttributes){x + 1.0f, y, z, (float)color, v2_metadata};
-            v3 = (VertexAttributes){x + 1.0f, y, z + 1.0f, (float)color, v3_metadata};
-            v4 = (VertexAttributes){x + 1.0f, y + 1.0f, z + 1.0f, (float)color, v4_metadata};
+            v1 = (VertexAttributes){x + size, y + size, z, (float)color, v1_metadata};
+            v2 = (VertexAttributes){x + size, y, z, (float)color, v2_metadata};
+            v3 = (VertexAttributes){x + size, y, z + size, (float)color, v3_metadata};
+            v4 = (VertexAttributes){x + size, y + size, z + size, (float)color, v4_metadata};
             break;
         }
         case FACE_LEFT_CTC: {
             v1 = (VertexAttributes){x, y, z, (float)color, v1_metadata};
-            v2 = (VertexAttributes){x, y + 1.0f, z, (float)color, v2_metadata};
-            v3 = (VertexAttributes){x, y + 1.0f, z + 1.0f, (float)color, v3_metadata};
-            v4 = (VertexAttributes){x, y, z + 1.0f, (float)color, v4_metadata};
+            v2 = (VertexAttributes){x, y + size, z, (float)color, v2_metadata};
+            v3 = (VertexAttributes){x, y + size, z + size, (float)color, v3_metadata};
+            v4 = (VertexAttributes){x, y, z + size, (float)color, v4_metadata};
             break;
         }
         case FACE_TOP_CTC: {
-            v1 = (VertexAttributes){x + 1.0f, y + 1.0f, z, (float)color, v1_metadata};
-            v2 = (VertexAttributes){x + 1.0f, y + 1.0f, z + 1.0f, (float)color, v2_metadata};
-            v3 = (VertexAttributes){x, y + 1.0f, z + 1.0f, (float)color, v3_metadata};
-            v4 = (VertexAttributes){x, y + 1.0f, z, (float)color, v4_metadata};
+            v1 = (VertexAttributes){x + size, y + size, z, (float)color, v1_metadata};
+            v2 = (VertexAttributes){x + size, y + size, z + size, (float)color, v2_metadata};
+            v3 = (VertexAttributes){x, y + size, z + size, (float)color, v3_metadata};
+            v4 = (VertexAttributes){x, y + size, z, (float)color, v4_metadata};
             break;
         }
         case FACE_DOWN_CTC: {
             v1 = (VertexAttributes){x, y, z, (float)color, v1_metadata};
-            v2 = (VertexAttributes){x, y, z + 1.0f, (float)color, v2_metadata};
-            v3 = (VertexAttributes){x + 1.0f, y, z + 1.0f, (float)color, v3_metadata};
-            v4 = (VertexAttributes){x + 1.0f, y, z, (float)color, v4_metadata};
+            v2 = (VertexAttributes){x, y, z + size, (float)color, v2_metadata};
+            v3 = (VertexAttributes){x + size, y, z + size, (float)color, v3_metadata};
+            v4 = (VertexAttributes){x + size, y, z, (float)color, v4_metadata};
             break;
         }
         case FACE_FRONT_CTC: {
-            v1 = (VertexAttributes){x, y, z + 1.0f, (float)color, v1_metadata};
-            v2 = (VertexAttributes){x, y + 1.0f, z + 1.0f, (float)color, v2_metadata};
-            v3 = (VertexAttributes){x + 1.0f, y + 1.0f, z + 1.0f, (float)color, v3_metadata};
-            v4 = (VertexAttributes){x + 1.0f, y, z + 1.0f, (float)color, v4_metadata};
+            v1 = (VertexAttributes){x, y, z + size, (float)color, v1_metadata};
+            v2 = (VertexAttributes){x, y + size, z + size, (float)color, v2_metadata};
+            v3 = (VertexAttributes){x + size, y + size, z + size, (float)color, v3_metadata};
+            v4 = (VertexAttributes){x + size, y, z + size, (float)color, v4_metadata};
             break;
         }
         case FACE_BACK_CTC: {
-            v1 = (VertexAttributes){x, y + 1.0f, z, (float)color, v1_metadata};
+            v1 = (VertexAttributes){x, y + size, z, (float)color, v1_metadata};
             v2 = (VertexAttributes){x, y, z, (float)color, v2_metadata};
-            v3 = (VertexAttributes){x + 1.0f, y, z, (float)color, v3_metadata};
-            v4 = (VertexAttributes){x + 1.0f, y + 1.0f, z, (float)color, v4_metadata};
+            v3 = (VertexAttributes){x + size, y, z, (float)color, v3_metadata};
+            v4 = (VertexAttributes){x + size, y + size, z, (float)color, v4_metadata};
             break;
         }
     }
+    VertexAttributes face[DRAWBUFFER_VERTICES_PER_FACE];
     if (aoShift) {
-        vbmaw->cursor[vbma_idxVertices] = v1;
-        vbmaw->cursor[vbma_idxVertices + 1] = v2;
-        vbmaw->cursor[vbma_idxVertices + 2] = v3;
-        vbmaw->cursor[vbma_idxVertices + 3] = v4;
+        face[0] = v1;
+        face[1] = v2;
+        face[2] = v3;
+        face[3] = v4;
     } else {
-        vbmaw->cursor[vbma_idxVertices] = v4;
-        vbmaw->cursor[vbma_idxVertices + 1] = v1;
-        vbmaw->cursor[vbma_idxVertices + 2] = v2;
-        vbmaw->cursor[vbma_idxVertices + 3] = v3;
+        face[0] = v4;
+        face[1] = v1;
+        face[2] = v2;
+        face[3] = v3;
     }
 
+    VertexAttributes *dst = vbmaw->cursor + vbma_idxVertices;
     vbmaw->writtenCount += DRAWBUFFER_VERTICES_PER_FACE;
+
+    // re-meshed chunks mostly write the same faces at the same place, skip those
+    if (vbmaw->writtenCount <= vbmaw->reusedCount && memcmp(dst, face, sizeof(face)) == 0) {
+        return;
+    }
+
+    memcpy(dst, face, sizeof(face));
+    _vertex_buffer_mark_dirty(vbmaw->vbma->vb,
+                              vbmaw->vbma->startIdx + vbma_idxVertices,
+                              DRAWBUFFER_VERTICES_PER_FACE);
     vbmaw->vbma->dirty = true;
 }
 
@@ -1267,7 +1458,8 @@ void vertex_buffer_mem_area_writer_done(VertexBufferMemAreaWriter *vbmaw) {
 VertexBufferMemAreaWriter *vertex_buffer_mem_area_writer_new(Shape *s,
                                                              Chunk *c,
                                                              VertexBufferMemArea *vbma,
-                                                             bool transparent) {
+                                                             bool transparent,
+                                                             uint8_t lod) {
     VertexBufferMemAreaWriter *vbmaw = (VertexBufferMemAreaWriter *)malloc(
         sizeof(VertexBufferMemAreaWriter));
     if (vbmaw == NULL) {
@@ -1276,7 +1468,8 @@ VertexBufferMemAreaWriter *vertex_buffer_mem_area_writer_new(Shape *s,
     vbmaw->s = s;
     vbmaw->c = c;
     vbmaw->isTransparent = transparent;
-    vertex_buffer_mem_area_writer_reset(vbmaw, vbma);
+    vbmaw->lod = lod;
+    vertex_buffer_mem_area_writer_reset(vbmaw, vbma, true);
     return vbmaw;
 }
 
@@ -1305,6 +1498,7 @@ void vertex_buffer_mem_area_make_gap(VertexBufferMemArea *vbma, bool transparent
 
     vbma->chunk = NULL;
     vbma->dirty = false;
+    vbma->cleared = false;
 
     // enlist with other gaps if some exist already
     if (vbma->vb->firstMemAreaGap == NULL) {
@@ -1365,6 +1559,9 @@ VertexBufferMemArea *vertex_buffer_mem_area_split_and_make_gap(VertexBufferMemAr
                                                           start,
                                                           vbma->startIdx + vbma_size,
                                                           diff);
+    // splitting a cleared gap
+    gap->cleared = vbma->cleared;
+    gap->dirty = vbma->cleared && vbma->dirty;
 
     // insert in global list
     if (vbma->_globalListNext != NULL) {
@@ -1397,7 +1594,11 @@ VertexBufferMemArea *vertex_buffer_mem_area_split_and_make_gap(VertexBufferMemAr
 
 void vertex_buffer_mem_area_flush(VertexBufferMemArea *vbma) {
     // write nothing to let vertex_buffer_mem_area_writer_done recycle all vbma
-    VertexBufferMemAreaWriter *writer = vertex_buffer_mem_area_writer_new(NULL, NULL, vbma, false);
+    VertexBufferMemAreaWriter *writer = vertex_buffer_mem_area_writer_new(NULL,
+                                                                          NULL,
+                                                                          vbma,
+                                                                          false,
+                                                                          vbma->vb->lod);
     vertex_buffer_mem_area_writer_done(writer);
     vertex_buffer_mem_area_writer_free(writer);
 }
@@ -1490,6 +1691,14 @@ void vertex_buffer_check_mem_area_chain(VertexBuffer *vb) {
 }
 #endif // VERTEX_BUFFER_DEBUG == 1
 
+void vertex_buffer_set_compaction_budget(uint32_t value) {
+    vertex_buffer_compaction_budget = value;
+}
+
+uint32_t vertex_buffer_get_compaction_budget(void) {
+    return vertex_buffer_compaction_budget;
+}
+
 void vertex_buffer_set_lighting_enabled(bool value) {
     vertex_buffer_lighting_enabled = value;
 }
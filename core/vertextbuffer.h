@@ -38,6 +38,11 @@ struct {
     uint32_t from, to;
 } typedef DrawBufferWriteSlice;
 
+// range of bytes within a vertex buffer's draw buffer
+struct {
+    uint32_t offset, size;
+} typedef VertexBufferRange;
+
 // A ChunkVertexMemory is an area in vertex buffer's memory that contains
 // vertices.
 // Vertices for a single chunk can ideally be stored in one single area.
@@ -53,7 +58,8 @@ typedef struct _VertexBufferMemAreaWriter VertexBufferMemAreaWriter;
 VertexBufferMemAreaWriter *vertex_buffer_mem_area_writer_new(Shape *s,
                                                              Chunk *c,
                                                              VertexBufferMemArea *vbma,
-                                                             bool transparent);
+                                                             bool transparent,
+                                                             uint8_t lod);
 void vertex_buffer_mem_area_writer_free(VertexBufferMemAreaWriter *vbmaw);
 
 void vertex_buffer_mem_area_writer_write(VertexBufferMemAreaWriter *vbmaw,
@@ -99,6 +105,20 @@ void vertex_buffer_fill_draw_slices(VertexBuffer *vb);
 void vertex_buffer_flush_draw_slices(VertexBuffer *vb);
 uint16_t vertex_buffer_get_nb_draw_slices(const VertexBuffer *vb);
 
+/// Chunk LOD level this vb holds vertices for, set when created by the shape
+void vertex_buffer_set_lod(VertexBuffer *vb, uint8_t lod);
+uint8_t vertex_buffer_get_lod(const VertexBuffer *vb);
+
+/// Vertices modified since last pop are tracked as sorted, merged ranges.
+/// Only vertices that actually changed are reported, a chunk re-meshed with the same faces doesn't
+/// add any range.
+uint32_t vertex_buffer_get_nb_dirty_ranges(const VertexBuffer *vb);
+
+/// Pops at most `max` dirty ranges, in bytes from the start of the draw buffer & by increasing
+/// offset, for renderers to issue the minimal set of sub-buffer updates.
+/// Returns the amount of ranges written in `ranges`.
+uint32_t vertex_buffer_pop_dirty_ranges(VertexBuffer *vb, VertexBufferRange *ranges, uint32_t max);
+
 uint32_t vertex_buffer_get_count(const VertexBuffer *vb);
 uint32_t vertex_buffer_get_max_count(const VertexBuffer *vb);
 
@@ -106,6 +126,10 @@ bool vertex_buffer_is_fragmented(const VertexBuffer *vb);
 
 void vertex_buffer_fill_gaps(VertexBuffer *vb);
 
+/// Fills gaps moving at most `budget` vertices, remaining gaps are zeroed and marked dirty so that
+/// draw slices cover them until next call. Returns the amount of vertices moved.
+uint32_t vertex_buffer_fill_gaps_with_budget(VertexBuffer *vb, const uint32_t budget);
+
 void vertex_buffer_mem_area_make_gap(VertexBufferMemArea *vbma, bool transparent);
 void vertex_buffer_mem_area_flush(VertexBufferMemArea *vbma);
 
@@ -120,6 +144,11 @@ bool vertex_buffer_has_dirty_mem_areas(const VertexBuffer *vb);
 
 void vertex_buffer_log_mem_areas(const VertexBuffer *vb);
 
+/// Max vertices moved per shape refresh to fill gaps, SHAPE_BUFFER_COMPACTION_BUDGET by default.
+/// UINT32_MAX to always fill all gaps immediately.
+void vertex_buffer_set_compaction_budget(uint32_t value);
+uint32_t vertex_buffer_get_compaction_budget(void);
+
 void vertex_buffer_set_lighting_enabled(bool value);
 bool vertex_buffer_get_lighting_enabled(void);
 
@@ -0,0 +1,676 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  world_stream.c
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+#include "world_stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cclog.h"
+#include "fifo_list.h"
+#include "index3d.h"
+#include "profiler.h"
+#include "thread.h"
+#include "zlib.h"
+
+#define WORLD_STREAM_REGION_VERSION 1
+#define WORLD_STREAM_REGION_NB_CHUNKS                                                              \
+    (WORLD_STREAM_REGION_SIZE * WORLD_STREAM_REGION_SIZE * WORLD_STREAM_REGION_SIZE)
+// region table entry offset for chunks stored empty, 0 is used for chunks not stored
+#define WORLD_STREAM_REGION_EMPTY_CHUNK UINT32_MAX
+#define WORLD_STREAM_CHUNK_DATA_SIZE ((uLong)CHUNK_SIZE_CUBE * (uLong)sizeof(Block))
+#define WORLD_STREAM_PATH_MAX_LENGTH 1024
+
+// shape chunk coordinates range, for all blocks of the chunk to be within SHAPE_COORDS_INT_T
+#define WORLD_STREAM_SHAPE_CHUNK_MIN (SHAPE_COORDS_MIN / CHUNK_SIZE)
+#define WORLD_STREAM_SHAPE_CHUNK_MAX (SHAPE_COORDS_MAX / CHUNK_SIZE)
+
+// a chunk loaded or being loaded
+typedef struct {
+    int3 coords; // world chunk coordinates
+    // checksum of blocks when loaded, to only write modified chunks
+    uint32_t crc;
+    bool loading;
+    char pad[3];
+} WorldStreamSlot;
+
+typedef struct {
+    Block *blocks; // save: blocks to write, NULL for an empty chunk
+    Chunk *chunk;  // load: result, NULL for an empty chunk
+    int3 coords;   // world chunk coordinates
+    uint32_t crc;  // load: checksum of loaded blocks
+    // load: origin epoch when requested, results from a previous origin are dropped
+    uint32_t epoch;
+    SHAPE_COORDS_INT3_T origin; // load: chunk origin in shape
+    bool save;
+    char pad[5];
+} WorldStreamRequest;
+
+struct _WorldStream {
+    Shape *shape;
+    char *directory;
+    world_stream_generate_func generate;
+    void *userdata;
+    Thread *thread;
+    ThreadCondition *condition;
+    // requests & results are protected by condition
+    FifoList *requests;
+    FifoList *results;
+    // world chunk coordinates -> WorldStreamSlot
+    Index3D *slots;
+    int3 focusPoints[WORLD_STREAM_MAX_FOCUS_POINTS]; // in world chunk coordinates
+    int3 origin;
+    uint32_t epoch;
+    uint32_t emptyCrc;
+    uint32_t nbLoaded;
+    uint32_t nbPending;
+    uint16_t radius;
+    uint8_t focusMask;
+    // loaded chunks have to be checked against focus points
+    bool needsScan;
+    // protected by condition
+    bool busy;
+    bool stop;
+    char pad[6];
+};
+
+// MARK: - Region files -
+
+static int32_t _world_stream_floor_div(const int32_t v, const int32_t d) {
+    return v >= 0 ? v / d : (v - (d - 1)) / d;
+}
+
+/// Opens region file containing chunk & returns chunk's entry offset in region table
+static FILE *_world_stream_region_open(const WorldStream *ws,
+                                       const int3 coords,
+                                       const bool write,
+                                       long *entryOffset) {
+    const int3 region = {_world_stream_floor_div(coords.x, WORLD_STREAM_REGION_SIZE),
+                         _world_stream_floor_div(coords.y, WORLD_STREAM_REGION_SIZE),
+                         _world_stream_floor_div(coords.z, WORLD_STREAM_REGION_SIZE)};
+    const int32_t index = (coords.x - region.x * WORLD_STREAM_REGION_SIZE) +
+                          (coords.y - region.y * WORLD_STREAM_REGION_SIZE) *
+                              WORLD_STREAM_REGION_SIZE +
+                          (coords.z - region.z * WORLD_STREAM_REGION_SIZE) *
+                              WORLD_STREAM_REGION_SIZE * WORLD_STREAM_REGION_SIZE;
+    *entryOffset = (long)(sizeof(uint32_t) + (size_t)index * 2 * sizeof(uint32_t));
+
+    char path[WORLD_STREAM_PATH_MAX_LENGTH];
+    snprintf(path,
+             WORLD_STREAM_PATH_MAX_LENGTH,
+             "%s/%d.%d.%d.region",
+             ws->directory,
+             region.x,
+             region.y,
+             region.z);
+
+    FILE *fd = fopen(path, "r+b");
+    if (fd == NULL && write) {
+        fd = fopen(path, "w+b");
+        if (fd == NULL) {
+            cclog_error("world stream: failed to create region file (%s)", path);
+            return NULL;
+        }
+        // version & empty table
+        const uint32_t version = WORLD_STREAM_REGION_VERSION;
+        uint32_t *table = (uint32_t *)calloc(WORLD_STREAM_REGION_NB_CHUNKS * 2, sizeof(uint32_t));
+        if (table == NULL || fwrite(&version, sizeof(uint32_t), 1, fd) != 1 ||
+            fwrite(table, sizeof(uint32_t) * 2, WORLD_STREAM_REGION_NB_CHUNKS, fd) !=
+                WORLD_STREAM_REGION_NB_CHUNKS) {
+            cclog_error("world stream: failed to write region table (%s)", path);
+            free(table);
+            fclose(fd);
+            return NULL;
+        }
+        free(table);
+        return fd;
+    }
+    if (fd == NULL) {
+        return NULL;
+    }
+
+    uint32_t version;
+    if (fread(&version, sizeof(uint32_t), 1, fd) != 1 || version != WORLD_STREAM_REGION_VERSION) {
+        cclog_error("world stream: region file version not supported (%s)", path);
+        fclose(fd);
+        return NULL;
+    }
+    return fd;
+}
+
+/// Returns false if chunk isn't stored, `blocks` untouched
+static bool _world_stream_region_read(const WorldStream *ws, const int3 coords, Block *blocks) {
+    long entryOffset;
+    FILE *fd = _world_stream_region_open(ws, coords, false, &entryOffset);
+    if (fd == NULL) {
+        return false;
+    }
+
+    uint32_t entry[2]; // offset, compressed size
+    if (fseek(fd, entryOffset, SEEK_SET) != 0 || fread(entry, sizeof(uint32_t), 2, fd) != 2) {
+        cclog_error("world stream: failed to read region table");
+        fclose(fd);
+        return false;
+    }
+    if (entry[0] == 0) {
+        fclose(fd);
+        return false;
+    }
+    if (entry[0] == WORLD_STREAM_REGION_EMPTY_CHUNK) {
+        fclose(fd);
+        return true;
+    }
+
+    void *compressedData = malloc(entry[1]);
+    if (compressedData == NULL) {
+        fclose(fd);
+        return false;
+    }
+    if (fseek(fd, (long)entry[0], SEEK_SET) != 0 || fread(compressedData, entry[1], 1, fd) != 1) {
+        cclog_error("world stream: failed to read chunk data");
+        free(compressedData);
+        fclose(fd);
+        return false;
+    }
+    fclose(fd);
+
+    uLong size = WORLD_STREAM_CHUNK_DATA_SIZE;
+    const int result = uncompress((Bytef *)blocks, &size, compressedData, entry[1]);
+    free(compressedData);
+    if (result != Z_OK || size != WORLD_STREAM_CHUNK_DATA_SIZE) {
+        cclog_error("world stream: failed to uncompress chunk data");
+        for (int i = 0; i < CHUNK_SIZE_CUBE; ++i) {
+            blocks[i].colorIndex = SHAPE_COLOR_INDEX_AIR_BLOCK;
+        }
+        return false;
+    }
+    return true;
+}
+
+/// Chunk data is appended, region files aren't compacted when chunks are written again
+static bool _world_stream_region_write(const WorldStream *ws,
+                                       const int3 coords,
+                                       const Block *blocks) {
+    long entryOffset;
+    FILE *fd = _world_stream_region_open(ws, coords, true, &entryOffset);
+    if (fd == NULL) {
+        return false;
+    }
+
+    uint32_t entry[2] = {WORLD_STREAM_REGION_EMPTY_CHUNK, 0};
+    if (blocks != NULL) {
+        uLong compressedSize = compressBound(WORLD_STREAM_CHUNK_DATA_SIZE);
+        void *compressedData = malloc(compressedSize);
+        if (compressedData == NULL ||
+            compress(compressedData,
+                     &compressedSize,
+                     (const Bytef *)blocks,
+                     WORLD_STREAM_CHUNK_DATA_SIZE) != Z_OK) {
+            cclog_error("world stream: failed to compress chunk data");
+            free(compressedData);
+            fclose(fd);
+            return false;
+        }
+        if (fseek(fd, 0, SEEK_END) != 0) {
+            free(compressedData);
+            fclose(fd);
+            return false;
+        }
+        entry[0] = (uint32_t)ftell(fd);
+        entry[1] = (uint32_t)compressedSize;
+        if (fwrite(compressedData, compressedSize, 1, fd) != 1) {
+            cclog_error("world stream: failed to write chunk data");
+            free(compressedData);
+            fclose(fd);
+            return false;
+        }
+        free(compressedData);
+    }
+
+    // table entry written last, a failed write leaves previous version of the chunk
+    if (fseek(fd, entryOffset, SEEK_SET) != 0 || fwrite(entry, sizeof(uint32_t), 2, fd) != 2) {
+        cclog_error("world stream: failed to write region table");
+        fclose(fd);
+        return false;
+    }
+    return fclose(fd) == 0;
+}
+
+// MARK: - Background thread -
+
+static uint32_t _world_stream_crc(const Block *blocks) {
+    return (uint32_t)crc32(0, (const Bytef *)blocks, (uInt)WORLD_STREAM_CHUNK_DATA_SIZE);
+}
+
+static void _world_stream_process(WorldStream *ws, WorldStreamRequest *r) {
+    if (r->save) {
+        PROFILER_ZONE_BEGIN("world_stream_save");
+        _world_stream_region_write(ws, r->coords, r->blocks);
+        free(r->blocks);
+        r->blocks = NULL;
+        PROFILER_ZONE_END();
+        return;
+    }
+
+    PROFILER_ZONE_BEGIN("world_stream_load");
+    Block *blocks = (Block *)malloc(WORLD_STREAM_CHUNK_DATA_SIZE);
+    if (blocks == NULL) {
+        r->crc = ws->emptyCrc;
+        PROFILER_ZONE_END();
+        return;
+    }
+    for (int i = 0; i < CHUNK_SIZE_CUBE; ++i) {
+        blocks[i].colorIndex = SHAPE_COLOR_INDEX_AIR_BLOCK;
+    }
+    if (_world_stream_region_read(ws, r->coords, blocks) == false && ws->generate != NULL) {
+        ws->generate(r->coords, blocks, ws->userdata);
+    }
+    r->crc = _world_stream_crc(blocks);
+
+    r->chunk = chunk_new(r->origin);
+    if (chunk_set_blocks(r->chunk, blocks) == 0) {
+        chunk_free(r->chunk, false);
+        r->chunk = NULL;
+    }
+    free(blocks);
+    PROFILER_ZONE_END();
+}
+
+static void _world_stream_worker_main(void *userdata) {
+    WorldStream *ws = (WorldStream *)userdata;
+
+    thread_condition_lock(ws->condition);
+    while (true) {
+        while (ws->stop == false && fifo_list_get_size(ws->requests) == 0) {
+            thread_condition_wait(ws->condition);
+        }
+        WorldStreamRequest *r = (WorldStreamRequest *)fifo_list_pop(ws->requests);
+        if (r == NULL) {
+            break; // stopped & all requests processed
+        }
+        ws->busy = true;
+        thread_condition_unlock(ws->condition);
+
+        _world_stream_process(ws, r);
+
+        thread_condition_lock(ws->condition);
+        if (r->save) {
+            free(r);
+        } else {
+            fifo_list_push(ws->results, r);
+        }
+        ws->busy = false;
+        thread_condition_broadcast(ws->condition);
+    }
+    thread_condition_unlock(ws->condition);
+}
+
+static void _world_stream_push_request(WorldStream *ws, WorldStreamRequest *r) {
+    thread_condition_lock(ws->condition);
+    fifo_list_push(ws->requests, r);
+    thread_condition_broadcast(ws->condition);
+    thread_condition_unlock(ws->condition);
+}
+
+static void _world_stream_result_free(void *ptr) {
+    WorldStreamRequest *r = (WorldStreamRequest *)ptr;
+    if (r->chunk != NULL) {
+        chunk_free(r->chunk, false);
+    }
+    free(r->blocks);
+    free(r);
+}
+
+// MARK: - Slots -
+
+static SHAPE_COORDS_INT3_T _world_stream_get_shape_chunk_coords(const WorldStream *ws,
+                                                                const int3 coords,
+                                                                bool *inRange) {
+    const int3 c = {coords.x - ws->origin.x, coords.y - ws->origin.y, coords.z - ws->origin.z};
+    *inRange = c.x >= WORLD_STREAM_SHAPE_CHUNK_MIN && c.x <= WORLD_STREAM_SHAPE_CHUNK_MAX &&
+               c.y >= WORLD_STREAM_SHAPE_CHUNK_MIN && c.y <= WORLD_STREAM_SHAPE_CHUNK_MAX &&
+               c.z >= WORLD_STREAM_SHAPE_CHUNK_MIN && c.z <= WORLD_STREAM_SHAPE_CHUNK_MAX;
+    return (SHAPE_COORDS_INT3_T){(SHAPE_COORDS_INT_T)c.x,
+                                 (SHAPE_COORDS_INT_T)c.y,
+                                 (SHAPE_COORDS_INT_T)c.z};
+}
+
+/// Writes chunk if modified since loaded, and removes it from the shape if `evict`
+static void _world_stream_save_slot(WorldStream *ws, WorldStreamSlot *slot, const bool evict) {
+    bool inRange;
+    const SHAPE_COORDS_INT3_T chunkCoords = _world_stream_get_shape_chunk_coords(ws,
+                                                                                 slot->coords,
+                                                                                 &inRange);
+    // edits may have created, emptied or removed the chunk since it was loaded
+    const Chunk *c = (const Chunk *)index3d_get(shape_get_chunks(ws->shape),
+                                                chunkCoords.x,
+                                                chunkCoords.y,
+                                                chunkCoords.z);
+    Block *blocks = NULL;
+    uint32_t crc = ws->emptyCrc;
+    if (c != NULL && chunk_get_nb_blocks(c) > 0) {
+        blocks = (Block *)malloc(WORLD_STREAM_CHUNK_DATA_SIZE);
+        if (blocks == NULL) {
+            cclog_error("world stream: failed to save chunk");
+            crc = slot->crc;
+        } else {
+            memcpy(blocks, octree_get_elements(chunk_get_octree(c)), WORLD_STREAM_CHUNK_DATA_SIZE);
+            crc = _world_stream_crc(blocks);
+        }
+    }
+
+    if (crc != slot->crc) {
+        WorldStreamRequest *r = (WorldStreamRequest *)calloc(1, sizeof(WorldStreamRequest));
+        if (r != NULL) {
+            r->blocks = blocks;
+            r->coords = slot->coords;
+            r->save = true;
+            _world_stream_push_request(ws, r);
+            blocks = NULL;
+            slot->crc = crc;
+        }
+    }
+    free(blocks);
+
+    if (evict && c != NULL) {
+        shape_remove_chunk(ws->shape, chunkCoords);
+    }
+}
+
+static bool _world_stream_is_in_range(const WorldStream *ws,
+                                      const int3 coords,
+                                      const int32_t radius) {
+    for (uint8_t i = 0; i < WORLD_STREAM_MAX_FOCUS_POINTS; ++i) {
+        if ((ws->focusMask & (1 << i)) == 0) {
+            continue;
+        }
+        const int3 *f = &ws->focusPoints[i];
+        if (abs(coords.x - f->x) <= radius && abs(coords.y - f->y) <= radius &&
+            abs(coords.z - f->z) <= radius) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _world_stream_request_load(WorldStream *ws, const int3 coords) {
+    if (index3d_get(ws->slots, coords.x, coords.y, coords.z) != NULL) {
+        return;
+    }
+    bool inRange;
+    const SHAPE_COORDS_INT3_T chunkCoords = _world_stream_get_shape_chunk_coords(ws,
+                                                                                 coords,
+                                                                                 &inRange);
+    if (inRange == false) {
+        return;
+    }
+
+    WorldStreamSlot *slot = (WorldStreamSlot *)malloc(sizeof(WorldStreamSlot));
+    WorldStreamRequest *r = (WorldStreamRequest *)calloc(1, sizeof(WorldStreamRequest));
+    if (slot == NULL || r == NULL) {
+        free(slot);
+        free(r);
+        return;
+    }
+    slot->coords = coords;
+    slot->crc = ws->emptyCrc;
+    slot->loading = true;
+    index3d_insert(ws->slots, slot, coords.x, coords.y, coords.z, NULL);
+    ++ws->nbPending;
+
+    r->coords = coords;
+    r->epoch = ws->epoch;
+    r->origin = (SHAPE_COORDS_INT3_T){(SHAPE_COORDS_INT_T)(chunkCoords.x * CHUNK_SIZE),
+                                      (SHAPE_COORDS_INT_T)(chunkCoords.y * CHUNK_SIZE),
+                                      (SHAPE_COORDS_INT_T)(chunkCoords.z * CHUNK_SIZE)};
+    _world_stream_push_request(ws, r);
+}
+
+/// Evicts all loaded chunks, or only the ones out of reach of all focus points
+static void _world_stream_evict(WorldStream *ws, const bool all) {
+    const int32_t radius = (int32_t)ws->radius + 1;
+    Index3DIterator *it = index3d_iterator_new(ws->slots);
+    WorldStreamSlot *slot;
+    while ((slot = (WorldStreamSlot *)index3d_iterator_pointer(it)) != NULL) {
+        // chunks being loaded are considered once added to the shape, unless origin changes
+        if (all || (slot->loading == false && _world_stream_is_in_range(ws, slot->coords, radius) ==
+                                                  false)) {
+            if (slot->loading) {
+                --ws->nbPending;
+            } else {
+                _world_stream_save_slot(ws, slot, true);
+                --ws->nbLoaded;
+            }
+            index3d_remove(ws->slots, slot->coords.x, slot->coords.y, slot->coords.z, it);
+            free(slot);
+        } else {
+            index3d_iterator_next(it);
+        }
+    }
+    index3d_iterator_free(it);
+}
+
+// MARK: - public functions -
+
+WorldStream *world_stream_new(Shape *shape,
+                              const char *directory,
+                              world_stream_generate_func generate,
+                              void *userdata) {
+    if (shape == NULL || directory == NULL) {
+        return NULL;
+    }
+    WorldStream *ws = (WorldStream *)malloc(sizeof(WorldStream));
+    if (ws == NULL) {
+        return NULL;
+    }
+    ws->shape = shape;
+    const size_t len = strlen(directory);
+    ws->directory = (char *)malloc(len + 1);
+    memcpy(ws->directory, directory, len + 1);
+    ws->generate = generate;
+    ws->userdata = userdata;
+    ws->condition = thread_condition_new();
+    ws->requests = fifo_list_new();
+    ws->results = fifo_list_new();
+    ws->slots = index3d_new();
+    memset(ws->focusPoints, 0, sizeof(ws->focusPoints));
+    ws->origin = int3_zero;
+    ws->epoch = 0;
+    ws->nbLoaded = 0;
+    ws->nbPending = 0;
+    ws->radius = WORLD_STREAM_DEFAULT_RADIUS;
+    ws->focusMask = 0;
+    ws->needsScan = false;
+    ws->busy = false;
+    ws->stop = false;
+
+    Block *air = (Block *)malloc(WORLD_STREAM_CHUNK_DATA_SIZE);
+    for (int i = 0; i < CHUNK_SIZE_CUBE; ++i) {
+        air[i].colorIndex = SHAPE_COLOR_INDEX_AIR_BLOCK;
+    }
+    ws->emptyCrc = _world_stream_crc(air);
+    free(air);
+
+    ws->thread = thread_new(_world_stream_worker_main, ws);
+    if (ws->thread == NULL) {
+        cclog_error("world stream: failed to start background thread");
+        index3d_free(ws->slots);
+        fifo_list_free(ws->results, NULL);
+        fifo_list_free(ws->requests, NULL);
+        thread_condition_free(ws->condition);
+        free(ws->directory);
+        free(ws);
+        return NULL;
+    }
+    return ws;
+}
+
+void world_stream_free(WorldStream *ws) {
+    if (ws == NULL) {
+        return;
+    }
+    world_stream_flush(ws);
+
+    thread_condition_lock(ws->condition);
+    ws->stop = true;
+    thread_condition_broadcast(ws->condition);
+    thread_condition_unlock(ws->condition);
+    thread_join_and_free(ws->thread);
+
+    fifo_list_free(ws->results, _world_stream_result_free);
+    fifo_list_free(ws->requests, _world_stream_result_free);
+    index3d_flush(ws->slots, free);
+    index3d_free(ws->slots);
+    thread_condition_free(ws->condition);
+    free(ws->directory);
+    free(ws);
+}
+
+void world_stream_set_focus_point(WorldStream *ws, const uint8_t id, const int3 coords) {
+    if (id >= WORLD_STREAM_MAX_FOCUS_POINTS) {
+        return;
+    }
+    const int3 c = {_world_stream_floor_div(coords.x, CHUNK_SIZE),
+                    _world_stream_floor_div(coords.y, CHUNK_SIZE),
+                    _world_stream_floor_div(coords.z, CHUNK_SIZE)};
+    int3 *f = &ws->focusPoints[id];
+    if ((ws->focusMask & (1 << id)) == 0 || f->x != c.x || f->y != c.y || f->z != c.z) {
+        *f = c;
+        ws->focusMask |= (uint8_t)(1 << id);
+        ws->needsScan = true;
+    }
+}
+
+void world_stream_remove_focus_point(WorldStream *ws, const uint8_t id) {
+    if (id < WORLD_STREAM_MAX_FOCUS_POINTS && (ws->focusMask & (1 << id)) != 0) {
+        ws->focusMask &= (uint8_t) ~(1 << id);
+        ws->needsScan = true;
+    }
+}
+
+void world_stream_set_radius(WorldStream *ws, const uint16_t radius) {
+    if (ws->radius != radius) {
+        ws->radius = radius;
+        ws->needsScan = true;
+    }
+}
+
+uint16_t world_stream_get_radius(const WorldStream *ws) {
+    return ws->radius;
+}
+
+void world_stream_set_origin(WorldStream *ws, const int3 origin) {
+    if (ws->origin.x == origin.x && ws->origin.y == origin.y && ws->origin.z == origin.z) {
+        return;
+    }
+    _world_stream_evict(ws, true);
+    ws->origin = origin;
+    ++ws->epoch;
+    ws->needsScan = true;
+}
+
+int3 world_stream_get_origin(const WorldStream *ws) {
+    return ws->origin;
+}
+
+void world_stream_update(WorldStream *ws) {
+    PROFILER_ZONE_BEGIN("world_stream_update");
+
+    // add loaded chunks to the shape
+    uint32_t budget = WORLD_STREAM_MAX_CHUNKS_PER_UPDATE;
+    while (budget > 0) {
+        thread_condition_lock(ws->condition);
+        WorldStreamRequest *r = (WorldStreamRequest *)fifo_list_pop(ws->results);
+        thread_condition_unlock(ws->condition);
+        if (r == NULL) {
+            break;
+        }
+
+        WorldStreamSlot *slot = NULL;
+        if (r->epoch == ws->epoch) {
+            slot = (WorldStreamSlot *)index3d_get(ws->slots, r->coords.x, r->coords.y, r->coords.z);
+        }
+        if (slot != NULL && slot->loading) {
+            slot->loading = false;
+            slot->crc = r->crc;
+            --ws->nbPending;
+            ++ws->nbLoaded;
+            if (r->chunk != NULL) {
+                if (shape_add_chunk(ws->shape, r->chunk)) {
+                    r->chunk = NULL;
+                } else {
+                    // chunk created by edits while loading, written when evicted
+                    slot->crc = ~r->crc;
+                }
+            }
+            --budget;
+            // may have to be evicted already
+            ws->needsScan = true;
+        }
+        _world_stream_result_free(r);
+    }
+
+    if (ws->needsScan) {
+        ws->needsScan = false;
+        _world_stream_evict(ws, false);
+
+        // nearest chunks requested first
+        const int32_t radius = (int32_t)ws->radius;
+        for (int32_t d = 0; d <= radius; ++d) {
+            for (uint8_t i = 0; i < WORLD_STREAM_MAX_FOCUS_POINTS; ++i) {
+                if ((ws->focusMask & (1 << i)) == 0) {
+                    continue;
+                }
+                const int3 f = ws->focusPoints[i];
+                for (int32_t z = -d; z <= d; ++z) {
+                    for (int32_t y = -d; y <= d; ++y) {
+                        for (int32_t x = -d; x <= d; ++x) {
+                            if (abs(x) == d || abs(y) == d || abs(z) == d) {
+                                _world_stream_request_load(ws,
+                                                           (int3){f.x + x, f.y + y, f.z + z});
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    PROFILER_ZONE_END();
+}
+
+void world_stream_flush(WorldStream *ws) {
+    Index3DIterator *it = index3d_iterator_new(ws->slots);
+    WorldStreamSlot *slot;
+    while ((slot = (WorldStreamSlot *)index3d_iterator_pointer(it)) != NULL) {
+        if (slot->loading == false) {
+            _world_stream_save_slot(ws, slot, false);
+        }
+        index3d_iterator_next(it);
+    }
+    index3d_iterator_free(it);
+
+    thread_condition_lock(ws->condition);
+    while (fifo_list_get_size(ws->requests) > 0 || ws->busy) {
+        thread_condition_wait(ws->condition);
+    }
+    thread_condition_unlock(ws->condition);
+}
+
+uint32_t world_stream_get_nb_loaded_chunks(const WorldStream *ws) {
+    return ws->nbLoaded;
+}
+
+uint32_t world_stream_get_nb_pending_chunks(const WorldStream *ws) {
+    return ws->nbPending;
+}
+
+bool world_stream_is_chunk_loaded(const WorldStream *ws, const int3 coords) {
+    const WorldStreamSlot *slot = (const WorldStreamSlot *)
+        index3d_get(ws->slots, coords.x, coords.y, coords.z);
+    return slot != NULL && slot->loading == false;
+}
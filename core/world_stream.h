@@ -0,0 +1,86 @@
+// -------------------------------------------------------------
+//  Cubzh Core
+//  world_stream.h
+//  Created by Adrien Duermael on October 17, 2026.
+// -------------------------------------------------------------
+
+// Streaming map mode: chunks of a map shape are paged in & out around focus points.
+// Chunks are loaded from a region file store on local disk (or generated when not stored yet) by a
+// background thread, and written back when evicted, only if they were modified.
+//
+// World chunk coordinates are 32-bit, the shape only holds the chunks around focus points:
+// shape block coordinates = world block coordinates - origin * CHUNK_SIZE, origin being in world
+// chunk coordinates. Chunks that can't be represented in shape coordinates aren't loaded, the
+// origin should be moved closer when focus points travel far (see world_stream_set_origin).
+//
+// Region files group WORLD_STREAM_REGION_SIZE^3 chunks. Block color indexes are stored as is, a
+// store can only be used with the palette it was written with.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "block.h"
+#include "int3.h"
+#include "shape.h"
+
+#define WORLD_STREAM_REGION_SIZE 8
+#define WORLD_STREAM_MAX_FOCUS_POINTS 4
+#define WORLD_STREAM_DEFAULT_RADIUS 4
+// loaded chunks added to the shape per world_stream_update, others wait for next updates
+#define WORLD_STREAM_MAX_CHUNKS_PER_UPDATE 16
+
+typedef struct _WorldStream WorldStream;
+
+/// Fills `blocks` (CHUNK_SIZE^3, air by default, x + y * CHUNK_SIZE + z * CHUNK_SIZE^2) for a chunk
+/// not found in the store. Called on the background thread.
+typedef void (*world_stream_generate_func)(const int3 coords, Block *blocks, void *userdata);
+
+/// `directory` must exist, region files are created in it. `generate` is optional, chunks not
+/// found in the store are then empty. `shape` must outlive the stream.
+/// Returns NULL if the background thread can't be started.
+WorldStream *world_stream_new(Shape *shape,
+                              const char *directory,
+                              world_stream_generate_func generate,
+                              void *userdata);
+
+/// Writes modified chunks & waits for the background thread to be done, chunks stay in the shape
+void world_stream_free(WorldStream *ws);
+
+/// Focus point in world block coordinates, chunks within radius are loaded around it
+void world_stream_set_focus_point(WorldStream *ws, const uint8_t id, const int3 coords);
+void world_stream_remove_focus_point(WorldStream *ws, const uint8_t id);
+
+/// Chunks within `radius` chunks of a focus point are loaded, chunks farther than `radius + 1`
+/// are evicted (not evicting right at the border avoids paging chunks in & out repeatedly)
+void world_stream_set_radius(WorldStream *ws, const uint16_t radius);
+uint16_t world_stream_get_radius(const WorldStream *ws);
+
+/// Evicts all chunks & loads them again around focus points with new shape coordinates
+void world_stream_set_origin(WorldStream *ws, const int3 origin);
+int3 world_stream_get_origin(const WorldStream *ws);
+
+/// Adds loaded chunks to the shape, evicts chunks out of reach & requests missing ones.
+/// To be called once per frame, from the thread owning the shape.
+void world_stream_update(WorldStream *ws);
+
+/// Writes all modified chunks (without evicting them) & waits for the background thread
+/// to process all requests
+void world_stream_flush(WorldStream *ws);
+
+/// Chunks added to the shape, including empty ones
+uint32_t world_stream_get_nb_loaded_chunks(const WorldStream *ws);
+
+/// Chunks requested, not added to the shape yet
+uint32_t world_stream_get_nb_pending_chunks(const WorldStream *ws);
+
+bool world_stream_is_chunk_loaded(const WorldStream *ws, const int3 coords);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
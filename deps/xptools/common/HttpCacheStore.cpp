@@ -0,0 +1,930 @@
+//
+//  HttpCacheStore.cpp
+//  xptools
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//  Copyright © 2026 voxowl. All rights reserved.
+//
+
+#include "HttpCacheStore.hpp"
+
+// C++
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if !defined(__VX_PLATFORM_WINDOWS) && !defined(__VX_PLATFORM_WASM)
+#define VX_HTTP_CACHE_USE_MMAP
+#include <sys/mman.h>
+#endif
+
+// xptools
+#include "filesystem.hpp"
+#include "vxlog.h"
+
+#include "BZMD5.hpp"
+
+#define VX_HTTP_CACHE_INDEX_MAGICBYTES "CUBZHCACHEIDX!"
+#define VX_HTTP_CACHE_INDEX_MAGICBYTES_LEN 14
+#define VX_HTTP_CACHE_INDEX_FORMAT_V2 2 // uint8
+#define VX_HTTP_CACHE_INDEX_FILENAME "index"
+#define VX_HTTP_CACHE_PACK_FILENAME_PREFIX "pack."
+// pack is compacted when dead bytes exceed live bytes and this threshold
+#define VX_HTTP_CACHE_COMPACTION_MIN_DEAD_SIZE 1048576 // 1MB
+// smaller segments are merged when the pack has more of them
+#define VX_HTTP_CACHE_MAX_SEGMENTS 16
+// buffered changes are written once one of these limits is reached
+#define VX_HTTP_CACHE_FLUSH_PENDING_SIZE 1048576 // 1MB
+#define VX_HTTP_CACHE_FLUSH_CHANGES 64
+#define VX_HTTP_CACHE_FLUSH_DELAY_SECONDS 5
+
+namespace vx {
+
+// --------------------------------------------------
+// MARK: - File utils -
+// --------------------------------------------------
+
+static bool _writeBytes(const void *bytes, const size_t len, FILE * const fd) {
+    return len == 0 || fwrite(bytes, sizeof(char), len, fd) == len;
+}
+
+static void _appendUint16(const uint16_t value, std::string& out) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(uint16_t));
+}
+
+static void _appendUint32(const uint32_t value, std::string& out) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(uint32_t));
+}
+
+static void _appendUint64(const uint64_t value, std::string& out) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(uint64_t));
+}
+
+static void _appendString(const std::string& value, std::string& out) {
+    _appendUint32(static_cast<uint32_t>(value.length()), out);
+    out.append(value);
+}
+
+static bool _readUint16(uint16_t& value, FILE * const fd) {
+    return fread(&value, sizeof(uint16_t), 1, fd) == 1;
+}
+
+static bool _readUint32(uint32_t& value, FILE * const fd) {
+    return fread(&value, sizeof(uint32_t), 1, fd) == 1;
+}
+
+static bool _readUint64(uint64_t& value, FILE * const fd) {
+    return fread(&value, sizeof(uint64_t), 1, fd) == 1;
+}
+
+static bool _readString(std::string& value, FILE * const fd) {
+    uint32_t len = 0;
+    if (_readUint32(len, fd) == false) {
+        return false;
+    }
+    value.resize(len);
+    return len == 0 || fread(&value[0], sizeof(char), len, fd) == len;
+}
+
+// --------------------------------------------------
+// MARK: - HttpCacheMapping -
+// --------------------------------------------------
+
+std::shared_ptr<HttpCacheMapping> HttpCacheMapping::make(FILE * const fd, const size_t size) {
+    if (fd == nullptr || size == 0) {
+        return nullptr;
+    }
+
+#if defined(VX_HTTP_CACHE_USE_MMAP)
+    // in-memory storage files have no file descriptor, they're read instead
+    const int fdNumber = fileno(fd);
+    if (fdNumber >= 0) {
+        void *addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fdNumber, 0);
+        if (addr != MAP_FAILED) {
+            return std::shared_ptr<HttpCacheMapping>(new HttpCacheMapping(static_cast<const char *>(addr), size, true));
+        }
+    }
+#endif
+
+    char *buf = static_cast<char *>(malloc(size));
+    if (buf == nullptr) {
+        return nullptr;
+    }
+    if (fseek(fd, 0, SEEK_SET) != 0 || fread(buf, sizeof(char), size, fd) != size) {
+        free(buf);
+        return nullptr;
+    }
+    return std::shared_ptr<HttpCacheMapping>(new HttpCacheMapping(buf, size, false));
+}
+
+std::shared_ptr<HttpCacheMapping> HttpCacheMapping::copy(const char *data, const size_t size) {
+    if (data == nullptr || size == 0) {
+        return nullptr;
+    }
+    char *buf = static_cast<char *>(malloc(size));
+    if (buf == nullptr) {
+        return nullptr;
+    }
+    memcpy(buf, data, size);
+    return std::shared_ptr<HttpCacheMapping>(new HttpCacheMapping(buf, size, false));
+}
+
+HttpCacheMapping::HttpCacheMapping(const char *data, const size_t size, const bool mapped) :
+_data(data),
+_size(size),
+_mapped(mapped) {}
+
+HttpCacheMapping::~HttpCacheMapping() {
+#if defined(VX_HTTP_CACHE_USE_MMAP)
+    if (_mapped) {
+        munmap(const_cast<char *>(_data), _size);
+        return;
+    }
+#endif
+    free(const_cast<char *>(_data));
+}
+
+// --------------------------------------------------
+// MARK: - HttpCacheBody -
+// --------------------------------------------------
+
+HttpCacheBody::HttpCacheBody(std::shared_ptr<HttpCacheMapping> mapping, const size_t offset, const size_t size) :
+_mapping(mapping),
+_offset(offset),
+_size(size) {}
+
+// --------------------------------------------------
+// MARK: - HttpCacheStore -
+// --------------------------------------------------
+
+HttpCacheStore::Entry::Entry() :
+url(),
+etag(),
+creationTime(0),
+maxAge(0),
+statusCode(0),
+headers(),
+body(nullptr) {}
+
+HttpCacheStore::Blob::Blob() :
+pending(nullptr),
+offset(0),
+size(0),
+segment(0),
+refCount(0) {}
+
+HttpCacheStore::Record::Record() :
+etag(),
+creationTime(0),
+maxAge(0),
+statusCode(0),
+headers(),
+blobKey(),
+metadataSize(0),
+lruIt() {}
+
+HttpCacheStore::HttpCacheStore(const std::string& dir, const uint64_t maxSize) :
+_dir(dir),
+_maxSize(maxSize),
+_size(0),
+_deadSize(0),
+_pendingSize(0),
+_segments(),
+_obsoleteSegments(),
+_nextSegment(0),
+_changes(0),
+_firstChangeTime(),
+_records(),
+_blobs(),
+_lru(),
+_segmentMappings() {
+    if (_loadIndex() == false) {
+        // missing or corrupted index, start from scratch
+        // (it also removes files from the legacy one-file-per-URL cache)
+        clear();
+    }
+    const size_t count = _records.size();
+    _evictIfNeeded();
+    if (_records.size() != count) {
+        _didChange();
+    }
+}
+
+HttpCacheStore::~HttpCacheStore() {
+    flush();
+}
+
+bool HttpCacheStore::put(const std::string& url,
+                         const std::string& etag,
+                         const uint32_t creationTime,
+                         const uint32_t maxAge,
+                         const uint16_t statusCode,
+                         const std::unordered_map<std::string, std::string>& headers,
+                         const char *bodyData,
+                         const size_t bodySize) {
+
+    if (bodyData == nullptr && bodySize > 0) {
+        return false;
+    }
+
+    const std::string blobKey = _blobKey(bodyData, bodySize);
+
+    auto blobIt = _blobs.find(blobKey);
+    if (blobIt == _blobs.end()) {
+        // new content, kept in memory until it's written in a new pack segment
+        Blob blob;
+        blob.size = bodySize;
+        if (bodySize > 0) {
+            blob.pending = HttpCacheMapping::copy(bodyData, bodySize);
+            if (blob.pending == nullptr) {
+                return false;
+            }
+            _pendingSize += bodySize;
+        }
+        blobIt = _blobs.emplace(blobKey, blob).first;
+    } else if (blobIt->second.refCount == 0) {
+        // revived blob (still in the pack, not compacted yet)
+        _deadSize -= blobIt->second.size;
+    }
+
+    // reference blob before replacing the previous record,
+    // so that a body that didn't change (304 revalidation) doesn't become dead.
+    Blob& blob = blobIt->second;
+    if (blob.refCount == 0) {
+        _size += blob.size;
+    }
+    blob.refCount += 1;
+
+    auto existing = _records.find(url);
+    if (existing != _records.end()) {
+        _removeRecord(existing);
+    }
+
+    Record record;
+    record.etag = etag;
+    record.creationTime = creationTime;
+    record.maxAge = maxAge;
+    record.statusCode = statusCode;
+    record.headers = headers;
+    record.blobKey = blobKey;
+    record.metadataSize = _metadataSize(url, record);
+
+    _size += record.metadataSize;
+
+    _lru.push_front(url);
+    record.lruIt = _lru.begin();
+    _records.emplace(url, std::move(record));
+
+    _evictIfNeeded();
+    _didChange();
+
+    return true;
+}
+
+bool HttpCacheStore::get(const std::string& url, Entry& out) {
+    _flushIfNeeded();
+
+    auto it = _records.find(url);
+    if (it == _records.end()) {
+        return false;
+    }
+
+    const Record& record = it->second;
+    auto blobIt = _blobs.find(record.blobKey);
+    if (blobIt == _blobs.end()) {
+        _removeRecord(it);
+        return false;
+    }
+    const Blob& blob = blobIt->second;
+
+    HttpCacheBody_SharedPtr body = nullptr;
+    if (blob.size == 0) {
+        body = std::make_shared<HttpCacheBody>(nullptr, 0, 0);
+    } else if (blob.pending != nullptr) {
+        body = std::make_shared<HttpCacheBody>(blob.pending, 0, static_cast<size_t>(blob.size));
+    } else {
+        std::shared_ptr<HttpCacheMapping> mapping = _getSegmentMapping(blob.segment);
+        if (mapping == nullptr) {
+            return false;
+        }
+        body = std::make_shared<HttpCacheBody>(mapping, static_cast<size_t>(blob.offset), static_cast<size_t>(blob.size));
+    }
+
+    out.url = url;
+    out.etag = record.etag;
+    out.creationTime = record.creationTime;
+    out.maxAge = record.maxAge;
+    out.statusCode = record.statusCode;
+    out.headers = record.headers;
+    out.body = body;
+
+    // mark as most recently used
+    // (order is persisted with the next index write)
+    _lru.splice(_lru.begin(), _lru, record.lruIt);
+
+    return true;
+}
+
+bool HttpCacheStore::remove(const std::string& url) {
+    auto it = _records.find(url);
+    if (it == _records.end()) {
+        return false;
+    }
+    _removeRecord(it);
+    _didChange();
+    return true;
+}
+
+void HttpCacheStore::clear() {
+    _records.clear();
+    _blobs.clear();
+    _lru.clear();
+    _segments.clear();
+    _obsoleteSegments.clear();
+    _segmentMappings.clear();
+    _size = 0;
+    _deadSize = 0;
+    _pendingSize = 0;
+    _nextSegment = 0;
+    _changes = 0;
+    _removeAllFiles();
+    _saveIndex();
+}
+
+bool HttpCacheStore::flush() {
+    if (_changes == 0) {
+        return true;
+    }
+    // new segment and index are written first,
+    // segments left out by compaction are only removed once the new index refers to them.
+    if (_writePendingBlobs() == false) {
+        _firstChangeTime = std::chrono::steady_clock::now();
+        return false;
+    }
+    _compactPackIfNeeded();
+    if (_saveIndex() == false) {
+        _firstChangeTime = std::chrono::steady_clock::now();
+        return false;
+    }
+    _removeObsoleteSegments();
+    _changes = 0;
+    return true;
+}
+
+void HttpCacheStore::setMaxSize(const uint64_t maxSize) {
+    _maxSize = maxSize;
+    const size_t count = _records.size();
+    _evictIfNeeded();
+    if (_records.size() != count) {
+        _didChange();
+    }
+}
+
+uint64_t HttpCacheStore::getMaxSize() const {
+    return _maxSize;
+}
+
+uint64_t HttpCacheStore::getSize() const {
+    return _size;
+}
+
+size_t HttpCacheStore::getEntryCount() const {
+    return _records.size();
+}
+
+size_t HttpCacheStore::getBlobCount() const {
+    size_t count = 0;
+    for (auto& kv : _blobs) {
+        if (kv.second.refCount > 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+uint64_t HttpCacheStore::getPackSize() const {
+    uint64_t size = _pendingSize;
+    for (auto& kv : _segments) {
+        size += kv.second;
+    }
+    return size;
+}
+
+size_t HttpCacheStore::getSegmentCount() const {
+    return _segments.size();
+}
+
+// MARK: - Private -
+
+std::string HttpCacheStore::_indexPath() const {
+    return _dir + "/" + VX_HTTP_CACHE_INDEX_FILENAME;
+}
+
+std::string HttpCacheStore::_segmentPath(const uint32_t segment) const {
+    return _dir + "/" + VX_HTTP_CACHE_PACK_FILENAME_PREFIX + std::to_string(segment);
+}
+
+// Index file format (little endian, native):
+// - magic bytes
+// - format version (uint8)
+// - segment count (uint32), then for each segment:
+//   ID (uint32), size (uint64)
+// - blob count (uint32), then for each blob:
+//   key (string), segment ID (uint32), offset (uint64), size (uint64)
+// - record count (uint32), then for each record, from most to least recently used:
+//   url (string), blob key (string), etag (string), creation time (uint32),
+//   max-age (uint32), status code (uint16), header count (uint32), headers (string pairs)
+// - magic bytes (trailer, to detect incomplete writes)
+bool HttpCacheStore::_loadIndex() {
+    FILE *fd = vx::fs::openStorageFile(_indexPath(), "rb");
+    if (fd == nullptr) {
+        return false;
+    }
+
+    bool ok = false;
+    char magic[VX_HTTP_CACHE_INDEX_MAGICBYTES_LEN];
+    uint8_t version = 0;
+    uint32_t segmentCount = 0;
+    uint32_t blobCount = 0;
+    uint32_t recordCount = 0;
+
+    if (fread(magic, sizeof(char), VX_HTTP_CACHE_INDEX_MAGICBYTES_LEN, fd) != VX_HTTP_CACHE_INDEX_MAGICBYTES_LEN ||
+        memcmp(magic, VX_HTTP_CACHE_INDEX_MAGICBYTES, VX_HTTP_CACHE_INDEX_MAGICBYTES_LEN) != 0) {
+        goto return_result;
+    }
+    if (fread(&version, sizeof(uint8_t), 1, fd) != 1 || version != VX_HTTP_CACHE_INDEX_FORMAT_V2) {
+        goto return_result;
+    }
+
+    if (_readUint32(segmentCount, fd) == false) {
+        goto return_result;
+    }
+    for (uint32_t i = 0; i < segmentCount; ++i) {
+        uint32_t segment = 0;
+        uint64_t size = 0;
+        if (_readUint32(segment, fd) == false || _readUint64(size, fd) == false) {
+            goto return_result;
+        }
+        _segments[segment] = size;
+        _nextSegment = std::max(_nextSegment, segment + 1);
+    }
+
+    if (_readUint32(blobCount, fd) == false) {
+        goto return_result;
+    }
+    for (uint32_t i = 0; i < blobCount; ++i) {
+        std::string key;
+        Blob blob;
+        if (_readString(key, fd) == false ||
+            _readUint32(blob.segment, fd) == false ||
+            _readUint64(blob.offset, fd) == false ||
+            _readUint64(blob.size, fd) == false) {
+            goto return_result;
+        }
+        if (blob.size > 0) {
+            auto segmentIt = _segments.find(blob.segment);
+            if (segmentIt == _segments.end() || blob.offset + blob.size > segmentIt->second) {
+                goto return_result;
+            }
+        }
+        _blobs.emplace(key, blob);
+    }
+
+    if (_readUint32(recordCount, fd) == false) {
+        goto return_result;
+    }
+    for (uint32_t i = 0; i < recordCount; ++i) {
+        std::string url;
+        Record record;
+        uint32_t headerCount = 0;
+        if (_readString(url, fd) == false ||
+            _readString(record.blobKey, fd) == false ||
+            _readString(record.etag, fd) == false ||
+            _readUint32(record.creationTime, fd) == false ||
+            _readUint32(record.maxAge, fd) == false ||
+            _readUint16(record.statusCode, fd) == false ||
+            _readUint32(headerCount, fd) == false) {
+            goto return_result;
+        }
+        for (uint32_t h = 0; h < headerCount; ++h) {
+            std::string key;
+            std::string value;
+            if (_readString(key, fd) == false || _readString(value, fd) == false) {
+                goto return_result;
+            }
+            record.headers.emplace(std::move(key), std::move(value));
+        }
+
+        auto blobIt = _blobs.find(record.blobKey);
+        if (blobIt == _blobs.end()) {
+            goto return_result;
+        }
+        blobIt->second.refCount += 1;
+
+        record.metadataSize = _metadataSize(url, record);
+        _size += record.metadataSize;
+        _lru.push_back(url);
+        record.lruIt = std::prev(_lru.end());
+        _records.emplace(std::move(url), std::move(record));
+    }
+
+    if (fread(magic, sizeof(char), VX_HTTP_CACHE_INDEX_MAGICBYTES_LEN, fd) != VX_HTTP_CACHE_INDEX_MAGICBYTES_LEN ||
+        memcmp(magic, VX_HTTP_CACHE_INDEX_MAGICBYTES, VX_HTTP_CACHE_INDEX_MAGICBYTES_LEN) != 0) {
+        goto return_result;
+    }
+
+    // segments must contain everything the index refers to
+    for (auto& kv : _segments) {
+        FILE *segmentFd = vx::fs::openStorageFile(_segmentPath(kv.first), "rb");
+        if (segmentFd == nullptr) {
+            goto return_result;
+        }
+        const size_t actualSize = vx::fs::getFileSize(segmentFd);
+        fclose(segmentFd);
+        if (actualSize < kv.second) {
+            goto return_result;
+        }
+    }
+
+    // only referenced blobs are listed in the index,
+    // everything else in the pack is dead
+    {
+        uint64_t packSize = 0;
+        for (auto& kv : _segments) {
+            packSize += kv.second;
+        }
+        uint64_t liveSize = 0;
+        for (auto& kv : _blobs) {
+            liveSize += kv.second.size;
+        }
+        _size += liveSize;
+        _deadSize = packSize - liveSize;
+    }
+
+    // segments written after the last index write are not referenced, they're removed
+    {
+        const std::vector<std::string> files = vx::fs::listStorageDirectory(_dir);
+        for (const std::string& file : files) {
+            if (file == _indexPath()) {
+                continue;
+            }
+            bool referenced = false;
+            for (auto& kv : _segments) {
+                if (file == _segmentPath(kv.first)) {
+                    referenced = true;
+                    break;
+                }
+            }
+            if (referenced == false) {
+                vx::fs::removeStorageFileOrDirectory(file);
+            }
+        }
+    }
+
+    ok = true;
+
+return_result:
+    fclose(fd);
+    if (ok == false) {
+        _records.clear();
+        _blobs.clear();
+        _lru.clear();
+        _segments.clear();
+        _size = 0;
+        _deadSize = 0;
+        _nextSegment = 0;
+    }
+    return ok;
+}
+
+bool HttpCacheStore::_saveIndex() {
+    // blobs that are not referenced anymore are not written,
+    // their bytes remain in the pack until next compaction.
+    // Bodies not written in the pack yet (and their records) are not written either.
+    std::string blobs;
+    uint32_t blobCount = 0;
+    for (auto& kv : _blobs) {
+        if (kv.second.refCount == 0 || kv.second.pending != nullptr) {
+            continue;
+        }
+        _appendString(kv.first, blobs);
+        _appendUint32(kv.second.segment, blobs);
+        _appendUint64(kv.second.offset, blobs);
+        _appendUint64(kv.second.size, blobs);
+        ++blobCount;
+    }
+
+    std::string records;
+    uint32_t recordCount = 0;
+    for (const std::string& url : _lru) {
+        const Record& record = _records.at(url);
+        auto blobIt = _blobs.find(record.blobKey);
+        if (blobIt == _blobs.end() || blobIt->second.pending != nullptr) {
+            continue;
+        }
+        _appendString(url, records);
+        _appendString(record.blobKey, records);
+        _appendString(record.etag, records);
+        _appendUint32(record.creationTime, records);
+        _appendUint32(record.maxAge, records);
+        _appendUint16(record.statusCode, records);
+        _appendUint32(static_cast<uint32_t>(record.headers.size()), records);
+        for (auto& header : record.headers) {
+            _appendString(header.first, records);
+            _appendString(header.second, records);
+        }
+        ++recordCount;
+    }
+
+    // serialized first, storage files can only be opened for writing with their size
+    std::string index(VX_HTTP_CACHE_INDEX_MAGICBYTES, VX_HTTP_CACHE_INDEX_MAGICBYTES_LEN);
+    index.push_back(static_cast<char>(VX_HTTP_CACHE_INDEX_FORMAT_V2));
+    _appendUint32(static_cast<uint32_t>(_segments.size()), index);
+    for (auto& kv : _segments) {
+        _appendUint32(kv.first, index);
+        _appendUint64(kv.second, index);
+    }
+    _appendUint32(blobCount, index);
+    index.append(blobs);
+    _appendUint32(recordCount, index);
+    index.append(records);
+    index.append(VX_HTTP_CACHE_INDEX_MAGICBYTES, VX_HTTP_CACHE_INDEX_MAGICBYTES_LEN);
+
+    FILE *fd = vx::fs::openStorageFile(_indexPath(), "wb", index.size());
+    if (fd == nullptr) {
+        vxlog_error("HTTP cache: can't open index");
+        return false;
+    }
+    bool ok = _writeBytes(index.data(), index.size(), fd);
+    if (fclose(fd) != 0) {
+        ok = false;
+    }
+
+    if (ok == false) {
+        vxlog_error("HTTP cache: can't write index");
+        vx::fs::removeStorageFileOrDirectory(_indexPath());
+    }
+    return ok;
+}
+
+void HttpCacheStore::_didChange() {
+    if (_changes == 0) {
+        _firstChangeTime = std::chrono::steady_clock::now();
+    }
+    _changes += 1;
+    _flushIfNeeded();
+}
+
+void HttpCacheStore::_flushIfNeeded() {
+    if (_changes == 0) {
+        return;
+    }
+    if (_pendingSize >= VX_HTTP_CACHE_FLUSH_PENDING_SIZE ||
+        _changes >= VX_HTTP_CACHE_FLUSH_CHANGES ||
+        std::chrono::steady_clock::now() - _firstChangeTime >= std::chrono::seconds(VX_HTTP_CACHE_FLUSH_DELAY_SECONDS)) {
+        flush();
+    }
+}
+
+bool HttpCacheStore::_writePendingBlobs() {
+    if (_pendingSize == 0) {
+        return true;
+    }
+
+    std::vector<Blob *> pending;
+    for (auto& kv : _blobs) {
+        if (kv.second.pending != nullptr) {
+            pending.push_back(&kv.second);
+        }
+    }
+
+    const uint32_t segment = _nextSegment;
+    FILE *fd = vx::fs::openStorageFile(_segmentPath(segment), "wb", static_cast<size_t>(_pendingSize));
+    if (fd == nullptr) {
+        vxlog_error("HTTP cache: can't open pack segment");
+        return false;
+    }
+    bool ok = true;
+    for (Blob *blob : pending) {
+        if (_writeBytes(blob->pending->data(), blob->pending->size(), fd) == false) {
+            ok = false;
+            break;
+        }
+    }
+    if (fclose(fd) != 0) {
+        ok = false;
+    }
+    if (ok == false) {
+        // nothing refers to the incomplete segment, bodies remain pending
+        vxlog_error("HTTP cache: can't write pack segment");
+        vx::fs::removeStorageFileOrDirectory(_segmentPath(segment));
+        return false;
+    }
+
+    uint64_t offset = 0;
+    for (Blob *blob : pending) {
+        blob->segment = segment;
+        blob->offset = offset;
+        blob->pending = nullptr;
+        offset += blob->size;
+    }
+    _segments[segment] = offset;
+    _nextSegment = segment + 1;
+    _pendingSize = 0;
+    return true;
+}
+
+void HttpCacheStore::_removeObsoleteSegments() {
+    for (const uint32_t segment : _obsoleteSegments) {
+        vx::fs::removeStorageFileOrDirectory(_segmentPath(segment));
+    }
+    _obsoleteSegments.clear();
+}
+
+void HttpCacheStore::_removeAllFiles() {
+    const std::vector<std::string> files = vx::fs::listStorageDirectory(_dir);
+    for (const std::string& file : files) {
+        vx::fs::removeStorageFileOrDirectory(file);
+    }
+}
+
+void HttpCacheStore::_removeRecord(std::unordered_map<std::string, Record>::iterator it) {
+    Record& record = it->second;
+    auto blobIt = _blobs.find(record.blobKey);
+    if (blobIt != _blobs.end() && blobIt->second.refCount > 0) {
+        blobIt->second.refCount -= 1;
+        if (blobIt->second.refCount == 0) {
+            _size -= blobIt->second.size;
+            if (blobIt->second.pending != nullptr) {
+                // never written, nothing to compact
+                _pendingSize -= blobIt->second.size;
+                _blobs.erase(blobIt);
+            } else {
+                _deadSize += blobIt->second.size;
+            }
+        }
+    }
+    _size -= record.metadataSize;
+    _lru.erase(record.lruIt);
+    _records.erase(it);
+}
+
+void HttpCacheStore::_evictIfNeeded() {
+    while (_size > _maxSize && _lru.empty() == false) {
+        _removeRecord(_records.find(_lru.back()));
+    }
+}
+
+bool HttpCacheStore::_compactPackIfNeeded() {
+    uint64_t packSize = 0;
+    for (auto& kv : _segments) {
+        packSize += kv.second;
+    }
+
+    // all segments are merged when most bytes are dead,
+    // all but the largest one when there are too many of them.
+    std::vector<uint32_t> merged;
+    if (_deadSize >= VX_HTTP_CACHE_COMPACTION_MIN_DEAD_SIZE && _deadSize >= packSize - _deadSize) {
+        for (auto& kv : _segments) {
+            merged.push_back(kv.first);
+        }
+    } else if (_segments.size() > VX_HTTP_CACHE_MAX_SEGMENTS) {
+        auto largest = _segments.begin();
+        for (auto it = _segments.begin(); it != _segments.end(); ++it) {
+            if (it->second > largest->second) {
+                largest = it;
+            }
+        }
+        for (auto& kv : _segments) {
+            if (kv.first != largest->first) {
+                merged.push_back(kv.first);
+            }
+        }
+    } else {
+        return false;
+    }
+
+    auto isMerged = [&merged](const uint32_t segment) {
+        return std::find(merged.begin(), merged.end(), segment) != merged.end();
+    };
+
+    // live blobs of merged segments, written in pack order
+    // to keep bodies of a same session close to each other
+    std::vector<Blob *> live;
+    uint64_t liveSize = 0;
+    for (auto& kv : _blobs) {
+        Blob& blob = kv.second;
+        if (blob.refCount > 0 && blob.pending == nullptr && blob.size > 0 && isMerged(blob.segment)) {
+            live.push_back(&blob);
+            liveSize += blob.size;
+        }
+    }
+    std::sort(live.begin(), live.end(), [](const Blob *a, const Blob *b) {
+        return a->segment < b->segment || (a->segment == b->segment && a->offset < b->offset);
+    });
+
+    const uint32_t segment = _nextSegment;
+    if (liveSize > 0) {
+        FILE *fd = vx::fs::openStorageFile(_segmentPath(segment), "wb", static_cast<size_t>(liveSize));
+        if (fd == nullptr) {
+            return false;
+        }
+        bool ok = true;
+        for (Blob *blob : live) {
+            std::shared_ptr<HttpCacheMapping> mapping = _getSegmentMapping(blob->segment);
+            if (mapping == nullptr ||
+                _writeBytes(mapping->data() + blob->offset, static_cast<size_t>(blob->size), fd) == false) {
+                ok = false;
+                break;
+            }
+        }
+        if (fclose(fd) != 0) {
+            ok = false;
+        }
+        if (ok == false) {
+            vx::fs::removeStorageFileOrDirectory(_segmentPath(segment));
+            return false;
+        }
+
+        // commit new offsets
+        uint64_t offset = 0;
+        for (Blob *blob : live) {
+            blob->segment = segment;
+            blob->offset = offset;
+            offset += blob->size;
+        }
+        _segments[segment] = liveSize;
+        _nextSegment = segment + 1;
+    }
+
+    // drop dead blobs & merged segments,
+    // existing bodies keep their own reference to previous mappings.
+    for (auto it = _blobs.begin(); it != _blobs.end();) {
+        if (it->second.refCount == 0 && it->second.pending == nullptr && isMerged(it->second.segment)) {
+            it = _blobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const uint32_t m : merged) {
+        packSize -= _segments[m];
+        _segments.erase(m);
+        _segmentMappings.erase(m);
+        _obsoleteSegments.push_back(m);
+    }
+    packSize += liveSize;
+
+    uint64_t referencedSize = 0;
+    for (auto& kv : _blobs) {
+        if (kv.second.refCount > 0 && kv.second.pending == nullptr) {
+            referencedSize += kv.second.size;
+        }
+    }
+    _deadSize = packSize - referencedSize;
+
+    return true;
+}
+
+std::shared_ptr<HttpCacheMapping> HttpCacheStore::_getSegmentMapping(const uint32_t segment) {
+    auto it = _segmentMappings.find(segment);
+    if (it != _segmentMappings.end()) {
+        return it->second;
+    }
+    auto segmentIt = _segments.find(segment);
+    if (segmentIt == _segments.end()) {
+        return nullptr;
+    }
+    FILE *fd = vx::fs::openStorageFile(_segmentPath(segment), "rb");
+    if (fd == nullptr) {
+        return nullptr;
+    }
+    std::shared_ptr<HttpCacheMapping> mapping = HttpCacheMapping::make(fd, static_cast<size_t>(segmentIt->second));
+    // mapping remains valid once the file is closed
+    fclose(fd);
+    if (mapping != nullptr) {
+        _segmentMappings.emplace(segment, mapping);
+    }
+    return mapping;
+}
+
+std::string HttpCacheStore::_blobKey(const char *data, const size_t size) {
+    MD5 hash;
+    size_t offset = 0;
+    while (offset < size) {
+        const size_t len = std::min(size - offset, static_cast<size_t>(1 << 30));
+        hash.update(data + offset, static_cast<MD5::size_type>(len));
+        offset += len;
+    }
+    return hash.finalize().hexdigest() + "-" + std::to_string(size);
+}
+
+uint64_t HttpCacheStore::_metadataSize(const std::string& url, const Record& record) {
+    uint64_t size = url.size() + record.etag.size() + record.blobKey.size() + sizeof(uint32_t) * 3;
+    for (auto& header : record.headers) {
+        size += header.first.size() + header.second.size();
+    }
+    return size;
+}
+
+}
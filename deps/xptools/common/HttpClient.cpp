@@ -19,7 +19,6 @@
 #include "strings.hpp"
 #include "filesystem.hpp"
 
-#include "BZMD5.hpp"
 #include "cJSON.h"
 
 #ifdef __VX_USE_LIBWEBSOCKETS
@@ -33,20 +32,6 @@
 
 #endif
 
-#define VX_HTTP_CACHE_MAGICBYTES "CUBZHCACHE!"
-#define VX_HTTP_CACHE_MAGICBYTES_LEN 11
-#define VX_HTTP_CACHE_FILE_FORMAT_V1 1 // uint8
-#define VX_HTTP_CACHE_FILE_FORMAT_V2 2 // uint8
-#define VX_HTTP_CACHE_COMPRESSION_NONE 1 // uint8
-// chunk IDs are uint8s
-#define VX_HTTP_CACHE_CHUNK_CREATIONTIME 1 // value is uint32 (seconds since 2001/01/01)
-#define VX_HTTP_CACHE_CHUNK_MAXAGE 2 // value is uint32 (seconds)
-#define VX_HTTP_CACHE_CHUNK_URL 3 // value is string
-#define VX_HTTP_CACHE_CHUNK_STATUSCODE 4 // value is uint32
-#define VX_HTTP_CACHE_CHUNK_HEADERS 5 // value is string (multiple occurences)
-#define VX_HTTP_CACHE_CHUNK_BODY 6 // value is string (raw bytes)
-#define VX_HTTP_CACHE_CHUNK_ETAG 7 // value is string (ETag bytes)
-
 namespace vx {
 
 // HttpClient::CacheMatch implementation
@@ -76,7 +61,11 @@ HttpClient& HttpClient::shared() {
     return *_sharedInstance;
 }
 
-HttpClient::~HttpClient() {}
+HttpClient::~HttpClient() {
+#if !defined(__VX_PLATFORM_WASM)
+    delete _cacheStore;
+#endif
+}
 
 void HttpClient::setCallbackMiddleware(HttpClient::CallbackMiddleware func) {
     _callbackMiddleware = func;
@@ -207,6 +196,9 @@ HttpRequest_SharedPtr HttpClient::Delete(const std::string &url,
 void HttpClient::run_unit_tests() {
     run_unit_tests_parse_url();
     run_unit_tests_get_url();
+#if !defined(__VX_PLATFORM_WASM)
+    run_unit_tests_cache_store();
+#endif
 }
 
 // --------------------------------------------------
@@ -316,15 +308,85 @@ void HttpClient::run_unit_tests_get_url() {
     assert(req->getStatus() == HttpRequest::Status::WAITING);
 }
 
+#if !defined(__VX_PLATFORM_WASM)
+
+void HttpClient::run_unit_tests_cache_store() {
+    const std::string dir = "http_cache_tests";
+    const std::string body(4096, 'x');
+    const HttpHeaders headers = {{"etag", "abc"}};
+
+    {
+        HttpCacheStore store(dir, 1024 * 1024);
+        store.clear();
+        assert(store.put("https://a.cu.bzh/1", "abc", 10, 60, HTTP_OK, headers, body.data(), body.size()));
+        assert(store.put("https://a.cu.bzh/2", "abc", 10, 60, HTTP_OK, headers, body.data(), body.size()));
+
+        // identical bodies are stored once
+        assert(store.getEntryCount() == 2);
+        assert(store.getBlobCount() == 1);
+        assert(store.getPackSize() == body.size());
+
+        // buffered bodies are written in a single pack segment
+        assert(store.getSegmentCount() == 0);
+        assert(store.flush());
+        assert(store.getSegmentCount() == 1);
+        assert(store.getPackSize() == body.size());
+
+        HttpCacheStore::Entry entry;
+        assert(store.get("https://a.cu.bzh/2", entry));
+        assert(entry.etag == "abc");
+        assert(entry.maxAge == 60);
+        assert(entry.statusCode == HTTP_OK);
+        assert(entry.body != nullptr);
+        assert(std::string(entry.body->data(), entry.body->size()) == body);
+    }
+
+    // index is persisted
+    {
+        HttpCacheStore store(dir, 1024 * 1024);
+        assert(store.getEntryCount() == 2);
+
+        HttpCacheStore::Entry entry;
+        assert(store.get("https://a.cu.bzh/1", entry));
+        assert(std::string(entry.body->data(), entry.body->size()) == body);
+
+        // least recently used entry is evicted first
+        store.setMaxSize(store.getSize() - 1);
+        assert(store.getEntryCount() == 1);
+        assert(store.get("https://a.cu.bzh/2", entry) == false);
+        assert(store.get("https://a.cu.bzh/1", entry));
+
+        // shared body is still alive
+        assert(store.getBlobCount() == 1);
+
+        assert(store.remove("https://a.cu.bzh/1"));
+        assert(store.getEntryCount() == 0);
+        assert(store.getSize() == 0);
+        store.clear();
+    }
+
+    vx::fs::removeStorageDirectoryRecurse(dir);
+}
+
+#endif
+
 HttpClient::HttpClient() :
 _cacheMutex(),
-_callbackMiddleware(nullptr) {}
+_callbackMiddleware(nullptr)
+#if !defined(__VX_PLATFORM_WASM)
+,_cacheStore(nullptr),
+_cacheMaxSize(VX_HTTP_CACHE_DEFAULT_MAX_SIZE)
+#endif
+{}
 
 bool HttpClient::cacheHttpResponse(HttpRequest_SharedPtr req) {
+#if defined(__VX_PLATFORM_WASM)
+    // Caching is not needed on WASM platform,
+    // as the web browser is already taking care of it.
+    return false;
+#else
     const std::lock_guard<std::mutex> lock(this->_cacheMutex);
 
-    bool ok = false;
-
     const HttpResponse& response = req->getResponse();
     const HttpHeaders& responseHeaders = response.getHeaders();
 
@@ -359,91 +421,17 @@ bool HttpClient::cacheHttpResponse(HttpRequest_SharedPtr req) {
     // TODO: used cached URL, do not reconstruct URL here
     const std::string requestURL = req->constructURLString();
 
-    // generate hash from URL
-    const std::string urlHash = md5(requestURL);
-
-    // open cache file in storage
-    const std::string filepath = std::string(VX_HTTP_CACHE_DIR_NAME) + "/" + urlHash;
-
-    // creates file is not present, truncate it otherwise
-    FILE* fd = vx::fs::openStorageFile(filepath, "wb");
-    if (fd == nullptr) {
-        return false;
-    }
-
-    // cache file header
-    {
-        ok = _cacheWriteFileHeader(VX_HTTP_CACHE_FILE_FORMAT_V2, VX_HTTP_CACHE_COMPRESSION_NONE, fd);
-        if (ok == false) {
-            goto return_false;
-        }
-    }
-
-    // etag
-    {
-        ok = _cacheWriteStringChunk(VX_HTTP_CACHE_CHUNK_ETAG, etag, fd);
-        if (ok == false) {
-            goto return_false;
-        }
-    }
-
-    // file creation time
-    {
-        const uint32_t creationTime = vx::device::timestampApple();
-        ok = _cacheWriteUint32Chunk(VX_HTTP_CACHE_CHUNK_CREATIONTIME, creationTime, fd);
-        if (ok == false) {
-            goto return_false;
-        }
-    }
-
-    // max-age value
-    {
-        ok = _cacheWriteUint32Chunk(VX_HTTP_CACHE_CHUNK_MAXAGE, maxAge, fd);
-        if (ok == false) {
-            goto return_false;
-        }
-    }
-
-    // request URL
-    {
-        ok = _cacheWriteStringChunk(VX_HTTP_CACHE_CHUNK_URL, requestURL, fd);
-        if (ok == false) {
-            goto return_false;
-        }
-    }
-
-    // HTTP status
-    {
-        ok = _cacheWriteUint32Chunk(VX_HTTP_CACHE_CHUNK_STATUSCODE, response.getStatusCode(), fd);
-        if (ok == false) {
-            goto return_false;
-        }
-    }
-
-    // HTTP response headers
-    {
-        ok = _cacheWriteMapStringStringChunk(VX_HTTP_CACHE_CHUNK_HEADERS, responseHeaders, fd);
-        if (ok == false) {
-            goto return_false;
-        }
-    }
-
-    // HTTP response body
-    {
-        ok = _cacheWriteStringChunk(VX_HTTP_CACHE_CHUNK_BODY, response.getBytes(), fd);
-        if (ok == false) {
-            goto return_false;
-        }
-    }
+    const uint32_t creationTime = vx::device::timestampApple();
 
-return_true:
-    fclose(fd);
-    return true;
-
-return_false:
-    fclose(fd);
-    vx::fs::removeStorageFileOrDirectory(filepath);
-    return false;
+    return _getCacheStore().put(requestURL,
+                                etag,
+                                creationTime,
+                                maxAge,
+                                response.getStatusCode(),
+                                responseHeaders,
+                                response.getBodyData(),
+                                response.getBodySize());
+#endif
 }
 
 #if !defined(__VX_PLATFORM_WASM)
@@ -451,7 +439,6 @@ return_false:
 HttpClient::CacheMatch HttpClient::getCachedResponseForRequest(HttpRequest_SharedPtr req) {
     const std::lock_guard<std::mutex> lock(this->_cacheMutex);
 
-    bool ok = false;
     CacheMatch result;
 
     if (req == nullptr) {
@@ -465,120 +452,28 @@ HttpClient::CacheMatch HttpClient::getCachedResponseForRequest(HttpRequest_Share
     // TODO: used cached URL, do not reconstruct URL here
     const std::string requestURL = req->constructURLString();
 
-    // generate hash from URL
-    const std::string urlHash = md5(requestURL);
-
-    // open cache file in storage
-    const std::string filepath = std::string(VX_HTTP_CACHE_DIR_NAME) + "/" + urlHash;
-
-    // check cache file exists
-    {
-        bool isDir = false;
-        const bool exists = vx::fs::storageFileExists(filepath, isDir);
-        if (exists == false || isDir) {
-            return result;
-        }
-    }
-
-    // open cache file
-    FILE *fd = vx::fs::openStorageFile(filepath);
-    if (fd == nullptr) {
+    HttpCacheStore::Entry entry;
+    if (_getCacheStore().get(requestURL, entry) == false) {
         return result;
     }
 
     result.didFindCache = true;
 
-    // skip header
-    {
-        fseek(fd, VX_HTTP_CACHE_MAGICBYTES_LEN, SEEK_SET);
-    }
-
-    // file format version & file compression method
-    uint8_t fileFormatVersion = 0;
-    {
-        uint8_t fileCompressionMethod = 0;
-        ok = _cacheReadFileHeader(&fileFormatVersion, &fileCompressionMethod, fd);
-        if (ok == false) {
-            goto return_cache_not_found_and_delete_cache;
-        }
-    }
-
-    if (fileFormatVersion > 1) {
-        std::string etag;
-        ok = _cacheReadStringChunk(VX_HTTP_CACHE_CHUNK_ETAG, etag, fd);
-        if (ok == false) {
-            goto return_cache_not_found_and_delete_cache;
-        }
-        if (etag.empty() == false) {
-            req->setOneHeader("If-None-Match", etag);
-        }
-    } else {
-        // ignore & delete old cache
-        goto return_cache_not_found_and_delete_cache;
+    if (entry.etag.empty() == false) {
+        req->setOneHeader("If-None-Match", entry.etag);
     }
 
     // check cache is not expired
-    {
-        uint32_t cacheCreationTime = 0;
-        ok = _cacheReadUint32Chunk(VX_HTTP_CACHE_CHUNK_CREATIONTIME, cacheCreationTime, fd);
-        if (ok == false) {
-            goto return_cache_not_found_and_delete_cache;
-        }
-
-        uint32_t maxAge = 0;
-        ok = _cacheReadUint32Chunk(VX_HTTP_CACHE_CHUNK_MAXAGE, maxAge, fd);
-        if (ok == false) {
-            goto return_cache_not_found_and_delete_cache;
-        }
-
-        const uint32_t currentTime = vx::device::timestampApple();
-        result.isStillFresh = currentTime < (cacheCreationTime + maxAge);
-    }
-
-    // read cache content
-    {
-        std::string url;
-        ok = _cacheReadStringChunk(VX_HTTP_CACHE_CHUNK_URL, url, fd);
-        if (ok == false || url != requestURL) {
-            goto return_cache_not_found_and_delete_cache;
-        }
-
-        uint32_t statusCode = 0;
-        ok = _cacheReadUint32Chunk(VX_HTTP_CACHE_CHUNK_STATUSCODE, statusCode, fd);
-        if (ok == false) {
-            goto return_cache_not_found_and_delete_cache;
-        }
-
-        HttpHeaders headers;
-        ok = _cacheReadMapStringStringChunk(VX_HTTP_CACHE_CHUNK_HEADERS, headers, fd);
-        if (ok == false) {
-            goto return_cache_not_found_and_delete_cache;
-        }
-
-        std::string body;
-        ok = _cacheReadStringChunk(VX_HTTP_CACHE_CHUNK_BODY, body, fd);
-        if (ok == false) {
-            goto return_cache_not_found_and_delete_cache;
-        }
-
-        req->getCachedResponse().setSuccess(true);
-        req->getCachedResponse().setStatusCode(statusCode);
-        req->getCachedResponse().setHeaders(std::move(headers));
-        req->getCachedResponse().setBytes(body);
-        req->getCachedResponse().setUseLocalCache(true);
-    }
-
-    goto return_result;
+    const uint32_t currentTime = vx::device::timestampApple();
+    result.isStillFresh = currentTime < (entry.creationTime + entry.maxAge);
 
-return_result:
-    fclose(fd);
-    return result;
+    // body is not copied, response points to the cache pack mapping
+    req->getCachedResponse().setSuccess(true);
+    req->getCachedResponse().setStatusCode(entry.statusCode);
+    req->getCachedResponse().setHeaders(std::move(entry.headers));
+    req->getCachedResponse().setCachedBody(entry.body);
+    req->getCachedResponse().setUseLocalCache(true);
 
-return_cache_not_found_and_delete_cache:
-    fclose(fd);
-    vx::fs::removeStorageFileOrDirectory(filepath);
-    result.didFindCache = false;
-    result.isStillFresh = false;
     return result;
 }
 
@@ -589,335 +484,29 @@ bool HttpClient::removeCachedResponseForRequest(HttpRequest_SharedPtr req) {
         return false;
     }
 
-    // if (req->getStatus() != HttpRequest::Status::DONE) {
-    //     return false;
-    // }
-
     // TODO: used cached URL, do not reconstruct URL here
     const std::string requestURL = req->constructURLString();
 
-    // generate hash from URL
-    const std::string urlHash = md5(requestURL);
-
-    // open cache file in storage
-    const std::string filepath = std::string(VX_HTTP_CACHE_DIR_NAME) + "/" + urlHash;
-
-    //vxlog_debug("❌ REMOVE HTTP CACHE: %s", filepath.c_str());
-
-    const bool ok = vx::fs::removeStorageFileOrDirectory(filepath);
-    return ok;
-}
-
-#endif // !defined(__VX_PLATFORM_WASM)
-
-bool HttpClient::_cacheWriteFileHeader(const uint8_t fileFormatVersion,
-                                       const uint8_t compressionMethod,
-                                       FILE * const fd) {
-    if (fd == nullptr) {
-        return false;
-    }
-
-    // make sure cursor is at the start of the file
-    if (ftell(fd) != 0) {
-        return false;
-    }
-
-    size_t n = 0;
-    n = fwrite(VX_HTTP_CACHE_MAGICBYTES, sizeof(char), VX_HTTP_CACHE_MAGICBYTES_LEN, fd);
-    if (n != VX_HTTP_CACHE_MAGICBYTES_LEN) {
-        return false;
-    }
-
-    n = fwrite(&fileFormatVersion, sizeof(uint8_t), 1, fd);
-    if (n != 1) {
-        return false;
-    }
-
-    n = fwrite(&compressionMethod, sizeof(uint8_t), 1, fd);
-    if (n != 1) {
-        return false;
-    }
-
-    return true;
+    return _getCacheStore().remove(requestURL);
 }
 
-bool HttpClient::_cacheWriteUint32Chunk(const uint8_t chunkID,
-                                        const uint32_t chunkValue,
-                                        FILE * const fd) {
-    if (fd == nullptr) {
-        return false;
-    }
-
-    size_t n = 0;
-
-    // chunk ID
-    n = fwrite(&chunkID, sizeof(uint8_t), 1, fd);
-    if (n != 1) {
-        return false;
-    }
-
-    // chunk value
-    n = fwrite(&chunkValue, sizeof(uint32_t), 1, fd);
-    if (n != 1) {
-        return false;
-    }
-
-    return true;
-}
-
-bool HttpClient::_cacheWriteStringChunk(const uint8_t chunkID,
-                                        const std::string chunkValue,
-                                        FILE * const fd) {
-    if (fd == nullptr) {
-        return false;
-    }
-
-    size_t n = 0;
-
-    // chunk ID
-    n = fwrite(&chunkID, sizeof(uint8_t), 1, fd);
-    if (n != 1) {
-        return false;
-    }
-
-    const uint32_t valueLen = static_cast<uint32_t>(chunkValue.length());
-
-    // chunk value length
-    n = fwrite(&valueLen, sizeof(uint32_t), 1, fd);
-    if (n != 1) {
-        return false;
-    }
-
-    // chunk value
-    n = fwrite(chunkValue.c_str(), sizeof(char), chunkValue.length(), fd);
-    if (n != chunkValue.length()) {
-        return false;
-    }
-
-    return true;
-}
-
-bool HttpClient::_cacheWriteMapStringStringChunk(const uint8_t chunkID,
-                                                 const std::unordered_map<std::string, std::string>& chunkValue,
-                                                 FILE * const fd) {
-    if (fd == nullptr) {
-        return false;
-    }
-
-    size_t n = 0;
-
-    // chunk ID
-    {
-        n = fwrite(&chunkID, sizeof(uint8_t), 1, fd);
-        if (n != 1) {
-            return false;
-        }
-    }
-
-    // count of key-value pairs
-    {
-        const uint32_t kvCount = static_cast<uint32_t>(chunkValue.size());
-        n = fwrite(&kvCount, sizeof(uint32_t), 1, fd);
-        if (n != 1) {
-            return false;
-        }
-    }
-
-    // key-value pairs
-    for (auto kv : chunkValue) {
-        // key
-        {
-            const std::string& str = kv.first;
-            const uint32_t& len = static_cast<uint32_t>(str.length());
-            n = fwrite(&len, sizeof(uint32_t), 1, fd);
-            if (n != 1) {
-                return false;
-            }
-            n = fwrite(str.c_str(), sizeof(char), len, fd);
-            if (n != len) {
-                return false;
-            }
-        }
-
-        // value
-        {
-            const std::string& str = kv.second;
-            const uint32_t& len = static_cast<uint32_t>(str.length());
-            n = fwrite(&len, sizeof(uint32_t), 1, fd);
-            if (n != 1) {
-                return false;
-            }
-            n = fwrite(str.c_str(), sizeof(char), len, fd);
-            if (n != len) {
-                return false;
-            }
-        }
-    }
-
-    return true;
-}
-
-bool HttpClient::_cacheReadFileHeader(uint8_t *fileFormatVersion, uint8_t *compressionMethod, FILE * const fd) {
-
-    if (fd == nullptr) { return false; }
-    if (ftell(fd) != VX_HTTP_CACHE_MAGICBYTES_LEN) { return false; }
-
-    size_t n = 0;
-
-    // file format
-    {
-        n = fread(fileFormatVersion, sizeof(uint8_t), 1, fd);
-        if (n != 1) {
-            return false;
-        }
-    }
-
-    // compression method
-    {
-        n = fread(compressionMethod, sizeof(uint8_t), 1, fd);
-        if (n != 1) {
-            return false;
-        }
-    }
-
-    return true;
-}
-
-bool HttpClient::_cacheReadUint32Chunk(const uint8_t chunkID, uint32_t& chunkValue, FILE * const fd) {
-    if (fd == nullptr) {
-        return false;
-    }
-
-    size_t n = 0;
-
-    // chunk ID
-    {
-        uint8_t chunkIDRead = 0;
-        n = fread(&chunkIDRead, sizeof(uint8_t), 1, fd);
-        if (n != 1) {
-            return false;
-        }
-        if (chunkIDRead != chunkID) {
-            return false;
-        }
-    }
-
-    // chunk value
-    {
-        n = fread(&chunkValue, sizeof(uint32_t), 1, fd);
-        if (n != 1) {
-            return false;
-        }
-    }
-
-    return true;
-}
-
-bool HttpClient::_cacheReadStringChunk(const uint8_t chunkID, std::string& chunkValue, FILE * const fd) {
-    if (fd == nullptr) {
-        return false;
-    }
-
-    size_t n = 0;
-    bool ok = false;
-
-    // chunk ID
-    {
-        uint8_t chunkIDRead = 0;
-        n = fread(&chunkIDRead, sizeof(uint8_t), 1, fd);
-        if (n != 1) {
-            return false;
-        }
-        if (chunkIDRead != chunkID) {
-            return false;
-        }
-    }
-
-    // chunk value
-    {
-        std::string value;
-        ok = _readString(value, fd);
-        if (ok == false) {
-            return false;
-        }
-        chunkValue.assign(value);
+void HttpClient::setCacheMaxSize(const uint64_t maxSize) {
+    const std::lock_guard<std::mutex> lock(this->_cacheMutex);
+    _cacheMaxSize = maxSize;
+    if (_cacheStore != nullptr) {
+        _cacheStore->setMaxSize(maxSize);
     }
-
-    return true;
 }
 
-bool HttpClient::_cacheReadMapStringStringChunk(const uint8_t chunkID,
-                                                std::unordered_map<std::string, std::string>& chunkValue,
-                                                FILE * const fd) {
-    if (fd == nullptr) {
-        return false;
-    }
-
-    size_t n = 0;
-    bool ok = false;
-
-    // chunk ID
-    {
-        uint8_t chunkIDRead = 0;
-        n = fread(&chunkIDRead, sizeof(uint8_t), 1, fd);
-        if (n != 1) {
-            return false;
-        }
-        if (chunkIDRead != chunkID) {
-            return false;
-        }
-    }
-
-    // count of key-value pairs
-    uint32_t count = 0;
-    n = fread(&count, sizeof(uint32_t), 1, fd);
-    if (n != 1) {
-        return false;
-    }
-
-    std::string key;
-    std::string value;
-    for (uint32_t i = 0; i < count; ++i) {
-        ok = _readString(key, fd);
-        if (ok == false) {
-            return false;
-        }
-        ok = _readString(value, fd);
-        if (ok == false) {
-            return false;
-        }
-        chunkValue.emplace(key, value);
+HttpCacheStore& HttpClient::_getCacheStore() {
+    // created lazily, storage path prefix may be set after the client is created
+    if (_cacheStore == nullptr) {
+        _cacheStore = new HttpCacheStore(VX_HTTP_CACHE_DIR_NAME, _cacheMaxSize);
     }
-
-    return true;
+    return *_cacheStore;
 }
 
-bool HttpClient::_readString(std::string& out, FILE * const fd) {
-    if (fd == nullptr) {
-        return false;
-    }
-
-    size_t n = 0;
-
-    uint32_t strLen = 0;
-    n = fread(&strLen, sizeof(uint32_t), 1, fd);
-    if (n != 1) {
-        return false;
-    }
-
-    char *strBuf = static_cast<char *>(malloc(sizeof(char) * strLen));
-    if (strBuf == nullptr) {
-        return false;
-    }
-    n = fread(strBuf, sizeof(char), strLen, fd);
-    if (n != strLen) {
-        free(strBuf);
-        return false;
-    }
-    out.assign(strBuf, strLen);
-    free(strBuf);
-    return true;
-}
+#endif // !defined(__VX_PLATFORM_WASM)
 
 std::vector<std::string> HttpClient::_parseCacheControlHeaderValue(const std::string& cacheControlValue) {
     std::vector<std::string> directives;
@@ -403,7 +403,12 @@ void HttpRequest::_useCachedResponse() {
     // doc: https://developer.mozilla.org/fr/docs/Web/HTTP/Status/304
     strongSelf->_response.setSuccess(strongSelf->_cachedResponse.getSuccess());
     strongSelf->_response.setStatusCode(strongSelf->_cachedResponse.getStatusCode());
-    strongSelf->_response.setBytes(strongSelf->_cachedResponse.getBytes());
+    if (strongSelf->_cachedResponse.getCachedBody() != nullptr) {
+        strongSelf->_response.setCachedBody(strongSelf->_cachedResponse.getCachedBody());
+    } else {
+        strongSelf->_response.setBytes(std::string(strongSelf->_cachedResponse.getBodyData(),
+                                                   strongSelf->_cachedResponse.getBodySize()));
+    }
     strongSelf->_response.setUseLocalCache(strongSelf->_cachedResponse.getUseLocalCache());
 }
 
@@ -11,6 +11,9 @@
 // C++
 #include <string>
 
+// xptools
+#include "HttpCacheStore.hpp"
+
 namespace vx {
 
 HttpResponse::HttpResponse() :
@@ -18,6 +21,8 @@ _success(false),
 _statusCode(0),
 _headers(),
 _bytes(),
+_bytesMutex(),
+_cachedBody(nullptr),
 _useLocalCache(false) {}
 
 HttpResponse::~HttpResponse() {}
@@ -88,17 +93,49 @@ const std::unordered_map<std::string, std::string>& HttpResponse::getHeaders() c
 }
 
 void HttpResponse::appendBytes(const std::string& bytes) {
+    if (_cachedBody != nullptr) {
+        getBytes();
+        _cachedBody = nullptr;
+    }
     this->_bytes.append(bytes);
 }
 
 const std::string& HttpResponse::getBytes() const {
+    const std::lock_guard<std::mutex> lock(_bytesMutex);
+    if (_cachedBody != nullptr && _bytes.size() != _cachedBody->size()) {
+        _bytes.assign(_cachedBody->data(), _cachedBody->size());
+    }
     return _bytes;
 }
 
 void HttpResponse::setBytes(const std::string& bytes) {
+    this->_cachedBody = nullptr;
     this->_bytes.assign(bytes);
 }
 
+void HttpResponse::setCachedBody(std::shared_ptr<const HttpCacheBody> body) {
+    this->_bytes.clear();
+    this->_cachedBody = body;
+}
+
+std::shared_ptr<const HttpCacheBody> HttpResponse::getCachedBody() const {
+    return _cachedBody;
+}
+
+const char *HttpResponse::getBodyData() const {
+    if (_cachedBody != nullptr) {
+        return _cachedBody->data();
+    }
+    return _bytes.data();
+}
+
+size_t HttpResponse::getBodySize() const {
+    if (_cachedBody != nullptr) {
+        return _cachedBody->size();
+    }
+    return _bytes.size();
+}
+
 void HttpResponse::setUseLocalCache(const bool useLocalCache) {
     this->_useLocalCache = useLocalCache;
 }
@@ -108,12 +145,14 @@ bool HttpResponse::getUseLocalCache() const {
 }
 
 const std::string HttpResponse::getText() const {
-    const size_t byteCount = _bytes.size(); // count of bytes
+    const size_t byteCount = getBodySize(); // count of bytes
     // alloc string of size (byteCount + 1) to accomodate for trailing NULL char
     // (string is initialized with NULL chars)
     std::string text(byteCount + 1, '\0');
     // copy bytes into the string
-    text.replace(0, byteCount, _bytes);
+    if (byteCount > 0) {
+        text.replace(0, byteCount, getBodyData(), byteCount);
+    }
     return text;
 }
 
@@ -11,6 +11,9 @@
 #include "audio.hpp"
 
 // C++
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <thread>
 #include <cassert>
 
@@ -24,7 +27,19 @@
 #define FADE_DURATION_SEC 0.01f // in seconds
 #define CUT_WAIT_DURATION_AFTER_FADE_SEC 0.02 // in seconds
 
+#define DEFAULT_MAX_VOICES 32
+#define SOUND_BANK_MAX_SIZE 33554432 // 32MB
+
+// sounds are decoded as signed 16 bits PCM,
+// half the memory of f32, engine converts when mixing.
+#define SOUND_BANK_FORMAT ma_format_s16
+
+// longer sounds are streamed from their file instead of being decoded in the bank
+#define SOUND_STREAM_MIN_DURATION_SEC 10
+
 #define OGG_PAGE_HEADER "OggS"
+#define OGG_PAGE_HEADER_SIZE 27
+#define OGG_PAGE_MAX_SIZE 65307
 
 using namespace vx::audio;
 
@@ -198,7 +213,12 @@ AudioEngine *AudioEngine::shared() {
 }
 
 AudioEngine::~AudioEngine() {
+    delete _bank;
+    _bank = nullptr;
     ma_engine_uninit(&_engine);
+    if (_hasContext) {
+        ma_context_uninit(&_context);
+    }
     free(_vfs);
     _vfs = nullptr;
 }
@@ -225,20 +245,128 @@ bool AudioEngine::setVolume(float volumePercentage) {
     return true;
 }
 
+SoundBank *AudioEngine::getSoundBank() {
+    return _bank;
+}
+
+// one second of 440Hz sine wave, mono
+static void _registerTestSound(SoundBank *bank, const std::string& name) {
+    const ma_uint32 sampleRate = 48000;
+    std::vector<ma_int16> frames(sampleRate);
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const double t = static_cast<double>(i) / static_cast<double>(sampleRate);
+        frames[i] = static_cast<ma_int16>(sin(t * 440.0 * 2.0 * 3.14159265358979323846) * 16000.0);
+    }
+    bank->add(name, ma_format_s16, 1, sampleRate, frames.data(), frames.size());
+}
+
+void AudioEngine::run_unit_tests() {
+    AudioEngine *engine = new AudioEngine(true);
+    SoundsTicks *ticks = SoundsTicks::shared();
+    const size_t maxVoices = ticks->getMaxVoices();
+
+    _registerTestSound(engine->getSoundBank(), "test_sine");
+
+    // instances share decoded buffer
+    {
+        Sound_SharedPtr a = Sound::make(engine, "test_sine");
+        Sound_SharedPtr b = Sound::make(engine, "test_sine");
+        assert(a != nullptr && b != nullptr);
+        assert(a->_buffer == b->_buffer);
+        assert(engine->getSoundBank()->getBufferCount() == 1);
+        assert(fabsf(a->getOriginalDuration() - 1.0f) < 0.001f);
+
+        // already in the bank, never probed as a file
+        ma_uint64 frameCount = 0;
+        ma_uint32 sampleRate = 0;
+        assert(engine->getSoundBank()->isStreamed("test_sine", &frameCount, &sampleRate) == false);
+    }
+
+    // voices are stolen by priority, then age
+    {
+        ticks->setMaxVoices(2);
+        Sound_SharedPtr low = Sound::make(engine, "test_sine");
+        Sound_SharedPtr high = Sound::make(engine, "test_sine");
+        Sound_SharedPtr other = Sound::make(engine, "test_sine");
+        high->setPriority(10);
+
+        low->play();
+        high->play();
+        assert(ticks->getActiveVoiceCount() == 2);
+
+        other->play();
+        assert(ticks->getActiveVoiceCount() == 2);
+        assert(low->hasVoice() == false);
+        assert(low->isPlaying() == false);
+        assert(high->hasVoice());
+        assert(other->hasVoice());
+
+        // lower priority can't steal a voice from higher priorities
+        other->setPriority(10);
+        low->play();
+        assert(low->hasVoice() == false);
+
+        // voices are released once sounds are stopped
+        high->stopWithoutFadeOut();
+        other->stopWithoutFadeOut();
+        ticks->tick(0.016);
+        assert(ticks->getActiveVoiceCount() == 0);
+    }
+
+    ticks->setMaxVoices(maxVoices);
+
+    engine->getSoundBank()->purgeUnused();
+    assert(engine->getSoundBank()->getBufferCount() == 0);
+
+    delete engine;
+}
+
+double AudioEngine::run_benchmark(const int count) {
+    AudioEngine *engine = new AudioEngine(true);
+    _registerTestSound(engine->getSoundBank(), "bench_sine");
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        Sound_SharedPtr sound = Sound::make(engine, "bench_sine");
+        assert(sound != nullptr);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    delete engine;
+
+    return static_cast<double>(count) / elapsed.count();
+}
+
 // MARK: - private -
 
-AudioEngine::AudioEngine() {
+AudioEngine::AudioEngine(const bool nullBackend) :
+_hasContext(false),
+_vfs(nullptr),
+_bank(nullptr) {
     
     ma_result result;
     
     // vfs
     _vfs = xptools_vfs_init();
 
+    _bank = new SoundBank(_vfs, SOUND_BANK_MAX_SIZE);
+
     // create engine with config
     ma_engine_config engineConfig = ma_engine_config_init();
     engineConfig.listenerCount = 1;
     engineConfig.pResourceManagerVFS = _vfs;
 
+    if (nullBackend) {
+        const ma_backend backends[] = { ma_backend_null };
+        result = ma_context_init(backends, 1, nullptr, &_context);
+        if (result != MA_SUCCESS) {
+            vxlog_error("[vx::audio::AudioEngine] failed to init null backend");
+            return;
+        }
+        _hasContext = true;
+        engineConfig.pContext = &_context;
+    }
+
     result = ma_engine_init(&engineConfig, &_engine);
     if (result != MA_SUCCESS) {
         // failed to initialize the engine.
@@ -246,12 +374,230 @@ AudioEngine::AudioEngine() {
     }
 }
 
+// --------------------------------------------------
+// MARK: - SoundBuffer type -
+// --------------------------------------------------
+
+SoundBuffer::SoundBuffer(const ma_format format,
+                         const ma_uint32 channels,
+                         const ma_uint32 sampleRate,
+                         const ma_uint64 frameCount,
+                         void *frames) :
+_format(format),
+_channels(channels),
+_sampleRate(sampleRate),
+_frameCount(frameCount),
+_frames(frames) {}
+
+SoundBuffer::~SoundBuffer() {
+    ma_free(_frames, nullptr);
+    _frames = nullptr;
+}
+
+size_t SoundBuffer::getSize() const {
+    return static_cast<size_t>(_frameCount * ma_get_bytes_per_frame(_format, _channels));
+}
+
+// --------------------------------------------------
+// MARK: - SoundBank type -
+// --------------------------------------------------
+
+SoundBank::SoundBank(ma_vfs *vfs, const size_t maxSize) :
+_vfs(vfs),
+_maxSize(maxSize),
+_size(0),
+_buffers(),
+_mutex() {}
+
+SoundBank::~SoundBank() {}
+
+SoundBuffer_SharedPtr SoundBank::get(const std::string& soundName) {
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _buffers.find(soundName);
+        if (it != _buffers.end()) {
+            return it->second;
+        }
+    }
+
+    // decode whole file, keeping its channels & sample rate
+    // (engine converts when mixing)
+    ma_decoder_config config = ma_decoder_config_init(SOUND_BANK_FORMAT, 0, 0);
+    ma_uint64 frameCount = 0;
+    void *frames = nullptr;
+    ma_result result = ma_decode_from_vfs(_vfs, soundName.c_str(), &config, &frameCount, &frames);
+    if (result != MA_SUCCESS || frames == nullptr) {
+        vxlog_error("[vx::audio::SoundBank] failed to decode sound");
+        return nullptr;
+    }
+
+    SoundBuffer_SharedPtr buffer = std::make_shared<SoundBuffer>(config.format,
+                                                                 config.channels,
+                                                                 config.sampleRate,
+                                                                 frameCount,
+                                                                 frames);
+    return _insert(soundName, buffer);
+}
+
+SoundBuffer_SharedPtr SoundBank::add(const std::string& soundName,
+                                     const ma_format format,
+                                     const ma_uint32 channels,
+                                     const ma_uint32 sampleRate,
+                                     const void *frames,
+                                     const ma_uint64 frameCount) {
+    const size_t size = static_cast<size_t>(frameCount * ma_get_bytes_per_frame(format, channels));
+    void *copy = ma_malloc(size, nullptr);
+    if (copy == nullptr) {
+        return nullptr;
+    }
+    memcpy(copy, frames, size);
+
+    SoundBuffer_SharedPtr buffer = std::make_shared<SoundBuffer>(format, channels, sampleRate, frameCount, copy);
+
+    {
+        // replace existing buffer, if any
+        const std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _buffers.find(soundName);
+        if (it != _buffers.end()) {
+            _size -= it->second->getSize();
+            _buffers.erase(it);
+        }
+    }
+
+    return _insert(soundName, buffer);
+}
+
+bool SoundBank::isStreamed(const std::string& soundName, ma_uint64 *frameCount, ma_uint32 *sampleRate) {
+    SoundLength length;
+    bool probed = false;
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        if (_buffers.find(soundName) != _buffers.end()) {
+            return false;
+        }
+        auto it = _lengths.find(soundName);
+        if (it != _lengths.end()) {
+            length = it->second;
+            probed = true;
+        }
+    }
+
+    if (probed == false) {
+        length = _probeLength(soundName);
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _lengths.emplace(soundName, length);
+    }
+
+    if (length.streamed) {
+        *frameCount = length.frameCount;
+        *sampleRate = length.sampleRate;
+    }
+    return length.streamed;
+}
+
+void SoundBank::purgeUnused() {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _buffers.begin(); it != _buffers.end();) {
+        if (it->second.use_count() == 1) {
+            _size -= it->second->getSize();
+            it = _buffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t SoundBank::getBufferCount() {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    return _buffers.size();
+}
+
+size_t SoundBank::getSize() {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    return _size;
+}
+
+SoundBuffer_SharedPtr SoundBank::_insert(const std::string& soundName, SoundBuffer_SharedPtr buffer) {
+    bool needsPurge = false;
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        // another thread may have decoded the same sound in the meantime
+        auto it = _buffers.find(soundName);
+        if (it != _buffers.end()) {
+            return it->second;
+        }
+        _buffers.emplace(soundName, buffer);
+        _size += buffer->getSize();
+        needsPurge = _size > _maxSize;
+    }
+    if (needsPurge) {
+        purgeUnused();
+    }
+    return buffer;
+}
+
+SoundBank::SoundLength SoundBank::_probeLength(const std::string& soundName) {
+    SoundLength length = { 0, 0, false };
+
+    ma_decoder_config config = ma_decoder_config_init(SOUND_BANK_FORMAT, 0, 0);
+    ma_decoder decoder;
+    if (ma_decoder_init_vfs(_vfs, soundName.c_str(), &config, &decoder) != MA_SUCCESS) {
+        // can't be streamed either, SoundBank::get reports the error
+        return length;
+    }
+    length.sampleRate = decoder.outputSampleRate;
+    if (ma_decoder_get_length_in_pcm_frames(&decoder, &length.frameCount) != MA_SUCCESS) {
+        length.frameCount = 0;
+    }
+    ma_decoder_uninit(&decoder);
+
+    // Ogg decoder reads through callbacks, it doesn't know the length:
+    // read granule position of the last page, at the end of the file.
+    ma_vfs_file file;
+    if (length.frameCount == 0 && ma_vfs_open(_vfs, soundName.c_str(), MA_OPEN_MODE_READ, &file) == MA_SUCCESS) {
+        ma_file_info info;
+        if (ma_vfs_info(_vfs, file, &info) == MA_SUCCESS && info.sizeInBytes >= OGG_PAGE_HEADER_SIZE) {
+            const ma_uint64 tailSize = info.sizeInBytes < OGG_PAGE_MAX_SIZE ? info.sizeInBytes : OGG_PAGE_MAX_SIZE;
+            std::vector<uint8_t> tail(static_cast<size_t>(tailSize));
+            size_t read = 0;
+            if (ma_vfs_seek(_vfs, file, -static_cast<ma_int64>(tailSize), ma_seek_origin_end) == MA_SUCCESS &&
+                ma_vfs_read(_vfs, file, tail.data(), tail.size(), &read) == MA_SUCCESS &&
+                read >= OGG_PAGE_HEADER_SIZE) {
+                const uint8_t lastPageFlag = 0x04;
+                for (size_t i = read - OGG_PAGE_HEADER_SIZE + 1; i > 0; --i) {
+                    const uint8_t *page = tail.data() + i - 1;
+                    if (page[0] == OGG_PAGE_HEADER[0] && page[1] == OGG_PAGE_HEADER[1] &&
+                        page[2] == OGG_PAGE_HEADER[2] && page[3] == OGG_PAGE_HEADER[3] &&
+                        (page[5] & lastPageFlag)) {
+                        // 1st 32 bits of granule position (can go up to 24 h and 51 m at 48 kHz)
+                        length.frameCount = static_cast<ma_uint64>(page[6]) |
+                                            static_cast<ma_uint64>(page[7]) << 8 |
+                                            static_cast<ma_uint64>(page[8]) << 16 |
+                                            static_cast<ma_uint64>(page[9]) << 24;
+                        break;
+                    }
+                }
+            }
+        }
+        ma_vfs_close(_vfs, file);
+    }
+
+    // unknown length: decoded in the bank
+    length.streamed = length.sampleRate > 0 &&
+                      length.frameCount > static_cast<ma_uint64>(length.sampleRate) * SOUND_STREAM_MIN_DURATION_SEC;
+    return length;
+}
+
 // --------------------------------------------------
 // MARK: - SoundsTicks type -
 // --------------------------------------------------
 
 SoundsTicks::SoundsTicks():
-_sounds() {}
+_voices(),
+_maxVoices(DEFAULT_MAX_VOICES),
+_voiceCounter(0) {
+    _voices.reserve(_maxVoices);
+}
 
 SoundsTicks::~SoundsTicks() {
 
@@ -266,26 +612,96 @@ SoundsTicks *SoundsTicks::shared() {
 }
 
 void SoundsTicks::tick(const double dt) {
-    if (_sounds.size() == 0) {
+    if (_voices.size() == 0) {
         return;
     }
 
     Sound_SharedPtr sptr;
-    for (std::vector<Sound_WeakPtr>::iterator it = _sounds.begin(); it != _sounds.end();) {
-        sptr = (*it).lock();
+    size_t i = 0;
+    while (i < _voices.size()) {
+        sptr = _voices[i].lock();
         if (sptr != nullptr) {
             sptr->tick(dt);
-            it++;
-        } else {
-            // remove sound reference from the list
-            it = _sounds.erase(it);
+            if (sptr->isVoiceIdle() == false) {
+                ++i;
+                continue;
+            }
+        }
+        // sound is gone or doesn't need its voice anymore
+        _releaseVoiceAt(i);
+    }
+}
+
+bool SoundsTicks::acquireVoice(const Sound_SharedPtr& sound) {
+    if (sound == nullptr) {
+        return false;
+    }
+    if (sound->_hasVoice) {
+        return true;
+    }
+
+    if (_voices.size() >= _maxVoices) {
+        // look for a voice to steal: lowest priority, then oldest
+        size_t victimIndex = _voices.size();
+        Sound_SharedPtr victim = nullptr;
+        for (size_t i = 0; i < _voices.size(); ++i) {
+            Sound_SharedPtr candidate = _voices[i].lock();
+            if (candidate == nullptr) {
+                // released sound, its voice can be used right away
+                victimIndex = i;
+                victim = nullptr;
+                break;
+            }
+            if (candidate->_priority > sound->_priority) {
+                continue;
+            }
+            if (victim == nullptr ||
+                candidate->_priority < victim->_priority ||
+                (candidate->_priority == victim->_priority && candidate->_voiceStamp < victim->_voiceStamp)) {
+                victim = candidate;
+                victimIndex = i;
+            }
+        }
+
+        if (victimIndex == _voices.size()) {
+            // all voices are used by sounds with greater priorities
+            return false;
+        }
+
+        if (victim != nullptr) {
+            victim->stopWithoutFadeOut();
+            victim->_playScheduled = false;
         }
+        _releaseVoiceAt(victimIndex);
     }
+
+    sound->_hasVoice = true;
+    sound->_voiceStamp = _voiceCounter++;
+    _voices.push_back(sound);
+    return true;
+}
+
+size_t SoundsTicks::getActiveVoiceCount() {
+    return _voices.size();
 }
 
-void SoundsTicks::addSound(const Sound_SharedPtr sound) {
-    Sound_WeakPtr soundWeakRef = sound;
-    _sounds.push_back(soundWeakRef);
+size_t SoundsTicks::getMaxVoices() {
+    return _maxVoices;
+}
+
+void SoundsTicks::setMaxVoices(const size_t maxVoices) {
+    _maxVoices = maxVoices > 0 ? maxVoices : 1;
+    _voices.reserve(_maxVoices);
+}
+
+void SoundsTicks::_releaseVoiceAt(const size_t index) {
+    Sound_SharedPtr sptr = _voices[index].lock();
+    if (sptr != nullptr) {
+        sptr->_hasVoice = false;
+    }
+    // order doesn't matter, swap with last
+    _voices[index] = _voices.back();
+    _voices.pop_back();
 }
 
 // --------------------------------------------------
@@ -296,6 +712,8 @@ void SoundsTicks::addSound(const Sound_SharedPtr sound) {
 Sound::Sound(AudioEngine * const engine, const std::string& soundName, const bool looping) :
 _weakSelf(),
 _retainer(),
+_buffer(nullptr),
+_initialized(false),
 _soundName(soundName),
 _startAt(-1.0f),
 _stopAt(-1.0f),
@@ -309,7 +727,10 @@ _playScheduled(false),
 _timeSinceStartOfPlay(-1.0),
 _timeSinceStartOfFade(-1.0),
 _startFrame(0),
-_sampleRate(0) {}
+_sampleRate(0),
+_priority(0),
+_hasVoice(false),
+_voiceStamp(0) {}
 
 Sound_SharedPtr Sound::make(AudioEngine * const engine, const std::string& soundName, const bool looping) {
     assert(engine != nullptr);
@@ -322,22 +743,57 @@ Sound_SharedPtr Sound::make(AudioEngine * const engine, const std::string& sound
         return nullptr;
     }
 
-    SoundsTicks::shared()->addSound(newSound);
-
     return newSound;
 }
     
 bool Sound::init(AudioEngine * const engine, const std::string& soundName) {
     ma_result result;
-    
-    // maybe we should use "ma_sound_init_from_data_source"
-    // - Spatialization is enabled by default
-    result = ma_sound_init_from_file(&(engine->_engine), soundName.c_str(), 0, nullptr, nullptr, &_ma_sound);
-    if (result != MA_SUCCESS) {
-        // error
-        vxlog_error("[vx::audio::Sound] failed to init Sound object (1)");
-        return false;
+    ma_uint64 frameCount = 0;
+
+    if (engine->_bank->isStreamed(soundName, &frameCount, &_sampleRate)) {
+        // long sound, each instance reads its own stream from the file
+        // - Spatialization is enabled by default
+        result = ma_sound_init_from_file(&(engine->_engine),
+                                         soundName.c_str(),
+                                         MA_SOUND_FLAG_STREAM,
+                                         nullptr,
+                                         nullptr,
+                                         &_ma_sound);
+        if (result != MA_SUCCESS) {
+            vxlog_error("[vx::audio::Sound] failed to init Sound object (1)");
+            return false;
+        }
+    } else {
+        // decoded once, shared by all instances of the same sound
+        _buffer = engine->_bank->get(soundName);
+        if (_buffer == nullptr) {
+            vxlog_error("[vx::audio::Sound] failed to init Sound object (1)");
+            return false;
+        }
+
+        result = ma_audio_buffer_ref_init(_buffer->getFormat(),
+                                          _buffer->getChannels(),
+                                          _buffer->getFrames(),
+                                          _buffer->getFrameCount(),
+                                          &_bufferRef);
+        if (result != MA_SUCCESS) {
+            vxlog_error("[vx::audio::Sound] failed to init Sound object (2)");
+            return false;
+        }
+        _bufferRef.sampleRate = _buffer->getSampleRate();
+
+        // - Spatialization is enabled by default
+        result = ma_sound_init_from_data_source(&(engine->_engine), &_bufferRef, 0, nullptr, &_ma_sound);
+        if (result != MA_SUCCESS) {
+            ma_audio_buffer_ref_uninit(&_bufferRef);
+            vxlog_error("[vx::audio::Sound] failed to init Sound object (3)");
+            return false;
+        }
+
+        frameCount = _buffer->getFrameCount();
+        _sampleRate = _buffer->getSampleRate();
     }
+    _initialized = true;
     
     // default tweaking values
     ma_sound_set_rolloff(&_ma_sound, 1.0f);
@@ -345,27 +801,11 @@ bool Sound::init(AudioEngine * const engine, const std::string& soundName) {
     ma_sound_set_max_distance(&_ma_sound, DEFAULT_MAX_DISTANCE);
     ma_sound_set_volume(&_ma_sound, _volume);
 
-    // retreive information about the sound
-    result = ma_sound_get_data_format(&_ma_sound, nullptr, nullptr, &_sampleRate, nullptr, 0);
-    if (result != MA_SUCCESS || _sampleRate == 0) {
+    if (_sampleRate == 0) {
         vxlog_error("[vx::audio::Sound] failed to retreive format.");
         return false;
     }
-
-    ma_uint64 nbFrames;
-    result = ma_data_source_get_length_in_pcm_frames(&_ma_sound, &nbFrames);
-    if (result != MA_SUCCESS) {
-        nbFrames = static_cast<ma_uint64>(this->getNbSamplesFromOggFile());
-    }
-
-    _originalDuration = static_cast<float>(nbFrames) / static_cast<float>(_sampleRate);
-
-    // reset
-    result = ma_sound_seek_to_pcm_frame(&_ma_sound, 0);
-    if (result != MA_SUCCESS) {
-        vxlog_error("[vx::audio::Sound] failed to init Sound object (3)");
-        return false;
-    }
+    _originalDuration = static_cast<float>(frameCount) / static_cast<float>(_sampleRate);
 
     _duration = _originalDuration / _pitch;
 
@@ -373,8 +813,13 @@ bool Sound::init(AudioEngine * const engine, const std::string& soundName) {
 }
 
 Sound::~Sound() {
-    ma_sound_stop(&_ma_sound);
-    ma_sound_uninit(&_ma_sound);
+    if (_initialized) {
+        ma_sound_stop(&_ma_sound);
+        ma_sound_uninit(&_ma_sound);
+        if (_buffer != nullptr) {
+            ma_audio_buffer_ref_uninit(&_bufferRef);
+        }
+    }
 }
 
 void Sound::tick(double dt) {
@@ -413,6 +858,11 @@ void Sound::play() {
         return;
     }
 
+    if (SoundsTicks::shared()->acquireVoice(_weakSelf.lock()) == false) {
+        // all voices are used by sounds with greater priorities
+        return;
+    }
+
     result = ma_sound_seek_to_pcm_frame(&_ma_sound, 0);
     if (result != MA_SUCCESS) {
         vxlog_error("play (1)");
@@ -480,6 +930,8 @@ void Sound::stop() {
 void Sound::stopWithoutFadeOut() {
     ma_sound_stop(&_ma_sound);
 
+    _timeSinceStartOfFade = -1.0;
+
     _retainer = nullptr;
 }
 
@@ -660,56 +1112,10 @@ void Sound::setPosition(const float x, const float y, const float z) {
     ma_sound_set_position(&_ma_sound, x, y, z);
 }
 
-ma_uint32 Sound::getNbSamplesFromOggFile() {
-    bool inCache = false;
-
-    if (_soundName.rfind("cache/_audio_", 0) == 0) {
-        inCache = true;
-    } else {
-        _soundName = "audio/" + _soundName;
-    }
-
-    FILE *fd;
-
-    if (inCache) {
-        fd = ::vx::fs::openStorageFile(_soundName.c_str());
-    } else {
-        fd = ::vx::fs::openBundleFile(_soundName.c_str());
-    }
-
-    if (fd == nullptr) {
-        return 0.0f;
-    }
-
-    const size_t headerSize = 27;
-    const uint8_t lastPageFlag = 0x04;
-    size_t size = 0;
-    ma_uint32 nbSamples = 0;
-
-    uint8_t *data = static_cast<uint8_t *>(::vx::fs::getFileContent(fd, &size));
-    if (size < headerSize) {
-        return 0;
-    }
-
-    // look for last ogg page
-    for (size_t i = size - headerSize; i > 0; --i) {
-        if (data[i] == OGG_PAGE_HEADER[0] && data[i + 1] == OGG_PAGE_HEADER[1] &&
-            data[i + 2] == OGG_PAGE_HEADER[2] && data[i + 3] == OGG_PAGE_HEADER[3] &&
-            (data[i + 5] & lastPageFlag)) {
-            // found the start of last header
-            // read the 1st 32 bits of granule position (from byte 6 to byte 9)
-            // (can go up to 24 h and 51 m at 48 kHz)
-            nbSamples = static_cast<ma_uint32>(data[i + 6]) |
-                        static_cast<ma_uint32>(data[i + 7] << 8) |
-                        static_cast<ma_uint32>(data[i + 8] << 16) |
-                        static_cast<ma_uint32>(data[i + 9] << 24);
-            break;
-        }
-    }
-
-    free(data);
-
-    return nbSamples;
+bool Sound::isVoiceIdle() {
+    return _playScheduled == false &&
+    _timeSinceStartOfFade < 0.0 &&
+    ma_sound_is_playing(&_ma_sound) == MA_FALSE;
 }
 
 void Sound::updateDuration() {
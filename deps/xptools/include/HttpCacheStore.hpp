@@ -0,0 +1,253 @@
+//
+//  HttpCacheStore.hpp
+//  xptools
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//  Copyright © 2026 voxowl. All rights reserved.
+//
+
+#pragma once
+
+// C++
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vx {
+
+/// Read-only region of a cache pack file.
+/// The region is memory-mapped when the platform & storage allow it,
+/// otherwise it is read once into a heap buffer.
+/// A mapping stays valid as long as a reference to it exists, even if the
+/// pack file it comes from has been compacted or removed in the meantime.
+class HttpCacheMapping final {
+public:
+    /// Maps (or reads) the first `size` bytes of the file.
+    /// Returns nullptr on failure.
+    static std::shared_ptr<HttpCacheMapping> make(FILE * const fd, const size_t size);
+
+    /// Copies given bytes into a heap buffer.
+    /// Returns nullptr on failure.
+    static std::shared_ptr<HttpCacheMapping> copy(const char *data, const size_t size);
+
+    ~HttpCacheMapping();
+
+    const char *data() const { return _data; }
+    size_t size() const { return _size; }
+    bool isMemoryMapped() const { return _mapped; }
+
+private:
+    HttpCacheMapping(const char *data, const size_t size, const bool mapped);
+
+    const char *_data;
+    size_t _size;
+    bool _mapped;
+};
+
+/// Cached response body. It doesn't own any copy of the bytes,
+/// it points into a shared pack file mapping.
+class HttpCacheBody final {
+public:
+    HttpCacheBody(std::shared_ptr<HttpCacheMapping> mapping, const size_t offset, const size_t size);
+
+    const char *data() const { return _mapping != nullptr ? _mapping->data() + _offset : nullptr; }
+    size_t size() const { return _size; }
+
+private:
+    std::shared_ptr<HttpCacheMapping> _mapping;
+    size_t _offset;
+    size_t _size;
+};
+
+typedef std::shared_ptr<const HttpCacheBody> HttpCacheBody_SharedPtr;
+
+/// Content-addressed store for cached HTTP responses.
+///
+/// On disk, a store is a directory containing:
+/// - an index file, listing response metadata (URL, ETag, max-age, status, headers)
+///   and the blobs they reference,
+/// - an append-only pack, containing response bodies. The pack is a list of segment
+///   files, each one written at once and never modified afterwards.
+///
+/// Bodies are identified by their content (md5 + size), so identical bodies served
+/// from different URLs are only stored once. Entries are evicted in least recently
+/// used order once the total size goes above the configured budget, and the pack is
+/// compacted when it contains more dead bytes than live ones, or too many segments.
+///
+/// Changes are buffered: new bodies are kept in memory and the index isn't rewritten
+/// for each of them. They're written together (new bodies in a new pack segment) once
+/// enough of them accumulated, after a delay, on `flush` or when the store is destroyed.
+///
+/// Not thread-safe, the owner is responsible for locking.
+class HttpCacheStore final {
+public:
+
+    /// Metadata of a cached response
+    class Entry final {
+    public:
+        Entry();
+        std::string url;
+        std::string etag;
+        uint32_t creationTime; // seconds since 2001/01/01
+        uint32_t maxAge; // seconds
+        uint16_t statusCode;
+        std::unordered_map<std::string, std::string> headers;
+        HttpCacheBody_SharedPtr body;
+    };
+
+    /// `dir` is a storage-relative directory path,
+    /// `maxSize` is the total size budget, in bytes.
+    HttpCacheStore(const std::string& dir, const uint64_t maxSize);
+
+    ~HttpCacheStore();
+
+    /// Stores (or replaces) the response for the given URL, body bytes are copied.
+    /// Returns false if the response couldn't be stored.
+    bool put(const std::string& url,
+             const std::string& etag,
+             const uint32_t creationTime,
+             const uint32_t maxAge,
+             const uint16_t statusCode,
+             const std::unordered_map<std::string, std::string>& headers,
+             const char *bodyData,
+             const size_t bodySize);
+
+    /// Retrieves the response for the given URL, marking it as recently used.
+    /// Returns false if there's no entry for this URL.
+    bool get(const std::string& url, Entry& out);
+
+    /// Removes the response for the given URL.
+    /// Returns false if there was no entry for this URL.
+    bool remove(const std::string& url);
+
+    /// Removes all entries and files.
+    void clear();
+
+    /// Writes buffered bodies & index changes.
+    /// Returns false if they couldn't be written, they remain buffered in that case.
+    bool flush();
+
+    /// Sets the total size budget (in bytes), evicting entries if needed.
+    void setMaxSize(const uint64_t maxSize);
+    uint64_t getMaxSize() const;
+
+    /// Total size of live entries (bodies & metadata), in bytes.
+    uint64_t getSize() const;
+
+    /// Count of cached responses
+    size_t getEntryCount() const;
+
+    /// Count of distinct bodies stored in the pack
+    size_t getBlobCount() const;
+
+    /// Size of the pack, in bytes (live and dead blobs, buffered ones included)
+    uint64_t getPackSize() const;
+
+    /// Count of pack segment files
+    size_t getSegmentCount() const;
+
+private:
+
+    class Blob final {
+    public:
+        Blob();
+        /// Body bytes, until they're written in a pack segment
+        std::shared_ptr<HttpCacheMapping> pending;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t segment;
+        uint32_t refCount;
+    };
+
+    class Record final {
+    public:
+        Record();
+        std::string etag;
+        uint32_t creationTime;
+        uint32_t maxAge;
+        uint16_t statusCode;
+        std::unordered_map<std::string, std::string> headers;
+        std::string blobKey;
+        uint64_t metadataSize;
+        std::list<std::string>::iterator lruIt;
+    };
+
+    /// Storage-relative directory path
+    std::string _dir;
+
+    /// Size budget, in bytes
+    uint64_t _maxSize;
+
+    /// Size of live bodies & metadata, in bytes
+    uint64_t _size;
+
+    /// Size of pack regions not referenced anymore, in bytes
+    uint64_t _deadSize;
+
+    /// Size of bodies not written in the pack yet, in bytes
+    uint64_t _pendingSize;
+
+    /// Pack segment sizes, indexed by segment ID
+    std::unordered_map<uint32_t, uint64_t> _segments;
+
+    /// Segment files to remove once the index doesn't refer to them anymore
+    std::vector<uint32_t> _obsoleteSegments;
+
+    /// ID of the next pack segment
+    uint32_t _nextSegment;
+
+    /// Changes not written in the index yet
+    uint32_t _changes;
+
+    /// Time of the first change not written yet
+    std::chrono::steady_clock::time_point _firstChangeTime;
+
+    /// Records, indexed by URL
+    std::unordered_map<std::string, Record> _records;
+
+    /// Blobs, indexed by content key
+    std::unordered_map<std::string, Blob> _blobs;
+
+    /// URLs, from most to least recently used
+    std::list<std::string> _lru;
+
+    /// Pack segment mappings, created when reading bodies
+    std::unordered_map<uint32_t, std::shared_ptr<HttpCacheMapping>> _segmentMappings;
+
+    std::string _indexPath() const;
+    std::string _segmentPath(const uint32_t segment) const;
+
+    bool _loadIndex();
+    bool _saveIndex();
+
+    /// Records a change, flushing changes if enough of them accumulated
+    void _didChange();
+
+    /// Flushes changes if enough of them accumulated, or if the oldest one is old enough
+    void _flushIfNeeded();
+
+    /// Writes pending bodies in a new pack segment
+    bool _writePendingBlobs();
+
+    /// Removes files of segments that are not part of the pack anymore
+    void _removeObsoleteSegments();
+
+    /// Removes all files in store directory, including legacy per-URL cache files.
+    void _removeAllFiles();
+
+    void _removeRecord(std::unordered_map<std::string, Record>::iterator it);
+    void _evictIfNeeded();
+    bool _compactPackIfNeeded();
+
+    std::shared_ptr<HttpCacheMapping> _getSegmentMapping(const uint32_t segment);
+
+    static std::string _blobKey(const char *data, const size_t size);
+    static uint64_t _metadataSize(const std::string& url, const Record& record);
+};
+
+}
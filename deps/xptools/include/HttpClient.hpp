@@ -15,10 +15,12 @@
 #include <unordered_set>
 
 // xptools
+#include "HttpCacheStore.hpp"
 #include "HttpRequest.hpp"
 #include "URL.hpp"
 
 #define VX_HTTP_CACHE_DIR_NAME "http_cache"
+#define VX_HTTP_CACHE_DEFAULT_MAX_SIZE 268435456 // 256MB
 
 // HTTP status codes
 #define HTTP_OK 200
@@ -62,7 +64,7 @@ public:
     /// Callback example:
     ///
     /// [](HttpRequest_SharedPtr req, const HttpResponse& resp){
-    ///     vxlog_debug("%d %s", resp.getStatusCode(), resp.getBytes().c_str());
+    ///     vxlog_debug("%d %s", resp.getStatusCode(), resp.getText().c_str());
     /// }
     ///
     HttpRequest_SharedPtr GET(const URL& url,
@@ -75,7 +77,7 @@ public:
     /// Callback example:
     ///
     /// [](HttpRequest_SharedPtr req, const HttpResponse& resp){
-    ///     vxlog_debug("%d %s", resp.getStatusCode(), resp.getBytes().c_str());
+    ///     vxlog_debug("%d %s", resp.getStatusCode(), resp.getText().c_str());
     /// }
     ///
     HttpRequest_SharedPtr GET(const std::string& host,
@@ -92,7 +94,7 @@ public:
     /// Callback example:
     ///
     /// [](HttpRequest_SharedPtr req, const HttpResponse& resp){
-    ///     vxlog_debug("%d %s", resp.getStatusCode(), resp.getBytes().c_str());
+    ///     vxlog_debug("%d %s", resp.getStatusCode(), resp.getText().c_str());
     /// }
     ///
     HttpRequest_SharedPtr POST(const std::string& host,
@@ -109,7 +111,7 @@ public:
     /// Callback example:
     ///
     /// [](HttpRequest_SharedPtr req, const HttpResponse& resp){
-    ///     vxlog_debug("%d %s", resp.getStatusCode(), resp.getBytes().c_str());
+    ///     vxlog_debug("%d %s", resp.getStatusCode(), resp.getText().c_str());
     /// }
     ///
     HttpRequest_SharedPtr POST(const std::string &url,
@@ -149,6 +151,9 @@ public:
     /// Remove cached response from cache
     bool removeCachedResponseForRequest(HttpRequest_SharedPtr req);
 
+    /// Sets cache size budget (in bytes), least recently used responses are evicted above it.
+    void setCacheMaxSize(const uint64_t maxSize);
+
 #endif
 
     static void run_unit_tests();
@@ -178,21 +183,16 @@ private:
 
     CallbackMiddleware _callbackMiddleware;
 
-    // file utils
-    static bool _cacheWriteFileHeader(const uint8_t fileFormatVersion, const uint8_t compressionMethod, FILE * const fd);
-    static bool _cacheWriteUint32Chunk(const uint8_t chunkID, const uint32_t chunkValue, FILE * const fd);
-    static bool _cacheWriteStringChunk(const uint8_t chunkID, const std::string chunkValue, FILE * const fd);
-    static bool _cacheWriteMapStringStringChunk(const uint8_t chunkID,
-                                                const std::unordered_map<std::string, std::string>& chunkValue,
-                                                FILE * const fd);
-    static bool _cacheReadFileHeader(uint8_t *fileFormatVersion, uint8_t *compressionMethod, FILE * const fd);
-    static bool _cacheReadUint32Chunk(const uint8_t chunkID, uint32_t& chunkValue, FILE * const fd);
-    static bool _cacheReadStringChunk(const uint8_t chunkID, std::string& chunkValue, FILE * const fd);
-    static bool _cacheReadMapStringStringChunk(const uint8_t chunkID,
-                                               std::unordered_map<std::string, std::string>& chunkValue,
-                                               FILE * const fd);
-
-    static bool _readString(std::string& out, FILE * const fd);
+#if !defined(__VX_PLATFORM_WASM)
+    /// Lazily created, protected by `_cacheMutex`
+    HttpCacheStore *_cacheStore;
+
+    ///
+    uint64_t _cacheMaxSize;
+
+    ///
+    HttpCacheStore& _getCacheStore();
+#endif
 
     // Returns an array containing the cache-control directives
     static std::vector<std::string> _parseCacheControlHeaderValue(const std::string& cacheControlValue);
@@ -200,6 +200,9 @@ private:
     // Unit tests
     static void run_unit_tests_parse_url();
     static void run_unit_tests_get_url();
+#if !defined(__VX_PLATFORM_WASM)
+    static void run_unit_tests_cache_store();
+#endif
 };
 
 }
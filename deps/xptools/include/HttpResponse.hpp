@@ -11,10 +11,14 @@
 // C++
 #include <string>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace vx {
 
+class HttpCacheBody;
+
 enum class HTTPStatus {
     OK,
     NOT_MODIFIED,
@@ -44,9 +48,20 @@ public:
     HTTPStatus getStatus() const;
 
     void appendBytes(const std::string& bytes);
+    /// When the body comes from the cache, it is copied into a string on first call
+    /// (safe to call from several threads reading the same response).
+    /// Use `getBodyData` & `getBodySize` to access it without copy.
     const std::string& getBytes() const;
     void setBytes(const std::string& bytes);
 
+    /// Sets body from the HTTP cache, bytes are not copied.
+    void setCachedBody(std::shared_ptr<const HttpCacheBody> body);
+    std::shared_ptr<const HttpCacheBody> getCachedBody() const;
+
+    /// Body bytes, whether they come from the network or the cache
+    const char *getBodyData() const;
+    size_t getBodySize() const;
+
     void setHeaders(std::unordered_map<std::string, std::string>&& headers);
     void setHeaders(const std::unordered_map<std::string, std::string>& headers);
     const std::unordered_map<std::string, std::string>& getHeaders() const;
@@ -71,7 +86,12 @@ private:
     std::unordered_map<std::string, std::string> _headers;
     
     /// Response body
-    std::string _bytes;
+    /// (mutable, filled lazily from `_cachedBody` when needed, under `_bytesMutex`)
+    mutable std::string _bytes;
+    mutable std::mutex _bytesMutex;
+
+    /// Response body, when read from the HTTP cache
+    std::shared_ptr<const HttpCacheBody> _cachedBody;
 
     /// Indicates whether the response content is from local cache
     bool _useLocalCache;
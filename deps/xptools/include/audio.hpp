@@ -13,6 +13,8 @@
 // C++
 #include <string>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 // miniaudio
@@ -27,6 +29,7 @@ typedef std::weak_ptr<Sound> Sound_WeakPtr;
 
 class Sound;
 class Listener;
+class SoundBank;
 
 typedef struct {
     ma_vfs_callbacks cb;
@@ -61,17 +64,32 @@ public:
     Listener *createListener();
 
     bool setVolume(float volumePercentage);
+
+    ///
+    SoundBank *getSoundBank();
+
+    static void run_unit_tests();
+
+    /// Creates & destroys `count` Sound instances of a decoded sound,
+    /// returns instances per second.
+    static double run_benchmark(const int count);
     
     // MARK: - Private -
 private:
     
-    ///
-    AudioEngine();
+    /// When `nullBackend` is true, the engine is created on top of miniaudio's null backend
+    /// (no audio output, used for tests & benchmarks).
+    AudioEngine(const bool nullBackend = false);
     
     // miniaudio stuff
+    ma_context _context;
     ma_engine _engine;
+    bool _hasContext;
     
     vx_tools_vfs *_vfs;
+
+    /// Decoded sounds, shared by Sound instances
+    SoundBank *_bank;
     
     // Now class Sound can access private members of Engine
     friend class Sound;
@@ -80,10 +98,139 @@ private:
     friend class Listener;
 };
 
+// --------------------------------------------------
+// MARK: - SoundBuffer -
+// --------------------------------------------------
+
+/// Decoded PCM frames, shared by all Sound instances playing the same sound.
+class SoundBuffer final {
+public:
+
+    ///
+    SoundBuffer(const ma_format format,
+                const ma_uint32 channels,
+                const ma_uint32 sampleRate,
+                const ma_uint64 frameCount,
+                void *frames);
+
+    ///
+    ~SoundBuffer();
+
+    ///
+    inline ma_format getFormat() const { return _format; }
+
+    ///
+    inline ma_uint32 getChannels() const { return _channels; }
+
+    ///
+    inline ma_uint32 getSampleRate() const { return _sampleRate; }
+
+    ///
+    inline ma_uint64 getFrameCount() const { return _frameCount; }
+
+    ///
+    inline const void *getFrames() const { return _frames; }
+
+    /// size of PCM frames, in bytes
+    size_t getSize() const;
+
+private:
+
+    ma_format _format;
+    ma_uint32 _channels;
+    ma_uint32 _sampleRate;
+    ma_uint64 _frameCount;
+
+    /// allocated by miniaudio (ma_free)
+    void *_frames;
+};
+
+typedef std::shared_ptr<SoundBuffer> SoundBuffer_SharedPtr;
+
+// --------------------------------------------------
+// MARK: - SoundBank -
+// --------------------------------------------------
+
+/// Decodes each sound once, and keeps decoded buffers around
+/// while they're used or while the bank is below its size budget.
+/// Long sounds (music) are not decoded, Sounds stream them from their file.
+class SoundBank final {
+public:
+
+    ///
+    SoundBank(ma_vfs *vfs, const size_t maxSize);
+
+    ///
+    ~SoundBank();
+
+    /// Returns decoded buffer for given sound name, decoding it on first request.
+    /// Returns nullptr if the sound can't be decoded.
+    SoundBuffer_SharedPtr get(const std::string& soundName);
+
+    /// Registers PCM frames under given name (frames are copied).
+    SoundBuffer_SharedPtr add(const std::string& soundName,
+                              const ma_format format,
+                              const ma_uint32 channels,
+                              const ma_uint32 sampleRate,
+                              const void *frames,
+                              const ma_uint64 frameCount);
+
+    /// Returns true if the sound is too long to be decoded in the bank and must be streamed.
+    /// Sounds already in the bank are never streamed.
+    /// `frameCount` & `sampleRate` are then set with the length of the sound (0 if unknown).
+    bool isStreamed(const std::string& soundName, ma_uint64 *frameCount, ma_uint32 *sampleRate);
+
+    /// Removes buffers that are not used by any Sound.
+    void purgeUnused();
+
+    ///
+    size_t getBufferCount();
+
+    /// total size of decoded buffers, in bytes
+    size_t getSize();
+
+private:
+
+    /// length of a sound, probed once
+    typedef struct {
+        ma_uint64 frameCount;
+        ma_uint32 sampleRate;
+        bool streamed;
+    } SoundLength;
+
+    SoundBuffer_SharedPtr _insert(const std::string& soundName, SoundBuffer_SharedPtr buffer);
+
+    /// Reads length from decoder, or from last Ogg page when the decoder doesn't know it.
+    SoundLength _probeLength(const std::string& soundName);
+
+    ///
+    ma_vfs *_vfs;
+
+    /// size budget, in bytes (unused buffers are purged above it)
+    size_t _maxSize;
+
+    ///
+    size_t _size;
+
+    ///
+    std::unordered_map<std::string, SoundBuffer_SharedPtr> _buffers;
+
+    /// probed lengths, not purged (small)
+    std::unordered_map<std::string, SoundLength> _lengths;
+
+    ///
+    std::mutex _mutex;
+};
+
 // --------------------------------------------------
 // MARK: - SoundsTicks -
 // --------------------------------------------------
 
+/// Voice pool: a Sound needs a voice to play.
+/// When all voices are used, the one with the lowest priority
+/// (the oldest one in case of equality) is stolen if its priority
+/// isn't greater than the priority of the Sound that needs it.
+/// Only Sounds holding a voice are ticked.
 class SoundsTicks final {
 public:
 
@@ -95,15 +242,34 @@ public:
 
     void tick(const double dt);
 
-    void addSound(const Sound_SharedPtr sound);
+    /// Returns false if no voice could be assigned to the sound.
+    bool acquireVoice(const Sound_SharedPtr& sound);
+
+    ///
+    size_t getActiveVoiceCount();
+
+    ///
+    size_t getMaxVoices();
+
+    ///
+    void setMaxVoices(const size_t maxVoices);
 
 private:
 
     /// private constructor
     SoundsTicks();
 
-    /// sounds currently allocated
-    std::vector<Sound_WeakPtr> _sounds;
+    ///
+    void _releaseVoiceAt(const size_t index);
+
+    /// sounds currently holding a voice
+    std::vector<Sound_WeakPtr> _voices;
+
+    ///
+    size_t _maxVoices;
+
+    /// incremented each time a voice is acquired, to find the oldest one
+    uint64_t _voiceCounter;
 };
 
 // --------------------------------------------------
@@ -218,21 +384,39 @@ public:
     
     ///
     void setPosition(const float x, const float y, const float z);
+
+    /// Voice stealing priority, higher values are stolen last (default: 0)
+    inline int getPriority() { return _priority; }
+
+    ///
+    inline void setPriority(const int priority) { _priority = priority; }
+
+    /// Returns true if the sound holds a voice from the pool
+    inline bool hasVoice() { return _hasVoice; }
     
 private:
-    /// reads the file and returns the number of samples
-    /// /!\ only works with ogg files
-    ma_uint32 getNbSamplesFromOggFile();
-
     /// updates the duration taking into account startAt and stopAt
     void updateDuration();
 
+    /// returns true when the sound doesn't need its voice anymore
+    bool isVoiceIdle();
+
     Sound_WeakPtr _weakSelf;
 
     Sound_SharedPtr _retainer;
+
+    /// decoded frames, shared with other instances of the same sound
+    /// (nullptr when the sound is streamed)
+    SoundBuffer_SharedPtr _buffer;
+
+    /// data source reading from `_buffer`, with its own cursor
+    ma_audio_buffer_ref _bufferRef;
     
     /// variable from miniaudio that controls the sound itself
     ma_sound _ma_sound;
+
+    /// true once `_ma_sound` has been initialized
+    bool _initialized;
     
     ///
     std::string _soundName;
@@ -272,7 +456,17 @@ private:
 
     ma_uint32 _sampleRate;
 
+    ///
+    int _priority;
+
+    ///
+    bool _hasVoice;
+
+    /// value of voice counter when the voice was acquired
+    uint64_t _voiceStamp;
+
     friend class AudioEngine;
+    friend class SoundsTicks;
 };
 
 // --------------------------------------------------
@@ -0,0 +1,18 @@
+//
+//  miniaudio_impl.cpp
+//  xptools-linux
+//
+//  Created by Gaetan de Villele on 17/10/2026.
+//  Copyright © 2026 voxowl. All rights reserved.
+//
+
+#define STB_VORBIS_HEADER_ONLY
+#include "extras/stb_vorbis.c"    /* Enables Vorbis decoding. */
+
+// miniaudio lib
+#define MINIAUDIO_IMPLEMENTATION
+#include "miniaudio.h"
+
+/* stb_vorbis implementation must come after the implementation of miniaudio. */
+#undef STB_VORBIS_HEADER_ONLY
+#include "extras/stb_vorbis.c"